@@ -50,6 +50,7 @@
 #include <gtk/gtkpixmap.h>
 #include <gobject/gvaluecollector.h>
 #include <pango/pango.h>
+#include <pango/pangocairo.h>
 
 #define __GTKSHEET_H_INSIDE__
 
@@ -83,6 +84,7 @@
 #   define GTK_SHEET_DEBUG_ENTER_PRESSED   0
 #   define GTK_SHEET_DEBUG_ENTRY   0
 #   define GTK_SHEET_DEBUG_EXPOSE   0
+#   define GTK_SHEET_DEBUG_EXTENT_CACHE   0
 #   define GTK_SHEET_DEBUG_FINALIZE  0
 #   define GTK_SHEET_DEBUG_FONT_METRICS  0
 #   define GTK_SHEET_DEBUG_FREEZE   0
@@ -103,6 +105,18 @@
 
 #define GTK_SHEET_MOD_MASK  GDK_MOD1_MASK  /* main modifier for sheet navigation */
 
+/* tiles are rendered by cairo and need the text overflow index, 
+   used only while drawing with cairo, see gtk_sheet_set_cairo_draw() */
+#define GTK_SHEET_TILE_CACHE  (GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0)
+
+/* worker threads render into client-side images and measure extents, 
+   rendering is used only while drawing with cairo */
+#define GTK_SHEET_RENDER_THREADS  1
+
+/* per thread font maps need a thread-safe pango (and fontconfig >= 2.10) */
+#define GTK_SHEET_PANGO_THREADSAFE_MAJOR  1
+#define GTK_SHEET_PANGO_THREADSAFE_MINOR  32
+
 #ifndef GDK_KEY_KP_Up
 #   define GDK_KEY_KP_Up GDK_KP_Up
 #   define GDK_KEY_KP_Down GDK_KP_Down
@@ -155,6 +169,7 @@ enum _GtkSheetProperties
     PROP_GTK_SHEET_AUTO_RESIZE_COLUMNS,  /* gtk_sheet_set_autoresize_columns() */
     PROP_GTK_SHEET_AUTO_SCROLL,  /* gtk_sheet_set_autoscroll() */
     PROP_GTK_SHEET_CLIP_TEXT,  /* gtk_sheet_set_clip_text() */
+    PROP_GTK_SHEET_CAIRO_DRAW,  /* gtk_sheet_set_cairo_draw() */
     PROP_GTK_SHEET_JUSTIFY_ENTRY,  /* gtk_sheet_set_justify_entry() */
     PROP_GTK_SHEET_BG_COLOR,  /* gtk_sheet_set_background() */
     PROP_GTK_SHEET_GRID_VISIBLE,  /* gtk_sheet_show_grid() */
@@ -186,6 +201,8 @@ enum _GtkSheetSignals
     SET_CELL,
     CLEAR_CELL,
     CHANGED,
+    RANGE_CHANGED,
+    EXTENTS_PROGRESS,
     NEW_COL_WIDTH,
     NEW_ROW_HEIGHT,
     ENTRY_FOCUS_IN,
@@ -221,22 +238,84 @@ typedef enum _GtkSheetArea
 /* data access macros - no frontend update! */
 
 #define COLPTR(sheet, colidx) (sheet->column[colidx])
-#define ROWPTR(sheet, rowidx) (&sheet->row[rowidx])
-
-#define GTK_SHEET_ROW_IS_VISIBLE(rowptr)  ((rowptr)->is_visible)
-#define GTK_SHEET_ROW_SET_VISIBLE(rowptr, value) ((rowptr)->is_visible = (value))
-#define GTK_SHEET_ROW_IS_SENSITIVE(rowptr)  ((rowptr)->is_sensitive)
-#define GTK_SHEET_ROW_SET_SENSITIVE(rowptr, value) ((rowptr)->is_sensitive = (value))
-#define GTK_SHEET_ROW_IS_READONLY(rowptr) (((rowptr)->is_readonly))
-#define GTK_SHEET_ROW_SET_READONLY(rowptr, value) ((rowptr)->is_readonly = (value))
-#define GTK_SHEET_ROW_CAN_FOCUS(rowptr) (((rowptr)->can_focus))
-#define GTK_SHEET_ROW_SET_CAN_FOCUS(rowptr, value) ((rowptr)->can_focus = (value))
-
-#define GTK_SHEET_ROW_CAN_GRAB_FOCUS(rowptr) \
-        (GTK_SHEET_ROW_IS_VISIBLE(rowptr) ? \
-              (GTK_SHEET_ROW_IS_SENSITIVE(rowptr) ? \
-                  GTK_SHEET_ROW_CAN_FOCUS(rowptr) : FALSE) \
-                                           : FALSE)
+/* rows: heights, flags and extents in pages of GTK_SHEET_ROW_PAGE_SIZE 
+   rows, allocated once a row of the page differs from a default row, 
+   other row data in GtkSheetRow records created on demand, 
+   see _gtk_sheet_row_get() */
+
+#define GTK_SHEET_ROW_FLAG_VISIBLE    (1 << 0)
+#define GTK_SHEET_ROW_FLAG_SENSITIVE  (1 << 1)
+#define GTK_SHEET_ROW_FLAG_READONLY   (1 << 2)  /* to override cell editable */
+#define GTK_SHEET_ROW_FLAG_CAN_FOCUS  (1 << 3)  /* to allow keyboard/mouse focus */
+#define GTK_SHEET_ROW_FLAG_ACTIVE     (1 << 4)  /* row button pressed */
+#define GTK_SHEET_ROW_FLAG_STYLED     (1 << 5)  /* row record has an attr_layer */
+#define GTK_SHEET_ROW_FLAG_EXTENT_UNKNOWN (1 << 6)  /* holds cells with deferred extents */
+#define GTK_SHEET_ROW_FLAG_EXTENT_HIST    (1 << 7)  /* in row_extent_hist */
+
+#define GTK_SHEET_ROW_FLAGS_DEFAULT \
+    (GTK_SHEET_ROW_FLAG_VISIBLE | GTK_SHEET_ROW_FLAG_SENSITIVE | GTK_SHEET_ROW_FLAG_CAN_FOCUS)
+
+#define GTK_SHEET_ROW_PAGE_SHIFT  10
+#define GTK_SHEET_ROW_PAGE_SIZE   (1 << GTK_SHEET_ROW_PAGE_SHIFT)
+#define GTK_SHEET_ROW_PAGE_MASK   (GTK_SHEET_ROW_PAGE_SIZE - 1)
+
+struct _GtkSheetRowPage
+{
+    gint height[GTK_SHEET_ROW_PAGE_SIZE];      /* pixels */
+    guint8 flags[GTK_SHEET_ROW_PAGE_SIZE];     /* visibility, sensitivity etc. */
+    gint max_extent[GTK_SHEET_ROW_PAGE_SIZE];  /* := max(Cell.extent.height) */
+    guint max_count[GTK_SHEET_ROW_PAGE_SIZE];  /* counted cells of max extent */
+    gint tree[GTK_SHEET_ROW_PAGE_SIZE + 1];    /* row geometry, binary indexed, 1-based */
+    gint total;                                /* row geometry, sum of the page */
+};
+
+/* the page of a row, NULL if all rows of the page are default rows */
+#define ROW_PAGE(sheet, rowidx) ((sheet)->row_pages[(rowidx) >> GTK_SHEET_ROW_PAGE_SHIFT])
+#define ROW_SLOT(rowidx) ((rowidx) & GTK_SHEET_ROW_PAGE_MASK)
+
+#define ROW_HEIGHT(sheet, rowidx) \
+    (ROW_PAGE(sheet, rowidx) ? ROW_PAGE(sheet, rowidx)->height[ROW_SLOT(rowidx)] \
+        : (sheet)->row_page_height)
+#define ROW_FLAGS(sheet, rowidx) \
+    (ROW_PAGE(sheet, rowidx) ? ROW_PAGE(sheet, rowidx)->flags[ROW_SLOT(rowidx)] \
+        : GTK_SHEET_ROW_FLAGS_DEFAULT)
+#define ROW_MAX_EXTENT(sheet, rowidx) \
+    (ROW_PAGE(sheet, rowidx) ? ROW_PAGE(sheet, rowidx)->max_extent[ROW_SLOT(rowidx)] : 0)
+#define ROW_MAX_COUNT(sheet, rowidx) \
+    (ROW_PAGE(sheet, rowidx) ? ROW_PAGE(sheet, rowidx)->max_count[ROW_SLOT(rowidx)] : 0)
+
+/* row updates, allocate the page unless the row stays a default row */
+#define ROW_SET_HEIGHT(sheet, rowidx, value) \
+    _gtk_sheet_row_set_height(sheet, rowidx, value)
+#define ROW_SET_MAX_EXTENT(sheet, rowidx, value) \
+    _gtk_sheet_row_set_max_extent(sheet, rowidx, value)
+#define ROW_SET_MAX_COUNT(sheet, rowidx, value) \
+    _gtk_sheet_row_set_max_count(sheet, rowidx, value)
+
+#define ROW_FLAG(sheet, rowidx, flag)  ((ROW_FLAGS(sheet, rowidx) & (flag)) != 0)
+#define ROW_SET_FLAG(sheet, rowidx, flag, value) \
+    _gtk_sheet_row_set_flag(sheet, rowidx, flag, value)
+
+#define GTK_SHEET_ROW_IS_VISIBLE(sheet, rowidx) \
+        ROW_FLAG(sheet, rowidx, GTK_SHEET_ROW_FLAG_VISIBLE)
+#define GTK_SHEET_ROW_SET_VISIBLE(sheet, rowidx, value) \
+        ROW_SET_FLAG(sheet, rowidx, GTK_SHEET_ROW_FLAG_VISIBLE, value)
+#define GTK_SHEET_ROW_IS_SENSITIVE(sheet, rowidx) \
+        ROW_FLAG(sheet, rowidx, GTK_SHEET_ROW_FLAG_SENSITIVE)
+#define GTK_SHEET_ROW_SET_SENSITIVE(sheet, rowidx, value) \
+        ROW_SET_FLAG(sheet, rowidx, GTK_SHEET_ROW_FLAG_SENSITIVE, value)
+#define GTK_SHEET_ROW_IS_READONLY(sheet, rowidx) \
+        ROW_FLAG(sheet, rowidx, GTK_SHEET_ROW_FLAG_READONLY)
+#define GTK_SHEET_ROW_SET_READONLY(sheet, rowidx, value) \
+        ROW_SET_FLAG(sheet, rowidx, GTK_SHEET_ROW_FLAG_READONLY, value)
+#define GTK_SHEET_ROW_CAN_FOCUS(sheet, rowidx) \
+        ROW_FLAG(sheet, rowidx, GTK_SHEET_ROW_FLAG_CAN_FOCUS)
+#define GTK_SHEET_ROW_SET_CAN_FOCUS(sheet, rowidx, value) \
+        ROW_SET_FLAG(sheet, rowidx, GTK_SHEET_ROW_FLAG_CAN_FOCUS, value)
+
+#define GTK_SHEET_ROW_CAN_GRAB_FOCUS(sheet, rowidx) \
+        ((ROW_FLAGS(sheet, rowidx) & GTK_SHEET_ROW_FLAGS_DEFAULT) \
+            == GTK_SHEET_ROW_FLAGS_DEFAULT)
 
 #define GTK_SHEET_CELL_IS_VISIBLE(sheet,row,col) \
         (gtk_sheet_cell_get_visible(sheet,row,col))
@@ -259,6 +338,90 @@ typedef enum _GtkSheetArea
 #define ROW_UNREALIZED_MAX_HEIGHT 128  /* unrealized maximum height */
 #define ROW_REMNANT_PIXELS  32   /* maximized: free space left for others */
 
+/* sparse cell storage
+ *
+ * sheet->data is a directory of GTK_SHEET_BLOCK_ROWS x GTK_SHEET_BLOCK_COLS
+ * cell blocks, indexed [block row][block column]. A block keeps a strip of 
+ * GTK_SHEET_BLOCK_ROWS cell pointers per column. Directory rows, blocks 
+ * and strips are allocated on demand and released when their last cell 
+ * goes away, so memory scales with the number of populated cells, not 
+ * with the bounding box of the sheet. A tall sheet of few columns costs 
+ * about one pointer per populated cell.
+ */
+
+#define GTK_SHEET_BLOCK_ROW_SHIFT  8
+#define GTK_SHEET_BLOCK_ROWS   (1 << GTK_SHEET_BLOCK_ROW_SHIFT)
+#define GTK_SHEET_BLOCK_ROW_MASK   (GTK_SHEET_BLOCK_ROWS - 1)
+
+#define GTK_SHEET_BLOCK_COL_SHIFT  4
+#define GTK_SHEET_BLOCK_COLS   (1 << GTK_SHEET_BLOCK_COL_SHIFT)
+#define GTK_SHEET_BLOCK_COL_MASK   (GTK_SHEET_BLOCK_COLS - 1)
+
+#define BLOCK_ROW_IDX(row)  ((row) >> GTK_SHEET_BLOCK_ROW_SHIFT)
+#define BLOCK_COL_IDX(col)  ((col) >> GTK_SHEET_BLOCK_COL_SHIFT)
+#define BLOCK_STRIP(col)  ((col) & GTK_SHEET_BLOCK_COL_MASK)
+#define STRIP_SLOT(row)  ((row) & GTK_SHEET_BLOCK_ROW_MASK)
+
+typedef struct _GtkSheetCellStrip
+{
+    guint ncells;  /* number of allocated cells within the strip */
+    GtkSheetCell *cell[GTK_SHEET_BLOCK_ROWS];
+} GtkSheetCellStrip;
+
+struct _GtkSheetCellBlock
+{
+    guint nstrips;  /* number of allocated strips within the block */
+    GtkSheetCellStrip *strip[GTK_SHEET_BLOCK_COLS];  /* per column or NULL */
+};
+
+static inline GtkSheetCellBlock *
+_gtk_sheet_cell_block(GtkSheet *sheet, gint row, gint col)
+{
+    GtkSheetCellBlock **blockrow;
+
+    if (row < 0 || col < 0)
+	return (NULL);
+    if (BLOCK_ROW_IDX(row) >= sheet->data_block_rows)
+	return (NULL);
+    if (BLOCK_COL_IDX(col) >= sheet->data_block_cols)
+	return (NULL);
+
+    blockrow = sheet->data[BLOCK_ROW_IDX(row)];
+    if (!blockrow)
+	return (NULL);
+
+    return (blockrow[BLOCK_COL_IDX(col)]);
+}
+
+/*
+ * _gtk_sheet_cell_get - get allocated cell data
+ * 
+ * @param sheet
+ * @param row
+ * @param col
+ * 
+ * @return the #GtkSheetCell or NULL if not allocated
+ */
+static inline GtkSheetCell *
+_gtk_sheet_cell_get(GtkSheet *sheet, gint row, gint col)
+{
+    GtkSheetCellBlock *block;
+    GtkSheetCellStrip *strip;
+
+    if (row > sheet->maxallocrow || col > sheet->maxalloccol)
+	return (NULL);
+
+    block = _gtk_sheet_cell_block(sheet, row, col);
+    if (!block)
+	return (NULL);
+
+    strip = block->strip[BLOCK_STRIP(col)];
+    if (!strip)
+	return (NULL);
+
+    return (strip->cell[STRIP_SLOT(row)]);
+}
+
 #define COLUMN_MAX_WIDTH(sheet) \
     (sheet->sheet_window_width < COLUMN_REMNANT_PIXELS ? \
     COLUMN_UNREALIZED_MAX_WIDTH : \
@@ -425,6 +588,74 @@ _gtksheet_signal_emit(GtkObject *object, guint signal_id, ...)
   va_end (var_args);
 }
 
+/*
+ * _gtk_sheet_emit_changed - emit "changed" for a cell
+ * 
+ * per cell emission is skipped when nobody is listening, bulk 
+ * operations report through "range-changed" instead
+ * 
+ * @param sheet  the #GtkSheet
+ * @param row    row number or -1
+ * @param col    column number or -1
+ */
+static inline void
+_gtk_sheet_emit_changed(GtkSheet *sheet, gint row, gint col)
+{
+    if (!GTK_SHEET_GET_CLASS(sheet)->changed
+	&& !g_signal_has_handler_pending(sheet, sheet_signals[CHANGED], 0, FALSE))
+	return;
+
+    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[CHANGED], 0, row, col);
+}
+
+/*
+ * _gtk_sheet_emit_clear_cell - emit "clear-cell" for a cell
+ * 
+ * @param sheet  the #GtkSheet
+ * @param row    row number
+ * @param col    column number
+ */
+static inline void
+_gtk_sheet_emit_clear_cell(GtkSheet *sheet, gint row, gint col)
+{
+    if (!GTK_SHEET_GET_CLASS(sheet)->clear_cell
+	&& !g_signal_has_handler_pending(sheet, sheet_signals[CLEAR_CELL], 0, FALSE))
+	return;
+
+    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[CLEAR_CELL], 0, row, col);
+}
+
+/*
+ * _gtk_sheet_emit_range_changed - emit "range-changed" once 
+ * for an operation 
+ * 
+ * @param sheet  the #GtkSheet
+ * @param row0   first row
+ * @param col0   first column
+ * @param rowi   last row
+ * @param coli   last column
+ */
+static void
+_gtk_sheet_emit_range_changed(GtkSheet *sheet,
+    gint row0, gint col0, gint rowi, gint coli)
+{
+    GtkSheetRange range;
+
+    if (row0 > rowi || col0 > coli)
+	return;
+
+    if (!GTK_SHEET_GET_CLASS(sheet)->range_changed
+	&& !g_signal_has_handler_pending(sheet, sheet_signals[RANGE_CHANGED], 0, FALSE))
+	return;
+
+    range.row0 = row0;
+    range.col0 = col0;
+    range.rowi = rowi;
+    range.coli = coli;
+
+    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[RANGE_CHANGED], 0, &range);
+}
+
 
 /* defaults */
 
@@ -474,9 +705,123 @@ static void g_debug_popup(char *fmt, ...)  /* used to intercept/debug drawing se
 
 #endif
 
+/*
+ * font metrics cache
+ *
+ * Ascent and descent are looked up once per font description. The 
+ * widget style font has a slot of its own, so default row heights 
+ * need no hashing. The cache is flushed on style changes.
+ */
+
+typedef struct _GtkSheetFontMetrics
+{
+    gint ascent;   /* pango units */
+    gint descent;  /* pango units */
+} GtkSheetFontMetrics;
+
+struct _GtkSheetMetricsCache
+{
+    GHashTable *lookup;  /* PangoFontDescription -> GtkSheetFontMetrics */
+    gboolean style_valid;
+    GtkSheetFontMetrics style;  /* widget style font */
+};
+
+static GtkSheetMetricsCache *
+_gtk_sheet_metrics_cache_new(void)
+{
+    GtkSheetMetricsCache *cache = g_new0(GtkSheetMetricsCache, 1);
+
+    cache->lookup = g_hash_table_new_full(
+	(GHashFunc) pango_font_description_hash,
+	(GEqualFunc) pango_font_description_equal,
+	(GDestroyNotify) pango_font_description_free,
+	g_free);
+    cache->style_valid = FALSE;
+
+    return (cache);
+}
+
+/*
+ * _gtk_sheet_metrics_cache_flush - drop all cached font metrics
+ * 
+ * @param cache
+ */
+static void
+_gtk_sheet_metrics_cache_flush(GtkSheetMetricsCache *cache)
+{
+    g_hash_table_remove_all(cache->lookup);
+    cache->style_valid = FALSE;
+}
+
+static void
+_gtk_sheet_metrics_cache_free(GtkSheetMetricsCache *cache)
+{
+    g_hash_table_destroy(cache->lookup);
+    g_free(cache);
+}
+
+static void
+_gtk_sheet_font_metrics_query(GtkWidget *widget,
+    PangoFontDescription *font_desc, GtkSheetFontMetrics *fm)
+{
+    PangoContext *context = gtk_widget_get_pango_context(widget);
+
+    PangoFontMetrics *metrics = pango_context_get_metrics(context,
+	font_desc, pango_context_get_language(context));
+    fm->ascent = pango_font_metrics_get_ascent(metrics);
+    fm->descent = pango_font_metrics_get_descent(metrics);
+    pango_font_metrics_unref(metrics);
+
+#if GTK_SHEET_DEBUG_FONT_METRICS > 0
+    g_debug("_gtk_sheet_font_metrics_query: asc %d desc %d",
+	fm->ascent / PANGO_SCALE, fm->descent / PANGO_SCALE);
+#endif
+}
+
+/*
+ * _gtk_sheet_font_metrics - get font metrics from the cache
+ * 
+ * @param sheet
+ * @param font_desc font, NULL for the widget style font
+ * 
+ * @return metrics owned by the cache, valid until the next style 
+ *  	   change, or NULL when there is no font
+ */
+static const GtkSheetFontMetrics *
+_gtk_sheet_font_metrics(GtkSheet *sheet, PangoFontDescription *font_desc)
+{
+    GtkWidget *widget = GTK_WIDGET(sheet);
+    GtkSheetMetricsCache *cache = sheet->metrics_cache;
+    PangoFontDescription *style_font = gtk_widget_get_style(widget)->font_desc;
+    GtkSheetFontMetrics *fm;
+
+    if (!font_desc || font_desc == style_font)
+    {
+	if (!style_font)
+	    return (NULL);
+
+	if (!cache->style_valid)
+	{
+	    _gtk_sheet_font_metrics_query(widget, style_font, &cache->style);
+	    cache->style_valid = TRUE;
+	}
+	return (&cache->style);
+    }
+
+    fm = g_hash_table_lookup(cache->lookup, font_desc);
+    if (!fm)
+    {
+	fm = g_new(GtkSheetFontMetrics, 1);
+	_gtk_sheet_font_metrics_query(widget, font_desc, fm);
+	g_hash_table_insert(cache->lookup,
+	    pango_font_description_copy(font_desc), fm);
+    }
+    return (fm);
+}
+
 /**
  * _gtk_sheet_row_default_height:
- * @widget: a #GtkWidget
+ * @widget: a #GtkSheet
  * 
  * Returns: row height in pixels 
  *  
@@ -486,49 +831,226 @@ static void g_debug_popup(char *fmt, ...)  /* used to intercept/debug drawing se
 guint
 _gtk_sheet_row_default_height(GtkWidget *widget)
 {
-    PangoFontDescription *font_desc = 
-	gtk_widget_get_style(GTK_WIDGET(widget))->font_desc;
+    const GtkSheetFontMetrics *fm;
 
-    if (!font_desc)
-	return (GTK_SHEET_ROW_DEFAULT_HEIGHT);
-
-    PangoContext *context = gtk_widget_get_pango_context(widget);
+    g_return_val_if_fail(GTK_IS_SHEET(widget), GTK_SHEET_ROW_DEFAULT_HEIGHT);
 
-    PangoFontMetrics *metrics = pango_context_get_metrics(context,
-	font_desc, pango_context_get_language(context));
-    guint val = pango_font_metrics_get_descent(metrics) +
-	pango_font_metrics_get_ascent(metrics);
-    pango_font_metrics_unref(metrics);
+    fm = _gtk_sheet_font_metrics(GTK_SHEET(widget), NULL);
+    if (!fm)
+	return (GTK_SHEET_ROW_DEFAULT_HEIGHT);
 
-    return (PANGO_PIXELS(val) + 2 * CELLOFFSET);
+    return (PANGO_PIXELS(fm->ascent + fm->descent) + 2 * CELLOFFSET);
 }
 
 static inline guint
 _default_font_ascent(GtkWidget *widget)
 {
-    PangoFontDescription *font_desc = 
-	gtk_widget_get_style(GTK_WIDGET(widget))->font_desc;
+    const GtkSheetFontMetrics *fm =
+	_gtk_sheet_font_metrics(GTK_SHEET(widget), NULL);
 
-    if (!font_desc)
+    if (!fm)
 	return (GTK_SHEET_DEFAULT_FONT_ASCENT);
 
-    PangoContext *context = gtk_widget_get_pango_context(widget);
+    return (PANGO_PIXELS(fm->ascent));
+}
 
-    PangoFontMetrics *metrics = pango_context_get_metrics(context,
-	font_desc, pango_context_get_language(context));
-    guint val = pango_font_metrics_get_ascent(metrics);
-    pango_font_metrics_unref(metrics);
+/*
+ * text extent cache
+ *
+ * Measured string extents are kept in a bounded LRU cache keyed by 
+ * font, text and wrapping, shared by all columns of the sheet. 
+ * Repetitive content is measured once per distinct value.
+ */
+
+#define GTK_SHEET_EXTENT_CACHE_SIZE  8192  /* max. cached extents */
+
+typedef struct _GtkSheetExtentKey
+{
+    PangoFontDescription *font_desc;  /* copy owned by cache entries */
+    const gchar *text;                /* copy owned by cache entries */
+    guint font_hash;
+    gint wrap_mode;                   /* GTK_WRAP_NONE if not wrapped */
+    gint wrap_width;                  /* pixels, -1 if not wrapped */
+} GtkSheetExtentKey;
+
+typedef struct _GtkSheetExtentEntry
+{
+    GtkSheetExtentKey key;
+    GList link;                       /* LRU position, data is the entry */
+    guint width;
+    guint height;
+} GtkSheetExtentEntry;
+
+struct _GtkSheetExtentCache
+{
+    GHashTable *lookup;  /* GtkSheetExtentKey -> GtkSheetExtentEntry */
+    GQueue lru;          /* most recently used first */
+    guint hits;
+    guint misses;
+};
+
+static guint
+_gtk_sheet_extent_key_hash(gconstpointer k)
+{
+    const GtkSheetExtentKey *key = k;
+
+    return ((g_str_hash(key->text) * 31 + key->font_hash) * 31
+	+ (key->wrap_mode << 16) + key->wrap_width);
+}
+
+static gboolean
+_gtk_sheet_extent_key_equal(gconstpointer k1, gconstpointer k2)
+{
+    const GtkSheetExtentKey *a = k1;
+    const GtkSheetExtentKey *b = k2;
+
+    if (a->font_hash != b->font_hash
+	|| a->wrap_mode != b->wrap_mode
+	|| a->wrap_width != b->wrap_width)
+	return (FALSE);
+    if (strcmp(a->text, b->text) != 0)
+	return (FALSE);
+    if (a->font_desc != b->font_desc)
+    {
+	if (!a->font_desc || !b->font_desc)
+	    return (FALSE);
+	if (!pango_font_description_equal(a->font_desc, b->font_desc))
+	    return (FALSE);
+    }
+    return (TRUE);
+}
+
+static void
+_gtk_sheet_extent_entry_free(GtkSheetExtentEntry *entry)
+{
+    if (entry->key.font_desc)
+	pango_font_description_free(entry->key.font_desc);
+    g_free((gchar *)entry->key.text);
+    g_free(entry);
+}
+
+static GtkSheetExtentCache *
+_gtk_sheet_extent_cache_new(void)
+{
+    GtkSheetExtentCache *cache = g_new0(GtkSheetExtentCache, 1);
+
+    cache->lookup = g_hash_table_new(_gtk_sheet_extent_key_hash,
+	_gtk_sheet_extent_key_equal);
+    g_queue_init(&cache->lru);
+
+    return (cache);
+}
+
+/*
+ * _gtk_sheet_extent_cache_flush - drop all cached extents
+ * 
+ * needed whenever the pango context or font resolution changes
+ * 
+ * @param cache
+ */
+static void
+_gtk_sheet_extent_cache_flush(GtkSheetExtentCache *cache)
+{
+    GList *link;
+
+    g_hash_table_remove_all(cache->lookup);
+
+    while ((link = g_queue_pop_head_link(&cache->lru)))
+	_gtk_sheet_extent_entry_free(link->data);
+}
+
+static void
+_gtk_sheet_extent_cache_free(GtkSheetExtentCache *cache)
+{
+#if GTK_SHEET_DEBUG_EXTENT_CACHE > 0
+    g_debug("_gtk_sheet_extent_cache_free: %u hits %u misses %u entries",
+	cache->hits, cache->misses, g_hash_table_size(cache->lookup));
+#endif
+
+    _gtk_sheet_extent_cache_flush(cache);
+    g_hash_table_destroy(cache->lookup);
+    g_free(cache);
+}
+
+/*
+ * _gtk_sheet_extent_cache_insert - add a measured extent
+ * 
+ * evicts the least recently used entry when full
+ * 
+ * @param cache
+ * @param key     key, font_desc and text are copied
+ * @param width
+ * @param height
+ */
+static void
+_gtk_sheet_extent_cache_insert(GtkSheetExtentCache *cache,
+    const GtkSheetExtentKey *key, guint width, guint height)
+{
+    GtkSheetExtentEntry *entry;
+
+    if (g_queue_get_length(&cache->lru) >= GTK_SHEET_EXTENT_CACHE_SIZE)
+    {
+	GList *link = g_queue_pop_tail_link(&cache->lru);
+
+	entry = link->data;
+	g_hash_table_remove(cache->lookup, &entry->key);
+	_gtk_sheet_extent_entry_free(entry);
+    }
+
+    entry = g_new(GtkSheetExtentEntry, 1);
+    entry->key = *key;
+    entry->key.font_desc = key->font_desc ?
+	pango_font_description_copy(key->font_desc) : NULL;
+    entry->key.text = g_strdup(key->text);
+    entry->width = width;
+    entry->height = height;
 
-    return (PANGO_PIXELS(val));
+    entry->link.data = entry;
+    entry->link.prev = entry->link.next = NULL;
+    g_queue_push_head_link(&cache->lru, &entry->link);
+
+    g_hash_table_insert(cache->lookup, &entry->key, entry);
 }
 
 static void _get_string_extent(GtkSheet *sheet, GtkSheetColumn *colptr,
     PangoFontDescription *font_desc, const gchar *text,
     guint *width, guint *height)
 {
+    GtkSheetExtentCache *cache = sheet->extent_cache;
+    GtkSheetExtentKey key;
+    GtkSheetExtentEntry *entry;
     PangoRectangle extent;
     PangoLayout *layout;
 
+    key.font_desc = font_desc;
+    key.text = text ? text : "";
+    key.font_hash = font_desc ? pango_font_description_hash(font_desc) : 0;
+    key.wrap_mode = GTK_WRAP_NONE;
+    key.wrap_width = -1;
+
+    if (colptr && !gtk_sheet_autoresize_columns(sheet) 
+	&& colptr->wrap_mode != GTK_WRAP_NONE)
+    {
+	key.wrap_mode = colptr->wrap_mode;
+	key.wrap_width = colptr->width;
+    }
+
+    entry = g_hash_table_lookup(cache->lookup, &key);
+    if (entry)
+    {
+	cache->hits++;
+
+	g_queue_unlink(&cache->lru, &entry->link);
+	g_queue_push_head_link(&cache->lru, &entry->link);
+
+	if (width)
+	    *width = entry->width;
+	if (height)
+	    *height = entry->height;
+	return;
+    }
+    cache->misses++;
+
     layout = gtk_widget_create_pango_layout(GTK_WIDGET(sheet), text);
     pango_layout_set_font_description(layout, font_desc);
 
@@ -581,6 +1103,8 @@ static void _get_string_extent(GtkSheet *sheet, GtkSheetColumn *colptr,
 
     g_object_unref(G_OBJECT(layout));
 
+    _gtk_sheet_extent_cache_insert(cache, &key, extent.width, extent.height);
+
     if (width)
 	*width = extent.width;
     if (height)
@@ -590,48 +1114,514 @@ static void _get_string_extent(GtkSheet *sheet, GtkSheetColumn *colptr,
 static inline guint
 _default_font_descent(GtkWidget *widget)
 {
-    PangoFontDescription *font_desc = 
-	gtk_widget_get_style(GTK_WIDGET(widget))->font_desc;
+    const GtkSheetFontMetrics *fm =
+	_gtk_sheet_font_metrics(GTK_SHEET(widget), NULL);
 
-    if (!font_desc)
+    if (!fm)
 	return (GTK_SHEET_DEFAULT_FONT_DESCENT);
 
-    PangoContext *context = gtk_widget_get_pango_context(widget);
+    return (PANGO_PIXELS(fm->descent));
+}
 
-    PangoFontMetrics *metrics = pango_context_get_metrics(context,
-	font_desc, pango_context_get_language(context));
-    guint val =  pango_font_metrics_get_descent(metrics);
-    pango_font_metrics_unref(metrics);
+/*
+ * prefix sums
+ *
+ * Row and column offsets are kept in binary indexed (Fenwick) trees 
+ * over the row heights and column widths, hidden rows and columns 
+ * count as 0. Offset lookups, pixel hit tests and single size updates 
+ * are O(log n), the total is kept up to date.
+ * 
+ * Between gtk_sheet_geometry_begin() and gtk_sheet_geometry_commit() 
+ * size updates only flag the geometry, which is rebuilt in O(n) once.
+ */
 
-    return (PANGO_PIXELS(val));
-}
+#define GTK_SHEET_GEOMETRY_ROWS     (1 << 0)
+#define GTK_SHEET_GEOMETRY_COLUMNS  (1 << 1)
 
-/* gives the top/bottom pixel of the given row in context of the sheet's voffset */
+struct _GtkSheetPrefixSum
+{
+    gint n;       /* number of elements */
+    gint alloc;   /* allocated elements */
+    gint top;     /* highest power of 2 <= n, 0 if empty */
+    gint total;   /* sum of all elements */
+    gint *value;  /* element values */
+    gint *tree;   /* binary indexed tree, 1-based */
+};
 
-static inline gint
-_gtk_sheet_row_top_ypixel(GtkSheet *sheet, gint row)
+static GtkSheetPrefixSum *
+_gtk_sheet_psum_new(void)
 {
-    if (row < 0 || row > sheet->maxrow)
-	return (sheet->voffset);
-    return (sheet->voffset + sheet->row[row].top_ypixel);
+    return (g_new0(GtkSheetPrefixSum, 1));
 }
 
-static inline gint
-_gtk_sheet_row_bottom_ypixel(GtkSheet *sheet, gint row)
+static void
+_gtk_sheet_psum_free(GtkSheetPrefixSum *ps)
 {
-    gint ypixel = _gtk_sheet_row_top_ypixel(sheet, row);
-    if (0 <= row && row <= sheet->maxrow)
-	ypixel += sheet->row[row].height;
-    return (ypixel);
+    g_free(ps->value);
+    g_free(ps->tree);
+    g_free(ps);
 }
 
-
-/** 
- * _gtk_sheet_row_from_ypixel: 
- * @sheet:  the sheet
- * @y:      the pixel 
- *  
- * get row from y pixel location. returns the row index 
+/*
+ * _gtk_sheet_psum_resize - set the number of elements
+ * 
+ * element values must be filled in and the tree rebuilt afterwards
+ * 
+ * @param ps
+ * @param n      number of elements
+ */
+static void
+_gtk_sheet_psum_resize(GtkSheetPrefixSum *ps, gint n)
+{
+    if (n > ps->alloc)
+    {
+	ps->alloc = MAX(n, 2 * ps->alloc);
+	ps->value = g_renew(gint, ps->value, ps->alloc);
+	ps->tree = g_renew(gint, ps->tree, ps->alloc + 1);
+    }
+    ps->n = n;
+
+    ps->top = (n > 0) ? 1 : 0;
+    while (ps->top > 0 && ps->top * 2 <= n) ps->top *= 2;
+}
+
+/*
+ * _gtk_sheet_psum_rebuild - build the tree from the element values, O(n)
+ * 
+ * @param ps
+ */
+static void
+_gtk_sheet_psum_rebuild(GtkSheetPrefixSum *ps)
+{
+    gint i, j;
+
+    ps->total = 0;
+    for (i = 1; i <= ps->n; i++)
+    {
+	ps->tree[i] = ps->value[i - 1];
+	ps->total += ps->value[i - 1];
+    }
+    for (i = 1; i <= ps->n; i++)
+    {
+	j = i + (i & -i);
+	if (j <= ps->n)
+	    ps->tree[j] += ps->tree[i];
+    }
+}
+
+/*
+ * _gtk_sheet_psum_set - update a single element, O(log n)
+ * 
+ * @param ps
+ * @param idx    element index
+ * @param value  new value
+ */
+static inline void
+_gtk_sheet_psum_set(GtkSheetPrefixSum *ps, gint idx, gint value)
+{
+    gint delta = value - ps->value[idx];
+    gint i;
+
+    if (!delta)
+	return;
+
+    ps->value[idx] = value;
+    ps->total += delta;
+
+    for (i = idx + 1; i <= ps->n; i += i & -i)
+	ps->tree[i] += delta;
+}
+
+/*
+ * _gtk_sheet_psum_prefix - sum of the elements before idx, O(log n)
+ * 
+ * @param ps
+ * @param idx    element index
+ */
+static inline gint
+_gtk_sheet_psum_prefix(const GtkSheetPrefixSum *ps, gint idx)
+{
+    gint sum = 0;
+    gint i;
+
+    for (i = MIN(idx, ps->n); i > 0; i -= i & -i)
+	sum += ps->tree[i];
+
+    return (sum);
+}
+
+/*
+ * _gtk_sheet_psum_find - find the element covering an offset, O(log n)
+ * 
+ * elements of value 0 never cover an offset
+ * 
+ * @param ps
+ * @param offset >= 0
+ * 
+ * @return element index or n if offset >= total
+ */
+static inline gint
+_gtk_sheet_psum_find(const GtkSheetPrefixSum *ps, gint offset)
+{
+    gint pos = 0;
+    gint step;
+
+    for (step = ps->top; step > 0; step >>= 1)
+    {
+	if (pos + step <= ps->n && ps->tree[pos + step] <= offset)
+	{
+	    pos += step;
+	    offset -= ps->tree[pos];
+	}
+    }
+    return (pos);
+}
+
+/* the row height as seen by the row geometry */
+#define ROW_GEOMETRY_HEIGHT(sheet, rowidx) \
+    (GTK_SHEET_ROW_IS_VISIBLE(sheet, rowidx) ? ROW_HEIGHT(sheet, rowidx) : 0)
+
+/*
+ * row pages
+ *
+ * Row heights, flags and extents are kept in pages of 
+ * GTK_SHEET_ROW_PAGE_SIZE rows. A NULL page stands for visible 
+ * default rows of row_page_height pixels, so the rows of a large 
+ * model cost a pointer per page until they get resized, hidden or 
+ * measured. The row geometry has two levels: sheet->row_geometry 
+ * sums the pages, each allocated page keeps a binary indexed tree 
+ * over its rows.
+ * 
+ * Slots beyond maxrow in the last page are stale, they are reset 
+ * when rows are appended and never summed below maxrow + 1.
+ */
+
+/*
+ * _gtk_sheet_row_page_fill - reset page slots to default rows
+ * 
+ * the page tree must be rebuilt afterwards
+ * 
+ * @param page
+ * @param slot    first slot
+ * @param n       number of slots
+ * @param height  row height
+ */
+static void
+_gtk_sheet_row_page_fill(GtkSheetRowPage *page, gint slot, gint n, gint height)
+{
+    gint i;
+
+    for (i = slot; i < slot + n; i++)
+    {
+	page->height[i] = height;
+	page->flags[i] = GTK_SHEET_ROW_FLAGS_DEFAULT;
+	page->max_extent[i] = 0;
+	page->max_count[i] = 0;
+    }
+}
+
+/*
+ * _gtk_sheet_row_page_rebuild - build the page tree from the rows, 
+ * O(page size)
+ * 
+ * @param page
+ */
+static void
+_gtk_sheet_row_page_rebuild(GtkSheetRowPage *page)
+{
+    gint i, j;
+
+    page->total = 0;
+    for (i = 1; i <= GTK_SHEET_ROW_PAGE_SIZE; i++)
+    {
+	page->tree[i] = (page->flags[i - 1] & GTK_SHEET_ROW_FLAG_VISIBLE) ?
+	    page->height[i - 1] : 0;
+	page->total += page->tree[i];
+    }
+    for (i = 1; i <= GTK_SHEET_ROW_PAGE_SIZE; i++)
+    {
+	j = i + (i & -i);
+	if (j <= GTK_SHEET_ROW_PAGE_SIZE)
+	    page->tree[j] += page->tree[i];
+    }
+}
+
+/*
+ * _gtk_sheet_row_page_prefix - sum of the rows before a slot, O(log n)
+ * 
+ * @param page
+ * @param slot   slot index
+ */
+static inline gint
+_gtk_sheet_row_page_prefix(const GtkSheetRowPage *page, gint slot)
+{
+    gint sum = 0;
+    gint i;
+
+    for (i = slot; i > 0; i -= i & -i)
+	sum += page->tree[i];
+
+    return (sum);
+}
+
+/*
+ * _gtk_sheet_row_page_find - find the slot covering an offset, O(log n)
+ * 
+ * @param page
+ * @param offset >= 0
+ * 
+ * @return slot index or GTK_SHEET_ROW_PAGE_SIZE if offset >= total
+ */
+static inline gint
+_gtk_sheet_row_page_find(const GtkSheetRowPage *page, gint offset)
+{
+    gint pos = 0;
+    gint step;
+
+    for (step = GTK_SHEET_ROW_PAGE_SIZE; step > 0; step >>= 1)
+    {
+	if (pos + step <= GTK_SHEET_ROW_PAGE_SIZE && page->tree[pos + step] <= offset)
+	{
+	    pos += step;
+	    offset -= page->tree[pos];
+	}
+    }
+    return (pos);
+}
+
+/*
+ * _gtk_sheet_row_page_get - get the page of a row for an update
+ * 
+ * a NULL page is allocated holding default rows, the page sum 
+ * does not change
+ * 
+ * @param sheet
+ * @param row    row index
+ */
+static GtkSheetRowPage *
+_gtk_sheet_row_page_get(GtkSheet *sheet, gint row)
+{
+    GtkSheetRowPage **pp = &ROW_PAGE(sheet, row);
+
+    if (!*pp)
+    {
+	*pp = g_new(GtkSheetRowPage, 1);
+	_gtk_sheet_row_page_fill(*pp, 0, GTK_SHEET_ROW_PAGE_SIZE, sheet->row_page_height);
+	_gtk_sheet_row_page_rebuild(*pp);
+    }
+    return (*pp);
+}
+
+static inline void
+_gtk_sheet_row_set_height(GtkSheet *sheet, gint row, gint height)
+{
+    if (ROW_PAGE(sheet, row) || height != sheet->row_page_height)
+	_gtk_sheet_row_page_get(sheet, row)->height[ROW_SLOT(row)] = height;
+}
+
+static inline void
+_gtk_sheet_row_set_max_extent(GtkSheet *sheet, gint row, gint extent)
+{
+    if (ROW_PAGE(sheet, row) || extent != 0)
+	_gtk_sheet_row_page_get(sheet, row)->max_extent[ROW_SLOT(row)] = extent;
+}
+
+static inline void
+_gtk_sheet_row_set_max_count(GtkSheet *sheet, gint row, guint count)
+{
+    if (ROW_PAGE(sheet, row) || count != 0)
+	_gtk_sheet_row_page_get(sheet, row)->max_count[ROW_SLOT(row)] = count;
+}
+
+static inline void
+_gtk_sheet_row_set_flag(GtkSheet *sheet, gint row, guint8 flag, gboolean value)
+{
+    GtkSheetRowPage *page;
+
+    if (((ROW_FLAGS(sheet, row) & flag) != 0) == (value != FALSE))
+	return;  /* unchanged, keep default rows */
+
+    page = _gtk_sheet_row_page_get(sheet, row);
+    if (value)
+	page->flags[ROW_SLOT(row)] |= flag;
+    else
+	page->flags[ROW_SLOT(row)] &= ~flag;
+}
+
+/*
+ * _gtk_sheet_row_pages_reset - reset rows to default rows
+ * 
+ * pages are only allocated for rows differing from row_page_height
+ * 
+ * @param sheet
+ * @param row     first row
+ * @param n       number of rows
+ * @param height  row height
+ */
+static void
+_gtk_sheet_row_pages_reset(GtkSheet *sheet, gint row, gint n, gint height)
+{
+    gint len;
+
+    while (n > 0)
+    {
+	len = MIN(n, GTK_SHEET_ROW_PAGE_SIZE - ROW_SLOT(row));
+
+	if (ROW_PAGE(sheet, row) || height != sheet->row_page_height)
+	{
+	    _gtk_sheet_row_page_fill(_gtk_sheet_row_page_get(sheet, row),
+		ROW_SLOT(row), len, height);
+	}
+	row += len;
+	n -= len;
+    }
+}
+
+/*
+ * _gtk_sheet_row_pages_move - move rows like memmove()
+ * 
+ * default rows moving onto default rows are skipped, the page 
+ * trees must be rebuilt afterwards
+ * 
+ * @param sheet
+ * @param dst    first destination row
+ * @param src    first source row
+ * @param n      number of rows
+ */
+static void
+_gtk_sheet_row_pages_move(GtkSheet *sheet, gint dst, gint src, gint n)
+{
+    GtkSheetRowPage *sp, *dp;
+    gint d, s, len;
+
+    while (n > 0)
+    {
+	if (dst < src)  /* front to back */
+	{
+	    len = MIN(n, GTK_SHEET_ROW_PAGE_SIZE - MAX(ROW_SLOT(dst), ROW_SLOT(src)));
+	    d = dst;
+	    s = src;
+	    dst += len;
+	    src += len;
+	}
+	else  /* back to front */
+	{
+	    len = MIN(n, MIN(ROW_SLOT(dst + n - 1), ROW_SLOT(src + n - 1)) + 1);
+	    d = dst + n - len;
+	    s = src + n - len;
+	}
+	n -= len;
+
+	sp = ROW_PAGE(sheet, s);
+	dp = ROW_PAGE(sheet, d);
+
+	if (!sp && !dp)
+	    continue;
+
+	dp = _gtk_sheet_row_page_get(sheet, d);
+
+	if (!sp)
+	{
+	    _gtk_sheet_row_page_fill(dp, ROW_SLOT(d), len, sheet->row_page_height);
+	    continue;
+	}
+
+	memmove(&dp->height[ROW_SLOT(d)], &sp->height[ROW_SLOT(s)], len * sizeof(gint));
+	memmove(&dp->flags[ROW_SLOT(d)], &sp->flags[ROW_SLOT(s)], len * sizeof(guint8));
+	memmove(&dp->max_extent[ROW_SLOT(d)], &sp->max_extent[ROW_SLOT(s)], len * sizeof(gint));
+	memmove(&dp->max_count[ROW_SLOT(d)], &sp->max_count[ROW_SLOT(s)], len * sizeof(guint));
+    }
+}
+
+/*
+ * _gtk_sheet_row_offset - sum of the visible row heights above a row, 
+ * O(log n)
+ * 
+ * @param sheet
+ * @param row    row index, 0..maxrow+1
+ */
+static inline gint
+_gtk_sheet_row_offset(GtkSheet *sheet, gint row)
+{
+    gint p = row >> GTK_SHEET_ROW_PAGE_SHIFT;
+    gint slot = ROW_SLOT(row);
+    gint sum = _gtk_sheet_psum_prefix(sheet->row_geometry, p);
+
+    if (!slot || p >= sheet->row_npages)
+	return (sum);
+
+    if (sheet->row_pages[p])
+	return (sum + _gtk_sheet_row_page_prefix(sheet->row_pages[p], slot));
+
+    return (sum + slot * sheet->row_page_height);
+}
+
+/*
+ * _gtk_sheet_row_find - find the row covering an offset, O(log n)
+ * 
+ * @param sheet
+ * @param offset >= 0
+ * 
+ * @return row index, > maxrow if offset >= total
+ */
+static inline gint
+_gtk_sheet_row_find(GtkSheet *sheet, gint offset)
+{
+    gint p = _gtk_sheet_psum_find(sheet->row_geometry, offset);
+    gint slot;
+
+    if (p >= sheet->row_npages)
+	return (sheet->row_npages << GTK_SHEET_ROW_PAGE_SHIFT);
+
+    offset -= _gtk_sheet_psum_prefix(sheet->row_geometry, p);
+
+    if (sheet->row_pages[p])
+	slot = _gtk_sheet_row_page_find(sheet->row_pages[p], offset);
+    else
+	slot = offset / MAX(sheet->row_page_height, 1);
+
+    return ((p << GTK_SHEET_ROW_PAGE_SHIFT) + slot);
+}
+
+/* the height of the column title area, if visible */
+#define COLUMN_TITLES_HEIGHT(sheet) \
+    ((sheet)->column_titles_visible ? (sheet)->column_title_area.height : 0)
+
+/* the column width as seen by the column geometry */
+#define COLUMN_GEOMETRY_WIDTH(sheet, colidx) \
+    (GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, colidx)) ? COLPTR(sheet, colidx)->width : 0)
+
+/* the width of the row title area, if visible */
+#define ROW_TITLES_WIDTH(sheet) \
+    ((sheet)->row_titles_visible ? (sheet)->row_title_area.width : 0)
+
+/* gives the top/bottom pixel of the given row in context of the sheet's voffset */
+
+static inline gint
+_gtk_sheet_row_top_ypixel(GtkSheet *sheet, gint row)
+{
+    if (row < 0 || row > sheet->maxrow)
+	return (sheet->voffset);
+    return (sheet->voffset + COLUMN_TITLES_HEIGHT(sheet)
+	+ _gtk_sheet_row_offset(sheet, row));
+}
+
+static inline gint
+_gtk_sheet_row_bottom_ypixel(GtkSheet *sheet, gint row)
+{
+    gint ypixel = _gtk_sheet_row_top_ypixel(sheet, row);
+    if (0 <= row && row <= sheet->maxrow)
+	ypixel += ROW_HEIGHT(sheet, row);
+    return (ypixel);
+}
+
+
+/** 
+ * _gtk_sheet_row_from_ypixel: 
+ * @sheet:  the sheet
+ * @y:      the pixel 
+ *  
+ * get row from y pixel location. returns the row index 
  * from a y pixel location (relative to the sheet window) 
  * honoring the sheet's scrolling offset and title visibility.
  * 
@@ -643,27 +1633,15 @@ _gtk_sheet_row_bottom_ypixel(GtkSheet *sheet, gint row)
 static inline gint
 _gtk_sheet_row_from_ypixel(GtkSheet *sheet, gint y)
 {
-    gint i, cy;
+    gint cy;
 
-    cy = sheet->voffset;
-    if (sheet->column_titles_visible)
-	cy += sheet->column_title_area.height;
+    cy = sheet->voffset + COLUMN_TITLES_HEIGHT(sheet);
 
     if (y < cy)
 	return (-1);    /* top outside */
 
-    for (i = 0; i <= sheet->maxrow; i++)
-    {
-	if (GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, i)))
-	{
-	    if (cy <= y  && y < (cy + sheet->row[i].height))
-		return (i);
-	    cy += sheet->row[i].height;
-	}
-    }
-
-    /* no match */
-    return (sheet->maxrow + 1);
+    /* maxrow + 1 if no match */
+    return (MIN(_gtk_sheet_row_find(sheet, y - cy), sheet->maxrow + 1));
 }
 
 
@@ -684,28 +1662,16 @@ _gtk_sheet_row_from_ypixel(GtkSheet *sheet, gint y)
 static inline gint
 _gtk_sheet_column_from_xpixel(GtkSheet *sheet, gint x)
 {
-    gint i, cx;
+    gint cx;
 
-    cx = sheet->hoffset;
-    if (sheet->row_titles_visible)
-	cx += sheet->row_title_area.width;
+    cx = sheet->hoffset + ROW_TITLES_WIDTH(sheet);
 
     if (x < cx) {
 	return (-1);  /* left outside */
     }
 
-    for (i = 0; i <= sheet->maxcol; i++)
-    {
-	if (GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, i)))
-	{
-	    if (cx <= x  && x < (cx + COLPTR(sheet, i)->width))
-		return (i);
-	    cx += COLPTR(sheet, i)->width;
-	}
-    }
-
-    /* no match */
-    return (sheet->maxcol + 1);
+    /* maxcol + 1 if no match */
+    return (MIN(_gtk_sheet_psum_find(sheet->column_geometry, x - cx), sheet->maxcol + 1));
 }
 
 /**
@@ -759,7 +1725,7 @@ static inline gint _gtk_sheet_first_visible_rowidx(GtkSheet *sheet, gint startid
     gint i;
     for (i = startidx; i <= sheet->maxrow; i++)
     {
-	if (GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, i)))
+	if (GTK_SHEET_ROW_IS_VISIBLE(sheet, i))
 	    return (i);
     }
     return (-1);
@@ -778,7 +1744,7 @@ static inline gint _gtk_sheet_last_visible_rowidx(GtkSheet *sheet, gint startidx
     gint i;
     for (i = startidx; i >= 0; i--)
     {
-	if (GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, i)))
+	if (GTK_SHEET_ROW_IS_VISIBLE(sheet, i))
 	    return (i);
     }
     return (-1);
@@ -835,7 +1801,7 @@ static inline void _gtk_sheet_count_visible(GtkSheet *sheet,
 
     for (i = range->row0; i <= range->rowi; i++)
     {
-	if (GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, i)))
+	if (GTK_SHEET_ROW_IS_VISIBLE(sheet, i))
 	    ++(*nrows);
     }
     for (i = range->col0; i <= range->coli; i++)
@@ -859,18 +1825,8 @@ static inline void _gtk_sheet_count_visible(GtkSheet *sheet,
 gint
 gtk_sheet_height(GtkSheet *sheet)
 {
-    gint i, cx;
-
-    cx = (sheet->column_titles_visible ? sheet->column_title_area.height : 0);
-
-    for (i = 0; i <= sheet->maxrow; i++)
-    {
-	if (GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, i)))
-	    cx += sheet->row[i].height;
-    }
-
-    return (cx);
-}
+    return (COLUMN_TITLES_HEIGHT(sheet) + _gtk_sheet_row_offset(sheet, sheet->maxrow + 1));
+}
 
 /**
  * gtk_sheet_width: 
@@ -884,17 +1840,7 @@ gtk_sheet_height(GtkSheet *sheet)
 gint
 gtk_sheet_width(GtkSheet *sheet)
 {
-    gint i, cx;
-
-    cx = (sheet->row_titles_visible ? sheet->row_title_area.width : 0);
-
-    for (i = 0; i <= sheet->maxcol; i++)
-    {
-	if (GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, i)))
-	    cx += COLPTR(sheet, i)->width;
-    }
-
-    return (cx);
+    return (ROW_TITLES_WIDTH(sheet) + sheet->column_geometry->total);
 }
 
 /**
@@ -1014,7 +1960,7 @@ POSSIBLE_YDRAG(GtkSheet *sheet, gint y, gint *drag_row)
 
     if (row > 0 && y <= ydrag + DRAG_WIDTH / 2)  /* you pick it at the top border */
     {
-	while (row > 0 && !GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row - 1))) row--;
+	while (row > 0 && !GTK_SHEET_ROW_IS_VISIBLE(sheet, row - 1)) row--;
 
 	--row;  /* you really want to resize the row above */
 
@@ -1024,7 +1970,7 @@ POSSIBLE_YDRAG(GtkSheet *sheet, gint y, gint *drag_row)
 	*drag_row = row;
 	return (TRUE);
 #if 0
-	return(GTK_SHEET_ROW_IS_SENSITIVE(ROWPTR(sheet, row)));
+	return(GTK_SHEET_ROW_IS_SENSITIVE(sheet, row));
 #endif
     }
 
@@ -1035,7 +1981,7 @@ POSSIBLE_YDRAG(GtkSheet *sheet, gint y, gint *drag_row)
 	*drag_row = row;
 	return (TRUE);
 #if 0
-	return(GTK_SHEET_ROW_IS_SENSITIVE(ROWPTR(sheet, row)));
+	return(GTK_SHEET_ROW_IS_SENSITIVE(sheet, row));
 #endif
     }
 
@@ -1205,8 +2151,9 @@ static gint gtk_sheet_flash(gpointer data);
 
 /* Drawing Routines */
 
-/* draw cell background and frame */
-static void _cell_draw_background(GtkSheet *sheet, gint row, gint column);
+/* render cells with cairo */
+static void _gtk_sheet_range_render(GtkSheet *sheet, cairo_t *cr,
+    const GtkSheetRange *range);
 
 /* draw cell border */
 static void _cell_draw_border(GtkSheet *sheet,
@@ -1215,6 +2162,79 @@ static void _cell_draw_border(GtkSheet *sheet,
 /* draw cell contents */
 static void _cell_draw_label(GtkSheet *sheet, gint row, gint column);
 
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+/* columns with text overflowing into a range */
+static void _gtk_sheet_range_add_text_columns(GtkSheet *sheet, GtkSheetRange *range);
+static void _gtk_sheet_text_column_targets(GtkSheet *sheet, GtkSheetRange *range);
+#endif
+
+#if GTK_SHEET_TILE_CACHE
+/* rendered tiles */
+#define GTK_SHEET_TILE_ROWS     32  /* rows per tile */
+#define GTK_SHEET_TILE_COLUMNS  8   /* columns per tile */
+
+typedef struct _GtkSheetTile
+{
+    gint trow;                 /* key: tile row and column */
+    gint tcol;
+    cairo_surface_t *surface;  /* NULL when no cell is visible */
+    gsize bytes;
+    guint paint_serial;        /* last paint that used the tile */
+    GList link;                /* in cache->lru, data is the tile */
+} GtkSheetTile;
+
+struct _GtkSheetTileCache
+{
+    GHashTable *lookup;  /* (trow, tcol) -> GtkSheetTile */
+    GQueue lru;          /* most recently used first */
+    gsize bytes;         /* size of all tile surfaces */
+    gsize budget;        /* max. bytes */
+    guint paint_serial;
+    GtkSheetRange view;  /* view at the last paint */
+    gint drow, dcol;     /* scroll direction */
+    guint prerender_idle;
+};
+
+static GtkSheetTileCache *_gtk_sheet_tile_cache_new(void);
+static void _gtk_sheet_tile_cache_flush(GtkSheetTileCache *cache);
+static void _gtk_sheet_tile_cache_drop(GtkSheetTileCache *cache, const GtkSheetRange *range);
+static void _gtk_sheet_tile_cache_free(GtkSheetTileCache *cache);
+static void _gtk_sheet_tile_cache_trim(GtkSheetTileCache *cache);
+#endif
+
+#if GTK_SHEET_RENDER_THREADS
+/* worker threads */
+struct _GtkSheetRenderPool
+{
+    GThreadPool *pool;
+    GThreadPool *extent_pool;  /* measures GtkSheetExtentSlice */
+    guint n_threads;
+    GAsyncQueue *contexts;  /* idle GtkSheetRenderContext */
+
+    /* font setup of the sheet, bumps serial when changed */
+    guint serial;
+    cairo_font_options_t *font_options;
+    gdouble resolution;
+    PangoLanguage *language;
+    PangoDirection base_dir;
+    PangoFontDescription *font_desc;
+};
+
+static GtkSheetRenderPool *_gtk_sheet_render_pool_new(guint n_threads);
+static void _gtk_sheet_render_pool_free(GtkSheetRenderPool *pool);
+static void _gtk_sheet_measure_cells_threaded(GtkSheet *sheet, GPtrArray *cells);
+#endif
+
+/* texts pulled from the model */
+static void _gtk_sheet_model_cache_free(GtkSheetModelCache *cache);
+static void _gtk_sheet_model_set_cell(GtkSheet *sheet, gint row, gint col,
+    GtkJustification justification, const gchar *text);
+
+/* retained cell layouts */
+static GtkSheetLayoutCache *_gtk_sheet_layout_cache_new(void);
+static void _gtk_sheet_layout_cache_flush(GtkSheetLayoutCache *cache);
+static void _gtk_sheet_layout_cache_free(GtkSheetLayoutCache *cache);
+
 /* highlight the visible part of the selected range */
 static void gtk_sheet_range_draw_selection(GtkSheet *sheet, GtkSheetRange range);
 
@@ -1278,13 +2298,57 @@ static void gtk_sheet_set_cell_attributes(GtkSheet *sheet,
     gint row, gint col, GtkSheetCellAttr attributes);
 static void init_attributes(GtkSheet *sheet, gint col, GtkSheetCellAttr *attributes);
 
+typedef void (*GtkSheetAttrFunc) (GtkSheetCellAttr *attributes, gpointer data);
+typedef struct _GtkSheetAttrEntry GtkSheetAttrEntry;
+
+/* attribute fields, as set by the range setters */
+enum
+{
+    GTK_SHEET_ATTR_BACKGROUND = 1 << 0,
+    GTK_SHEET_ATTR_FOREGROUND = 1 << 1,
+    GTK_SHEET_ATTR_JUSTIFICATION = 1 << 2,
+    GTK_SHEET_ATTR_FONT = 1 << 3,
+    GTK_SHEET_ATTR_BORDER = 1 << 4,
+    GTK_SHEET_ATTR_BORDER_COLOR = 1 << 5,
+    GTK_SHEET_ATTR_EDITABLE = 1 << 6,
+    GTK_SHEET_ATTR_VISIBLE = 1 << 7,
+    GTK_SHEET_ATTR_SENSITIVE = 1 << 8,
+    GTK_SHEET_ATTR_CAN_FOCUS = 1 << 9,
+};
+
+#define GTK_SHEET_ATTR_NFIELDS  10
+#define GTK_SHEET_ATTR_ALL  ((1 << GTK_SHEET_ATTR_NFIELDS) - 1)
+
+static void _gtk_sheet_range_modify_attributes(GtkSheet *sheet,
+    const GtkSheetRange *range, guint fields,
+    GtkSheetAttrFunc func, gpointer data);
+static void _gtk_sheet_cell_override(GtkSheet *sheet, gint row, gint col,
+    const GtkSheetCellAttr *attributes, guint set, guint unset);
+static GtkSheetAttrTable *_gtk_sheet_attr_table_new(void);
+static void _gtk_sheet_attr_table_free(GtkSheetAttrTable *table);
+static guint _gtk_sheet_attr_intern(GtkSheet *sheet,
+    const GtkSheetCellAttr *attributes, guint mask);
+static void _gtk_sheet_attr_ref(GtkSheet *sheet, guint id);
+static void _gtk_sheet_attr_unref(GtkSheet *sheet, guint id);
+static const GtkSheetAttrEntry *_gtk_sheet_attr_lookup(GtkSheet *sheet, guint id);
+static void _gtk_sheet_attr_layer_free(GtkSheetAttrLayer *layer);
+static void _gtk_sheet_attr_rules_free(GtkSheet *sheet);
+static void _gtk_sheet_attr_rules_adjust(GtkSheet *sheet,
+    gboolean rows, gint position, gint n);
+
+/* row data records */
+static void _gtk_sheet_row_free(GtkSheetRow *row);
+static inline GtkSheetRow *_gtk_sheet_row_peek(GtkSheet *sheet, gint row);
+static GtkSheetRow *_gtk_sheet_row_get(GtkSheet *sheet, gint row);
+static const GtkSheetButton *_gtk_sheet_row_button(GtkSheet *sheet, gint row);
+
 /* Memory allocation routines */
 static void gtk_sheet_real_range_clear(GtkSheet *sheet,
     const GtkSheetRange *range, gboolean delete);
 static void gtk_sheet_real_cell_clear(GtkSheet *sheet,
 				      gint row, gint column, gboolean delete);
 
-static GtkSheetCell *gtk_sheet_cell_new(void);
+static GtkSheetCell *gtk_sheet_cell_new(GtkSheet *sheet);
 
 static void AddRows(GtkSheet *sheet, gint position, gint nrows);
 static void AddColumns(GtkSheet *sheet, gint position, gint ncols);
@@ -1295,6 +2359,20 @@ static void DeleteColumn(GtkSheet *sheet, gint col, gint ncols);
 static gint GrowSheet(GtkSheet *sheet, gint newrows, gint newcols);
 static void CheckBounds(GtkSheet *sheet, gint row, gint col);
 static void CheckCellData(GtkSheet *sheet, const gint row, const gint col);
+static void PutCellData(GtkSheet *sheet, gint row, gint col, GtkSheetCell *cell);
+static GPtrArray *CollectCellData(GtkSheet *sheet,
+    gint row0, gint rowi, gint col0, gint coli);
+static void MoveCellData(GtkSheet *sheet,
+    gint row0, gint col0, gint drow, gint dcol);
+static void DeleteCellData(GtkSheet *sheet,
+    gint row0, gint rowi, gint col0, gint coli);
+static void FreeCellData(GtkSheet *sheet);
+
+static GtkSheetCell *PoolCellAlloc(GtkSheet *sheet);
+static void PoolCellFree(GtkSheet *sheet, GtkSheetCell *cell);
+static gchar *PoolStrdup(GtkSheet *sheet, const gchar *str);
+static void PoolStrfree(GtkSheet *sheet, gchar *str);
+static void PoolTrim(GtkSheet *sheet, gboolean force);
 
 /* Container Functions */
 static void gtk_sheet_remove_handler(GtkContainer *container, GtkWidget *widget);
@@ -1363,7 +2441,7 @@ gtk_sheet_buildable_add_child_internal(GtkSheet *sheet,
     if (name)
 	gtk_widget_set_name(GTK_WIDGET(child), name);
 
-    _gtk_sheet_reset_text_column(sheet, col);
+    _gtk_sheet_reset_text_column(sheet, col - 1);
     _gtk_sheet_recalc_left_xpixels(sheet);
 }
 
@@ -1467,10 +2545,9 @@ gtk_sheet_query_tooltip_handler(GtkWidget *widget,
 	    col = _gtk_sheet_column_from_xpixel(sheet, x);
 
 	if ((0 <= row && row <= sheet->maxrow && 0 <= col && col <= sheet->maxcol)
-	    && (row <= sheet->maxallocrow && col <= sheet->maxalloccol)
-	    && (sheet->data[row] && sheet->data[row][col]))
+	    && _gtk_sheet_cell_get(sheet, row, col))
 	{
-	    GtkSheetCell *cell = sheet->data[row][col];
+	    GtkSheetCell *cell = _gtk_sheet_cell_get(sheet, row, col);
 
 	    tip = cell->tooltip_markup;
 	    if (tip && tip[0])
@@ -1495,9 +2572,9 @@ gtk_sheet_query_tooltip_handler(GtkWidget *widget,
 	if (row < 0)
 	    row = _gtk_sheet_row_from_ypixel(sheet, y);
 
-	if (0 <= row && row <= sheet->maxrow)
+	if (0 <= row && row <= sheet->maxrow && _gtk_sheet_row_peek(sheet, row))
 	{
-	    GtkSheetRow *rowp = ROWPTR(sheet, row);
+	    GtkSheetRow *rowp = _gtk_sheet_row_peek(sheet, row);
 
 	    tip = rowp->tooltip_markup;
 	    if (tip && tip[0])
@@ -1835,6 +2912,10 @@ gtk_sheet_set_property(GObject *object,
 	    gtk_sheet_set_clip_text(sheet, g_value_get_boolean(value));
 	    break;
 
+	case PROP_GTK_SHEET_CAIRO_DRAW:
+	    gtk_sheet_set_cairo_draw(sheet, g_value_get_boolean(value));
+	    break;
+
 	case PROP_GTK_SHEET_JUSTIFY_ENTRY:
 	    gtk_sheet_set_justify_entry(sheet, g_value_get_boolean(value));
 	    break;
@@ -1963,6 +3044,10 @@ gtk_sheet_get_property(GObject    *object,
 	    g_value_set_boolean(value, sheet->clip_text);
 	    break;
 
+	case PROP_GTK_SHEET_CAIRO_DRAW:
+	    g_value_set_boolean(value, sheet->cairo_draw);
+	    break;
+
 	case PROP_GTK_SHEET_JUSTIFY_ENTRY:
 	    g_value_set_boolean(value, sheet->justify_entry);
 	    break;
@@ -2166,6 +3251,17 @@ gtk_sheet_class_init_properties(GObjectClass *gobject_class)
 	G_PARAM_READWRITE);
     g_object_class_install_property(gobject_class, PROP_GTK_SHEET_CLIP_TEXT, pspec);
 
+    /**
+     * GtkSheet:cairo-draw:
+     *
+     * Render cells with cairo instead of GdkGC
+     */
+    pspec = g_param_spec_boolean("cairo-draw", "Cairo drawing",
+	"Render cells with cairo instead of GdkGC",
+	FALSE,
+	G_PARAM_READWRITE);
+    g_object_class_install_property(gobject_class, PROP_GTK_SHEET_CAIRO_DRAW, pspec);
+
     pspec = g_param_spec_boolean("justify-entry", "Justify cell entry",
 	"Adapt cell entry editor to the cell justification",
 	TRUE,
@@ -2631,6 +3727,43 @@ _gtk_sheet_class_init_signals(GtkObjectClass *object_class,
 	gtksheet_VOID__INT_INT,
 	G_TYPE_NONE, 2, G_TYPE_INT, G_TYPE_INT);
 
+    /**
+     * GtkSheet::range-changed:
+     * @sheet: the sheet widget that emitted the signal
+     * @range: the #GtkSheetRange whose contents changed
+     *
+     * Emited once per operation changing cell contents, i.e. 
+     * setting, loading, clearing or deleting cells and inserting 
+     * or deleting rows and columns. 
+     */
+    sheet_signals[RANGE_CHANGED] =
+	g_signal_new("range-changed",
+	G_TYPE_FROM_CLASS(object_class),
+	G_SIGNAL_RUN_LAST,
+	G_STRUCT_OFFSET(GtkSheetClass, range_changed),
+	NULL, NULL,
+	gtksheet_VOID__BOXED,
+	G_TYPE_NONE, 1, G_TYPE_SHEET_RANGE);
+
+    /**
+     * GtkSheet::extents-progress:
+     * @sheet: the sheet widget that emitted the signal
+     * @done: rows measured so far
+     * @total: rows to measure
+     *
+     * Emited while cell extents are measured in the background 
+     * after a style change or gtk_sheet_refresh_extents(). The 
+     * last emission has @done equal to @total. 
+     */
+    sheet_signals[EXTENTS_PROGRESS] =
+	g_signal_new("extents-progress",
+	G_TYPE_FROM_CLASS(object_class),
+	G_SIGNAL_RUN_LAST,
+	G_STRUCT_OFFSET(GtkSheetClass, extents_progress),
+	NULL, NULL,
+	gtksheet_VOID__INT_INT,
+	G_TYPE_NONE, 2, G_TYPE_INT, G_TYPE_INT);
+
     /**
      * GtkSheet::new-column-width:
      * @sheet: the sheet widget that emitted the signal
@@ -3159,6 +4292,7 @@ gtk_sheet_init(GtkSheet *sheet)
     sheet->autoresize_rows = FALSE;
     sheet->autoscroll = TRUE;
     sheet->clip_text = FALSE;
+    sheet->text_spread_dirty = FALSE;
     sheet->justify_entry = TRUE;
     sheet->locked = FALSE;
 
@@ -3188,7 +4322,15 @@ gtk_sheet_init(GtkSheet *sheet)
 
     sheet->title = NULL;
 
-    sheet->row = NULL;
+    sheet->row_pages = NULL;
+    sheet->row_npages = 0;
+    sheet->row_page_height = 0;
+    sheet->row_data = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+	NULL, (GDestroyNotify)_gtk_sheet_row_free);
+    sheet->row_data_last = -1;
+    sheet->row_extent_hist = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+	NULL, (GDestroyNotify)g_sequence_free);
+    sheet->row_extent_hist_last = -1;
     sheet->column = NULL;
 
     sheet->rows_resizable = TRUE;
@@ -3203,10 +4345,35 @@ gtk_sheet_init(GtkSheet *sheet)
     sheet->view.coli = -1;
 
     sheet->data = NULL;
+    sheet->data_block_rows = 0;
+    sheet->data_block_cols = 0;
 
     sheet->maxallocrow = -1;
     sheet->maxalloccol = -1;
 
+    sheet->mem_pool = g_new0(GtkSheetMemPool, 1);
+    sheet->attr_table = _gtk_sheet_attr_table_new();
+    sheet->attr_rules = NULL;
+    sheet->attr_rule_bands = g_ptr_array_new();
+    sheet->attr_serial = 0;
+
+    sheet->row_geometry = _gtk_sheet_psum_new();
+    sheet->column_geometry = _gtk_sheet_psum_new();
+    sheet->geometry_batch = 0;
+    sheet->geometry_dirty = 0;
+    sheet->metrics_cache = _gtk_sheet_metrics_cache_new();
+    sheet->extent_cache = _gtk_sheet_extent_cache_new();
+    sheet->layout_cache = _gtk_sheet_layout_cache_new();
+    sheet->dirty_ranges = g_array_new(FALSE, FALSE, sizeof(GtkSheetRange));
+    sheet->dirty_idle = 0;
+    sheet->cairo_draw = FALSE;  /* see gtk_sheet_set_cairo_draw() */
+    sheet->tile_cache = NULL;  /* see gtk_sheet_set_tile_cache_size() */
+    sheet->render_pool = NULL;  /* see gtk_sheet_set_render_threads() */
+    sheet->model = NULL;
+    sheet->model_cache = NULL;
+    sheet->extent_idle = 0;
+    sheet->extent_cursor = 0;
+
     sheet->active_cell.row = -1;
     sheet->active_cell.col = -1;
 
@@ -3292,13 +4459,10 @@ gtk_sheet_init(GtkSheet *sheet)
 
 
 static void
-_gtk_sheet_row_init(GtkSheetRow *row)
+_gtk_sheet_row_init(GtkSheetRow *row, guint height)
 {
     row->name = NULL;
-    row->height = GTK_SHEET_ROW_DEFAULT_HEIGHT;
-    row->requisition = GTK_SHEET_ROW_DEFAULT_HEIGHT;
-    row->top_ypixel = 0;
-    row->max_extent_height = 0;
+    row->requisition = height;
 
     row->button.state = GTK_STATE_NORMAL;
     row->button.label = NULL;
@@ -3308,39 +4472,159 @@ _gtk_sheet_row_init(GtkSheetRow *row)
 
     row->tooltip_markup = NULL;
     row->tooltip_text = NULL;
-
-    GTK_SHEET_ROW_SET_VISIBLE(row, TRUE);
-    GTK_SHEET_ROW_SET_SENSITIVE(row, TRUE);
-    GTK_SHEET_ROW_SET_READONLY(row, FALSE);
-    GTK_SHEET_ROW_SET_CAN_FOCUS(row, TRUE);
+    row->attr_layer = NULL;
 }
 
 static void
-gtk_sheet_row_finalize(GtkSheetRow *row)
+_gtk_sheet_row_free(GtkSheetRow *row)
 {
-    if (row->name)
-    {
-	g_free(row->name);
-	row->name = NULL;
-    }
+    g_free(row->name);
+    g_free(row->button.label);
+    g_free(row->tooltip_markup);
+    g_free(row->tooltip_text);
+
+    if (row->attr_layer)
+	_gtk_sheet_attr_layer_free(row->attr_layer);
+
+    g_free(row);
+}
+
+/*
+ * row data
+ *
+ * Row heights, flags and extent maxima are kept in arrays of the 
+ * sheet, scanned by the geometry, drawing and traversal code. 
+ * Titles, buttons, tooltips and row styles are only needed for a 
+ * few rows, they live in GtkSheetRow records in the sheet's 
+ * row_data table, created on first write. Rows without a record 
+ * read as defaults.
+ */
+
+/*
+ * _gtk_sheet_row_peek - the data record of a row
+ * 
+ * @param sheet
+ * @param row    row index
+ * 
+ * @return the #GtkSheetRow or NULL for default data
+ */
+static inline GtkSheetRow *
+_gtk_sheet_row_peek(GtkSheet *sheet, gint row)
+{
+    return (g_hash_table_lookup(sheet->row_data, GINT_TO_POINTER(row)));
+}
+
+/*
+ * _gtk_sheet_row_get - the data record of a row, created if needed
+ * 
+ * @param sheet
+ * @param row    row index
+ * 
+ * @return the #GtkSheetRow
+ */
+static GtkSheetRow *
+_gtk_sheet_row_get(GtkSheet *sheet, gint row)
+{
+    GtkSheetRow *rowp = _gtk_sheet_row_peek(sheet, row);
 
-    if (row->button.label)
+    if (!rowp)
     {
-	g_free(row->button.label);
-	row->button.label = NULL;
+	rowp = g_new(GtkSheetRow, 1);
+	_gtk_sheet_row_init(rowp, _gtk_sheet_row_default_height(GTK_WIDGET(sheet)));
+	g_hash_table_insert(sheet->row_data, GINT_TO_POINTER(row), rowp);
+
+	if (row > sheet->row_data_last)
+	    sheet->row_data_last = row;
     }
+    return (rowp);
+}
 
-    if (row->tooltip_markup)
+/*
+ * _gtk_sheet_row_button - the title button of a row
+ * 
+ * @param sheet
+ * @param row    row index
+ * 
+ * @return the button, a shared default for rows without record
+ */
+static const GtkSheetButton *
+_gtk_sheet_row_button(GtkSheet *sheet, gint row)
+{
+    static const GtkSheetButton default_button =
     {
-	g_free(row->tooltip_markup);
-	row->tooltip_markup = NULL;
-    }
+	GTK_STATE_NORMAL, NULL, TRUE, NULL, GTK_JUSTIFY_CENTER
+    };
+    GtkSheetRow *rowp = _gtk_sheet_row_peek(sheet, row);
+
+    return (rowp ? &rowp->button : &default_button);
+}
+
+/*
+ * _gtk_sheet_row_table_shift - renumber a table keyed by row
+ * 
+ * after inserting (delta > 0) or deleting (delta < 0) rows at 
+ * row. Values of deleted rows are destroyed. Free when no key 
+ * is at or after row, as for appended rows, otherwise 
+ * O(number of keys).
+ * 
+ * @param table          the table, replaced when renumbered
+ * @param last           upper bound of the table keys, updated
+ * @param row            first inserted or deleted row
+ * @param delta          number of rows inserted or deleted
+ * @param value_destroy  destroy function of the table values
+ */
+static void
+_gtk_sheet_row_table_shift(GHashTable **table, gint *last,
+    gint row, gint delta, GDestroyNotify value_destroy)
+{
+    GHashTable *shifted;
+    GHashTableIter iter;
+    gpointer key, value;
 
-    if (row->tooltip_text)
+    if (*last < row)
+	return;
+
+    shifted = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+	NULL, value_destroy);
+    *last = -1;
+
+    g_hash_table_iter_init(&iter, *table);
+    while (g_hash_table_iter_next(&iter, &key, &value))
     {
-	g_free(row->tooltip_text);
-	row->tooltip_text = NULL;
+	gint r = GPOINTER_TO_INT(key);
+
+	if (r >= row)
+	{
+	    if (delta < 0 && r < row - delta)
+	    {
+		value_destroy(value);
+		continue;
+	    }
+	    r += delta;
+	}
+	g_hash_table_insert(shifted, GINT_TO_POINTER(r), value);
+
+	if (r > *last)
+	    *last = r;
     }
+
+    g_hash_table_steal_all(*table);
+    g_hash_table_destroy(*table);
+    *table = shifted;
+}
+
+/*
+ * _gtk_sheet_row_data_shift - renumber the row data records
+ * 
+ * @param sheet
+ * @param row    first inserted or deleted row
+ * @param delta  number of rows inserted or deleted
+ */
+static void
+_gtk_sheet_row_data_shift(GtkSheet *sheet, gint row, gint delta)
+{
+    _gtk_sheet_row_table_shift(&sheet->row_data, &sheet->row_data_last,
+	row, delta, (GDestroyNotify)_gtk_sheet_row_free);
 }
 
 /**
@@ -3381,12 +4665,7 @@ gtk_sheet_new(guint rows, guint columns, const gchar *title)
 void
 gtk_sheet_construct(GtkSheet *sheet, guint rows, guint columns, const gchar *title)
 {
-    sheet->data = (GtkSheetCell ***)g_malloc(sizeof(GtkSheetCell **));
-
-    sheet->data[0] = (GtkSheetCell **)g_malloc(sizeof(GtkSheetCell *)+sizeof(gdouble));
-    sheet->data[0][0] = NULL;
-
-    /* set number of rows and columns */
+    /* cell data blocks are allocated on demand */
     GrowSheet(sheet, MINROWS, MINCOLS);
 
     /* Init heading row/column, add normal rows/columns */
@@ -3839,11790 +5118,18556 @@ gtk_sheet_autoresize_rows(GtkSheet *sheet)
     return (sheet->autoresize_rows);
 }
 
-/**
- * _gtk_sheet_recalc_extent_width:
- * @sheet:  the #GtkSheet 
- * @col:    column to be recalculated
- *  
- * recalc maximum column extent width
+/*
+ * extent histograms
+ *
+ * Every column counts the extent widths and every row the extent 
+ * heights of the cells defining its maximum extent, as a sequence of 
+ * (extent, count) bins sorted by extent. Adding and removing a cell 
+ * and finding the maximum are O(log n), so a shrinking cell does not 
+ * rescan its column or row.
+ * 
+ * A cell with text and visible attributes is counted in its column 
+ * if its row is visible and in its row if its column is visible. 
+ * Cell.extent_flags records where it was counted.
+ * 
+ * While the sheet does not autoresize, written cells are not 
+ * measured. They are flagged dirty and their row and column marked 
+ * extent_unknown, until autoresizing asks for the maximum extent.
  */
-static void _gtk_sheet_recalc_extent_width(GtkSheet *sheet, gint col)
-{
-    gint new_width = 0;
-    gint row;
-
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("_gtk_sheet_recalc_extent_width[%d]: called", col);
-#endif
-
-    if (col < 0 || col > sheet->maxalloccol || col > sheet->maxcol)
-	return;
-
-    for (row = 0; row <= sheet->maxallocrow; row++)
-    {
-	GtkSheetRow *rowptr = ROWPTR(sheet, row);
 
-	if (GTK_SHEET_ROW_IS_VISIBLE(rowptr))
-	{
-	    GtkSheetCell *cell = sheet->data[row][col];
+#define GTK_SHEET_CELL_COUNTED_WIDTH   (1 << 0)  /* in column histogram */
+#define GTK_SHEET_CELL_COUNTED_HEIGHT  (1 << 1)  /* in row histogram */
+#define GTK_SHEET_CELL_EXTENT_DIRTY    (1 << 2)  /* not measured yet */
 
-	    if (cell && cell->text && cell->text[0])
-	    {
-		GtkSheetCellAttr attributes;
-		gtk_sheet_get_attributes(sheet, row, col, &attributes);
+#define GTK_SHEET_EXTENT_THREADED_MIN  1024   /* cells, fewer are measured here */
+#define GTK_SHEET_EXTENT_CHUNK         65536  /* cells measured per batch */
+#define GTK_SHEET_EXTENT_SERIAL_CHUNK  512    /* cells per idle batch, no threads */
+#define GTK_SHEET_EXTENT_IDLE_BUDGET   0.010  /* seconds per idle callback */
 
-		if (attributes.is_visible)
-		{
-		    if (cell->extent.width > new_width)
-		    {
-			new_width = cell->extent.width;
-		    }
-		}
-	    }
-	}
-    }
+typedef struct _GtkSheetExtentBin
+{
+    gint extent;  /* key */
+    guint count;  /* number of cells */
+} GtkSheetExtentBin;
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("_gtk_sheet_recalc_extent_width[%d]: new_width %d",
-            col, new_width);
-#endif
+static gint
+_gtk_sheet_extent_bin_compare(gconstpointer a, gconstpointer b, gpointer data)
+{
+    gint ea = ((const GtkSheetExtentBin *)a)->extent;
+    gint eb = ((const GtkSheetExtentBin *)b)->extent;
 
-    COLPTR(sheet, col)->max_extent_width = new_width;
+    return ((ea > eb) - (ea < eb));
 }
 
-/**
- * _gtk_sheet_recalc_extent_height:
- * @sheet:  the #GtkSheet 
- * @row:    row to be recalculated
- *  
- * recalc maximum row extent height
+/*
+ * _gtk_sheet_extent_hist_lookup - find the bin of an extent
+ * 
+ * @param hist   the histogram
+ * @param extent the extent
+ * @param pos    returns the bin position or the insert position
+ * 
+ * @return the bin or NULL
  */
-static void _gtk_sheet_recalc_extent_height(GtkSheet *sheet, gint row)
+static GtkSheetExtentBin *
+_gtk_sheet_extent_hist_lookup(GSequence *hist, gint extent, GSequenceIter **pos)
 {
-    gint new_height = 0;
-    gint col;
+    GtkSheetExtentBin key, *bin;
+    GSequenceIter *it;
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("_gtk_sheet_recalc_extent_height[%d]: called", row);
-#endif
+    key.extent = extent;
+    key.count = 0;
 
-    if (row < 0 || row > sheet->maxallocrow || row > sheet->maxrow)
-	return;
+    /* position behind an equal bin */
+    *pos = g_sequence_search(hist, &key, _gtk_sheet_extent_bin_compare, NULL);
 
-    for (col = 0; col <= sheet->maxalloccol; col++)
-    {
-	GtkSheetColumn *colptr = COLPTR(sheet, col);
+    if (g_sequence_iter_is_begin(*pos))
+	return (NULL);
 
-	if (GTK_SHEET_COLUMN_IS_VISIBLE(colptr))
-	{
-	    GtkSheetCell *cell = sheet->data[row][col];
+    it = g_sequence_iter_prev(*pos);
+    bin = g_sequence_get(it);
 
-	    if (cell && cell->text && cell->text[0])
-	    {
-		GtkSheetCellAttr attributes;
-		gtk_sheet_get_attributes(sheet, row, col, &attributes);
+    if (bin->extent != extent)
+	return (NULL);
 
-		if (attributes.is_visible)
-		{
-		    if (cell->extent.height > new_height)
-		    {
-			new_height = cell->extent.height;
-		    }
-		}
-	    }
-	}
-    }
+    *pos = it;
+    return (bin);
+}
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("_gtk_sheet_recalc_extent_height[%d]: new_height %d",
-            col, new_height);
-#endif
+static void
+_gtk_sheet_extent_hist_add(GSequence **hist, gint extent, guint count)
+{
+    GtkSheetExtentBin *bin;
+    GSequenceIter *pos;
 
-    ROWPTR(sheet, row)->max_extent_height = new_height;
+    if (!*hist)
+	*hist = g_sequence_new(g_free);
+
+    bin = _gtk_sheet_extent_hist_lookup(*hist, extent, &pos);
+
+    if (!bin)
+    {
+	bin = g_new(GtkSheetExtentBin, 1);
+	bin->extent = extent;
+	bin->count = 0;
+	g_sequence_insert_before(pos, bin);
+    }
+    bin->count += count;
 }
 
-/**
- * _gtk_sheet_update_extent:
- * @sheet:  the #GtkSheet
- * @cell:   the #GtkSheetCell
- * @row:    the row
- * @col:    the column
- * 
- * update cell extent and propagate to max row/column extent
- */
-static void _gtk_sheet_update_extent(GtkSheet *sheet,
-    GtkSheetCell *cell, gint row, gint col)
+static void
+_gtk_sheet_extent_hist_remove(GSequence **hist, gint extent)
 {
-    guint text_width = 0, text_height = 0;
-    guint new_extent_width = 0, new_extent_height = 0;
-    GdkRectangle old_extent;
-    GtkSheetColumn *colptr = COLPTR(sheet, col);
-    GtkSheetRow *rowptr = ROWPTR(sheet, row);
+    GtkSheetExtentBin *bin;
+    GSequenceIter *pos;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
-    g_return_if_fail(cell != NULL);
+    if (!*hist)
+	return;
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("_gtk_sheet_update_extent[%d,%d]: called cell (xw %d,xh %d) colxw %d rowxh %d",
-	row, col,
-	cell->extent.width, cell->extent.height,
-	colptr->max_extent_width, rowptr->max_extent_height);
-#endif
+    bin = _gtk_sheet_extent_hist_lookup(*hist, extent, &pos);
+    g_return_if_fail(bin != NULL);
 
-    old_extent = cell->extent;  /* to check wether it was increased */
+    if (--bin->count == 0)
+	g_sequence_remove(pos);
 
-    if (!cell->text || !cell->text[0])
+    if (g_sequence_iter_is_end(g_sequence_get_begin_iter(*hist)))
     {
-	cell->extent.width = 0;
-	cell->extent.height = 0;
-
-	if (old_extent.height != 0)
-	    _gtk_sheet_recalc_extent_height(sheet, row);
-	if (old_extent.width != 0)
-	    _gtk_sheet_recalc_extent_width(sheet, col);
-	return;
+	g_sequence_free(*hist);
+	*hist = NULL;
     }
+}
 
-    GtkSheetCellAttr attributes;
-    gtk_sheet_get_attributes(sheet, row, col, &attributes);
+static gint
+_gtk_sheet_extent_hist_max(GSequence *hist)
+{
+    GSequenceIter *it;
 
-    _get_string_extent(sheet, colptr,
-	attributes.font_desc, cell->text, &text_width, &text_height);
+    if (!hist)
+	return (0);
 
-    /* add borders */
-    new_extent_width = CELL_EXTENT_WIDTH(text_width, attributes.border.width);
-    new_extent_height = CELL_EXTENT_HEIGHT(text_height, 0);
+    it = g_sequence_get_end_iter(hist);
+    if (g_sequence_iter_is_begin(it))
+	return (0);
 
-    cell->extent.width = new_extent_width;
-    cell->extent.height = new_extent_height;
+    return (((GtkSheetExtentBin *)g_sequence_get(g_sequence_iter_prev(it)))->extent);
+}
 
-    if (!GTK_SHEET_COLUMN_IS_VISIBLE(colptr))
-	return;
-    if (!GTK_SHEET_ROW_IS_VISIBLE(rowptr))
-	return;
+/*
+ * row extents
+ * 
+ * The cells of a row mostly share one extent height. A row keeps 
+ * its maximum and the number of counted cells of that extent in 
+ * the sheet's row arrays. Only rows holding different extents 
+ * get a histogram in the sheet's row_extent_hist table.
+ */
 
-    if (new_extent_width >= old_extent.width)  /* wider */
-    {
-	if (new_extent_width > colptr->max_extent_width)
-	{
-	    colptr->max_extent_width = new_extent_width;
-	}
-    }
-    else if (new_extent_width < old_extent.width)  /* narrower */
+/*
+ * _gtk_sheet_row_extent_add - count a cell extent height of a row
+ * 
+ * @param sheet
+ * @param row     row index
+ * @param extent  the cell extent height
+ */
+static void
+_gtk_sheet_row_extent_add(GtkSheet *sheet, gint row, gint extent)
+{
+    GSequence *hist;
+
+    if (ROW_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_EXTENT_HIST))
     {
-	_gtk_sheet_recalc_extent_width(sheet, col);
+	hist = g_hash_table_lookup(sheet->row_extent_hist, GINT_TO_POINTER(row));
     }
-
-    if (new_extent_height >= old_extent.height)  /* higher */
+    else if (!ROW_MAX_COUNT(sheet, row) || extent == ROW_MAX_EXTENT(sheet, row))
     {
-	if (new_extent_height > rowptr->max_extent_height)
-	{
-	    rowptr->max_extent_height = new_extent_height;
-	}
+	ROW_SET_MAX_EXTENT(sheet, row, extent);
+	ROW_SET_MAX_COUNT(sheet, row, ROW_MAX_COUNT(sheet, row) + 1);
+	return;
     }
-    else if (new_extent_height < old_extent.height)  /* lower */
+    else  /* mixed extents, switch to a histogram */
     {
-	_gtk_sheet_recalc_extent_height(sheet, row);
+	hist = NULL;
+	_gtk_sheet_extent_hist_add(&hist,
+	    ROW_MAX_EXTENT(sheet, row), ROW_MAX_COUNT(sheet, row));
+	ROW_SET_MAX_COUNT(sheet, row, 0);
+
+	g_hash_table_insert(sheet->row_extent_hist, GINT_TO_POINTER(row), hist);
+	if (row > sheet->row_extent_hist_last)
+	    sheet->row_extent_hist_last = row;
+	ROW_SET_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_EXTENT_HIST, TRUE);
     }
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("_gtk_sheet_update_extent[%d,%d]: done cell (xw %d,xh %d) colxw %d rowxh %d",
-	row, col,
-	cell->extent.width, cell->extent.height,
-	colptr->max_extent_width, rowptr->max_extent_height);
-#endif
+    _gtk_sheet_extent_hist_add(&hist, extent, 1);
+
+    if (extent > ROW_MAX_EXTENT(sheet, row))
+	ROW_SET_MAX_EXTENT(sheet, row, extent);
 }
 
-static void
-_gtk_sheet_autoresize_column_internal(GtkSheet *sheet, gint col)
+/*
+ * _gtk_sheet_row_extent_remove - uncount a cell extent height of 
+ * a row
+ * 
+ * @param sheet
+ * @param row     row index
+ * @param extent  the counted cell extent height
+ */
+static void
+_gtk_sheet_row_extent_remove(GtkSheet *sheet, gint row, gint extent)
 {
-    gint new_width;
-    GtkSheetColumn *colptr;
+    GSequence *hist;
+    GtkSheetExtentBin *bin;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    if (!ROW_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_EXTENT_HIST))
+    {
+	g_return_if_fail(ROW_MAX_COUNT(sheet, row) > 0);
+	g_return_if_fail(extent == ROW_MAX_EXTENT(sheet, row));
 
-    if (col < 0 || col > sheet->maxalloccol || col > sheet->maxcol)
+	ROW_SET_MAX_COUNT(sheet, row, ROW_MAX_COUNT(sheet, row) - 1);
+	if (ROW_MAX_COUNT(sheet, row) == 0)
+	    ROW_SET_MAX_EXTENT(sheet, row, 0);
 	return;
+    }
 
-    colptr = COLPTR(sheet, col);
+    /* a histogram holds two extents at least, it is not freed here */
+    hist = g_hash_table_lookup(sheet->row_extent_hist, GINT_TO_POINTER(row));
+    _gtk_sheet_extent_hist_remove(&hist, extent);
 
-    if (!GTK_SHEET_COLUMN_IS_VISIBLE(colptr))
+    if (g_sequence_get_length(hist) > 1)
+    {
+	ROW_SET_MAX_EXTENT(sheet, row, _gtk_sheet_extent_hist_max(hist));
 	return;
+    }
 
-    new_width = COLUMN_EXTENT_TO_WIDTH(colptr->max_extent_width);
+    /* a single extent left, drop the histogram */
+    bin = g_sequence_get(g_sequence_get_begin_iter(hist));
+    ROW_SET_MAX_EXTENT(sheet, row, bin->extent);
+    ROW_SET_MAX_COUNT(sheet, row, bin->count);
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("_gtk_sheet_autoresize_column_internal[%d]: called col w %d new w %d",
-	col, colptr->width, new_width);
-#endif
+    g_hash_table_remove(sheet->row_extent_hist, GINT_TO_POINTER(row));
+    ROW_SET_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_EXTENT_HIST, FALSE);
+}
 
-    if (new_width != colptr->width)
+/*
+ * _gtk_sheet_cell_uncount_extent - remove the cell extent from 
+ * its column and row histograms
+ * 
+ * must be called before the cell extent or position changes
+ * 
+ * @param sheet  the #GtkSheet
+ * @param cell   the #GtkSheetCell
+ * @param row    row of the cell
+ * @param col    column of the cell
+ */
+static void
+_gtk_sheet_cell_uncount_extent(GtkSheet *sheet,
+    GtkSheetCell *cell, gint row, gint col)
+{
+    if (cell->extent_flags & GTK_SHEET_CELL_COUNTED_WIDTH)
     {
-#if GTK_SHEET_DEBUG_SIZE > 0
-	g_debug("_gtk_sheet_autoresize_column_internal[%d]: set width %d",
-	    col, new_width);
-#endif
-	gtk_sheet_set_column_width(sheet, col, new_width);
-	GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_REDRAW_PENDING);
+	GtkSheetColumn *colptr = COLPTR(sheet, col);
+
+	_gtk_sheet_extent_hist_remove(&colptr->extent_hist, cell->extent.width);
+	colptr->max_extent_width = _gtk_sheet_extent_hist_max(colptr->extent_hist);
     }
+
+    if (cell->extent_flags & GTK_SHEET_CELL_COUNTED_HEIGHT)
+	_gtk_sheet_row_extent_remove(sheet, row, cell->extent.height);
+
+    cell->extent_flags = 0;
 }
 
+/*
+ * _gtk_sheet_cell_count_extent - add the cell extent to its 
+ * column and row histograms
+ * 
+ * @param sheet      the #GtkSheet
+ * @param cell       the #GtkSheetCell, not counted yet
+ * @param row        row of the cell
+ * @param col        column of the cell
+ * @param is_visible visibility from the cell attributes
+ */
 static void
-_gtk_sheet_autoresize_row_internal(GtkSheet *sheet, gint row)
+_gtk_sheet_cell_count_extent(GtkSheet *sheet,
+    GtkSheetCell *cell, gint row, gint col, gboolean is_visible)
 {
-    gint new_height;
-    GtkSheetRow *rowptr;
-
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    GtkSheetColumn *colptr = COLPTR(sheet, col);
 
-    if (row < 0 || row > sheet->maxallocrow || row > sheet->maxrow)
+    if (!cell->text || !cell->text[0] || !is_visible)
 	return;
 
-    rowptr = ROWPTR(sheet, row);
-
-    if (!GTK_SHEET_ROW_IS_VISIBLE(rowptr))
-	return;
+    if (GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+    {
+	_gtk_sheet_extent_hist_add(&colptr->extent_hist, cell->extent.width, 1);
 
-    new_height = ROW_EXTENT_TO_HEIGHT(rowptr->max_extent_height);
+	if (cell->extent.width > colptr->max_extent_width)
+	    colptr->max_extent_width = cell->extent.width;
 
-#if 0 && GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("_gtk_sheet_autoresize_row_internal[%d]: win_h %d ext_h %d row_max_h %d",
-	row, sheet->sheet_window_height, rowptr->max_extent_height,
-	ROW_MAX_HEIGHT(sheet));
-    g_debug("_gtk_sheet_autoresize_row_internal[%d]: called row h %d new h %d",
-	row, rowptr->height, new_height);
-#endif
+	cell->extent_flags |= GTK_SHEET_CELL_COUNTED_WIDTH;
+    }
 
-    if (new_height != rowptr->height)
+    if (GTK_SHEET_COLUMN_IS_VISIBLE(colptr))
     {
-#if GTK_SHEET_DEBUG_SIZE > 0
-	g_debug("_gtk_sheet_autoresize_row_internal[%d]: set height %d",
-	    row, new_height);
-#endif
-	gtk_sheet_set_row_height(sheet, row, new_height);
-	GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_REDRAW_PENDING);
+	_gtk_sheet_row_extent_add(sheet, row, cell->extent.height);
+	cell->extent_flags |= GTK_SHEET_CELL_COUNTED_HEIGHT;
     }
 }
 
-static void gtk_sheet_autoresize_all(GtkSheet *sheet)
+/*
+ * _gtk_sheet_recount_extents - recount populated cells of a range
+ * 
+ * to be called after the visibility of rows, columns or cell 
+ * attributes in the range changed
+ * 
+ * @param sheet  the #GtkSheet
+ * @param range  the range
+ */
+void
+_gtk_sheet_recount_extents(GtkSheet *sheet, const GtkSheetRange *range)
 {
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
-
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-    {
-#if GTK_SHEET_DEBUG_SIZE > 0
-	g_debug("gtk_sheet_autoresize_all: not realized");
-#endif
-	return;
-    }
+    GPtrArray *cells;
+    guint i;
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("gtk_sheet_autoresize_all: running");
-#endif
+    cells = CollectCellData(sheet,
+	range->row0, range->rowi, range->col0, range->coli);
 
-    gboolean need_freeze = (
-                            !GTK_SHEET_IS_FROZEN(sheet)
-                            && (gtk_sheet_autoresize_columns(sheet) 
-                                || gtk_sheet_autoresize_rows(sheet))
-                            );
-    
-    if (need_freeze) gtk_sheet_freeze(sheet);
-        
-    if (gtk_sheet_autoresize_columns(sheet))
+    for (i = 0; i < cells->len; i++)
     {
-	gint col;
-
-#if GTK_SHEET_DEBUG_SIZE > 0
-	g_debug("gtk_sheet_autoresize_all: columns");
-#endif
+	GtkSheetCell *cell = g_ptr_array_index(cells, i);
+	GtkSheetCellAttr attributes;
 
-	for (col = 0; col <= sheet->maxalloccol; col++)
-	{
-	    if (GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
-	    {
-		_gtk_sheet_autoresize_column_internal(sheet, col);
-	    }
-	}
-    }
+	if (cell->extent_flags & GTK_SHEET_CELL_EXTENT_DIRTY)
+	    continue;  /* counted when measured */
 
-    if (gtk_sheet_autoresize_rows(sheet))
-    {
-	gint row;
+	_gtk_sheet_cell_uncount_extent(sheet, cell, cell->row, cell->col);
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-	g_debug("gtk_sheet_autoresize_all: rows");
-#endif
+	if (!cell->text || !cell->text[0])
+	    continue;
 
-	for (row = 0; row <= sheet->maxallocrow; row++)
-	{
-	    if (GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row)))
-	    {
-		_gtk_sheet_autoresize_row_internal(sheet, row);
-	    }
-	}
+	gtk_sheet_get_attributes(sheet, cell->row, cell->col, &attributes);
+	_gtk_sheet_cell_count_extent(sheet, cell, cell->row, cell->col,
+	    attributes.is_visible);
     }
 
-    if (need_freeze) gtk_sheet_thaw(sheet);
+    g_ptr_array_free(cells, TRUE);
 }
 
-/**
- * gtk_sheet_set_autoscroll:
- * @sheet: a #GtkSheet
- * @autoscroll: TRUE or FALSE
- *
- * The sheet will be automatically scrolled when you move beyond
- * the last row/col in #GtkSheet.
+/*
+ * _gtk_sheet_cell_measure_extent - measure and count the cell extent
+ * 
+ * @param sheet  the #GtkSheet
+ * @param cell   the #GtkSheetCell with text, not counted yet
+ * @param row    row of the cell
+ * @param col    column of the cell
  */
-void
-gtk_sheet_set_autoscroll(GtkSheet *sheet, gboolean autoscroll)
+static void
+_gtk_sheet_cell_measure_extent(GtkSheet *sheet,
+    GtkSheetCell *cell, gint row, gint col)
 {
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    guint text_width = 0, text_height = 0;
+    GtkSheetCellAttr attributes;
 
-    sheet->autoscroll = autoscroll;
-}
+    gtk_sheet_get_attributes(sheet, row, col, &attributes);
 
-/**
- * gtk_sheet_autoscroll:
- * @sheet: a #GtkSheet
- *
- * Get the autoscroll mode of #GtkSheet.
- *
- * Returns: TRUE or FALSE
- */
-gboolean
-gtk_sheet_autoscroll(GtkSheet *sheet)
-{
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+    _get_string_extent(sheet, COLPTR(sheet, col),
+	attributes.font_desc, cell->text, &text_width, &text_height);
 
-    return (sheet->autoscroll);
+    /* add borders */
+    cell->extent.width = CELL_EXTENT_WIDTH(text_width, attributes.border.width);
+    cell->extent.height = CELL_EXTENT_HEIGHT(text_height, 0);
+
+    _gtk_sheet_cell_count_extent(sheet, cell, row, col, attributes.is_visible);
 }
 
-/**
- * gtk_sheet_set_clip_text:
- * @sheet: a #GtkSheet
- * @clip_text: TRUE or FALSE
- *
- * Clip text in cell. When clip text mode is turned off, cell 
- * text is written over neighbour columns, as long as their 
- * contents are empty. 
+/*
+ * _gtk_sheet_cell_defer_extent - postpone measuring the cell extent
+ * 
+ * @param sheet  the #GtkSheet
+ * @param cell   the #GtkSheetCell with text, not counted yet
+ * @param row    row of the cell
+ * @param col    column of the cell
  */
-void
-gtk_sheet_set_clip_text(GtkSheet *sheet, gboolean clip_text)
+static void
+_gtk_sheet_cell_defer_extent(GtkSheet *sheet,
+    GtkSheetCell *cell, gint row, gint col)
 {
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    cell->extent.width = 0;
+    cell->extent.height = 0;
+    cell->extent_flags |= GTK_SHEET_CELL_EXTENT_DIRTY;
 
-    sheet->clip_text = clip_text;
+    COLPTR(sheet, col)->extent_unknown = TRUE;
+    ROW_SET_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_EXTENT_UNKNOWN, TRUE);
 }
 
-/**
- * gtk_sheet_clip_text:
- * @sheet: a #GtkSheet
- *
- * Get clip text mode in #GtkSheet. When clip text mode is 
- * turned off, cell text is written over neighbour columns, as 
- * long as their contents are empty. 
- *
- * Returns: TRUE or FALSE
+/*
+ * _gtk_sheet_measure_cells - measure and count deferred extents
+ * 
+ * large batches are measured by the render threads, if any, see 
+ * gtk_sheet_set_render_threads()
+ * 
+ * @param sheet  the #GtkSheet
+ * @param cells  #GtkSheetCell flagged GTK_SHEET_CELL_EXTENT_DIRTY
  */
-gboolean
-gtk_sheet_clip_text(GtkSheet *sheet)
+static void
+_gtk_sheet_measure_cells(GtkSheet *sheet, GPtrArray *cells)
 {
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+    guint i;
 
-    return (sheet->clip_text);
-}
+#if GTK_SHEET_RENDER_THREADS
+    if (sheet->render_pool && cells->len >= GTK_SHEET_EXTENT_THREADED_MIN)
+    {
+	_gtk_sheet_measure_cells_threaded(sheet, cells);
+	return;
+    }
+#endif
 
-/**
- * gtk_sheet_set_justify_entry:
- * @sheet: a #GtkSheet
- * @justify: TRUE or FALSE
- *
- * Justify cell entry editor in #GtkSheet.
- */
-void
-gtk_sheet_set_justify_entry(GtkSheet *sheet, gboolean justify)
-{
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    for (i = 0; i < cells->len; i++)
+    {
+	GtkSheetCell *cell = g_ptr_array_index(cells, i);
 
-    sheet->justify_entry = justify;
+	cell->extent_flags &= ~GTK_SHEET_CELL_EXTENT_DIRTY;
+	_gtk_sheet_cell_measure_extent(sheet, cell, cell->row, cell->col);
+    }
 }
 
-/**
- * gtk_sheet_justify_entry:
- * @sheet: a #GtkSheet
- *
- * Get the cell entry editor justification setting from 
- * #GtkSheet. 
- *
- * Returns: TRUE or FALSE
+/*
+ * _gtk_sheet_collect_dirty - add the cells with deferred extents 
+ * of a range
+ * 
+ * @param sheet  the #GtkSheet
+ * @param row0   first row
+ * @param rowi   last row
+ * @param col0   first column
+ * @param coli   last column
+ * @param dirty  the array to add to
  */
-gboolean
-gtk_sheet_justify_entry(GtkSheet *sheet)
+static void
+_gtk_sheet_collect_dirty(GtkSheet *sheet,
+    gint row0, gint rowi, gint col0, gint coli, GPtrArray *dirty)
 {
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+    GPtrArray *cells;
+    guint i;
 
-    return (sheet->justify_entry);
+    cells = CollectCellData(sheet, row0, rowi, col0, coli);
+
+    for (i = 0; i < cells->len; i++)
+    {
+	GtkSheetCell *cell = g_ptr_array_index(cells, i);
+
+	if (cell->extent_flags & GTK_SHEET_CELL_EXTENT_DIRTY)
+	    g_ptr_array_add(dirty, cell);
+    }
+
+    g_ptr_array_free(cells, TRUE);
 }
 
-/**
- * gtk_sheet_set_vjustification:
- * @sheet: a #GtkSheet
- * @vjust: a #GtkSheetVerticalJustification
- *
- * Set the default vertical cell text justification for 
- * #GtkSheet. 
+/*
+ * _gtk_sheet_resolve_extents - measure the deferred extents of a 
+ * range
+ * 
+ * walks the range in bands of rows and measures in batches of 
+ * GTK_SHEET_EXTENT_CHUNK cells
+ * 
+ * @param sheet  the #GtkSheet
+ * @param range  the range
  */
-void
-gtk_sheet_set_vjustification(GtkSheet *sheet, GtkSheetVerticalJustification vjust)
+static void
+_gtk_sheet_resolve_extents(GtkSheet *sheet, const GtkSheetRange *range)
 {
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    GPtrArray *dirty = g_ptr_array_new();
+    gint row, rowi = MIN(range->rowi, sheet->maxallocrow);
 
-    sheet->vjust = vjust;
-}
+    for (row = range->row0; row <= rowi; row += GTK_SHEET_BLOCK_ROWS)
+    {
+	_gtk_sheet_collect_dirty(sheet,
+	    row, MIN(row + GTK_SHEET_BLOCK_ROWS - 1, rowi),
+	    range->col0, range->coli, dirty);
 
-/**
- * gtk_sheet_get_vjustification:
- * @sheet: a #GtkSheet
- *
- * Get the default vertical cell text justification from 
- * #GtkSheet. 
- *
- * Returns: the default #GtkSheetVerticalJustification
- */
-GtkSheetVerticalJustification
-gtk_sheet_get_vjustification(GtkSheet *sheet)
-{
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
-
-    return (sheet->vjust);
-}
+	if (dirty->len >= GTK_SHEET_EXTENT_CHUNK)
+	{
+	    _gtk_sheet_measure_cells(sheet, dirty);
+	    g_ptr_array_set_size(dirty, 0);
+	}
+    }
 
-/**
- * gtk_sheet_set_traverse_type:
- * @sheet: a #GtkSheet
- * @ttype: a #GtkSheetTraverseType
- *
- * Set the default traversal type for cursor movement in a 
- * #GtkSheet. 
- */
-void
-gtk_sheet_set_traverse_type(GtkSheet *sheet, GtkSheetTraverseType ttype)
-{
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    if (dirty->len)
+	_gtk_sheet_measure_cells(sheet, dirty);
 
-    sheet->traverse_type = ttype;
+    g_ptr_array_free(dirty, TRUE);
 }
 
-/**
- * gtk_sheet_get_traverse_type:
- * @sheet: a #GtkSheet
- *
- * Get the default cell traversal type from #GtkSheet. 
- *
- * Returns: the default #GtkSheetTraverseType
+/*
+ * _gtk_sheet_resolve_all_extents - make all maximum extents known
+ * 
+ * one pass over the sheet instead of one per row and column
+ * 
+ * @param sheet  the #GtkSheet
  */
-GtkSheetTraverseType
-gtk_sheet_get_traverse_type(GtkSheet *sheet)
+static void
+_gtk_sheet_resolve_all_extents(GtkSheet *sheet)
 {
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+    GtkSheetRange range;
+    gint row, col;
 
-    return (sheet->traverse_type);
-}
+    /* a deferred cell marks its column, too */
+    for (col = 0; col <= sheet->maxalloccol; col++)
+    {
+	if (COLPTR(sheet, col)->extent_unknown)
+	    break;
+    }
+    if (col > sheet->maxalloccol)
+	return;
 
+    range.row0 = 0;
+    range.rowi = sheet->maxallocrow;
+    range.col0 = 0;
+    range.coli = sheet->maxalloccol;
 
+    _gtk_sheet_resolve_extents(sheet, &range);
 
-/**
- * gtk_sheet_set_locked:
- * @sheet: a #GtkSheet
- * @locked: TRUE or FALSE
- *
- * Lock the #GtkSheet, which means it is no longer editable,
- * cell contents cannot be modified by the user.
-    */
-void
-gtk_sheet_set_locked(GtkSheet *sheet, gboolean locked)
-{
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    for (col = 0; col <= sheet->maxalloccol; col++)
+	COLPTR(sheet, col)->extent_unknown = FALSE;
 
-    sheet->locked = locked;
+    for (row = 0; row <= sheet->maxallocrow; row++)
+	ROW_SET_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_EXTENT_UNKNOWN, FALSE);
 }
 
-/**
- * gtk_sheet_locked:
- * @sheet: a #GtkSheet
- *
- * Get the lock status of #GtkSheet, locked means the sheet is
- * not editable, cell contents cannot be modified by the user.
- *
- * Returns: TRUE or FALSE
+/*
+ * _gtk_sheet_invalidate_extents - forget all measured extents
+ * 
+ * needed when fonts resolve differently. Cells with text are 
+ * flagged dirty and measured again when needed.
+ * 
+ * @param sheet  the #GtkSheet
  */
-gboolean
-gtk_sheet_locked(GtkSheet *sheet)
+static void
+_gtk_sheet_invalidate_extents(GtkSheet *sheet)
 {
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
-
-    return (sheet->locked);
-}
+    gint row, col;
 
-/* This routine has problems with gtk+-1.2 related with the
- * label/button drawing - I think it's a bug in gtk+-1.2 */
+    for (col = 0; col <= sheet->maxalloccol; col++)
+    {
+	GtkSheetColumn *colptr = COLPTR(sheet, col);
 
-/**
- * gtk_sheet_set_title:
- * @sheet: a #GtkSheet
- * @title: #GtkSheet title
- *
- * Set  #GtkSheet title. The widget will keep a copy of the
- * string.
- */
-void
-gtk_sheet_set_title(GtkSheet *sheet, const gchar *title)
-{
-    GtkWidget *label;
+	if (colptr->extent_hist)
+	{
+	    g_sequence_free(colptr->extent_hist);
+	    colptr->extent_hist = NULL;
+	}
+	colptr->max_extent_width = 0;
+	colptr->extent_unknown = TRUE;
+    }
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_hash_table_remove_all(sheet->row_extent_hist);
+    sheet->row_extent_hist_last = -1;
 
-    if (sheet->title)
-    {
-	g_free(sheet->title);
-	sheet->title = NULL;
-    }
-    if (title)
+    for (row = 0; row <= sheet->maxrow; row += GTK_SHEET_ROW_PAGE_SIZE)
     {
-	sheet->title = g_strdup(title);
-    }
-
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)) || !title)
-	return;
+	GtkSheetRowPage *page = ROW_PAGE(sheet, row);
+	gint i;
 
-    if (gtk_bin_get_child(GTK_BIN(sheet->button)))
-	label = gtk_bin_get_child(GTK_BIN(sheet->button));
-/*
-  gtk_label_set_text(GTK_LABEL(label), title);
-*/
-    size_allocate_global_button(sheet);
+	if (!page)  /* default rows, no extents */
+	    continue;
 
-    /* remove and destroy the old widget */
-/*
-  old_widget = gtk_bin_get_child(GTK_BIN (sheet->button));
-  if (old_widget)
-    {
-      gtk_container_remove (GTK_CONTAINER (sheet->button), old_widget);
+	for (i = 0; i < GTK_SHEET_ROW_PAGE_SIZE; i++)
+	{
+	    page->max_extent[i] = 0;
+	    page->max_count[i] = 0;
+	    page->flags[i] &= ~GTK_SHEET_ROW_FLAG_EXTENT_HIST;
+	}
     }
 
-  label = gtk_label_new (title);
-  gtk_misc_set_alignment(GTK_MISC(label), 0.5 , 0.5 );
+    for (row = 0; row <= sheet->maxallocrow; row += GTK_SHEET_BLOCK_ROWS)
+    {
+	GPtrArray *cells = CollectCellData(sheet,
+	    row, row + GTK_SHEET_BLOCK_ROWS - 1, 0, sheet->maxalloccol);
+	guint i;
 
-  gtk_container_add (GTK_CONTAINER (sheet->button), label);
-  gtk_widget_show (label);
+	for (i = 0; i < cells->len; i++)
+	{
+	    GtkSheetCell *cell = g_ptr_array_index(cells, i);
 
-  size_allocate_global_button(sheet);
+	    cell->extent.width = 0;
+	    cell->extent.height = 0;
+	    cell->extent_flags = 0;
 
-  g_signal_emit(GTK_OBJECT(sheet),sheet_signals[CHANGED], 0, -1, -1);
+	    if (cell->text && cell->text[0])
+	    {
+		cell->extent_flags = GTK_SHEET_CELL_EXTENT_DIRTY;
+		ROW_SET_FLAG(sheet, cell->row, GTK_SHEET_ROW_FLAG_EXTENT_UNKNOWN, TRUE);
+	    }
+	}
 
-  if(old_widget)
-      gtk_widget_destroy (old_widget);
-*/
+	g_ptr_array_free(cells, TRUE);
+    }
 }
 
-/**
- * gtk_sheet_set_description:
- * @sheet: a #GtkSheet
- * @description: #GtkSheet description
- *
- * Set  #GtkSheet description for application use. 
+/*
+ * _gtk_sheet_column_resolve_extents - make the maximum extent 
+ * width of a column known
+ * 
+ * @param sheet  the #GtkSheet
+ * @param col    the column
  */
-void
-gtk_sheet_set_description(GtkSheet *sheet, const gchar *description)
+static void
+_gtk_sheet_column_resolve_extents(GtkSheet *sheet, gint col)
 {
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    GtkSheetColumn *colptr = COLPTR(sheet, col);
+    GtkSheetRange range;
 
-    if (sheet->description)
-	g_free(sheet->description);
-    sheet->description = g_strdup(description);
-}
+    if (!colptr->extent_unknown)
+	return;
 
-/**
- * gtk_sheet_get_description:
- * @sheet: a #GtkSheet
- * @description: #GtkSheet description
- *
- * Get sheet description.
- *
- * Returns: sheet description or NULL, do not modify or free it
- */
-const gchar *
-gtk_sheet_get_description(GtkSheet *sheet, const gchar *description)
-{
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
+    colptr->extent_unknown = FALSE;
 
-    return (sheet->description);
-}
+    range.row0 = 0;
+    range.rowi = sheet->maxallocrow;
+    range.col0 = range.coli = col;
 
+    _gtk_sheet_resolve_extents(sheet, &range);
+}
 
-/**
- * gtk_sheet_is_frozen:
- * @sheet: the #GtkSheet 
- *  
- * Get freeze status. 
+/*
+ * _gtk_sheet_row_resolve_extents - make the maximum extent 
+ * height of a row known
  * 
- * Returns: TRUE or FALSE wether the sheet is frozen
+ * @param sheet  the #GtkSheet
+ * @param row    the row
  */
-gboolean gtk_sheet_is_frozen(GtkSheet *sheet)
+static void
+_gtk_sheet_row_resolve_extents(GtkSheet *sheet, gint row)
 {
-    return (GTK_SHEET_IS_FROZEN(sheet));
-}
+    GtkSheetRange range;
+
+    if (!ROW_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_EXTENT_UNKNOWN))
+	return;
 
+    ROW_SET_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_EXTENT_UNKNOWN, FALSE);
+
+    range.row0 = range.rowi = row;
+    range.col0 = 0;
+    range.coli = sheet->maxalloccol;
+
+    _gtk_sheet_resolve_extents(sheet, &range);
+}
 
 /**
- * gtk_sheet_freeze:
- * @sheet: a #GtkSheet
- *
- * Freeze all visual updates of the #GtkSheet.
- * The updates will occure in a more efficient way than if you made them on a unfrozen #GtkSheet .
+ * _gtk_sheet_update_extent:
+ * @sheet:  the #GtkSheet
+ * @cell:   the #GtkSheetCell
+ * @row:    the row
+ * @col:    the column
+ * 
+ * update cell extent and propagate to max row/column extent, 
+ * measuring is deferred while the sheet does not autoresize
  */
-void
-gtk_sheet_freeze(GtkSheet *sheet)
+static void _gtk_sheet_update_extent(GtkSheet *sheet,
+    GtkSheetCell *cell, gint row, gint col)
 {
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_return_if_fail(cell != NULL);
 
-    sheet->freeze_count++;
-    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IS_FROZEN);
-
-#if GTK_SHEET_DEBUG_FREEZE > 0
-    g_debug("gtk_sheet_freeze: freeze_count == %d", sheet->freeze_count);
+#if GTK_SHEET_DEBUG_SIZE > 0
+    g_debug("_gtk_sheet_update_extent[%d,%d]: called cell (xw %d,xh %d) colxw %d rowxh %d",
+	row, col,
+	cell->extent.width, cell->extent.height,
+	COLPTR(sheet, col)->max_extent_width, ROW_MAX_EXTENT(sheet, row));
 #endif
 
-}
+    _gtk_sheet_cell_uncount_extent(sheet, cell, row, col);
 
+    if (!cell->text || !cell->text[0])
+    {
+	cell->extent.width = 0;
+	cell->extent.height = 0;
+	return;
+    }
 
-/**
- * _gtk_sheet_redraw_internal: 
- * @sheet:  to be redrawn 
- * @reset_hadjustment: wether to reset horizontal adjustment
- * @reset_vadjustment: wether to reset vertical adjustment
- *  
- *  do a complete sheet redraw. used after rows/cols have been
- *  appended/deleted or after combined operations while the
- *  sheet was frozen
- */
-void _gtk_sheet_redraw_internal(GtkSheet *sheet,
-    gboolean reset_hadjustment,
-    gboolean reset_vadjustment)
+    if (!gtk_sheet_autoresize(sheet))
+    {
+	_gtk_sheet_cell_defer_extent(sheet, cell, row, col);
+	return;
+    }
+
+    _gtk_sheet_cell_measure_extent(sheet, cell, row, col);
+
+#if GTK_SHEET_DEBUG_SIZE > 0
+    g_debug("_gtk_sheet_update_extent[%d,%d]: done cell (xw %d,xh %d) colxw %d rowxh %d",
+	row, col,
+	cell->extent.width, cell->extent.height,
+	COLPTR(sheet, col)->max_extent_width, ROW_MAX_EXTENT(sheet, row));
+#endif
+}
+
+static void
+_gtk_sheet_autoresize_column_internal(GtkSheet *sheet, gint col)
 {
-    gboolean done = FALSE;  /* handle sheets with no scrollbars */
+    gint new_width;
+    GtkSheetColumn *colptr;
 
-    if (reset_hadjustment)
-	sheet->old_hadjustment = -1.;  /* causes redraw */
-    if (reset_vadjustment)
-	sheet->old_vadjustment = -1.;  /* causes redraw */
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+    if (col < 0 || col > sheet->maxalloccol || col > sheet->maxcol)
 	return;
-    if (GTK_SHEET_IS_FROZEN(sheet))
+
+    colptr = COLPTR(sheet, col);
+
+    if (!GTK_SHEET_COLUMN_IS_VISIBLE(colptr))
 	return;
 
-#if GTK_SHEET_DEBUG_DRAW > 0
-    g_debug("_gtk_sheet_redraw_internal: called");
-#endif
+    _gtk_sheet_column_resolve_extents(sheet, col);
+    new_width = COLUMN_EXTENT_TO_WIDTH(colptr->max_extent_width);
 
-    _gtk_sheet_recalc_view_range(sheet);
+#if GTK_SHEET_DEBUG_SIZE > 0
+    g_debug("_gtk_sheet_autoresize_column_internal[%d]: called col w %d new w %d",
+	col, colptr->width, new_width);
+#endif
 
-    if (sheet->row_titles_visible || sheet->column_titles_visible)
+    if (new_width != colptr->width)
     {
-	size_allocate_global_button(sheet);
+#if GTK_SHEET_DEBUG_SIZE > 0
+	g_debug("_gtk_sheet_autoresize_column_internal[%d]: set width %d",
+	    col, new_width);
+#endif
+	gtk_sheet_set_column_width(sheet, col, new_width);
+	GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_REDRAW_PENDING);
     }
+}
 
-    if (sheet->row_titles_visible)
-    {
-	size_allocate_row_title_buttons(sheet);
-    }
+static void
+_gtk_sheet_autoresize_row_internal(GtkSheet *sheet, gint row)
+{
+    gint new_height;
 
-    if (sheet->column_titles_visible)
-    {
-	_gtk_sheet_column_buttons_size_allocate(sheet);
-    }
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    /* send value_changed or redraw directly */
+    if (row < 0 || row > sheet->maxallocrow || row > sheet->maxrow)
+	return;
 
-    if (sheet->vadjustment)
-    {
-	g_signal_emit_by_name(GTK_OBJECT(sheet->vadjustment), "value_changed");
-	done = TRUE;
-    }
+    if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	return;
 
-    if (sheet->hadjustment)
-    {
-	g_signal_emit_by_name(GTK_OBJECT(sheet->hadjustment), "value_changed");
-	done = TRUE;
-    }
+    _gtk_sheet_row_resolve_extents(sheet, row);
+    new_height = ROW_EXTENT_TO_HEIGHT(ROW_MAX_EXTENT(sheet, row));
 
-    if (!done)
+#if 0 && GTK_SHEET_DEBUG_SIZE > 0
+    g_debug("_gtk_sheet_autoresize_row_internal[%d]: win_h %d ext_h %d row_max_h %d",
+	row, sheet->sheet_window_height, ROW_MAX_EXTENT(sheet, row),
+	ROW_MAX_HEIGHT(sheet));
+    g_debug("_gtk_sheet_autoresize_row_internal[%d]: called row h %d new h %d",
+	row, ROW_HEIGHT(sheet, row), new_height);
+#endif
+
+    if (new_height != ROW_HEIGHT(sheet, row))
     {
-	_gtk_sheet_range_draw(sheet, NULL, TRUE);
+#if GTK_SHEET_DEBUG_SIZE > 0
+	g_debug("_gtk_sheet_autoresize_row_internal[%d]: set height %d",
+	    row, new_height);
+#endif
+	gtk_sheet_set_row_height(sheet, row, new_height);
+	GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_REDRAW_PENDING);
     }
 }
 
-
-/**
- * gtk_sheet_thaw:
- * @sheet: a #GtkSheet
- *
- * Thaw the sheet after you have made a number of changes on a frozen sheet.
- * The updates will occure in a more efficient way than if you made them on a unfrozen sheet .
- */
-void
-gtk_sheet_thaw(GtkSheet *sheet)
+static void gtk_sheet_autoresize_all(GtkSheet *sheet)
 {
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (sheet->freeze_count == 0)
-	return;
-
-    sheet->freeze_count--;
-    if (sheet->freeze_count > 0)
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
     {
-#if GTK_SHEET_DEBUG_FREEZE > 0
-	g_warning("gtk_sheet_thaw: ignored (freeze_count > 0)");
+#if GTK_SHEET_DEBUG_SIZE > 0
+	g_debug("gtk_sheet_autoresize_all: not realized");
 #endif
 	return;
     }
-#if GTK_SHEET_DEBUG_FREEZE > 0
-    g_debug("gtk_sheet_thaw: freeze_count == %d", sheet->freeze_count);
+
+#if GTK_SHEET_DEBUG_SIZE > 0
+    g_debug("gtk_sheet_autoresize_all: running");
 #endif
 
-    _gtk_sheet_scrollbar_adjust(sheet);
+    gboolean need_batch = (gtk_sheet_autoresize_columns(sheet) 
+                           || gtk_sheet_autoresize_rows(sheet));
+    
+    /* one geometry rebuild instead of one per column and row */
+    if (need_batch) gtk_sheet_geometry_begin(sheet);
 
-    if (gtk_widget_get_realized(GTK_WIDGET(sheet)))
+    /* measure deferred cells in one batch */
+    _gtk_sheet_resolve_all_extents(sheet);
+        
+    if (gtk_sheet_autoresize_columns(sheet))
     {
-	if (sheet->row_titles_visible)
-	{
-	    size_allocate_row_title_buttons(sheet);
-	    gdk_window_show(sheet->row_title_window);
-	}
+	gint col;
 
-	if (sheet->column_titles_visible)
+#if GTK_SHEET_DEBUG_SIZE > 0
+	g_debug("gtk_sheet_autoresize_all: columns");
+#endif
+
+	for (col = 0; col <= sheet->maxalloccol; col++)
 	{
-	    _gtk_sheet_column_buttons_size_allocate(sheet);
-	    gdk_window_show(sheet->column_title_window);
+	    if (GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
+	    {
+		_gtk_sheet_autoresize_column_internal(sheet, col);
+	    }
 	}
     }
 
-    GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IS_FROZEN);
-
-    if (gtk_sheet_autoresize(sheet))
+    if (gtk_sheet_autoresize_rows(sheet))
     {
-	GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_AUTORESIZE_PENDING);
-    }
+	gint row;
 
-    _gtk_sheet_redraw_internal(sheet, TRUE, TRUE);
+#if GTK_SHEET_DEBUG_SIZE > 0
+	g_debug("gtk_sheet_autoresize_all: rows");
+#endif
 
-    if (sheet->state == GTK_STATE_NORMAL)
-    {
-	if (sheet->sheet_entry && gtk_widget_get_mapped(sheet->sheet_entry))
+	for (row = 0; row <= sheet->maxallocrow; row++)
 	{
-	    gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
-	    /*
-	    gtk_sheet_entry_signal_connect_changed(sheet, gtk_sheet_entry_changed_handler);
-	    gtk_sheet_show_active_cell(sheet);
-	    */
+	    if (GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	    {
+		_gtk_sheet_autoresize_row_internal(sheet, row);
+	    }
 	}
     }
+
+    if (need_batch) gtk_sheet_geometry_commit(sheet);
 }
 
-/**
- * gtk_sheet_set_row_titles_width:
- * @sheet: a #GtkSheet
- * @width: row titles width.
- *
- * Resize row titles area.
- */
-void
-gtk_sheet_set_row_titles_width(GtkSheet *sheet, guint width)
+static gboolean
+_gtk_sheet_extents_idle_handler(gpointer data)
 {
-    if (width < GTK_SHEET_COLUMN_MIN_WIDTH)
-	return;
+    GtkSheet *sheet = GTK_SHEET(data);
+    GPtrArray *dirty;
+    GTimer *timer;
+    guint chunk;
+    gint total;
 
-    sheet->row_title_area.width = width;
+    GDK_THREADS_ENTER();
 
-    _gtk_sheet_recalc_top_ypixels(sheet);
-    _gtk_sheet_recalc_left_xpixels(sheet);
-    _gtk_sheet_recalc_view_range(sheet);
+    /* serial measuring runs in small batches until the time budget 
+       is spent, so the main loop stays responsive */
+    chunk = sheet->render_pool ? 
+	GTK_SHEET_EXTENT_CHUNK : GTK_SHEET_EXTENT_SERIAL_CHUNK;
 
-    _gtk_sheet_scrollbar_adjust(sheet);
-    _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
-}
+    dirty = g_ptr_array_new();
+    timer = g_timer_new();
+    total = sheet->maxallocrow + 1;
 
+    do
+    {
+	g_ptr_array_set_size(dirty, 0);
 
-/**
- * gtk_sheet_show_row_titles:
- * @sheet: a #GtkSheet
- *
- * Show row titles .
- */
-void
-gtk_sheet_show_row_titles(GtkSheet *sheet)
-{
-    gint row;
+	while (sheet->extent_cursor < total && dirty->len < chunk)
+	{
+	    _gtk_sheet_collect_dirty(sheet,
+		sheet->extent_cursor, sheet->extent_cursor + GTK_SHEET_BLOCK_ROWS - 1,
+		0, sheet->maxalloccol, dirty);
+	    sheet->extent_cursor += GTK_SHEET_BLOCK_ROWS;
+	}
+	sheet->extent_cursor = MIN(sheet->extent_cursor, total);
 
-    if (sheet->row_titles_visible)
-	return;
+	_gtk_sheet_measure_cells(sheet, dirty);
+    }
+    while (sheet->extent_cursor < total
+	&& g_timer_elapsed(timer, NULL) < GTK_SHEET_EXTENT_IDLE_BUDGET);
 
-    sheet->row_titles_visible = TRUE;
-    _gtk_sheet_recalc_top_ypixels(sheet);
-    _gtk_sheet_recalc_left_xpixels(sheet);
+    g_timer_destroy(timer);
+    g_ptr_array_free(dirty, TRUE);
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
-    if (GTK_SHEET_IS_FROZEN(sheet))
-	return;
+    if (sheet->extent_cursor >= total)
+    {
+	sheet->extent_idle = 0;
 
-    gdk_window_show(sheet->row_title_window);
+	if (gtk_sheet_autoresize(sheet))
+	    gtk_sheet_autoresize_all(sheet);
+    }
 
-    gdk_window_move_resize(sheet->row_title_window,
-	sheet->row_title_area.x,
-	sheet->row_title_area.y,
-	sheet->row_title_area.width,
-	sheet->row_title_area.height);
+    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[EXTENTS_PROGRESS], 0,
+	sheet->extent_cursor, total);
 
-    for (row = MIN_VIEW_ROW(sheet); row <= MAX_VIEW_ROW(sheet) && row <= sheet->maxrow; row++)
-    {
-	GtkSheetChild *child;
-	if (row < 0 || row > sheet->maxrow)
-	    continue;
+    GDK_THREADS_LEAVE();
 
-	child = sheet->row[row].button.child;
-	if (child)
-	    _gtk_sheet_child_show(child);
-    }
-    _gtk_sheet_scrollbar_adjust(sheet);
-    _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
+    return (sheet->extent_idle != 0);
 }
 
+/*
+ * _gtk_sheet_schedule_extents - measure dirty cells in the 
+ * background
+ * 
+ * starts over from the first row
+ * 
+ * @param sheet  the #GtkSheet
+ */
+static void
+_gtk_sheet_schedule_extents(GtkSheet *sheet)
+{
+    sheet->extent_cursor = 0;
+
+    if (!sheet->extent_idle)
+    {
+	sheet->extent_idle = g_idle_add_full(G_PRIORITY_LOW,
+	    _gtk_sheet_extents_idle_handler, sheet, NULL);
+    }
+}
 
 /**
- * gtk_sheet_hide_row_titles:
+ * gtk_sheet_refresh_extents:
  * @sheet: a #GtkSheet
  *
- * Hide row titles .
+ * Measure the text extents of all cells again, i.e. after 
+ * changing fonts the sheet does not know about. Cells are 
+ * measured in batches from an idle handler, by the render 
+ * threads if set, see gtk_sheet_set_render_threads(). Progress 
+ * is reported by the "extents-progress" signal. When done, an 
+ * autoresizing sheet fits its columns and rows in one update.
  */
 void
-gtk_sheet_hide_row_titles(GtkSheet *sheet)
+gtk_sheet_refresh_extents(GtkSheet *sheet)
 {
-    gint row;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (!sheet->row_titles_visible)
-	return;
+    if (sheet->extent_cache)
+	_gtk_sheet_extent_cache_flush(sheet->extent_cache);
 
-    sheet->row_titles_visible = FALSE;
-    _gtk_sheet_recalc_top_ypixels(sheet);
-    _gtk_sheet_recalc_left_xpixels(sheet);
+    _gtk_sheet_invalidate_extents(sheet);
+    _gtk_sheet_schedule_extents(sheet);
+}
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
-    if (GTK_SHEET_IS_FROZEN(sheet))
-	return;
-
-    if (sheet->row_title_window)
-	gdk_window_hide(sheet->row_title_window);
-
-    if (gtk_widget_get_visible(sheet->button))
-	gtk_widget_hide(sheet->button);
-
-    for (row = MIN_VIEW_ROW(sheet); row <= MAX_VIEW_ROW(sheet) && row <= sheet->maxrow; row++)
-    {
-	GtkSheetChild *child;
-	if (row < 0 || row > sheet->maxrow)
-	    continue;
+/**
+ * gtk_sheet_set_autoscroll:
+ * @sheet: a #GtkSheet
+ * @autoscroll: TRUE or FALSE
+ *
+ * The sheet will be automatically scrolled when you move beyond
+ * the last row/col in #GtkSheet.
+ */
+void
+gtk_sheet_set_autoscroll(GtkSheet *sheet, gboolean autoscroll)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-	child = sheet->row[row].button.child;
-	if (child)
-	    _gtk_sheet_child_hide(child);
-    }
-    _gtk_sheet_scrollbar_adjust(sheet);
-    _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
+    sheet->autoscroll = autoscroll;
 }
 
 /**
- * gtk_sheet_row_titles_visible:
+ * gtk_sheet_autoscroll:
  * @sheet: a #GtkSheet
  *
- * Get the visibility of row column titles .
+ * Get the autoscroll mode of #GtkSheet.
  *
  * Returns: TRUE or FALSE
  */
 gboolean
-gtk_sheet_row_titles_visible(GtkSheet *sheet)
+gtk_sheet_autoscroll(GtkSheet *sheet)
 {
     g_return_val_if_fail(sheet != NULL, FALSE);
     g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    return (sheet->row_titles_visible);
+    return (sheet->autoscroll);
 }
 
-
 /**
- * gtk_sheet_set_row_title:
+ * gtk_sheet_set_clip_text:
  * @sheet: a #GtkSheet
- * @row: row number
- * @title: row title
+ * @clip_text: TRUE or FALSE
  *
- * Set row title.
+ * Clip text in cell. When clip text mode is turned off, cell 
+ * text is written over neighbour columns, as long as their 
+ * contents are empty. 
  */
 void
-gtk_sheet_set_row_title(GtkSheet *sheet,
-    gint row,
-    const gchar *title)
+gtk_sheet_set_clip_text(GtkSheet *sheet, gboolean clip_text)
 {
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (sheet->row[row].name)
-	g_free(sheet->row[row].name);
-
-    sheet->row[row].name = g_strdup(title);
+    sheet->clip_text = clip_text;
+    _gtk_sheet_tile_cache_invalidate(sheet, NULL);
 }
 
 /**
- * gtk_sheet_get_row_title:
+ * gtk_sheet_clip_text:
  * @sheet: a #GtkSheet
- * @row: row number
  *
- * Get row title.
+ * Get clip text mode in #GtkSheet. When clip text mode is 
+ * turned off, cell text is written over neighbour columns, as 
+ * long as their contents are empty. 
  *
- * Returns: a pointer to the row title or NULL. 
- * Do not modify or free it. 
+ * Returns: TRUE or FALSE
  */
-const gchar *
-gtk_sheet_get_row_title(GtkSheet *sheet,
-    gint row)
+gboolean
+gtk_sheet_clip_text(GtkSheet *sheet)
 {
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    return (sheet->row[row].name);
+    return (sheet->clip_text);
 }
 
 /**
- * gtk_sheet_row_button_add_label:
+ * gtk_sheet_set_cairo_draw:
  * @sheet: a #GtkSheet
- * @row: row number
- * @label: text label
+ * @cairo_draw: TRUE to render cells with cairo
  *
- * Set button label.It is used to set a row title.
+ * Select the drawing backend. By default cells are drawn with 
+ * GdkGC directly into the backing pixmap. With cairo, cells are 
+ * rendered into client-side images, which enables the tile cache 
+ * and the render threads, see gtk_sheet_set_tile_cache_size() and 
+ * gtk_sheet_set_render_threads().
  */
 void
-gtk_sheet_row_button_add_label(GtkSheet *sheet, gint row, const gchar *label)
+gtk_sheet_set_cairo_draw(GtkSheet *sheet, gboolean cairo_draw)
 {
-    GtkSheetButton *button;
-    GtkRequisition req;
-    gboolean aux_c, aux_r;
-
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (row < 0 || row > sheet->maxrow)
+    cairo_draw = cairo_draw != FALSE;
+    if (cairo_draw == sheet->cairo_draw)
 	return;
 
-    button = &sheet->row[row].button;
-    if (button->label)
-	g_free(button->label);
-    button->label = g_strdup(label);
-
-    aux_c = gtk_sheet_autoresize_columns(sheet);
-    aux_r = gtk_sheet_autoresize_rows(sheet);
-    gtk_sheet_set_autoresize(sheet, FALSE);
-    gtk_sheet_set_autoresize_rows(sheet, TRUE);
-    _gtk_sheet_button_size_request(sheet, button, &req);
-    gtk_sheet_set_autoresize_columns(sheet, aux_c);
-    gtk_sheet_set_autoresize_rows(sheet, aux_r);
-
-    if (req.height > sheet->row[row].height)
-	gtk_sheet_set_row_height(sheet, row, req.height);
-
-    if (req.width > sheet->row_title_area.width)
-    {
-	gtk_sheet_set_row_titles_width(sheet, req.width);
-    }
+    sheet->cairo_draw = cairo_draw;
 
     if (!GTK_SHEET_IS_FROZEN(sheet))
-    {
-	_gtk_sheet_draw_button(sheet, row, -1);
-    }
-    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[CHANGED], 0, row, -1);
+	_gtk_sheet_range_draw(sheet, NULL, TRUE);
 }
 
 /**
- * gtk_sheet_row_button_get_label:
+ * gtk_sheet_cairo_draw:
  * @sheet: a #GtkSheet
- * @row: row number
  *
- * Get a row button label.
+ * Get the drawing backend, see gtk_sheet_set_cairo_draw().
  *
- * Returns: In case of succes , a pointer to label
- * text.Otherwise NULL
+ * Returns: TRUE when cells are rendered with cairo
  */
-const gchar *
-gtk_sheet_row_button_get_label(GtkSheet *sheet, gint row)
+gboolean
+gtk_sheet_cairo_draw(GtkSheet *sheet)
 {
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
-
-    if (row < 0 || row > sheet->maxrow)
-	return (NULL);
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    return (sheet->row[row].button.label);
+    return (sheet->cairo_draw);
 }
 
 /**
- * gtk_sheet_row_label_set_visibility:
+ * gtk_sheet_set_tile_cache_size:
  * @sheet: a #GtkSheet
- * @row: row number
- * @visible: TRUE or FALSE
+ * @kbytes: memory budget in kilobytes, 0 disables the cache
  *
- * Set row label visibility.
+ * Keep rendered cells in image tiles, so that scrolling back to 
+ * cells shown before copies the tiles instead of painting the 
+ * cells again. While the sheet is idle, the page ahead in the 
+ * scroll direction is rendered in advance. Least recently used 
+ * tiles are dropped when @kbytes are exceeded. The cache is 
+ * disabled by default and used only while drawing with cairo, see 
+ * gtk_sheet_set_cairo_draw().
  */
 void
-gtk_sheet_row_label_set_visibility(GtkSheet *sheet, gint row, gboolean visible)
+gtk_sheet_set_tile_cache_size(GtkSheet *sheet, guint kbytes)
 {
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (row < 0 || row > sheet->maxrow)
+#if GTK_SHEET_TILE_CACHE
+    if (kbytes == 0)
+    {
+	if (sheet->tile_cache)
+	{
+	    _gtk_sheet_tile_cache_free(sheet->tile_cache);
+	    sheet->tile_cache = NULL;
+	}
 	return;
+    }
 
-    sheet->row[row].button.label_visible = visible;
+    if (!sheet->tile_cache)
+	sheet->tile_cache = _gtk_sheet_tile_cache_new();
 
-    if (!GTK_SHEET_IS_FROZEN(sheet))
-    {
-	_gtk_sheet_draw_button(sheet, row, -1);
-	g_signal_emit(GTK_OBJECT(sheet), sheet_signals[CHANGED], 0, row, -1);
-    }
+    sheet->tile_cache->budget = (gsize)kbytes * 1024;
+    _gtk_sheet_tile_cache_trim(sheet->tile_cache);
+#endif
 }
 
 /**
- * gtk_sheet_rows_labels_set_visibility:
+ * gtk_sheet_get_tile_cache_size:
  * @sheet: a #GtkSheet
- * @visible: TRUE or FALSE
  *
- * Set all rows label visibility. The sheet itself
- * has no such property, this is a convenience function to set
- * the property for all existing rows.
+ * Get the memory budget of the tile cache, see 
+ * gtk_sheet_set_tile_cache_size().
+ *
+ * Returns: the budget in kilobytes, 0 when the cache is disabled
  */
-void
-gtk_sheet_rows_labels_set_visibility(GtkSheet *sheet, gboolean visible)
+guint
+gtk_sheet_get_tile_cache_size(GtkSheet *sheet)
 {
-    gint i;
-
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_return_val_if_fail(sheet != NULL, 0);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), 0);
 
-    for (i = 0; i <= sheet->maxrow; i++) gtk_sheet_row_label_set_visibility(sheet, i, visible);
+#if GTK_SHEET_TILE_CACHE
+    if (sheet->tile_cache)
+	return (sheet->tile_cache->budget / 1024);
+#endif
+    return (0);
 }
 
-
 /**
- * gtk_sheet_row_button_justify:
- * @sheet: a #GtkSheet.
- * @row: row number
- * @justification: a #GtkJustification :GTK_JUSTIFY_LEFT, RIGHT, 
- *  			 CENTER
+ * gtk_sheet_set_render_threads:
+ * @sheet: a #GtkSheet
+ * @n_threads: number of worker threads, 0 or 1 renders on the 
+ *           main thread
  *
- * Set the justification(alignment) of the row buttons.
+ * Render large damaged areas in parallel. The main thread copies 
+ * the visible cells' text and attributes, worker threads shape and 
+ * render bands of rows into an image and the main thread copies the 
+ * image to the screen. Threads must have been initialized, see 
+ * g_thread_init(). Requires Pango 1.32 or newer, older versions 
+ * keep rendering on the main thread. Rendering needs cairo drawing, 
+ * see gtk_sheet_set_cairo_draw(), cell extents are measured by the 
+ * threads in either case. Not used while a tile cache is set, see 
+ * gtk_sheet_set_tile_cache_size(). The default is 0.
  */
 void
-gtk_sheet_row_button_justify(GtkSheet *sheet, gint row,
-    GtkJustification justification)
+gtk_sheet_set_render_threads(GtkSheet *sheet, guint n_threads)
 {
-    GtkSheetButton *button;
-
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (row < 0 || row > sheet->maxrow)
+#if GTK_SHEET_RENDER_THREADS
+    if (n_threads < 2)
+    {
+	if (sheet->render_pool)
+	{
+	    _gtk_sheet_render_pool_free(sheet->render_pool);
+	    sheet->render_pool = NULL;
+	}
 	return;
+    }
 
-    button = &sheet->row[row].button;
-    button->justification = justification;
+    if (!g_thread_supported())
+    {
+	g_warning("gtk_sheet_set_render_threads: threads not initialized");
+	return;
+    }
 
-    if (!GTK_SHEET_IS_FROZEN(sheet))
+    if (!sheet->render_pool)
     {
-	_gtk_sheet_draw_button(sheet, row, -1);
+	sheet->render_pool = _gtk_sheet_render_pool_new(n_threads);
+	return;
     }
+
+    g_thread_pool_set_max_threads(sheet->render_pool->pool, n_threads, NULL);
+    g_thread_pool_set_max_threads(sheet->render_pool->extent_pool, n_threads, NULL);
+    sheet->render_pool->n_threads = n_threads;
+#endif
 }
 
 /**
- * gtk_sheet_moveto:
- * @sheet: a #GtkSheet.
- * @row: row number
- * @column: column number
- * @row_align: row alignment
- * @col_align: column alignment
+ * gtk_sheet_get_render_threads:
+ * @sheet: a #GtkSheet
  *
- * Scroll the viewing area of the sheet to the given column and row;
- *  
- * row_align and col_align are between 0-1 representing the location 
- * the row should appear on the screnn, 0 being top or left, 
- * 1 being bottom or right.
- * 
- * passing row_align/col_align of -1 will suppress movement in
- * that direction.
- *  
- * if row or column is negative then there is no change
+ * Get the number of render threads, see 
+ * gtk_sheet_set_render_threads().
+ *
+ * Returns: the number of worker threads, 0 when rendering on the 
+ * main thread
  */
-
-void
-gtk_sheet_moveto(GtkSheet *sheet,
-    gint row,
-    gint col,
-    gint row_align,
-    gint col_align)
+guint
+gtk_sheet_get_render_threads(GtkSheet *sheet)
 {
-    gint x, y;
-    guint width, height;
-
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
-    g_return_if_fail(sheet->hadjustment != NULL);
-    g_return_if_fail(sheet->vadjustment != NULL);
+    g_return_val_if_fail(sheet != NULL, 0);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), 0);
 
-#if GTK_SHEET_DEBUG_MOVE > 0
-    g_debug("gtk_sheet_moveto: row %d col %d row_align %d col_align %d",
-	row, col, row_align, col_align);
+#if GTK_SHEET_RENDER_THREADS
+    if (sheet->render_pool)
+	return (sheet->render_pool->n_threads);
 #endif
+    return (0);
+}
 
-    if (row < 0 || row > sheet->maxrow)
+/**
+ * _gtk_sheet_tile_cache_invalidate:
+ * @sheet:  the #GtkSheet
+ * @range:  changed cells or NULL for all
+ *
+ * drop the rendered tiles showing a range, including the tiles 
+ * its text overflows into
+ */
+void
+_gtk_sheet_tile_cache_invalidate(GtkSheet *sheet, const GtkSheetRange *range)
+{
+#if GTK_SHEET_TILE_CACHE
+    GtkSheetRange drop;
+
+    if (!sheet->tile_cache)
 	return;
-    if (col < 0 || col > sheet->maxcol)
+
+    if (!range)
+    {
+	_gtk_sheet_tile_cache_flush(sheet->tile_cache);
 	return;
+    }
 
-    height = sheet->sheet_window_height;
-    width = sheet->sheet_window_width;
+    drop.row0 = MAX(range->row0, 0);
+    drop.rowi = MIN(range->rowi, sheet->maxrow);
+    drop.col0 = MAX(range->col0, 0);
+    drop.coli = MIN(range->coli, sheet->maxcol);
 
-    /* adjust vertical scrollbar */
+    if (drop.row0 > drop.rowi || drop.col0 > drop.coli)
+	return;
 
-    if (row >= 0 && row_align >= 0)
-    {
-	if (row_align == 0)  /* align top cell border */
-	{
-	    y = _gtk_sheet_row_top_ypixel(sheet, row) - sheet->voffset;
+    if (!gtk_sheet_clip_text(sheet))
+	_gtk_sheet_range_add_text_columns(sheet, &drop);
 
-	    if (sheet->column_titles_visible)
-		y -= sheet->column_title_area.height; /* to bottom edge of title area*/
-	}
-	else  /* align bottom cell border */
-	{
-	    y = _gtk_sheet_row_top_ypixel(sheet, row) - sheet->voffset
-		+ sheet->row[row].height;
+    _gtk_sheet_tile_cache_drop(sheet->tile_cache, &drop);
+#endif
+}
 
-	    y -= height;  /* to bottom edge of window */
-	}
-
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
-	g_debug("gtk_sheet_moveto: rowTpx %d voffs %d height %d rheight %d colTw %s y %d", 
-	    _gtk_sheet_row_top_ypixel(sheet, row), sheet->voffset, 
-	    height, sheet->row[row].height, 
-	    sheet->column_titles_visible ? "Yes" : "No",
-	    y);
-#endif
-
-	if (y < 0)
-	    gtk_adjustment_set_value(sheet->vadjustment, 0.0);
-	else
-	    gtk_adjustment_set_value(sheet->vadjustment, y);
-
-	sheet->old_vadjustment = -1.;
-
-	if (sheet->vadjustment)
-	{
-	    g_signal_emit_by_name(GTK_OBJECT(sheet->vadjustment), "value_changed");
-	}
-    }
-
-    /* adjust horizontal scrollbar */
-    if (col >= 0 && col_align >= 0)  /* left or right align */
-    {
-	if (col_align == 0)  /* align left cell border */
-	{
-	    x = _gtk_sheet_column_left_xpixel(sheet, col) - sheet->hoffset;
-
-	    if (sheet->row_titles_visible)
-		x -= sheet->row_title_area.width; /* to right edge of title area*/
-	}
-	else  /* align right cell border */
-	{
-	    x = _gtk_sheet_column_left_xpixel(sheet, col) - sheet->hoffset
-		+ COLPTR(sheet, col)->width;
-
-	    x -= width;  /* to right edge of window */
-	}
-
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
-	g_debug("gtk_sheet_moveto: colLpx %d hoffs %d width %d cwidth %d rowTw %s x %d", 
-	    _gtk_sheet_column_left_xpixel(sheet, col), sheet->hoffset, 
-	    width, COLPTR(sheet, col)->width, 
-	    sheet->row_titles_visible ? "Yes" : "No",
-	    x);
-#endif
-
-	if (x < 0)
-	    gtk_adjustment_set_value(sheet->hadjustment, 0.0);
-	else
-	    gtk_adjustment_set_value(sheet->hadjustment, x);
-
-	sheet->old_hadjustment = -1.;
+/**
+ * gtk_sheet_set_justify_entry:
+ * @sheet: a #GtkSheet
+ * @justify: TRUE or FALSE
+ *
+ * Justify cell entry editor in #GtkSheet.
+ */
+void
+gtk_sheet_set_justify_entry(GtkSheet *sheet, gboolean justify)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-	if (sheet->hadjustment)
-	{
-	    g_signal_emit_by_name(GTK_OBJECT(sheet->hadjustment), "value_changed");
-	}
-    }
+    sheet->justify_entry = justify;
 }
 
-
 /**
- * gtk_sheet_row_sensitive:
- * @sheet: a #GtkSheet.
- * @row: row number
+ * gtk_sheet_justify_entry:
+ * @sheet: a #GtkSheet
  *
- * Get row button sensitivity. 
- *  
- * Returns: 
- * TRUE - is sensitive,  
- * FALSE - insensitive or not existant 
+ * Get the cell entry editor justification setting from 
+ * #GtkSheet. 
+ *
+ * Returns: TRUE or FALSE
  */
 gboolean
-gtk_sheet_row_sensitive(GtkSheet *sheet, gint row)
+gtk_sheet_justify_entry(GtkSheet *sheet)
 {
     g_return_val_if_fail(sheet != NULL, FALSE);
     g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    if (row < 0 || row > sheet->maxrow)
-	return (FALSE);
-
-    return (GTK_SHEET_ROW_IS_SENSITIVE(ROWPTR(sheet, row)));
+    return (sheet->justify_entry);
 }
 
 /**
- * gtk_sheet_row_set_sensitivity:
- * @sheet: a #GtkSheet.
- * @row: row number
- * @sensitive: TRUE or FALSE
+ * gtk_sheet_set_vjustification:
+ * @sheet: a #GtkSheet
+ * @vjust: a #GtkSheetVerticalJustification
  *
- * Set row button sensitivity. If sensitivity is TRUE can be toggled, otherwise it acts as a title .
+ * Set the default vertical cell text justification for 
+ * #GtkSheet. 
  */
 void
-gtk_sheet_row_set_sensitivity(GtkSheet *sheet, gint row,  gboolean sensitive)
+gtk_sheet_set_vjustification(GtkSheet *sheet, GtkSheetVerticalJustification vjust)
 {
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (row < 0 || row > sheet->maxrow)
-	return;
-
-    GTK_SHEET_ROW_SET_SENSITIVE(ROWPTR(sheet, row), sensitive);
-
-    if (!sensitive)
-	sheet->row[row].button.state = GTK_STATE_INSENSITIVE;
-    else
-	sheet->row[row].button.state = GTK_STATE_NORMAL;
-
-    if (gtk_widget_get_realized(GTK_WIDGET(sheet)) && !GTK_SHEET_IS_FROZEN(sheet))
-	_gtk_sheet_draw_button(sheet, row, -1);
+    sheet->vjust = vjust;
+    _gtk_sheet_tile_cache_invalidate(sheet, NULL);
 }
 
 /**
- * gtk_sheet_rows_set_sensitivity:
- * @sheet: a #GtkSheet.
- * @sensitive: TRUE or FALSE
+ * gtk_sheet_get_vjustification:
+ * @sheet: a #GtkSheet
  *
- * Set rows buttons sensitivity. If sensitivity is TRUE button
- * can be toggled, otherwise act as titles. The sheet itself
- * has no such property, it is a convenience function to set the
- * property for all existing rows.
+ * Get the default vertical cell text justification from 
+ * #GtkSheet. 
+ *
+ * Returns: the default #GtkSheetVerticalJustification
  */
-void
-gtk_sheet_rows_set_sensitivity(GtkSheet *sheet, gboolean sensitive)
+GtkSheetVerticalJustification
+gtk_sheet_get_vjustification(GtkSheet *sheet)
 {
-    gint i;
-
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    for (i = 0; i <= sheet->maxrow; i++) gtk_sheet_row_set_sensitivity(sheet, i, sensitive);
+    return (sheet->vjust);
 }
 
 /**
- * gtk_sheet_rows_set_resizable:
- * @sheet: a #GtkSheet.
- * @resizable: TRUE or FALSE
+ * gtk_sheet_set_traverse_type:
+ * @sheet: a #GtkSheet
+ * @ttype: a #GtkSheetTraverseType
  *
- * Set rows resizable status.
+ * Set the default traversal type for cursor movement in a 
+ * #GtkSheet. 
  */
 void
-gtk_sheet_rows_set_resizable(GtkSheet *sheet, gboolean resizable)
+gtk_sheet_set_traverse_type(GtkSheet *sheet, GtkSheetTraverseType ttype)
 {
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    sheet->rows_resizable = resizable;
+    sheet->traverse_type = ttype;
 }
 
 /**
- * gtk_sheet_rows_resizable:
- * @sheet: a #GtkSheet.
+ * gtk_sheet_get_traverse_type:
+ * @sheet: a #GtkSheet
  *
- * Get rows resizable status.
+ * Get the default cell traversal type from #GtkSheet. 
  *
- * Returns: TRUE or FALSE
+ * Returns: the default #GtkSheetTraverseType
  */
-gboolean
-gtk_sheet_rows_resizable(GtkSheet *sheet)
+GtkSheetTraverseType
+gtk_sheet_get_traverse_type(GtkSheet *sheet)
 {
     g_return_val_if_fail(sheet != NULL, FALSE);
     g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    return (sheet->rows_resizable);
+    return (sheet->traverse_type);
 }
 
 
+
 /**
- * gtk_sheet_row_visible:
- * @sheet: a #GtkSheet.
- * @row: row number
+ * gtk_sheet_set_locked:
+ * @sheet: a #GtkSheet
+ * @locked: TRUE or FALSE
  *
- * Get row visibility. 
- *  
- * Returns: 
- * TRUE - is visible 
- * FALSE - invisible or not existant 
+ * Lock the #GtkSheet, which means it is no longer editable,
+ * cell contents cannot be modified by the user.
+    */
+void
+gtk_sheet_set_locked(GtkSheet *sheet, gboolean locked)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+
+    sheet->locked = locked;
+}
+
+/**
+ * gtk_sheet_locked:
+ * @sheet: a #GtkSheet
+ *
+ * Get the lock status of #GtkSheet, locked means the sheet is
+ * not editable, cell contents cannot be modified by the user.
+ *
+ * Returns: TRUE or FALSE
  */
 gboolean
-gtk_sheet_row_visible(GtkSheet *sheet, gint row)
+gtk_sheet_locked(GtkSheet *sheet)
 {
     g_return_val_if_fail(sheet != NULL, FALSE);
     g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    if (row < 0 || row > sheet->maxrow)
-	return (FALSE);
-
-    return (GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row)));
+    return (sheet->locked);
 }
 
+/* This routine has problems with gtk+-1.2 related with the
+ * label/button drawing - I think it's a bug in gtk+-1.2 */
+
 /**
- * gtk_sheet_row_set_visibility:
- * @sheet: a #GtkSheet.
- * @row: row number
- * @visible: TRUE or FALSE
+ * gtk_sheet_set_title:
+ * @sheet: a #GtkSheet
+ * @title: #GtkSheet title
  *
- * Set row visibility. The default value is TRUE. If FALSE, the row is hidden.
+ * Set  #GtkSheet title. The widget will keep a copy of the
+ * string.
  */
 void
-gtk_sheet_row_set_visibility(GtkSheet *sheet, gint row, gboolean visible)
+gtk_sheet_set_title(GtkSheet *sheet, const gchar *title)
 {
-    GtkSheetRow *rowobj;
-    gint act_row, act_col;
+    GtkWidget *label;
 
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (row < 0 || row > sheet->maxrow)
-	return;
+    if (sheet->title)
+    {
+	g_free(sheet->title);
+	sheet->title = NULL;
+    }
+    if (title)
+    {
+	sheet->title = g_strdup(title);
+    }
 
-    rowobj = ROWPTR(sheet, row);
-    if (GTK_SHEET_ROW_IS_VISIBLE(rowobj) == visible)
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)) || !title)
 	return;
 
-    act_row = sheet->active_cell.row;
-    act_col = sheet->active_cell.col;
+    if (gtk_bin_get_child(GTK_BIN(sheet->button)))
+	label = gtk_bin_get_child(GTK_BIN(sheet->button));
+/*
+  gtk_label_set_text(GTK_LABEL(label), title);
+*/
+    size_allocate_global_button(sheet);
 
-    if (act_row == row)   /* hide active column -> disable active cell */
+    /* remove and destroy the old widget */
+/*
+  old_widget = gtk_bin_get_child(GTK_BIN (sheet->button));
+  if (old_widget)
     {
-	_gtk_sheet_hide_active_cell(sheet);
-
-	sheet->active_cell.row = -1;
-	sheet->active_cell.col = -1;
+      gtk_container_remove (GTK_CONTAINER (sheet->button), old_widget);
     }
 
-    act_row = sheet->active_cell.row;
-    act_col = sheet->active_cell.col;
+  label = gtk_label_new (title);
+  gtk_misc_set_alignment(GTK_MISC(label), 0.5 , 0.5 );
 
-    GTK_SHEET_ROW_SET_VISIBLE(rowobj, visible);
-
-    _gtk_sheet_range_fixup(sheet, &sheet->range);
-    _gtk_sheet_recalc_top_ypixels(sheet);
-
-    _gtk_sheet_scrollbar_adjust(sheet);
-    _gtk_sheet_redraw_internal(sheet, FALSE, TRUE);
-}
+  gtk_container_add (GTK_CONTAINER (sheet->button), label);
+  gtk_widget_show (label);
 
+  size_allocate_global_button(sheet);
 
-/**
- * gtk_sheet_get_tooltip_markup: 
- * @sheet:  a #GtkSheet. 
- *  
- * Gets the contents of the tooltip (markup) for sheet 
- * 
- * Returns:	the tooltip text, or NULL. You should free the 
- *          returned string with g_free() when done.
- */
-gchar *gtk_sheet_get_tooltip_markup(GtkSheet *sheet)
-{
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
+  g_signal_emit(GTK_OBJECT(sheet),sheet_signals[CHANGED], 0, -1, -1);
 
-    return (gtk_widget_get_tooltip_markup(GTK_WIDGET(sheet)));
+  if(old_widget)
+      gtk_widget_destroy (old_widget);
+*/
 }
 
 /**
- * gtk_sheet_set_tooltip_markup: 
- * @sheet:  a #GtkSheet.
- * @markup:  	the contents of the tooltip for widget, or NULL. 
- *  
- * Sets markup as the contents of the tooltip, which is marked 
- * up with the Pango text markup language. 
+ * gtk_sheet_set_description:
+ * @sheet: a #GtkSheet
+ * @description: #GtkSheet description
+ *
+ * Set  #GtkSheet description for application use. 
  */
-void gtk_sheet_set_tooltip_markup(GtkSheet *sheet,
-    const gchar *markup)
+void
+gtk_sheet_set_description(GtkSheet *sheet, const gchar *description)
 {
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    gtk_widget_set_tooltip_markup(GTK_WIDGET(sheet), markup);
+    if (sheet->description)
+	g_free(sheet->description);
+    sheet->description = g_strdup(description);
 }
 
 /**
- * gtk_sheet_get_tooltip_text:
- * @sheet:  a #GtkSheet. 
- *  
- * Gets the contents of the tooltip for the #GtkSheet
- * 
- * Returns:	the tooltip text, or NULL. You should free the 
- *          returned string with g_free() when done.
+ * gtk_sheet_get_description:
+ * @sheet: a #GtkSheet
+ * @description: #GtkSheet description
+ *
+ * Get sheet description.
+ *
+ * Returns: sheet description or NULL, do not modify or free it
  */
-gchar *gtk_sheet_get_tooltip_text(GtkSheet *sheet)
+const gchar *
+gtk_sheet_get_description(GtkSheet *sheet, const gchar *description)
 {
     g_return_val_if_fail(sheet != NULL, NULL);
     g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
 
-    return (gtk_widget_get_tooltip_text(GTK_WIDGET(sheet)));
+    return (sheet->description);
 }
 
-/**
- * gtk_sheet_set_tooltip_text: 
- * @sheet:  a #GtkSheet.
- * @text:  the contents of the tooltip for widget 
- *  
- * Sets text as the contents of the tooltip. 
- */
-void gtk_sheet_set_tooltip_text(GtkSheet *sheet,
-    const gchar *text)
-{
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
-
-    gtk_widget_set_tooltip_text(GTK_WIDGET(sheet), text);
-}
 
 /**
- * gtk_sheet_row_get_tooltip_markup: 
- * @sheet:  a #GtkSheet. 
- * @row: row index 
- *  
- * Gets the contents of the tooltip (markup) for the column 
+ * gtk_sheet_is_frozen:
+ * @sheet: the #GtkSheet 
  *  
- * Returns:	the tooltip text, or NULL. You should free the 
- *          returned string with g_free() when done.
+ * Get freeze status. 
+ * 
+ * Returns: TRUE or FALSE wether the sheet is frozen
  */
-gchar *gtk_sheet_row_get_tooltip_markup(GtkSheet *sheet,
-    const gint row)
+gboolean gtk_sheet_is_frozen(GtkSheet *sheet)
 {
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
-
-    if (row < 0 || row > sheet->maxrow)
-	return (NULL);
-
-    return (g_strdup(ROWPTR(sheet, row)->tooltip_markup));
+    return (GTK_SHEET_IS_FROZEN(sheet));
 }
 
+
 /**
- * gtk_sheet_row_set_tooltip_markup: 
- * @sheet:  a #GtkSheet.
- * @row: row index 
- * @markup:  	the contents of the tooltip for widget, or NULL. 
- *  
- * Sets markup as the contents of the tooltip, which is marked 
- * up with the Pango text markup language. 
+ * gtk_sheet_freeze:
+ * @sheet: a #GtkSheet
+ *
+ * Freeze all visual updates of the #GtkSheet.
+ * The updates will occure in a more efficient way than if you made them on a unfrozen #GtkSheet .
  */
-void gtk_sheet_row_set_tooltip_markup(GtkSheet *sheet,
-    const gint row,
-    const gchar *markup)
+void
+gtk_sheet_freeze(GtkSheet *sheet)
 {
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (row < 0 || row > sheet->maxrow)
-	return;
+    sheet->freeze_count++;
+    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IS_FROZEN);
+
+#if GTK_SHEET_DEBUG_FREEZE > 0
+    g_debug("gtk_sheet_freeze: freeze_count == %d", sheet->freeze_count);
+#endif
 
-    if (sheet->row[row].tooltip_markup)
-	g_free(sheet->row[row].tooltip_markup);
-    sheet->row[row].tooltip_markup = g_strdup(markup);
 }
 
+
 /**
- * gtk_sheet_row_get_tooltip_text: 
- * @sheet:  a #GtkSheet. 
- * @row: row index 
+ * _gtk_sheet_redraw_internal: 
+ * @sheet:  to be redrawn 
+ * @reset_hadjustment: wether to reset horizontal adjustment
+ * @reset_vadjustment: wether to reset vertical adjustment
  *  
- * Gets the contents of the tooltip for the column 
- * 
- * Returns:	the tooltip text, or NULL. You should free the 
- *          returned string with g_free() when done.
+ *  do a complete sheet redraw. used after rows/cols have been
+ *  appended/deleted or after combined operations while the
+ *  sheet was frozen
  */
-gchar *gtk_sheet_row_get_tooltip_text(GtkSheet *sheet,
-    const gint row)
+void _gtk_sheet_redraw_internal(GtkSheet *sheet,
+    gboolean reset_hadjustment,
+    gboolean reset_vadjustment)
 {
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
-
-    if (row < 0 || row > sheet->maxrow)
-	return (NULL);
+    gboolean done = FALSE;  /* handle sheets with no scrollbars */
 
-    return (g_strdup(ROWPTR(sheet, row)->tooltip_text));
-}
+    _gtk_sheet_tile_cache_invalidate(sheet, NULL);
 
-/**
- * gtk_sheet_row_set_tooltip_text: 
- * @sheet:  a #GtkSheet.
- * @row: row index 
- * @text:  the contents of the tooltip for widget 
- *  
- * Sets text as the contents of the tooltip. 
- */
-void gtk_sheet_row_set_tooltip_text(GtkSheet *sheet,
-    const gint row,
-    const gchar *text)
-{
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    if (reset_hadjustment)
+	sheet->old_hadjustment = -1.;  /* causes redraw */
+    if (reset_vadjustment)
+	sheet->old_vadjustment = -1.;  /* causes redraw */
 
-    if (row < 0 || row > sheet->maxrow)
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+    if (GTK_SHEET_IS_FROZEN(sheet))
 	return;
 
-    if (sheet->row[row].tooltip_text)
-	g_free(sheet->row[row].tooltip_text);
-    sheet->row[row].tooltip_text = g_strdup(text);
-}
+#if GTK_SHEET_DEBUG_DRAW > 0
+    g_debug("_gtk_sheet_redraw_internal: called");
+#endif
 
-/**
- * gtk_sheet_row_get_readonly: 
- * @sheet:  a #GtkSheet. 
- * @row: row index 
- *  
- * Gets the row readonly flag 
- *  
- * Returns:	the readonly flag
- */
-gboolean gtk_sheet_row_get_readonly(GtkSheet *sheet, const gint row)
-{
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+    _gtk_sheet_recalc_view_range(sheet);
 
-    if (row < 0 || row > sheet->maxrow) return (FALSE);
+    if (sheet->row_titles_visible || sheet->column_titles_visible)
+    {
+	size_allocate_global_button(sheet);
+    }
+
+    if (sheet->row_titles_visible)
+    {
+	size_allocate_row_title_buttons(sheet);
+    }
+
+    if (sheet->column_titles_visible)
+    {
+	_gtk_sheet_column_buttons_size_allocate(sheet);
+    }
+
+    /* send value_changed or redraw directly */
+
+    if (sheet->vadjustment)
+    {
+	g_signal_emit_by_name(GTK_OBJECT(sheet->vadjustment), "value_changed");
+	done = TRUE;
+    }
+
+    if (sheet->hadjustment)
+    {
+	g_signal_emit_by_name(GTK_OBJECT(sheet->hadjustment), "value_changed");
+	done = TRUE;
+    }
 
-    return (ROWPTR(sheet, row)->is_readonly);
+    if (!done)
+    {
+	_gtk_sheet_range_draw(sheet, NULL, TRUE);
+    }
 }
 
+
 /**
- * gtk_sheet_row_set_readonly: 
- * @sheet:  a #GtkSheet.
- * @row: row index 
- * @is_readonly:  the row is_readonly flag 
- *  
- * Sets the row readonly flag. 
- * A cell is editable if the sheet is not locked, the row is 
- * not readonly and the cell (-range) was set to editable. 
+ * gtk_sheet_thaw:
+ * @sheet: a #GtkSheet
+ *
+ * Thaw the sheet after you have made a number of changes on a frozen sheet.
+ * The updates will occure in a more efficient way than if you made them on a unfrozen sheet .
  */
-void gtk_sheet_row_set_readonly(GtkSheet *sheet, const gint row,
-                                   const gboolean is_readonly)
+void
+gtk_sheet_thaw(GtkSheet *sheet)
 {
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (row < 0 || row > sheet->maxrow) return;
-
-    ROWPTR(sheet, row)->is_readonly = is_readonly;
-}
+    if (sheet->freeze_count == 0)
+	return;
 
-/**
- * gtk_sheet_row_get_can_focus: 
- * @sheet:  a #GtkSheet. 
- * @row: row index 
- *  
- * Gets the row can_focus flag 
- *  
- * Returns:	the can_focus flag
- */
-gboolean gtk_sheet_row_get_can_focus(GtkSheet *sheet, const gint row)
-{
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+    sheet->freeze_count--;
+    if (sheet->freeze_count > 0)
+    {
+#if GTK_SHEET_DEBUG_FREEZE > 0
+	g_warning("gtk_sheet_thaw: ignored (freeze_count > 0)");
+#endif
+	return;
+    }
+#if GTK_SHEET_DEBUG_FREEZE > 0
+    g_debug("gtk_sheet_thaw: freeze_count == %d", sheet->freeze_count);
+#endif
 
-    if (row < 0 || row > sheet->maxrow) return (FALSE);
+    _gtk_sheet_scrollbar_adjust(sheet);
 
-    return (ROWPTR(sheet, row)->can_focus);
-}
+    if (gtk_widget_get_realized(GTK_WIDGET(sheet)))
+    {
+	if (sheet->row_titles_visible)
+	{
+	    size_allocate_row_title_buttons(sheet);
+	    gdk_window_show(sheet->row_title_window);
+	}
 
-/**
- * gtk_sheet_row_set_can_focus: 
- * @sheet:  a #GtkSheet.
- * @row: row index 
- * @can_focus:  the row can_focus flag 
- *  
- * Sets the row can_focus flag. 
- * Note: Does not check row visiblity, sensitivity, etc. Use the
- * macro GTK_SHEET_ROW_CAN_GRAB_FOCUS() for dependency checking.
- */
-void gtk_sheet_row_set_can_focus(GtkSheet *sheet, const gint row,
-                                   const gboolean can_focus)
-{
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+	if (sheet->column_titles_visible)
+	{
+	    _gtk_sheet_column_buttons_size_allocate(sheet);
+	    gdk_window_show(sheet->column_title_window);
+	}
+    }
 
-    if (row < 0 || row > sheet->maxrow) return;
+    GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IS_FROZEN);
+
+    if (gtk_sheet_autoresize(sheet))
+    {
+	GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_AUTORESIZE_PENDING);
+    }
+
+    _gtk_sheet_redraw_internal(sheet, TRUE, TRUE);
 
-    ROWPTR(sheet, row)->can_focus = can_focus;
+    if (sheet->state == GTK_STATE_NORMAL)
+    {
+	if (sheet->sheet_entry && gtk_widget_get_mapped(sheet->sheet_entry))
+	{
+	    gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
+	    /*
+	    gtk_sheet_entry_signal_connect_changed(sheet, gtk_sheet_entry_changed_handler);
+	    gtk_sheet_show_active_cell(sheet);
+	    */
+	}
+    }
 }
 
 /**
- * gtk_sheet_cell_get_tooltip_markup: 
- * @sheet:  a #GtkSheet. 
- * @row: row index 
- * @col: column index 
- *  
- * Gets the contents of the tooltip (markup) for the column 
- * 
- * Returns:	the tooltip text, or NULL. You should free the 
- *          returned string with g_free() when done.
+ * gtk_sheet_geometry_begin:
+ * @sheet: a #GtkSheet
+ *
+ * Start a batch of row height, column width and visibility 
+ * changes. The sheet is frozen and row and column offsets are 
+ * not updated until gtk_sheet_geometry_commit(), so pixel 
+ * positions still report the geometry before the batch. Batches 
+ * may be nested.
  */
-gchar *gtk_sheet_cell_get_tooltip_markup(GtkSheet *sheet,
-    const gint row, const gint col)
+void
+gtk_sheet_geometry_begin(GtkSheet *sheet)
 {
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
-
-    if (col < 0 || col > sheet->maxcol)
-	return (NULL);
-    if (row < 0 || row > sheet->maxrow)
-	return (NULL);
-
-    if (row > sheet->maxallocrow || col > sheet->maxalloccol)
-	return (NULL);
-
-    if (!sheet->data[row])
-	return (NULL);
-    if (!sheet->data[row][col])
-	return (NULL);
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    return (g_strdup(sheet->data[row][col]->tooltip_markup));
+    sheet->geometry_batch++;
+    gtk_sheet_freeze(sheet);
 }
 
 /**
- * gtk_sheet_cell_set_tooltip_markup: 
- * @sheet:  a #GtkSheet.
- * @row: row index 
- * @col: column index 
- * @markup:  	the contents of the tooltip for widget, or NULL. 
- *  
- * Sets markup as the contents of the tooltip, which is marked 
- * up with the Pango text markup language. 
+ * gtk_sheet_geometry_commit:
+ * @sheet: a #GtkSheet
+ *
+ * End a batch started with gtk_sheet_geometry_begin(). The 
+ * outermost commit rebuilds the row and column offsets once, 
+ * then thawing the sheet adjusts the scrollbars, positions the 
+ * children and redraws.
  */
-void gtk_sheet_cell_set_tooltip_markup(GtkSheet *sheet,
-    const gint row, const gint col,
-    const gchar *markup)
+void
+gtk_sheet_geometry_commit(GtkSheet *sheet)
 {
-    GtkSheetCell *cell;
-
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_return_if_fail(sheet->geometry_batch > 0);
 
-    if (col < 0 || col > sheet->maxcol)
-	return;
-    if (row < 0 || row > sheet->maxrow)
-	return;
-
-    CheckCellData(sheet, row, col);
-    cell = sheet->data[row][col];
+    sheet->geometry_batch--;
 
-    if (cell->tooltip_markup)
+    if (sheet->geometry_batch == 0)
     {
-	g_free(cell->tooltip_markup);
-	cell->tooltip_markup = NULL;
+	if (sheet->geometry_dirty & GTK_SHEET_GEOMETRY_ROWS)
+	    _gtk_sheet_recalc_top_ypixels(sheet);
+	if (sheet->geometry_dirty & GTK_SHEET_GEOMETRY_COLUMNS)
+	    _gtk_sheet_recalc_left_xpixels(sheet);
+
+	_gtk_sheet_recalc_view_range(sheet);
     }
 
-    cell->tooltip_markup = g_strdup(markup);
+    gtk_sheet_thaw(sheet);
 }
 
 /**
- * gtk_sheet_cell_get_tooltip_text: 
- * @sheet:  a #GtkSheet. 
- * @row: row index 
- * @col: column index 
- * 
- * Gets the contents of the tooltip for the column 
- *  
- * Returns:	the tooltip text, or NULL. You should free the 
- *          returned string with g_free() when done.
+ * gtk_sheet_set_row_titles_width:
+ * @sheet: a #GtkSheet
+ * @width: row titles width.
+ *
+ * Resize row titles area.
  */
-gchar *gtk_sheet_cell_get_tooltip_text(GtkSheet *sheet,
-    const gint row, const gint col)
+void
+gtk_sheet_set_row_titles_width(GtkSheet *sheet, guint width)
 {
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
-
-    if (col < 0 || col > sheet->maxcol)
-	return (NULL);
-    if (row < 0 || row > sheet->maxrow)
-	return (NULL);
+    if (width < GTK_SHEET_COLUMN_MIN_WIDTH)
+	return;
 
-    if (row > sheet->maxallocrow || col > sheet->maxalloccol)
-	return (NULL);
+    sheet->row_title_area.width = width;
 
-    if (!sheet->data[row])
-	return (NULL);
-    if (!sheet->data[row][col])
-	return (NULL);
+    _gtk_sheet_recalc_top_ypixels(sheet);
+    _gtk_sheet_recalc_left_xpixels(sheet);
+    _gtk_sheet_recalc_view_range(sheet);
 
-    return (g_strdup(sheet->data[row][col]->tooltip_text));
+    _gtk_sheet_scrollbar_adjust(sheet);
+    _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
 }
 
+
 /**
- * gtk_sheet_cell_set_tooltip_text: 
- * @sheet:  a #GtkSheet.
- * @row: row index 
- * @col: column index 
- * @text:  the contents of the tooltip for widget 
- *  
- * Sets text as the contents of the tooltip. 
+ * gtk_sheet_show_row_titles:
+ * @sheet: a #GtkSheet
+ *
+ * Show row titles .
  */
-void gtk_sheet_cell_set_tooltip_text(GtkSheet *sheet,
-    const gint row, const gint col,
-    const gchar *text)
+void
+gtk_sheet_show_row_titles(GtkSheet *sheet)
 {
-    GtkSheetCell *cell;
+    gint row;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    if (sheet->row_titles_visible)
+	return;
 
-    if (col < 0 || col > sheet->maxcol)
+    sheet->row_titles_visible = TRUE;
+    _gtk_sheet_recalc_top_ypixels(sheet);
+    _gtk_sheet_recalc_left_xpixels(sheet);
+
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
 	return;
-    if (row < 0 || row > sheet->maxrow)
+    if (GTK_SHEET_IS_FROZEN(sheet))
 	return;
 
-    CheckCellData(sheet, row, col);
-    cell = sheet->data[row][col];
+    gdk_window_show(sheet->row_title_window);
 
-    if (cell->tooltip_text)
+    gdk_window_move_resize(sheet->row_title_window,
+	sheet->row_title_area.x,
+	sheet->row_title_area.y,
+	sheet->row_title_area.width,
+	sheet->row_title_area.height);
+
+    for (row = MIN_VIEW_ROW(sheet); row <= MAX_VIEW_ROW(sheet) && row <= sheet->maxrow; row++)
     {
-	g_free(cell->tooltip_text);
-	cell->tooltip_text = NULL;
-    }
+	GtkSheetChild *child;
+	if (row < 0 || row > sheet->maxrow)
+	    continue;
 
-    cell->tooltip_text = g_strdup(text);
+	child = _gtk_sheet_row_button(sheet, row)->child;
+	if (child)
+	    _gtk_sheet_child_show(child);
+    }
+    _gtk_sheet_scrollbar_adjust(sheet);
+    _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
 }
 
+
 /**
- * gtk_sheet_cell_get_editable: 
- * @sheet:  a #GtkSheet. 
- * @row: row index 
- * @col: column index 
- * 
- * Check editable status of sheet, row, column and cell to decide
- * if a sheet cell is editable 
- *  
- * Returns:	TRUE if editable, FALSE if blocked by any level.
- *  NOTE: this routine also checks if the sheet row/column/cell 
- *  can receive focus. A cell may be editable, but not focusable 
- *  still rendering it unable to be changed by the user.
+ * gtk_sheet_hide_row_titles:
+ * @sheet: a #GtkSheet
  *
- *  To check only the editable attribute on the cell, 
- *  use #gtk_sheet_get_attributes() to fetch cell attributes and
- *  examine them.
+ * Hide row titles .
  */
-gboolean gtk_sheet_cell_get_editable(GtkSheet *sheet,
-    const gint row, const gint col)
+void
+gtk_sheet_hide_row_titles(GtkSheet *sheet)
 {
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+    gint row;
 
-    if (col < 0 || col > sheet->maxcol)
-	return (FALSE);
-    if (row < 0 || row > sheet->maxrow)
-	return (FALSE);
+    if (!sheet->row_titles_visible)
+	return;
 
-    GtkSheetColumn *colptr = COLPTR(sheet,col);
-    GtkSheetRow *rowptr = ROWPTR(sheet,row);
-    GtkSheetCellAttr myattr;
+    sheet->row_titles_visible = FALSE;
+    _gtk_sheet_recalc_top_ypixels(sheet);
+    _gtk_sheet_recalc_left_xpixels(sheet);
 
-    /* if the sheet is locked, or the row/col are
-     * readonly, then the cell is automatically 
-     * not editable, even if its local edit flag allows it.
-     * NOTE: the cell may be still not visible if the row/col
-     * is marked as not visible.
-     */
-    if( GTK_SHEET_IS_LOCKED(sheet)
-       || GTK_SHEET_ROW_IS_READONLY(rowptr)
-       || GTK_SHEET_COLUMN_IS_READONLY(colptr)
-       || !GTK_SHEET_ROW_CAN_FOCUS(rowptr)
-       || !GTK_SHEET_COLUMN_CAN_FOCUS(colptr) )
-        return FALSE;
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+    if (GTK_SHEET_IS_FROZEN(sheet))
+	return;
 
-    gtk_sheet_get_attributes(sheet,row,col,&myattr);
-    if( !myattr.is_editable || !myattr.can_focus )
-        return FALSE;
+    if (sheet->row_title_window)
+	gdk_window_hide(sheet->row_title_window);
 
-    return TRUE;
+    if (gtk_widget_get_visible(sheet->button))
+	gtk_widget_hide(sheet->button);
+
+    for (row = MIN_VIEW_ROW(sheet); row <= MAX_VIEW_ROW(sheet) && row <= sheet->maxrow; row++)
+    {
+	GtkSheetChild *child;
+	if (row < 0 || row > sheet->maxrow)
+	    continue;
+
+	child = _gtk_sheet_row_button(sheet, row)->child;
+	if (child)
+	    _gtk_sheet_child_hide(child);
+    }
+    _gtk_sheet_scrollbar_adjust(sheet);
+    _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
 }
 
 /**
- * gtk_sheet_cell_set_editable: 
- * @sheet:  a #GtkSheet.
- * @row: row index 
- * @col: column index 
- * @is_editable:  value for the editable status of the cell 
- *  
- * Sets cell editable status in cell attributes.
+ * gtk_sheet_row_titles_visible:
+ * @sheet: a #GtkSheet
+ *
+ * Get the visibility of row column titles .
+ *
+ * Returns: TRUE or FALSE
  */
-void gtk_sheet_cell_set_editable(GtkSheet *sheet,
-    const gint row, const gint col,
-    const gboolean is_editable)
+gboolean
+gtk_sheet_row_titles_visible(GtkSheet *sheet)
 {
-    GtkSheetCellAttr myattr;
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+
+    return (sheet->row_titles_visible);
+}
+
+
+/**
+ * gtk_sheet_set_row_title:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ * @title: row title
+ *
+ * Set row title.
+ */
+void
+gtk_sheet_set_row_title(GtkSheet *sheet,
+    gint row,
+    const gchar *title)
+{
+    GtkSheetRow *rowp;
 
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (col < 0 || col > sheet->maxcol)
-	return;
     if (row < 0 || row > sheet->maxrow)
 	return;
 
-    gtk_sheet_get_attributes(sheet,row,col,&myattr);
-    myattr.is_editable = is_editable;
-    gtk_sheet_set_cell_attributes(sheet,row,col,myattr);
-    return;
+    rowp = _gtk_sheet_row_get(sheet, row);
+    if (rowp->name)
+	g_free(rowp->name);
+
+    rowp->name = g_strdup(title);
 }
 
 /**
- * gtk_sheet_cell_get_sensitive 
- * @sheet:  a #GtkSheet. 
- * @row: row index 
- * @col: column index 
- * 
- * Check sensitivity status of sheet, row, column and cell to decide
- * if a sheet cell can receive focus.
- *  
- * Returns:	TRUE if cell is not sensitive, FALSE if it is marked
- * sensitive at any level.
+ * gtk_sheet_get_row_title:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ *
+ * Get row title.
+ *
+ * Returns: a pointer to the row title or NULL. 
+ * Do not modify or free it. 
  */
-gboolean gtk_sheet_cell_get_sensitive(GtkSheet *sheet,
-    const gint row, const gint col)
+const gchar *
+gtk_sheet_get_row_title(GtkSheet *sheet,
+    gint row)
 {
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
-
-    if (col < 0 || col > sheet->maxcol)
-	return (FALSE);
-    if (row < 0 || row > sheet->maxrow)
-	return (FALSE);
-
-    GtkSheetColumn *colptr = COLPTR(sheet,col);
-    GtkSheetRow *rowptr = ROWPTR(sheet,row);
-    GtkSheetCellAttr myattr;
+    GtkSheetRow *rowp;
 
-    /* if the widget/row/col are insensitive, then the 
-     * cell is automatically not sensitive, even if
-     * its local flag allows it.
-     */
-    if(!gtk_widget_get_sensitive(GTK_WIDGET(sheet)) 
-       || !GTK_SHEET_ROW_IS_SENSITIVE(rowptr)
-       || !GTK_SHEET_COLUMN_IS_SENSITIVE(colptr) )
-        return FALSE;
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
 
-    gtk_sheet_get_attributes(sheet,row,col,&myattr);
-    if( !myattr.is_sensitive )
-        return FALSE;
+    if (row < 0 || row > sheet->maxrow)
+	return (NULL);
 
-    return TRUE;
+    rowp = _gtk_sheet_row_peek(sheet, row);
+    return (rowp ? rowp->name : NULL);
 }
 
 /**
- * gtk_sheet_cell_set_sensitive: 
- * @sheet:  a #GtkSheet.
- * @row: row index 
- * @col: column index 
- * @is_sensitive:  value for the sensitive status of the cell 
- *  
- * Sets cell sensitive status
+ * gtk_sheet_row_button_add_label:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ * @label: text label
+ *
+ * Set button label.It is used to set a row title.
  */
-void gtk_sheet_cell_set_sensitive(GtkSheet *sheet,
-    const gint row, const gint col,
-    const gboolean is_sensitive)
+void
+gtk_sheet_row_button_add_label(GtkSheet *sheet, gint row, const gchar *label)
 {
-    GtkSheetCellAttr myattr;
+    GtkSheetButton *button;
+    GtkRequisition req;
+    gboolean aux_c, aux_r;
 
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (col < 0 || col > sheet->maxcol)
-	return;
     if (row < 0 || row > sheet->maxrow)
 	return;
 
-    gtk_sheet_get_attributes(sheet,row,col,&myattr);
-    myattr.is_sensitive = is_sensitive;
-    gtk_sheet_set_cell_attributes(sheet,row,col,myattr);
-    return;
-}
+    button = &_gtk_sheet_row_get(sheet, row)->button;
+    if (button->label)
+	g_free(button->label);
+    button->label = g_strdup(label);
+
+    aux_c = gtk_sheet_autoresize_columns(sheet);
+    aux_r = gtk_sheet_autoresize_rows(sheet);
+    gtk_sheet_set_autoresize(sheet, FALSE);
+    gtk_sheet_set_autoresize_rows(sheet, TRUE);
+    _gtk_sheet_button_size_request(sheet, button, &req);
+    gtk_sheet_set_autoresize_columns(sheet, aux_c);
+    gtk_sheet_set_autoresize_rows(sheet, aux_r);
+
+    if (req.height > ROW_HEIGHT(sheet, row))
+	gtk_sheet_set_row_height(sheet, row, req.height);
+
+    if (req.width > sheet->row_title_area.width)
+    {
+	gtk_sheet_set_row_titles_width(sheet, req.width);
+    }
 
+    if (!GTK_SHEET_IS_FROZEN(sheet))
+    {
+	_gtk_sheet_draw_button(sheet, row, -1);
+    }
+    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[CHANGED], 0, row, -1);
+}
 
 /**
- * gtk_sheet_cell_get_can_focus: 
- * @sheet:  a #GtkSheet. 
- * @row: row index 
- * @col: column index 
- * 
- * Check ability of cell to grab focus. Check includes 
- * checking for blocks at row/column/sheet level.
- *  
- * Returns:	TRUE if the cell can focus, FALSE if blocked by any level
+ * gtk_sheet_row_button_get_label:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ *
+ * Get a row button label.
+ *
+ * Returns: In case of succes , a pointer to label
+ * text.Otherwise NULL
  */
-gboolean gtk_sheet_cell_get_can_focus(GtkSheet *sheet,
-    const gint row, const gint col)
+const gchar *
+gtk_sheet_row_button_get_label(GtkSheet *sheet, gint row)
 {
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
 
-    if (col < 0 || col > sheet->maxcol)
-	return (FALSE);
     if (row < 0 || row > sheet->maxrow)
-	return (FALSE);
-
-    GtkSheetColumn *colptr = COLPTR(sheet,col);
-    GtkSheetRow *rowptr = ROWPTR(sheet,row);
-    GtkSheetCellAttr myattr;
-
-    /* if the sheet row/col are invisible, insensitive or not
-     * allowing focus, then the cell is automatically 
-     * not focusable, even if its local edit flag allows it.
-     */
-    if(!GTK_SHEET_ROW_CAN_GRAB_FOCUS(rowptr)
-       || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(colptr) )
-        return FALSE;
-
-    gtk_sheet_get_attributes(sheet,row,col,&myattr);
-    if( !myattr.can_focus )
-        return FALSE;
+	return (NULL);
 
-    return TRUE;
+    return (_gtk_sheet_row_button(sheet, row)->label);
 }
 
 /**
- * gtk_sheet_cell_set_can_focus: 
- * @sheet:  a #GtkSheet.
- * @row: row index 
- * @col: column index 
- * @can_focus:  value for the editable status of the cell 
- *  
- * Sets cell can_focus flag
+ * gtk_sheet_row_label_set_visibility:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ * @visible: TRUE or FALSE
+ *
+ * Set row label visibility.
  */
-void gtk_sheet_cell_set_can_focus(GtkSheet *sheet,
-    const gint row, const gint col,
-    const gboolean can_focus)
+void
+gtk_sheet_row_label_set_visibility(GtkSheet *sheet, gint row, gboolean visible)
 {
-    GtkSheetCellAttr myattr;
-
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (col < 0 || col > sheet->maxcol)
-	return;
     if (row < 0 || row > sheet->maxrow)
 	return;
 
-    gtk_sheet_get_attributes(sheet,row,col,&myattr);
-    myattr.can_focus = can_focus;
-    gtk_sheet_set_cell_attributes(sheet,row,col,myattr);
-    return;
+    if (visible == _gtk_sheet_row_button(sheet, row)->label_visible)
+	return;
+
+    _gtk_sheet_row_get(sheet, row)->button.label_visible = visible;
+
+    if (!GTK_SHEET_IS_FROZEN(sheet))
+    {
+	_gtk_sheet_draw_button(sheet, row, -1);
+	g_signal_emit(GTK_OBJECT(sheet), sheet_signals[CHANGED], 0, row, -1);
+    }
 }
 
 /**
- * gtk_sheet_cell_get_visible: 
- * @sheet:  a #GtkSheet. 
- * @row: row index 
- * @col: column index 
- * 
- * Check visiblity of cell. 
- *  
- * Returns:	TRUE if the cell is visible, FALSE otherwise.
+ * gtk_sheet_rows_labels_set_visibility:
+ * @sheet: a #GtkSheet
+ * @visible: TRUE or FALSE
+ *
+ * Set all rows label visibility. The sheet itself
+ * has no such property, this is a convenience function to set
+ * the property for all existing rows.
  */
-gboolean gtk_sheet_cell_get_visible(GtkSheet *sheet,
-    const gint row, const gint col)
+void
+gtk_sheet_rows_labels_set_visibility(GtkSheet *sheet, gboolean visible)
 {
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
-
-    if (col < 0 || col > sheet->maxcol)
-	return (FALSE);
-    if (row < 0 || row > sheet->maxrow)
-	return (FALSE);
-
-    GtkSheetColumn *colptr = COLPTR(sheet,col);
-    GtkSheetRow *rowptr = ROWPTR(sheet,row);
-    GtkSheetCellAttr myattr;
-
-    /* if the sheet row/col are invisible, 
-     * then so is the cell, even if its local flag allows it.
-     */
-    if(!GTK_SHEET_ROW_IS_VISIBLE(rowptr)
-       || !GTK_SHEET_COLUMN_IS_VISIBLE(colptr) )
-        return FALSE;
+    gint i;
 
-    gtk_sheet_get_attributes(sheet,row,col,&myattr);
-    if( !myattr.is_visible )
-        return FALSE;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    return TRUE;
+    for (i = 0; i <= sheet->maxrow; i++) gtk_sheet_row_label_set_visibility(sheet, i, visible);
 }
 
+
 /**
- * gtk_sheet_cell_set_visible: 
- * @sheet:  a #GtkSheet.
- * @row: row index 
- * @col: column index 
- * @is_visible:  value for the visibility status of the cell 
- *  
- * Sets cell is_visible flag
+ * gtk_sheet_row_button_justify:
+ * @sheet: a #GtkSheet.
+ * @row: row number
+ * @justification: a #GtkJustification :GTK_JUSTIFY_LEFT, RIGHT, 
+ *  			 CENTER
+ *
+ * Set the justification(alignment) of the row buttons.
  */
-void gtk_sheet_cell_set_visible(GtkSheet *sheet,
-    const gint row, const gint col,
-    const gboolean is_visible)
+void
+gtk_sheet_row_button_justify(GtkSheet *sheet, gint row,
+    GtkJustification justification)
 {
-    GtkSheetCellAttr myattr;
+    GtkSheetButton *button;
 
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (col < 0 || col > sheet->maxcol)
-	return;
     if (row < 0 || row > sheet->maxrow)
 	return;
 
-    gtk_sheet_get_attributes(sheet,row,col,&myattr);
-    myattr.is_visible = is_visible;
-    gtk_sheet_set_cell_attributes(sheet,row,col,myattr);
-    return;
+    button = &_gtk_sheet_row_get(sheet, row)->button;
+    button->justification = justification;
+
+    if (!GTK_SHEET_IS_FROZEN(sheet))
+    {
+	_gtk_sheet_draw_button(sheet, row, -1);
+    }
 }
 
 /**
- * gtk_sheet_select_row:
+ * gtk_sheet_moveto:
  * @sheet: a #GtkSheet.
  * @row: row number
+ * @column: column number
+ * @row_align: row alignment
+ * @col_align: column alignment
  *
- * Select the row. The range is then highlighted, and the bounds are stored in sheet->range.
+ * Scroll the viewing area of the sheet to the given column and row;
+ *  
+ * row_align and col_align are between 0-1 representing the location 
+ * the row should appear on the screnn, 0 being top or left, 
+ * 1 being bottom or right.
+ * 
+ * passing row_align/col_align of -1 will suppress movement in
+ * that direction.
+ *  
+ * if row or column is negative then there is no change
  */
+
 void
-gtk_sheet_select_row(GtkSheet *sheet, gint row)
+gtk_sheet_moveto(GtkSheet *sheet,
+    gint row,
+    gint col,
+    gint row_align,
+    gint col_align)
 {
+    gint x, y;
+    guint width, height;
+
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_return_if_fail(sheet->hadjustment != NULL);
+    g_return_if_fail(sheet->vadjustment != NULL);
+
+#if GTK_SHEET_DEBUG_MOVE > 0
+    g_debug("gtk_sheet_moveto: row %d col %d row_align %d col_align %d",
+	row, col, row_align, col_align);
+#endif
 
     if (row < 0 || row > sheet->maxrow)
 	return;
+    if (col < 0 || col > sheet->maxcol)
+	return;
 
-    if (sheet->state != GTK_SHEET_NORMAL)
+    height = sheet->sheet_window_height;
+    width = sheet->sheet_window_width;
+
+    /* adjust vertical scrollbar */
+
+    if (row >= 0 && row_align >= 0)
     {
-	gtk_sheet_real_unselect_range(sheet, NULL);
+	if (row_align == 0)  /* align top cell border */
+	{
+	    y = _gtk_sheet_row_top_ypixel(sheet, row) - sheet->voffset;
+
+	    if (sheet->column_titles_visible)
+		y -= sheet->column_title_area.height; /* to bottom edge of title area*/
+	}
+	else  /* align bottom cell border */
+	{
+	    y = _gtk_sheet_row_top_ypixel(sheet, row) - sheet->voffset
+		+ ROW_HEIGHT(sheet, row);
+
+	    y -= height;  /* to bottom edge of window */
+	}
+
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
+	g_debug("gtk_sheet_moveto: rowTpx %d voffs %d height %d rheight %d colTw %s y %d", 
+	    _gtk_sheet_row_top_ypixel(sheet, row), sheet->voffset, 
+	    height, ROW_HEIGHT(sheet, row), 
+	    sheet->column_titles_visible ? "Yes" : "No",
+	    y);
+#endif
+
+	if (y < 0)
+	    gtk_adjustment_set_value(sheet->vadjustment, 0.0);
+	else
+	    gtk_adjustment_set_value(sheet->vadjustment, y);
+
+	sheet->old_vadjustment = -1.;
+
+	if (sheet->vadjustment)
+	{
+	    g_signal_emit_by_name(GTK_OBJECT(sheet->vadjustment), "value_changed");
+	}
     }
-    else
+
+    /* adjust horizontal scrollbar */
+    if (col >= 0 && col_align >= 0)  /* left or right align */
     {
-	gboolean veto = TRUE;
-	veto = gtk_sheet_deactivate_cell(sheet);
-	if (!veto)
-	    return;
-    }
+	if (col_align == 0)  /* align left cell border */
+	{
+	    x = _gtk_sheet_column_left_xpixel(sheet, col) - sheet->hoffset;
 
-    sheet->state = GTK_SHEET_ROW_SELECTED;
+	    if (sheet->row_titles_visible)
+		x -= sheet->row_title_area.width; /* to right edge of title area*/
+	}
+	else  /* align right cell border */
+	{
+	    x = _gtk_sheet_column_left_xpixel(sheet, col) - sheet->hoffset
+		+ COLPTR(sheet, col)->width;
 
-    sheet->range.row0 = row;
-    sheet->range.col0 = 0;
-    sheet->range.rowi = row;
-    sheet->range.coli = sheet->maxcol;
+	    x -= width;  /* to right edge of window */
+	}
 
-    sheet->active_cell.row = row;
-    sheet->active_cell.col = 0;
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
+	g_debug("gtk_sheet_moveto: colLpx %d hoffs %d width %d cwidth %d rowTw %s x %d", 
+	    _gtk_sheet_column_left_xpixel(sheet, col), sheet->hoffset, 
+	    width, COLPTR(sheet, col)->width, 
+	    sheet->row_titles_visible ? "Yes" : "No",
+	    x);
+#endif
 
-    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[SELECT_ROW], 0, row);
-    gtk_sheet_real_select_range(sheet, NULL);
+	if (x < 0)
+	    gtk_adjustment_set_value(sheet->hadjustment, 0.0);
+	else
+	    gtk_adjustment_set_value(sheet->hadjustment, x);
+
+	sheet->old_hadjustment = -1.;
+
+	if (sheet->hadjustment)
+	{
+	    g_signal_emit_by_name(GTK_OBJECT(sheet->hadjustment), "value_changed");
+	}
+    }
 }
 
+
 /**
- * gtk_sheet_select_column:
+ * gtk_sheet_row_sensitive:
  * @sheet: a #GtkSheet.
- * @column: column number
+ * @row: row number
  *
- * Select the column. The range is then highlighted, and the bounds are stored in sheet->range.
+ * Get row button sensitivity. 
+ *  
+ * Returns: 
+ * TRUE - is sensitive,  
+ * FALSE - insensitive or not existant 
  */
-void
-gtk_sheet_select_column(GtkSheet *sheet, gint column)
+gboolean
+gtk_sheet_row_sensitive(GtkSheet *sheet, gint row)
 {
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
-
-    if (column < 0 || column > sheet->maxcol)
-	return;
-
-    if (sheet->state != GTK_SHEET_NORMAL)
-    {
-	gtk_sheet_real_unselect_range(sheet, NULL);
-    }
-    else
-    {
-	gboolean veto = TRUE;
-	veto = gtk_sheet_deactivate_cell(sheet);
-	if (!veto)
-	    return;
-    }
-
-    sheet->state = GTK_SHEET_COLUMN_SELECTED;
-
-    sheet->range.row0 = 0;
-    sheet->range.col0 = column;
-    sheet->range.rowi = sheet->maxrow;
-    sheet->range.coli = column;
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    sheet->active_cell.row = 0;
-    sheet->active_cell.col = column;
+    if (row < 0 || row > sheet->maxrow)
+	return (FALSE);
 
-    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[SELECT_COLUMN], 0, column);
-    gtk_sheet_real_select_range(sheet, NULL);
+    return (GTK_SHEET_ROW_IS_SENSITIVE(sheet, row));
 }
 
 /**
- * gtk_sheet_clip_range:
+ * gtk_sheet_row_set_sensitivity:
  * @sheet: a #GtkSheet.
- * @clip_range: #GtkSheetRange to be saved
+ * @row: row number
+ * @sensitive: TRUE or FALSE
  *
- * Save selected range to "clipboard".
+ * Set row button sensitivity. If sensitivity is TRUE can be toggled, otherwise it acts as a title .
  */
 void
-gtk_sheet_clip_range(GtkSheet *sheet, const GtkSheetRange *clip_range)
+gtk_sheet_row_set_sensitivity(GtkSheet *sheet, gint row,  gboolean sensitive)
 {
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (GTK_SHEET_IN_CLIP(sheet))
+    if (row < 0 || row > sheet->maxrow)
 	return;
 
-    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_CLIP);
-
-    if (clip_range == NULL)
-	sheet->clip_range = sheet->range;
-    else
-	sheet->clip_range = *clip_range;
-
-    sheet->interval = 0;
-    sheet->clip_timer = g_timeout_add_full(0, TIMEOUT_FLASH, gtk_sheet_flash, sheet, NULL);
+    GTK_SHEET_ROW_SET_SENSITIVE(sheet, row, sensitive);
 
-    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[CLIP_RANGE], 0, &sheet->clip_range);
+    if (gtk_widget_get_realized(GTK_WIDGET(sheet)) && !GTK_SHEET_IS_FROZEN(sheet))
+	_gtk_sheet_draw_button(sheet, row, -1);
 }
 
 /**
- * gtk_sheet_unclip_range:
+ * gtk_sheet_rows_set_sensitivity:
  * @sheet: a #GtkSheet.
+ * @sensitive: TRUE or FALSE
  *
- * Free clipboard.
+ * Set rows buttons sensitivity. If sensitivity is TRUE button
+ * can be toggled, otherwise act as titles. The sheet itself
+ * has no such property, it is a convenience function to set the
+ * property for all existing rows.
  */
 void
-gtk_sheet_unclip_range(GtkSheet *sheet)
+gtk_sheet_rows_set_sensitivity(GtkSheet *sheet, gboolean sensitive)
 {
+    gint i;
+
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (!GTK_SHEET_IN_CLIP(sheet))
-	return;
+    for (i = 0; i <= sheet->maxrow; i++) gtk_sheet_row_set_sensitivity(sheet, i, sensitive);
+}
 
-    GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_CLIP);
-    g_source_remove(sheet->clip_timer);
-    _gtk_sheet_range_draw(sheet, &sheet->clip_range, TRUE);
+/**
+ * gtk_sheet_rows_set_resizable:
+ * @sheet: a #GtkSheet.
+ * @resizable: TRUE or FALSE
+ *
+ * Set rows resizable status.
+ */
+void
+gtk_sheet_rows_set_resizable(GtkSheet *sheet, gboolean resizable)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (gtk_sheet_range_isvisible(sheet, sheet->range))
-	_gtk_sheet_range_draw(sheet, &sheet->range, TRUE);
+    sheet->rows_resizable = resizable;
 }
 
 /**
- * gtk_sheet_in_clip:
+ * gtk_sheet_rows_resizable:
  * @sheet: a #GtkSheet.
  *
- * Get the clip status of #GtkSheet.
+ * Get rows resizable status.
  *
  * Returns: TRUE or FALSE
  */
 gboolean
-gtk_sheet_in_clip(GtkSheet *sheet)
+gtk_sheet_rows_resizable(GtkSheet *sheet)
 {
     g_return_val_if_fail(sheet != NULL, FALSE);
     g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    return (GTK_SHEET_IN_CLIP(sheet));
+    return (sheet->rows_resizable);
 }
 
 
-static gint
-gtk_sheet_flash(gpointer data)
+/**
+ * gtk_sheet_row_visible:
+ * @sheet: a #GtkSheet.
+ * @row: row number
+ *
+ * Get row visibility. 
+ *  
+ * Returns: 
+ * TRUE - is visible 
+ * FALSE - invisible or not existant 
+ */
+gboolean
+gtk_sheet_row_visible(GtkSheet *sheet, gint row)
 {
-    GtkSheet *sheet;
-    gint x, y, width, height;
-    GdkRectangle clip_area;
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    sheet = GTK_SHEET(data);
+    if (row < 0 || row > sheet->maxrow)
+	return (FALSE);
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return (TRUE);
-    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
-	return (TRUE);
-    if (!gtk_sheet_range_isvisible(sheet, sheet->clip_range))
-	return (TRUE);
-    if (GTK_SHEET_IN_XDRAG(sheet))
-	return (TRUE);
-    if (GTK_SHEET_IN_YDRAG(sheet))
-	return (TRUE);
+    return (GTK_SHEET_ROW_IS_VISIBLE(sheet, row));
+}
 
-    GDK_THREADS_ENTER();
+/**
+ * gtk_sheet_row_set_visibility:
+ * @sheet: a #GtkSheet.
+ * @row: row number
+ * @visible: TRUE or FALSE
+ *
+ * Set row visibility. The default value is TRUE. If FALSE, the row is hidden.
+ */
+void
+gtk_sheet_row_set_visibility(GtkSheet *sheet, gint row, gboolean visible)
+{
+    gint act_row, act_col;
 
-    x = _gtk_sheet_column_left_xpixel(sheet, sheet->clip_range.col0) + 1;
-    y = _gtk_sheet_row_top_ypixel(sheet, sheet->clip_range.row0) + 1;
-    width = _gtk_sheet_column_left_xpixel(sheet, sheet->clip_range.coli) - x +
-	COLPTR(sheet, sheet->clip_range.coli)->width - 1;
-    height = _gtk_sheet_row_top_ypixel(sheet, sheet->clip_range.rowi) - y +
-	sheet->row[sheet->clip_range.rowi].height - 1;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    clip_area.x = _gtk_sheet_column_left_xpixel(sheet, MIN_VIEW_COLUMN(sheet));
-    clip_area.y = _gtk_sheet_row_top_ypixel(sheet, MIN_VIEW_ROW(sheet));
-    clip_area.width = sheet->sheet_window_width;
-    clip_area.height = sheet->sheet_window_height;
+    if (row < 0 || row > sheet->maxrow)
+	return;
 
-    if (x < 0)
-    {
-	width = width + x + 1;
-	x = -1;
-    }
-    if (width > clip_area.width)
-	width = clip_area.width + 10;
+    if (GTK_SHEET_ROW_IS_VISIBLE(sheet, row) == visible)
+	return;
 
-    if (y < 0)
+    act_row = sheet->active_cell.row;
+    act_col = sheet->active_cell.col;
+
+    if (act_row == row)   /* hide active column -> disable active cell */
     {
-	height = height + y + 1;
-	y = -1;
-    }
-    if (height > clip_area.height)
-	height = clip_area.height + 10;
+	_gtk_sheet_hide_active_cell(sheet);
 
-    gdk_draw_pixmap(sheet->sheet_window,
-	gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-	sheet->pixmap,
-	x, y,
-	x, y,
-	1, height);
+	sheet->active_cell.row = -1;
+	sheet->active_cell.col = -1;
+    }
 
-    gdk_draw_pixmap(sheet->sheet_window,
-	gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-	sheet->pixmap,
-	x, y,
-	x, y,
-	width, 1);
+    act_row = sheet->active_cell.row;
+    act_col = sheet->active_cell.col;
 
-    gdk_draw_pixmap(sheet->sheet_window,
-	gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-	sheet->pixmap,
-	x, y + height,
-	x, y + height,
-	width, 1);
+    GTK_SHEET_ROW_SET_VISIBLE(sheet, row, visible);
 
-    gdk_draw_pixmap(sheet->sheet_window,
-	gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-	sheet->pixmap,
-	x + width, y,
-	x + width, y,
-	1, height);
+    {
+	GtkSheetRange range;
 
-    sheet->interval = sheet->interval + 1;
-    if (sheet->interval == TIME_INTERVAL)
-	sheet->interval = 0;
+	range.row0 = range.rowi = row;
+	range.col0 = 0;
+	range.coli = sheet->maxcol;
 
-    gdk_gc_set_dashes(sheet->xor_gc, sheet->interval, (gint8 *)"\4\4", 2);
-    gtk_sheet_draw_flashing_range(sheet, sheet->clip_range);
-    gdk_gc_set_dashes(sheet->xor_gc, 0, (gint8 *)"\4\4", 2);
+	_gtk_sheet_recount_extents(sheet, &range);
+    }
 
-    GDK_THREADS_LEAVE();
+    _gtk_sheet_range_fixup(sheet, &sheet->range);
+    _gtk_sheet_row_geometry_changed(sheet, row);
 
-    return (TRUE);
+    _gtk_sheet_scrollbar_adjust(sheet);
+    _gtk_sheet_redraw_internal(sheet, FALSE, TRUE);
 }
 
-static void
-gtk_sheet_draw_flashing_range(GtkSheet *sheet, GtkSheetRange range)
+
+/**
+ * gtk_sheet_get_tooltip_markup: 
+ * @sheet:  a #GtkSheet. 
+ *  
+ * Gets the contents of the tooltip (markup) for sheet 
+ * 
+ * Returns:	the tooltip text, or NULL. You should free the 
+ *          returned string with g_free() when done.
+ */
+gchar *gtk_sheet_get_tooltip_markup(GtkSheet *sheet)
 {
-    GdkRectangle clip_area;
-    gint x, y, width, height;
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
 
-    if (!gtk_sheet_range_isvisible(sheet, sheet->clip_range))
-	return;
+    return (gtk_widget_get_tooltip_markup(GTK_WIDGET(sheet)));
+}
 
-    clip_area.x = _gtk_sheet_column_left_xpixel(sheet, MIN_VIEW_COLUMN(sheet));
-    clip_area.y = _gtk_sheet_row_top_ypixel(sheet, MIN_VIEW_ROW(sheet));
-    clip_area.width = sheet->sheet_window_width;
-    clip_area.height = sheet->sheet_window_height;
+/**
+ * gtk_sheet_set_tooltip_markup: 
+ * @sheet:  a #GtkSheet.
+ * @markup:  	the contents of the tooltip for widget, or NULL. 
+ *  
+ * Sets markup as the contents of the tooltip, which is marked 
+ * up with the Pango text markup language. 
+ */
+void gtk_sheet_set_tooltip_markup(GtkSheet *sheet,
+    const gchar *markup)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    gdk_gc_set_clip_rectangle(sheet->xor_gc, &clip_area);
+    gtk_widget_set_tooltip_markup(GTK_WIDGET(sheet), markup);
+}
 
-    x = _gtk_sheet_column_left_xpixel(sheet, sheet->clip_range.col0) + 1;
-    y = _gtk_sheet_row_top_ypixel(sheet, sheet->clip_range.row0) + 1;
-    width = _gtk_sheet_column_left_xpixel(sheet, sheet->clip_range.coli) - x +
-	COLPTR(sheet, sheet->clip_range.coli)->width - 1;
-    height = _gtk_sheet_row_top_ypixel(sheet, sheet->clip_range.rowi) - y +
-	sheet->row[sheet->clip_range.rowi].height - 1;
+/**
+ * gtk_sheet_get_tooltip_text:
+ * @sheet:  a #GtkSheet. 
+ *  
+ * Gets the contents of the tooltip for the #GtkSheet
+ * 
+ * Returns:	the tooltip text, or NULL. You should free the 
+ *          returned string with g_free() when done.
+ */
+gchar *gtk_sheet_get_tooltip_text(GtkSheet *sheet)
+{
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
 
-    if (x < 0)
-    {
-	width = width + x + 1;
-	x = -1;
-    }
-    if (width > clip_area.width)
-	width = clip_area.width + 10;
+    return (gtk_widget_get_tooltip_text(GTK_WIDGET(sheet)));
+}
 
-    if (y < 0)
-    {
-	height = height + y + 1;
-	y = -1;
-    }
-    if (height > clip_area.height)
-	height = clip_area.height + 10;
-
-    gdk_gc_set_line_attributes(sheet->xor_gc, 1, 1, 0, 0);
-
-    gdk_draw_rectangle(sheet->sheet_window, sheet->xor_gc, FALSE,
-	x, y,
-	width, height);
-
-    gdk_gc_set_line_attributes(sheet->xor_gc, 1, 0, 0, 0);
-
-    gdk_gc_set_clip_rectangle(sheet->xor_gc, NULL);
-}
-
-static gint
-gtk_sheet_range_isvisible(GtkSheet *sheet, GtkSheetRange range)
+/**
+ * gtk_sheet_set_tooltip_text: 
+ * @sheet:  a #GtkSheet.
+ * @text:  the contents of the tooltip for widget 
+ *  
+ * Sets text as the contents of the tooltip. 
+ */
+void gtk_sheet_set_tooltip_text(GtkSheet *sheet,
+    const gchar *text)
 {
-    g_return_val_if_fail(sheet != NULL, FALSE);
-
-    if (range.row0 > MAX_VIEW_ROW(sheet))
-	return (FALSE);
-    if (range.rowi < MIN_VIEW_ROW(sheet))
-	return (FALSE);
-
-    if (range.col0 > MAX_VIEW_COLUMN(sheet))
-	return (FALSE);
-    if (range.coli < MIN_VIEW_COLUMN(sheet))
-	return (FALSE);
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    return (TRUE);
+    gtk_widget_set_tooltip_text(GTK_WIDGET(sheet), text);
 }
 
-static gint
-gtk_sheet_cell_isvisible(GtkSheet *sheet,
-    gint row, gint column)
+/**
+ * gtk_sheet_row_get_tooltip_markup: 
+ * @sheet:  a #GtkSheet. 
+ * @row: row index 
+ *  
+ * Gets the contents of the tooltip (markup) for the column 
+ *  
+ * Returns:	the tooltip text, or NULL. You should free the 
+ *          returned string with g_free() when done.
+ */
+gchar *gtk_sheet_row_get_tooltip_markup(GtkSheet *sheet,
+    const gint row)
 {
-    GtkSheetRange range;
+    GtkSheetRow *rowp;
 
-    range.row0 = row;
-    range.col0 = column;
-    range.rowi = row;
-    range.coli = column;
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
 
-    return (gtk_sheet_range_isvisible(sheet, range));
+    if (row < 0 || row > sheet->maxrow)
+	return (NULL);
+
+    rowp = _gtk_sheet_row_peek(sheet, row);
+    return (rowp ? g_strdup(rowp->tooltip_markup) : NULL);
 }
 
 /**
- * gtk_sheet_get_visible_range:
- * @sheet: a #GtkSheet.
- * @range: a selected #GtkSheetRange
- * struct _GtkSheetRange { gint row0,col0; //  upper-left cell
- * 			  gint rowi,coli;  // lower-right cell  };
- *
- * Get sheet's ranges in a #GkSheetRange structure.
+ * gtk_sheet_row_set_tooltip_markup: 
+ * @sheet:  a #GtkSheet.
+ * @row: row index 
+ * @markup:  	the contents of the tooltip for widget, or NULL. 
+ *  
+ * Sets markup as the contents of the tooltip, which is marked 
+ * up with the Pango text markup language. 
  */
-void
-gtk_sheet_get_visible_range(GtkSheet *sheet, GtkSheetRange *range)
+void gtk_sheet_row_set_tooltip_markup(GtkSheet *sheet,
+    const gint row,
+    const gchar *markup)
 {
+    GtkSheetRow *rowp;
+
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
-    g_return_if_fail(range != NULL);
-
-    range->row0 = MIN_VIEW_ROW(sheet);
-    range->col0 = MIN_VIEW_COLUMN(sheet);
-    range->rowi = MAX_VIEW_ROW(sheet);
-    range->coli = MAX_VIEW_COLUMN(sheet);
-}
 
-/**
- * gtk_sheet_get_vadjustment:
- * @sheet: a #GtkSheet.
- *
- * Get vertical scroll adjustments.
- *
- * Returns: (transfer none) a #GtkAdjustment
- */
-GtkAdjustment *
-gtk_sheet_get_vadjustment(GtkSheet *sheet)
-{
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
+    if (row < 0 || row > sheet->maxrow)
+	return;
 
-    return (sheet->vadjustment);
+    rowp = _gtk_sheet_row_get(sheet, row);
+    if (rowp->tooltip_markup)
+	g_free(rowp->tooltip_markup);
+    rowp->tooltip_markup = g_strdup(markup);
 }
 
 /**
- * gtk_sheet_get_hadjustment:
- * @sheet: a #GtkSheet.
- *
- * Get horizontal scroll adjustments.
- *
- * Returns: (transfer none) a #GtkAdjustment
+ * gtk_sheet_row_get_tooltip_text: 
+ * @sheet:  a #GtkSheet. 
+ * @row: row index 
+ *  
+ * Gets the contents of the tooltip for the column 
+ * 
+ * Returns:	the tooltip text, or NULL. You should free the 
+ *          returned string with g_free() when done.
  */
-GtkAdjustment *
-gtk_sheet_get_hadjustment(GtkSheet *sheet)
+gchar *gtk_sheet_row_get_tooltip_text(GtkSheet *sheet,
+    const gint row)
 {
+    GtkSheetRow *rowp;
+
     g_return_val_if_fail(sheet != NULL, NULL);
     g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
 
-    return (sheet->hadjustment);
+    if (row < 0 || row > sheet->maxrow)
+	return (NULL);
+
+    rowp = _gtk_sheet_row_peek(sheet, row);
+    return (rowp ? g_strdup(rowp->tooltip_text) : NULL);
 }
 
 /**
- * gtk_sheet_set_vadjustment:
- * @sheet: a #GtkSheet.
- * @adjustment: a #GtkAdjustment
- *
- * Change vertical scroll adjustments.
+ * gtk_sheet_row_set_tooltip_text: 
+ * @sheet:  a #GtkSheet.
+ * @row: row index 
+ * @text:  the contents of the tooltip for widget 
+ *  
+ * Sets text as the contents of the tooltip. 
  */
-void
-gtk_sheet_set_vadjustment(GtkSheet *sheet, GtkAdjustment *adjustment)
+void gtk_sheet_row_set_tooltip_text(GtkSheet *sheet,
+    const gint row,
+    const gchar *text)
 {
-    GtkAdjustment *old_adjustment;
+    GtkSheetRow *rowp;
 
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (adjustment)
-	g_return_if_fail(GTK_IS_ADJUSTMENT(adjustment));
-    if (sheet->vadjustment == adjustment)
+    if (row < 0 || row > sheet->maxrow)
 	return;
 
-    old_adjustment = sheet->vadjustment;
+    rowp = _gtk_sheet_row_get(sheet, row);
+    if (rowp->tooltip_text)
+	g_free(rowp->tooltip_text);
+    rowp->tooltip_text = g_strdup(text);
+}
 
-    if (sheet->vadjustment)
-    {
-	g_signal_handlers_disconnect_matched(
-	    GTK_OBJECT(sheet->vadjustment),
-	    G_SIGNAL_MATCH_DATA,
-	    0, 0, NULL, NULL, sheet);
-	g_object_unref(G_OBJECT(sheet->vadjustment));
-    }
+/**
+ * gtk_sheet_row_get_readonly: 
+ * @sheet:  a #GtkSheet. 
+ * @row: row index 
+ *  
+ * Gets the row readonly flag 
+ *  
+ * Returns:	the readonly flag
+ */
+gboolean gtk_sheet_row_get_readonly(GtkSheet *sheet, const gint row)
+{
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    sheet->vadjustment = adjustment;
+    if (row < 0 || row > sheet->maxrow) return (FALSE);
 
-    if (sheet->vadjustment)
-    {
-	g_object_ref(G_OBJECT(sheet->vadjustment));
-	g_object_ref_sink(G_OBJECT(sheet->vadjustment));
-	g_object_unref(G_OBJECT(sheet->vadjustment));
+    return (GTK_SHEET_ROW_IS_READONLY(sheet, row));
+}
 
-	g_signal_connect(GTK_OBJECT(sheet->vadjustment), "changed",
-	    (void *)_vadjustment_changed_handler,
-	    (gpointer)sheet);
-	g_signal_connect(GTK_OBJECT(sheet->vadjustment), "value_changed",
-	    (void *)_vadjustment_value_changed_handler,
-	    (gpointer)sheet);
-    }
+/**
+ * gtk_sheet_row_set_readonly: 
+ * @sheet:  a #GtkSheet.
+ * @row: row index 
+ * @is_readonly:  the row is_readonly flag 
+ *  
+ * Sets the row readonly flag. 
+ * A cell is editable if the sheet is not locked, the row is 
+ * not readonly and the cell (-range) was set to editable. 
+ */
+void gtk_sheet_row_set_readonly(GtkSheet *sheet, const gint row,
+                                   const gboolean is_readonly)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (!sheet->vadjustment || !old_adjustment)
-    {
-	gtk_widget_queue_resize(GTK_WIDGET(sheet));
-	return;
-    }
+    if (row < 0 || row > sheet->maxrow) return;
 
-    sheet->old_vadjustment = gtk_adjustment_get_value(sheet->vadjustment);
+    GTK_SHEET_ROW_SET_READONLY(sheet, row, is_readonly);
 }
 
 /**
- * gtk_sheet_set_hadjustment:
- * @sheet: a #GtkSheet.
- * @adjustment: a #GtkAdjustment
- *
- * Change horizontal scroll adjustments.
+ * gtk_sheet_row_get_can_focus: 
+ * @sheet:  a #GtkSheet. 
+ * @row: row index 
+ *  
+ * Gets the row can_focus flag 
+ *  
+ * Returns:	the can_focus flag
  */
-void
-gtk_sheet_set_hadjustment(GtkSheet *sheet, GtkAdjustment *adjustment)
+gboolean gtk_sheet_row_get_can_focus(GtkSheet *sheet, const gint row)
 {
-    GtkAdjustment *old_adjustment;
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+
+    if (row < 0 || row > sheet->maxrow) return (FALSE);
+
+    return (GTK_SHEET_ROW_CAN_FOCUS(sheet, row));
+}
 
+/**
+ * gtk_sheet_row_set_can_focus: 
+ * @sheet:  a #GtkSheet.
+ * @row: row index 
+ * @can_focus:  the row can_focus flag 
+ *  
+ * Sets the row can_focus flag. 
+ * Note: Does not check row visiblity, sensitivity, etc. Use the
+ * macro GTK_SHEET_ROW_CAN_GRAB_FOCUS() for dependency checking.
+ */
+void gtk_sheet_row_set_can_focus(GtkSheet *sheet, const gint row,
+                                   const gboolean can_focus)
+{
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (adjustment)
-	g_return_if_fail(GTK_IS_ADJUSTMENT(adjustment));
-    if (sheet->hadjustment == adjustment)
-	return;
+    if (row < 0 || row > sheet->maxrow) return;
 
-    old_adjustment = sheet->hadjustment;
+    GTK_SHEET_ROW_SET_CAN_FOCUS(sheet, row, can_focus);
+}
 
-    if (sheet->hadjustment)
-    {
-	g_signal_handlers_disconnect_matched(
-	    GTK_OBJECT(sheet->hadjustment),
-	    G_SIGNAL_MATCH_DATA,
-	    0, 0, NULL, NULL, sheet);
-	g_object_unref(GTK_OBJECT(sheet->hadjustment));
-    }
-
-    sheet->hadjustment = adjustment;
+/**
+ * gtk_sheet_cell_get_tooltip_markup: 
+ * @sheet:  a #GtkSheet. 
+ * @row: row index 
+ * @col: column index 
+ *  
+ * Gets the contents of the tooltip (markup) for the column 
+ * 
+ * Returns:	the tooltip text, or NULL. You should free the 
+ *          returned string with g_free() when done.
+ */
+gchar *gtk_sheet_cell_get_tooltip_markup(GtkSheet *sheet,
+    const gint row, const gint col)
+{
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
 
-    if (sheet->hadjustment)
-    {
-	g_object_ref(G_OBJECT(sheet->hadjustment));
-	g_object_ref_sink(G_OBJECT(sheet->hadjustment));
-	g_object_unref(G_OBJECT(sheet->hadjustment));
+    if (col < 0 || col > sheet->maxcol)
+	return (NULL);
+    if (row < 0 || row > sheet->maxrow)
+	return (NULL);
 
-	g_signal_connect(GTK_OBJECT(sheet->hadjustment), "changed",
-	    (void *)_hadjustment_changed_handler,
-	    (gpointer)sheet);
-	g_signal_connect(GTK_OBJECT(sheet->hadjustment), "value_changed",
-	    (void *)_hadjustment_value_changed_handler,
-	    (gpointer)sheet);
-    }
+    GtkSheetCell *cell = _gtk_sheet_cell_get(sheet, row, col);
 
-    if (!sheet->hadjustment || !old_adjustment)
-    {
-	gtk_widget_queue_resize(GTK_WIDGET(sheet));
-	return;
-    }
+    if (!cell)
+	return (NULL);
 
-    sheet->old_hadjustment = gtk_adjustment_get_value(sheet->hadjustment);
+    return (g_strdup(cell->tooltip_markup));
 }
 
 /**
- * gtk_sheet_set_scroll_adjustments:
- * @sheet: a #GtkSheet.
- * @hadjustment: a #GtkAdjustment
- * @vadjustment: a #GtkAdjustment
- *
- * Change horizontal and vertical scroll adjustments.
+ * gtk_sheet_cell_set_tooltip_markup: 
+ * @sheet:  a #GtkSheet.
+ * @row: row index 
+ * @col: column index 
+ * @markup:  	the contents of the tooltip for widget, or NULL. 
+ *  
+ * Sets markup as the contents of the tooltip, which is marked 
+ * up with the Pango text markup language. 
  */
-static void
-gtk_sheet_set_scroll_adjustments(GtkSheet *sheet,
-    GtkAdjustment *hadjustment,
-    GtkAdjustment *vadjustment)
+void gtk_sheet_cell_set_tooltip_markup(GtkSheet *sheet,
+    const gint row, const gint col,
+    const gchar *markup)
 {
-#if GTK_SHEET_DEBUG_SIGNALS > 0
-    g_debug("SIGNAL set-scroll-adjustments %p", sheet);
-#endif
+    GtkSheetCell *cell;
+    GtkSheetRange range;
 
-    if (sheet->hadjustment != hadjustment)
-	gtk_sheet_set_hadjustment(sheet, hadjustment);
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (sheet->vadjustment != vadjustment)
-	gtk_sheet_set_vadjustment(sheet, vadjustment);
+    if (col < 0 || col > sheet->maxcol)
+	return;
+    if (row < 0 || row > sheet->maxrow)
+	return;
+
+    CheckCellData(sheet, row, col);
+    cell = _gtk_sheet_cell_get(sheet, row, col);
+
+    {
+	gchar *old = cell->tooltip_markup;  /* markup may point to it */
+
+	cell->tooltip_markup = PoolStrdup(sheet, markup);
+	PoolStrfree(sheet, old);
+    }
+
+    range.row0 = range.rowi = row;
+    range.col0 = range.coli = col;
+    _gtk_sheet_tile_cache_invalidate(sheet, &range);  /* marker */
 }
 
-/*
- * gtk_sheet_finalize_handler:
- * 
- * this is the #GtkSheet object class "finalize" signal handler
+/**
+ * gtk_sheet_cell_get_tooltip_text: 
+ * @sheet:  a #GtkSheet. 
+ * @row: row index 
+ * @col: column index 
  * 
- * @param object the #GtkSheet
+ * Gets the contents of the tooltip for the column 
+ *  
+ * Returns:	the tooltip text, or NULL. You should free the 
+ *          returned string with g_free() when done.
  */
-static void
-gtk_sheet_finalize_handler(GObject *object)
+gchar *gtk_sheet_cell_get_tooltip_text(GtkSheet *sheet,
+    const gint row, const gint col)
 {
-    GtkSheet *sheet;
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
 
-    g_return_if_fail(object != NULL);
-    g_return_if_fail(GTK_IS_SHEET(object));
+    if (col < 0 || col > sheet->maxcol)
+	return (NULL);
+    if (row < 0 || row > sheet->maxrow)
+	return (NULL);
 
-    sheet = GTK_SHEET(object);
+    GtkSheetCell *cell = _gtk_sheet_cell_get(sheet, row, col);
 
-    /* get rid of all the cells */
-    gtk_sheet_range_clear(sheet, NULL);
-    gtk_sheet_range_delete(sheet, NULL);
+    if (!cell)
+	return (NULL);
 
-    gtk_sheet_delete_rows(sheet, 0, sheet->maxrow + 1);
-    gtk_sheet_delete_columns(sheet, 0, sheet->maxcol + 1);
+    return (g_strdup(cell->tooltip_text));
+}
 
-    DeleteRow(sheet, 0, sheet->maxrow + 1);
-    DeleteColumn(sheet, 0, sheet->maxcol + 1);
+/**
+ * gtk_sheet_cell_set_tooltip_text: 
+ * @sheet:  a #GtkSheet.
+ * @row: row index 
+ * @col: column index 
+ * @text:  the contents of the tooltip for widget 
+ *  
+ * Sets text as the contents of the tooltip. 
+ */
+void gtk_sheet_cell_set_tooltip_text(GtkSheet *sheet,
+    const gint row, const gint col,
+    const gchar *text)
+{
+    GtkSheetCell *cell;
+    GtkSheetRange range;
 
-    g_free(sheet->row);
-    sheet->row = NULL;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (sheet->column)  /* free remaining column array, no gobjects there */
-    {
-	g_free(sheet->column);
-	sheet->column = NULL;
-    }
+    if (col < 0 || col > sheet->maxcol)
+	return;
+    if (row < 0 || row > sheet->maxrow)
+	return;
 
-    g_free(sheet->data);
-    sheet->data = NULL;
+    CheckCellData(sheet, row, col);
+    cell = _gtk_sheet_cell_get(sheet, row, col);
 
-    if (sheet->title)
     {
-	g_free(sheet->title);
-	sheet->title = NULL;
+	gchar *old = cell->tooltip_text;  /* text may point to it */
+
+	cell->tooltip_text = PoolStrdup(sheet, text);
+	PoolStrfree(sheet, old);
     }
 
-    if (G_OBJECT_CLASS(sheet_parent_class)->finalize)
-	(*G_OBJECT_CLASS(sheet_parent_class)->finalize)(object);
+    range.row0 = range.rowi = row;
+    range.col0 = range.coli = col;
+    _gtk_sheet_tile_cache_invalidate(sheet, &range);  /* marker */
 }
 
-/*
- * gtk_sheet_destroy_handler:
- * 
- * this is the #GtkSheet object class "finalize" handler
+/**
+ * gtk_sheet_cell_get_editable: 
+ * @sheet:  a #GtkSheet. 
+ * @row: row index 
+ * @col: column index 
  * 
- * @param object
+ * Check editable status of sheet, row, column and cell to decide
+ * if a sheet cell is editable 
+ *  
+ * Returns:	TRUE if editable, FALSE if blocked by any level.
+ *  NOTE: this routine also checks if the sheet row/column/cell 
+ *  can receive focus. A cell may be editable, but not focusable 
+ *  still rendering it unable to be changed by the user.
+ *
+ *  To check only the editable attribute on the cell, 
+ *  use #gtk_sheet_get_attributes() to fetch cell attributes and
+ *  examine them.
  */
-static void
-gtk_sheet_destroy_handler(GtkObject *object)
+gboolean gtk_sheet_cell_get_editable(GtkSheet *sheet,
+    const gint row, const gint col)
 {
-    GtkSheet *sheet;
-    GList *children;
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    g_return_if_fail(object != NULL);
-    g_return_if_fail(GTK_IS_SHEET(object));
+    if (col < 0 || col > sheet->maxcol)
+	return (FALSE);
+    if (row < 0 || row > sheet->maxrow)
+	return (FALSE);
 
-    sheet = GTK_SHEET(object);
+    GtkSheetColumn *colptr = COLPTR(sheet,col);
+    GtkSheetCellAttr myattr;
 
-    /* destroy the entry */
-    if (sheet->sheet_entry && GTK_IS_WIDGET(sheet->sheet_entry))
-    {
-	gtk_widget_destroy(sheet->sheet_entry);
-	sheet->sheet_entry = NULL;
-    }
+    /* if the sheet is locked, or the row/col are
+     * readonly, then the cell is automatically 
+     * not editable, even if its local edit flag allows it.
+     * NOTE: the cell may be still not visible if the row/col
+     * is marked as not visible.
+     */
+    if( GTK_SHEET_IS_LOCKED(sheet)
+       || GTK_SHEET_ROW_IS_READONLY(sheet, row)
+       || GTK_SHEET_COLUMN_IS_READONLY(colptr)
+       || !GTK_SHEET_ROW_CAN_FOCUS(sheet, row)
+       || !GTK_SHEET_COLUMN_CAN_FOCUS(colptr) )
+        return FALSE;
 
-    /* destroy the global selection button */
-    if (sheet->button && GTK_IS_WIDGET(sheet->button))
-    {
-#if GTK_SHEET_DEBUG_REALIZE > 0
-	g_debug("gtk_sheet_destroy: destroying old entry %p", sheet->button);
-#endif
-	gtk_widget_destroy(sheet->button);
-	sheet->button = NULL;
-    }
+    gtk_sheet_get_attributes(sheet,row,col,&myattr);
+    if( !myattr.is_editable || !myattr.can_focus )
+        return FALSE;
 
-    if (sheet->timer)
-    {
-	g_source_remove(sheet->timer);
-	sheet->timer = 0;
-    }
+    return TRUE;
+}
 
-    if (sheet->clip_timer)
-    {
-	g_source_remove(sheet->clip_timer);
-	sheet->clip_timer = 0;
-    }
+/**
+ * gtk_sheet_cell_set_editable: 
+ * @sheet:  a #GtkSheet.
+ * @row: row index 
+ * @col: column index 
+ * @is_editable:  value for the editable status of the cell 
+ *  
+ * Sets cell editable status in cell attributes.
+ */
+void gtk_sheet_cell_set_editable(GtkSheet *sheet,
+    const gint row, const gint col,
+    const gboolean is_editable)
+{
+    GtkSheetCellAttr myattr;
 
-    /* unref adjustments */
-    if (sheet->hadjustment)
-    {
-	g_signal_handlers_disconnect_matched(
-	    GTK_OBJECT(sheet->hadjustment),
-	    G_SIGNAL_MATCH_DATA,
-	    0, 0, NULL, NULL, sheet);
-	g_object_unref(G_OBJECT(sheet->hadjustment));
-	sheet->hadjustment = NULL;
-    }
-    if (sheet->vadjustment)
-    {
-	g_signal_handlers_disconnect_matched(
-	    GTK_OBJECT(sheet->vadjustment),
-	    G_SIGNAL_MATCH_DATA,
-	    0, 0, NULL, NULL, sheet);
-	g_object_unref(G_OBJECT(sheet->vadjustment));
-	sheet->vadjustment = NULL;
-    }
-
-    children = sheet->children;
-    while (children)
-    {
-	GtkSheetChild *child = (GtkSheetChild *)children->data;
-	if (child && child->widget)
-	    gtk_sheet_remove_handler(GTK_CONTAINER(sheet), child->widget);
-	children = sheet->children;
-    }
-    sheet->children = NULL;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IS_DESTROYED);
+    if (col < 0 || col > sheet->maxcol)
+	return;
+    if (row < 0 || row > sheet->maxrow)
+	return;
 
-    if (GTK_OBJECT_CLASS(sheet_parent_class)->destroy)
-	(*GTK_OBJECT_CLASS(sheet_parent_class)->destroy)(object);
+    gtk_sheet_get_attributes(sheet,row,col,&myattr);
+    myattr.is_editable = is_editable;
+    gtk_sheet_set_cell_attributes(sheet,row,col,myattr);
+    return;
 }
 
-/*
- * gtk_sheet_style_set_handler:
- * 
- * this is the #GtkSheet widget class "style-set" signal handler
+/**
+ * gtk_sheet_cell_get_sensitive 
+ * @sheet:  a #GtkSheet. 
+ * @row: row index 
+ * @col: column index 
  * 
- * @param widget the #GtkSheet
- * @param previous_style
+ * Check sensitivity status of sheet, row, column and cell to decide
+ * if a sheet cell can receive focus.
+ *  
+ * Returns:	TRUE if cell is not sensitive, FALSE if it is marked
+ * sensitive at any level.
  */
-static void
-gtk_sheet_style_set_handler(GtkWidget *widget, GtkStyle  *previous_style)
+gboolean gtk_sheet_cell_get_sensitive(GtkSheet *sheet,
+    const gint row, const gint col)
 {
-    GtkSheet *sheet;
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    g_return_if_fail(widget != NULL);
-    g_return_if_fail(GTK_IS_SHEET(widget));
+    if (col < 0 || col > sheet->maxcol)
+	return (FALSE);
+    if (row < 0 || row > sheet->maxrow)
+	return (FALSE);
 
-    if (GTK_WIDGET_CLASS(sheet_parent_class)->style_set)
-	(*GTK_WIDGET_CLASS(sheet_parent_class)->style_set)(widget, previous_style);
+    GtkSheetColumn *colptr = COLPTR(sheet,col);
+    GtkSheetCellAttr myattr;
 
-    sheet = GTK_SHEET(widget);
+    /* if the widget/row/col are insensitive, then the 
+     * cell is automatically not sensitive, even if
+     * its local flag allows it.
+     */
+    if(!gtk_widget_get_sensitive(GTK_WIDGET(sheet)) 
+       || !GTK_SHEET_ROW_IS_SENSITIVE(sheet, row)
+       || !GTK_SHEET_COLUMN_IS_SENSITIVE(colptr) )
+        return FALSE;
 
-    if (gtk_widget_get_realized(widget))
-    {
-	gtk_style_set_background(gtk_widget_get_style(widget),
-	    gtk_widget_get_window(widget),
-	    gtk_widget_get_state(widget));
-    }
+    gtk_sheet_get_attributes(sheet,row,col,&myattr);
+    if( !myattr.is_sensitive )
+        return FALSE;
+
+    return TRUE;
 }
 
-/*
- * gtk_sheet_realize_handler:
- * 
- * this is the #GtkSheet widget class "realize" signal handler
- * 
- * @param widget the #GtkSheet
+/**
+ * gtk_sheet_cell_set_sensitive: 
+ * @sheet:  a #GtkSheet.
+ * @row: row index 
+ * @col: column index 
+ * @is_sensitive:  value for the sensitive status of the cell 
+ *  
+ * Sets cell sensitive status
  */
-static void
-gtk_sheet_realize_handler(GtkWidget *widget)
+void gtk_sheet_cell_set_sensitive(GtkSheet *sheet,
+    const gint row, const gint col,
+    const gboolean is_sensitive)
 {
-    GtkSheet *sheet;
-    GdkWindowAttr attributes;
-    gint attributes_mask;
-    GdkGCValues values, auxvalues;
-    GdkColormap *colormap;
-    GtkSheetChild *child;
-    GList *children;
-    GtkAllocation allocation;
+    GtkSheetCellAttr myattr;
 
-    g_return_if_fail(widget != NULL);
-    g_return_if_fail(GTK_IS_SHEET(widget));
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    sheet = GTK_SHEET(widget);
+    if (col < 0 || col > sheet->maxcol)
+	return;
+    if (row < 0 || row > sheet->maxrow)
+	return;
 
-    /* we need to recalc all positions, because row/column visibility
-       may have changed between adding rows/cols and realisation
-       PR#92947
-       */
-    _gtk_sheet_recalc_top_ypixels(sheet);
-    _gtk_sheet_recalc_left_xpixels(sheet);
+    gtk_sheet_get_attributes(sheet,row,col,&myattr);
+    myattr.is_sensitive = is_sensitive;
+    gtk_sheet_set_cell_attributes(sheet,row,col,myattr);
+    return;
+}
 
-#if GTK_SHEET_DEBUG_REALIZE > 0
-    g_debug("gtk_sheet_realize_handler: called (%p)", sheet->sheet_entry);
-#endif
 
-    gtk_widget_set_realized_true(GTK_WIDGET(widget));
+/**
+ * gtk_sheet_cell_get_can_focus: 
+ * @sheet:  a #GtkSheet. 
+ * @row: row index 
+ * @col: column index 
+ * 
+ * Check ability of cell to grab focus. Check includes 
+ * checking for blocks at row/column/sheet level.
+ *  
+ * Returns:	TRUE if the cell can focus, FALSE if blocked by any level
+ */
+gboolean gtk_sheet_cell_get_can_focus(GtkSheet *sheet,
+    const gint row, const gint col)
+{
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    gtk_widget_get_allocation(widget, &allocation);
-    attributes.window_type = GDK_WINDOW_CHILD;
-    attributes.x = allocation.x;
-    attributes.y = allocation.y;
-    attributes.width = allocation.width;
-    attributes.height = allocation.height;
-    attributes.wclass = GDK_INPUT_OUTPUT;
+    if (col < 0 || col > sheet->maxcol)
+	return (FALSE);
+    if (row < 0 || row > sheet->maxrow)
+	return (FALSE);
 
-    attributes.visual = gtk_widget_get_visual(widget);
-    attributes.colormap = gtk_widget_get_colormap(widget);
+    GtkSheetColumn *colptr = COLPTR(sheet,col);
+    GtkSheetCellAttr myattr;
 
-    attributes.event_mask = gtk_widget_get_events(widget);
-    attributes.event_mask |= (
-	GDK_EXPOSURE_MASK |
-	    GDK_BUTTON_PRESS_MASK |
-	    GDK_BUTTON_RELEASE_MASK |
-	    GDK_KEY_PRESS_MASK |
-	    GDK_POINTER_MOTION_MASK |
-	    GDK_POINTER_MOTION_HINT_MASK);
+    /* if the sheet row/col are invisible, insensitive or not
+     * allowing focus, then the cell is automatically 
+     * not focusable, even if its local edit flag allows it.
+     */
+    if(!GTK_SHEET_ROW_CAN_GRAB_FOCUS(sheet, row)
+       || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(colptr) )
+        return FALSE;
 
-    attributes_mask = GDK_WA_X | GDK_WA_Y |
-	    GDK_WA_VISUAL | GDK_WA_COLORMAP | GDK_WA_CURSOR;
+    gtk_sheet_get_attributes(sheet,row,col,&myattr);
+    if( !myattr.can_focus )
+        return FALSE;
 
-    attributes.cursor = gdk_cursor_new(GDK_TOP_LEFT_ARROW);
+    return TRUE;
+}
 
-    /* main window */
-    gtk_widget_set_window(widget,
-	gdk_window_new(gtk_widget_get_parent_window(widget),
-	    &attributes, attributes_mask));
+/**
+ * gtk_sheet_cell_set_can_focus: 
+ * @sheet:  a #GtkSheet.
+ * @row: row index 
+ * @col: column index 
+ * @can_focus:  value for the editable status of the cell 
+ *  
+ * Sets cell can_focus flag
+ */
+void gtk_sheet_cell_set_can_focus(GtkSheet *sheet,
+    const gint row, const gint col,
+    const gboolean can_focus)
+{
+    GtkSheetCellAttr myattr;
 
-    gdk_window_set_user_data(gtk_widget_get_window(widget), sheet);
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    gtk_widget_set_style(widget,
-	gtk_style_attach(gtk_widget_get_style(widget),
-	    gtk_widget_get_window(widget)));
+    if (col < 0 || col > sheet->maxcol)
+	return;
+    if (row < 0 || row > sheet->maxrow)
+	return;
 
-    gtk_style_set_background(gtk_widget_get_style(widget),
-	gtk_widget_get_window(widget),
-	GTK_STATE_NORMAL);
+    gtk_sheet_get_attributes(sheet,row,col,&myattr);
+    myattr.can_focus = can_focus;
+    gtk_sheet_set_cell_attributes(sheet,row,col,myattr);
+    return;
+}
 
-    attributes.x = 0;
-    if (sheet->row_titles_visible)
-	attributes.x = sheet->row_title_area.width;
-    attributes.y = 0;
-    attributes.width = sheet->column_title_area.width;
-    attributes.height = sheet->column_title_area.height;
+/**
+ * gtk_sheet_cell_get_visible: 
+ * @sheet:  a #GtkSheet. 
+ * @row: row index 
+ * @col: column index 
+ * 
+ * Check visiblity of cell. 
+ *  
+ * Returns:	TRUE if the cell is visible, FALSE otherwise.
+ */
+gboolean gtk_sheet_cell_get_visible(GtkSheet *sheet,
+    const gint row, const gint col)
+{
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    /* column-title window */
-    sheet->column_title_window = gdk_window_new(
-	gtk_widget_get_window(widget),
-	&attributes, attributes_mask);
-    gdk_window_set_user_data(sheet->column_title_window, sheet);
-    gtk_style_set_background(gtk_widget_get_style(widget),
-	sheet->column_title_window, GTK_STATE_NORMAL);
-
-    attributes.x = 0;
-    attributes.y = 0;
-    if (sheet->column_titles_visible)
-	attributes.y = sheet->column_title_area.height;
-    attributes.width = sheet->row_title_area.width;
-    attributes.height = sheet->row_title_area.height;
-
-    /* row-title window */
-    sheet->row_title_window = gdk_window_new(
-	gtk_widget_get_window(widget),
-	&attributes, attributes_mask);
-    gdk_window_set_user_data(sheet->row_title_window, sheet);
-    gtk_style_set_background(gtk_widget_get_style(widget),
-	sheet->row_title_window, GTK_STATE_NORMAL);
-
-    /* sheet-window */
-    attributes.cursor = gdk_cursor_new(GDK_PLUS);
-
-    attributes.x = 0;
-    attributes.y = 0;
-    attributes.width = sheet->sheet_window_width;
-    attributes.height = sheet->sheet_window_height;
+    if (col < 0 || col > sheet->maxcol)
+	return (FALSE);
+    if (row < 0 || row > sheet->maxrow)
+	return (FALSE);
 
-    sheet->sheet_window = gdk_window_new(
-	gtk_widget_get_window(widget),
-	&attributes, attributes_mask);
-    gdk_window_set_user_data(sheet->sheet_window, sheet);
+    GtkSheetColumn *colptr = COLPTR(sheet,col);
+    GtkSheetCellAttr myattr;
 
-    gdk_window_set_background(sheet->sheet_window,
-	&(gtk_widget_get_style(widget)->white));
-    gdk_window_show(sheet->sheet_window);
+    /* if the sheet row/col are invisible, 
+     * then so is the cell, even if its local flag allows it.
+     */
+    if(!GTK_SHEET_ROW_IS_VISIBLE(sheet, row)
+       || !GTK_SHEET_COLUMN_IS_VISIBLE(colptr) )
+        return FALSE;
 
-    /* backing_pixmap */
-    gtk_sheet_make_backing_pixmap(sheet, 0, 0);
+    gtk_sheet_get_attributes(sheet,row,col,&myattr);
+    if( !myattr.is_visible )
+        return FALSE;
 
-    /* GCs */
-    if (sheet->fg_gc)
-	gdk_gc_unref(sheet->fg_gc);
-    sheet->fg_gc = gdk_gc_new(gtk_widget_get_window(widget));
+    return TRUE;
+}
 
-    if (sheet->bg_gc)
-	gdk_gc_unref(sheet->bg_gc);
-    sheet->bg_gc = gdk_gc_new(gtk_widget_get_window(widget));
+/**
+ * gtk_sheet_cell_set_visible: 
+ * @sheet:  a #GtkSheet.
+ * @row: row index 
+ * @col: column index 
+ * @is_visible:  value for the visibility status of the cell 
+ *  
+ * Sets cell is_visible flag
+ */
+void gtk_sheet_cell_set_visible(GtkSheet *sheet,
+    const gint row, const gint col,
+    const gboolean is_visible)
+{
+    GtkSheetCellAttr myattr;
 
-    colormap = gtk_widget_get_colormap(widget);
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    gdk_color_white(colormap, &(gtk_widget_get_style(widget)->white));
-    gdk_color_black(colormap, &(gtk_widget_get_style(widget)->black));
+    if (col < 0 || col > sheet->maxcol)
+	return;
+    if (row < 0 || row > sheet->maxrow)
+	return;
 
-    gdk_gc_get_values(sheet->fg_gc, &auxvalues);
+    gtk_sheet_get_attributes(sheet,row,col,&myattr);
+    myattr.is_visible = is_visible;
+    gtk_sheet_set_cell_attributes(sheet,row,col,myattr);
+    return;
+}
 
-    values.foreground = gtk_widget_get_style(widget)->white;
-    values.function = GDK_INVERT;
-    values.subwindow_mode = GDK_INCLUDE_INFERIORS;
+/**
+ * gtk_sheet_select_row:
+ * @sheet: a #GtkSheet.
+ * @row: row number
+ *
+ * Select the row. The range is then highlighted, and the bounds are stored in sheet->range.
+ */
+void
+gtk_sheet_select_row(GtkSheet *sheet, gint row)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (sheet->xor_gc)
-	gdk_gc_unref(sheet->xor_gc);
-    sheet->xor_gc = gdk_gc_new_with_values(gtk_widget_get_window(widget),
-	&values,
-	GDK_GC_FOREGROUND |
-	    GDK_GC_FUNCTION |
-	    GDK_GC_SUBWINDOW);
+    if (row < 0 || row > sheet->maxrow)
+	return;
 
-    if (gtk_widget_get_parent(sheet->sheet_entry))
+    if (sheet->state != GTK_SHEET_NORMAL)
     {
-	g_object_ref(sheet->sheet_entry);
-	gtk_widget_unparent(sheet->sheet_entry);
+	gtk_sheet_real_unselect_range(sheet, NULL);
     }
-    gtk_widget_set_parent_window(sheet->sheet_entry, sheet->sheet_window);
-    gtk_widget_set_parent(sheet->sheet_entry, GTK_WIDGET(sheet));
-
-    if (sheet->button && gtk_widget_get_parent(sheet->button))
+    else
     {
-	g_object_ref(sheet->button);
-	gtk_widget_unparent(sheet->button);
+	gboolean veto = TRUE;
+	veto = gtk_sheet_deactivate_cell(sheet);
+	if (!veto)
+	    return;
     }
-    gtk_widget_set_parent_window(sheet->button, sheet->sheet_window);
-    gtk_widget_set_parent(sheet->button, GTK_WIDGET(sheet));
-
-/*
-  gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
-*/
-
-    if (!sheet->cursor_drag)
-	sheet->cursor_drag = gdk_cursor_new(GDK_PLUS);
 
-    if (sheet->column_titles_visible)
-	gdk_window_show(sheet->column_title_window);
-    if (sheet->row_titles_visible)
-	gdk_window_show(sheet->row_title_window);
-
-    size_allocate_row_title_buttons(sheet);
-    _gtk_sheet_column_buttons_size_allocate(sheet);
+    sheet->state = GTK_SHEET_ROW_SELECTED;
 
-    if (sheet->title)  /* re-initialize title to update GUI */
-    {
-	gchar *existing_title = g_strdup(sheet->title);
-	gtk_sheet_set_title(sheet, existing_title);
-	g_free(existing_title);
-    }
+    sheet->range.row0 = row;
+    sheet->range.col0 = 0;
+    sheet->range.rowi = row;
+    sheet->range.coli = sheet->maxcol;
 
-    children = sheet->children;
-    while (children)
-    {
-	child = children->data;
-	children = children->next;
+    sheet->active_cell.row = row;
+    sheet->active_cell.col = 0;
 
-	gtk_sheet_realize_child(sheet, child);
-    }
+    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[SELECT_ROW], 0, row);
+    gtk_sheet_real_select_range(sheet, NULL);
 }
 
-/*
- * global_button_clicked_handler:
- * this is the #GtkSheet global sheet button "button-press-event" handler. 
- *  
- * It will handle single-clicks of button 1 internally, selecting/deselecting 
- * all sheet cells. All other button press events are propagated to the sheet. 
- *  
- * You cann connect your own "button-press-event" handler to the sheet 
- * widget, and will receive all non-internally handled button-press-events.
- * 
- * @param widget the global sheet button that received the signal 
- * @param event  the GdkEventButton which triggered this signal
- * @param data   the #GtkSheet passed on signal connection 
- *  
- * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
+/**
+ * gtk_sheet_select_column:
+ * @sheet: a #GtkSheet.
+ * @column: column number
+ *
+ * Select the column. The range is then highlighted, and the bounds are stored in sheet->range.
  */
-static gboolean
-global_button_press_handler(GtkWidget *widget,
-    GdkEventButton *event,
-    gpointer data)
+void
+gtk_sheet_select_column(GtkSheet *sheet, gint column)
 {
-    gboolean veto;
-    GtkSheet *sheet = GTK_SHEET(data);
-    gboolean retval = FALSE;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (!retval
-	&& (event->type == GDK_BUTTON_PRESS)
-	&& (event->button == 1))
+    if (column < 0 || column > sheet->maxcol)
+	return;
+
+    if (sheet->state != GTK_SHEET_NORMAL)
     {
-	gtk_sheet_click_cell(sheet, -1, -1, &veto);
-	gtk_widget_grab_focus(GTK_WIDGET(sheet));
+	gtk_sheet_real_unselect_range(sheet, NULL);
     }
     else
     {
-	g_signal_emit_by_name(GTK_WIDGET(sheet), 
-	    "button_press_event", 
-	    event,
-	    &retval);
+	gboolean veto = TRUE;
+	veto = gtk_sheet_deactivate_cell(sheet);
+	if (!veto)
+	    return;
     }
 
-    return(retval);
-}
+    sheet->state = GTK_SHEET_COLUMN_SELECTED;
 
-static void
-create_global_button(GtkSheet *sheet)
-{
-    sheet->button = gtk_button_new_with_label(" ");
+    sheet->range.row0 = 0;
+    sheet->range.col0 = column;
+    sheet->range.rowi = sheet->maxrow;
+    sheet->range.coli = column;
 
-    g_signal_connect(GTK_OBJECT(sheet->button),
-	"button-press-event",
-	G_CALLBACK(global_button_press_handler),
-	(gpointer)sheet);
+    sheet->active_cell.row = 0;
+    sheet->active_cell.col = column;
+
+    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[SELECT_COLUMN], 0, column);
+    gtk_sheet_real_select_range(sheet, NULL);
 }
 
-static void
-size_allocate_global_button(GtkSheet *sheet)
+/**
+ * gtk_sheet_clip_range:
+ * @sheet: a #GtkSheet.
+ * @clip_range: #GtkSheetRange to be saved
+ *
+ * Save selected range to "clipboard".
+ */
+void
+gtk_sheet_clip_range(GtkSheet *sheet, const GtkSheetRange *clip_range)
 {
-    GtkAllocation allocation;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (!sheet->column_titles_visible)
-	return;
-    if (!sheet->row_titles_visible)
+    if (GTK_SHEET_IN_CLIP(sheet))
 	return;
 
-    gtk_widget_size_request(sheet->button, NULL);
+    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_CLIP);
 
-    allocation.x = 0;
-    allocation.y = 0;
-    allocation.width = sheet->row_title_area.width;
-    allocation.height = sheet->column_title_area.height;
+    if (clip_range == NULL)
+	sheet->clip_range = sheet->range;
+    else
+	sheet->clip_range = *clip_range;
 
-    gtk_widget_size_allocate(sheet->button, &allocation);
-    gtk_widget_show(sheet->button);
-}
+    sheet->interval = 0;
+    sheet->clip_timer = g_timeout_add_full(0, TIMEOUT_FLASH, gtk_sheet_flash, sheet, NULL);
 
+    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[CLIP_RANGE], 0, &sheet->clip_range);
+}
 
-/*
- * gtk_sheet_unrealize_handler:
- * 
- * this is the #GtkSheet widget class "unrealize" signal handler
- * 
- * @param widget the #GtkSheet
+/**
+ * gtk_sheet_unclip_range:
+ * @sheet: a #GtkSheet.
+ *
+ * Free clipboard.
  */
-static void
-gtk_sheet_unrealize_handler(GtkWidget *widget)
+void
+gtk_sheet_unclip_range(GtkSheet *sheet)
 {
-    GtkSheet *sheet;
-
-    g_return_if_fail(widget != NULL);
-    g_return_if_fail(GTK_IS_SHEET(widget));
-
-    sheet = GTK_SHEET(widget);
-
-    gdk_cursor_destroy(sheet->cursor_drag);
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    gdk_gc_destroy(sheet->xor_gc);
-    gdk_gc_destroy(sheet->fg_gc);
-    gdk_gc_destroy(sheet->bg_gc);
+    if (!GTK_SHEET_IN_CLIP(sheet))
+	return;
 
-    gdk_window_destroy(sheet->sheet_window);
-    gdk_window_destroy(sheet->column_title_window);
-    gdk_window_destroy(sheet->row_title_window);
+    GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_CLIP);
+    g_source_remove(sheet->clip_timer);
+    _gtk_sheet_range_draw(sheet, &sheet->clip_range, TRUE);
 
-    if (sheet->pixmap)
-    {
-	g_object_unref(G_OBJECT(sheet->pixmap));
-	sheet->pixmap = NULL;
-    }
+    if (gtk_sheet_range_isvisible(sheet, sheet->range))
+	_gtk_sheet_range_draw(sheet, &sheet->range, TRUE);
+}
 
-    sheet->column_title_window = NULL;
-    sheet->sheet_window = NULL;
-    sheet->cursor_drag = NULL;
-    sheet->xor_gc = NULL;
-    sheet->fg_gc = NULL;
-    sheet->bg_gc = NULL;
+/**
+ * gtk_sheet_in_clip:
+ * @sheet: a #GtkSheet.
+ *
+ * Get the clip status of #GtkSheet.
+ *
+ * Returns: TRUE or FALSE
+ */
+gboolean
+gtk_sheet_in_clip(GtkSheet *sheet)
+{
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    if (GTK_WIDGET_CLASS(sheet_parent_class)->unrealize)
-	(*GTK_WIDGET_CLASS(sheet_parent_class)->unrealize)(widget);
+    return (GTK_SHEET_IN_CLIP(sheet));
 }
 
-/*
- * gtk_sheet_map_handler:
- * 
- * this is the #GtkSheet widget class "map" signal handler
- * 
- * @param widget the #GtkSheet
- */
-static void
-gtk_sheet_map_handler(GtkWidget *widget)
+
+static gint
+gtk_sheet_flash(gpointer data)
 {
     GtkSheet *sheet;
-    GtkWidget *WdChild;
-    GtkSheetChild *child;
-    GList *children;
-
-    g_return_if_fail(widget != NULL);
-    g_return_if_fail(GTK_IS_SHEET(widget));
+    gint x, y, width, height;
+    GdkRectangle clip_area;
 
-    sheet = GTK_SHEET(widget);
+    sheet = GTK_SHEET(data);
 
-#if GTK_SHEET_DEBUG_EXPOSE > 0
-    g_debug("gtk_sheet_map_handler: called");
-#endif
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return (TRUE);
+    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
+	return (TRUE);
+    if (!gtk_sheet_range_isvisible(sheet, sheet->clip_range))
+	return (TRUE);
+    if (GTK_SHEET_IN_XDRAG(sheet))
+	return (TRUE);
+    if (GTK_SHEET_IN_YDRAG(sheet))
+	return (TRUE);
 
-    if (!gtk_widget_get_mapped(widget))
-    {
-	gtk_widget_set_mapped_true(GTK_WIDGET(widget));
+    GDK_THREADS_ENTER();
 
-	if (!sheet->cursor_drag)
-	    sheet->cursor_drag = gdk_cursor_new(GDK_PLUS);
+    x = _gtk_sheet_column_left_xpixel(sheet, sheet->clip_range.col0) + 1;
+    y = _gtk_sheet_row_top_ypixel(sheet, sheet->clip_range.row0) + 1;
+    width = _gtk_sheet_column_left_xpixel(sheet, sheet->clip_range.coli) - x +
+	COLPTR(sheet, sheet->clip_range.coli)->width - 1;
+    height = _gtk_sheet_row_top_ypixel(sheet, sheet->clip_range.rowi) - y +
+	ROW_HEIGHT(sheet, sheet->clip_range.rowi) - 1;
 
-	gdk_window_show(gtk_widget_get_window(widget));
-	gdk_window_show(sheet->sheet_window);
+    clip_area.x = _gtk_sheet_column_left_xpixel(sheet, MIN_VIEW_COLUMN(sheet));
+    clip_area.y = _gtk_sheet_row_top_ypixel(sheet, MIN_VIEW_ROW(sheet));
+    clip_area.width = sheet->sheet_window_width;
+    clip_area.height = sheet->sheet_window_height;
 
-	if (sheet->column_titles_visible)
-	{
-	    _gtk_sheet_column_buttons_size_allocate(sheet);
-	    gdk_window_show(sheet->column_title_window);
-	}
+    if (x < 0)
+    {
+	width = width + x + 1;
+	x = -1;
+    }
+    if (width > clip_area.width)
+	width = clip_area.width + 10;
 
-	if (sheet->row_titles_visible)
-	{
-	    size_allocate_row_title_buttons(sheet);
-	    gdk_window_show(sheet->row_title_window);
-	}
+    if (y < 0)
+    {
+	height = height + y + 1;
+	y = -1;
+    }
+    if (height > clip_area.height)
+	height = clip_area.height + 10;
 
-#if 0
-	/* this will be done by gtk_sheet_activate_cell() below,
-	   it causes trouble when there is no active cell in the sheet,
-	   because sheet_entry will start to process events */
-	if (!gtk_widget_get_mapped (sheet->sheet_entry))
-	{
-	    gtk_widget_show (sheet->sheet_entry);
-	    gtk_widget_map (sheet->sheet_entry);
-	}
-#endif
+    gdk_draw_pixmap(sheet->sheet_window,
+	gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+	sheet->pixmap,
+	x, y,
+	x, y,
+	1, height);
 
-	if (gtk_widget_get_visible(sheet->button) &&
-	    !gtk_widget_get_mapped(sheet->button))
-	{
-	    gtk_widget_show(sheet->button);
-	    gtk_widget_map(sheet->button);
-	}
+    gdk_draw_pixmap(sheet->sheet_window,
+	gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+	sheet->pixmap,
+	x, y,
+	x, y,
+	width, 1);
 
-	if ((WdChild = gtk_bin_get_child(GTK_BIN(sheet->button))))
-	{
-	    if (gtk_widget_get_visible(WdChild) &&
-		!gtk_widget_get_mapped(WdChild))
-	    {
-		gtk_widget_map(WdChild);
-	    }
-	}
+    gdk_draw_pixmap(sheet->sheet_window,
+	gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+	sheet->pixmap,
+	x, y + height,
+	x, y + height,
+	width, 1);
 
-#if GTK_SHEET_DEBUG_EXPOSE > 0
-	g_debug("gtk_sheet_map_handler: calling _gtk_sheet_range_draw");
-#endif
+    gdk_draw_pixmap(sheet->sheet_window,
+	gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+	sheet->pixmap,
+	x + width, y,
+	x + width, y,
+	1, height);
 
-	_gtk_sheet_recalc_view_range(sheet);
-	_gtk_sheet_range_draw(sheet, NULL, TRUE);
+    sheet->interval = sheet->interval + 1;
+    if (sheet->interval == TIME_INTERVAL)
+	sheet->interval = 0;
 
-	/* this was already done above - why again?
-	gtk_sheet_activate_cell(sheet, 
-	    sheet->active_cell.row, 
-	    sheet->active_cell.col);
-	    */
+    gdk_gc_set_dashes(sheet->xor_gc, sheet->interval, (gint8 *)"\4\4", 2);
+    gtk_sheet_draw_flashing_range(sheet, sheet->clip_range);
+    gdk_gc_set_dashes(sheet->xor_gc, 0, (gint8 *)"\4\4", 2);
 
-	children = sheet->children;
-	while (children)
-	{
-	    child = children->data;
-	    children = children->next;
+    GDK_THREADS_LEAVE();
 
-	    if (gtk_widget_get_visible(child->widget) &&
-		!gtk_widget_get_mapped(child->widget))
-	    {
-		gtk_widget_map(child->widget);
-		gtk_sheet_position_child(sheet, child);
-	    }
-	}
-    }
+    return (TRUE);
 }
 
-/*
- * gtk_sheet_unmap_handler:
- * 
- * this is the #GtkSheet widget class "unmap" signal handler
- * 
- * @param widget the #GtkSheet
- */
 static void
-gtk_sheet_unmap_handler(GtkWidget *widget)
+gtk_sheet_draw_flashing_range(GtkSheet *sheet, GtkSheetRange range)
 {
-    GtkSheet *sheet;
-    GtkSheetChild *child;
-    GList *children;
-
-    g_return_if_fail(widget != NULL);
-    g_return_if_fail(GTK_IS_SHEET(widget));
+    GdkRectangle clip_area;
+    gint x, y, width, height;
 
-    sheet = GTK_SHEET(widget);
+    if (!gtk_sheet_range_isvisible(sheet, sheet->clip_range))
+	return;
 
-#if GTK_SHEET_DEBUG_DRAW > 0
-    g_debug("gtk_sheet_unmap: called");
-#endif
-
-    if (gtk_widget_get_mapped(widget))
-    {
-	gtk_widget_set_mapped_false(GTK_WIDGET(widget));
-
-	gdk_window_hide(sheet->sheet_window);
+    clip_area.x = _gtk_sheet_column_left_xpixel(sheet, MIN_VIEW_COLUMN(sheet));
+    clip_area.y = _gtk_sheet_row_top_ypixel(sheet, MIN_VIEW_ROW(sheet));
+    clip_area.width = sheet->sheet_window_width;
+    clip_area.height = sheet->sheet_window_height;
 
-	if (sheet->column_titles_visible)
-	    gdk_window_hide(sheet->column_title_window);
+    gdk_gc_set_clip_rectangle(sheet->xor_gc, &clip_area);
 
-	if (sheet->row_titles_visible)
-	    gdk_window_hide(sheet->row_title_window);
+    x = _gtk_sheet_column_left_xpixel(sheet, sheet->clip_range.col0) + 1;
+    y = _gtk_sheet_row_top_ypixel(sheet, sheet->clip_range.row0) + 1;
+    width = _gtk_sheet_column_left_xpixel(sheet, sheet->clip_range.coli) - x +
+	COLPTR(sheet, sheet->clip_range.coli)->width - 1;
+    height = _gtk_sheet_row_top_ypixel(sheet, sheet->clip_range.rowi) - y +
+	ROW_HEIGHT(sheet, sheet->clip_range.rowi) - 1;
 
-	gdk_window_hide(gtk_widget_get_window(widget));
+    if (x < 0)
+    {
+	width = width + x + 1;
+	x = -1;
+    }
+    if (width > clip_area.width)
+	width = clip_area.width + 10;
 
-	if (gtk_widget_get_mapped(sheet->sheet_entry))
-	    gtk_widget_unmap(sheet->sheet_entry);
+    if (y < 0)
+    {
+	height = height + y + 1;
+	y = -1;
+    }
+    if (height > clip_area.height)
+	height = clip_area.height + 10;
 
-	if (gtk_widget_get_mapped(sheet->button))
-	    gtk_widget_unmap(sheet->button);
+    gdk_gc_set_line_attributes(sheet->xor_gc, 1, 1, 0, 0);
 
-	children = sheet->children;
-	while (children)
-	{
-	    child = children->data;
-	    children = children->next;
+    gdk_draw_rectangle(sheet->sheet_window, sheet->xor_gc, FALSE,
+	x, y,
+	width, height);
 
-	    if (gtk_widget_get_visible(child->widget) &&
-		gtk_widget_get_mapped(child->widget))
-	    {
-		gtk_widget_unmap(child->widget);
-	    }
-	}
+    gdk_gc_set_line_attributes(sheet->xor_gc, 1, 0, 0, 0);
 
-    }
+    gdk_gc_set_clip_rectangle(sheet->xor_gc, NULL);
 }
 
-/*
- * gtk_sheet_draw_tm - draw tooltip marker
- * 
- * @param sheet
- */
-static void
-gtk_sheet_draw_tooltip_marker(GtkSheet *sheet,
-    GtkSheetArea area,
-    const gint row, const gint col)
+static gint
+gtk_sheet_range_isvisible(GtkSheet *sheet, GtkSheetRange range)
 {
-    switch(area)
-    {
-	case ON_CELL_AREA:
-	    if (row <= sheet->maxallocrow && col <= sheet->maxalloccol
-		&& sheet->data[row] && sheet->data[row][col])
-	    {
-		GtkSheetCell *cell = sheet->data[row][col];
-
-		if (cell->tooltip_markup || cell->tooltip_text)
-		{
-		    GdkPoint p[3];
+    g_return_val_if_fail(sheet != NULL, FALSE);
 
-		    gdk_gc_set_foreground(sheet->bg_gc, &sheet->tm_color);
+    if (range.row0 > MAX_VIEW_ROW(sheet))
+	return (FALSE);
+    if (range.rowi < MIN_VIEW_ROW(sheet))
+	return (FALSE);
 
-		    p[0].x = _gtk_sheet_column_left_xpixel(sheet, col) + COLPTR(sheet, col)->width
-			- GTK_SHEET_DEFAULT_TM_SIZE;
-		    p[0].y = _gtk_sheet_row_top_ypixel(sheet, row) + 1;
+    if (range.col0 > MAX_VIEW_COLUMN(sheet))
+	return (FALSE);
+    if (range.coli < MIN_VIEW_COLUMN(sheet))
+	return (FALSE);
 
-		    p[1].x = p[0].x + GTK_SHEET_DEFAULT_TM_SIZE;
-		    p[1].y = p[0].y;
+    return (TRUE);
+}
 
-		    p[2].x = p[1].x;
-		    p[2].y = p[1].y + GTK_SHEET_DEFAULT_TM_SIZE;
+static gint
+gtk_sheet_cell_isvisible(GtkSheet *sheet,
+    gint row, gint column)
+{
+    GtkSheetRange range;
 
-		    /* draw cell tooltip marker */
-		    gdk_draw_polygon(sheet->pixmap,
-			sheet->bg_gc,
-			TRUE, p, 3);
-		}
-	    }
-	    break;
+    range.row0 = row;
+    range.col0 = column;
+    range.rowi = row;
+    range.coli = column;
 
-	case ON_ROW_TITLES_AREA:
-	    if (0 <= row && row <= sheet->maxrow)
-	    {
-		GtkSheetRow *rowp = ROWPTR(sheet, row);
-		GdkWindow *window = sheet->row_title_window;
+    return (gtk_sheet_range_isvisible(sheet, range));
+}
 
-		if (rowp->tooltip_markup || rowp->tooltip_text)
-		{
-		    GdkPoint p[3];
+/**
+ * gtk_sheet_get_visible_range:
+ * @sheet: a #GtkSheet.
+ * @range: a selected #GtkSheetRange
+ * struct _GtkSheetRange { gint row0,col0; //  upper-left cell
+ * 			  gint rowi,coli;  // lower-right cell  };
+ *
+ * Get sheet's ranges in a #GkSheetRange structure.
+ */
+void
+gtk_sheet_get_visible_range(GtkSheet *sheet, GtkSheetRange *range)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_return_if_fail(range != NULL);
 
-		    gdk_gc_set_foreground(sheet->bg_gc, &sheet->tm_color);
+    range->row0 = MIN_VIEW_ROW(sheet);
+    range->col0 = MIN_VIEW_COLUMN(sheet);
+    range->rowi = MAX_VIEW_ROW(sheet);
+    range->coli = MAX_VIEW_COLUMN(sheet);
+}
 
-		    p[0].x = sheet->row_title_area.width - 1
-			- GTK_SHEET_DEFAULT_TM_SIZE;
-		    p[0].y = _gtk_sheet_row_top_ypixel(sheet, row) + 1;
-		    if (sheet->column_titles_visible)
-			p[0].y -= sheet->column_title_area.height;
+/**
+ * gtk_sheet_get_vadjustment:
+ * @sheet: a #GtkSheet.
+ *
+ * Get vertical scroll adjustments.
+ *
+ * Returns: (transfer none) a #GtkAdjustment
+ */
+GtkAdjustment *
+gtk_sheet_get_vadjustment(GtkSheet *sheet)
+{
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
 
-		    p[1].x = p[0].x + GTK_SHEET_DEFAULT_TM_SIZE;
-		    p[1].y = p[0].y;
+    return (sheet->vadjustment);
+}
 
-		    p[2].x = p[1].x;
-		    p[2].y = p[1].y + GTK_SHEET_DEFAULT_TM_SIZE;
+/**
+ * gtk_sheet_get_hadjustment:
+ * @sheet: a #GtkSheet.
+ *
+ * Get horizontal scroll adjustments.
+ *
+ * Returns: (transfer none) a #GtkAdjustment
+ */
+GtkAdjustment *
+gtk_sheet_get_hadjustment(GtkSheet *sheet)
+{
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
 
-		    /* draw cell tooltip marker */
-		    gdk_draw_polygon(window,
-			sheet->bg_gc,
-			TRUE, p, 3);
-		}
-	    }
-	    break;
+    return (sheet->hadjustment);
+}
 
-	case ON_COLUMN_TITLES_AREA:
-	    if (0 <= col && col <= sheet->maxcol)
-	    {
-		GtkSheetColumn *column = COLPTR(sheet, col);
-		GdkWindow *window = sheet->column_title_window;
+/**
+ * gtk_sheet_set_vadjustment:
+ * @sheet: a #GtkSheet.
+ * @adjustment: a #GtkAdjustment
+ *
+ * Change vertical scroll adjustments.
+ */
+void
+gtk_sheet_set_vadjustment(GtkSheet *sheet, GtkAdjustment *adjustment)
+{
+    GtkAdjustment *old_adjustment;
 
-		if (gtk_widget_get_has_tooltip(GTK_WIDGET(column)))
-		{
-		    GdkPoint p[3];
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-		    gdk_gc_set_foreground(sheet->bg_gc, &sheet->tm_color);
+    if (adjustment)
+	g_return_if_fail(GTK_IS_ADJUSTMENT(adjustment));
+    if (sheet->vadjustment == adjustment)
+	return;
 
-		    p[0].x = _gtk_sheet_column_right_xpixel(sheet, col) + CELL_SPACING - 1
-			- GTK_SHEET_DEFAULT_TM_SIZE;
-		    if (sheet->row_titles_visible)
-			p[0].x -= sheet->row_title_area.width;
-		    p[0].y = 0;
+    old_adjustment = sheet->vadjustment;
 
-		    p[1].x = p[0].x + GTK_SHEET_DEFAULT_TM_SIZE;
-		    p[1].y = p[0].y;
+    if (sheet->vadjustment)
+    {
+	g_signal_handlers_disconnect_matched(
+	    GTK_OBJECT(sheet->vadjustment),
+	    G_SIGNAL_MATCH_DATA,
+	    0, 0, NULL, NULL, sheet);
+	g_object_unref(G_OBJECT(sheet->vadjustment));
+    }
 
-		    p[2].x = p[1].x;
-		    p[2].y = p[1].y + GTK_SHEET_DEFAULT_TM_SIZE;
+    sheet->vadjustment = adjustment;
 
-		    /* draw cell tooltip marker */
-		    gdk_draw_polygon(window,
-			sheet->bg_gc,
-			TRUE, p, 3);
-		}
-	    }
-	    break;
+    if (sheet->vadjustment)
+    {
+	g_object_ref(G_OBJECT(sheet->vadjustment));
+	g_object_ref_sink(G_OBJECT(sheet->vadjustment));
+	g_object_unref(G_OBJECT(sheet->vadjustment));
 
-	default:
-	    return;
+	g_signal_connect(GTK_OBJECT(sheet->vadjustment), "changed",
+	    (void *)_vadjustment_changed_handler,
+	    (gpointer)sheet);
+	g_signal_connect(GTK_OBJECT(sheet->vadjustment), "value_changed",
+	    (void *)_vadjustment_value_changed_handler,
+	    (gpointer)sheet);
     }
-}
 
-static void
-_cell_draw_background(GtkSheet *sheet, gint row, gint col)
-{
-    GtkWidget *widget;
-    GdkGC * fg_gc, *bg_gc;
-    GdkRectangle area;
-
-    g_return_if_fail(sheet != NULL);
-
-    /* bail now if we arn't drawable yet */
-    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
-	return;
-
-    if (row < 0 || row > sheet->maxrow)
-	return;
-    if (col < 0 || col > sheet->maxcol)
-	return;
-    if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
-	return;
-    if (!GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row)))
+    if (!sheet->vadjustment || !old_adjustment)
+    {
+	gtk_widget_queue_resize(GTK_WIDGET(sheet));
 	return;
+    }
 
-    widget = GTK_WIDGET(sheet);
-
-    GtkSheetCellAttr attributes;
-    gtk_sheet_get_attributes(sheet, row, col, &attributes);
+    sheet->old_vadjustment = gtk_adjustment_get_value(sheet->vadjustment);
+}
 
-    /* select GC for background rectangle */
-    gdk_gc_set_foreground(sheet->fg_gc, &attributes.foreground);
-    gdk_gc_set_foreground(sheet->bg_gc, &attributes.background);
+/**
+ * gtk_sheet_set_hadjustment:
+ * @sheet: a #GtkSheet.
+ * @adjustment: a #GtkAdjustment
+ *
+ * Change horizontal scroll adjustments.
+ */
+void
+gtk_sheet_set_hadjustment(GtkSheet *sheet, GtkAdjustment *adjustment)
+{
+    GtkAdjustment *old_adjustment;
 
-    fg_gc = sheet->fg_gc;
-    bg_gc = sheet->bg_gc;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    area.x = _gtk_sheet_column_left_xpixel(sheet, col);
-    area.y = _gtk_sheet_row_top_ypixel(sheet, row);
-    area.width = COLPTR(sheet, col)->width;
-    area.height = ROWPTR(sheet, row)->height;
+    if (adjustment)
+	g_return_if_fail(GTK_IS_ADJUSTMENT(adjustment));
+    if (sheet->hadjustment == adjustment)
+	return;
 
-#if GTK_SHEET_DEBUG_DRAW_BACKGROUND>0
-#if 1
-    g_debug("_cell_draw_background(%d,%d): cellbg x %d y %d w %d h %d %s",
-	row, col,
-	area.x, area.y, area.width, area.height,
-	gdk_color_to_string(&attributes.background));
-#endif
-#endif
+    old_adjustment = sheet->hadjustment;
 
-    /* fill cell background */
-    gdk_draw_rectangle(sheet->pixmap,
-	bg_gc,
-	TRUE,
-	area.x, area.y,
-	area.width, area.height);
+    if (sheet->hadjustment)
+    {
+	g_signal_handlers_disconnect_matched(
+	    GTK_OBJECT(sheet->hadjustment),
+	    G_SIGNAL_MATCH_DATA,
+	    0, 0, NULL, NULL, sheet);
+	g_object_unref(GTK_OBJECT(sheet->hadjustment));
+    }
 
-    gdk_gc_set_line_attributes(sheet->fg_gc, 1, 0, 0, 0);
+    sheet->hadjustment = adjustment;
 
-    if (sheet->show_grid)
+    if (sheet->hadjustment)
     {
-	gdk_gc_set_foreground(sheet->bg_gc, &sheet->grid_color);
+	g_object_ref(G_OBJECT(sheet->hadjustment));
+	g_object_ref_sink(G_OBJECT(sheet->hadjustment));
+	g_object_unref(G_OBJECT(sheet->hadjustment));
 
-#if GTK_SHEET_DEBUG_DRAW_BACKGROUND>0
-#if 0
-	g_debug("_cell_draw_background(%d,%d): grid x %d y %d w %d h %d %s",
-		row, col,
-		area.x, area.y, area.width, area.height,
-		gdk_color_to_string(&attributes.background));
-#endif
-#endif
+	g_signal_connect(GTK_OBJECT(sheet->hadjustment), "changed",
+	    (void *)_hadjustment_changed_handler,
+	    (gpointer)sheet);
+	g_signal_connect(GTK_OBJECT(sheet->hadjustment), "value_changed",
+	    (void *)_hadjustment_value_changed_handler,
+	    (gpointer)sheet);
+    }
 
-	/* draw grid rectangle */
-	gdk_draw_rectangle(sheet->pixmap,
-	    sheet->bg_gc,
-	    FALSE,
-	    area.x, area.y,
-	    area.width, area.height);
+    if (!sheet->hadjustment || !old_adjustment)
+    {
+	gtk_widget_queue_resize(GTK_WIDGET(sheet));
+	return;
     }
 
-    gtk_sheet_draw_tooltip_marker(sheet, ON_CELL_AREA, row, col);
+    sheet->old_hadjustment = gtk_adjustment_get_value(sheet->hadjustment);
 }
 
+/**
+ * gtk_sheet_set_scroll_adjustments:
+ * @sheet: a #GtkSheet.
+ * @hadjustment: a #GtkAdjustment
+ * @vadjustment: a #GtkAdjustment
+ *
+ * Change horizontal and vertical scroll adjustments.
+ */
 static void
-_cell_draw_border(GtkSheet *sheet, gint row, gint col, gint mask)
+gtk_sheet_set_scroll_adjustments(GtkSheet *sheet,
+    GtkAdjustment *hadjustment,
+    GtkAdjustment *vadjustment)
 {
-    GtkWidget *widget;
-    GdkGC * fg_gc, *bg_gc;
-    GdkRectangle area;
-    guint width;
+#if GTK_SHEET_DEBUG_SIGNALS > 0
+    g_debug("SIGNAL set-scroll-adjustments %p", sheet);
+#endif
 
-    g_return_if_fail(sheet != NULL);
+    if (sheet->hadjustment != hadjustment)
+	gtk_sheet_set_hadjustment(sheet, hadjustment);
 
-    /* bail now if we arn't drawable yet */
-    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
-	return;
+    if (sheet->vadjustment != vadjustment)
+	gtk_sheet_set_vadjustment(sheet, vadjustment);
+}
 
-    if (row < 0 || row > sheet->maxrow)
-	return;
-    if (col < 0 || col > sheet->maxcol)
-	return;
-    if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
-	return;
-    if (!GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row)))
-	return;
+/*
+ * gtk_sheet_finalize_handler:
+ * 
+ * this is the #GtkSheet object class "finalize" signal handler
+ * 
+ * @param object the #GtkSheet
+ */
+static void
+gtk_sheet_finalize_handler(GObject *object)
+{
+    GtkSheet *sheet;
 
-    widget = GTK_WIDGET(sheet);
+    g_return_if_fail(object != NULL);
+    g_return_if_fail(GTK_IS_SHEET(object));
 
-    GtkSheetCellAttr attributes;
-    gtk_sheet_get_attributes(sheet, row, col, &attributes);
+    sheet = GTK_SHEET(object);
 
-    /* select GC for background rectangle */
-    gdk_gc_set_foreground(sheet->fg_gc, &attributes.border.color);
-    gdk_gc_set_foreground(sheet->bg_gc, &attributes.background);
+    /* get rid of all the cells, releasing slabs in bulk */
+    FreeCellData(sheet);
 
-    fg_gc = sheet->fg_gc;
-    bg_gc = sheet->bg_gc;
+    gtk_sheet_delete_rows(sheet, 0, sheet->maxrow + 1);
+    gtk_sheet_delete_columns(sheet, 0, sheet->maxcol + 1);
 
-    area.x = _gtk_sheet_column_left_xpixel(sheet, col);
-    area.y = _gtk_sheet_row_top_ypixel(sheet, row);
-    area.width = COLPTR(sheet, col)->width;
-    area.height = sheet->row[row].height;
+    DeleteRow(sheet, 0, sheet->maxrow + 1);
+    DeleteColumn(sheet, 0, sheet->maxcol + 1);
 
-    width = attributes.border.width;
-    gdk_gc_set_line_attributes(sheet->fg_gc, attributes.border.width,
-	attributes.border.line_style,
-	attributes.border.cap_style,
-	attributes.border.join_style);
-    if (width > 0)
+    g_free(sheet->row_pages);  /* pages were freed by DeleteRow() */
+    sheet->row_pages = NULL;
+    sheet->row_npages = 0;
+    if (sheet->row_data)
+    {
+	g_hash_table_destroy(sheet->row_data);
+	sheet->row_data = NULL;
+    }
+    if (sheet->row_extent_hist)
     {
+	g_hash_table_destroy(sheet->row_extent_hist);
+	sheet->row_extent_hist = NULL;
+    }
 
-	if (attributes.border.mask & GTK_SHEET_LEFT_BORDER & mask)
-	    gdk_draw_line(sheet->pixmap, sheet->fg_gc,
-		area.x, area.y - width / 2,
-		area.x, area.y + area.height + width / 2 + 1);
+    if (sheet->column)  /* free remaining column array, no gobjects there */
+    {
+	g_free(sheet->column);
+	sheet->column = NULL;
+    }
 
-	if (attributes.border.mask & GTK_SHEET_RIGHT_BORDER & mask)
-	    gdk_draw_line(sheet->pixmap, sheet->fg_gc,
-		area.x + area.width, area.y - width / 2,
-		area.x + area.width,
-		area.y + area.height + width / 2 + 1);
+    if (sheet->mem_pool)
+    {
+	g_free(sheet->mem_pool);
+	sheet->mem_pool = NULL;
+    }
 
-	if (attributes.border.mask & GTK_SHEET_TOP_BORDER & mask)
-	    gdk_draw_line(sheet->pixmap, sheet->fg_gc,
-		area.x - width / 2, area.y,
-		area.x + area.width + width / 2 + 1,
-		area.y);
+    _gtk_sheet_attr_rules_free(sheet);
 
-	if (attributes.border.mask & GTK_SHEET_BOTTOM_BORDER & mask)
-	    gdk_draw_line(sheet->pixmap, sheet->fg_gc,
-		area.x - width / 2, area.y + area.height,
-		area.x + area.width + width / 2 + 1,
-		area.y + area.height);
+    if (sheet->attr_table)
+    {
+	_gtk_sheet_attr_table_free(sheet->attr_table);
+	sheet->attr_table = NULL;
     }
 
-}
+    if (sheet->row_geometry)
+    {
+	_gtk_sheet_psum_free(sheet->row_geometry);
+	sheet->row_geometry = NULL;
+    }
 
+    if (sheet->column_geometry)
+    {
+	_gtk_sheet_psum_free(sheet->column_geometry);
+	sheet->column_geometry = NULL;
+    }
 
-static void
-_cell_draw_label(GtkSheet *sheet, gint row, gint col)
-{
-    GtkWidget *widget;
-    GdkRectangle area, clip_area;
-    gint i;
-    gint text_width, text_height, y;
-    gint xoffset = 0;
-    gint size, sizel, sizer;
-    GdkGC *gc;
-    PangoLayout *layout;
-    PangoRectangle rect;
-    PangoFontMetrics *metrics;
-    PangoContext *context = gtk_widget_get_pango_context(GTK_WIDGET(sheet));
-    gint ascent, descent, spacing, y_pos;
-    GtkSheetVerticalJustification vjust;
+    if (sheet->metrics_cache)
+    {
+	_gtk_sheet_metrics_cache_free(sheet->metrics_cache);
+	sheet->metrics_cache = NULL;
+    }
 
-    gchar * label, *dataformat;
+    if (sheet->extent_cache)
+    {
+	_gtk_sheet_extent_cache_free(sheet->extent_cache);
+	sheet->extent_cache = NULL;
+    }
 
-    g_return_if_fail(sheet != NULL);
+    if (sheet->layout_cache)
+    {
+	_gtk_sheet_layout_cache_free(sheet->layout_cache);
+	sheet->layout_cache = NULL;
+    }
 
-    /* bail now if we aren't drawable yet */
-    if (!GTK_WIDGET_DRAWABLE(sheet))
-	return;
+    if (sheet->dirty_ranges)
+    {
+	g_array_free(sheet->dirty_ranges, TRUE);
+	sheet->dirty_ranges = NULL;
+    }
 
-    if (row < 0 || row > sheet->maxallocrow)
-	return;
-    if (col < 0 || col > sheet->maxalloccol)
-	return;
+    if (sheet->model_cache)
+    {
+	_gtk_sheet_model_cache_free(sheet->model_cache);
+	sheet->model_cache = NULL;
+    }
 
-    if (!sheet->data[row])
-	return;
-    if (!sheet->data[row][col])
-	return;
-    if (!sheet->data[row][col]->text || !sheet->data[row][col]->text[0])
-	return;
+#if GTK_SHEET_TILE_CACHE
+    if (sheet->tile_cache)
+    {
+	_gtk_sheet_tile_cache_free(sheet->tile_cache);
+	sheet->tile_cache = NULL;
+    }
+#endif
 
-    if (row < 0 || row > sheet->maxrow)
-	return;
-    if (col < 0 || col > sheet->maxcol)
-	return;
+#if GTK_SHEET_RENDER_THREADS
+    if (sheet->render_pool)
+    {
+	_gtk_sheet_render_pool_free(sheet->render_pool);
+	sheet->render_pool = NULL;
+    }
+#endif
 
-    /* bail now if we aren't drawable yet */
-    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
-	return;
+    if (sheet->title)
+    {
+	g_free(sheet->title);
+	sheet->title = NULL;
+    }
 
-    GtkSheetColumn *colptr = COLPTR(sheet, col);
+    if (G_OBJECT_CLASS(sheet_parent_class)->finalize)
+	(*G_OBJECT_CLASS(sheet_parent_class)->finalize)(object);
+}
 
-    if (!GTK_SHEET_COLUMN_IS_VISIBLE(colptr))
-	return;
-    if (!GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row)))
-	return;
-
-    widget = GTK_WIDGET(sheet);
+/*
+ * gtk_sheet_destroy_handler:
+ * 
+ * this is the #GtkSheet object class "finalize" handler
+ * 
+ * @param object
+ */
+static void
+gtk_sheet_destroy_handler(GtkObject *object)
+{
+    GtkSheet *sheet;
+    GList *children;
 
-    label = sheet->data[row][col]->text;
-    dataformat = gtk_sheet_column_get_format(sheet, col);
+    g_return_if_fail(object != NULL);
+    g_return_if_fail(GTK_IS_SHEET(object));
 
-    if (dataformat)
-	label = gtk_data_format(label, dataformat);
+    sheet = GTK_SHEET(object);
 
-    GtkSheetCellAttr attributes;
-    gtk_sheet_get_attributes(sheet, row, col, &attributes);
+    /* destroy the entry */
+    if (sheet->sheet_entry && GTK_IS_WIDGET(sheet->sheet_entry))
+    {
+	gtk_widget_destroy(sheet->sheet_entry);
+	sheet->sheet_entry = NULL;
+    }
 
-    /* select GC for background rectangle */
-    gdk_gc_set_foreground(sheet->fg_gc, &attributes.foreground);
-    gdk_gc_set_background(sheet->fg_gc, &attributes.background);
+    /* destroy the global selection button */
+    if (sheet->button && GTK_IS_WIDGET(sheet->button))
+    {
+#if GTK_SHEET_DEBUG_REALIZE > 0
+	g_debug("gtk_sheet_destroy: destroying old entry %p", sheet->button);
+#endif
+	gtk_widget_destroy(sheet->button);
+	sheet->button = NULL;
+    }
 
-    gc = sheet->fg_gc;
+    if (sheet->timer)
+    {
+	g_source_remove(sheet->timer);
+	sheet->timer = 0;
+    }
 
-    area.x = _gtk_sheet_column_left_xpixel(sheet, col);
-    area.y = _gtk_sheet_row_top_ypixel(sheet, row);
-    area.width = colptr->width;
-    area.height = ROWPTR(sheet, row)->height;
+    if (sheet->clip_timer)
+    {
+	g_source_remove(sheet->clip_timer);
+	sheet->clip_timer = 0;
+    }
 
-    clip_area = area;
+    if (sheet->dirty_idle)
+    {
+	g_source_remove(sheet->dirty_idle);
+	sheet->dirty_idle = 0;
+    }
 
-    layout = gtk_widget_create_pango_layout(GTK_WIDGET(sheet), label);
-    pango_layout_set_font_description(layout, attributes.font_desc);
+    if (sheet->extent_idle)
+    {
+	g_source_remove(sheet->extent_idle);
+	sheet->extent_idle = 0;
+    }
 
-    if (!gtk_sheet_autoresize_columns(sheet))
+#if GTK_SHEET_TILE_CACHE
+    if (sheet->tile_cache && sheet->tile_cache->prerender_idle)
     {
-	switch(colptr->wrap_mode)
-	{
-	    case GTK_WRAP_NONE: 
-		break;
+	g_source_remove(sheet->tile_cache->prerender_idle);
+	sheet->tile_cache->prerender_idle = 0;
+    }
+#endif
 
-	    case GTK_WRAP_CHAR:
-		pango_layout_set_width(layout, colptr->width * PANGO_SCALE);
-		pango_layout_set_wrap(layout, PANGO_WRAP_CHAR);
-		break;
+    /* detach the model */
+    if (sheet->model)
+    {
+	g_signal_handlers_disconnect_matched(
+	    G_OBJECT(sheet->model),
+	    G_SIGNAL_MATCH_DATA,
+	    0, 0, NULL, NULL, sheet);
+	g_object_unref(G_OBJECT(sheet->model));
+	sheet->model = NULL;
+    }
 
-	    case GTK_WRAP_WORD:
-		pango_layout_set_width(layout, colptr->width * PANGO_SCALE);
-		pango_layout_set_wrap(layout, PANGO_WRAP_WORD);
-		break;
+    /* unref adjustments */
+    if (sheet->hadjustment)
+    {
+	g_signal_handlers_disconnect_matched(
+	    GTK_OBJECT(sheet->hadjustment),
+	    G_SIGNAL_MATCH_DATA,
+	    0, 0, NULL, NULL, sheet);
+	g_object_unref(G_OBJECT(sheet->hadjustment));
+	sheet->hadjustment = NULL;
+    }
+    if (sheet->vadjustment)
+    {
+	g_signal_handlers_disconnect_matched(
+	    GTK_OBJECT(sheet->vadjustment),
+	    G_SIGNAL_MATCH_DATA,
+	    0, 0, NULL, NULL, sheet);
+	g_object_unref(G_OBJECT(sheet->vadjustment));
+	sheet->vadjustment = NULL;
+    }
 
-	    case GTK_WRAP_WORD_CHAR:
-		pango_layout_set_width(layout, colptr->width * PANGO_SCALE);
-		pango_layout_set_wrap(layout, PANGO_WRAP_WORD_CHAR);
-		break;
-	}
+    children = sheet->children;
+    while (children)
+    {
+	GtkSheetChild *child = (GtkSheetChild *)children->data;
+	if (child && child->widget)
+	    gtk_sheet_remove_handler(GTK_CONTAINER(sheet), child->widget);
+	children = sheet->children;
     }
+    sheet->children = NULL;
 
-    pango_layout_get_pixel_extents(layout, NULL, &rect);
+    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IS_DESTROYED);
 
-    metrics = pango_context_get_metrics(context,
-	attributes.font_desc, pango_context_get_language(context));
+    if (GTK_OBJECT_CLASS(sheet_parent_class)->destroy)
+	(*GTK_OBJECT_CLASS(sheet_parent_class)->destroy)(object);
+}
 
-    ascent = pango_font_metrics_get_ascent(metrics) / PANGO_SCALE;
-    descent = pango_font_metrics_get_descent(metrics) / PANGO_SCALE;
-    spacing = pango_layout_get_spacing(layout) / PANGO_SCALE;
+/*
+ * gtk_sheet_style_set_handler:
+ * 
+ * this is the #GtkSheet widget class "style-set" signal handler
+ * 
+ * @param widget the #GtkSheet
+ * @param previous_style
+ */
+static void
+gtk_sheet_style_set_handler(GtkWidget *widget, GtkStyle  *previous_style)
+{
+    GtkSheet *sheet;
 
-    pango_font_metrics_unref(metrics);
+    g_return_if_fail(widget != NULL);
+    g_return_if_fail(GTK_IS_SHEET(widget));
 
-    /* Align primarily for locale's ascent/descent */
+    if (GTK_WIDGET_CLASS(sheet_parent_class)->style_set)
+	(*GTK_WIDGET_CLASS(sheet_parent_class)->style_set)(widget, previous_style);
 
-    /* vertical cell text justification */
+    sheet = GTK_SHEET(widget);
+
+    /* fonts may resolve differently now */
+    if (sheet->metrics_cache)
+	_gtk_sheet_metrics_cache_flush(sheet->metrics_cache);
+    if (sheet->extent_cache)
+	_gtk_sheet_extent_cache_flush(sheet->extent_cache);
+    if (sheet->layout_cache)
+	_gtk_sheet_layout_cache_flush(sheet->layout_cache);
+    _gtk_sheet_tile_cache_invalidate(sheet, NULL);
+
+    /* measured extents are stale, refit in the background */
+    if (previous_style && sheet->maxalloccol >= 0)
     {
-	/* column->vjust overrides sheet->vjust */
+	_gtk_sheet_invalidate_extents(sheet);
+	if (gtk_sheet_autoresize(sheet))
+	    _gtk_sheet_schedule_extents(sheet);
+    }
 
-	vjust = colptr->vjust;
-	if (vjust == GTK_SHEET_VERTICAL_JUSTIFICATION_DEFAULT)
-	    vjust = sheet->vjust;
+    if (gtk_widget_get_realized(widget))
+    {
+	gtk_style_set_background(gtk_widget_get_style(widget),
+	    gtk_widget_get_window(widget),
+	    gtk_widget_get_state(widget));
+    }
+}
 
-	/* Vertical justification is quantisized, so that all text lines using the
-	   same font appear vertically aligned, even if adjacent columns have
-	   different vjust settings.
-	   */
-	switch(vjust)
-	{
-	    case GTK_SHEET_VERTICAL_JUSTIFICATION_DEFAULT:
-	    case GTK_SHEET_VERTICAL_JUSTIFICATION_TOP:
-		y_pos = CELLOFFSET;
-		break;
+/*
+ * gtk_sheet_realize_handler:
+ * 
+ * this is the #GtkSheet widget class "realize" signal handler
+ * 
+ * @param widget the #GtkSheet
+ */
+static void
+gtk_sheet_realize_handler(GtkWidget *widget)
+{
+    GtkSheet *sheet;
+    GdkWindowAttr attributes;
+    gint attributes_mask;
+    GdkGCValues values, auxvalues;
+    GdkColormap *colormap;
+    GtkSheetChild *child;
+    GList *children;
+    GtkAllocation allocation;
 
-	    case GTK_SHEET_VERTICAL_JUSTIFICATION_MIDDLE:
-		{
-		    /* the following works only if the whole text is set with same metrics */
-		    register gint line_height = ascent + descent + spacing;
-		    register gint area_lines = area.height / line_height;
-		    register gint text_lines = rect.height / line_height;
+    g_return_if_fail(widget != NULL);
+    g_return_if_fail(GTK_IS_SHEET(widget));
 
-		    y_pos = CELLOFFSET - ((text_lines - area_lines) / 2) * line_height;
-		}
-		break;
+    sheet = GTK_SHEET(widget);
 
-	    case GTK_SHEET_VERTICAL_JUSTIFICATION_BOTTOM:
-		{
-		    /* the following works only if the whole text is set with same metrics */
-		    register gint line_height = ascent + descent + spacing;
-		    register gint area_lines = area.height / line_height;
-		    register gint area_height_quant = area_lines * line_height;
+    /* we need to recalc all positions, because row/column visibility
+       may have changed between adding rows/cols and realisation
+       PR#92947
+       */
+    _gtk_sheet_recalc_top_ypixels(sheet);
+    _gtk_sheet_recalc_left_xpixels(sheet);
 
-		    y_pos = CELLOFFSET + area_height_quant - rect.height;
-		}
-		break;
-	}
+#if GTK_SHEET_DEBUG_REALIZE > 0
+    g_debug("gtk_sheet_realize_handler: called (%p)", sheet->sheet_entry);
+#endif
 
-	y = area.y + y_pos;
-    }
+    gtk_widget_set_realized_true(GTK_WIDGET(widget));
 
-    text_width = rect.width;
-    text_height = rect.height;
+    gtk_widget_get_allocation(widget, &allocation);
+    attributes.window_type = GDK_WINDOW_CHILD;
+    attributes.x = allocation.x;
+    attributes.y = allocation.y;
+    attributes.width = allocation.width;
+    attributes.height = allocation.height;
+    attributes.wclass = GDK_INPUT_OUTPUT;
 
+    attributes.visual = gtk_widget_get_visual(widget);
+    attributes.colormap = gtk_widget_get_colormap(widget);
 
-    switch(attributes.justification)
-    {
-	case GTK_JUSTIFY_RIGHT:
-	    size = area.width;  /* start with col size */
-	    area.x += area.width;  /* anchor clip_area at right */
+    attributes.event_mask = gtk_widget_get_events(widget);
+    attributes.event_mask |= (
+	GDK_EXPOSURE_MASK |
+	    GDK_BUTTON_PRESS_MASK |
+	    GDK_BUTTON_RELEASE_MASK |
+	    GDK_KEY_PRESS_MASK |
+	    GDK_POINTER_MOTION_MASK |
+	    GDK_POINTER_MOTION_HINT_MASK);
 
-	    if (!gtk_sheet_clip_text(sheet))  /* text extends multiple cells */
-	    {
-		for (i = col - 1; i >= MIN_VIEW_COLUMN(sheet); i--)
-		{
-		    GtkSheetColumn *cpi = COLPTR(sheet, i);
+    attributes_mask = GDK_WA_X | GDK_WA_Y |
+	    GDK_WA_VISUAL | GDK_WA_COLORMAP | GDK_WA_CURSOR;
 
-		    if (i < 0 || i > sheet->maxcol)
-			break;
+    attributes.cursor = gdk_cursor_new(GDK_TOP_LEFT_ARROW);
 
-		    if (!GTK_SHEET_COLUMN_IS_VISIBLE(cpi))
-			continue;
-		    if (gtk_sheet_cell_get_text(sheet, row, i))
-			break;
-		    if (size >= text_width + CELLOFFSET)
-			break;
+    /* main window */
+    gtk_widget_set_window(widget,
+	gdk_window_new(gtk_widget_get_parent_window(widget),
+	    &attributes, attributes_mask));
 
-		    size += cpi->width;  /* extend to left */
+    gdk_window_set_user_data(gtk_widget_get_window(widget), sheet);
 
-#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
-		    /* note: this column draws text on cpi */
-		    cpi->right_text_column = MAX(col, cpi->right_text_column);
-#if GTK_SHEET_DEBUG_DRAW > 0
-		    g_debug("_cell_draw_label: right_text_column %d = %d",
-			i, cpi->right_text_column);
-#endif
-#endif
-		}
-		area.width = size;  /* extend clip area */
-	    }
-	    area.x -= size;  /* shift left */
-	    xoffset += area.width - text_width - 2 * CELLOFFSET - attributes.border.width / 2;
-	    break;
+    gtk_widget_set_style(widget,
+	gtk_style_attach(gtk_widget_get_style(widget),
+	    gtk_widget_get_window(widget)));
 
-	case GTK_JUSTIFY_CENTER:
-	    sizel = sizer = area.width / 2;  /* start with half col size*/
-	    area.x += area.width / 2;  /* anchor clip_area at center */
+    gtk_style_set_background(gtk_widget_get_style(widget),
+	gtk_widget_get_window(widget),
+	GTK_STATE_NORMAL);
 
-	    if (!gtk_sheet_clip_text(sheet))  /* text extends multiple cells */
-	    {
-		for (i = col + 1; i <= MAX_VIEW_COLUMN(sheet) && i <= sheet->maxcol; i++)
-		{
-		    GtkSheetColumn *cpi = COLPTR(sheet, i);
+    attributes.x = 0;
+    if (sheet->row_titles_visible)
+	attributes.x = sheet->row_title_area.width;
+    attributes.y = 0;
+    attributes.width = sheet->column_title_area.width;
+    attributes.height = sheet->column_title_area.height;
 
-		    if (!GTK_SHEET_COLUMN_IS_VISIBLE(cpi))
-			continue;
-		    if (gtk_sheet_cell_get_text(sheet, row, i))
-			break;
-		    if (sizer >= text_width / 2)
-			break;
+    /* column-title window */
+    sheet->column_title_window = gdk_window_new(
+	gtk_widget_get_window(widget),
+	&attributes, attributes_mask);
+    gdk_window_set_user_data(sheet->column_title_window, sheet);
+    gtk_style_set_background(gtk_widget_get_style(widget),
+	sheet->column_title_window, GTK_STATE_NORMAL);
 
-		    sizer += cpi->width;  /* extend to right */
+    attributes.x = 0;
+    attributes.y = 0;
+    if (sheet->column_titles_visible)
+	attributes.y = sheet->column_title_area.height;
+    attributes.width = sheet->row_title_area.width;
+    attributes.height = sheet->row_title_area.height;
 
-#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
-		    /* note: this column draws text on cpi */
-		    cpi->left_text_column = MIN(col, cpi->left_text_column);
-#if GTK_SHEET_DEBUG_DRAW > 0
-		    g_debug("_cell_draw_label: left_text_column %d = %d",
-			i, cpi->left_text_column);
-#endif
-#endif
-		}
-		for (i = col - 1; i >= MIN_VIEW_COLUMN(sheet); i--)
-		{
-		    GtkSheetColumn *cpi = COLPTR(sheet, i);
+    /* row-title window */
+    sheet->row_title_window = gdk_window_new(
+	gtk_widget_get_window(widget),
+	&attributes, attributes_mask);
+    gdk_window_set_user_data(sheet->row_title_window, sheet);
+    gtk_style_set_background(gtk_widget_get_style(widget),
+	sheet->row_title_window, GTK_STATE_NORMAL);
 
-		    if (i < 0 || i > sheet->maxcol)
-			break;
+    /* sheet-window */
+    attributes.cursor = gdk_cursor_new(GDK_PLUS);
 
-		    if (!GTK_SHEET_COLUMN_IS_VISIBLE(cpi))
-			continue;
-		    if (gtk_sheet_cell_get_text(sheet, row, i))
-			break;
-		    if (sizel >= text_width / 2)
-			break;
+    attributes.x = 0;
+    attributes.y = 0;
+    attributes.width = sheet->sheet_window_width;
+    attributes.height = sheet->sheet_window_height;
 
-		    sizel += cpi->width;  /* extend to left */
+    sheet->sheet_window = gdk_window_new(
+	gtk_widget_get_window(widget),
+	&attributes, attributes_mask);
+    gdk_window_set_user_data(sheet->sheet_window, sheet);
 
-#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
-		    /* note: this column draws text on cpi */
-		    cpi->right_text_column = MAX(col, cpi->right_text_column);
-#if GTK_SHEET_DEBUG_DRAW > 0
-		    g_debug("_cell_draw_label: right_text_column %d = %d",
-			i, cpi->right_text_column);
-#endif
-#endif
-		}
-		area.width = sizel + sizer;  /* extend clip area */
-	    }
-	    area.x -= sizel;  /* shift left */
-	    xoffset += sizel - text_width / 2 - CELLOFFSET;
-	    break;
+    gdk_window_set_background(sheet->sheet_window,
+	&(gtk_widget_get_style(widget)->white));
+    gdk_window_show(sheet->sheet_window);
 
-	case GTK_JUSTIFY_LEFT:
-	default:
-	    size = area.width;  /* start with col size, anchor at left */
+    /* backing_pixmap */
+    gtk_sheet_make_backing_pixmap(sheet, 0, 0);
 
-	    if (!gtk_sheet_clip_text(sheet))  /* text extends multiple cells */
-	    {
-		for (i = col + 1; i <= MAX_VIEW_COLUMN(sheet) && i <= sheet->maxcol; i++)
-		{
-		    GtkSheetColumn *cpi = COLPTR(sheet, i);
+    /* GCs */
+    if (sheet->fg_gc)
+	gdk_gc_unref(sheet->fg_gc);
+    sheet->fg_gc = gdk_gc_new(gtk_widget_get_window(widget));
 
-		    if (!GTK_SHEET_COLUMN_IS_VISIBLE(cpi))
-			continue;
-		    if (gtk_sheet_cell_get_text(sheet, row, i))
-			break;
-		    if (size >= text_width + CELLOFFSET)
-			break;
+    if (sheet->bg_gc)
+	gdk_gc_unref(sheet->bg_gc);
+    sheet->bg_gc = gdk_gc_new(gtk_widget_get_window(widget));
 
-		    size += cpi->width;  /* extend to right */
+    colormap = gtk_widget_get_colormap(widget);
 
-#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
-		    /* note: this column draws text on cpi */
-		    cpi->left_text_column = MIN(col, cpi->left_text_column);
-#if GTK_SHEET_DEBUG_DRAW > 0
-		    g_debug("_cell_draw_label: left_text_column %d = %d",
-			i, cpi->left_text_column);
-#endif
-#endif
-		}
-		area.width = size;  /* extend clip area */
-	    }
-	    xoffset += attributes.border.width / 2;
-	    break;
-    }
+    gdk_color_white(colormap, &(gtk_widget_get_style(widget)->white));
+    gdk_color_black(colormap, &(gtk_widget_get_style(widget)->black));
 
-    if (!gtk_sheet_clip_text(sheet))  /* text extends multiple cells */
-	clip_area = area;
-    gdk_gc_set_clip_rectangle(gc, &clip_area);
+    gdk_gc_get_values(sheet->fg_gc, &auxvalues);
 
-#if GTK_SHEET_DEBUG_DRAW_LABEL>0
-#if 0
-    g_debug("_cell_draw_label(%d,%d): clip x %d y %d w %d h %d",
-	    row, col,
-	    clip_area.x, clip_area.y, clip_area.width, clip_area.height);
-#endif
-#endif
+    values.foreground = gtk_widget_get_style(widget)->white;
+    values.function = GDK_INVERT;
+    values.subwindow_mode = GDK_INCLUDE_INFERIORS;
 
+    if (sheet->xor_gc)
+	gdk_gc_unref(sheet->xor_gc);
+    sheet->xor_gc = gdk_gc_new_with_values(gtk_widget_get_window(widget),
+	&values,
+	GDK_GC_FOREGROUND |
+	    GDK_GC_FUNCTION |
+	    GDK_GC_SUBWINDOW);
 
-#if GTK_SHEET_DEBUG_DRAW_LABEL>0
-#if 1
-    g_debug("_cell_draw_label(%d,%d): x %d y %d fg %s bg %s",
-	row, col,
-	area.x + xoffset + CELLOFFSET, y,
-	gdk_color_to_string(&attributes.foreground),
-	gdk_color_to_string(&attributes.background)
-	);
-#endif
-#endif
+    if (gtk_widget_get_parent(sheet->sheet_entry))
+    {
+	g_object_ref(sheet->sheet_entry);
+	gtk_widget_unparent(sheet->sheet_entry);
+    }
+    gtk_widget_set_parent_window(sheet->sheet_entry, sheet->sheet_window);
+    gtk_widget_set_parent(sheet->sheet_entry, GTK_WIDGET(sheet));
 
-    gdk_draw_layout(sheet->pixmap, gc,
-	area.x + xoffset + CELLOFFSET, y,
-	layout);
+    if (sheet->button && gtk_widget_get_parent(sheet->button))
+    {
+	g_object_ref(sheet->button);
+	gtk_widget_unparent(sheet->button);
+    }
+    gtk_widget_set_parent_window(sheet->button, sheet->sheet_window);
+    gtk_widget_set_parent(sheet->button, GTK_WIDGET(sheet));
 
-    g_object_unref(G_OBJECT(layout));
+/*
+  gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
+*/
 
-    /* copy sheet->pixmap to window */
+    if (!sheet->cursor_drag)
+	sheet->cursor_drag = gdk_cursor_new(GDK_PLUS);
 
-    gdk_draw_pixmap(sheet->sheet_window,
-	gc,
-	sheet->pixmap,
-	area.x, area.y,
-	area.x, area.y,
-	area.width, area.height);
+    if (sheet->column_titles_visible)
+	gdk_window_show(sheet->column_title_window);
+    if (sheet->row_titles_visible)
+	gdk_window_show(sheet->row_title_window);
 
-    gdk_gc_set_clip_rectangle(gc, NULL);
-}
+    size_allocate_row_title_buttons(sheet);
+    _gtk_sheet_column_buttons_size_allocate(sheet);
 
+    if (sheet->title)  /* re-initialize title to update GUI */
+    {
+	gchar *existing_title = g_strdup(sheet->title);
+	gtk_sheet_set_title(sheet, existing_title);
+	g_free(existing_title);
+    }
 
+    children = sheet->children;
+    while (children)
+    {
+	child = children->data;
+	children = children->next;
 
-/**
- * _gtk_sheet_range_draw:
- * @sheet:  the #GtkSheet
- * @range:  the #GtkSheetRange or NULL
- * @activate_active_cell: TRUE to activate active cell after 
- *                      drawing
+	gtk_sheet_realize_child(sheet, child);
+    }
+}
+
+/*
+ * global_button_clicked_handler:
+ * this is the #GtkSheet global sheet button "button-press-event" handler. 
  *  
- * draw visible part of range. 
- * If @range == NULL then draw the whole screen.
+ * It will handle single-clicks of button 1 internally, selecting/deselecting 
+ * all sheet cells. All other button press events are propagated to the sheet. 
+ *  
+ * You cann connect your own "button-press-event" handler to the sheet 
+ * widget, and will receive all non-internally handled button-press-events.
+ * 
+ * @param widget the global sheet button that received the signal 
+ * @param event  the GdkEventButton which triggered this signal
+ * @param data   the #GtkSheet passed on signal connection 
  *  
+ * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
  */
-void
-_gtk_sheet_range_draw(GtkSheet *sheet,
-    const GtkSheetRange *range,
-    gboolean activate_active_cell)
+static gboolean
+global_button_press_handler(GtkWidget *widget,
+    GdkEventButton *event,
+    gpointer data)
 {
-    gint row, col;
-    GtkSheetRange drawing_range;
-    GdkRectangle area;
-
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_SHEET(sheet));
-
-#if GTK_SHEET_DEBUG_DRAW > 0
-    g_debug("_gtk_sheet_range_draw: called");
-#endif
-
-    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
-	return;
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
-    if (!gtk_widget_get_mapped(GTK_WIDGET(sheet)))
-	return;
+    gboolean veto;
+    GtkSheet *sheet = GTK_SHEET(data);
+    gboolean retval = FALSE;
 
-    if (range)
+    if (!retval
+	&& (event->type == GDK_BUTTON_PRESS)
+	&& (event->button == 1))
     {
-	drawing_range.row0 = MAX(range->row0, MIN_VIEW_ROW(sheet));
-	drawing_range.rowi = MIN(range->rowi, MAX_VIEW_ROW(sheet));
-	drawing_range.col0 = MAX(range->col0, MIN_VIEW_COLUMN(sheet));
-	drawing_range.coli = MIN(range->coli, MAX_VIEW_COLUMN(sheet));
+	gtk_sheet_click_cell(sheet, -1, -1, &veto);
+	gtk_widget_grab_focus(GTK_WIDGET(sheet));
     }
     else
     {
-	drawing_range.row0 = MIN_VIEW_ROW(sheet);
-	drawing_range.rowi = MAX_VIEW_ROW(sheet);
-	drawing_range.col0 = MIN_VIEW_COLUMN(sheet);
-	drawing_range.coli = MAX_VIEW_COLUMN(sheet);
-    }
+	g_signal_emit_by_name(GTK_WIDGET(sheet), 
+	    "button_press_event", 
+	    event,
+	    &retval);
+    }
 
-#if GTK_SHEET_DEBUG_DRAW > 0
-    g_debug("_gtk_sheet_range_draw: row %d - %d col %d - %d",
-	drawing_range.row0, drawing_range.rowi, drawing_range.col0, drawing_range.coli);
-#endif
+    return(retval);
+}
 
-    if (drawing_range.row0 > drawing_range.rowi)
+static void
+create_global_button(GtkSheet *sheet)
+{
+    sheet->button = gtk_button_new_with_label(" ");
+
+    g_signal_connect(GTK_OBJECT(sheet->button),
+	"button-press-event",
+	G_CALLBACK(global_button_press_handler),
+	(gpointer)sheet);
+}
+
+static void
+size_allocate_global_button(GtkSheet *sheet)
+{
+    GtkAllocation allocation;
+
+    if (!sheet->column_titles_visible)
 	return;
-    if (drawing_range.col0 > drawing_range.coli)
+    if (!sheet->row_titles_visible)
 	return;
 
-/*  
-   gdk_draw_rectangle (sheet->pixmap,
-       GTK_WIDGET(sheet)->style->white_gc,
-       TRUE,
-       0,0,
-       sheet->sheet_window_width,sheet->sheet_window_height);
-*/
+    gtk_widget_size_request(sheet->button, NULL);
 
-    /* clear outer area beyond rightmost column */
-    if (drawing_range.coli >= MAX_VIEW_COLUMN(sheet))
-    {
-	gint maxcol = MAX_VIEW_COLUMN(sheet);  /* might not be visible */
+    allocation.x = 0;
+    allocation.y = 0;
+    allocation.width = sheet->row_title_area.width;
+    allocation.height = sheet->column_title_area.height;
 
-	if (maxcol > sheet->maxcol)
-	    maxcol = sheet->maxcol;
+    gtk_widget_size_allocate(sheet->button, &allocation);
+    gtk_widget_show(sheet->button);
+}
 
-	while (maxcol >= 0
-	    && !GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, maxcol))) --maxcol;
 
-	if (maxcol >= 0)
-	{
-	    area.x = _gtk_sheet_column_left_xpixel(sheet, maxcol) +
-		COLPTR(sheet, maxcol)->width;
-	}
-	else
-	{
-	    area.x = sheet->hoffset;
-	    if (sheet->row_titles_visible)
-		area.x += sheet->row_title_area.width;
-	}
-	area.width = sheet->sheet_window_width - area.x;
-	area.y = 0;
-	area.height = sheet->sheet_window_height;
+/*
+ * gtk_sheet_unrealize_handler:
+ * 
+ * this is the #GtkSheet widget class "unrealize" signal handler
+ * 
+ * @param widget the #GtkSheet
+ */
+static void
+gtk_sheet_unrealize_handler(GtkWidget *widget)
+{
+    GtkSheet *sheet;
 
-	if (area.width > 0) /* beware, rightmost column might be partially visible */
-	{
-#if 0
-	    gdk_gc_set_foreground(sheet->fg_gc, &sheet->bg_color);
-#else
-	    gdk_gc_set_foreground(sheet->fg_gc,
-		&gtk_widget_get_style(GTK_WIDGET(sheet))->bg[GTK_STATE_NORMAL]);
-#endif
+    g_return_if_fail(widget != NULL);
+    g_return_if_fail(GTK_IS_SHEET(widget));
 
-	    gdk_draw_rectangle(sheet->pixmap,
-		sheet->fg_gc,
-		TRUE,  /* filled */
-		area.x, area.y,
-		area.width, area.height);
+    sheet = GTK_SHEET(widget);
 
-	    gdk_draw_pixmap(sheet->sheet_window,
-		gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-		sheet->pixmap,
-		area.x, area.y,
-		area.x, area.y,
-		area.width, area.height);
-	}
+    /* nothing left to draw on */
+    if (sheet->dirty_idle)
+    {
+	g_source_remove(sheet->dirty_idle);
+	sheet->dirty_idle = 0;
     }
+    g_array_set_size(sheet->dirty_ranges, 0);
+    _gtk_sheet_tile_cache_invalidate(sheet, NULL);
 
-    /* clear outer area beyond last row */
-    if (drawing_range.rowi >= MAX_VIEW_ROW(sheet))
-    {
-	gint maxrow = MAX_VIEW_ROW(sheet);  /* might not be visible */
+    gdk_cursor_destroy(sheet->cursor_drag);
 
-	if (maxrow > sheet->maxrow)
-	    maxrow = sheet->maxrow;
+    gdk_gc_destroy(sheet->xor_gc);
+    gdk_gc_destroy(sheet->fg_gc);
+    gdk_gc_destroy(sheet->bg_gc);
 
-	while (maxrow >= 0
-	    && !GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, maxrow))) --maxrow;
+    gdk_window_destroy(sheet->sheet_window);
+    gdk_window_destroy(sheet->column_title_window);
+    gdk_window_destroy(sheet->row_title_window);
 
-	area.x = 0;
-	area.width = sheet->sheet_window_width;
+    if (sheet->pixmap)
+    {
+	g_object_unref(G_OBJECT(sheet->pixmap));
+	sheet->pixmap = NULL;
+    }
 
-	if (maxrow >= 0)
-	{
-	    area.y = _gtk_sheet_row_top_ypixel(sheet, maxrow) +
-		ROWPTR(sheet, maxrow)->height;
-	}
-	else
-	{
-	    area.y = sheet->voffset;
-	    if (sheet->column_titles_visible)
-		area.y += sheet->column_title_area.height;
-	}
-	area.height = sheet->sheet_window_height - area.y;
+    sheet->column_title_window = NULL;
+    sheet->sheet_window = NULL;
+    sheet->cursor_drag = NULL;
+    sheet->xor_gc = NULL;
+    sheet->fg_gc = NULL;
+    sheet->bg_gc = NULL;
 
-	if (area.height > 0) /* beware, last row might be partially visible */
-	{
-#if 0
-	    gdk_gc_set_foreground(sheet->fg_gc, &sheet->bg_color);
-#else
-	    gdk_gc_set_foreground(sheet->fg_gc,
-		&gtk_widget_get_style(GTK_WIDGET(sheet))->bg[GTK_STATE_NORMAL]);
-#endif
+    if (GTK_WIDGET_CLASS(sheet_parent_class)->unrealize)
+	(*GTK_WIDGET_CLASS(sheet_parent_class)->unrealize)(widget);
+}
 
-	    gdk_draw_rectangle(sheet->pixmap,
-		sheet->fg_gc,
-		TRUE,  /* filled */
-		area.x, area.y,
-		area.width, area.height);
+/*
+ * gtk_sheet_map_handler:
+ * 
+ * this is the #GtkSheet widget class "map" signal handler
+ * 
+ * @param widget the #GtkSheet
+ */
+static void
+gtk_sheet_map_handler(GtkWidget *widget)
+{
+    GtkSheet *sheet;
+    GtkWidget *WdChild;
+    GtkSheetChild *child;
+    GList *children;
 
-	    gdk_draw_pixmap(sheet->sheet_window,
-		gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-		sheet->pixmap,
-		area.x, area.y,
-		area.x, area.y,
-		area.width, area.height);
-	}
-    }
+    g_return_if_fail(widget != NULL);
+    g_return_if_fail(GTK_IS_SHEET(widget));
 
-    /* extend the drawing range to include all text sources */
+    sheet = GTK_SHEET(widget);
 
-    if (drawing_range.col0 < 0)
-	drawing_range.col0 = 0;
-    if (drawing_range.col0 > sheet->maxcol)
-	drawing_range.col0 = sheet->maxcol;
-    if (drawing_range.coli < 0)
-	drawing_range.coli = 0;
-    if (drawing_range.coli > sheet->maxcol)
-	drawing_range.coli = sheet->maxcol;
+#if GTK_SHEET_DEBUG_EXPOSE > 0
+    g_debug("gtk_sheet_map_handler: called");
+#endif
 
-    if (!gtk_sheet_clip_text(sheet))  /* text extends multiple cells */
+    if (!gtk_widget_get_mapped(widget))
     {
-	drawing_range.col0 = MIN_VIEW_COLUMN(sheet);
-	drawing_range.coli = MAX_VIEW_COLUMN(sheet);
+	gtk_widget_set_mapped_true(GTK_WIDGET(widget));
 
-#if GTK_SHEET_DEBUG_DRAW > 0
-    g_debug("_gtk_sheet_range_draw: extended: row %d - %d col %d - %d",
-	drawing_range.row0, drawing_range.rowi, drawing_range.col0, drawing_range.coli);
-#endif
-    }
+	if (!sheet->cursor_drag)
+	    sheet->cursor_drag = gdk_cursor_new(GDK_PLUS);
 
-    /* draw grid and cells */
-    for (row = drawing_range.row0; row <= drawing_range.rowi; row++)
-    {
-	for (col = drawing_range.col0; col <= drawing_range.coli; col++)
+	gdk_window_show(gtk_widget_get_window(widget));
+	gdk_window_show(sheet->sheet_window);
+
+	if (sheet->column_titles_visible)
 	{
-	    _cell_draw_background(sheet, row, col);
+	    _gtk_sheet_column_buttons_size_allocate(sheet);
+	    gdk_window_show(sheet->column_title_window);
 	}
-    }
 
-    for (row = drawing_range.row0; row <= drawing_range.rowi; row++)
-    {
-	for (col = drawing_range.col0; col <= drawing_range.coli; col++)
+	if (sheet->row_titles_visible)
 	{
-	    _cell_draw_border(sheet, row - 1, col, GTK_SHEET_BOTTOM_BORDER);
-	    _cell_draw_border(sheet, row + 1, col, GTK_SHEET_TOP_BORDER);
-	    _cell_draw_border(sheet, row, col - 1, GTK_SHEET_RIGHT_BORDER);
-	    _cell_draw_border(sheet, row, col + 1, GTK_SHEET_LEFT_BORDER);
-	    _cell_draw_border(sheet, row, col, 15);
+	    size_allocate_row_title_buttons(sheet);
+	    gdk_window_show(sheet->row_title_window);
 	}
-    }
-
-    /* draw text within range (1) */
 
-#if GTK_SHEET_DEBUG_DRAW > 0
-    g_debug("_gtk_sheet_range_draw: (1) row %d - %d col %d - %d",
-	drawing_range.row0, drawing_range.rowi,
-	drawing_range.col0, drawing_range.coli);
+#if 0
+	/* this will be done by gtk_sheet_activate_cell() below,
+	   it causes trouble when there is no active cell in the sheet,
+	   because sheet_entry will start to process events */
+	if (!gtk_widget_get_mapped (sheet->sheet_entry))
+	{
+	    gtk_widget_show (sheet->sheet_entry);
+	    gtk_widget_map (sheet->sheet_entry);
+	}
 #endif
 
-    for (row = drawing_range.row0; row <= drawing_range.rowi; row++)
-    {
-	for (col = drawing_range.col0; col <= drawing_range.coli; col++)
+	if (gtk_widget_get_visible(sheet->button) &&
+	    !gtk_widget_get_mapped(sheet->button))
 	{
-	    if (row <= sheet->maxallocrow && col <= sheet->maxalloccol &&
-		sheet->data[row] && sheet->data[row][col])
-	    {
-		_cell_draw_label(sheet, row, col);
-	    }
+	    gtk_widget_show(sheet->button);
+	    gtk_widget_map(sheet->button);
 	}
-    }
-#if 0
-    /* draw text left outside range (2) */
-
-    if (0 <= drawing_range.col0 && drawing_range.col0 <= sheet->maxcol)
-    {
-#if GTK_SHEET_DEBUG_DRAW > 0
-	g_debug("_gtk_sheet_range_draw: (2) row %d - %d col %d - %d",
-	    drawing_range.row0, drawing_range.rowi,
-	    COLPTR(sheet, drawing_range.col0)->left_text_column, drawing_range.col0 - 1);
-#endif
 
-	for (row = drawing_range.row0; row <= drawing_range.rowi; row++)
+	if ((WdChild = gtk_bin_get_child(GTK_BIN(sheet->button))))
 	{
-	    for (col = COLPTR(sheet, drawing_range.col0)->left_text_column;
-		col < drawing_range.col0; col++)
+	    if (gtk_widget_get_visible(WdChild) &&
+		!gtk_widget_get_mapped(WdChild))
 	    {
-#if GTK_SHEET_DEBUG_DRAW > 0
-		g_debug("_gtk_sheet_range_draw: (2) %d %d", row, col);
-#endif
-		if (row <= sheet->maxallocrow && col <= sheet->maxalloccol &&
-		    sheet->data[row] && sheet->data[row][col])
-		{
-		    _cell_draw_background(sheet, row, col);
-		    _cell_draw_label(sheet, row, col);
-		}
+		gtk_widget_map(WdChild);
 	    }
 	}
-    }
 
-    /* draw text right outside range (3) */
-
-    if (0 <= drawing_range.coli && drawing_range.coli <= sheet->maxcol)
-    {
-#if GTK_SHEET_DEBUG_DRAW > 0
-	g_debug("_gtk_sheet_range_draw: (3) row %d - %d col %d - %d",
-	    drawing_range.row0, drawing_range.rowi,
-	    drawing_range.coli + 1, COLPTR(sheet, drawing_range.coli)->right_text_column);
+#if GTK_SHEET_DEBUG_EXPOSE > 0
+	g_debug("gtk_sheet_map_handler: calling _gtk_sheet_range_draw");
 #endif
 
-	for (row = drawing_range.row0; row <= drawing_range.rowi; row++)
-	{
-	    for (col = drawing_range.coli + 1;
-		col <= COLPTR(sheet, drawing_range.coli)->right_text_column; col++)
-	    {
-#if GTK_SHEET_DEBUG_DRAW > 0
-		g_debug("_gtk_sheet_range_draw: (3) %d %d", row, col);
-#endif
-		_cell_draw_background(sheet, row, col);
+	_gtk_sheet_recalc_view_range(sheet);
+	_gtk_sheet_range_draw(sheet, NULL, TRUE);
 
-		if (row <= sheet->maxallocrow && col <= sheet->maxalloccol &&
-		    sheet->data[row] && sheet->data[row][col])
-		{
-		    _cell_draw_label(sheet, row, col);
-		}
-	    }
-	}
-    }
-#endif
-    gtk_sheet_draw_backing_pixmap(sheet, drawing_range);
+	/* this was already done above - why again?
+	gtk_sheet_activate_cell(sheet, 
+	    sheet->active_cell.row, 
+	    sheet->active_cell.col);
+	    */
 
-    if (sheet->state != GTK_SHEET_NORMAL &&
-	gtk_sheet_range_isvisible(sheet, sheet->range))
-    {
-	gtk_sheet_range_draw_selection(sheet, drawing_range);
-    }
+	children = sheet->children;
+	while (children)
+	{
+	    child = children->data;
+	    children = children->next;
 
-    if (activate_active_cell &&
-	sheet->state == GTK_STATE_NORMAL &&
-	sheet->active_cell.row >= drawing_range.row0 &&
-	sheet->active_cell.row <= drawing_range.rowi &&
-	sheet->active_cell.col >= drawing_range.col0 &&
-	sheet->active_cell.col <= drawing_range.coli)
-    {
-	gtk_sheet_show_active_cell(sheet);
+	    if (gtk_widget_get_visible(child->widget) &&
+		!gtk_widget_get_mapped(child->widget))
+	    {
+		gtk_widget_map(child->widget);
+		gtk_sheet_position_child(sheet, child);
+	    }
+	}
     }
 }
 
+/*
+ * gtk_sheet_unmap_handler:
+ * 
+ * this is the #GtkSheet widget class "unmap" signal handler
+ * 
+ * @param widget the #GtkSheet
+ */
 static void
-gtk_sheet_range_draw_selection(GtkSheet *sheet, GtkSheetRange range)
+gtk_sheet_unmap_handler(GtkWidget *widget)
 {
-    GdkRectangle area;
-    gint i, j;
-    GtkSheetRange aux;
+    GtkSheet *sheet;
+    GtkSheetChild *child;
+    GList *children;
 
-    if (range.col0 > sheet->range.coli || range.coli < sheet->range.col0 ||
-	range.row0 > sheet->range.rowi || range.rowi < sheet->range.row0)
-    {
-#if GTK_SHEET_DEBUG_SELECTION > 0
-	g_debug("gtk_sheet_range_draw_selection: range outside");
+    g_return_if_fail(widget != NULL);
+    g_return_if_fail(GTK_IS_SHEET(widget));
+
+    sheet = GTK_SHEET(widget);
+
+#if GTK_SHEET_DEBUG_DRAW > 0
+    g_debug("gtk_sheet_unmap: called");
 #endif
-	return;
-    }
 
-    if (!gtk_sheet_range_isvisible(sheet, range))
+    if (gtk_widget_get_mapped(widget))
     {
-#if GTK_SHEET_DEBUG_SELECTION > 0
-	g_debug("gtk_sheet_range_draw_selection: range invisible");
-#endif
-	return;
-    }
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
+	gtk_widget_set_mapped_false(GTK_WIDGET(widget));
 
-    aux = range;
+	gdk_window_hide(sheet->sheet_window);
 
-    range.col0 = MAX(sheet->range.col0, range.col0);
-    range.coli = MIN(sheet->range.coli, range.coli);
-    range.row0 = MAX(sheet->range.row0, range.row0);
-    range.rowi = MIN(sheet->range.rowi, range.rowi);
+	if (sheet->column_titles_visible)
+	    gdk_window_hide(sheet->column_title_window);
 
-    range.col0 = MAX(range.col0, MIN_VIEW_COLUMN(sheet));
-    range.coli = MIN(range.coli, MAX_VIEW_COLUMN(sheet));
-    range.row0 = MAX(range.row0, MIN_VIEW_ROW(sheet));
-    range.rowi = MIN(range.rowi, MAX_VIEW_ROW(sheet));
+	if (sheet->row_titles_visible)
+	    gdk_window_hide(sheet->row_title_window);
 
-#if GTK_SHEET_DEBUG_SELECTION > 0
-    g_debug("gtk_sheet_range_draw_selection: range r %d-%d c %d-%d",
-	range.row0, range.rowi, range.col0, range.coli);
-#endif
+	gdk_window_hide(gtk_widget_get_window(widget));
 
-    for (i = range.row0; i <= range.rowi; i++)
-    {
-	if (i > sheet->maxrow)
-	    break;
+	if (gtk_widget_get_mapped(sheet->sheet_entry))
+	    gtk_widget_unmap(sheet->sheet_entry);
 
-	for (j = range.col0; j <= range.coli; j++)
+	if (gtk_widget_get_mapped(sheet->button))
+	    gtk_widget_unmap(sheet->button);
+
+	children = sheet->children;
+	while (children)
 	{
-	    if (j > sheet->maxcol)
-		break;
+	    child = children->data;
+	    children = children->next;
 
-	    if (gtk_sheet_cell_get_state(sheet, i, j) == GTK_STATE_SELECTED &&
-		GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, j)) &&
-		GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, i)))
+	    if (gtk_widget_get_visible(child->widget) &&
+		gtk_widget_get_mapped(child->widget))
 	    {
-		row_button_set(sheet, i);
-		_gtk_sheet_column_button_set(sheet, j);
-
-		area.x = _gtk_sheet_column_left_xpixel(sheet, j);
-		area.y = _gtk_sheet_row_top_ypixel(sheet, i);
-		area.width = COLPTR(sheet, j)->width;
-		area.height = sheet->row[i].height;
-
-		if (i == sheet->range.row0)
-		{
-		    area.y = area.y + 2;
-		    area.height = area.height - 2;
-		}
-		if (i == sheet->range.rowi)
-		    area.height = area.height - 3;
-
-		if (j == sheet->range.col0)
-		{
-		    area.x = area.x + 2;
-		    area.width = area.width - 2;
-		}
-		if (j == sheet->range.coli)
-		    area.width = area.width - 3;
-
-		if (i != sheet->active_cell.row || j != sheet->active_cell.col)
-		{
-		    gdk_draw_rectangle(sheet->sheet_window,
-			sheet->xor_gc,
-			TRUE,
-			area.x + 1, area.y + 1,
-			area.width, area.height);
-		}
+		gtk_widget_unmap(child->widget);
 	    }
-
 	}
-    }
 
-    gtk_sheet_draw_border(sheet, sheet->range);
+    }
 }
 
+/*
+ * gtk_sheet_draw_tm - draw tooltip marker
+ * 
+ * @param sheet
+ */
 static void
-gtk_sheet_draw_backing_pixmap(GtkSheet *sheet, GtkSheetRange range)
+gtk_sheet_draw_tooltip_marker(GtkSheet *sheet,
+    GtkSheetArea area,
+    const gint row, const gint col)
 {
-    gint x, y, width, height;
-
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
-
-    x = _gtk_sheet_column_left_xpixel(sheet, range.col0);
-    y = _gtk_sheet_row_top_ypixel(sheet, range.row0);
-    width = _gtk_sheet_column_left_xpixel(sheet, range.coli) - x;
-    if (0 <= range.coli && range.coli <= sheet->maxcol)
-	width += COLPTR(sheet, range.coli)->width;
-    height = _gtk_sheet_row_top_ypixel(sheet, range.rowi) - y;
-    if (0 <= range.rowi && range.rowi <= sheet->maxrow)
-	height += sheet->row[range.rowi].height;
-
-    if (range.row0 == sheet->range.row0)
+    switch(area)
     {
-	y = y - 5;
-	height = height + 5;
-    }
-    if (range.rowi == sheet->range.rowi)
-	height = height + 5;
+	case ON_CELL_AREA:
+	    if (_gtk_sheet_cell_get(sheet, row, col))
+	    {
+		GtkSheetCell *cell = _gtk_sheet_cell_get(sheet, row, col);
 
-    if (range.col0 == sheet->range.col0)
-    {
-	x = x - 5;
-	width = width + 5;
-    }
-    if (range.coli == sheet->range.coli)
-	width = width + 5;
+		if (cell->tooltip_markup || cell->tooltip_text)
+		{
+		    GdkPoint p[3];
 
-    width = MIN(width, sheet->sheet_window_width - x);
-    height = MIN(height, sheet->sheet_window_height - y);
+		    gdk_gc_set_foreground(sheet->bg_gc, &sheet->tm_color);
 
-    x--;
-    y--;
-    width += 2;
-    height += 2;
+		    p[0].x = _gtk_sheet_column_left_xpixel(sheet, col) + COLPTR(sheet, col)->width
+			- GTK_SHEET_DEFAULT_TM_SIZE;
+		    p[0].y = _gtk_sheet_row_top_ypixel(sheet, row) + 1;
 
-    x = (sheet->row_titles_visible) ? MAX(x, sheet->row_title_area.width) : MAX(x, 0);
-    y = (sheet->column_titles_visible) ? MAX(y, sheet->column_title_area.height) : MAX(y, 0);
+		    p[1].x = p[0].x + GTK_SHEET_DEFAULT_TM_SIZE;
+		    p[1].y = p[0].y;
 
-    if (range.coli >= sheet->maxcol)
-	width = sheet->sheet_window_width - x;
-    if (range.rowi >= sheet->maxrow)
-	height = sheet->sheet_window_height - y;
+		    p[2].x = p[1].x;
+		    p[2].y = p[1].y + GTK_SHEET_DEFAULT_TM_SIZE;
 
-#if GTK_SHEET_DEBUG_EXPOSE > 0
-    g_debug("gtk_sheet_draw_backing_pixmap: x %d y %d w %d h %d",
-	x, y, width + 1, height + 1);
-#endif
+		    /* draw cell tooltip marker */
+		    gdk_draw_polygon(sheet->pixmap,
+			sheet->bg_gc,
+			TRUE, p, 3);
+		}
+	    }
+	    break;
 
-    gdk_draw_pixmap(sheet->sheet_window,
-	gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-	sheet->pixmap,
-	x, y,
-	x, y,
-	width + 1,
-	height + 1);
-}
+	case ON_ROW_TITLES_AREA:
+	    if (0 <= row && row <= sheet->maxrow)
+	    {
+		GtkSheetRow *rowp = _gtk_sheet_row_peek(sheet, row);
+		GdkWindow *window = sheet->row_title_window;
 
-static inline void
-gtk_sheet_cell_init(GtkSheetCell *cell)
-{
-    cell->extent.x = cell->extent.y = 0;
-    cell->extent.width = cell->extent.height = 0;
+		if (rowp && (rowp->tooltip_markup || rowp->tooltip_text))
+		{
+		    GdkPoint p[3];
 
-    cell->row = cell->col = -1;
+		    gdk_gc_set_foreground(sheet->bg_gc, &sheet->tm_color);
 
-    cell->attributes = NULL;
-    cell->text = cell->link = NULL;
+		    p[0].x = sheet->row_title_area.width - 1
+			- GTK_SHEET_DEFAULT_TM_SIZE;
+		    p[0].y = _gtk_sheet_row_top_ypixel(sheet, row) + 1;
+		    if (sheet->column_titles_visible)
+			p[0].y -= sheet->column_title_area.height;
 
-    cell->tooltip_markup = cell->tooltip_text = NULL;
-}
+		    p[1].x = p[0].x + GTK_SHEET_DEFAULT_TM_SIZE;
+		    p[1].y = p[0].y;
 
-static void
-gtk_sheet_cell_finalize(GtkSheet *sheet, GtkSheetCell *cell)
-{
-    g_return_if_fail(cell != NULL);
+		    p[2].x = p[1].x;
+		    p[2].y = p[1].y + GTK_SHEET_DEFAULT_TM_SIZE;
 
-    if (cell->text)
-    {
-	g_free(cell->text);
-	cell->text = NULL;
+		    /* draw cell tooltip marker */
+		    gdk_draw_polygon(window,
+			sheet->bg_gc,
+			TRUE, p, 3);
+		}
+	    }
+	    break;
 
-	if (GTK_IS_OBJECT(sheet) && G_OBJECT(sheet)->ref_count > 0)
-	    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[CLEAR_CELL], 0,
-		cell->row, cell->col);
-    }
+	case ON_COLUMN_TITLES_AREA:
+	    if (0 <= col && col <= sheet->maxcol)
+	    {
+		GtkSheetColumn *column = COLPTR(sheet, col);
+		GdkWindow *window = sheet->column_title_window;
 
-    if (cell->link)
-    {
-	cell->link = NULL;
-    }
+		if (gtk_widget_get_has_tooltip(GTK_WIDGET(column)))
+		{
+		    GdkPoint p[3];
 
-    if (cell->tooltip_markup)
-    {
-	g_free(cell->tooltip_markup);
-	cell->tooltip_markup = NULL;
-    }
+		    gdk_gc_set_foreground(sheet->bg_gc, &sheet->tm_color);
 
-    if (cell->tooltip_text)
-    {
-	g_free(cell->tooltip_text);
-	cell->tooltip_text = NULL;
-    }
+		    p[0].x = _gtk_sheet_column_right_xpixel(sheet, col) + CELL_SPACING - 1
+			- GTK_SHEET_DEFAULT_TM_SIZE;
+		    if (sheet->row_titles_visible)
+			p[0].x -= sheet->row_title_area.width;
+		    p[0].y = 0;
 
-    if (cell->attributes)
-    {
-	GtkSheetCellAttr *attributes = cell->attributes;
+		    p[1].x = p[0].x + GTK_SHEET_DEFAULT_TM_SIZE;
+		    p[1].y = p[0].y;
 
-	if (attributes->font_desc && attributes->do_font_desc_free)
-	{
-	    pango_font_description_free(attributes->font_desc);  /* free */
-	    attributes->font_desc = NULL;
-	}
-	g_free(attributes);
+		    p[2].x = p[1].x;
+		    p[2].y = p[1].y + GTK_SHEET_DEFAULT_TM_SIZE;
+
+		    /* draw cell tooltip marker */
+		    gdk_draw_polygon(window,
+			sheet->bg_gc,
+			TRUE, p, 3);
+		}
+	    }
+	    break;
 
-	cell->attributes = NULL;
+	default:
+	    return;
     }
 }
 
-static GtkSheetCell *
-gtk_sheet_cell_new(void)
+static void
+_cell_draw_border(GtkSheet *sheet, gint row, gint col, gint mask)
 {
-    GtkSheetCell *cell = g_new(GtkSheetCell, 1);
-    gtk_sheet_cell_init(cell);
-    return (cell);
-}
+    GtkWidget *widget;
+    GdkGC * fg_gc, *bg_gc;
+    GdkRectangle area;
+    guint width;
 
-/**
- * gtk_sheet_set_cell_text:
- * @sheet: a #GtkSheet.
- * @row: row_number
- * @col: column number
- * @text: cell text
- *
- * Set cell contents and allocate memory if needed. No 
- * justifcation is made. attributes and links remain unchanged.
- */
-void
-gtk_sheet_set_cell_text(GtkSheet *sheet, gint row, gint col, const gchar *text)
-{
     g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (col > sheet->maxcol || row > sheet->maxrow)
+    /* bail now if we arn't drawable yet */
+    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
 	return;
-    if (col < 0 || row < 0)
+
+    if (row < 0 || row > sheet->maxrow)
+	return;
+    if (col < 0 || col > sheet->maxcol)
 	return;
+    if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
+	return;
+    if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	return;
+
+    widget = GTK_WIDGET(sheet);
 
     GtkSheetCellAttr attributes;
     gtk_sheet_get_attributes(sheet, row, col, &attributes);
-    gtk_sheet_set_cell(sheet, row, col, attributes.justification, text);
+
+    /* select GC for background rectangle */
+    gdk_gc_set_foreground(sheet->fg_gc, &attributes.border.color);
+    gdk_gc_set_foreground(sheet->bg_gc, &attributes.background);
+
+    fg_gc = sheet->fg_gc;
+    bg_gc = sheet->bg_gc;
+
+    area.x = _gtk_sheet_column_left_xpixel(sheet, col);
+    area.y = _gtk_sheet_row_top_ypixel(sheet, row);
+    area.width = COLPTR(sheet, col)->width;
+    area.height = ROW_HEIGHT(sheet, row);
+
+    width = attributes.border.width;
+    gdk_gc_set_line_attributes(sheet->fg_gc, attributes.border.width,
+	attributes.border.line_style,
+	attributes.border.cap_style,
+	attributes.border.join_style);
+    if (width > 0)
+    {
+
+	if (attributes.border.mask & GTK_SHEET_LEFT_BORDER & mask)
+	    gdk_draw_line(sheet->pixmap, sheet->fg_gc,
+		area.x, area.y - width / 2,
+		area.x, area.y + area.height + width / 2 + 1);
+
+	if (attributes.border.mask & GTK_SHEET_RIGHT_BORDER & mask)
+	    gdk_draw_line(sheet->pixmap, sheet->fg_gc,
+		area.x + area.width, area.y - width / 2,
+		area.x + area.width,
+		area.y + area.height + width / 2 + 1);
+
+	if (attributes.border.mask & GTK_SHEET_TOP_BORDER & mask)
+	    gdk_draw_line(sheet->pixmap, sheet->fg_gc,
+		area.x - width / 2, area.y,
+		area.x + area.width + width / 2 + 1,
+		area.y);
+
+	if (attributes.border.mask & GTK_SHEET_BOTTOM_BORDER & mask)
+	    gdk_draw_line(sheet->pixmap, sheet->fg_gc,
+		area.x - width / 2, area.y + area.height,
+		area.x + area.width + width / 2 + 1,
+		area.y + area.height);
+    }
+
 }
 
-/**
- * gtk_sheet_set_cell:
- * @sheet: a #GtkSheet.
- * @row: row_number
- * @col: column number
- * @justification: a #GtkJustification :GTK_JUSTIFY_LEFT, RIGHT, CENTER
- * @text: cell text
+
+/*
+ * cell layout cache
  *
- * Set cell contents and allocate memory if needed.
+ * Shaped PangoLayouts of cells drawn recently are retained, so that 
+ * redraws and scrolling do not shape the visible cells again. An 
+ * entry is revalidated against label, font and wrapping on every 
+ * use and reshaped when any of them changed. Entries outside the view 
+ * are swept when the cache is full.
  */
-void
-gtk_sheet_set_cell(GtkSheet *sheet, gint row, gint col,
-    GtkJustification justification,
-    const gchar *text)
+
+#define GTK_SHEET_LAYOUT_CACHE_SIZE  4096  /* max. retained layouts */
+
+typedef struct _GtkSheetLayoutEntry
 {
-    GtkSheetCell *cell;
+    gint row;                         /* key */
+    gint col;
+    PangoLayout *layout;
+    gchar *label;                     /* shaped text */
+    PangoFontDescription *font_desc;  /* shaped font, copy */
+    gint wrap_mode;
+    gint wrap_width;
+} GtkSheetLayoutEntry;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
-    if (col > sheet->maxcol || row > sheet->maxrow)
-	return;
-    if (col < 0 || row < 0)
-	return;
+struct _GtkSheetLayoutCache
+{
+    GHashTable *lookup;  /* (row, col) -> GtkSheetLayoutEntry */
+    guint hits;
+    guint misses;
+};
 
-#if GTK_SHEET_DEBUG_SET_CELL_TIMER > 0
-    GTimer *tm = g_timer_new();
-#endif
+static guint
+_gtk_sheet_layout_key_hash(gconstpointer k)
+{
+    const GtkSheetLayoutEntry *key = k;
 
-    CheckCellData(sheet, row, col);
+    return ((guint)key->row * 8191 + (guint)key->col);
+}
 
-#if 0 && GTK_SHEET_DEBUG_SET_CELL_TIMER > 0
-    g_debug("st1: %0.6f", g_timer_elapsed(tm, NULL));
+static gboolean
+_gtk_sheet_layout_key_equal(gconstpointer k1, gconstpointer k2)
+{
+    const GtkSheetLayoutEntry *a = k1;
+    const GtkSheetLayoutEntry *b = k2;
+
+    return (a->row == b->row && a->col == b->col);
+}
+
+static void
+_gtk_sheet_layout_entry_free(GtkSheetLayoutEntry *entry)
+{
+    g_object_unref(G_OBJECT(entry->layout));
+    if (entry->font_desc)
+	pango_font_description_free(entry->font_desc);
+    g_free(entry->label);
+    g_free(entry);
+}
+
+static GtkSheetLayoutCache *
+_gtk_sheet_layout_cache_new(void)
+{
+    GtkSheetLayoutCache *cache = g_new0(GtkSheetLayoutCache, 1);
+
+    cache->lookup = g_hash_table_new_full(
+	_gtk_sheet_layout_key_hash, _gtk_sheet_layout_key_equal,
+	NULL, (GDestroyNotify)_gtk_sheet_layout_entry_free);
+
+    return (cache);
+}
+
+static void
+_gtk_sheet_layout_cache_flush(GtkSheetLayoutCache *cache)
+{
+    g_hash_table_remove_all(cache->lookup);
+}
+
+static void
+_gtk_sheet_layout_cache_free(GtkSheetLayoutCache *cache)
+{
+#if GTK_SHEET_DEBUG_DRAW_LABEL > 0
+    g_debug("_gtk_sheet_layout_cache_free: %u hits %u misses %u entries",
+	cache->hits, cache->misses, g_hash_table_size(cache->lookup));
 #endif
 
-    cell = sheet->data[row][col];
+    g_hash_table_destroy(cache->lookup);
+    g_free(cache);
+}
 
-    GtkSheetCellAttr attributes;
-    gtk_sheet_get_attributes(sheet, row, col, &attributes);
-    attributes.justification = justification;
-    gtk_sheet_set_cell_attributes(sheet, row, col, attributes);
+/*
+ * _gtk_sheet_layout_cache_sweep - evict layouts of cells away from the view
+ * 
+ * keeps cells within half a view size around the current view
+ * 
+ * @param sheet
+ */
+static void
+_gtk_sheet_layout_cache_sweep(GtkSheet *sheet)
+{
+    GtkSheetLayoutCache *cache = sheet->layout_cache;
+    GtkSheetRange keep;
+    GHashTableIter iter;
+    gpointer key, value;
+    gint rmargin = (MAX_VIEW_ROW(sheet) - MIN_VIEW_ROW(sheet) + 1) / 2;
+    gint cmargin = (MAX_VIEW_COLUMN(sheet) - MIN_VIEW_COLUMN(sheet) + 1) / 2;
 
-    if (cell->text)
+    keep.row0 = MIN_VIEW_ROW(sheet) - rmargin;
+    keep.rowi = MAX_VIEW_ROW(sheet) + rmargin;
+    keep.col0 = MIN_VIEW_COLUMN(sheet) - cmargin;
+    keep.coli = MAX_VIEW_COLUMN(sheet) + cmargin;
+
+    g_hash_table_iter_init(&iter, cache->lookup);
+    while (g_hash_table_iter_next(&iter, &key, &value))
     {
-	g_free(cell->text);
-	cell->text = NULL;
+	GtkSheetLayoutEntry *entry = value;
+
+	if (!_POINT_IN_RANGE(entry->row, entry->col, &keep))
+	    g_hash_table_iter_remove(&iter);
     }
 
-    if (text)
+    if (g_hash_table_size(cache->lookup) >= GTK_SHEET_LAYOUT_CACHE_SIZE)
+	_gtk_sheet_layout_cache_flush(cache);  /* huge view */
+}
+
+/*
+ * _gtk_sheet_cell_layout - get the shaped layout of a cell label
+ * 
+ * @param sheet
+ * @param row, col
+ * @param label      text to be drawn
+ * @param font_desc  font
+ * @param colptr     the cell's column
+ * 
+ * @return the #PangoLayout, owned by the cache
+ */
+static PangoLayout *
+_gtk_sheet_cell_layout(GtkSheet *sheet, gint row, gint col,
+    const gchar *label, PangoFontDescription *font_desc,
+    GtkSheetColumn *colptr)
+{
+    GtkSheetLayoutCache *cache = sheet->layout_cache;
+    GtkSheetLayoutEntry key, *entry;
+    gint wrap_mode = GTK_WRAP_NONE;
+    gint wrap_width = -1;
+
+    if (!gtk_sheet_autoresize_columns(sheet) && colptr->wrap_mode != GTK_WRAP_NONE)
     {
-	gchar *dataformat = gtk_sheet_column_get_format(sheet, col);
+	wrap_mode = colptr->wrap_mode;
+	wrap_width = colptr->width;
+    }
 
-	if (dataformat)
-	    text = gtk_data_format_remove(text, dataformat);
+    key.row = row;
+    key.col = col;
+    entry = g_hash_table_lookup(cache->lookup, &key);
 
-#if GTK_SHEET_DEBUG_SET_CELL_TEXT > 0
-	g_debug("gtk_sheet_set_cell[%p]: r %d c %d ar %d ac %d <%s>", 
-	    sheet, row, col, sheet->active_cell.row, sheet->active_cell.col, text);
-#endif
+    if (entry
+	&& entry->wrap_mode == wrap_mode
+	&& entry->wrap_width == wrap_width
+	&& strcmp(entry->label, label) == 0
+	&& (entry->font_desc == font_desc
+	    || (entry->font_desc && font_desc
+		&& pango_font_description_equal(entry->font_desc, font_desc))))
+    {
+	cache->hits++;
+	return (entry->layout);
+    }
+    cache->misses++;
 
-	cell->text = g_strdup(text); 
+    if (!entry)
+    {
+	if (g_hash_table_size(cache->lookup) >= GTK_SHEET_LAYOUT_CACHE_SIZE)
+	    _gtk_sheet_layout_cache_sweep(sheet);
+
+	entry = g_new0(GtkSheetLayoutEntry, 1);
+	entry->row = row;
+	entry->col = col;
+	entry->layout = gtk_widget_create_pango_layout(GTK_WIDGET(sheet), NULL);
+
+	g_hash_table_insert(cache->lookup, entry, entry);
     }
-#if GTK_SHEET_DEBUG_SET_CELL_TEXT > 0
     else
-	g_debug("gtk_sheet_set_cell[%p]: r %d c %d ar %d ac %d NULL", 
-	    sheet, row, col, sheet->active_cell.row, sheet->active_cell.col);
-#endif
-
-#if 0 && GTK_SHEET_DEBUG_SET_CELL_TIMER > 0
-    g_debug("st2: %0.6f", g_timer_elapsed(tm, NULL));
-#endif
+    {
+	g_free(entry->label);
+	if (entry->font_desc)
+	    pango_font_description_free(entry->font_desc);
+    }
 
-    _gtk_sheet_update_extent(sheet, cell, row, col);
+    entry->label = g_strdup(label);
+    entry->font_desc = font_desc ? pango_font_description_copy(font_desc) : NULL;
+    entry->wrap_mode = wrap_mode;
+    entry->wrap_width = wrap_width;
 
-#if GTK_SHEET_DEBUG_SET_CELL_TIMER > 0
-    g_debug("st3: %0.6f", g_timer_elapsed(tm, NULL));
-#endif
+    pango_layout_set_text(entry->layout, label, -1);
+    pango_layout_set_font_description(entry->layout, font_desc);
 
-    if (attributes.is_visible)
+    switch(wrap_mode)
     {
-	gboolean need_draw = TRUE;
+	case GTK_WRAP_NONE: 
+	    pango_layout_set_width(entry->layout, -1);
+	    break;
 
-	/* PR#104553 - if sheet entry editor is active on the cell being modified,
-	   we need to update it's contents
-	   */
-	if (row == sheet->active_cell.row && col == sheet->active_cell.col)
-	{
-#if GTK_SHEET_DEBUG_SET_CELL_TEXT > 0
-	    g_debug("gtk_sheet_set_cell[%p]: update sheet entry", sheet);
-#endif
-	    gtk_sheet_set_entry_text(sheet, text);  /* PR#104553 */
-	}
+	case GTK_WRAP_CHAR:
+	    pango_layout_set_width(entry->layout, wrap_width * PANGO_SCALE);
+	    pango_layout_set_wrap(entry->layout, PANGO_WRAP_CHAR);
+	    break;
 
-	if (gtk_sheet_autoresize(sheet))  /* handle immediate resize */
-	{
-	    if (cell->text && cell->text[0])
-	    {
-		if (gtk_sheet_autoresize_columns(sheet))
-		{
-		    GtkSheetColumn *colptr = COLPTR(sheet, col);
-		    gint new_width = COLUMN_EXTENT_TO_WIDTH(colptr->max_extent_width);
-
-		    if (new_width != colptr->width)
-		    {
-#if GTK_SHEET_DEBUG_SIZE > 0
-			g_debug("gtk_sheet_set_cell[%d]: set col width %d", col, new_width);
-#endif
-			gtk_sheet_set_column_width(sheet, col, new_width);
-			GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_REDRAW_PENDING);
-			need_draw = FALSE;
-		    }
-		}
-
-		if (gtk_sheet_autoresize_rows(sheet))
-		{
-		    GtkSheetRow *rowptr = ROWPTR(sheet, row);
-		    gint new_height = ROW_EXTENT_TO_HEIGHT(rowptr->max_extent_height);
-
-		    if (new_height != rowptr->height)
-		    {
-#if GTK_SHEET_DEBUG_SIZE > 0
-			g_debug("gtk_sheet_set_cell[%d]: set row height %d", row, new_height);
-#endif
-			gtk_sheet_set_row_height(sheet, row, new_height);
-			GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_REDRAW_PENDING);
-			need_draw = FALSE;
-		    }
-		}
-	    }
-	}
-
-	if (need_draw)
-	{
-	    GtkSheetRange range;
-
-	    range.row0 = row;
-	    range.rowi = row;
-	    range.col0 = sheet->view.col0;
-	    range.coli = sheet->view.coli;
+	case GTK_WRAP_WORD:
+	    pango_layout_set_width(entry->layout, wrap_width * PANGO_SCALE);
+	    pango_layout_set_wrap(entry->layout, PANGO_WRAP_WORD);
+	    break;
 
-	    if (!GTK_SHEET_IS_FROZEN(sheet))
-		_gtk_sheet_range_draw(sheet, &range, TRUE);
-	}
+	case GTK_WRAP_WORD_CHAR:
+	    pango_layout_set_width(entry->layout, wrap_width * PANGO_SCALE);
+	    pango_layout_set_wrap(entry->layout, PANGO_WRAP_WORD_CHAR);
+	    break;
     }
-#if GTK_SHEET_DEBUG_SET_CELL_TIMER > 0
-    g_debug("st4: %0.6f", g_timer_elapsed(tm, NULL));
-#endif
 
-    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[CHANGED], 0, row, col);
-
-#if GTK_SHEET_DEBUG_SET_CELL_TIMER > 0
-    g_debug("st9: %0.6f", g_timer_elapsed(tm, NULL));
-    g_timer_destroy(tm);
-#endif
+    return (entry->layout);
 }
 
-/**
- * gtk_sheet_cell_clear:
- * @sheet: a #GtkSheet.
- * @row: row_number
- * @column: column number
- *
- * Clear cell contents.
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+#define TEXT_SPAN_PACK(left, right) \
+    GUINT_TO_POINTER(((guint)MIN(left, 0xFFFF) << 16) | (guint)MIN(right, 0xFFFF))
+#define TEXT_SPAN_LEFT(span)   ((gint)(GPOINTER_TO_UINT(span) >> 16))
+#define TEXT_SPAN_RIGHT(span)  ((gint)(GPOINTER_TO_UINT(span) & 0xFFFF))
+
+/*
+ * _gtk_sheet_text_span_record - remember the overflow of a label
+ * 
+ * keeps the columns covered by each overflowing label of a 
+ * column. When a label at the column's text spread shrinks or 
+ * goes away, the spread is recounted and the text column index 
+ * rebuilt before the next range is extended, see 
+ * _gtk_sheet_text_columns_rebuild(). Widening is noted in the 
+ * index directly by _cell_label_spread().
+ * 
+ * @param sheet
+ * @param row
+ * @param col
+ * @param left   columns covered left of the cell
+ * @param right  columns covered right of the cell
  */
-void
-gtk_sheet_cell_clear(GtkSheet *sheet, gint row, gint column)
+static void
+_gtk_sheet_text_span_record(GtkSheet *sheet, gint row, gint col,
+    gint left, gint right)
 {
-    GtkSheetRange range;
-
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    GtkSheetColumn *colptr;
+    gpointer span = NULL;
 
-    if (column > sheet->maxcol || row > sheet->maxrow)
+    if (col < 0 || col > sheet->maxcol)
 	return;
-    if (column > sheet->maxalloccol || row > sheet->maxallocrow)
+
+    colptr = COLPTR(sheet, col);
+
+    if (colptr->text_spans)
+	span = g_hash_table_lookup(colptr->text_spans, GINT_TO_POINTER(row));
+    else if (!left && !right)
 	return;
-    if (column < 0 || row < 0)
+
+    if (span == (left || right ? TEXT_SPAN_PACK(left, right) : NULL))
 	return;
 
-    range.row0 = row;
-    range.rowi = row;
-    range.col0 = sheet->view.col0;
-    range.coli = sheet->view.coli;
+    if (span
+	&& ((TEXT_SPAN_LEFT(span) > left
+	    && col - TEXT_SPAN_LEFT(span) <= colptr->left_text_spread)
+	|| (TEXT_SPAN_RIGHT(span) > right
+	    && col + TEXT_SPAN_RIGHT(span) >= colptr->right_text_spread)))
+    {
+	colptr->text_spread_dirty = TRUE;
+	sheet->text_spread_dirty = TRUE;
+    }
 
-    gtk_sheet_real_cell_clear(sheet, row, column, FALSE);
+    if (left || right)
+    {
+	if (!colptr->text_spans)
+	    colptr->text_spans = g_hash_table_new(g_direct_hash, g_direct_equal);
 
-    if (!GTK_SHEET_IS_FROZEN(sheet))
+	g_hash_table_insert(colptr->text_spans,
+	    GINT_TO_POINTER(row), TEXT_SPAN_PACK(left, right));
+
+	colptr->left_text_spread = MIN(col - left, colptr->left_text_spread);
+	colptr->right_text_spread = MAX(col + right, colptr->right_text_spread);
+    }
+    else
     {
-	_gtk_sheet_range_draw(sheet, &range, TRUE);
+	g_hash_table_remove(colptr->text_spans, GINT_TO_POINTER(row));
     }
 }
+#endif
 
-/**
- * gtk_sheet_cell_delete:
- * @sheet: a #GtkSheet.
- * @row: row_number
- * @column: column number
- *
- * Clear cell contents and remove links.
+/*
+ * _cell_label_spread - width covered by a cell label
+ * 
+ * widens the label area from its anchor into empty neighbour 
+ * columns until the text fits, unless text is clipped, and 
+ * records the text overflow into neighbour columns.
+ * 
+ * @param sheet
+ * @param row
+ * @param col
+ * @param justification the anchor: right edge, centre or left edge
+ * @param text_width    label width in pixels
+ * @param sizel         returns the width covered left of the anchor
+ * @param sizer         returns the width covered right of the anchor
  */
-void
-gtk_sheet_cell_delete(GtkSheet *sheet, gint row, gint column)
+static void
+_cell_label_spread(GtkSheet *sheet, gint row, gint col,
+    GtkJustification justification, gint text_width,
+    gint *sizel, gint *sizer)
 {
-    GtkSheetRange range;
+    gint i, width = COLPTR(sheet, col)->width;
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+    gint left = col, right = col;  /* columns covered by the label */
+#endif
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
-    if (column > sheet->maxcol || row > sheet->maxrow)
-	return;
-    if (column > sheet->maxalloccol || row > sheet->maxallocrow)
-	return;
-    if (column < 0 || row < 0)
-	return;
+    switch(justification)
+    {
+	case GTK_JUSTIFY_RIGHT:
+	    *sizel = width;  /* start with col size */
+	    *sizer = 0;
 
-    range.row0 = row;
-    range.rowi = row;
-    range.col0 = sheet->view.col0;
-    range.coli = sheet->view.coli;
+	    if (!gtk_sheet_clip_text(sheet))  /* text extends multiple cells */
+	    {
+		for (i = col - 1; i >= 0; i--)  /* beyond view, see text columns */
+		{
+		    GtkSheetColumn *cpi = COLPTR(sheet, i);
 
-    gtk_sheet_real_cell_clear(sheet, row, column, TRUE);
+		    if (i > sheet->maxcol)
+			break;
 
-    if (!GTK_SHEET_IS_FROZEN(sheet))
-	_gtk_sheet_range_draw(sheet, &range, TRUE);
-}
+		    if (!GTK_SHEET_COLUMN_IS_VISIBLE(cpi))
+			continue;
+		    if (gtk_sheet_cell_get_text(sheet, row, i))
+			break;
+		    if (*sizel >= text_width + CELLOFFSET)
+			break;
 
-static void
-gtk_sheet_real_cell_clear(GtkSheet *sheet,
-    gint row, gint column,
-    gboolean delete)
-{
-    GtkSheetCell *cell;
+		    *sizel += cpi->width;  /* extend to left */
 
-    if (row > sheet->maxallocrow || column > sheet->maxalloccol)
-	return;
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+		    /* note: this column draws text on cpi */
+		    cpi->right_text_column = MAX(col, cpi->right_text_column);
+		    left = i;
+#if GTK_SHEET_DEBUG_DRAW > 0
+		    g_debug("_cell_label_spread: right_text_column %d = %d",
+			i, cpi->right_text_column);
+#endif
+#endif
+		}
+	    }
+	    break;
 
-    if (!sheet->data[row])
-	return;
+	case GTK_JUSTIFY_CENTER:
+	    *sizel = *sizer = width / 2;  /* start with half col size*/
 
-    cell = sheet->data[row][column];
-    if (!cell)
-	return;
+	    if (!gtk_sheet_clip_text(sheet))  /* text extends multiple cells */
+	    {
+		for (i = col + 1; i <= sheet->maxcol; i++)  /* beyond view, see text columns */
+		{
+		    GtkSheetColumn *cpi = COLPTR(sheet, i);
 
-#if GTK_SHEET_DEBUG_SET_CELL_TEXT > 0
-	g_debug("gtk_sheet_real_cell_clear[%p]: r %d c %d ar %d ac %d <%s>", 
-                sheet, row, column, 
-                sheet->active_cell.row, sheet->active_cell.col, 
-                cell->text ? cell->text : "<NULL>");
+		    if (!GTK_SHEET_COLUMN_IS_VISIBLE(cpi))
+			continue;
+		    if (gtk_sheet_cell_get_text(sheet, row, i))
+			break;
+		    if (*sizer >= text_width / 2)
+			break;
+
+		    *sizer += cpi->width;  /* extend to right */
+
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+		    /* note: this column draws text on cpi */
+		    cpi->left_text_column = MIN(col, cpi->left_text_column);
+		    right = i;
+#if GTK_SHEET_DEBUG_DRAW > 0
+		    g_debug("_cell_label_spread: left_text_column %d = %d",
+			i, cpi->left_text_column);
+#endif
 #endif
+		}
+		for (i = col - 1; i >= 0; i--)  /* beyond view, see text columns */
+		{
+		    GtkSheetColumn *cpi = COLPTR(sheet, i);
 
+		    if (i > sheet->maxcol)
+			break;
 
-    if (cell->text)
-    {
-	g_free(cell->text);
-	cell->text = NULL;
+		    if (!GTK_SHEET_COLUMN_IS_VISIBLE(cpi))
+			continue;
+		    if (gtk_sheet_cell_get_text(sheet, row, i))
+			break;
+		    if (*sizel >= text_width / 2)
+			break;
 
-	if (GTK_IS_OBJECT(sheet) && G_OBJECT(sheet)->ref_count > 0)
-	    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[CLEAR_CELL], 0, row, column);
-    }
+		    *sizel += cpi->width;  /* extend to left */
 
-    if (cell->link)
-    {
-	cell->link = NULL;
-    }
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+		    /* note: this column draws text on cpi */
+		    cpi->right_text_column = MAX(col, cpi->right_text_column);
+		    left = i;
+#if GTK_SHEET_DEBUG_DRAW > 0
+		    g_debug("_cell_label_spread: right_text_column %d = %d",
+			i, cpi->right_text_column);
+#endif
+#endif
+		}
+	    }
+	    break;
 
-    if (cell->tooltip_markup)
-    {
-	g_free(cell->tooltip_markup);
-	cell->tooltip_markup = NULL;
-    }
+	case GTK_JUSTIFY_LEFT:
+	default:
+	    *sizel = 0;
+	    *sizer = width;  /* start with col size, anchor at left */
 
-    if (cell->tooltip_text)
-    {
-	g_free(cell->tooltip_text);
-	cell->tooltip_text = NULL;
-    }
+	    if (!gtk_sheet_clip_text(sheet))  /* text extends multiple cells */
+	    {
+		for (i = col + 1; i <= sheet->maxcol; i++)  /* beyond view, see text columns */
+		{
+		    GtkSheetColumn *cpi = COLPTR(sheet, i);
 
-    if (delete)
-    {
-	gtk_sheet_cell_finalize(sheet, cell);
+		    if (!GTK_SHEET_COLUMN_IS_VISIBLE(cpi))
+			continue;
+		    if (gtk_sheet_cell_get_text(sheet, row, i))
+			break;
+		    if (*sizer >= text_width + CELLOFFSET)
+			break;
 
-#if GTK_SHEET_DEBUG_ALLOCATION > 0
-	g_debug("gtk_sheet_real_cell_clear: freeing %d %d", row, column); 
-#endif
+		    *sizer += cpi->width;  /* extend to right */
 
-	g_free(cell);
-	sheet->data[row][column] = NULL;
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+		    /* note: this column draws text on cpi */
+		    cpi->left_text_column = MIN(col, cpi->left_text_column);
+		    right = i;
+#if GTK_SHEET_DEBUG_DRAW > 0
+		    g_debug("_cell_label_spread: left_text_column %d = %d",
+			i, cpi->left_text_column);
+#endif
+#endif
+		}
+	    }
+	    break;
     }
+
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+    _gtk_sheet_text_span_record(sheet, row, col, col - left, right - col);
+#endif
 }
 
-/**
- * gtk_sheet_range_clear:
- * @sheet: a #GtkSheet.
- * @range: a #GtkSheetRange
- *
- * Clear range contents. If range==NULL the whole sheet will be cleared.
+/*
+ * _cell_place_label - lay out a cell label
+ * 
+ * computes layout, origin and clip area of a cell label and 
+ * records the text overflow into neighbour columns. Shared by 
+ * all render paths.
+ * 
+ * @param sheet
+ * @param row
+ * @param col
+ * @param attributes returns the cell attributes
+ * @param clip_area  returns the area covered by the text
+ * @param text_x     returns the layout origin
+ * @param text_y
+ * 
+ * @return the layout, owned by the layout cache, or NULL when 
+ *         there is nothing to draw
  */
-void
-gtk_sheet_range_clear(GtkSheet *sheet, const GtkSheetRange *range)
+static PangoLayout *
+_cell_place_label(GtkSheet *sheet, gint row, gint col,
+    GtkSheetCellAttr *attributes, GdkRectangle *clip_area,
+    gint *text_x, gint *text_y)
 {
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    GdkRectangle area;
+    gint text_width, text_height, y;
+    gint xoffset = 0;
+    gint sizel, sizer;
+    PangoLayout *layout;
+    PangoRectangle rect;
+    const GtkSheetFontMetrics *fm;
+    gint ascent, descent, spacing, y_pos;
+    GtkSheetVerticalJustification vjust;
 
-    gtk_sheet_real_range_clear(sheet, range, FALSE);
-}
+    gchar * label, *dataformat;
 
-/**
- * gtk_sheet_range_delete:
- * @sheet: a #GtkSheet.
- * @range: a #GtkSheetRange
- *
- * Clear range contents and remove links.
- * FIXME:: if range==NULL whole sheet is deleted?
- */
-void
-gtk_sheet_range_delete(GtkSheet *sheet, const GtkSheetRange *range)
-{
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_return_val_if_fail(sheet != NULL, NULL);
 
-    gtk_sheet_real_range_clear(sheet, range, TRUE);
-}
+    /* bail now if we aren't drawable yet */
+    if (!GTK_WIDGET_DRAWABLE(sheet))
+	return (NULL);
 
-static void
-gtk_sheet_real_range_clear(GtkSheet *sheet, const GtkSheetRange *range,
-    gboolean delete)
-{
-    gint row, col;
-    GtkSheetRange clear;
+    label = gtk_sheet_cell_get_text(sheet, row, col);  /* model aware */
 
-    if (!range)
-    {
-	clear.row0 = 0;
-	clear.rowi = sheet->maxallocrow;
-	clear.col0 = 0;
-	clear.coli = sheet->maxalloccol;
-    }
-    else
+    if (!label)
     {
-	clear = *range;
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+	_gtk_sheet_text_span_record(sheet, row, col, 0, 0);
+#endif
+	return (NULL);
     }
 
-    clear.row0 = MAX(clear.row0, 0);
-    clear.col0 = MAX(clear.col0, 0);
-    clear.rowi = MIN(clear.rowi, sheet->maxallocrow);
-    clear.coli = MIN(clear.coli, sheet->maxalloccol);
+    if (row < 0 || row > sheet->maxrow)
+	return (NULL);
+    if (col < 0 || col > sheet->maxcol)
+	return (NULL);
+
+    /* bail now if we aren't drawable yet */
+    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
+	return (NULL);
+
+    GtkSheetColumn *colptr = COLPTR(sheet, col);
+
+    if (!GTK_SHEET_COLUMN_IS_VISIBLE(colptr))
+	return (NULL);
+    if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	return (NULL);
+
+    dataformat = gtk_sheet_column_get_format(sheet, col);
+
+    if (dataformat)
+	label = gtk_data_format(label, dataformat);
+
+    gtk_sheet_get_attributes(sheet, row, col, attributes);
+
+    area.x = _gtk_sheet_column_left_xpixel(sheet, col);
+    area.y = _gtk_sheet_row_top_ypixel(sheet, row);
+    area.width = colptr->width;
+    area.height = ROW_HEIGHT(sheet, row);
+
+    *clip_area = area;
+
+    layout = _gtk_sheet_cell_layout(sheet, row, col,
+	label, attributes->font_desc, colptr);  /* owned by the cache */
+
+    pango_layout_get_pixel_extents(layout, NULL, &rect);
 
-    for (row = clear.row0; row <= clear.rowi; row++)
+    fm = _gtk_sheet_font_metrics(sheet, attributes->font_desc);
+
+    ascent = fm ? fm->ascent / PANGO_SCALE : GTK_SHEET_DEFAULT_FONT_ASCENT;
+    descent = fm ? fm->descent / PANGO_SCALE : GTK_SHEET_DEFAULT_FONT_DESCENT;
+    spacing = pango_layout_get_spacing(layout) / PANGO_SCALE;
+
+    /* Align primarily for locale's ascent/descent */
+
+    /* vertical cell text justification */
     {
-	for (col = clear.col0; col <= clear.coli; col++)
+	/* column->vjust overrides sheet->vjust */
+
+	vjust = colptr->vjust;
+	if (vjust == GTK_SHEET_VERTICAL_JUSTIFICATION_DEFAULT)
+	    vjust = sheet->vjust;
+
+	/* Vertical justification is quantisized, so that all text lines using the
+	   same font appear vertically aligned, even if adjacent columns have
+	   different vjust settings.
+	   */
+	switch(vjust)
 	{
-	    gtk_sheet_real_cell_clear(sheet, row, col, delete);
+	    case GTK_SHEET_VERTICAL_JUSTIFICATION_DEFAULT:
+	    case GTK_SHEET_VERTICAL_JUSTIFICATION_TOP:
+		y_pos = CELLOFFSET;
+		break;
+
+	    case GTK_SHEET_VERTICAL_JUSTIFICATION_MIDDLE:
+		{
+		    /* the following works only if the whole text is set with same metrics */
+		    register gint line_height = ascent + descent + spacing;
+		    register gint area_lines = area.height / line_height;
+		    register gint text_lines = rect.height / line_height;
+
+		    y_pos = CELLOFFSET - ((text_lines - area_lines) / 2) * line_height;
+		}
+		break;
+
+	    case GTK_SHEET_VERTICAL_JUSTIFICATION_BOTTOM:
+		{
+		    /* the following works only if the whole text is set with same metrics */
+		    register gint line_height = ascent + descent + spacing;
+		    register gint area_lines = area.height / line_height;
+		    register gint area_height_quant = area_lines * line_height;
+
+		    y_pos = CELLOFFSET + area_height_quant - rect.height;
+		}
+		break;
 	}
-	_gtk_sheet_recalc_extent_height(sheet, row);
+
+	y = area.y + y_pos;
     }
-    for (col = clear.col0; col <= clear.coli; col++)
+
+    text_width = rect.width;
+    text_height = rect.height;
+
+
+    _cell_label_spread(sheet, row, col, attributes->justification,
+	text_width, &sizel, &sizer);
+
+    switch(attributes->justification)
     {
-	_gtk_sheet_recalc_extent_width(sheet, col);
+	case GTK_JUSTIFY_RIGHT:
+	    area.x += area.width;  /* anchor clip_area at right */
+	    area.width = sizel;
+	    area.x -= sizel;  /* shift left */
+	    xoffset += area.width - text_width - 2 * CELLOFFSET - attributes->border.width / 2;
+	    break;
+
+	case GTK_JUSTIFY_CENTER:
+	    area.x += area.width / 2;  /* anchor clip_area at center */
+	    if (!gtk_sheet_clip_text(sheet))
+		area.width = sizel + sizer;
+	    area.x -= sizel;  /* shift left */
+	    xoffset += sizel - text_width / 2 - CELLOFFSET;
+	    break;
+
+	case GTK_JUSTIFY_LEFT:
+	default:
+	    area.width = sizer;
+	    xoffset += attributes->border.width / 2;
+	    break;
     }
 
-    _gtk_sheet_range_draw(sheet, NULL, TRUE);
+    if (!gtk_sheet_clip_text(sheet))  /* text extends multiple cells */
+	*clip_area = area;
+
+#if GTK_SHEET_DEBUG_DRAW_LABEL>0
+    g_debug("_cell_place_label(%d,%d): x %d y %d fg %s bg %s",
+	row, col,
+	area.x + xoffset + CELLOFFSET, y,
+	gdk_color_to_string(&attributes->foreground),
+	gdk_color_to_string(&attributes->background)
+	);
+#endif
+
+    *text_x = area.x + xoffset + CELLOFFSET;
+    *text_y = y;
+
+    return (layout);
 }
 
-/**
- * gtk_sheet_cell_get_text:
- * @sheet: a #GtkSheet
- * @row: row number
- * @col: column number
- *
- * Get cell text.
- *
- * Returns: a pointer to the cell text, or NULL. 
- * Do not modify or free it.
+/*
+ * _gtk_sheet_range_grid_segments - collect the grid lines of a range
+ * 
+ * one line per visible row and column boundary
+ * 
+ * @param sheet
+ * @param range
+ * 
+ * @return a #GArray of #GdkSegment, to be freed by the caller, or 
+ *         NULL when the range has no visible cells
  */
-gchar *
-gtk_sheet_cell_get_text (GtkSheet *sheet, gint row, gint col)
-{
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
-
-    if (col > sheet->maxcol || row > sheet->maxrow)
-	return (NULL);
-    if (col < 0 || row < 0)
+static GArray *
+_gtk_sheet_range_grid_segments(GtkSheet *sheet, const GtkSheetRange *range)
+{
+    GArray *segments;
+    GdkSegment seg;
+    gint row, col, row0, rowi, col0, coli;
+    gint x0, x1, y0, y1, x, y;
+
+    row0 = MAX(range->row0, 0);
+    rowi = MIN(range->rowi, sheet->maxrow);
+    col0 = MAX(range->col0, 0);
+    coli = MIN(range->coli, sheet->maxcol);
+
+    /* outer bounds of the visible cells */
+    while (row0 <= rowi && !GTK_SHEET_ROW_IS_VISIBLE(sheet, row0)) row0++;
+    while (rowi >= row0 && !GTK_SHEET_ROW_IS_VISIBLE(sheet, rowi)) rowi--;
+    while (col0 <= coli && !GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col0))) col0++;
+    while (coli >= col0 && !GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, coli))) coli--;
+
+    if (row0 > rowi || col0 > coli)
 	return (NULL);
 
-    if (row > sheet->maxallocrow || col > sheet->maxalloccol)
-	return (NULL);
+    x0 = _gtk_sheet_column_left_xpixel(sheet, col0);
+    x1 = _gtk_sheet_column_left_xpixel(sheet, coli) + COLPTR(sheet, coli)->width;
+    y0 = _gtk_sheet_row_top_ypixel(sheet, row0);
+    y1 = _gtk_sheet_row_top_ypixel(sheet, rowi) + ROW_HEIGHT(sheet, rowi);
 
-    if (!sheet->data[row])
-	return (NULL);
-    if (!sheet->data[row][col])
-	return (NULL);
-    if (!sheet->data[row][col]->text)
-	return (NULL);
-    if (!sheet->data[row][col]->text[0])
-	return (NULL);
+    segments = g_array_sized_new(FALSE, FALSE, sizeof(GdkSegment),
+	(rowi - row0) + (coli - col0) + 4);
 
-    return (sheet->data[row][col]->text);
-}
+    for (row = row0, y = y0; row <= rowi; row++)
+    {
+	if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	    continue;
 
-/**
- * gtk_sheet_link_cell:
- * @sheet: a #GtkSheet
- * @row: row number
- * @col: column number
- * @link: pointer linked to the cell
- *
- * Link pointer to a cell.
- */
-void
-gtk_sheet_link_cell(GtkSheet *sheet, gint row, gint col, gpointer link)
-{
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+	seg.x1 = x0; seg.y1 = y; seg.x2 = x1; seg.y2 = y;
+	g_array_append_val(segments, seg);
+	y += ROW_HEIGHT(sheet, row);
+    }
+    seg.x1 = x0; seg.y1 = y1; seg.x2 = x1; seg.y2 = y1;
+    g_array_append_val(segments, seg);
 
-    if (col > sheet->maxcol || row > sheet->maxrow)
-	return;
-    if (col < 0 || row < 0)
-	return;
+    for (col = col0, x = x0; col <= coli; col++)
+    {
+	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
+	    continue;
 
-    CheckCellData(sheet, row, col);
+	seg.x1 = x; seg.y1 = y0; seg.x2 = x; seg.y2 = y1;
+	g_array_append_val(segments, seg);
+	x += COLPTR(sheet, col)->width;
+    }
+    seg.x1 = x1; seg.y1 = y0; seg.x2 = x1; seg.y2 = y1;
+    g_array_append_val(segments, seg);
 
-    sheet->data[row][col]->link = link;
+    return (segments);
 }
 
-/**
- * gtk_sheet_get_link:
- * @sheet: a #GtkSheet
- * @row: row number
- * @col: column number
- *
- * Get link pointer from a cell.
+/*
+ * cairo render path
  *
- * Returns: (transfer none) pointer linked to the cell
+ * Cells are rendered in sheet window coordinates onto any cairo 
+ * context: the backing pixmap, a client-side image surface or a 
+ * translated tile. Rectangles and lines sharing a colour are 
+ * collected into one path and painted together.
  */
-gpointer
-gtk_sheet_get_link(GtkSheet *sheet, gint row, gint col)
+
+/*
+ * _gtk_sheet_render_backgrounds - fill cell backgrounds
+ * 
+ * @param sheet
+ * @param cr
+ * @param range    range to fill
+ * @param bordered returns row, column pairs of cells having a border
+ */
+static void
+_gtk_sheet_render_backgrounds(GtkSheet *sheet, cairo_t *cr,
+    const GtkSheetRange *range, GArray *bordered)
 {
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
-    if (col > sheet->maxcol || row > sheet->maxrow)
-	return (NULL);
-    if (col < 0 || row < 0)
-	return (NULL);
+    gint row, col;
+    gboolean path_set = FALSE;
+    GdkColor path_color;
 
-    if (row > sheet->maxallocrow || col > sheet->maxalloccol)
-	return (NULL);
-    if (!sheet->data[row])
-	return (NULL); /* Added by Chris Howell */
-    if (!sheet->data[row][col])
-	return (NULL); /* Added by Bob Lissner */
+    for (row = MAX(range->row0, 0); row <= range->rowi && row <= sheet->maxrow; row++)
+    {
+	GdkColor run_color;
+	gint y, run_x = 0, run_width = 0;
 
-    return (sheet->data[row][col]->link);
-}
+	if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	    continue;
 
-/**
- * gtk_sheet_remove_link:
- * @sheet: a #GtkSheet
- * @row: row number
- * @col: column number
- *
- * Remove link pointer from a cell.
+	y = _gtk_sheet_row_top_ypixel(sheet, row);
+
+	for (col = MAX(range->col0, 0); col <= range->coli + 1; col++)
+	{
+	    GtkSheetColumn *colptr = NULL;
+	    GtkSheetCellAttr attributes;
+
+	    if (col <= range->coli && col <= sheet->maxcol)
+	    {
+		colptr = COLPTR(sheet, col);
+
+		if (!GTK_SHEET_COLUMN_IS_VISIBLE(colptr))
+		    continue;  /* no width, keeps the run */
+
+		gtk_sheet_get_attributes(sheet, row, col, &attributes);
+
+		if (attributes.border.width > 0 && attributes.border.mask)
+		{
+		    g_array_append_val(bordered, row);
+		    g_array_append_val(bordered, col);
+		}
+
+		if (run_width > 0 && gdk_color_equal(&attributes.background, &run_color))
+		{
+		    run_width += colptr->width;
+		    continue;
+		}
+	    }
+
+	    if (run_width > 0)  /* add the finished run */
+	    {
+		if (path_set && !gdk_color_equal(&path_color, &run_color))
+		{
+		    gdk_cairo_set_source_color(cr, &path_color);
+		    cairo_fill(cr);
+		}
+		path_color = run_color;
+		path_set = TRUE;
+
+		cairo_rectangle(cr, run_x, y, run_width, ROW_HEIGHT(sheet, row));
+	    }
+
+	    if (!colptr)
+		break;
+
+	    run_x = _gtk_sheet_column_left_xpixel(sheet, col);
+	    run_width = colptr->width;
+	    run_color = attributes.background;
+	}
+    }
+
+    if (path_set)
+    {
+	gdk_cairo_set_source_color(cr, &path_color);
+	cairo_fill(cr);
+    }
+}
+
+/*
+ * _gtk_sheet_render_tooltip_markers - mark cells having a tooltip
+ * 
+ * @param sheet
+ * @param cr
+ * @param range
  */
-void
-gtk_sheet_remove_link(GtkSheet *sheet, gint row, gint col)
+static void
+_gtk_sheet_render_tooltip_markers(GtkSheet *sheet, cairo_t *cr,
+    const GtkSheetRange *range)
 {
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
-    if (col > sheet->maxcol || row > sheet->maxrow)
-	return;
-    if (col < 0 || row < 0)
-	return;
+    gint row, col;
+    gboolean found = FALSE;
 
-    /* Fixed by Andreas Voegele */
-    if (row <= sheet->maxallocrow && col <= sheet->maxalloccol &&
-	sheet->data[row] && sheet->data[row][col] &&
-	sheet->data[row][col]->link)
-	sheet->data[row][col]->link = NULL;
+    for (row = MAX(range->row0, 0); row <= range->rowi && row <= sheet->maxrow; row++)
+    {
+	if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	    continue;
+
+	for (col = MAX(range->col0, 0); col <= range->coli && col <= sheet->maxcol; col++)
+	{
+	    GtkSheetCell *cell = _gtk_sheet_cell_get(sheet, row, col);
+	    gint x, y;
+
+	    if (!cell || (!cell->tooltip_markup && !cell->tooltip_text))
+		continue;
+	    if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
+		continue;
+
+	    x = _gtk_sheet_column_left_xpixel(sheet, col) + COLPTR(sheet, col)->width;
+	    y = _gtk_sheet_row_top_ypixel(sheet, row) + 1;
+
+	    cairo_move_to(cr, x - GTK_SHEET_DEFAULT_TM_SIZE, y);
+	    cairo_line_to(cr, x, y);
+	    cairo_line_to(cr, x, y + GTK_SHEET_DEFAULT_TM_SIZE);
+	    cairo_close_path(cr);
+	    found = TRUE;
+	}
+    }
+
+    if (found)
+    {
+	gdk_cairo_set_source_color(cr, &sheet->tm_color);
+	cairo_fill(cr);
+    }
 }
 
-/**
- * gtk_sheet_cell_get_state:
- * @sheet: a #GtkSheet
- * @row: row number
- * @col: column number
- *
- * Get status of a cell.
- *
- * Returns: a #GtkStateType:
- * GTK_SHEET_NORMAL,GTK_SHEET_ROW_SELECTED,GTK_SHEET_COLUMN_SELECTED,GTK_SHEET_RANGE_SELECTED
+/*
+ * _gtk_sheet_render_grid - draw the grid lines of a range
+ * 
+ * @param sheet
+ * @param cr
+ * @param range
  */
-GtkStateType
-gtk_sheet_cell_get_state(GtkSheet *sheet, gint row, gint col)
+static void
+_gtk_sheet_render_grid(GtkSheet *sheet, cairo_t *cr, const GtkSheetRange *range)
 {
-    gint state;
-    GtkSheetRange *range;
-
-    g_return_val_if_fail(sheet != NULL, 0);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), 0);
-    if (col > sheet->maxcol || row > sheet->maxrow)
-	return (0);
-    if (col < 0 || row < 0)
-	return (0);
+    GArray *segments = _gtk_sheet_range_grid_segments(sheet, range);
+    guint i;
 
-    state = sheet->state;
-    range = &sheet->range;
+    if (!segments)
+	return;
 
-    switch(state)
+    /* on pixel centres, including the end point like X thin lines */
+    for (i = 0; i < segments->len; i++)
     {
-	case GTK_SHEET_NORMAL:
-	    return (GTK_STATE_NORMAL);
-	    break;
-	case GTK_SHEET_ROW_SELECTED:
-	    if (row >= range->row0 && row <= range->rowi)
-		return (GTK_STATE_SELECTED);
-	    break;
-	case GTK_SHEET_COLUMN_SELECTED:
-	    if (col >= range->col0 && col <= range->coli)
-		return (GTK_STATE_SELECTED);
-	    break;
-	case GTK_SHEET_RANGE_SELECTED:
-	    if (row >= range->row0 && row <= range->rowi &&\
-		    col >= range->col0 && col <= range->coli)
-		return (GTK_STATE_SELECTED);
-	    break;
+	GdkSegment *seg = &g_array_index(segments, GdkSegment, i);
+
+	if (seg->y1 == seg->y2)
+	{
+	    cairo_move_to(cr, seg->x1, seg->y1 + 0.5);
+	    cairo_line_to(cr, seg->x2 + 1, seg->y2 + 0.5);
+	}
+	else
+	{
+	    cairo_move_to(cr, seg->x1 + 0.5, seg->y1);
+	    cairo_line_to(cr, seg->x2 + 0.5, seg->y2 + 1);
+	}
     }
-    return (GTK_STATE_NORMAL);
+    g_array_free(segments, TRUE);
+
+    gdk_cairo_set_source_color(cr, &sheet->grid_color);
+    cairo_set_line_width(cr, 1.0);
+    cairo_set_line_cap(cr, CAIRO_LINE_CAP_BUTT);
+    cairo_set_dash(cr, NULL, 0, 0.0);
+    cairo_stroke(cr);
 }
 
-/**
- * gtk_sheet_get_pixel_info:
- * @sheet: a #GtkSheet
- * @window: base window for coordinates (null)
- * @x: x coordinate
- * @y: y coordinate
- * @row: cell row number
- * @column: cell column number
- *
- * Get row and column correspondig to the given position within 
- * the sheet. 
- *  
- * In order to decode clicks into to title area correctly, pass 
- * the GdkWindow from the button event. Omitting the 
- * window (NULL) defaults to the sheet window. 
- *  
- * row and column may return values in the range [-1 .. max+1] 
- * depending on wether the position lies within the title area, 
- * the sheet cell area or beyond the outermost row/column. 
- *  
- * All 9 sheet areas can be reliably determined by evaluating 
- * the returned row/column values (title area/cell 
- * area/outside). 
- *
- * Returns: TRUE if the position lies within the sheet cell area
- * or FALSE when outside (title area f.e.)
+/*
+ * _gtk_sheet_render_border - draw the border of a cell
+ * 
+ * @param sheet
+ * @param cr
+ * @param row
+ * @param col
+ * @param mask   border sides to be drawn
  */
-gboolean
-gtk_sheet_get_pixel_info(GtkSheet *sheet,
-    GdkWindow *window, gint x, gint y, gint *row, gint *column)
+static void
+_gtk_sheet_render_border(GtkSheet *sheet, cairo_t *cr,
+    gint row, gint col, gint mask)
 {
-    gint trow, tcol;
+    static const gdouble dashes[] = { 4.0, 4.0 };  /* X default */
+    GtkSheetCellAttr attributes;
+    gdouble x, y, w, h, half, offset;
 
-    *row = *column = -1;  /* init all output vars */
+    if (row < 0 || row > sheet->maxrow)
+	return;
+    if (col < 0 || col > sheet->maxcol)
+	return;
+    if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
+	return;
+    if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	return;
 
-    g_return_val_if_fail(sheet != NULL, 0);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), 0);
+    gtk_sheet_get_attributes(sheet, row, col, &attributes);
 
-    /* there is a coordinate shift to be considered when
-       clicking into a title area because: 
-       - the sheet window covers the whole sheet 
-       - the column titles window overlaps the sheet window,
-          but may be shifted right when row titles are visible
-      - the row titles window overlaps the sheet window,
-         but may be shifted down when column titles are visible
-       */
+    mask &= attributes.border.mask;
+    if (attributes.border.width == 0 || !mask)
+	return;
 
-    if (sheet->column_titles_visible
-	&& window == sheet->column_title_window)
+    x = _gtk_sheet_column_left_xpixel(sheet, col);
+    y = _gtk_sheet_row_top_ypixel(sheet, row);
+    w = COLPTR(sheet, col)->width;
+    h = ROW_HEIGHT(sheet, row);
+
+    half = attributes.border.width / 2;
+    offset = (attributes.border.width & 1) ? 0.5 : 0.0;  /* pixel centres */
+
+    if (mask & GTK_SHEET_LEFT_BORDER)
     {
-	if (sheet->row_titles_visible)
-	{
-#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
-	    g_debug("gtk_sheet_get_pixel_info: shift x");
-#endif
-	    x += sheet->row_title_area.width;
-	}
-#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
-	g_debug("gtk_sheet_get_pixel_info: r1");
-#endif
-	trow = -1;
-	tcol = _gtk_sheet_column_from_xpixel(sheet, x);
+	cairo_move_to(cr, x + offset, y - half);
+	cairo_line_to(cr, x + offset, y + h + half + 1);
     }
-    else if (sheet->row_titles_visible
-	&& window == sheet->row_title_window)
+    if (mask & GTK_SHEET_RIGHT_BORDER)
     {
-	if (sheet->column_titles_visible)
-	{
-#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
-	    g_debug("gtk_sheet_get_pixel_info: shift y");
-#endif
-	    y += sheet->column_title_area.height;
-	}
-#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
-	g_debug("gtk_sheet_get_pixel_info: c1");
-#endif
-	trow = _gtk_sheet_row_from_ypixel(sheet, y);
-	tcol = -1;
+	cairo_move_to(cr, x + w + offset, y - half);
+	cairo_line_to(cr, x + w + offset, y + h + half + 1);
     }
-    else if (sheet->column_titles_visible
-	     && sheet->row_titles_visible
-	     && x < sheet->row_title_area.width
-	     && y < sheet->column_title_area.height )
+    if (mask & GTK_SHEET_TOP_BORDER)
     {
-#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
-	g_debug("gtk_sheet_get_pixel_info: sb");
-#endif
-	trow = -1;
-	tcol = -1;
+	cairo_move_to(cr, x - half, y + offset);
+	cairo_line_to(cr, x + w + half + 1, y + offset);
     }
-    else
+    if (mask & GTK_SHEET_BOTTOM_BORDER)
     {
-#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
-	g_debug("gtk_sheet_get_pixel_info: rN/cN");
-#endif
-	trow = _gtk_sheet_row_from_ypixel(sheet, y);
-	tcol = _gtk_sheet_column_from_xpixel(sheet, x);
+	cairo_move_to(cr, x - half, y + h + offset);
+	cairo_line_to(cr, x + w + half + 1, y + h + offset);
     }
 
-#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
-    g_debug("gtk_sheet_get_pixel_info: x %d y %d row %d col %d", x, y, trow, tcol);
-#endif
+    gdk_cairo_set_source_color(cr, &attributes.border.color);
+    cairo_set_line_width(cr, attributes.border.width);
 
-    *row = trow;
-    *column = tcol;
+    if (attributes.border.line_style == GDK_LINE_SOLID)
+	cairo_set_dash(cr, NULL, 0, 0.0);
+    else
+	cairo_set_dash(cr, dashes, G_N_ELEMENTS(dashes), 0.0);
 
-    /* bounds checking, return false if the user clicked
-     * on a blank area */
+    switch(attributes.border.cap_style)
+    {
+	case GDK_CAP_ROUND:
+	    cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
+	    break;
+	case GDK_CAP_PROJECTING:
+	    cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+	    break;
+	default:
+	    cairo_set_line_cap(cr, CAIRO_LINE_CAP_BUTT);
+	    break;
+    }
 
-    if (trow < 0 || trow > sheet->maxrow)
-	return (FALSE);
-    if (tcol < 0 || tcol > sheet->maxcol)
-	return (FALSE);
+    switch(attributes.border.join_style)
+    {
+	case GDK_JOIN_ROUND:
+	    cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+	    break;
+	case GDK_JOIN_BEVEL:
+	    cairo_set_line_join(cr, CAIRO_LINE_JOIN_BEVEL);
+	    break;
+	default:
+	    cairo_set_line_join(cr, CAIRO_LINE_JOIN_MITER);
+	    break;
+    }
 
-    return (TRUE);
+    cairo_stroke(cr);
 }
 
-/**
- * gtk_sheet_get_cell_area:
- * @sheet: a #GtkSheet
- * @row: row number
- * @column: column number
- * @area: a #GdkRectangle area of the cell
- *
- * Get area of a given cell.
- *
- * Returns: TRUE(success) or FALSE(failure)
+/*
+ * _gtk_sheet_render_label - draw the label of a cell
+ * 
+ * @param sheet
+ * @param cr
+ * @param row
+ * @param col
  */
-gboolean
-gtk_sheet_get_cell_area(GtkSheet *sheet,
-    gint row,
-    gint col,
-    GdkRectangle *area)
+static void
+_gtk_sheet_render_label(GtkSheet *sheet, cairo_t *cr, gint row, gint col)
 {
-    g_return_val_if_fail(sheet != NULL, 0);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), 0);
-
-    if (row > sheet->maxrow || col > sheet->maxcol)
-	return (FALSE);
+    GtkSheetCellAttr attributes;
+    GdkRectangle clip_area;
+    PangoLayout *layout;
+    gint x, y;
 
-    area->x = (col == -1) ? 0 : (_gtk_sheet_column_left_xpixel(sheet, col) -
-	(sheet->row_titles_visible ? sheet->row_title_area.width : 0));
-    area->y = (row == -1) ? 0 : (_gtk_sheet_row_top_ypixel(sheet, row) -
-	(sheet->column_titles_visible ? sheet->column_title_area.height : 0));
-    area->width = (col == -1) ? sheet->row_title_area.width : COLPTR(sheet, col)->width;
-    area->height = (row == -1) ? sheet->column_title_area.height : sheet->row[row].height;
+    layout = _cell_place_label(sheet, row, col,
+	&attributes, &clip_area, &x, &y);
+    if (!layout)
+	return;
 
-/*
-  if(row < 0 || col < 0) return FALSE;
+    cairo_save(cr);
+    gdk_cairo_rectangle(cr, &clip_area);
+    cairo_clip(cr);
 
-  area->x = COLUMN_LEFT_XPIXEL(sheet, col);
-  area->y = ROW_TOP_YPIXEL(sheet, row);
-  if(sheet->row_titles_visible)
-       area->x -= sheet->row_title_area.width;
-  if(sheet->column_titles_visible)
-       area->y -= sheet->column_title_area.height;
+    gdk_cairo_set_source_color(cr, &attributes.foreground);
+    cairo_move_to(cr, x, y);
+    pango_cairo_show_layout(cr, layout);
 
-  area->width = COLPTR(sheet, col)->width;
-  area->height = sheet->row[row].height;
-*/
-    return (TRUE);
+    cairo_restore(cr);
 }
 
-/**
- * gtk_sheet_set_active_cell:
- * @sheet: a #GtkSheet
- * @row: row number
- * @column: column number
- *
- * Set active cell where the cell entry will be displayed. 
- * Use (row,col) = (-1,-1) to deactivate active cell. 
- *
- * Returns: FALSE if current cell can't be deactivated or
- * requested cell can't be activated
+/*
+ * _gtk_sheet_range_render - render the cells of a range
+ * 
+ * renders backgrounds, tooltip markers, grid, borders and labels 
+ * in sheet window coordinates. The range must already include its 
+ * text overflow columns.
+ * 
+ * @param sheet
+ * @param cr
+ * @param range
  */
-gboolean
-gtk_sheet_set_active_cell(GtkSheet *sheet, gint row, gint col)
+static void
+_gtk_sheet_range_render(GtkSheet *sheet, cairo_t *cr,
+    const GtkSheetRange *range)
 {
-    g_return_val_if_fail(sheet != NULL, 0);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), 0);
+    gint row, col;
+    guint i;
+    GArray *bordered = g_array_new(FALSE, FALSE, sizeof(gint));
 
-    if (row > sheet->maxrow || col > sheet->maxcol)
-	return (FALSE);
+    _gtk_sheet_render_backgrounds(sheet, cr, range, bordered);
+    _gtk_sheet_render_tooltip_markers(sheet, cr, range);
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("gtk_sheet_set_active_cell: row %d col %d", row, col);
-#endif
+    if (sheet->show_grid)
+	_gtk_sheet_render_grid(sheet, cr, range);
 
-    if (!gtk_widget_get_can_focus(GTK_WIDGET(sheet)))
+    /* bordered cells within the range, neighbours only on the facing side */
+    for (i = 0; i < bordered->len; i += 2)
     {
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-	g_debug("gtk_sheet_set_active_cell: row %d col %d abort: sheet, can-focus false", row, col);
-#endif
-	return (FALSE);
+	_gtk_sheet_render_border(sheet, cr,
+	    g_array_index(bordered, gint, i), g_array_index(bordered, gint, i + 1), 15);
     }
+    g_array_free(bordered, TRUE);
 
-    if (col >= 0 && !GTK_SHEET_COLUMN_CAN_FOCUS(COLPTR(sheet, col)))
+    for (col = range->col0; col <= range->coli; col++)
     {
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-	g_debug("gtk_sheet_set_active_cell: row %d col %d abort: sheet column, can-focus false", row, col);
-#endif
-	return (FALSE);
+	_gtk_sheet_render_border(sheet, cr, range->row0 - 1, col, GTK_SHEET_BOTTOM_BORDER);
+	_gtk_sheet_render_border(sheet, cr, range->rowi + 1, col, GTK_SHEET_TOP_BORDER);
     }
-
-    if (col >= 0 && !GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
+    for (row = range->row0; row <= range->rowi; row++)
     {
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-	g_debug("gtk_sheet_set_active_cell: row %d col %d abort: sheet column, visible false", row, col);
-#endif
-	return (FALSE);
+	_gtk_sheet_render_border(sheet, cr, row, range->col0 - 1, GTK_SHEET_RIGHT_BORDER);
+	_gtk_sheet_render_border(sheet, cr, row, range->coli + 1, GTK_SHEET_LEFT_BORDER);
     }
 
-    if (gtk_widget_get_realized(GTK_WIDGET(sheet)))
+    for (row = MAX(range->row0, 0); row <= range->rowi && row <= sheet->maxrow; row++)
     {
-#if 0
-	gint old_row = sheet->active_cell.row;
-	gint old_col = sheet->active_cell.col;
-#endif
-
-	if (!gtk_sheet_deactivate_cell(sheet))
-	{
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-	    g_debug("gtk_sheet_set_active_cell: abort: deactivation false");
-#endif
-	    return (FALSE);
-	}
-
-	/* the deactivate signal handler may have activated another cell here */
-#if 0
-	if ((sheet->active_cell.row != old_row) || (sheet->active_cell.col != old_col))
+	for (col = range->col0; col <= range->coli; col++)
 	{
-#ifdef GTK_SHEET_DEBUG
-	    g_debug("gtk_sheet_set_active_cell: deactivation moved active cell to row %d col %d",
-		    sheet->active_cell.row, sheet->active_cell.col);
-#endif
-	    return(FALSE);
+	    if (sheet->model || _gtk_sheet_cell_get(sheet, row, col))
+		_gtk_sheet_render_label(sheet, cr, row, col);
 	}
-#endif
-    }
-
-    if (row < 0 || col < 0)
-    {
-	sheet->range.row0 = -1;
-	sheet->range.rowi = -1;
-	sheet->range.col0 = -1;
-	sheet->range.coli = -1;
-
-	return (TRUE);
     }
-
-    sheet->active_cell.row = row;
-    sheet->active_cell.col = col;
-
-    if (!gtk_sheet_activate_cell(sheet, row, col))
-	return (FALSE);
-
-    _gtk_sheet_move_query(sheet, row, col, TRUE);
-
-    return (TRUE);
 }
 
-/**
- * gtk_sheet_get_active_cell:
- * @sheet: a #GtkSheet
- * @row: row number
- * @column: column number
- *
- * Store the coordinates of the active cell in row,col. 
- * If (row<0 || col<0) then there was no active cell in the 
- * sheet. 
+/*
+ * _gtk_sheet_range_pixel_area - sheet window area of a range
+ * 
+ * @param sheet
+ * @param range
+ * @param area   returns the area covered by the visible cells, 
+ *               clipped to the sheet window
+ * 
+ * @return FALSE if the area is empty
  */
-void
-gtk_sheet_get_active_cell(GtkSheet *sheet, gint *row, gint *column)
+static gboolean
+_gtk_sheet_range_pixel_area(GtkSheet *sheet, const GtkSheetRange *range,
+    GdkRectangle *area)
 {
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
-
-    *row = sheet->active_cell.row;
-    *column = sheet->active_cell.col;
-}
+    gint row0 = MAX(range->row0, 0), rowi = MIN(range->rowi, sheet->maxrow);
+    gint col0 = MAX(range->col0, 0), coli = MIN(range->coli, sheet->maxcol);
+    gint x0, x1, y0, y1;
 
-/**
- * gtk_sheet_set_tab_direction:
- * @sheet: a #GtkSheet
- * @dir: the primary tab direction
- *
- * Sets a primary movement direction to the Tab, Return and 
- * Enter keys, and assigns the opposite direction to the same 
- * keys with GDK_SHIFT_MASK. 
- *  
- * Transposed movement direction can be accessed with 
- * GTK_SHEET_MOD_MASK|GDK_CONTROL_MASK and 
- * GTK_SHEET_MOD_MASK|GDK_CONTROL_MASK|GDK_SHIFT_MASK. 
- *  
- * All bindings are defined for the #GtkSheetClass, so all sheet
- * instances use the same movement directions. 
- *  
- * Default: GTK_DIR_TAB_FORWARD.
- *  
- * Since: 3.0.2 
- */
-void
-gtk_sheet_set_tab_direction(GtkSheet *sheet, GtkDirectionType dir)
-{
-    GtkSheetClass *klass;
+    while (rowi >= row0 && !GTK_SHEET_ROW_IS_VISIBLE(sheet, rowi)) rowi--;
+    while (coli >= col0 && !GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, coli))) coli--;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    if (row0 > rowi || col0 > coli)
+	return (FALSE);
 
-    klass = GTK_SHEET_GET_CLASS(sheet);
+    x0 = MAX(_gtk_sheet_column_left_xpixel(sheet, col0), 0);
+    x1 = MIN(_gtk_sheet_column_left_xpixel(sheet, coli) + COLPTR(sheet, coli)->width,
+	sheet->sheet_window_width);
+    y0 = MAX(_gtk_sheet_row_top_ypixel(sheet, row0), 0);
+    y1 = MIN(_gtk_sheet_row_top_ypixel(sheet, rowi) + ROW_HEIGHT(sheet, rowi),
+	sheet->sheet_window_height);
 
-    _gtk_sheet_class_init_tab_bindings(klass, dir);
-}
+    area->x = x0;
+    area->y = y0;
+    area->width = x1 - x0;
+    area->height = y1 - y0;
 
+    if (sheet->show_grid)  /* closing grid lines */
+    {
+	area->width++;
+	area->height++;
+    }
 
+    return (area->width > 0 && area->height > 0);
+}
 
 /*
- * gtk_sheet_entry_changed_handler:
+ * _gtk_sheet_range_paint_image - paint cells through an image
  * 
- * this is the sheet_entry editable "changed" signal handler 
- *  
- * The signal is emited when typing into the entry, or changing 
- * its content. 
- *  
- * Its main purpose is to update the cell data text 
+ * renders a range into a client-side image surface and uploads it 
+ * into the backing pixmap by a single request, instead of one 
+ * server request per cell, colour and line.
  * 
- * @param widget the sheet_entry widget
- * @param data the #GtkSheet, passed on signal creation
+ * @param sheet
+ * @param range  range including its text overflow columns
  */
 static void
-gtk_sheet_entry_changed_handler(GtkWidget *widget, gpointer data)
+_gtk_sheet_range_paint_image(GtkSheet *sheet, const GtkSheetRange *range)
 {
-    GtkSheet *sheet;
-    gint row, col;
-    char *text;
-
-    g_return_if_fail(data != NULL);
-    g_return_if_fail(GTK_IS_SHEET(data));
-
-    sheet = GTK_SHEET(data);
+    GdkRectangle area;
+    cairo_surface_t *surface;
+    cairo_t *cr;
 
-    if (!gtk_widget_get_visible(gtk_sheet_get_entry_widget(sheet)))
-	return;
-    if (sheet->state != GTK_STATE_NORMAL)
+    if (!_gtk_sheet_range_pixel_area(sheet, range, &area))
 	return;
 
-    row = sheet->active_cell.row;
-    col = sheet->active_cell.col;
+    surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24,
+	area.width, area.height);
 
-    if (row < 0 || col < 0)
-	return;
+    /* every pixel of the area is covered by a background or grid line */
+    cr = cairo_create(surface);
+    cairo_translate(cr, -area.x, -area.y);
+    _gtk_sheet_range_render(sheet, cr, range);
+    cairo_destroy(cr);
 
-    sheet->active_cell.row = -1;
-    sheet->active_cell.col = -1;
+    cr = gdk_cairo_create(sheet->pixmap);
+    cairo_set_source_surface(cr, surface, area.x, area.y);
+    gdk_cairo_rectangle(cr, &area);
+    cairo_fill(cr);
+    cairo_destroy(cr);
 
-    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IS_FROZEN);
+    cairo_surface_destroy(surface);
+}
 
-    text = gtk_sheet_get_entry_text(sheet);
-    gtk_sheet_set_cell_text(sheet, row, col, text);
-    g_free(text);
+#if GTK_SHEET_TILE_CACHE
+/*
+ * tile cache
+ *
+ * Optionally, rendered cells are kept in image tiles of 
+ * GTK_SHEET_TILE_ROWS x GTK_SHEET_TILE_COLUMNS cells, so paging back 
+ * to cells seen before is a blit instead of a render. Tiles are 
+ * dropped when their cells change and evicted least recently used 
+ * beyond the memory budget. While the sheet is idle, the page ahead 
+ * in the scroll direction is rendered in advance.
+ */
 
-    if (sheet->freeze_count == 0)
-	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IS_FROZEN);
+static guint
+_gtk_sheet_tile_key_hash(gconstpointer k)
+{
+    const GtkSheetTile *key = k;
 
-    sheet->active_cell.row = row;;
-    sheet->active_cell.col = col;
+    return ((guint)key->trow * 8191 + (guint)key->tcol);
 }
 
-
 static gboolean
-gtk_sheet_deactivate_cell(GtkSheet *sheet)
+_gtk_sheet_tile_key_equal(gconstpointer a, gconstpointer b)
 {
-    gboolean veto = TRUE;
-    gint row, col;
+    const GtkSheetTile *ka = a, *kb = b;
 
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+    return (ka->trow == kb->trow && ka->tcol == kb->tcol);
+}
 
-    row = sheet->active_cell.row;
-    col = sheet->active_cell.col;
+static void
+_gtk_sheet_tile_free(gpointer data)
+{
+    GtkSheetTile *tile = data;
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("gtk_sheet_deactivate_cell: called, row %d col %d", row, col);
-#endif
+    if (tile->surface)
+	cairo_surface_destroy(tile->surface);
+    g_free(tile);
+}
 
-    if (row < 0 || row > sheet->maxrow)
-	return (TRUE);
-    if (col < 0 || col > sheet->maxcol)
-	return (TRUE);
+static GtkSheetTileCache *
+_gtk_sheet_tile_cache_new(void)
+{
+    GtkSheetTileCache *cache = g_new0(GtkSheetTileCache, 1);
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return (FALSE);
-    if (sheet->state != GTK_SHEET_NORMAL)
-	return (FALSE);
+    cache->lookup = g_hash_table_new_full(
+	_gtk_sheet_tile_key_hash, _gtk_sheet_tile_key_equal,
+	NULL, _gtk_sheet_tile_free);
 
-    gtk_sheet_entry_signal_disconnect_by_func(sheet,
-	G_CALLBACK(gtk_sheet_entry_changed_handler));
+    return (cache);
+}
 
-    _gtk_sheet_hide_active_cell(sheet);
+static void
+_gtk_sheet_tile_cache_remove(GtkSheetTileCache *cache, GtkSheetTile *tile)
+{
+    g_queue_unlink(&cache->lru, &tile->link);
+    cache->bytes -= tile->bytes;
+    g_hash_table_remove(cache->lookup, tile);  /* frees the tile */
+}
 
-    sheet->active_cell.row = -1;  /* reset before signal emission, to prevent recursion */
-    sheet->active_cell.col = -1;
+static void
+_gtk_sheet_tile_cache_flush(GtkSheetTileCache *cache)
+{
+    g_hash_table_remove_all(cache->lookup);
 
-    /* beware: DEACTIVATE handler may call gtk_sheet_set_active_cell()
-       */
+    cache->lru.head = cache->lru.tail = NULL;
+    cache->lru.length = 0;
+    cache->bytes = 0;
+}
 
-    _gtksheet_signal_emit(GTK_OBJECT(sheet), sheet_signals[DEACTIVATE],
-	row, col, &veto);
+static void
+_gtk_sheet_tile_cache_free(GtkSheetTileCache *cache)
+{
+    if (cache->prerender_idle)
+	g_source_remove(cache->prerender_idle);
 
-    if (!veto)
+    _gtk_sheet_tile_cache_flush(cache);
+    g_hash_table_destroy(cache->lookup);
+    g_free(cache);
+}
+
+/*
+ * _gtk_sheet_tile_cache_trim - evict tiles beyond the budget
+ * 
+ * tiles of the current paint are kept, the budget may be exceeded 
+ * while a single paint needs more.
+ * 
+ * @param cache
+ */
+static void
+_gtk_sheet_tile_cache_trim(GtkSheetTileCache *cache)
+{
+    while (cache->bytes > cache->budget && cache->lru.tail)
     {
-	sheet->active_cell.row = row;
-	sheet->active_cell.col = col;
+	GtkSheetTile *tile = cache->lru.tail->data;
 
-	return (FALSE);
-    }
+	if (tile->paint_serial == cache->paint_serial)
+	    break;
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("gtk_sheet_deactivate_cell: running");
-#endif
+	_gtk_sheet_tile_cache_remove(cache, tile);
+    }
+}
 
+/*
+ * _gtk_sheet_tile_cache_drop - drop tiles overlapping a range
+ * 
+ * @param cache
+ * @param range  range with valid rows and columns
+ */
+static void
+_gtk_sheet_tile_cache_drop(GtkSheetTileCache *cache, const GtkSheetRange *range)
+{
+    gint trow0 = range->row0 / GTK_SHEET_TILE_ROWS;
+    gint trowi = range->rowi / GTK_SHEET_TILE_ROWS;
+    gint tcol0 = range->col0 / GTK_SHEET_TILE_COLUMNS;
+    gint tcoli = range->coli / GTK_SHEET_TILE_COLUMNS;
+    gint trow, tcol;
 
-    if (GTK_SHEET_REDRAW_PENDING(sheet))
+    if ((guint64)(trowi - trow0 + 1) * (tcoli - tcol0 + 1)
+	> g_hash_table_size(cache->lookup))
     {
-	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_REDRAW_PENDING);
-	_gtk_sheet_range_draw(sheet, NULL, TRUE);
+	GList *link = cache->lru.head;
+
+	while (link)  /* fewer tiles cached than covered */
+	{
+	    GtkSheetTile *tile = link->data;
+
+	    link = link->next;
+
+	    if (trow0 <= tile->trow && tile->trow <= trowi
+		&& tcol0 <= tile->tcol && tile->tcol <= tcoli)
+	    {
+		_gtk_sheet_tile_cache_remove(cache, tile);
+	    }
+	}
+	return;
     }
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("gtk_sheet_deactivate_cell: done row %d col %d", row, col);
-#endif
+    for (trow = trow0; trow <= trowi; trow++)
+    {
+	for (tcol = tcol0; tcol <= tcoli; tcol++)
+	{
+	    GtkSheetTile key, *tile;
 
-    return (TRUE);
+	    key.trow = trow;
+	    key.tcol = tcol;
+
+	    tile = g_hash_table_lookup(cache->lookup, &key);
+	    if (tile)
+		_gtk_sheet_tile_cache_remove(cache, tile);
+	}
+    }
 }
 
-/**
- * _gtk_sheet_hide_active_cell:
+/*
+ * _gtk_sheet_tile_area - cells and position of a tile
  * 
- * @param sheet  the #GtkSheet 
- *  
- * hide active cell
+ * @param sheet
+ * @param trow
+ * @param tcol
+ * @param range  returns the cells of the tile
+ * @param area   returns the position in the sheet window and 
+ *               the size, including closing grid lines
  */
-void
-_gtk_sheet_hide_active_cell(GtkSheet *sheet)
+static void
+_gtk_sheet_tile_area(GtkSheet *sheet, gint trow, gint tcol,
+    GtkSheetRange *range, GdkRectangle *area)
 {
-    gint row, col;
-
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
-    if (!gtk_widget_get_visible(sheet->sheet_entry))
-	return;
-
-    row = sheet->active_cell.row;
-    col = sheet->active_cell.col;
+    range->row0 = trow * GTK_SHEET_TILE_ROWS;
+    range->rowi = MIN(range->row0 + GTK_SHEET_TILE_ROWS - 1, sheet->maxrow);
+    range->col0 = tcol * GTK_SHEET_TILE_COLUMNS;
+    range->coli = MIN(range->col0 + GTK_SHEET_TILE_COLUMNS - 1, sheet->maxcol);
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("_gtk_sheet_hide_active_cell: called row %d col %d", row, col);
-#endif
+    area->x = _gtk_sheet_column_left_xpixel(sheet, range->col0);
+    area->y = _gtk_sheet_row_top_ypixel(sheet, range->row0);
 
-    if (row < 0 || row > sheet->maxrow)
-	return;
-    if (col < 0 || col > sheet->maxcol)
-	return;
+    area->width = _gtk_sheet_column_left_xpixel(sheet, range->coli) - area->x;
+    if (GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, range->coli)))
+	area->width += COLPTR(sheet, range->coli)->width;
 
-    if (sheet->freeze_count == 0)
-	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IS_FROZEN);
+    area->height = _gtk_sheet_row_top_ypixel(sheet, range->rowi) - area->y;
+    if (GTK_SHEET_ROW_IS_VISIBLE(sheet, range->rowi))
+	area->height += ROW_HEIGHT(sheet, range->rowi);
 
-#if 0
-    /* transferring entry text to the cell gives problems when gtk_sheet_change_entry()
-       is called during TRAVERSE signal emission. The text of the already changed
-       entry gets written into the deactivated cell */
+    if (sheet->show_grid && area->width > 0 && area->height > 0)
     {
-	char *text = gtk_sheet_get_entry_text(sheet);
+	area->width++;
+	area->height++;
+    }
+}
 
-	/* todo: compare with existing text, only notify if text changes */
-	gtk_sheet_set_cell_text(sheet, row, col, text);
+/*
+ * _gtk_sheet_tile_render - render a tile and add it to the cache
+ * 
+ * When the text of its cells now overflows further, the tiles 
+ * covering the new overflow are dropped.
+ * 
+ * @param sheet
+ * @param trow
+ * @param tcol
+ * 
+ * @return the tile, owned by the cache
+ */
+static GtkSheetTile *
+_gtk_sheet_tile_render(GtkSheet *sheet, gint trow, gint tcol)
+{
+    GtkSheetTileCache *cache = sheet->tile_cache;
+    GtkSheetTile *tile;
+    GtkSheetRange range;
+    GdkRectangle area;
 
-	g_free(text);
-    }
-#endif
+    _gtk_sheet_tile_area(sheet, trow, tcol, &range, &area);
 
-#if 0
-    /* why shoud we first set the cursor to the cell we want hide ? */
-    g_signal_emit(GTK_OBJECT(sheet),sheet_signals[SET_CELL], 0, row, col);
-#endif
+    tile = g_new0(GtkSheetTile, 1);
+    tile->trow = trow;
+    tile->tcol = tcol;
+    tile->link.data = tile;
 
-    if (!GTK_SHEET_IS_FROZEN(sheet))
+    if (area.width > 0 && area.height > 0)
     {
-	GtkSheetRange range;
+	GtkSheetRange ext = range, before = range, after = range;
+	cairo_t *cr;
 
-	range.row0 = range.rowi = row;
-	range.col0 = range.coli = col;
+	if (!gtk_sheet_clip_text(sheet))
+	{
+	    _gtk_sheet_range_add_text_columns(sheet, &ext);
+	    _gtk_sheet_text_column_targets(sheet, &before);
+	}
 
-	_gtk_sheet_range_draw(sheet, &range, FALSE);  /* do not reactivate active cell!!! */
-    }
+	tile->surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24,
+	    area.width, area.height);
+	tile->bytes = (gsize)area.width * area.height * 4;
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("_gtk_sheet_hide_active_cell: _gtk_sheet_column_button_release");
-#endif
-    _gtk_sheet_column_button_release(sheet, col);
-    row_button_release(sheet, row);
+	cr = cairo_create(tile->surface);
+	cairo_translate(cr, -area.x, -area.y);
+	_gtk_sheet_range_render(sheet, cr, &ext);
+	cairo_destroy(cr);
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("_gtk_sheet_hide_active_cell: gtk_widget_unmap");
-#endif
-    gtk_widget_unmap(sheet->sheet_entry);
+	if (!gtk_sheet_clip_text(sheet))  /* text now reaching further */
+	{
+	    _gtk_sheet_text_column_targets(sheet, &after);
 
-    gdk_draw_pixmap(sheet->sheet_window,
-	gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-	sheet->pixmap,
-	_gtk_sheet_column_left_xpixel(sheet, col) - 1,
-	_gtk_sheet_row_top_ypixel(sheet, row) - 1,
-	_gtk_sheet_column_left_xpixel(sheet, col) - 1,
-	_gtk_sheet_row_top_ypixel(sheet, row) - 1,
-	COLPTR(sheet, col)->width + 4,
-	sheet->row[row].height + 4);
+	    if (after.col0 < before.col0)
+	    {
+		GtkSheetRange drop = range;
 
-#if 0
-    /* why shoud we first set the cursor to the cell we want hide ? */
-    gtk_widget_grab_focus(GTK_WIDGET(sheet));
-#endif
+		drop.col0 = after.col0;
+		drop.coli = before.col0 - 1;
+		_gtk_sheet_tile_cache_drop(cache, &drop);
+	    }
+	    if (after.coli > before.coli)
+	    {
+		GtkSheetRange drop = range;
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("_gtk_sheet_hide_active_cell: gtk_widget_set_visible");
+		drop.col0 = before.coli + 1;
+		drop.coli = after.coli;
+		_gtk_sheet_tile_cache_drop(cache, &drop);
+	    }
+	}
+    }
+
+#if GTK_SHEET_DEBUG_DRAW > 0
+    g_debug("_gtk_sheet_tile_render: tile %d,%d row %d - %d col %d - %d %dx%d",
+	trow, tcol, range.row0, range.rowi, range.col0, range.coli,
+	area.width, area.height);
 #endif
 
-    gtk_widget_set_visible(GTK_WIDGET(sheet->sheet_entry), FALSE);
+    g_hash_table_insert(cache->lookup, tile, tile);
+    g_queue_push_head_link(&cache->lru, &tile->link);
+    cache->bytes += tile->bytes;
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("_gtk_sheet_hide_active_cell: done");
-#endif
+    return (tile);
 }
 
+/*
+ * _gtk_sheet_tile_prerender - render one tile ahead of the view
+ * 
+ * @param sheet
+ * 
+ * @return TRUE if more tiles ahead may be missing
+ */
 static gboolean
-gtk_sheet_activate_cell(GtkSheet *sheet, gint row, gint col)
+_gtk_sheet_tile_prerender(GtkSheet *sheet)
 {
-    gboolean veto = TRUE;
-
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
-
-    if (GTK_SHEET_FLAGS(sheet) & GTK_SHEET_IS_DESTROYED) return(FALSE); /* PR#102114 */
+    GtkSheetTileCache *cache = sheet->tile_cache;
+    GtkSheetRange ahead = sheet->view;
+    gint trow, tcol;
 
-    if (row < 0 || col < 0)
+    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
 	return (FALSE);
-    if (row > sheet->maxrow || col > sheet->maxcol)
+    if (GTK_SHEET_IS_FROZEN(sheet))
+	return (FALSE);
+    if (cache->bytes >= cache->budget)  /* never evict for guesses */
 	return (FALSE);
 
-    if (!gtk_widget_get_can_focus(GTK_WIDGET(sheet)))
+    if (cache->drow > 0)
     {
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-	g_debug("gtk_sheet_activate_cell: row %d col %d abort: sheet, can-focus false", row, col);
-#endif
-	return (FALSE);
+	ahead.row0 = sheet->view.rowi + 1;
+	ahead.rowi = sheet->view.rowi + (sheet->view.rowi - sheet->view.row0 + 1);
     }
-
-    if (!GTK_SHEET_COLUMN_CAN_FOCUS(COLPTR(sheet, col)))
+    else if (cache->drow < 0)
     {
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-	g_debug("gtk_sheet_activate_cell: row %d col %d abort: sheet column, can-focus false", row, col);
-#endif
-	return (FALSE);
+	ahead.rowi = sheet->view.row0 - 1;
+	ahead.row0 = sheet->view.row0 - (sheet->view.rowi - sheet->view.row0 + 1);
     }
-
-/* 
-   _gtksheet_signal_emit(GTK_OBJECT(sheet),sheet_signals[ACTIVATE], row, col, &veto);
-    if(!gtk_widget_get_realized(GTK_WIDGET(sheet))) return veto;
-    if (!veto) return FALSE;
-*/
-
-    if (sheet->state != GTK_SHEET_NORMAL)
+    else if (cache->dcol > 0)
     {
-	sheet->state = GTK_SHEET_NORMAL;
-	gtk_sheet_real_unselect_range(sheet, NULL);
+	ahead.col0 = sheet->view.coli + 1;
+	ahead.coli = sheet->view.coli + (sheet->view.coli - sheet->view.col0 + 1);
+    }
+    else if (cache->dcol < 0)
+    {
+	ahead.coli = sheet->view.col0 - 1;
+	ahead.col0 = sheet->view.col0 - (sheet->view.coli - sheet->view.col0 + 1);
     }
+    else
+	return (FALSE);
 
-    sheet->range.row0 = row;
-    sheet->range.col0 = col;
-    sheet->range.rowi = row;
-    sheet->range.coli = col;
+    ahead.row0 = MAX(ahead.row0, 0);
+    ahead.rowi = MIN(ahead.rowi, sheet->maxrow);
+    ahead.col0 = MAX(ahead.col0, 0);
+    ahead.coli = MIN(ahead.coli, sheet->maxcol);
 
-    sheet->active_cell.row = row;
-    sheet->active_cell.col = col;
+    if (ahead.row0 > ahead.rowi || ahead.col0 > ahead.coli)
+	return (FALSE);
 
-    sheet->selection_cell.row = row;
-    sheet->selection_cell.col = col;
+    for (trow = ahead.row0 / GTK_SHEET_TILE_ROWS;
+	trow <= ahead.rowi / GTK_SHEET_TILE_ROWS; trow++)
+    {
+	for (tcol = ahead.col0 / GTK_SHEET_TILE_COLUMNS;
+	    tcol <= ahead.coli / GTK_SHEET_TILE_COLUMNS; tcol++)
+	{
+	    GtkSheetTile key;
 
-    row_button_set(sheet, row);
-    _gtk_sheet_column_button_set(sheet, col);
+	    key.trow = trow;
+	    key.tcol = tcol;
 
-    GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
-    gtk_sheet_show_active_cell(sheet);
+	    if (!g_hash_table_lookup(cache->lookup, &key))
+	    {
+		_gtk_sheet_tile_render(sheet, trow, tcol);
+		return (TRUE);
+	    }
+	}
+    }
+    return (FALSE);
+}
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("gtk_sheet_activate_cell: signal setup");
-#endif
+static gboolean
+_gtk_sheet_tile_prerender_handler(gpointer data)
+{
+    GtkSheet *sheet = GTK_SHEET(data);
+    gboolean more;
 
-    gtk_sheet_entry_signal_connect_changed(sheet,
-	G_CALLBACK(gtk_sheet_entry_changed_handler));
+    GDK_THREADS_ENTER();
 
-    _gtksheet_signal_emit(GTK_OBJECT(sheet), sheet_signals[ACTIVATE], row, col, &veto);
+    more = _gtk_sheet_tile_prerender(sheet);
+    if (!more)
+	sheet->tile_cache->prerender_idle = 0;
 
-    return (TRUE);
+    GDK_THREADS_LEAVE();
+
+    return (more);
 }
 
-static void _gtk_sheet_entry_preselect(GtkSheet *sheet)
+/*
+ * _gtk_sheet_range_paint_tiles - paint cells from cached tiles
+ * 
+ * renders the missing tiles covering a range and copies them into 
+ * the backing pixmap. Notes the scroll direction and schedules the 
+ * pre-rendering of the page ahead.
+ * 
+ * @param sheet
+ * @param range  range including its text overflow columns
+ */
+static void
+_gtk_sheet_range_paint_tiles(GtkSheet *sheet, const GtkSheetRange *range)
 {
-    gboolean select_on_focus;
-    gboolean editable = TRUE;  /* incomplete - refer to gtkitementry::gtk_entry_grab_focus() */
-    gboolean in_click = FALSE;  /* incomplete - refer to gtkitementry::gtk_entry_grab_focus() */
-
-#if GTK_SHEET_DEBUG_MOVE > 0
-    g_debug("_gtk_sheet_entry_preselect: called");
-#endif
+    GtkSheetTileCache *cache = sheet->tile_cache;
+    GdkRectangle area;
+    gint trow, trow0, trowi, tcol, tcol0, tcoli;
+    gboolean rendered;
+    cairo_t *cr;
 
-    g_object_get(G_OBJECT(gtk_settings_get_default()),
-	"gtk-entry-select-on-focus",
-	&select_on_focus,
-	NULL);
+    if (!_gtk_sheet_range_pixel_area(sheet, range, &area))
+	return;
 
-    if (select_on_focus && editable && !in_click)
+    if (sheet->view.row0 != cache->view.row0 || sheet->view.col0 != cache->view.col0)
     {
-	gtk_sheet_entry_select_region(sheet, 0, -1);
+	cache->drow = CLAMP(sheet->view.row0 - cache->view.row0, -1, 1);
+	cache->dcol = CLAMP(sheet->view.col0 - cache->view.col0, -1, 1);
+	cache->view = sheet->view;
     }
-}
 
-/**
- * _gtk_sheet_entry_setup: 
- * @sheet:  the #GtkSheet
- * @row:    row index
- * @col:    column index
- * @entry_widget: entry widget 
- * 
- * configure sheet_entry for use within the active cell
- * - justification 
- * - editable
- * - max_length 
- * - wrap_mode 
- * - color attributes
- * - font
- *  
- * this function must not dependant on any text contents.
- */
-static void _gtk_sheet_entry_setup(GtkSheet *sheet, gint row, gint col,
-    GtkWidget *entry_widget)
-{
-    GtkJustification justification = GTK_JUSTIFY_LEFT;
-    gboolean editable;
-    GtkStyle *style;
-    GtkSheetColumn *colptr = COLPTR(sheet, col);
-    GtkSheetRow *rowptr = ROWPTR(sheet, row);
+    trow0 = MAX(range->row0, 0) / GTK_SHEET_TILE_ROWS;
+    trowi = MIN(range->rowi, sheet->maxrow) / GTK_SHEET_TILE_ROWS;
+    tcol0 = MAX(range->col0, 0) / GTK_SHEET_TILE_COLUMNS;
+    tcoli = MIN(range->coli, sheet->maxcol) / GTK_SHEET_TILE_COLUMNS;
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("_gtk_sheet_entry_setup: row %d col %d", row, col);
-#endif
+    cache->paint_serial++;
 
-    if (row < 0 || col < 0)
-	return;
+    /* rendering may widen text overflow and drop tiles done before */
+    do
+    {
+	rendered = FALSE;
 
-    GtkSheetCellAttr attributes;
-    gtk_sheet_get_attributes(sheet, row, col, &attributes);
+	for (trow = trow0; trow <= trowi; trow++)
+	{
+	    for (tcol = tcol0; tcol <= tcoli; tcol++)
+	    {
+		GtkSheetTile key, *tile;
 
-    if (gtk_sheet_justify_entry(sheet))
-	justification = attributes.justification;
+		key.trow = trow;
+		key.tcol = tcol;
 
-    editable = !(gtk_sheet_locked(sheet)
-	|| !attributes.is_editable
-	|| colptr->is_readonly 
-        || rowptr->is_readonly);
+		tile = g_hash_table_lookup(cache->lookup, &key);
+		if (!tile)
+		{
+		    tile = _gtk_sheet_tile_render(sheet, trow, tcol);
+		    rendered = TRUE;
+		}
+		else
+		{
+		    g_queue_unlink(&cache->lru, &tile->link);
+		    g_queue_push_head_link(&cache->lru, &tile->link);
+		}
+		tile->paint_serial = cache->paint_serial;
+	    }
+	}
+    }
+    while (rendered);
 
-    gtk_sheet_set_entry_editable(sheet, editable);
+    cr = gdk_cairo_create(sheet->pixmap);
+    gdk_cairo_rectangle(cr, &area);
+    cairo_clip(cr);
 
-    if (GTK_IS_ITEM_ENTRY(entry_widget))
+    for (trow = trow0; trow <= trowi; trow++)
     {
-	GtkItemEntry *item_entry = GTK_ITEM_ENTRY(entry_widget);
-	GtkEntry *entry = GTK_ENTRY(entry_widget);
+	for (tcol = tcol0; tcol <= tcoli; tcol++)
+	{
+	    GtkSheetTile key, *tile;
+	    GtkSheetRange cells;
+	    GdkRectangle tile_area;
 
-	/* 5.8.2010/fp - the code below has no effect in GTK 2.18.9,
-	   a right justified editable will pop to left justification
-	   as soon as something gets selected, and will
-	   pop back to right aligment, as soon as the
-	   cursor ist moved. When this happens, the
-	   justification value in the editable is correct. */
+	    key.trow = trow;
+	    key.tcol = tcol;
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-	g_debug("_gtk_sheet_entry_setup: GtkItemEntry justification %d", justification);
-#endif
-	gtk_item_entry_set_justification(item_entry, justification);
-	gtk_item_entry_set_max_length_bytes(item_entry, colptr->max_length_bytes);
+	    tile = g_hash_table_lookup(cache->lookup, &key);
+	    if (!tile->surface)
+		continue;
 
-	gtk_entry_set_max_length(entry, colptr->max_length);
-    }
-    else if (GTK_IS_DATA_TEXT_VIEW(entry_widget))
-    {
-	GtkDataTextView *data_textview = GTK_DATA_TEXT_VIEW(entry_widget);
-	GtkTextView *textview = GTK_TEXT_VIEW(entry_widget);
+	    _gtk_sheet_tile_area(sheet, trow, tcol, &cells, &tile_area);
 
-	gtk_text_view_set_wrap_mode(textview, colptr->wrap_mode);
-	gtk_data_text_view_set_max_length(data_textview, colptr->max_length);
-	gtk_data_text_view_set_max_length_bytes(data_textview, colptr->max_length_bytes);
+	    cairo_set_source_surface(cr, tile->surface, tile_area.x, tile_area.y);
+	    gdk_cairo_rectangle(cr, &tile_area);
+	    cairo_fill(cr);
+	}
     }
-    else if (GTK_IS_TEXT_VIEW(entry_widget))
-    {
-	GtkTextView *textview = GTK_TEXT_VIEW(entry_widget);
+    cairo_destroy(cr);
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-	g_debug("_gtk_sheet_entry_setup: GtkTextView justification %d", justification);
-#endif
-	gtk_text_view_set_justification(textview, justification);
-	gtk_text_view_set_wrap_mode(textview, colptr->wrap_mode);
-    }
-    else if (GTK_IS_ENTRY(entry_widget))
+    _gtk_sheet_tile_cache_trim(cache);
+
+    if (!cache->prerender_idle && (cache->drow || cache->dcol))
     {
-	GtkEntry *entry = GTK_ENTRY(entry_widget);
-	gtk_entry_set_max_length(entry, colptr->max_length);
+	cache->prerender_idle = g_idle_add_full(G_PRIORITY_LOW,
+	    _gtk_sheet_tile_prerender_handler, sheet, NULL);
     }
-
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("_gtk_sheet_entry_setup: style bg color %s",
-	gdk_color_to_string(&attributes.background));
+}
 #endif
 
-#if 1
-    if (gtk_widget_get_realized(entry_widget))
-    {
-	style = gtk_widget_get_style(entry_widget);
-	if (!style)
-	    gtk_widget_ensure_style(entry_widget);  /* why this ?? */
-	style = gtk_widget_get_style(entry_widget);
-
-	style = gtk_style_copy(style);
-
-	style->bg[GTK_STATE_NORMAL] = attributes.background;
-	style->base[GTK_STATE_NORMAL] = attributes.background;
-	style->fg[GTK_STATE_NORMAL] = attributes.foreground;
-	style->text[GTK_STATE_NORMAL] = attributes.foreground;
+#if GTK_SHEET_RENDER_THREADS
+/*
+ * threaded rendering
+ *
+ * Optionally, a damaged range is rendered by a pool of worker
+ * threads. The main thread takes a snapshot of the geometry,
+ * attributes and labels of the range, so the workers never touch
+ * the sheet. The area is cut into bands of whole rows. Each band
+ * is shaped and rendered into its part of one client-side image,
+ * which the main thread uploads when all bands are done. Workers
+ * use font maps of their own, which are not shared between
+ * threads.
+ */
 
-	style->bg[GTK_STATE_ACTIVE] = attributes.background;
-	style->base[GTK_STATE_ACTIVE] = attributes.background;
-	style->fg[GTK_STATE_ACTIVE] = attributes.foreground;
-	style->text[GTK_STATE_ACTIVE] = attributes.foreground;
+#define GTK_SHEET_RENDER_BAND_MIN_HEIGHT  32  /* pixels */
+#define GTK_SHEET_RENDER_BANDS_PER_THREAD  2  /* balances long labels */
 
-	pango_font_description_free(style->font_desc);
-	style->font_desc = pango_font_description_copy(attributes.font_desc);
+typedef struct _GtkSheetRenderFont
+{
+    PangoFontDescription *font_desc;  /* copy, NULL for the style font */
+    gint ascent, descent;             /* pixels */
+} GtkSheetRenderFont;
 
-	gtk_widget_set_style(entry_widget, style);
+typedef struct _GtkSheetRenderCell
+{
+    GdkColor foreground;
+    GdkColor background;
+    GtkSheetCellBorder border;
+    GtkJustification justification;
+    gint font;                 /* index into snapshot fonts */
+    gchar *label;              /* formatted text, NULL in the ring */
+    gint text_width;           /* returns the shaped label width */
+    guint has_text : 1;        /* stops text overflow */
+    guint has_tooltip : 1;
+} GtkSheetRenderCell;
+
+typedef struct _GtkSheetRenderSnapshot
+{
+    GtkSheetRange range;       /* cells to be rendered */
+    gint row0, col0;           /* sheet cell of cells[0], range - 1 */
+    gint nrows, ncols;         /* including a ring of neighbours */
+    gint *y, *height;          /* per row, height 0 when hidden */
+    gint *x, *width;           /* per column, width 0 when hidden */
+    gint *vjust;               /* per column */
+    gint *wrap_mode;           /* per column */
+    GtkSheetRenderCell *cells; /* nrows x ncols */
+    GArray *fonts;             /* GtkSheetRenderFont */
+
+    gboolean clip_text;
+    gboolean show_grid;
+    GdkColor grid_color;
+    GdkColor tm_color;
+
+    GdkRectangle area;         /* sheet window area of the image */
+    guchar *data;              /* image pixels */
+    gint stride;
+    GAsyncQueue *done;         /* finished bands */
+} GtkSheetRenderSnapshot;
+
+typedef struct _GtkSheetRenderBand
+{
+    GtkSheetRenderSnapshot *snap;
+    gint y, height;            /* sheet window pixels */
+} GtkSheetRenderBand;
+
+typedef struct _GtkSheetRenderContext
+{
+    PangoFontMap *font_map;
+    PangoContext *context;
+    guint serial;              /* pool font setup applied */
+} GtkSheetRenderContext;
 
-	g_object_unref(style); /* 22.06.13/fp */
-    }
-#endif
-}
+#define SNAPCELL(snap, r, c)  (&(snap)->cells[(r) * (snap)->ncols + (c)])
 
-static void
-gtk_sheet_show_active_cell(GtkSheet *sheet)
+/*
+ * _gtk_sheet_render_snapshot_new - copy what a range renders
+ *
+ * labels are formatted, attributes resolved and font metrics
+ * looked up here, on the main thread.
+ *
+ * @param sheet
+ * @param range  range including its text overflow columns
+ * @param area   sheet window area of the range
+ *
+ * @return the snapshot
+ */
+static GtkSheetRenderSnapshot *
+_gtk_sheet_render_snapshot_new(GtkSheet *sheet, const GtkSheetRange *range,
+    const GdkRectangle *area)
 {
-    gchar *text = NULL;
-    gchar *old_text;
-    gint row, col;
-    gboolean is_visible = TRUE;
+    GtkSheetRenderSnapshot *snap = g_new0(GtkSheetRenderSnapshot, 1);
+    GHashTable *font_index = g_hash_table_new(g_direct_hash, g_direct_equal);
+    gint r, c;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    snap->range.row0 = MAX(range->row0, 0);
+    snap->range.rowi = MIN(range->rowi, sheet->maxrow);
+    snap->range.col0 = MAX(range->col0, 0);
+    snap->range.coli = MIN(range->coli, sheet->maxcol);
 
-    row = sheet->active_cell.row;
-    col = sheet->active_cell.col;
+    snap->row0 = snap->range.row0 - 1;
+    snap->col0 = snap->range.col0 - 1;
+    snap->nrows = snap->range.rowi - snap->range.row0 + 3;
+    snap->ncols = snap->range.coli - snap->range.col0 + 3;
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug(
-        "gtk_sheet_show_active_cell: called row %d col %d insel %d", 
-        row, col, GTK_SHEET_IN_SELECTION(sheet));
-#endif
+    snap->y = g_new0(gint, snap->nrows);
+    snap->height = g_new0(gint, snap->nrows);
+    snap->x = g_new0(gint, snap->ncols);
+    snap->width = g_new0(gint, snap->ncols);
+    snap->vjust = g_new0(gint, snap->ncols);
+    snap->wrap_mode = g_new0(gint, snap->ncols);
+    snap->cells = g_new0(GtkSheetRenderCell, snap->nrows * snap->ncols);
+    snap->fonts = g_array_new(FALSE, FALSE, sizeof(GtkSheetRenderFont));
 
-    if (row < 0 || col < 0)
-	return;
-    if (row > sheet->maxrow || col > sheet->maxcol)
-	return;
+    snap->clip_text = gtk_sheet_clip_text(sheet);
+    snap->show_grid = sheet->show_grid;
+    snap->grid_color = sheet->grid_color;
+    snap->tm_color = sheet->tm_color;
+    snap->area = *area;
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
-    if (sheet->state != GTK_SHEET_NORMAL)
-	return;
-    if (GTK_SHEET_IN_SELECTION(sheet))
-	return;
-    if (!sheet->sheet_entry)   /* PR#102114 */
-	return;
+    for (r = 0; r < snap->nrows; r++)
+    {
+	gint row = snap->row0 + r;
 
-    /* we should send a ENTRY_CHANGE_REQUEST signal here */
+	if (row < 0 || row > sheet->maxrow)
+	    continue;
+	if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	    continue;
 
-    if ((row <= sheet->maxallocrow) && (col <= sheet->maxalloccol)
-	&& sheet->data[row])
-    {
-	GtkSheetCell *cell = sheet->data[row][col];
-	if (cell)
-	{
-	    if (cell->text)
-		text = g_strdup(cell->text);
-	    if (cell->attributes)
-		is_visible = cell->attributes->is_visible;
-	}
+	snap->y[r] = _gtk_sheet_row_top_ypixel(sheet, row);
+	snap->height[r] = ROW_HEIGHT(sheet, row);
     }
 
-    GtkWidget *entry_widget = gtk_sheet_get_entry(sheet);
+    for (c = 0; c < snap->ncols; c++)
+    {
+	gint col = snap->col0 + c;
+	GtkSheetColumn *colptr;
 
-    /* update visibility */
+	if (col < 0 || col > sheet->maxcol)
+	    continue;
 
-    gtk_widget_set_visible(GTK_WIDGET(sheet->sheet_entry), is_visible);
+	colptr = COLPTR(sheet, col);
+	if (!GTK_SHEET_COLUMN_IS_VISIBLE(colptr))
+	    continue;
 
-    if (GTK_IS_ENTRY(entry_widget))
-    {
-	gtk_entry_set_visibility(GTK_ENTRY(entry_widget), is_visible);
-    }
+	snap->x[c] = _gtk_sheet_column_left_xpixel(sheet, col);
+	snap->width[c] = colptr->width;
 
-    /* update text  */
+	/* column->vjust overrides sheet->vjust */
+	snap->vjust[c] = colptr->vjust;
+	if (snap->vjust[c] == GTK_SHEET_VERTICAL_JUSTIFICATION_DEFAULT)
+	    snap->vjust[c] = sheet->vjust;
 
-    if (!text)
-	text = g_strdup("");
+	snap->wrap_mode[c] = GTK_WRAP_NONE;
+	if (!gtk_sheet_autoresize_columns(sheet))
+	    snap->wrap_mode[c] = colptr->wrap_mode;
+    }
 
-    old_text = gtk_sheet_get_entry_text(sheet);
+    for (r = 0; r < snap->nrows; r++)
+    {
+	if (!snap->height[r])
+	    continue;
 
-    /* the entry setup must be done before the text assigment,
-       otherwise max_length may cause text assignment to fail
-       */
-    _gtk_sheet_entry_setup(sheet, row, col, entry_widget);
+	for (c = 0; c < snap->ncols; c++)
+	{
+	    GtkSheetRenderCell *rc = SNAPCELL(snap, r, c);
+	    gint row = snap->row0 + r, col = snap->col0 + c;
+	    GtkSheetCellAttr attributes;
+	    GtkSheetCell *cell;
+	    gchar *text, *dataformat;
+	    gpointer index;
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("gtk_sheet_show_active_cell: old_text <%s> text <%s>", old_text, text);
-#endif
+	    if (!snap->width[c])
+		continue;
 
-    if (!old_text || (old_text[0] != text[0]) || strcmp(old_text, text) != 0)
-    {
-	gtk_sheet_set_entry_text(sheet, text);
-    }
+	    gtk_sheet_get_attributes(sheet, row, col, &attributes);
 
-    /* we should send an ENTRY_CONFIGURATION signal here */
+	    rc->foreground = attributes.foreground;
+	    rc->background = attributes.background;
+	    rc->border = attributes.border;
+	    rc->justification = attributes.justification;
 
-    gtk_sheet_entry_set_max_size(sheet);
-    _gtk_sheet_entry_size_allocate(sheet);
+	    text = gtk_sheet_cell_get_text(sheet, row, col);  /* model aware */
+	    cell = _gtk_sheet_cell_get(sheet, row, col);
 
-    gtk_widget_map(sheet->sheet_entry);
-    gtk_sheet_draw_active_cell(sheet);
+	    rc->has_text = (text != NULL);
+	    rc->has_tooltip = (cell && (cell->tooltip_markup || cell->tooltip_text));
 
-    _gtk_sheet_entry_preselect(sheet);
+	    /* the ring contributes borders and overflow stops only */
+	    if (!rc->has_text
+		|| r == 0 || r == snap->nrows - 1 || c == 0 || c == snap->ncols - 1)
+		continue;
 
-    gtk_widget_grab_focus(entry_widget);
+	    dataformat = gtk_sheet_column_get_format(sheet, col);
+	    rc->label = g_strdup(dataformat ?
+		gtk_data_format(text, dataformat) : text);
+	    g_free(dataformat);
 
-    g_free(text);
-    g_free(old_text);
+	    if (!g_hash_table_lookup_extended(font_index,
+		attributes.font_desc, NULL, &index))
+	    {
+		const GtkSheetFontMetrics *fm =
+		    _gtk_sheet_font_metrics(sheet, attributes.font_desc);
+		GtkSheetRenderFont font;
+
+		font.font_desc = attributes.font_desc ?
+		    pango_font_description_copy(attributes.font_desc) : NULL;
+		font.ascent = fm ? fm->ascent / PANGO_SCALE : GTK_SHEET_DEFAULT_FONT_ASCENT;
+		font.descent = fm ? fm->descent / PANGO_SCALE : GTK_SHEET_DEFAULT_FONT_DESCENT;
+
+		index = GINT_TO_POINTER(snap->fonts->len);
+		g_array_append_val(snap->fonts, font);
+		g_hash_table_insert(font_index, attributes.font_desc, index);
+	    }
+	    rc->font = GPOINTER_TO_INT(index);
+	}
+    }
+
+    g_hash_table_destroy(font_index);
+    return (snap);
 }
 
 static void
-gtk_sheet_draw_active_cell(GtkSheet *sheet)
+_gtk_sheet_render_snapshot_free(GtkSheetRenderSnapshot *snap)
 {
-    gint row, col;
-
-    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
-	return;
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
+    guint i;
 
-    row = sheet->active_cell.row;
-    col = sheet->active_cell.col;
+    for (i = 0; i < (guint)(snap->nrows * snap->ncols); i++)
+	g_free(snap->cells[i].label);
 
-    if (row < 0 || row > sheet->maxrow)
-	return;
-    if (col < 0 || col > sheet->maxcol)
-	return;
+    for (i = 0; i < snap->fonts->len; i++)
+    {
+	GtkSheetRenderFont *font = &g_array_index(snap->fonts, GtkSheetRenderFont, i);
 
-    if (!gtk_sheet_cell_isvisible(sheet, row, col))
-	return;
+	if (font->font_desc)
+	    pango_font_description_free(font->font_desc);
+    }
+    g_array_free(snap->fonts, TRUE);
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("gtk_sheet_draw_active_cell: row %d col %d", row, col);
-#endif
+    g_free(snap->y);
+    g_free(snap->height);
+    g_free(snap->x);
+    g_free(snap->width);
+    g_free(snap->vjust);
+    g_free(snap->wrap_mode);
+    g_free(snap->cells);
+    g_free(snap->data);
 
-    row_button_set(sheet, row);
-    _gtk_sheet_column_button_set(sheet, col);
+    if (snap->done)
+	g_async_queue_unref(snap->done);
 
-    gtk_sheet_draw_backing_pixmap(sheet, sheet->range);
-    gtk_sheet_draw_border(sheet, sheet->range);
+    g_free(snap);
 }
 
-
+/*
+ * _gtk_sheet_band_backgrounds - fill the cell backgrounds of rows
+ *
+ * @param snap
+ * @param cr
+ * @param ra, rb  snapshot rows
+ */
 static void
-gtk_sheet_make_backing_pixmap(GtkSheet *sheet, guint width, guint height)
+_gtk_sheet_band_backgrounds(GtkSheetRenderSnapshot *snap, cairo_t *cr,
+    gint ra, gint rb)
 {
-    gint pixmap_width, pixmap_height;
-
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
+    gint r, c;
+    gboolean path_set = FALSE;
+    GdkColor path_color;
 
-    if (width == 0 && height == 0)
+    for (r = ra; r <= rb; r++)
     {
-	width = sheet->sheet_window_width + 80;
-	height = sheet->sheet_window_height + 80;
-    }
+	GdkColor run_color;
+	gint run_x = 0, run_width = 0;
 
-    if (!sheet->pixmap)
-    {
-	/* allocate */
-	sheet->pixmap = gdk_pixmap_new(sheet->sheet_window,
-	    width, height,
-	    -1);
-	if (!GTK_SHEET_IS_FROZEN(sheet))
-	    _gtk_sheet_range_draw(sheet, NULL, TRUE);
-    }
-    else
-    {
-	/* reallocate if sizes don't match */
-	gdk_window_get_size(sheet->pixmap, &pixmap_width, &pixmap_height);
+	if (!snap->height[r])
+	    continue;
 
-	if ((pixmap_width != width) || (pixmap_height != height))
+	for (c = 1; c < snap->ncols; c++)
 	{
-	    g_object_unref(G_OBJECT(sheet->pixmap));
-	    sheet->pixmap = gdk_pixmap_new(sheet->sheet_window,
-		width, height,
-		-1);
-	    if (!GTK_SHEET_IS_FROZEN(sheet))
-		_gtk_sheet_range_draw(sheet, NULL, TRUE);
-	}
-    }
-}
+	    GtkSheetRenderCell *rc = NULL;
 
-static void
-gtk_sheet_new_selection(GtkSheet *sheet, GtkSheetRange *range)
-{
-    gint i, j, mask1, mask2;
-    gint state, selected;
-    gint x, y, width, height;
-    GtkSheetRange new_range, aux_range;
+	    if (c < snap->ncols - 1)
+	    {
+		if (!snap->width[c])
+		    continue;  /* no width, keeps the run */
 
-    g_return_if_fail(sheet != NULL);
+		rc = SNAPCELL(snap, r, c);
 
-    if (range == NULL)
-	range = &sheet->range;
+		if (run_width > 0 && gdk_color_equal(&rc->background, &run_color))
+		{
+		    run_width += snap->width[c];
+		    continue;
+		}
+	    }
 
-    new_range = *range;
+	    if (run_width > 0)  /* add the finished run */
+	    {
+		if (path_set && !gdk_color_equal(&path_color, &run_color))
+		{
+		    gdk_cairo_set_source_color(cr, &path_color);
+		    cairo_fill(cr);
+		}
+		path_color = run_color;
+		path_set = TRUE;
 
-    range->row0 = MIN(range->row0, sheet->range.row0);
-    range->rowi = MAX(range->rowi, sheet->range.rowi);
-    range->col0 = MIN(range->col0, sheet->range.col0);
-    range->coli = MAX(range->coli, sheet->range.coli);
+		cairo_rectangle(cr, run_x, snap->y[r], run_width, snap->height[r]);
+	    }
 
-    range->row0 = MAX(range->row0, MIN_VIEW_ROW(sheet));
-    range->rowi = MIN(range->rowi, MAX_VIEW_ROW(sheet));
-    range->col0 = MAX(range->col0, MIN_VIEW_COLUMN(sheet));
-    range->coli = MIN(range->coli, MAX_VIEW_COLUMN(sheet));
+	    if (!rc)
+		break;
 
-    aux_range.row0 = MAX(new_range.row0, MIN_VIEW_ROW(sheet));
-    aux_range.rowi = MIN(new_range.rowi, MAX_VIEW_ROW(sheet));
-    aux_range.col0 = MAX(new_range.col0, MIN_VIEW_COLUMN(sheet));
-    aux_range.coli = MIN(new_range.coli, MAX_VIEW_COLUMN(sheet));
+	    run_x = snap->x[c];
+	    run_width = snap->width[c];
+	    run_color = rc->background;
+	}
+    }
 
-    for (i = range->row0; i <= range->rowi; i++)
+    if (path_set)
     {
-	if (i > sheet->maxrow)
-	    break;
+	gdk_cairo_set_source_color(cr, &path_color);
+	cairo_fill(cr);
+    }
+}
 
-	for (j = range->col0; j <= range->coli; j++)
+/*
+ * _gtk_sheet_band_tooltip_markers - mark cells having a tooltip
+ *
+ * @param snap
+ * @param cr
+ * @param ra, rb  snapshot rows
+ */
+static void
+_gtk_sheet_band_tooltip_markers(GtkSheetRenderSnapshot *snap, cairo_t *cr,
+    gint ra, gint rb)
+{
+    gint r, c;
+    gboolean found = FALSE;
+
+    for (r = ra; r <= rb; r++)
+    {
+	for (c = 1; c < snap->ncols - 1; c++)
 	{
-	    if (j > sheet->maxcol)
-		break;
+	    gint x, y;
 
-	    state = gtk_sheet_cell_get_state(sheet, i, j);
-	    selected = (i <= new_range.rowi && i >= new_range.row0 &&
-		j <= new_range.coli && j >= new_range.col0) ? TRUE : FALSE;
+	    if (!SNAPCELL(snap, r, c)->has_tooltip)
+		continue;
 
-	    if (state == GTK_STATE_SELECTED && selected &&
-		GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, j)) && GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, i)) &&
-		(i == sheet->range.row0 || i == sheet->range.rowi ||
-		    j == sheet->range.col0 || j == sheet->range.coli ||
-		    i == new_range.row0 || i == new_range.rowi ||
-		    j == new_range.col0 || j == new_range.coli))
-	    {
+	    x = snap->x[c] + snap->width[c];
+	    y = snap->y[r] + 1;
 
-		mask1 = i == sheet->range.row0 ? 1 : 0;
-		mask1 = i == sheet->range.rowi ? mask1 + 2 : mask1;
-		mask1 = j == sheet->range.col0 ? mask1 + 4 : mask1;
-		mask1 = j == sheet->range.coli ? mask1 + 8 : mask1;
+	    cairo_move_to(cr, x - GTK_SHEET_DEFAULT_TM_SIZE, y);
+	    cairo_line_to(cr, x, y);
+	    cairo_line_to(cr, x, y + GTK_SHEET_DEFAULT_TM_SIZE);
+	    cairo_close_path(cr);
+	    found = TRUE;
+	}
+    }
 
-		mask2 = i == new_range.row0 ? 1 : 0;
-		mask2 = i == new_range.rowi ? mask2 + 2 : mask2;
-		mask2 = j == new_range.col0 ? mask2 + 4 : mask2;
-		mask2 = j == new_range.coli ? mask2 + 8 : mask2;
+    if (found)
+    {
+	gdk_cairo_set_source_color(cr, &snap->tm_color);
+	cairo_fill(cr);
+    }
+}
 
-		if (mask1 != mask2)
-		{
-		    x = _gtk_sheet_column_left_xpixel(sheet, j);
-		    y = _gtk_sheet_row_top_ypixel(sheet, i);
-		    width = _gtk_sheet_column_left_xpixel(sheet, j) - x + COLPTR(sheet, j)->width;
-		    height = _gtk_sheet_row_top_ypixel(sheet, i) - y + sheet->row[i].height;
+/*
+ * _gtk_sheet_band_grid - draw the grid lines of rows
+ *
+ * same lines as _gtk_sheet_render_grid(), limited to the rows
+ *
+ * @param snap
+ * @param cr
+ * @param ra, rb  snapshot rows
+ */
+static void
+_gtk_sheet_band_grid(GtkSheetRenderSnapshot *snap, cairo_t *cr,
+    gint ra, gint rb)
+{
+    gint r, c, c0, ci, x0, x1, y0, y1;
 
-		    if (i == sheet->range.row0)
-		    {
-			y = y - 3;
-			height = height + 3;
-		    }
-		    if (i == sheet->range.rowi)
-			height = height + 3;
-		    if (j == sheet->range.col0)
-		    {
-			x = x - 3;
-			width = width + 3;
-		    }
-		    if (j == sheet->range.coli)
-			width = width + 3;
+    for (c0 = 1; c0 < snap->ncols - 1 && !snap->width[c0]; c0++) ;
+    for (ci = snap->ncols - 2; ci >= c0 && !snap->width[ci]; ci--) ;
+    while (ra <= rb && !snap->height[ra]) ra++;
+    while (rb >= ra && !snap->height[rb]) rb--;
 
-		    gdk_draw_pixmap(sheet->sheet_window,
-			gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-			sheet->pixmap,
-			x + 1,
-			y + 1,
-			x + 1,
-			y + 1,
-			width,
-			height);
+    if (c0 > ci || ra > rb)
+	return;
 
-		    if (i != sheet->active_cell.row || j != sheet->active_cell.col)
-		    {
-			x = _gtk_sheet_column_left_xpixel(sheet, j);
-			y = _gtk_sheet_row_top_ypixel(sheet, i);
-			width = _gtk_sheet_column_left_xpixel(sheet, j) - x + COLPTR(sheet, j)->width;
-			height = _gtk_sheet_row_top_ypixel(sheet, i) - y + sheet->row[i].height;
+    x0 = snap->x[c0];
+    x1 = snap->x[ci] + snap->width[ci];
+    y0 = snap->y[ra];
+    y1 = snap->y[rb] + snap->height[rb];
 
-			if (i == new_range.row0)
-			{
-			    y = y + 2;
-			    height = height - 2;
-			}
-			if (i == new_range.rowi)
-			    height = height - 3;
-			if (j == new_range.col0)
-			{
-			    x = x + 2;
-			    width = width - 2;
-			}
-			if (j == new_range.coli)
-			    width = width - 3;
+    /* on pixel centres, including the end point like X thin lines */
+    for (r = ra; r <= rb; r++)
+    {
+	if (!snap->height[r])
+	    continue;
 
-			gdk_draw_rectangle(sheet->sheet_window,
-			    sheet->xor_gc,
-			    TRUE,
-			    x + 1, y + 1,
-			    width, height);
-		    }
-		}
-	    }
-	}
+	cairo_move_to(cr, x0, snap->y[r] + 0.5);
+	cairo_line_to(cr, x1 + 1, snap->y[r] + 0.5);
     }
+    cairo_move_to(cr, x0, y1 + 0.5);
+    cairo_line_to(cr, x1 + 1, y1 + 0.5);
 
-    for (i = range->row0; i <= range->rowi; i++)
+    for (c = c0; c <= ci; c++)
     {
-	for (j = range->col0; j <= range->coli; j++)
-	{
-	    state = gtk_sheet_cell_get_state(sheet, i, j);
-	    selected = (i <= new_range.rowi && i >= new_range.row0 &&
-		j <= new_range.coli && j >= new_range.col0) ? TRUE : FALSE;
+	if (!snap->width[c])
+	    continue;
 
-	    if (state == GTK_STATE_SELECTED && !selected &&
-		GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, j)) &&
-		GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, i)))
-	    {
-		x = _gtk_sheet_column_left_xpixel(sheet, j);
-		y = _gtk_sheet_row_top_ypixel(sheet, i);
-		width = _gtk_sheet_column_left_xpixel(sheet, j) - x + COLPTR(sheet, j)->width;
-		height = _gtk_sheet_row_top_ypixel(sheet, i) - y + sheet->row[i].height;
+	cairo_move_to(cr, snap->x[c] + 0.5, y0);
+	cairo_line_to(cr, snap->x[c] + 0.5, y1 + 1);
+    }
+    cairo_move_to(cr, x1 + 0.5, y0);
+    cairo_line_to(cr, x1 + 0.5, y1 + 1);
 
-		if (i == sheet->range.row0)
-		{
-		    y = y - 3;
-		    height = height + 3;
-		}
-		if (i == sheet->range.rowi)
-		    height = height + 3;
-		if (j == sheet->range.col0)
-		{
-		    x = x - 3;
-		    width = width + 3;
-		}
-		if (j == sheet->range.coli)
-		    width = width + 3;
+    gdk_cairo_set_source_color(cr, &snap->grid_color);
+    cairo_set_line_width(cr, 1.0);
+    cairo_set_line_cap(cr, CAIRO_LINE_CAP_BUTT);
+    cairo_set_dash(cr, NULL, 0, 0.0);
+    cairo_stroke(cr);
+}
 
-		gdk_draw_pixmap(sheet->sheet_window,
-		    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-		    sheet->pixmap,
-		    x + 1,
-		    y + 1,
-		    x + 1,
-		    y + 1,
-		    width,
-		    height);
-	    }
-	}
-    }
+/*
+ * _gtk_sheet_band_border - draw the border of a cell
+ *
+ * same drawing as _gtk_sheet_render_border()
+ *
+ * @param snap
+ * @param cr
+ * @param r, c   snapshot cell
+ * @param mask   border sides to be drawn
+ */
+static void
+_gtk_sheet_band_border(GtkSheetRenderSnapshot *snap, cairo_t *cr,
+    gint r, gint c, gint mask)
+{
+    static const gdouble dashes[] = { 4.0, 4.0 };  /* X default */
+    GtkSheetCellBorder *border = &SNAPCELL(snap, r, c)->border;
+    gdouble x, y, w, h, half, offset;
 
-    for (i = range->row0; i <= range->rowi; i++)
-    {
-	for (j = range->col0; j <= range->coli; j++)
-	{
-	    state = gtk_sheet_cell_get_state(sheet, i, j);
-	    selected = (i <= new_range.rowi && i >= new_range.row0 &&
-		j <= new_range.coli && j >= new_range.col0) ? TRUE : FALSE;
+    if (!snap->height[r] || !snap->width[c])
+	return;
 
-	    if (state != GTK_STATE_SELECTED && selected &&
-		GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, j)) && GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, i)) &&
-		(i != sheet->active_cell.row || j != sheet->active_cell.col))
-	    {
-		x = _gtk_sheet_column_left_xpixel(sheet, j);
-		y = _gtk_sheet_row_top_ypixel(sheet, i);
-		width = _gtk_sheet_column_left_xpixel(sheet, j) - x + COLPTR(sheet, j)->width;
-		height = _gtk_sheet_row_top_ypixel(sheet, i) - y + sheet->row[i].height;
+    mask &= border->mask;
+    if (border->width == 0 || !mask)
+	return;
 
-		if (i == new_range.row0)
-		{
-		    y = y + 2;
-		    height = height - 2;
-		}
-		if (i == new_range.rowi)
-		    height = height - 3;
-		if (j == new_range.col0)
-		{
-		    x = x + 2;
-		    width = width - 2;
-		}
-		if (j == new_range.coli)
-		    width = width - 3;
+    x = snap->x[c];
+    y = snap->y[r];
+    w = snap->width[c];
+    h = snap->height[r];
 
-		gdk_draw_rectangle(sheet->sheet_window,
-		    sheet->xor_gc,
-		    TRUE,
-		    x + 1, y + 1,
-		    width, height);
-	    }
-	}
-    }
+    half = border->width / 2;
+    offset = (border->width & 1) ? 0.5 : 0.0;  /* pixel centres */
 
-    for (i = aux_range.row0; i <= aux_range.rowi; i++)
+    if (mask & GTK_SHEET_LEFT_BORDER)
     {
-	for (j = aux_range.col0; j <= aux_range.coli; j++)
-	{
-	    if (GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, j)) && GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, i)))
-	    {
-		state = gtk_sheet_cell_get_state(sheet, i, j);
+	cairo_move_to(cr, x + offset, y - half);
+	cairo_line_to(cr, x + offset, y + h + half + 1);
+    }
+    if (mask & GTK_SHEET_RIGHT_BORDER)
+    {
+	cairo_move_to(cr, x + w + offset, y - half);
+	cairo_line_to(cr, x + w + offset, y + h + half + 1);
+    }
+    if (mask & GTK_SHEET_TOP_BORDER)
+    {
+	cairo_move_to(cr, x - half, y + offset);
+	cairo_line_to(cr, x + w + half + 1, y + offset);
+    }
+    if (mask & GTK_SHEET_BOTTOM_BORDER)
+    {
+	cairo_move_to(cr, x - half, y + h + offset);
+	cairo_line_to(cr, x + w + half + 1, y + h + offset);
+    }
 
-		mask1 = i == sheet->range.row0 ? 1 : 0;
-		mask1 = i == sheet->range.rowi ? mask1 + 2 : mask1;
-		mask1 = j == sheet->range.col0 ? mask1 + 4 : mask1;
-		mask1 = j == sheet->range.coli ? mask1 + 8 : mask1;
+    gdk_cairo_set_source_color(cr, &border->color);
+    cairo_set_line_width(cr, border->width);
 
-		mask2 = i == new_range.row0 ? 1 : 0;
-		mask2 = i == new_range.rowi ? mask2 + 2 : mask2;
-		mask2 = j == new_range.col0 ? mask2 + 4 : mask2;
-		mask2 = j == new_range.coli ? mask2 + 8 : mask2;
-		if (mask2 != mask1 || (mask2 == mask1 && state != GTK_STATE_SELECTED))
-		{
-		    x = _gtk_sheet_column_left_xpixel(sheet, j);
-		    y = _gtk_sheet_row_top_ypixel(sheet, i);
-		    width = COLPTR(sheet, j)->width;
-		    height = sheet->row[i].height;
-		    if (mask2 & 1)
-			gdk_draw_rectangle(sheet->sheet_window,
-			    sheet->xor_gc,
-			    TRUE,
-			    x + 1, y - 1,
-			    width, 3);
-
-		    if (mask2 & 2)
-			gdk_draw_rectangle(sheet->sheet_window,
-			    sheet->xor_gc,
-			    TRUE,
-			    x + 1, y + height - 1,
-			    width, 3);
+    if (border->line_style == GDK_LINE_SOLID)
+	cairo_set_dash(cr, NULL, 0, 0.0);
+    else
+	cairo_set_dash(cr, dashes, G_N_ELEMENTS(dashes), 0.0);
 
-		    if (mask2 & 4)
-			gdk_draw_rectangle(sheet->sheet_window,
-			    sheet->xor_gc,
-			    TRUE,
-			    x - 1, y + 1,
-			    3, height);
+    switch(border->cap_style)
+    {
+	case GDK_CAP_ROUND:
+	    cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
+	    break;
+	case GDK_CAP_PROJECTING:
+	    cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+	    break;
+	default:
+	    cairo_set_line_cap(cr, CAIRO_LINE_CAP_BUTT);
+	    break;
+    }
 
-		    if (mask2 & 8)
-			gdk_draw_rectangle(sheet->sheet_window,
-			    sheet->xor_gc,
-			    TRUE,
-			    x + width - 1, y + 1,
-			    3, height);
-		}
-	    }
-	}
+    switch(border->join_style)
+    {
+	case GDK_JOIN_ROUND:
+	    cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+	    break;
+	case GDK_JOIN_BEVEL:
+	    cairo_set_line_join(cr, CAIRO_LINE_JOIN_BEVEL);
+	    break;
+	default:
+	    cairo_set_line_join(cr, CAIRO_LINE_JOIN_MITER);
+	    break;
     }
 
-    *range = new_range;
-    gtk_sheet_draw_corners(sheet, new_range);
+    cairo_stroke(cr);
 }
 
-static void
-gtk_sheet_draw_border(GtkSheet *sheet, GtkSheetRange new_range)
+/*
+ * _gtk_sheet_band_spread - widen a label into empty columns
+ *
+ * snapshot version of _cell_label_spread(). Columns beyond the
+ * snapshot are outside the image and need not be covered.
+ *
+ * @param snap
+ * @param r, c   snapshot cell
+ * @param step   -1 to the left, +1 to the right
+ * @param size   width covered so far
+ * @param limit  width needed
+ *
+ * @return the width covered
+ */
+static gint
+_gtk_sheet_band_spread(GtkSheetRenderSnapshot *snap,
+    gint r, gint c, gint step, gint size, gint limit)
 {
-    GdkRectangle clip_area, area;
-    gint i;
+    for (c += step; c >= 0 && c < snap->ncols; c += step)
+    {
+	if (!snap->width[c])
+	    continue;
+	if (SNAPCELL(snap, r, c)->has_text)
+	    break;
+	if (size >= limit)
+	    break;
 
-    area.x = _gtk_sheet_column_left_xpixel(sheet, new_range.col0);
-    area.y = _gtk_sheet_row_top_ypixel(sheet, new_range.row0);
-    area.width = _gtk_sheet_column_right_xpixel(sheet, new_range.coli) - area.x;
-    area.height = _gtk_sheet_row_bottom_ypixel(sheet, new_range.rowi) - area.y;
+	size += snap->width[c];
+    }
+    return (size);
+}
 
-    clip_area.x = sheet->row_title_area.width;
-    clip_area.y = sheet->column_title_area.height;
-    clip_area.width = sheet->sheet_window_width;
-    clip_area.height = sheet->sheet_window_height;
+/*
+ * _gtk_sheet_band_label - shape and draw the label of a cell
+ *
+ * same placement as _cell_place_label(), the shaped width is
+ * returned in the snapshot cell.
+ *
+ * @param snap
+ * @param context  pango context of the calling thread
+ * @param cr
+ * @param r, c     snapshot cell
+ */
+static void
+_gtk_sheet_band_label(GtkSheetRenderSnapshot *snap, PangoContext *context,
+    cairo_t *cr, gint r, gint c)
+{
+    GtkSheetRenderCell *rc = SNAPCELL(snap, r, c);
+    GtkSheetRenderFont *font = &g_array_index(snap->fonts, GtkSheetRenderFont, rc->font);
+    PangoLayout *layout;
+    PangoRectangle rect;
+    GdkRectangle area;
+    gint width = snap->width[c];
+    gint xoffset = 0, sizel, sizer, spacing, y_pos;
 
-    if (!sheet->row_titles_visible)
-	clip_area.x = 0;
-    if (!sheet->column_titles_visible)
-	clip_area.y = 0;
+    layout = pango_layout_new(context);
+    pango_layout_set_text(layout, rc->label, -1);
+    pango_layout_set_font_description(layout, font->font_desc);
 
-    if (area.x < 0)
-    {
-	area.width = area.width + area.x;
-	area.x = 0;
-    }
-    if (area.width > clip_area.width)
-	area.width = clip_area.width + 10;
-    if (area.y < 0)
+    switch(snap->wrap_mode[c])
     {
-	area.height = area.height + area.y;
-	area.y = 0;
+	case GTK_WRAP_CHAR:
+	    pango_layout_set_width(layout, width * PANGO_SCALE);
+	    pango_layout_set_wrap(layout, PANGO_WRAP_CHAR);
+	    break;
+
+	case GTK_WRAP_WORD:
+	    pango_layout_set_width(layout, width * PANGO_SCALE);
+	    pango_layout_set_wrap(layout, PANGO_WRAP_WORD);
+	    break;
+
+	case GTK_WRAP_WORD_CHAR:
+	    pango_layout_set_width(layout, width * PANGO_SCALE);
+	    pango_layout_set_wrap(layout, PANGO_WRAP_WORD_CHAR);
+	    break;
+
+	default:
+	    break;
     }
-    if (area.height > clip_area.height)
-	area.height = clip_area.height + 10;
 
-#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
-    g_debug("gtk_sheet_draw_border: clip_area (%d, %d, %d, %d)",
-	clip_area.x, clip_area.y, clip_area.width, clip_area.height);
-#endif
+    pango_layout_get_pixel_extents(layout, NULL, &rect);
+    rc->text_width = rect.width;
 
-    clip_area.x--;
-    clip_area.y--;
-    clip_area.width += 3;
-    clip_area.height += 3;
+    area.x = snap->x[c];
+    area.y = snap->y[r];
+    area.width = width;
+    area.height = snap->height[r];
 
-    gdk_gc_set_clip_rectangle(sheet->xor_gc, &clip_area);
+    spacing = pango_layout_get_spacing(layout) / PANGO_SCALE;
 
-    for (i = -1; i <= 1; ++i)
+    switch(snap->vjust[c])
     {
-	gdk_draw_rectangle(sheet->sheet_window,
-	    sheet->xor_gc,
-	    FALSE,
-	    area.x + i, area.y + i,
-	    area.width - 2 * i, area.height - 2 * i);
-    }
+	case GTK_SHEET_VERTICAL_JUSTIFICATION_MIDDLE:
+	    {
+		gint line_height = font->ascent + font->descent + spacing;
+		gint area_lines = area.height / line_height;
+		gint text_lines = rect.height / line_height;
 
-    gdk_gc_set_clip_rectangle(sheet->xor_gc, NULL);
-    gtk_sheet_draw_corners(sheet, new_range);
-}
+		y_pos = CELLOFFSET - ((text_lines - area_lines) / 2) * line_height;
+	    }
+	    break;
 
-static void
-gtk_sheet_draw_corners(GtkSheet *sheet, GtkSheetRange range)
-{
-    gint x, y;
-    guint width = 1;
+	case GTK_SHEET_VERTICAL_JUSTIFICATION_BOTTOM:
+	    {
+		gint line_height = font->ascent + font->descent + spacing;
+		gint area_lines = area.height / line_height;
 
-    if (gtk_sheet_cell_isvisible(sheet, range.row0, range.col0))
-    {
-	x = _gtk_sheet_column_left_xpixel(sheet, range.col0);
-	y = _gtk_sheet_row_top_ypixel(sheet, range.row0);
-	gdk_draw_pixmap(sheet->sheet_window,
-	    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-	    sheet->pixmap,
-	    x - 1,
-	    y - 1,
-	    x - 1,
-	    y - 1,
-	    3,
-	    3);
-	gdk_draw_rectangle(sheet->sheet_window,
-	    sheet->xor_gc,
-	    TRUE,
-	    x - 1, y - 1,
-	    3, 3);
+		y_pos = CELLOFFSET + area_lines * line_height - rect.height;
+	    }
+	    break;
+
+	default:
+	    y_pos = CELLOFFSET;
+	    break;
     }
 
-    if (gtk_sheet_cell_isvisible(sheet, range.row0, range.coli) ||
-	sheet->state == GTK_SHEET_COLUMN_SELECTED)
+    switch(rc->justification)
     {
-	x = _gtk_sheet_column_left_xpixel(sheet, range.coli) +
-	    COLPTR(sheet, range.coli)->width;
-	y = _gtk_sheet_row_top_ypixel(sheet, range.row0);
-	width = 1;
-	if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
-	{
-	    y = _gtk_sheet_row_top_ypixel(sheet, sheet->view.row0) + 3;
-	    width = 3;
-	}
-	gdk_draw_pixmap(sheet->sheet_window,
-	    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-	    sheet->pixmap,
-	    x - width,
-	    y - width,
-	    x - width,
-	    y - width,
-	    2 * width + 1,
-	    2 * width + 1);
-	gdk_draw_rectangle(sheet->sheet_window,
-	    sheet->xor_gc,
-	    TRUE,
-	    x - width + width / 2, y - width + width / 2,
-	    2 + width, 2 + width);
+	case GTK_JUSTIFY_RIGHT:
+	    sizel = snap->clip_text ? width :
+		_gtk_sheet_band_spread(snap, r, c, -1, width, rect.width + CELLOFFSET);
+	    area.x += width - sizel;
+	    area.width = sizel;
+	    xoffset += sizel - rect.width - 2 * CELLOFFSET - rc->border.width / 2;
+	    break;
+
+	case GTK_JUSTIFY_CENTER:
+	    sizel = sizer = width / 2;
+	    if (!snap->clip_text)
+	    {
+		sizer = _gtk_sheet_band_spread(snap, r, c, 1, sizer, rect.width / 2);
+		sizel = _gtk_sheet_band_spread(snap, r, c, -1, sizel, rect.width / 2);
+		area.width = sizel + sizer;
+	    }
+	    area.x += width / 2 - sizel;
+	    xoffset += sizel - rect.width / 2 - CELLOFFSET;
+	    break;
+
+	case GTK_JUSTIFY_LEFT:
+	default:
+	    if (!snap->clip_text)
+		area.width = _gtk_sheet_band_spread(snap, r, c, 1, width, rect.width + CELLOFFSET);
+	    xoffset += rc->border.width / 2;
+	    break;
     }
 
-    if (gtk_sheet_cell_isvisible(sheet, range.rowi, range.col0) ||
-	sheet->state == GTK_SHEET_ROW_SELECTED)
+    if (snap->clip_text)  /* clip to the cell */
     {
-	x = _gtk_sheet_column_left_xpixel(sheet, range.col0);
-	y = _gtk_sheet_row_top_ypixel(sheet, range.rowi) +
-	    sheet->row[range.rowi].height;
-	width = 1;
-	if (sheet->state == GTK_SHEET_ROW_SELECTED)
-	{
-	    x = _gtk_sheet_column_left_xpixel(sheet, sheet->view.col0) + 3;
-	    width = 3;
-	}
-	gdk_draw_pixmap(sheet->sheet_window,
-	    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-	    sheet->pixmap,
-	    x - width,
-	    y - width,
-	    x - width,
-	    y - width,
-	    2 * width + 1,
-	    2 * width + 1);
-	gdk_draw_rectangle(sheet->sheet_window,
-	    sheet->xor_gc,
-	    TRUE,
-	    x - width + width / 2, y - width + width / 2,
-	    2 + width, 2 + width);
+	area.x = snap->x[c];
+	area.width = width;
     }
 
-    if (gtk_sheet_cell_isvisible(sheet, range.rowi, range.coli))
-    {
-	x = _gtk_sheet_column_left_xpixel(sheet, range.coli) +
-	    COLPTR(sheet, range.coli)->width;
-	y = _gtk_sheet_row_top_ypixel(sheet, range.rowi) +
-	    sheet->row[range.rowi].height;
-	width = 1;
-	if (sheet->state == GTK_SHEET_RANGE_SELECTED)
-	    width = 3;
-	if (sheet->state == GTK_SHEET_NORMAL)
-	    width = 3;
-	gdk_draw_pixmap(sheet->sheet_window,
-	    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-	    sheet->pixmap,
-	    x - width,
-	    y - width,
-	    x - width,
-	    y - width,
-	    2 * width + 1,
-	    2 * width + 1);
-	gdk_draw_rectangle(sheet->sheet_window,
-	    sheet->xor_gc,
-	    TRUE,
-	    x - width + width / 2, y - width + width / 2,
-	    2 + width, 2 + width);
+    cairo_save(cr);
+    gdk_cairo_rectangle(cr, &area);
+    cairo_clip(cr);
 
-    }
+    gdk_cairo_set_source_color(cr, &rc->foreground);
+    cairo_move_to(cr, area.x + xoffset + CELLOFFSET, area.y + y_pos);
+    pango_cairo_show_layout(cr, layout);
 
-}
+    cairo_restore(cr);
 
+    g_object_unref(layout);
+}
 
+/*
+ * _gtk_sheet_render_context_setup - apply the sheet font setup
+ *
+ * @param pool
+ * @param ctx   context of the calling thread
+ */
 static void
-gtk_sheet_real_select_range(GtkSheet *sheet, GtkSheetRange *range)
+_gtk_sheet_render_context_setup(GtkSheetRenderPool *pool,
+    GtkSheetRenderContext *ctx)
 {
-    gint i;
-    gint state;
+    if (!ctx->font_map)
+	ctx->font_map = pango_cairo_font_map_new();
 
-    g_return_if_fail(sheet != NULL);
+    if (ctx->context)
+	g_object_unref(ctx->context);
 
-    if (range == NULL)
-	range = &sheet->range;
+    ctx->context = pango_font_map_create_context(ctx->font_map);
 
-    if (range->row0 < 0 || range->rowi < 0)
-	return;
-    if (range->col0 < 0 || range->coli < 0)
-	return;
+    pango_cairo_context_set_resolution(ctx->context, pool->resolution);
+    pango_cairo_context_set_font_options(ctx->context, pool->font_options);
+    pango_context_set_language(ctx->context, pool->language);
+    pango_context_set_base_dir(ctx->context, pool->base_dir);
+    pango_context_set_font_description(ctx->context, pool->font_desc);
 
-#if GTK_SHEET_DEBUG_SELECTION > 0
-    g_debug("gtk_sheet_real_select_range: {%d, %d, %d, %d}",
-	range->row0, range->col0, range->rowi, range->coli);
-#endif
+    ctx->serial = pool->serial;
+}
 
-    state = sheet->state;
+/*
+ * _gtk_sheet_render_band - render a band, in a worker thread
+ *
+ * renders the snapshot rows crossing the band into the band's part
+ * of the image. Only reads the snapshot, except for the shaped
+ * label widths of its own rows.
+ *
+ * @param data       the #GtkSheetRenderBand
+ * @param user_data  the #GtkSheetRenderPool
+ */
+static void
+_gtk_sheet_render_band(gpointer data, gpointer user_data)
+{
+    GtkSheetRenderBand *band = data;
+    GtkSheetRenderPool *pool = user_data;
+    GtkSheetRenderSnapshot *snap = band->snap;
+    GtkSheetRenderContext *ctx;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    gint r, c, ra = snap->nrows, rb = 0, r0, r1;
+
+    /* a context is used by one thread at a time */
+    ctx = g_async_queue_try_pop(pool->contexts);
+    if (!ctx)
+	ctx = g_new0(GtkSheetRenderContext, 1);
+    if (!ctx->context || ctx->serial != pool->serial)
+	_gtk_sheet_render_context_setup(pool, ctx);
+
+    for (r = 1; r < snap->nrows - 1; r++)
+    {
+	if (!snap->height[r])
+	    continue;
+	if (snap->y[r] >= band->y + band->height
+	    || snap->y[r] + snap->height[r] <= band->y)
+	    continue;
 
-    if (state == GTK_SHEET_COLUMN_SELECTED || state == GTK_SHEET_RANGE_SELECTED)
-    {
-	for (i = sheet->range.col0; i < range->col0; i++) _gtk_sheet_column_button_release(sheet, i);
+	ra = MIN(ra, r);
+	rb = MAX(rb, r);
+    }
 
-	for (i = range->coli + 1; i <= sheet->range.coli; i++) _gtk_sheet_column_button_release(sheet, i);
+    surface = cairo_image_surface_create_for_data(
+	snap->data + (band->y - snap->area.y) * snap->stride,
+	CAIRO_FORMAT_RGB24, snap->area.width, band->height, snap->stride);
 
-	for (i = range->col0; i <= range->coli; i++)
-	{
-	    _gtk_sheet_column_button_set(sheet, i);
-	}
-    }
+    cr = cairo_create(surface);
+    cairo_translate(cr, -snap->area.x, -band->y);
 
-    if (state == GTK_SHEET_ROW_SELECTED || state == GTK_SHEET_RANGE_SELECTED)
+    if (ra <= rb)
     {
-	for (i = sheet->range.row0; i < range->row0; i++) row_button_release(sheet, i);
-
-	for (i = range->rowi + 1; i <= sheet->range.rowi; i++) row_button_release(sheet, i);
+	_gtk_sheet_band_backgrounds(snap, cr, ra, rb);
+	_gtk_sheet_band_tooltip_markers(snap, cr, ra, rb);
 
-	for (i = range->row0; i <= range->rowi; i++)
-	{
-	    row_button_set(sheet, i);
-	}
+	if (snap->show_grid)
+	    _gtk_sheet_band_grid(snap, cr, ra, rb);
     }
 
-    if (range->coli != sheet->range.coli || range->col0 != sheet->range.col0 ||
-	range->rowi != sheet->range.rowi || range->row0 != sheet->range.row0)
+    /* borders reaching into the band, from the visible rows around it */
+    for (r0 = ra - 1; r0 > 1 && !snap->height[r0]; r0--) ;
+    for (r1 = rb + 1; r1 < snap->nrows - 2 && !snap->height[r1]; r1++) ;
+    r0 = MAX(r0, 1);
+    r1 = MIN(r1, snap->nrows - 2);
+
+    for (r = r0; r <= r1; r++)
     {
-	gtk_sheet_new_selection(sheet, range);
+	for (c = 1; c < snap->ncols - 1; c++)
+	    _gtk_sheet_band_border(snap, cr, r, c, 15);
+    }
 
-	sheet->range.col0 = range->col0;
-	sheet->range.coli = range->coli;
-	sheet->range.row0 = range->row0;
-	sheet->range.rowi = range->rowi;
+    /* neighbours only on the facing side */
+    for (c = 1; c < snap->ncols - 1; c++)
+    {
+	if (band->y == snap->area.y)
+	    _gtk_sheet_band_border(snap, cr, 0, c, GTK_SHEET_BOTTOM_BORDER);
+	if (band->y + band->height == snap->area.y + snap->area.height)
+	    _gtk_sheet_band_border(snap, cr, snap->nrows - 1, c, GTK_SHEET_TOP_BORDER);
     }
-    else
+    for (r = r0; r <= r1; r++)
     {
-	gtk_sheet_draw_backing_pixmap(sheet, sheet->range);
-	gtk_sheet_range_draw_selection(sheet, sheet->range);
+	_gtk_sheet_band_border(snap, cr, r, 0, GTK_SHEET_RIGHT_BORDER);
+	_gtk_sheet_band_border(snap, cr, r, snap->ncols - 1, GTK_SHEET_LEFT_BORDER);
     }
 
-    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[SELECT_RANGE], 0, range);
+    for (r = ra; r <= rb; r++)
+    {
+	for (c = 1; c < snap->ncols - 1; c++)
+	{
+	    if (SNAPCELL(snap, r, c)->label)
+		_gtk_sheet_band_label(snap, ctx->context, cr, r, c);
+	}
+    }
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+
+    g_async_queue_push(pool->contexts, ctx);
+    g_async_queue_push(snap->done, band);
 }
 
-/**
- * gtk_sheet_select_range:
- * @sheet: a #GtkSheet
- * @range: a #GtkSheetRange
+/*
+ * threaded extent measuring
  *
- * Highlight the selected range and store bounds in sheet->range
+ * The main thread resolves the attributes of the cells to measure 
+ * and reduces them to distinct font, text and wrapping keys. The 
+ * render threads measure slices of these keys with their own 
+ * contexts, then the main thread stores and counts the extents.
  */
-void
-gtk_sheet_select_range(GtkSheet *sheet, const GtkSheetRange *range)
+
+typedef struct _GtkSheetExtentJob
 {
-    GtkSheetRange new_range;  /* buffer needed because gtk_sheet_real_unselect_range() will clear it */
+    GtkSheetExtentKey key;     /* text and font_desc borrowed */
+    guint width, height;       /* pixels */
+} GtkSheetExtentJob;
 
-    g_return_if_fail(sheet != NULL);
+typedef struct _GtkSheetExtentItem
+{
+    GtkSheetCell *cell;
+    GtkSheetExtentJob *job;
+    gint border_width;
+    gboolean is_visible;
+} GtkSheetExtentItem;
 
-    if (!range)
-	range = &sheet->range;
+typedef struct _GtkSheetExtentSlice
+{
+    GtkSheetExtentJob **jobs;
+    guint n;
+    GAsyncQueue *done;         /* finished slices */
+} GtkSheetExtentSlice;
 
-    new_range = *range;
+/*
+ * _gtk_sheet_measure_slice - measure a slice of keys, in a worker 
+ * thread
+ *
+ * lays out the keys like _get_string_extent() does, reusing one 
+ * layout for the whole slice
+ *
+ * @param data       the #GtkSheetExtentSlice
+ * @param user_data  the #GtkSheetRenderPool
+ */
+static void
+_gtk_sheet_measure_slice(gpointer data, gpointer user_data)
+{
+    GtkSheetExtentSlice *slice = data;
+    GtkSheetRenderPool *pool = user_data;
+    GtkSheetRenderContext *ctx;
+    PangoLayout *layout;
+    PangoRectangle extent;
+    guint i;
 
-    if (new_range.row0 < 0 || new_range.rowi < 0)
-	return;
-    if (new_range.col0 < 0 || new_range.coli < 0)
-	return;
+    ctx = g_async_queue_try_pop(pool->contexts);
+    if (!ctx)
+	ctx = g_new0(GtkSheetRenderContext, 1);
+    if (!ctx->context || ctx->serial != pool->serial)
+	_gtk_sheet_render_context_setup(pool, ctx);
 
-    if (sheet->state != GTK_SHEET_NORMAL)
-    {
-	/* this will clear sheet->range */
-	gtk_sheet_real_unselect_range(sheet, NULL);
-    }
-    else
+    layout = pango_layout_new(ctx->context);
+
+    for (i = 0; i < slice->n; i++)
     {
-	gboolean veto = TRUE;
-	veto = gtk_sheet_deactivate_cell(sheet);
-	if (!veto)
-	    return;
-    }
+	GtkSheetExtentJob *job = slice->jobs[i];
 
-    sheet->range.row0 = new_range.row0;
-    sheet->range.rowi = new_range.rowi;
-    sheet->range.col0 = new_range.col0;
-    sheet->range.coli = new_range.coli;
+	pango_layout_set_font_description(layout, job->key.font_desc);
+	pango_layout_set_text(layout, job->key.text, -1);
 
-    sheet->active_cell.row = new_range.row0;
-    sheet->active_cell.col = new_range.col0;
+	switch(job->key.wrap_mode)
+	{
+	    case GTK_WRAP_CHAR:
+		pango_layout_set_wrap(layout, PANGO_WRAP_CHAR);
+		break;
 
-    sheet->selection_cell.row = new_range.rowi;
-    sheet->selection_cell.col = new_range.coli;
+	    case GTK_WRAP_WORD:
+		pango_layout_set_wrap(layout, PANGO_WRAP_WORD);
+		break;
 
-    sheet->state = GTK_SHEET_RANGE_SELECTED;
-    gtk_sheet_real_select_range(sheet, NULL);
+	    case GTK_WRAP_WORD_CHAR:
+		pango_layout_set_wrap(layout, PANGO_WRAP_WORD_CHAR);
+		break;
 
-}
-/**
- * gtk_sheet_unselect_range:
- * @sheet: a #GtkSheet
- *
- * Unselect the current selected range and clears the bounds in sheet->range.
- */
-void
-gtk_sheet_unselect_range(GtkSheet *sheet)
-{
-    gtk_sheet_real_unselect_range(sheet, NULL);
-    sheet->state = GTK_SHEET_NORMAL;
-    gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
-}
+	    default:
+		break;
+	}
+	pango_layout_set_width(layout, job->key.wrap_width < 0 ?
+	    -1 : job->key.wrap_width * PANGO_SCALE);
 
+	pango_layout_get_pixel_extents(layout, NULL, &extent);
 
-static void
-gtk_sheet_real_unselect_range(GtkSheet *sheet, GtkSheetRange *range)
-{
-    gint i;
+	job->width = extent.width;
+	job->height = extent.height;
+    }
 
-    g_return_if_fail(sheet != NULL);
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
+    g_object_unref(layout);
 
-    if (!range)
-	range = &sheet->range;
+    g_async_queue_push(pool->contexts, ctx);
+    g_async_queue_push(slice->done, slice);
+}
 
-#if GTK_SHEET_DEBUG_SELECTION > 0
-    g_debug("gtk_sheet_real_unselect_range: called {%d, %d, %d, %d}",
-	range->row0, range->col0, range->rowi, range->coli);
-#endif
+static GtkSheetRenderPool *
+_gtk_sheet_render_pool_new(guint n_threads)
+{
+    GtkSheetRenderPool *pool;
+    GError *error = NULL;
+    const gchar *mismatch;
 
-    if (range->row0 < 0 || range->rowi < 0)
-	return;
-    if (range->col0 < 0 || range->coli < 0)
-	return;
+    mismatch = pango_version_check(GTK_SHEET_PANGO_THREADSAFE_MAJOR,
+	GTK_SHEET_PANGO_THREADSAFE_MINOR, 0);
+    if (mismatch)
+    {
+	g_warning("_gtk_sheet_render_pool_new: pango is not thread-safe, %s",
+	    mismatch);
+	return (NULL);
+    }
 
-    if (gtk_sheet_range_isvisible(sheet, *range))
+    pool = g_new0(GtkSheetRenderPool, 1);
+    pool->n_threads = n_threads;
+    pool->contexts = g_async_queue_new();
+    pool->pool = g_thread_pool_new(_gtk_sheet_render_band, pool,
+	n_threads, FALSE, &error);
+    if (pool->pool)
     {
-#if GTK_SHEET_DEBUG_SELECTION > 0
-	g_debug("gtk_sheet_real_unselect_range: gtk_sheet_draw_backing_pixmap");
-#endif
-	gtk_sheet_draw_backing_pixmap(sheet, *range);
+	pool->extent_pool = g_thread_pool_new(_gtk_sheet_measure_slice, pool,
+	    n_threads, FALSE, &error);
     }
 
-    for (i = range->col0; i <= range->coli; i++)
+    if (!pool->extent_pool)
     {
-#if GTK_SHEET_DEBUG_SELECTION > 0
-	g_debug("gtk_sheet_real_unselect_range: _gtk_sheet_column_button_release(%d)", i);
-#endif
-	_gtk_sheet_column_button_release(sheet, i);
+	g_warning("_gtk_sheet_render_pool_new: %s", error->message);
+	g_error_free(error);
+	if (pool->pool)
+	    g_thread_pool_free(pool->pool, FALSE, TRUE);
+	g_async_queue_unref(pool->contexts);
+	g_free(pool);
+	return (NULL);
     }
+    return (pool);
+}
 
-    for (i = range->row0; i <= range->rowi; i++)
+static void
+_gtk_sheet_render_pool_free(GtkSheetRenderPool *pool)
+{
+    GtkSheetRenderContext *ctx;
+
+    g_thread_pool_free(pool->pool, FALSE, TRUE);
+    g_thread_pool_free(pool->extent_pool, FALSE, TRUE);
+
+    while ((ctx = g_async_queue_try_pop(pool->contexts)))
     {
-#if GTK_SHEET_DEBUG_SELECTION > 0
-	g_debug("gtk_sheet_real_unselect_range: row_button_release(%d)", i);
-#endif
-	row_button_release(sheet, i);
+	if (ctx->context)
+	    g_object_unref(ctx->context);
+	if (ctx->font_map)
+	    g_object_unref(ctx->font_map);
+	g_free(ctx);
     }
+    g_async_queue_unref(pool->contexts);
 
-#if GTK_SHEET_DEBUG_SELECTION > 0
-    g_debug("gtk_sheet_real_unselect_range: gtk_sheet_position_children()");
-#endif
-    gtk_sheet_position_children(sheet);
+    if (pool->font_options)
+	cairo_font_options_destroy(pool->font_options);
+    if (pool->font_desc)
+	pango_font_description_free(pool->font_desc);
 
-    /* reset range */
-    range->row0 = range->rowi = range->col0 = range->coli = -1;
+    g_free(pool);
 }
 
+/*
+ * _gtk_sheet_render_pool_update - pick up the sheet font setup
+ *
+ * must not be called while bands are rendered
+ *
+ * @param pool
+ * @param sheet
+ */
+static void
+_gtk_sheet_render_pool_update(GtkSheetRenderPool *pool, GtkSheet *sheet)
+{
+    PangoContext *context = gtk_widget_get_pango_context(GTK_WIDGET(sheet));
+    const cairo_font_options_t *font_options =
+	pango_cairo_context_get_font_options(context);
+    const PangoFontDescription *font_desc =
+	pango_context_get_font_description(context);
+    gdouble resolution = pango_cairo_context_get_resolution(context);
+    PangoLanguage *language = pango_context_get_language(context);
+    PangoDirection base_dir = pango_context_get_base_dir(context);
+
+    if (pool->serial
+	&& resolution == pool->resolution
+	&& language == pool->language
+	&& base_dir == pool->base_dir
+	&& (font_options ?
+	    pool->font_options && cairo_font_options_equal(font_options, pool->font_options)
+	    : !pool->font_options)
+	&& (font_desc ?
+	    pool->font_desc && pango_font_description_equal(font_desc, pool->font_desc)
+	    : !pool->font_desc))
+    {
+	return;
+    }
+
+    if (pool->font_options)
+	cairo_font_options_destroy(pool->font_options);
+    if (pool->font_desc)
+	pango_font_description_free(pool->font_desc);
+
+    pool->font_options = font_options ? cairo_font_options_copy(font_options) : NULL;
+    pool->font_desc = font_desc ? pango_font_description_copy(font_desc) : NULL;
+    pool->resolution = resolution;
+    pool->language = language;
+    pool->base_dir = base_dir;
+    pool->serial++;
+}
 
 /*
- * gtk_sheet_expose_handler:
- * 
- * this is the #GtkSheet widget class "expose-event" signal handler
- * 
- * @param widget the #GtkSheet
- * @param event  the GdkEventExpose which triggered this signal
- * 
- * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
+ * _gtk_sheet_measure_cells_threaded - measure cell extents by 
+ * worker threads
+ *
+ * distinct keys already in the extent cache are not measured 
+ * again, newly measured keys are added to it. Blocks until all 
+ * slices are done.
+ *
+ * @param sheet
+ * @param cells  #GtkSheetCell flagged GTK_SHEET_CELL_EXTENT_DIRTY
  */
-static gboolean
-gtk_sheet_expose_handler(GtkWidget *widget, GdkEventExpose *event)
+static void
+_gtk_sheet_measure_cells_threaded(GtkSheet *sheet, GPtrArray *cells)
 {
-    GtkSheet *sheet;
-    gint i;
+    GtkSheetRenderPool *pool = sheet->render_pool;
+    GtkSheetExtentItem *items;
+    GtkSheetExtentSlice *slices;
+    GHashTable *keys;
+    GPtrArray *jobs;
+    PangoFontDescription *last_font = NULL;
+    guint last_hash = 0;
+    guint i, nslices, per_slice;
 
-    g_return_val_if_fail(widget != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(widget), FALSE);
-    g_return_val_if_fail(event != NULL, FALSE);
+    _gtk_sheet_render_pool_update(pool, sheet);
 
-    sheet = GTK_SHEET(widget);
+    items = g_new(GtkSheetExtentItem, cells->len);
+    keys = g_hash_table_new_full(_gtk_sheet_extent_key_hash,
+	_gtk_sheet_extent_key_equal, NULL, g_free);
+    jobs = g_ptr_array_new();
 
-    if (gtk_widget_is_drawable(widget))
+    for (i = 0; i < cells->len; i++)
     {
-#if GTK_SHEET_DEBUG_EXPOSE > 0
-	g_debug("gtk_sheet_expose_handler: called");
-#endif
+	GtkSheetCell *cell = g_ptr_array_index(cells, i);
+	GtkSheetColumn *colptr = COLPTR(sheet, cell->col);
+	GtkSheetCellAttr attributes;
+	GtkSheetExtentKey key;
+	GtkSheetExtentJob *job;
 
-	if (event->window == sheet->row_title_window && sheet->row_titles_visible)
+	gtk_sheet_get_attributes(sheet, cell->row, cell->col, &attributes);
+
+	if (attributes.font_desc != last_font || i == 0)
 	{
-#if GTK_SHEET_DEBUG_EXPOSE > 0
-	    g_debug("gtk_sheet_expose_handler: row buttons");
-#endif
-	    for (i = MIN_VIEW_ROW(sheet); i <= MAX_VIEW_ROW(sheet) && i <= sheet->maxrow; i++)
-	    {
-		_gtk_sheet_draw_button(sheet, i, -1);
-	    }
+	    last_font = attributes.font_desc;
+	    last_hash = last_font ? pango_font_description_hash(last_font) : 0;
 	}
 
-	if (event->window == sheet->column_title_window && sheet->column_titles_visible)
+	key.font_desc = attributes.font_desc;
+	key.text = cell->text;
+	key.font_hash = last_hash;
+	key.wrap_mode = GTK_WRAP_NONE;
+	key.wrap_width = -1;
+
+	if (!gtk_sheet_autoresize_columns(sheet)
+	    && colptr->wrap_mode != GTK_WRAP_NONE)
 	{
-#if GTK_SHEET_DEBUG_EXPOSE > 0
-	    g_debug("gtk_sheet_expose_handler: column buttons");
-#endif
-	    for (i = MIN_VIEW_COLUMN(sheet); i <= MAX_VIEW_COLUMN(sheet) && i <= sheet->maxcol; i++)
-	    {
-		_gtk_sheet_draw_button(sheet, -1, i);
-	    }
+	    key.wrap_mode = colptr->wrap_mode;
+	    key.wrap_width = colptr->width;
 	}
 
-	if (event->window == sheet->sheet_window)
+	job = g_hash_table_lookup(keys, &key);
+	if (!job)
 	{
-	    GtkSheetRange range;
+	    GtkSheetExtentEntry *entry =
+		g_hash_table_lookup(sheet->extent_cache->lookup, &key);
 
-	    range.row0 = _gtk_sheet_row_from_ypixel(sheet, event->area.y);
-	    range.col0 = _gtk_sheet_column_from_xpixel(sheet, event->area.x);
-	    range.rowi = _gtk_sheet_row_from_ypixel(sheet, event->area.y + event->area.height);
-	    range.coli = _gtk_sheet_column_from_xpixel(sheet, event->area.x + event->area.width);
+	    job = g_new(GtkSheetExtentJob, 1);
+	    job->key = key;
+	    g_hash_table_insert(keys, &job->key, job);
 
-#if GTK_SHEET_DEBUG_EXPOSE > 0
-	    g_debug("gtk_sheet_expose_handler: backing pixmap (%d,%d) (%d,%d)",
-		range.row0, range.col0, range.rowi, range.coli);
+	    if (entry)
+	    {
+		job->width = entry->width;
+		job->height = entry->height;
+	    }
+	    else
+		g_ptr_array_add(jobs, job);
+	}
+
+	items[i].cell = cell;
+	items[i].job = job;
+	items[i].border_width = attributes.border.width;
+	items[i].is_visible = attributes.is_visible;
+    }
+
+#if GTK_SHEET_DEBUG_SIZE > 0
+    g_debug("_gtk_sheet_measure_cells_threaded: %u cells %u keys %u to measure",
+	cells->len, g_hash_table_size(keys), jobs->len);
 #endif
 
-	    gtk_sheet_draw_backing_pixmap(sheet, range);
+    if (jobs->len)
+    {
+	GAsyncQueue *done = g_async_queue_new();
 
-	    if (sheet->state != GTK_SHEET_NORMAL)
-	    {
-		if (gtk_sheet_range_isvisible(sheet, sheet->range))
-		    gtk_sheet_draw_backing_pixmap(sheet, sheet->range);
-		if (GTK_SHEET_IN_RESIZE(sheet) || GTK_SHEET_IN_DRAG(sheet))
-		    gtk_sheet_draw_backing_pixmap(sheet, sheet->drag_range);
+	nslices = MIN(pool->n_threads * GTK_SHEET_RENDER_BANDS_PER_THREAD, jobs->len);
+	per_slice = (jobs->len + nslices - 1) / nslices;
+	nslices = (jobs->len + per_slice - 1) / per_slice;
 
-		if (gtk_sheet_range_isvisible(sheet, sheet->range))
-		    gtk_sheet_range_draw_selection(sheet, sheet->range);
-		if (GTK_SHEET_IN_RESIZE(sheet) || GTK_SHEET_IN_DRAG(sheet))
-		    draw_xor_rectangle(sheet, sheet->drag_range);
-	    }
+	slices = g_new(GtkSheetExtentSlice, nslices);
 
-	    if ((!GTK_SHEET_IN_XDRAG(sheet)) && 
-                (!GTK_SHEET_IN_YDRAG(sheet)))
-	    {
-		if (sheet->state == GTK_SHEET_NORMAL)
-		{
-#if GTK_SHEET_DEBUG_EXPOSE > 0
-                    g_debug(
-                        "gtk_sheet_expose_handler: draw_active_cell ar %d ac %d",
-                        sheet->active_cell.row,
-                        sheet->active_cell.col);
-#endif
+	for (i = 0; i < nslices; i++)
+	{
+	    slices[i].jobs = (GtkSheetExtentJob **)jobs->pdata + i * per_slice;
+	    slices[i].n = MIN(per_slice, jobs->len - i * per_slice);
+	    slices[i].done = done;
 
-		    gtk_sheet_draw_active_cell(sheet);
+	    g_thread_pool_push(pool->extent_pool, &slices[i], NULL);
+	}
 
-#if GTK_SHEET_DEBUG_EXPOSE > 0
-                    g_debug("gtk_sheet_expose_handler: insel %d",
-                            GTK_SHEET_IN_SELECTION(sheet));
-#endif
-		    if (!GTK_SHEET_IN_SELECTION(sheet)){
-                        gtk_widget_queue_draw(sheet->sheet_entry); 
-                    }
-		}
-	    }
+	for (i = 0; i < nslices; i++)
+	    g_async_queue_pop(done);
+
+	g_async_queue_unref(done);
+	g_free(slices);
+
+	for (i = 0; i < jobs->len; i++)
+	{
+	    GtkSheetExtentJob *job = g_ptr_array_index(jobs, i);
+
+	    _gtk_sheet_extent_cache_insert(sheet->extent_cache,
+		&job->key, job->width, job->height);
 	}
     }
 
-    if (sheet->state != GTK_SHEET_NORMAL && GTK_SHEET_IN_SELECTION(sheet))
-	gtk_widget_grab_focus(GTK_WIDGET(sheet));
+    for (i = 0; i < cells->len; i++)
+    {
+	GtkSheetCell *cell = items[i].cell;
 
-    (*GTK_WIDGET_CLASS(sheet_parent_class)->expose_event)(widget, event);
+	cell->extent_flags &= ~GTK_SHEET_CELL_EXTENT_DIRTY;
+	cell->extent.width = CELL_EXTENT_WIDTH(items[i].job->width, items[i].border_width);
+	cell->extent.height = CELL_EXTENT_HEIGHT(items[i].job->height, 0);
 
-    return (FALSE);
-}
+	_gtk_sheet_cell_count_extent(sheet, cell, cell->row, cell->col,
+	    items[i].is_visible);
+    }
 
+    g_ptr_array_free(jobs, TRUE);
+    g_hash_table_destroy(keys);
+    g_free(items);
+}
 
 /*
- * gtk_sheet_button_press_handler:
- * 
- * this is the #GtkSheet widget class "button-press-event" handler
- * 
- * @param widget the #GtkSheet
- * @param event  the GdkEventButton which triggered this signal
- * 
- * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
+ * _gtk_sheet_range_paint_threaded - paint cells by worker threads
+ *
+ * cuts the range into bands of whole rows, so every label is
+ * shaped once, renders the bands in parallel and uploads the image
+ * into the backing pixmap. Small ranges are painted directly.
+ *
+ * @param sheet
+ * @param range  range including its text overflow columns
  */
-static gboolean
-gtk_sheet_button_press_handler(GtkWidget *widget, GdkEventButton *event)
+static void
+_gtk_sheet_range_paint_threaded(GtkSheet *sheet, const GtkSheetRange *range)
 {
-    GtkSheet *sheet;
-    GdkModifierType mods;
-    gint x, y, row, column;
-    gboolean veto;
+    GtkSheetRenderPool *pool = sheet->render_pool;
+    GtkSheetRenderSnapshot *snap;
+    GtkSheetRenderBand *bands;
+    GdkRectangle area;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    gint r, c, i, y, nbands, max_bands, band_height;
 
-    g_return_val_if_fail(widget != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(widget), FALSE);
-    g_return_val_if_fail(event != NULL, FALSE);
-/*
-    if(event->type != GDK_BUTTON_PRESS) return(TRUE);
-*/
+    if (!_gtk_sheet_range_pixel_area(sheet, range, &area))
+	return;
 
-#if GTK_SHEET_DEBUG_MOUSE > 0
-    g_debug("gtk_sheet_button_press_handler: called");
+    max_bands = MIN((gint)pool->n_threads * GTK_SHEET_RENDER_BANDS_PER_THREAD,
+	area.height / GTK_SHEET_RENDER_BAND_MIN_HEIGHT);
+
+    if (max_bands < 2)  /* not worth the thread switch */
+    {
+	_gtk_sheet_range_paint_image(sheet, range);
+	return;
+    }
+
+    _gtk_sheet_render_pool_update(pool, sheet);
+
+    snap = _gtk_sheet_render_snapshot_new(sheet, range, &area);
+    snap->stride = cairo_format_stride_for_width(CAIRO_FORMAT_RGB24, area.width);
+    snap->data = g_malloc(snap->stride * area.height);
+    snap->done = g_async_queue_new();
+
+    /* cut at row tops */
+    bands = g_new(GtkSheetRenderBand, max_bands);
+    band_height = area.height / max_bands;
+    nbands = 0;
+    y = area.y;
+
+    for (r = 1; r < snap->nrows - 1 && nbands < max_bands - 1; r++)
+    {
+	if (!snap->height[r])
+	    continue;
+	if (snap->y[r] - y < band_height)
+	    continue;
+	if (snap->y[r] >= area.y + area.height)
+	    break;
+
+	bands[nbands].snap = snap;
+	bands[nbands].y = y;
+	bands[nbands].height = snap->y[r] - y;
+	nbands++;
+	y = snap->y[r];
+    }
+    bands[nbands].snap = snap;
+    bands[nbands].y = y;
+    bands[nbands].height = area.y + area.height - y;
+    nbands++;
+
+    for (i = 0; i < nbands; i++)
+	g_thread_pool_push(pool->pool, &bands[i], NULL);
+
+    for (i = 0; i < nbands; i++)
+	g_async_queue_pop(snap->done);
+
+#if GTK_SHEET_DEBUG_DRAW > 0
+    g_debug("_gtk_sheet_range_paint_threaded: %d bands of %d x %d",
+	nbands, area.width, area.height);
 #endif
 
-    gdk_window_get_pointer(gtk_widget_get_window(widget),
-	NULL, NULL, &mods);
+    surface = cairo_image_surface_create_for_data(snap->data,
+	CAIRO_FORMAT_RGB24, area.width, area.height, snap->stride);
 
-    if (!(mods & GDK_BUTTON1_MASK))
-	return (TRUE);
+    cr = gdk_cairo_create(sheet->pixmap);
+    cairo_set_source_surface(cr, surface, area.x, area.y);
+    gdk_cairo_rectangle(cr, &area);
+    cairo_fill(cr);
+    cairo_destroy(cr);
 
-    sheet = GTK_SHEET(widget);
+    cairo_surface_destroy(surface);
 
-    /* press on resize windows */
-    if (event->window == sheet->column_title_window && gtk_sheet_columns_resizable(sheet))
+    /* record the text overflow of the shaped labels */
+    for (r = 1; r < snap->nrows - 1; r++)
     {
-	gtk_widget_get_pointer(widget, &sheet->x_drag, NULL);
-	if (POSSIBLE_XDRAG(sheet, sheet->x_drag, &sheet->drag_cell.col))
+	for (c = 1; c < snap->ncols - 1; c++)
 	{
-	    guint req;
-	    if (event->type == GDK_2BUTTON_PRESS)
+	    GtkSheetRenderCell *rc = SNAPCELL(snap, r, c);
+	    gint sizel, sizer;
+
+	    if (rc->label)
 	    {
-		_gtk_sheet_autoresize_column_internal(sheet, sheet->drag_cell.col);
-		GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_XDRAG);
-		return (TRUE);
+		_cell_label_spread(sheet, snap->row0 + r, snap->col0 + c,
+		    rc->justification, rc->text_width, &sizel, &sizer);
 	    }
-	    _gtk_sheet_column_size_request(sheet, sheet->drag_cell.col, &req);
-	    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_XDRAG);
-	    gdk_pointer_grab(sheet->column_title_window, FALSE,
-		GDK_POINTER_MOTION_HINT_MASK |
-		    GDK_BUTTON1_MOTION_MASK |
-		    GDK_BUTTON_RELEASE_MASK,
-		NULL, NULL, event->time);
-
-	    draw_xor_vline(sheet);
-	    return (TRUE);
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+	    else
+	    {
+		_gtk_sheet_text_span_record(sheet,
+		    snap->row0 + r, snap->col0 + c, 0, 0);
+	    }
+#endif
 	}
     }
 
-    if (event->window == sheet->row_title_window && gtk_sheet_rows_resizable(sheet))
-    {
-	gtk_widget_get_pointer(widget, NULL, &sheet->y_drag);
+    g_free(bands);
+    _gtk_sheet_render_snapshot_free(snap);
+}
+#endif
 
-	if (POSSIBLE_YDRAG(sheet, sheet->y_drag, &sheet->drag_cell.row))
-	{
-	    guint req;
-	    gtk_sheet_row_size_request(sheet, sheet->drag_cell.row, &req);
-	    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_YDRAG);
-	    gdk_pointer_grab(sheet->row_title_window, FALSE,
-		GDK_POINTER_MOTION_HINT_MASK |
-		    GDK_BUTTON1_MOTION_MASK |
-		    GDK_BUTTON_RELEASE_MASK,
-		NULL, NULL, event->time);
+/*
+ * GdkGC draw path, the default, see gtk_sheet_set_cairo_draw()
+ */
 
-	    draw_xor_hline(sheet);
-	    return (TRUE);
-	}
-    }
+static void
+_cell_draw_label(GtkSheet *sheet, gint row, gint col)
+{
+    GtkSheetCellAttr attributes;
+    GdkRectangle clip_area;
+    PangoLayout *layout;
+    gint x, y;
 
-    /* the sheet itself does not handle other than single click events */
-    if (event->type != GDK_BUTTON_PRESS)
-	return (FALSE);
+    layout = _cell_place_label(sheet, row, col,
+	&attributes, &clip_area, &x, &y);
+    if (!layout)
+	return;
 
-    /* selections on the sheet */
-    if (event->window == sheet->sheet_window)
+    gdk_gc_set_foreground(sheet->fg_gc, &attributes.foreground);
+    gdk_gc_set_background(sheet->fg_gc, &attributes.background);
+    gdk_gc_set_clip_rectangle(sheet->fg_gc, &clip_area);
+
+    gdk_draw_layout(sheet->pixmap, sheet->fg_gc, x, y, layout);
+
+    /* copy sheet->pixmap to window */
+
+    gdk_draw_pixmap(sheet->sheet_window,
+	sheet->fg_gc,
+	sheet->pixmap,
+	clip_area.x, clip_area.y,
+	clip_area.x, clip_area.y,
+	clip_area.width, clip_area.height);
+
+    gdk_gc_set_clip_rectangle(sheet->fg_gc, NULL);
+}
+
+
+
+/*
+ * _gtk_sheet_range_paint_backgrounds - fill cell backgrounds
+ * 
+ * fills horizontal runs of cells with the same background by a 
+ * single rectangle and sets the GC colour only when it changes.
+ * 
+ * @param sheet
+ * @param range    range to fill
+ * @param bordered returns row, column pairs of cells having a border
+ */
+static void
+_gtk_sheet_range_paint_backgrounds(GtkSheet *sheet,
+    const GtkSheetRange *range, GArray *bordered)
+{
+    gint row, col;
+    gboolean gc_set = FALSE;
+    guint32 gc_pixel = 0;
+
+    for (row = MAX(range->row0, 0); row <= range->rowi && row <= sheet->maxrow; row++)
     {
-#if GTK_SHEET_DEBUG_MOUSE > 0
-	g_debug("gtk_sheet_button_press_handler: on sheet");
-#endif
+	GdkColor run_color;
+	gint y, run_x = 0, run_width = 0;
 
-	gtk_widget_get_pointer(widget, &x, &y);
-	gtk_sheet_get_pixel_info(sheet, NULL, x, y, &row, &column);
-	if (row < 0 && column < 0) return(FALSE);  /* chain up to global button press handler*/
+	if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	    continue;
 
-#if GTK_SHEET_DEBUG_MOUSE > 0
-	g_debug("gtk_sheet_button_press_handler: pointer grab (%d,%d) r %d c %d mr %d mc %d", 
-	    x, y, row, column, sheet->maxrow, sheet->maxcol
-	    );
-#endif
-	gdk_pointer_grab(sheet->sheet_window, FALSE,
-	    GDK_POINTER_MOTION_HINT_MASK |
-		GDK_BUTTON1_MOTION_MASK |
-		GDK_BUTTON_RELEASE_MASK,
-	    NULL, NULL, event->time);
-	gtk_grab_add(GTK_WIDGET(sheet));
-	sheet->timer = g_timeout_add_full(0, TIMEOUT_SCROLL, _gtk_sheet_scroll_to_pointer, sheet, NULL);
-#if GTK_SHEET_DEBUG_MOUSE > 0
-	g_debug("gtk_sheet_button_press_handler: grab focus");
-#endif
-	gtk_widget_grab_focus(GTK_WIDGET(sheet));
+	y = _gtk_sheet_row_top_ypixel(sheet, row);
 
-	if (sheet->selection_mode != GTK_SELECTION_SINGLE &&
-	    gdk_cursor_get_cursor_type(sheet->cursor_drag) == GDK_SIZING &&
-	    !GTK_SHEET_IN_SELECTION(sheet) && !GTK_SHEET_IN_RESIZE(sheet))
+	for (col = MAX(range->col0, 0); col <= range->coli + 1; col++)
 	{
-	    if (sheet->state == GTK_STATE_NORMAL)
+	    GtkSheetColumn *colptr = NULL;
+	    GtkSheetCellAttr attributes;
+
+	    if (col <= range->coli && col <= sheet->maxcol)
 	    {
-		gint row = sheet->active_cell.row;  /* PR#203012 */
-		gint column = sheet->active_cell.col;  /* PR#203012 */
+		colptr = COLPTR(sheet, col);
 
-		if (!gtk_sheet_deactivate_cell(sheet))
-		    return (FALSE);
-		sheet->active_cell.row = row;
-		sheet->active_cell.col = column;
-		sheet->drag_range = sheet->range;
-		sheet->state = GTK_SHEET_RANGE_SELECTED;
-		gtk_sheet_select_range(sheet, &sheet->drag_range);
+		if (!GTK_SHEET_COLUMN_IS_VISIBLE(colptr))
+		    continue;  /* no width, keeps the run */
+
+		gtk_sheet_get_attributes(sheet, row, col, &attributes);
+
+		if (attributes.border.width > 0 && attributes.border.mask)
+		{
+		    g_array_append_val(bordered, row);
+		    g_array_append_val(bordered, col);
+		}
+
+		if (run_width > 0 && attributes.background.pixel == run_color.pixel)
+		{
+		    run_width += colptr->width;
+		    continue;
+		}
 	    }
-	    sheet->x_drag = x;
-	    sheet->y_drag = y;
-	    if (row > sheet->range.rowi)
-		row--;
-	    if (column > sheet->range.coli)
-		column--;
-	    sheet->drag_cell.row = row;
-	    sheet->drag_cell.col = column;
-	    sheet->drag_range = sheet->range;
-	    draw_xor_rectangle(sheet, sheet->drag_range);
-	    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_RESIZE);
-	}
-	else if (gdk_cursor_get_cursor_type(sheet->cursor_drag) == GDK_TOP_LEFT_ARROW &&
-	    !GTK_SHEET_IN_SELECTION(sheet) && !GTK_SHEET_IN_DRAG(sheet))
-	{
-	    if (sheet->state == GTK_STATE_NORMAL)
+
+	    if (run_width > 0)  /* fill the finished run */
 	    {
-		gint row = sheet->active_cell.row;  /* PR#203012 */
-		gint column = sheet->active_cell.col;  /* PR#203012 */
+		if (!gc_set || gc_pixel != run_color.pixel)
+		{
+		    gdk_gc_set_foreground(sheet->bg_gc, &run_color);
+		    gc_pixel = run_color.pixel;
+		    gc_set = TRUE;
+		}
 
-		if (!gtk_sheet_deactivate_cell(sheet))
-		    return (FALSE);
-		sheet->active_cell.row = row;
-		sheet->active_cell.col = column;
-		sheet->drag_range = sheet->range;
-		sheet->state = GTK_SHEET_RANGE_SELECTED;
-		gtk_sheet_select_range(sheet, &sheet->drag_range);
+#if GTK_SHEET_DEBUG_DRAW_BACKGROUND>0
+		g_debug("_gtk_sheet_range_paint_backgrounds: row %d x %d w %d %s",
+		    row, run_x, run_width, gdk_color_to_string(&run_color));
+#endif
+
+		gdk_draw_rectangle(sheet->pixmap,
+		    sheet->bg_gc,
+		    TRUE,
+		    run_x, y,
+		    run_width, ROW_HEIGHT(sheet, row));
 	    }
-	    sheet->x_drag = x;
-	    sheet->y_drag = y;
-	    if (row < sheet->range.row0)
-		row++;
-	    if (row > sheet->range.rowi)
-		row--;
-	    if (column < sheet->range.col0)
-		column++;
-	    if (column > sheet->range.coli)
-		column--;
-	    sheet->drag_cell.row = row;
-	    sheet->drag_cell.col = column;
-	    sheet->drag_range = sheet->range;
-#if GTK_SHEET_DEBUG_MOUSE > 0
-	    g_debug("gtk_sheet_button_press_handler: drag_range r %d c %d (%d,%d, %d, %d) mr %d mc %d", 
-		sheet->drag_cell.row, sheet->drag_cell.col, 
-		sheet->drag_range.row0, sheet->drag_range.rowi, 
-		sheet->drag_range.col0, sheet->drag_range.coli, 
-		sheet->maxrow, sheet->maxcol
-	    );
-#endif
-	    draw_xor_rectangle(sheet, sheet->drag_range);
-	    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_DRAG);
-	}
-	else
-	{
-#if GTK_SHEET_DEBUG_MOUSE > 0
-	    g_debug("gtk_sheet_button_press_handler: on click cell");
-#endif
 
-	    gtk_sheet_click_cell(sheet, row, column, &veto);
-	    if (veto)
-		GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+	    if (!colptr)
+		break;
+
+	    run_x = _gtk_sheet_column_left_xpixel(sheet, col);
+	    run_width = colptr->width;
+	    run_color = attributes.background;
 	}
-	return(TRUE);
     }
+}
 
-    if (event->window == sheet->column_title_window)
-    {
-	gtk_widget_get_pointer(widget, &x, &y);
-	column = _gtk_sheet_column_from_xpixel(sheet, x);
-	if (column < 0 || column > sheet->maxcol)
-	    return (FALSE);
+/*
+ * _gtk_sheet_range_paint_grid - draw the grid lines of a range
+ * 
+ * all lines are drawn by a single request
+ * 
+ * @param sheet
+ * @param range
+ */
+static void
+_gtk_sheet_range_paint_grid(GtkSheet *sheet, const GtkSheetRange *range)
+{
+    GArray *segments = _gtk_sheet_range_grid_segments(sheet, range);
 
-	if (GTK_SHEET_COLUMN_IS_SENSITIVE(COLPTR(sheet, column)))
-	{
-	    gtk_sheet_click_cell(sheet, -1, column, &veto);
-	    gtk_grab_add(GTK_WIDGET(sheet));
-	    sheet->timer = g_timeout_add_full(0, TIMEOUT_SCROLL, _gtk_sheet_scroll_to_pointer, sheet, NULL);
-	    gtk_widget_grab_focus(GTK_WIDGET(sheet));
-	    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
-	}
-    }
+    if (!segments)
+	return;
 
-    if (event->window == sheet->row_title_window)
-    {
-	gtk_widget_get_pointer(widget, &x, &y);
-	row = _gtk_sheet_row_from_ypixel(sheet, y);
-	if (row < 0 || row > sheet->maxrow)
-	    return (FALSE);
+    gdk_gc_set_foreground(sheet->bg_gc, &sheet->grid_color);
 
-	if (GTK_SHEET_ROW_IS_SENSITIVE(ROWPTR(sheet, row)))
-	{
-	    gtk_sheet_click_cell(sheet, row, -1, &veto);
-	    gtk_grab_add(GTK_WIDGET(sheet));
-	    sheet->timer = g_timeout_add_full(0, TIMEOUT_SCROLL, _gtk_sheet_scroll_to_pointer, sheet, NULL);
-	    gtk_widget_grab_focus(GTK_WIDGET(sheet));
-	    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
-	}
-    }
+    gdk_draw_segments(sheet->pixmap,
+	sheet->bg_gc,
+	(GdkSegment *)segments->data, segments->len);
 
-    return (TRUE);
+    g_array_free(segments, TRUE);
 }
 
-static gint
-_gtk_sheet_scroll_to_pointer(gpointer data)
+/*
+ * _gtk_sheet_range_paint_gc - paint cells with GCs
+ * 
+ * @param sheet
+ * @param range  range including its text overflow columns
+ */
+static void
+_gtk_sheet_range_paint_gc(GtkSheet *sheet, const GtkSheetRange *range)
 {
-    GtkSheet *sheet = GTK_SHEET(data);
-    gint x, y, row, column;
-    gint move = TRUE;
+    gint row, col;
+    guint i;
+    GArray *bordered;
 
-    GDK_THREADS_ENTER();
+    /* draw grid and cells */
+    bordered = g_array_new(FALSE, FALSE, sizeof(gint));
 
-    gtk_widget_get_pointer(GTK_WIDGET(sheet), &x, &y);
-    gtk_sheet_get_pixel_info(sheet, NULL, x, y, &row, &column);
+    _gtk_sheet_range_paint_backgrounds(sheet, range, bordered);
 
-    if (GTK_SHEET_IN_SELECTION(sheet))
+    for (row = MAX(range->row0, 0);
+	row <= range->rowi && row <= sheet->maxrow; row++)
     {
-	GtkSheetRange visr;
-
-	/* beware of invisible columns/rows */
-	if (!_gtk_sheet_get_visible_range(sheet, &visr))
-	    return (TRUE);
+	if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	    continue;
 
-	if (_POINT_IN_RANGE(row, column, &visr))
+	for (col = range->col0;
+	    col <= range->coli && col <= sheet->maxcol; col++)
 	{
-	    gtk_sheet_extend_selection(sheet, row, column);
+	    if (GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
+		gtk_sheet_draw_tooltip_marker(sheet, ON_CELL_AREA, row, col);
 	}
     }
 
-    if (GTK_SHEET_IN_DRAG(sheet) || GTK_SHEET_IN_RESIZE(sheet))
+    if (sheet->show_grid)
+	_gtk_sheet_range_paint_grid(sheet, range);
+
+    /* bordered cells within the range, neighbours only on the facing side */
+    for (i = 0; i < bordered->len; i += 2)
     {
-	move = _gtk_sheet_move_query(sheet, row, column, FALSE);
-	if (move)
-	    draw_xor_rectangle(sheet, sheet->drag_range);
+	_cell_draw_border(sheet,
+	    g_array_index(bordered, gint, i), g_array_index(bordered, gint, i + 1), 15);
     }
+    g_array_free(bordered, TRUE);
 
-    GDK_THREADS_LEAVE();
-    return (TRUE);
-}
+    for (col = range->col0; col <= range->coli; col++)
+    {
+	_cell_draw_border(sheet, range->row0 - 1, col, GTK_SHEET_BOTTOM_BORDER);
+	_cell_draw_border(sheet, range->rowi + 1, col, GTK_SHEET_TOP_BORDER);
+    }
+    for (row = range->row0; row <= range->rowi; row++)
+    {
+	_cell_draw_border(sheet, row, range->col0 - 1, GTK_SHEET_RIGHT_BORDER);
+	_cell_draw_border(sheet, row, range->coli + 1, GTK_SHEET_LEFT_BORDER);
+    }
 
-static void
-gtk_sheet_click_cell(GtkSheet *sheet, gint row, gint col, gboolean *veto)
-{
-    *veto = TRUE;
+    /* draw text within range (1) */
 
-#if GTK_SHEET_DEBUG_CLICK > 0
-    g_debug("gtk_sheet_click_cell: called, row %d col %d", row, col);
+#if GTK_SHEET_DEBUG_DRAW > 0
+    g_debug("_gtk_sheet_range_paint: (1) row %d - %d col %d - %d",
+	range->row0, range->rowi,
+	range->col0, range->coli);
 #endif
 
-    /* allow row,col < 0 here, see below */
-    if (row > sheet->maxrow || col > sheet->maxcol)
-    {
-	*veto = FALSE;
-	return;
-    }
-
-    if (col >= 0 && row >= 0)
+    for (row = range->row0; row <= range->rowi; row++)
     {
-	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) ||
-	    !GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row))    || 
-            !GTK_SHEET_CELL_IS_VISIBLE(sheet,row,col)        ||
-            !GTK_SHEET_COLUMN_IS_SENSITIVE(COLPTR(sheet,col))||
-            !GTK_SHEET_ROW_IS_SENSITIVE(ROWPTR(sheet,row))   || 
-            !GTK_SHEET_CELL_IS_SENSITIVE(sheet,row,col)      ||
-            !GTK_SHEET_COLUMN_CAN_FOCUS(COLPTR(sheet,col))   ||
-            !GTK_SHEET_ROW_CAN_FOCUS(ROWPTR(sheet,row))      ||
-            !GTK_SHEET_CELL_CAN_FOCUS(sheet,row,col)         )
+	for (col = range->col0; col <= range->coli; col++)
 	{
-	    *veto = FALSE;
-	    return;
+	    if (sheet->model || _gtk_sheet_cell_get(sheet, row, col))
+	    {
+		_cell_draw_label(sheet, row, col);
+	    }
 	}
     }
+}
 
+/*
+ * _gtk_sheet_range_paint - paint cells into the backing pixmap
+ * 
+ * paints grid, backgrounds, borders and labels of a range that 
+ * was already clipped to the view. Areas beyond the last row or 
+ * column are cleared.
+ * 
+ * @param sheet
+ * @param drawing_range
+ *               the range, extended by its text overflow columns 
+ *               when text is not clipped
+ */
+static void
+_gtk_sheet_range_paint(GtkSheet *sheet, GtkSheetRange *drawing_range)
+{
+    GdkRectangle area;
 
-    /* if we do not grab focus here, some entry widgets (i.e. GtkSpinButton)
-       will not format contents correctly on field exit */
-
-    gtk_widget_grab_focus(GTK_WIDGET(sheet));
+    /* clear outer area beyond rightmost column */
+    if (drawing_range->coli >= MAX_VIEW_COLUMN(sheet))
+    {
+	gint maxcol = MAX_VIEW_COLUMN(sheet);  /* might not be visible */
 
-    _gtksheet_signal_emit(GTK_OBJECT(sheet), sheet_signals[TRAVERSE],
-	sheet->active_cell.row, sheet->active_cell.col,
-	&row, &col, veto);
+	if (maxcol > sheet->maxcol)
+	    maxcol = sheet->maxcol;
 
-    if (!*veto)
-    {
-	if (sheet->state == GTK_STATE_NORMAL)
-	    return;
+	while (maxcol >= 0
+	    && !GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, maxcol))) --maxcol;
 
-	row = sheet->active_cell.row;
-	col = sheet->active_cell.col;
-	gtk_sheet_activate_cell(sheet, row, col);
-	return;
-    }
+	if (maxcol >= 0)
+	{
+	    area.x = _gtk_sheet_column_left_xpixel(sheet, maxcol) +
+		COLPTR(sheet, maxcol)->width;
+	}
+	else
+	{
+	    area.x = sheet->hoffset;
+	    if (sheet->row_titles_visible)
+		area.x += sheet->row_title_area.width;
+	}
+	area.width = sheet->sheet_window_width - area.x;
+	area.y = 0;
+	area.height = sheet->sheet_window_height;
 
-    if (row == -1 && col >= 0)  /* column button clicked */
-    {
-	if (gtk_sheet_autoscroll(sheet))
-	    _gtk_sheet_move_query(sheet, row, col, FALSE);
+	if (area.width > 0) /* beware, rightmost column might be partially visible */
+	{
+#if 0
+	    gdk_gc_set_foreground(sheet->fg_gc, &sheet->bg_color);
+#else
+	    gdk_gc_set_foreground(sheet->fg_gc,
+		&gtk_widget_get_style(GTK_WIDGET(sheet))->bg[GTK_STATE_NORMAL]);
+#endif
 
-	gtk_sheet_select_column(sheet, col);
-	return;
-    }
-    if (col == -1 && row >= 0)  /* row button clicked */
-    {
-	if (gtk_sheet_autoscroll(sheet))
-	    _gtk_sheet_move_query(sheet, row, col, FALSE);
+	    gdk_draw_rectangle(sheet->pixmap,
+		sheet->fg_gc,
+		TRUE,  /* filled */
+		area.x, area.y,
+		area.width, area.height);
 
-	gtk_sheet_select_row(sheet, row);
-	return;
+	    gdk_draw_pixmap(sheet->sheet_window,
+		gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+		sheet->pixmap,
+		area.x, area.y,
+		area.x, area.y,
+		area.width, area.height);
+	}
     }
 
-    if (row == -1 && col == -1)  /* global button clicked */
+    /* clear outer area beyond last row */
+    if (drawing_range->rowi >= MAX_VIEW_ROW(sheet))
     {
-	sheet->range.row0 = 0;
-	sheet->range.col0 = 0;
-	sheet->range.rowi = sheet->maxrow;
-	sheet->range.coli = sheet->maxcol;
-
-	sheet->active_cell.row = 0;
-	sheet->active_cell.col = 0;
+	gint maxrow = MAX_VIEW_ROW(sheet);  /* might not be visible */
 
-	if (sheet->state != GTK_STATE_NORMAL)   /* if any range is selected, clear it */
-	    gtk_sheet_unselect_range(sheet);
-	else
-	    gtk_sheet_select_range(sheet, NULL);
+	if (maxrow > sheet->maxrow)
+	    maxrow = sheet->maxrow;
 
-	return;
-    }
+	while (maxrow >= 0
+	    && !GTK_SHEET_ROW_IS_VISIBLE(sheet, maxrow)) --maxrow;
 
-    if (row != -1 && col != -1)  /* sheet cell clicked */
-    {
-	GtkSheetColumn *colp = COLPTR(sheet, col);
+	area.x = 0;
+	area.width = sheet->sheet_window_width;
 
-	if (!gtk_widget_get_can_focus(GTK_WIDGET(sheet)))
+	if (maxrow >= 0)
 	{
-#if GTK_SHEET_DEBUG_CLICK > 0
-	    g_debug("gtk_sheet_click_cell: row %d col %d VETO: sheet, can-focus false", row, col);
-#endif
-	    *veto = FALSE;
-	    return;
+	    area.y = _gtk_sheet_row_top_ypixel(sheet, maxrow) +
+		ROW_HEIGHT(sheet, maxrow);
+	}
+	else
+	{
+	    area.y = sheet->voffset;
+	    if (sheet->column_titles_visible)
+		area.y += sheet->column_title_area.height;
 	}
+	area.height = sheet->sheet_window_height - area.y;
 
-	if (!GTK_SHEET_COLUMN_CAN_FOCUS(colp))
+	if (area.height > 0) /* beware, last row might be partially visible */
 	{
-#if GTK_SHEET_DEBUG_CLICK > 0
-	    g_debug("gtk_sheet_click_cell: row %d col %d VETO: sheet column, can-focus false", row, col);
+#if 0
+	    gdk_gc_set_foreground(sheet->fg_gc, &sheet->bg_color);
+#else
+	    gdk_gc_set_foreground(sheet->fg_gc,
+		&gtk_widget_get_style(GTK_WIDGET(sheet))->bg[GTK_STATE_NORMAL]);
 #endif
-	    *veto = FALSE;
-	    return;
-	}
 
-	if (sheet->state != GTK_SHEET_NORMAL)
-	{
-	    sheet->state = GTK_SHEET_NORMAL;
-	    gtk_sheet_real_unselect_range(sheet, NULL);
-	}
-	else
-	{
-#if GTK_SHEET_DEBUG_CLICK > 0
-	    g_debug("gtk_sheet_click_cell: row %d col %d calling deactivate", row, col);
-#endif
-	    if (!gtk_sheet_deactivate_cell(sheet))
-	    {
-#if GTK_SHEET_DEBUG_CLICK > 0
-		g_debug("gtk_sheet_click_cell: row %d col %d VETO: deactivate false", row, col);
-#endif
-		*veto = FALSE;
-		return;
-	    }
-#if GTK_SHEET_DEBUG_CLICK > 0
-	    g_debug("gtk_sheet_click_cell: row %d col %d back from deactivate", row, col);
-#endif
-	}
+	    gdk_draw_rectangle(sheet->pixmap,
+		sheet->fg_gc,
+		TRUE,  /* filled */
+		area.x, area.y,
+		area.width, area.height);
 
-	/* auto switch column entry_type */
-	/* not sure wether to move this code to gtk_sheet_show_active_cell() */
-	{
-	    GType installed_entry_type = sheet->installed_entry_type;
-	    GType wanted_type =
-		(colp->entry_type != G_TYPE_NONE) ? colp->entry_type : sheet->entry_type;
+	    gdk_draw_pixmap(sheet->sheet_window,
+		gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+		sheet->pixmap,
+		area.x, area.y,
+		area.x, area.y,
+		area.width, area.height);
+	}
+    }
 
-	    if (installed_entry_type != wanted_type)
-	    {
-		if (sheet->state == GTK_SHEET_NORMAL)
-		    _gtk_sheet_hide_active_cell(sheet);
+    /* extend the drawing range to include all text sources */
 
-		create_sheet_entry(sheet, wanted_type ? wanted_type : G_TYPE_NONE);
-	    }
-	}
+    if (drawing_range->col0 < 0)
+	drawing_range->col0 = 0;
+    if (drawing_range->col0 > sheet->maxcol)
+	drawing_range->col0 = sheet->maxcol;
+    if (drawing_range->coli < 0)
+	drawing_range->coli = 0;
+    if (drawing_range->coli > sheet->maxcol)
+	drawing_range->coli = sheet->maxcol;
 
-	/* DEACTIVATE handler might have called gtk_sheet_set_active_cell(),
-	   so wie leave it, if it was changed
-	   */
-#if 0
-	{
-	    gint act_row = sheet->active_cell.row;
-	    gint act_col = sheet->active_cell.col;
+    if (!gtk_sheet_clip_text(sheet))  /* text extends multiple cells */
+    {
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+	_gtk_sheet_range_add_text_columns(sheet, drawing_range);
+#else
+	drawing_range->col0 = MIN_VIEW_COLUMN(sheet);
+	drawing_range->coli = MAX_VIEW_COLUMN(sheet);
+#endif
 
-	    if (act_row != -1 && act_col != -1 &&
-		(sheet->active_cell.row != row || sheet->active_cell.col != col))
-	    {
-		row = sheet->active_cell.row;
-		col = sheet->active_cell.col;
-	    }
-	}
+#if GTK_SHEET_DEBUG_DRAW > 0
+    g_debug("_gtk_sheet_range_paint: extended: row %d - %d col %d - %d",
+	drawing_range->row0, drawing_range->rowi, drawing_range->col0, drawing_range->coli);
 #endif
+    }
 
-	if (gtk_sheet_autoscroll(sheet))
-	    _gtk_sheet_move_query(sheet, row, col, TRUE);
+    if (!sheet->cairo_draw)
+    {
+	_gtk_sheet_range_paint_gc(sheet, drawing_range);
+	return;
+    }
 
-	sheet->active_cell.row = row;
-	sheet->active_cell.col = col;
+#if GTK_SHEET_TILE_CACHE
+    if (sheet->tile_cache)
+    {
+	_gtk_sheet_range_paint_tiles(sheet, drawing_range);
+	return;
+    }
+#endif
 
-	sheet->selection_cell.row = row;
-	sheet->selection_cell.col = col;
+    for (;;)
+    {
+	GtkSheetRange painted = *drawing_range;
 
-	sheet->range.row0 = row;
-	sheet->range.col0 = col;
-	sheet->range.rowi = row;
-	sheet->range.coli = col;
+#if GTK_SHEET_RENDER_THREADS
+	if (sheet->render_pool)
+	    _gtk_sheet_range_paint_threaded(sheet, drawing_range);
+	else
+#endif
+	    _gtk_sheet_range_paint_image(sheet, drawing_range);
 
-	sheet->state = GTK_SHEET_NORMAL;
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+	if (gtk_sheet_clip_text(sheet))
+	    break;
 
-	GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
-	gtk_sheet_draw_active_cell(sheet);
-	return;
+	/* the image clips text now overflowing beyond the range */
+	_gtk_sheet_range_add_text_columns(sheet, drawing_range);
+	if (drawing_range->col0 == painted.col0 && drawing_range->coli == painted.coli)
+	    break;
+#else
+	break;
+#endif
     }
-
-    g_assert_not_reached();
-    gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
 }
 
-/*
- * gtk_sheet_button_release_handler:
- * 
- * this is the #GtkSheet widget class "button-release-event" handler
- * 
- * @param widget the #GtkSheet
- * @param event  the GdkEventButton which triggered this signal
- * 
- * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
+/**
+ * _gtk_sheet_range_draw:
+ * @sheet:  the #GtkSheet
+ * @range:  the #GtkSheetRange or NULL
+ * @activate_active_cell: TRUE to activate active cell after 
+ *                      drawing
+ *  
+ * draw visible part of range. 
+ * If @range == NULL then draw the whole screen, dropping all 
+ * rendered tiles.
+ *  
  */
-static gboolean
-gtk_sheet_button_release_handler(GtkWidget *widget, GdkEventButton *event)
+void
+_gtk_sheet_range_draw(GtkSheet *sheet,
+    const GtkSheetRange *range,
+    gboolean activate_active_cell)
 {
-    GtkSheet *sheet;
-    gint x, y;
+    GtkSheetRange drawing_range;
 
-    sheet = GTK_SHEET(widget);
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_SHEET(sheet));
 
-    /* release on resize windows */
-    if (GTK_SHEET_IN_XDRAG(sheet))
-    {
-	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_XDRAG);
-	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
-	gtk_widget_get_pointer(widget, &x, NULL);
-	gdk_pointer_ungrab(event->time);
-	draw_xor_vline(sheet);
+    if (!range)
+	_gtk_sheet_tile_cache_invalidate(sheet, NULL);
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-	g_debug("gtk_sheet_button_release_handler[%d]: set width %d",
-	    sheet->drag_cell.col, new_column_width(sheet, sheet->drag_cell.col, &x));
+#if GTK_SHEET_DEBUG_DRAW > 0
+    g_debug("_gtk_sheet_range_draw: called");
 #endif
-	gtk_sheet_set_column_width(sheet,
-	    sheet->drag_cell.col, new_column_width(sheet, sheet->drag_cell.col, &x));
 
-	sheet->old_hadjustment = -1.;
+    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
+	return;
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+    if (!gtk_widget_get_mapped(GTK_WIDGET(sheet)))
+	return;
 
-	if (sheet->hadjustment)
-	{
-	    g_signal_emit_by_name(GTK_OBJECT(sheet->hadjustment),  "value_changed");
-	}
-	return (TRUE);
+    if (range)
+    {
+	drawing_range.row0 = MAX(range->row0, MIN_VIEW_ROW(sheet));
+	drawing_range.rowi = MIN(range->rowi, MAX_VIEW_ROW(sheet));
+	drawing_range.col0 = MAX(range->col0, MIN_VIEW_COLUMN(sheet));
+	drawing_range.coli = MIN(range->coli, MAX_VIEW_COLUMN(sheet));
     }
-
-    if (GTK_SHEET_IN_YDRAG(sheet))
+    else
     {
-	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_YDRAG);
-	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
-	gtk_widget_get_pointer(widget, NULL, &y);
-	gdk_pointer_ungrab(event->time);
-	draw_xor_hline(sheet);
-
-	gtk_sheet_set_row_height(sheet, sheet->drag_cell.row,
-	    new_row_height(sheet, sheet->drag_cell.row, &y));
+	drawing_range.row0 = MIN_VIEW_ROW(sheet);
+	drawing_range.rowi = MAX_VIEW_ROW(sheet);
+	drawing_range.col0 = MIN_VIEW_COLUMN(sheet);
+	drawing_range.coli = MAX_VIEW_COLUMN(sheet);
 
-	sheet->old_vadjustment = -1.;
-	if (sheet->vadjustment)
-	{
-	    g_signal_emit_by_name(GTK_OBJECT(sheet->vadjustment), "value_changed");
-	}
-	return (TRUE);
+	/* covers all queued ranges */
+	g_array_set_size(sheet->dirty_ranges, 0);
     }
 
+#if GTK_SHEET_DEBUG_DRAW > 0
+    g_debug("_gtk_sheet_range_draw: row %d - %d col %d - %d",
+	drawing_range.row0, drawing_range.rowi, drawing_range.col0, drawing_range.coli);
+#endif
 
-    if (GTK_SHEET_IN_DRAG(sheet))
-    {
-	GtkSheetRange old_range;
-	draw_xor_rectangle(sheet, sheet->drag_range);
-	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_DRAG);
-	gdk_pointer_ungrab(event->time);
+    if (drawing_range.row0 > drawing_range.rowi)
+	return;
+    if (drawing_range.col0 > drawing_range.coli)
+	return;
 
-	gtk_sheet_real_unselect_range(sheet, NULL);
+/*  
+   gdk_draw_rectangle (sheet->pixmap,
+       GTK_WIDGET(sheet)->style->white_gc,
+       TRUE,
+       0,0,
+       sheet->sheet_window_width,sheet->sheet_window_height);
+*/
 
-	sheet->active_cell.row = sheet->active_cell.row +
-	    (sheet->drag_range.row0 - sheet->range.row0);
-	sheet->active_cell.col = sheet->active_cell.col +
-	    (sheet->drag_range.col0 - sheet->range.col0);
-	sheet->selection_cell.row = sheet->selection_cell.row +
-	    (sheet->drag_range.row0 - sheet->range.row0);
-	sheet->selection_cell.col = sheet->selection_cell.col +
-	    (sheet->drag_range.col0 - sheet->range.col0);
-	old_range = sheet->range;
-	sheet->range = sheet->drag_range;
-	sheet->drag_range = old_range;
-	g_signal_emit(GTK_OBJECT(sheet), sheet_signals[MOVE_RANGE], 0,
-	    &sheet->drag_range, &sheet->range);
-	gtk_sheet_select_range(sheet, &sheet->range);
+    _gtk_sheet_range_paint(sheet, &drawing_range);
+
+    gtk_sheet_draw_backing_pixmap(sheet, drawing_range);
+
+    if (sheet->state != GTK_SHEET_NORMAL &&
+	gtk_sheet_range_isvisible(sheet, sheet->range))
+    {
+	gtk_sheet_range_draw_selection(sheet, drawing_range);
     }
 
-    if (GTK_SHEET_IN_RESIZE(sheet))
+    if (activate_active_cell &&
+	sheet->state == GTK_STATE_NORMAL &&
+	sheet->active_cell.row >= drawing_range.row0 &&
+	sheet->active_cell.row <= drawing_range.rowi &&
+	sheet->active_cell.col >= drawing_range.col0 &&
+	sheet->active_cell.col <= drawing_range.coli)
     {
-	GtkSheetRange old_range;
-	draw_xor_rectangle(sheet, sheet->drag_range);
-	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_RESIZE);
-	gdk_pointer_ungrab(event->time);
+	gtk_sheet_show_active_cell(sheet);
+    }
+}
 
-	gtk_sheet_real_unselect_range(sheet, NULL);
-
-	sheet->active_cell.row = sheet->active_cell.row +
-	    (sheet->drag_range.row0 - sheet->range.row0);
-	sheet->active_cell.col = sheet->active_cell.col +
-	    (sheet->drag_range.col0 - sheet->range.col0);
-	if (sheet->drag_range.row0 < sheet->range.row0)
-	    sheet->selection_cell.row = sheet->drag_range.row0;
-	if (sheet->drag_range.rowi >= sheet->range.rowi)
-	    sheet->selection_cell.row = sheet->drag_range.rowi;
-	if (sheet->drag_range.col0 < sheet->range.col0)
-	    sheet->selection_cell.col = sheet->drag_range.col0;
-	if (sheet->drag_range.coli >= sheet->range.coli)
-	    sheet->selection_cell.col = sheet->drag_range.coli;
-	old_range = sheet->range;
-	sheet->range = sheet->drag_range;
-	sheet->drag_range = old_range;
+/*
+ * queued redraw
+ *
+ * Cell updates queue their range instead of drawing at once. Pending 
+ * ranges are clipped to the view and merged where they overlap or 
+ * line up, and drawn together from an idle handler.
+ */
 
-	if (sheet->state == GTK_STATE_NORMAL)
-	    sheet->state = GTK_SHEET_RANGE_SELECTED;
-	g_signal_emit(GTK_OBJECT(sheet), sheet_signals[RESIZE_RANGE], 0,
-	    &sheet->drag_range, &sheet->range);
-	gtk_sheet_select_range(sheet, &sheet->range);
-    }
+#define GTK_SHEET_DIRTY_MAX_RANGES  16  /* collapse to bounding box */
 
-    if (sheet->state == GTK_SHEET_NORMAL && GTK_SHEET_IN_SELECTION(sheet))
-    {
-	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
-	gdk_pointer_ungrab(event->time);
-	gtk_sheet_activate_cell(sheet, sheet->active_cell.row,
-	    sheet->active_cell.col);
-    }
+/*
+ * _gtk_sheet_range_merge - merge two ranges if that is exact
+ * 
+ * @param range  range, extended on success
+ * @param other
+ * 
+ * @return TRUE if the ranges overlap or line up and were merged
+ */
+static gboolean
+_gtk_sheet_range_merge(GtkSheetRange *range, const GtkSheetRange *other)
+{
+    gboolean overlap, vstack, hstack;
 
-    if (GTK_SHEET_IN_SELECTION)
-	gdk_pointer_ungrab(event->time);
-    if (sheet->timer)
-	g_source_remove(sheet->timer);
-    gtk_grab_remove(GTK_WIDGET(sheet));
+    overlap = range->row0 <= other->rowi && other->row0 <= range->rowi
+	&& range->col0 <= other->coli && other->col0 <= range->coli;
+    vstack = range->col0 == other->col0 && range->coli == other->coli
+	&& range->row0 <= other->rowi + 1 && other->row0 <= range->rowi + 1;
+    hstack = range->row0 == other->row0 && range->rowi == other->rowi
+	&& range->col0 <= other->coli + 1 && other->col0 <= range->coli + 1;
 
-    GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+    if (!overlap && !vstack && !hstack)
+	return (FALSE);
 
+    range->row0 = MIN(range->row0, other->row0);
+    range->rowi = MAX(range->rowi, other->rowi);
+    range->col0 = MIN(range->col0, other->col0);
+    range->coli = MAX(range->coli, other->coli);
     return (TRUE);
 }
 
-/*
- * gtk_sheet_motion_handler:<p>
- * this is the #GtkSheet widget class "motion-notify-event" signal handler
- * 
- * @param widget the #GtkSheet
- * @param event  the GdkEventMotion which triggered this signal
- * 
- * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
- */
 static gboolean
-gtk_sheet_motion_handler(GtkWidget *widget, GdkEventMotion *event)
+_gtk_sheet_queued_draw_handler(gpointer data)
 {
-    GtkSheet *sheet;
-    GdkModifierType mods;
-    GdkCursorType new_cursor;
-    gint x, y, row, column;
+    GtkSheet *sheet = GTK_SHEET(data);
 
-    g_return_val_if_fail(widget != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(widget), FALSE);
-    g_return_val_if_fail(event != NULL, FALSE);
+    GDK_THREADS_ENTER();
 
+    sheet->dirty_idle = 0;
+    _gtk_sheet_flush_queued_draw(sheet);
 
-    sheet = GTK_SHEET(widget);
+    GDK_THREADS_LEAVE();
 
-    /* selections on the sheet */
-    x = event->x;
-    y = event->y;
+    return (FALSE);
+}
 
-#if GTK_SHEET_DEBUG_MOTION > 0
-    g_debug("gtk_sheet_motion_handler: (%d,%d) inSel %s", x, y,
-	GTK_SHEET_IN_SELECTION(sheet) ? "Yes" : "No" );
-#endif
+/**
+ * _gtk_sheet_range_queue_draw:
+ * @sheet:  the #GtkSheet
+ * @range:  the #GtkSheetRange or NULL
+ *  
+ * queue a redraw of the visible part of range, done when the 
+ * main loop becomes idle. If @range == NULL then the whole 
+ * screen is queued. Nothing is queued while the sheet is frozen, 
+ * gtk_sheet_thaw() redraws everything. Rendered tiles of the 
+ * range are dropped in any case.
+ */
+void
+_gtk_sheet_range_queue_draw(GtkSheet *sheet, const GtkSheetRange *range)
+{
+    GArray *dirty = sheet->dirty_ranges;
+    GtkSheetRange queued;
+    guint i;
 
-    if (event->window == sheet->column_title_window 
-	&& gtk_sheet_columns_resizable(sheet))
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+
+    _gtk_sheet_tile_cache_invalidate(sheet, range);
+
+    if (GTK_SHEET_IS_FROZEN(sheet))
+	return;
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+
+    queued = sheet->view;
+    if (range)
     {
-	gtk_widget_get_pointer(widget, &x, &y);
-	if (!GTK_SHEET_IN_SELECTION(sheet) && POSSIBLE_XDRAG(sheet, x, &column))
-	{
-	    new_cursor = GDK_SB_H_DOUBLE_ARROW;
-	    if (new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
-	    {
-		gdk_cursor_destroy(sheet->cursor_drag);
-		sheet->cursor_drag = gdk_cursor_new(GDK_SB_H_DOUBLE_ARROW);
-		gdk_window_set_cursor(sheet->column_title_window, sheet->cursor_drag);
-	    }
-	}
-	else
-	{
-	    new_cursor = GDK_TOP_LEFT_ARROW;
-	    if (!GTK_SHEET_IN_XDRAG(sheet) && new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
-	    {
-		gdk_cursor_destroy(sheet->cursor_drag);
-		sheet->cursor_drag = gdk_cursor_new(GDK_TOP_LEFT_ARROW);
-		gdk_window_set_cursor(sheet->column_title_window, sheet->cursor_drag);
-	    }
-	}
+	queued.row0 = MAX(range->row0, MIN_VIEW_ROW(sheet));
+	queued.rowi = MIN(range->rowi, MAX_VIEW_ROW(sheet));
+	queued.col0 = MAX(range->col0, MIN_VIEW_COLUMN(sheet));
+	queued.coli = MIN(range->coli, MAX_VIEW_COLUMN(sheet));
     }
 
-    if (event->window == sheet->row_title_window 
-	&& gtk_sheet_rows_resizable(sheet))
+    if (queued.row0 > queued.rowi || queued.col0 > queued.coli)
+	return;
+
+    /* the merged range may now line up with ranges checked before */
+    i = 0;
+    while (i < dirty->len)
     {
-	gtk_widget_get_pointer(widget, &x, &y);
-	if (!GTK_SHEET_IN_SELECTION(sheet) && POSSIBLE_YDRAG(sheet, y, &column))
+	if (_gtk_sheet_range_merge(&queued,
+	    &g_array_index(dirty, GtkSheetRange, i)))
 	{
-	    new_cursor = GDK_SB_V_DOUBLE_ARROW;
-	    if (new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
-	    {
-		gdk_cursor_destroy(sheet->cursor_drag);
-		sheet->cursor_drag = gdk_cursor_new(GDK_SB_V_DOUBLE_ARROW);
-		gdk_window_set_cursor(sheet->row_title_window, sheet->cursor_drag);
-	    }
+	    g_array_remove_index_fast(dirty, i);
+	    i = 0;
 	}
 	else
+	    i++;
+    }
+
+    if (dirty->len >= GTK_SHEET_DIRTY_MAX_RANGES)
+    {
+	for (i = 0; i < dirty->len; i++)
 	{
-	    new_cursor = GDK_TOP_LEFT_ARROW;
-	    if (!GTK_SHEET_IN_YDRAG(sheet) && new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
-	    {
-		gdk_cursor_destroy(sheet->cursor_drag);
-		sheet->cursor_drag = gdk_cursor_new(GDK_TOP_LEFT_ARROW);
-		gdk_window_set_cursor(sheet->row_title_window, sheet->cursor_drag);
-	    }
+	    GtkSheetRange *r = &g_array_index(dirty, GtkSheetRange, i);
+
+	    queued.row0 = MIN(queued.row0, r->row0);
+	    queued.rowi = MAX(queued.rowi, r->rowi);
+	    queued.col0 = MIN(queued.col0, r->col0);
+	    queued.coli = MAX(queued.coli, r->coli);
 	}
+	g_array_set_size(dirty, 0);
     }
 
-    new_cursor = GDK_PLUS;
-    if (!POSSIBLE_DRAG(sheet, x, y, &row, &column) && !GTK_SHEET_IN_DRAG(sheet) &&
-	!POSSIBLE_RESIZE(sheet, x, y, &row, &column) && !GTK_SHEET_IN_RESIZE(sheet) &&
-	event->window == sheet->sheet_window &&
-	new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
+    g_array_append_val(dirty, queued);
+
+#if GTK_SHEET_DEBUG_DRAW > 0
+    g_debug("_gtk_sheet_range_queue_draw: row %d - %d col %d - %d, %u pending",
+	queued.row0, queued.rowi, queued.col0, queued.coli, dirty->len);
+#endif
+
+    if (!sheet->dirty_idle)
     {
-	gdk_cursor_destroy(sheet->cursor_drag);
-	sheet->cursor_drag = gdk_cursor_new(GDK_PLUS);
-	gdk_window_set_cursor(sheet->sheet_window, sheet->cursor_drag);
+	sheet->dirty_idle = g_idle_add_full(GDK_PRIORITY_REDRAW,
+	    _gtk_sheet_queued_draw_handler, sheet, NULL);
     }
+}
 
-    new_cursor = GDK_TOP_LEFT_ARROW;
-    if (!(POSSIBLE_RESIZE(sheet, x, y, &row, &column) || GTK_SHEET_IN_RESIZE(sheet)) &&
-	(POSSIBLE_DRAG(sheet, x, y, &row, &column) || GTK_SHEET_IN_DRAG(sheet)) &&
-	event->window == sheet->sheet_window &&
-	new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
+/**
+ * _gtk_sheet_flush_queued_draw:
+ * @sheet:  the #GtkSheet
+ *  
+ * draw all queued ranges now
+ */
+void
+_gtk_sheet_flush_queued_draw(GtkSheet *sheet)
+{
+    GArray *dirty = sheet->dirty_ranges;
+
+    if (sheet->dirty_idle)
     {
-	gdk_cursor_destroy(sheet->cursor_drag);
-	sheet->cursor_drag = gdk_cursor_new(GDK_TOP_LEFT_ARROW);
-	gdk_window_set_cursor(sheet->sheet_window, sheet->cursor_drag);
+	g_source_remove(sheet->dirty_idle);
+	sheet->dirty_idle = 0;
     }
 
-    new_cursor = GDK_SIZING;
-    if (!GTK_SHEET_IN_DRAG(sheet) &&
-	(POSSIBLE_RESIZE(sheet, x, y, &row, &column) || GTK_SHEET_IN_RESIZE(sheet)) &&
-	event->window == sheet->sheet_window &&
-	new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
+    /* pop first, drawing may queue again */
+    while (dirty->len > 0)
     {
-	gdk_cursor_destroy(sheet->cursor_drag);
-	sheet->cursor_drag = gdk_cursor_new(GDK_SIZING);
-	gdk_window_set_cursor(sheet->sheet_window, sheet->cursor_drag);
+	GtkSheetRange range = g_array_index(dirty, GtkSheetRange, dirty->len - 1);
+
+	g_array_set_size(dirty, dirty->len - 1);
+	_gtk_sheet_range_draw(sheet, &range, TRUE);
     }
+}
 
-    gdk_window_get_pointer(gtk_widget_get_window(widget), &x, &y, &mods);
-    if (!(mods & GDK_BUTTON1_MASK))
-	return (FALSE);
+/*
+ * gtk_sheet_range_draw_selection - highlight selected cells
+ * 
+ * the cell rectangles are collected into a region and inverted by 
+ * a single fill clipped to that region.
+ * 
+ * @param sheet
+ * @param range  range to be highlighted
+ */
+static void
+gtk_sheet_range_draw_selection(GtkSheet *sheet, GtkSheetRange range)
+{
+    GdkRectangle area;
+    GdkRegion *region;
+    gint i, j;
+    GtkSheetRange aux;
 
-    if (GTK_SHEET_IN_XDRAG(sheet))
+    if (range.col0 > sheet->range.coli || range.coli < sheet->range.col0 ||
+	range.row0 > sheet->range.rowi || range.rowi < sheet->range.row0)
     {
-	if (event->is_hint ||
-	    event->window != gtk_widget_get_window(widget))
-	{
-	    gtk_widget_get_pointer(widget, &x, NULL);
-	}
-	else
-	    x = event->x;
-
-	new_column_width(sheet, sheet->drag_cell.col, &x);
-	if (x != sheet->x_drag)
-	{
-	    draw_xor_vline(sheet);
-	    sheet->x_drag = x;
-	    draw_xor_vline(sheet);
-	}
-	return (TRUE);
+#if GTK_SHEET_DEBUG_SELECTION > 0
+	g_debug("gtk_sheet_range_draw_selection: range outside");
+#endif
+	return;
     }
 
-    if (GTK_SHEET_IN_YDRAG(sheet))
+    if (!gtk_sheet_range_isvisible(sheet, range))
     {
-	if (event->is_hint ||
-	    event->window != gtk_widget_get_window(widget))
-	{
-	    gtk_widget_get_pointer(widget, NULL, &y);
-	}
-	else
-	    y = event->y;
-
-	new_row_height(sheet, sheet->drag_cell.row, &y);
-	if (y != sheet->y_drag)
-	{
-	    draw_xor_hline(sheet);
-	    sheet->y_drag = y;
-	    draw_xor_hline(sheet);
-	}
-	return (TRUE);
+#if GTK_SHEET_DEBUG_SELECTION > 0
+	g_debug("gtk_sheet_range_draw_selection: range invisible");
+#endif
+	return;
     }
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
 
-    if (GTK_SHEET_IN_DRAG(sheet))
-    {
-	GtkSheetRange aux, visr;
+    aux = range;
 
-	gint current_row = MIN(sheet->maxrow, _gtk_sheet_row_from_ypixel(sheet, y));
-	gint current_col = MIN(sheet->maxcol, _gtk_sheet_column_from_xpixel(sheet, x));
+    range.col0 = MAX(sheet->range.col0, range.col0);
+    range.coli = MIN(sheet->range.coli, range.coli);
+    range.row0 = MAX(sheet->range.row0, range.row0);
+    range.rowi = MIN(sheet->range.rowi, range.rowi);
 
-	row = current_row - sheet->drag_cell.row;
-	column = current_col - sheet->drag_cell.col;
+    range.col0 = MAX(range.col0, MIN_VIEW_COLUMN(sheet));
+    range.coli = MIN(range.coli, MAX_VIEW_COLUMN(sheet));
+    range.row0 = MAX(range.row0, MIN_VIEW_ROW(sheet));
+    range.rowi = MIN(range.rowi, MAX_VIEW_ROW(sheet));
 
-	if (sheet->state == GTK_SHEET_ROW_SELECTED)
-	    column = 0;
-	if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
-	    row = 0;
-	sheet->x_drag = x;
-	sheet->y_drag = y;
-	aux = sheet->range;
+#if GTK_SHEET_DEBUG_SELECTION > 0
+    g_debug("gtk_sheet_range_draw_selection: range r %d-%d c %d-%d",
+	range.row0, range.rowi, range.col0, range.coli);
+#endif
 
-	/* beware of invisible columns/rows */
-	if (!_gtk_sheet_get_visible_range(sheet, &visr))
-	    return (TRUE);
+    region = gdk_region_new();
 
-	if (_RECT_IN_RANGE(aux.row0 + row, aux.rowi + row,
-		aux.col0 + column, aux.coli + column, &visr))
+    for (i = range.row0; i <= range.rowi; i++)
+    {
+	GdkRectangle run = { 0, 0, 0, 0 };  /* adjacent cells of the row */
+
+	if (i > sheet->maxrow)
+	    break;
+
+	for (j = range.col0; j <= range.coli; j++)
 	{
-	    aux = sheet->drag_range;
+	    if (j > sheet->maxcol)
+		break;
 
-#if 1
-	    /* The following code doesn't behave properly when there
-	       are invisible columns in the sheet. For a proper user experience
-	       it should
-	       1. _gtk_sheet_count_visible(drag_range)
-	       2. try to move the outer edge into the given direction
-	       3. find and add enough visible columns backwards
-	       Beware: above algo will modify width/height of the drag area
-	       */
-	    if (row > 0)
-	    {
-		gint nrow0 = _gtk_sheet_first_visible_rowidx(sheet, sheet->range.row0 + row);
-		gint nrowi = _gtk_sheet_first_visible_rowidx(sheet, sheet->range.rowi + row);
-		if (nrow0 >= 0 && nrowi >= 0)
-		{
-		    sheet->drag_range.row0 = nrow0;
-		    sheet->drag_range.rowi = nrowi;
-		}
-	    }
-	    else
+	    if (gtk_sheet_cell_get_state(sheet, i, j) == GTK_STATE_SELECTED &&
+		GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, j)) &&
+		GTK_SHEET_ROW_IS_VISIBLE(sheet, i))
 	    {
-		gint nrow0 = _gtk_sheet_last_visible_rowidx(sheet, sheet->range.row0 + row);
-		gint nrowi = _gtk_sheet_last_visible_rowidx(sheet, sheet->range.rowi + row);
-		if (nrow0 >= 0 && nrowi >= 0)
+		row_button_set(sheet, i);
+		_gtk_sheet_column_button_set(sheet, j);
+
+		area.x = _gtk_sheet_column_left_xpixel(sheet, j);
+		area.y = _gtk_sheet_row_top_ypixel(sheet, i);
+		area.width = COLPTR(sheet, j)->width;
+		area.height = ROW_HEIGHT(sheet, i);
+
+		if (i == sheet->range.row0)
 		{
-		    sheet->drag_range.row0 = nrow0;
-		    sheet->drag_range.rowi = nrowi;
+		    area.y = area.y + 2;
+		    area.height = area.height - 2;
 		}
-	    }
-	    if (column > 0)
-	    {
-		gint ncol0 = _gtk_sheet_first_visible_colidx(sheet, sheet->range.col0 + column);
-		gint ncoli = _gtk_sheet_first_visible_colidx(sheet, sheet->range.coli + column);
-		if (ncol0 >= 0 && ncoli >= 0)
+		if (i == sheet->range.rowi)
+		    area.height = area.height - 3;
+
+		if (j == sheet->range.col0)
 		{
-		    sheet->drag_range.col0 = ncol0;
-		    sheet->drag_range.coli = ncoli;
+		    area.x = area.x + 2;
+		    area.width = area.width - 2;
 		}
-	    }
-	    else
-	    {
-		gint ncol0 = _gtk_sheet_last_visible_colidx(sheet, sheet->range.col0 + column);
-		gint ncoli = _gtk_sheet_last_visible_colidx(sheet, sheet->range.coli + column);
-		if (ncol0 >= 0 && ncoli >= 0)
+		if (j == sheet->range.coli)
+		    area.width = area.width - 3;
+
+		if ((i != sheet->active_cell.row || j != sheet->active_cell.col)
+		    && area.width > 0 && area.height > 0)
 		{
-		    sheet->drag_range.col0 = ncol0;
-		    sheet->drag_range.coli = ncoli;
+		    area.x++;
+		    area.y++;
+
+		    if (run.width > 0 && run.x + run.width == area.x
+			&& run.y == area.y && run.height == area.height)
+		    {
+			run.width += area.width;
+			continue;
+		    }
+		    if (run.width > 0)
+			gdk_region_union_with_rect(region, &run);
+		    run = area;
 		}
 	    }
-#endif
 
-	    if (aux.row0 != sheet->drag_range.row0 ||
-		aux.col0 != sheet->drag_range.col0)
-	    {
-		draw_xor_rectangle(sheet, aux);
-		draw_xor_rectangle(sheet, sheet->drag_range);
-	    }
 	}
-	return (TRUE);
+	if (run.width > 0)
+	    gdk_region_union_with_rect(region, &run);
     }
 
-    if (GTK_SHEET_IN_RESIZE(sheet))
+    if (!gdk_region_empty(region))
     {
-	GtkSheetRange aux, visr;
-	gint current_col, current_row, col_threshold, row_threshold;
+	gdk_region_get_clipbox(region, &area);
 
-	g_assert(0 <= sheet->drag_cell.row && sheet->drag_cell.row <= sheet->maxrow);
-	g_assert(0 <= sheet->drag_cell.col && sheet->drag_cell.col <= sheet->maxcol);
+	gdk_gc_set_clip_region(sheet->xor_gc, region);
+	gdk_draw_rectangle(sheet->sheet_window,
+	    sheet->xor_gc,
+	    TRUE,
+	    area.x, area.y,
+	    area.width, area.height);
+	gdk_gc_set_clip_region(sheet->xor_gc, NULL);
+    }
+    gdk_region_destroy(region);
 
-	current_row = MIN(sheet->maxrow, _gtk_sheet_row_from_ypixel(sheet, y));
-	current_col = MIN(sheet->maxcol, _gtk_sheet_column_from_xpixel(sheet, x));
+    gtk_sheet_draw_border(sheet, sheet->range);
+}
 
-	row    = current_row - sheet->drag_cell.row;
-	column = current_col - sheet->drag_cell.col;
+static void
+gtk_sheet_draw_backing_pixmap(GtkSheet *sheet, GtkSheetRange range)
+{
+    gint x, y, width, height;
 
-#if GTK_SHEET_DEBUG_SELECTION > 0
-	g_debug("gtk_sheet_motion: RESIZE row %d col %d cr %d cc %d",
-	    row, column, current_row, current_col);
-#endif
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
 
-	/*use half of column width resp. row height as threshold to expand selection*/
-	row_threshold = _gtk_sheet_row_top_ypixel(sheet, current_row);
-	if (current_row >= 0)
-	    row_threshold += (ROWPTR(sheet, current_row)->height) / 2;
+    x = _gtk_sheet_column_left_xpixel(sheet, range.col0);
+    y = _gtk_sheet_row_top_ypixel(sheet, range.row0);
+    width = _gtk_sheet_column_left_xpixel(sheet, range.coli) - x;
+    if (0 <= range.coli && range.coli <= sheet->maxcol)
+	width += COLPTR(sheet, range.coli)->width;
+    height = _gtk_sheet_row_top_ypixel(sheet, range.rowi) - y;
+    if (0 <= range.rowi && range.rowi <= sheet->maxrow)
+	height += ROW_HEIGHT(sheet, range.rowi);
 
-	if (current_row > sheet->drag_range.row0 && y < row_threshold)
-	    current_row = _gtk_sheet_last_visible_rowidx(sheet, current_row - 1);
-	else if (current_row < sheet->drag_range.row0 && y < row_threshold)
-	    current_row = _gtk_sheet_first_visible_rowidx(sheet, current_row + 1);
+    if (range.row0 == sheet->range.row0)
+    {
+	y = y - 5;
+	height = height + 5;
+    }
+    if (range.rowi == sheet->range.rowi)
+	height = height + 5;
 
-	col_threshold = _gtk_sheet_column_left_xpixel(sheet, current_col);
-	if (current_col >= 0)
-	    col_threshold += (COLPTR(sheet, current_col)->width) / 2;
+    if (range.col0 == sheet->range.col0)
+    {
+	x = x - 5;
+	width = width + 5;
+    }
+    if (range.coli == sheet->range.coli)
+	width = width + 5;
 
-	if (current_col > sheet->drag_range.col0 && x < col_threshold)
-	    current_col = _gtk_sheet_last_visible_colidx(sheet, current_col - 1);
-	else if (current_col < sheet->drag_range.col0 && x > col_threshold)
-	    current_col = _gtk_sheet_first_visible_colidx(sheet, current_col + 1);
+    width = MIN(width, sheet->sheet_window_width - x);
+    height = MIN(height, sheet->sheet_window_height - y);
 
-	sheet->x_drag = x;
-	sheet->y_drag = y;
-	aux = sheet->range;
+    x--;
+    y--;
+    width += 2;
+    height += 2;
 
-	/* beware of invisible columns/rows */
-	if (!_gtk_sheet_get_visible_range(sheet, &visr))
-	    return (TRUE);
+    x = (sheet->row_titles_visible) ? MAX(x, sheet->row_title_area.width) : MAX(x, 0);
+    y = (sheet->column_titles_visible) ? MAX(y, sheet->column_title_area.height) : MAX(y, 0);
 
-#if GTK_SHEET_DEBUG_SELECTION > 0
-	g_debug("gtk_sheet_motion: RESIZE th %d row %d col %d cr %d cc %d",
-	    row_threshold, row, column, current_row, current_col);
+    if (range.coli >= sheet->maxcol)
+	width = sheet->sheet_window_width - x;
+    if (range.rowi >= sheet->maxrow)
+	height = sheet->sheet_window_height - y;
+
+#if GTK_SHEET_DEBUG_EXPOSE > 0
+    g_debug("gtk_sheet_draw_backing_pixmap: x %d y %d w %d h %d",
+	x, y, width + 1, height + 1);
 #endif
 
-	if (_POINT_IN_RANGE(current_row, current_col, &visr))
-	{
-	    aux = sheet->drag_range;
-	    sheet->drag_range = sheet->range;
+    gdk_draw_pixmap(sheet->sheet_window,
+	gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+	sheet->pixmap,
+	x, y,
+	x, y,
+	width + 1,
+	height + 1);
+}
 
-	    if (sheet->state != GTK_SHEET_COLUMN_SELECTED)
-	    {
-		if (current_row >= sheet->drag_range.row0)
-		{
-		    sheet->drag_range.rowi = current_row;
-		}
-		else if (current_row < sheet->drag_range.row0)
-		{
-		    sheet->drag_range.rowi = sheet->drag_range.row0;
-		    sheet->drag_range.row0 = current_row;
-		}
-	    }
+static inline void
+gtk_sheet_cell_init(GtkSheetCell *cell)
+{
+    cell->extent.x = cell->extent.y = 0;
+    cell->extent.width = cell->extent.height = 0;
 
-	    if (sheet->state != GTK_SHEET_ROW_SELECTED)
-	    {
-		if (current_col >= sheet->drag_range.col0)
-		{
-		    sheet->drag_range.coli = current_col;
-		}
-		else if (current_col < sheet->drag_range.col0)
-		{
-		    sheet->drag_range.coli = sheet->drag_range.col0;
-		    sheet->drag_range.col0 = current_col;
-		}
-	    }
+    cell->row = cell->col = -1;
 
-	    if (_RANGE_NEQ_RANGE(&aux, &sheet->drag_range)
-	    {
-		draw_xor_rectangle(sheet, aux);
-		draw_xor_rectangle(sheet, sheet->drag_range);
-	    }
-	}
-	return (TRUE);
-    }
+    cell->attr_id = 0;
+    cell->extent_flags = 0;
+    cell->text = cell->link = NULL;
 
-    gtk_sheet_get_pixel_info(sheet, NULL, x, y, &row, &column);
+    cell->tooltip_markup = cell->tooltip_text = NULL;
+}
 
-    if (sheet->state == GTK_SHEET_NORMAL
-	&& row == sheet->active_cell.row && column == sheet->active_cell.col)
+static void
+gtk_sheet_cell_finalize(GtkSheet *sheet, GtkSheetCell *cell)
+{
+    g_return_if_fail(cell != NULL);
+
+    _gtk_sheet_cell_uncount_extent(sheet, cell, cell->row, cell->col);
+
+    if (cell->text)
     {
-	return (TRUE);
+	PoolStrfree(sheet, cell->text);
+	cell->text = NULL;
+
+	if (GTK_IS_OBJECT(sheet) && G_OBJECT(sheet)->ref_count > 0)
+	    _gtk_sheet_emit_clear_cell(sheet, cell->row, cell->col);
     }
 
-    if (GTK_SHEET_IN_SELECTION(sheet) && (mods & GDK_BUTTON1_MASK))
+    if (cell->link)
     {
-	GtkSheetRange visr;
+	cell->link = NULL;
+    }
 
-	if (!_gtk_sheet_get_visible_range(sheet, &visr))
-	    return (TRUE);
+    if (cell->tooltip_markup)
+    {
+	PoolStrfree(sheet, cell->tooltip_markup);
+	cell->tooltip_markup = NULL;
+    }
 
-	if (_POINT_IN_RANGE(
-	    row >= 0 ? row : _gtk_sheet_first_visible_rowidx(sheet, 0),
-	    column >= 0 ? column : _gtk_sheet_first_visible_colidx(sheet, 0), 
-	    &visr))
-	{
-	    gtk_sheet_extend_selection(sheet, row, column);
-	}
+    if (cell->tooltip_text)
+    {
+	PoolStrfree(sheet, cell->tooltip_text);
+	cell->tooltip_text = NULL;
     }
 
-    return (TRUE);
+    if (cell->attr_id)
+    {
+	_gtk_sheet_attr_unref(sheet, cell->attr_id);
+	cell->attr_id = 0;
+    }
 }
 
-/* _HUNT_() statement macros find visible row/col into hunting direction */
+static GtkSheetCell *
+gtk_sheet_cell_new(GtkSheet *sheet)
+{
+    GtkSheetCell *cell = PoolCellAlloc(sheet);
+    gtk_sheet_cell_init(cell);
+    return (cell);
+}
 
-#define _HUNT_VISIBLE_LEFT(col) \
-	while (col > 0 \
-	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col))) ) \
-		  col--; \
-	if (col < 0) col = 0; \
-	while (col < sheet->maxcol \
-	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col))) ) \
-		  col++; \
-	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) ) \
-		col = -1;
+/**
+ * gtk_sheet_set_cell_text:
+ * @sheet: a #GtkSheet.
+ * @row: row_number
+ * @col: column number
+ * @text: cell text
+ *
+ * Set cell contents and allocate memory if needed. No 
+ * justifcation is made. attributes and links remain unchanged.
+ */
+void
+gtk_sheet_set_cell_text(GtkSheet *sheet, gint row, gint col, const gchar *text)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-#define _HUNT_VISIBLE_RIGHT(col) \
-	while (col < sheet->maxcol \
-	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col))) ) \
-		col++; \
-    if (col > sheet->maxcol) col = sheet->maxcol; \
-	while (col > 0 \
-	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col))) ) \
-		col--; \
-	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) ) \
-		col = -1;
+    if (col > sheet->maxcol || row > sheet->maxrow)
+	return;
+    if (col < 0 || row < 0)
+	return;
 
-#define _HUNT_VISIBLE_UP(row) \
-	while (row > 0 \
-	  && !GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row))) row--; \
-	if (row < 0) row = 0; \
-	while (row < sheet->maxrow \
-	  && !GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row))) row++; \
-	if (!GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row))) row = -1;
+    GtkSheetCellAttr attributes;
+    gtk_sheet_get_attributes(sheet, row, col, &attributes);
+    gtk_sheet_set_cell(sheet, row, col, attributes.justification, text);
+}
 
-#define _HUNT_VISIBLE_DOWN(row) \
-	while (row < sheet->maxrow \
-	  && ((row < 0) || !GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row))) ) \
-	       row++; \
-	if (row > sheet->maxrow) row = sheet->maxrow; \
-	while (row > 0 \
-	  && !GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row))) row--; \
-	if (!GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row))) row = -1;
+/**
+ * gtk_sheet_set_cell:
+ * @sheet: a #GtkSheet.
+ * @row: row_number
+ * @col: column number
+ * @justification: a #GtkJustification :GTK_JUSTIFY_LEFT, RIGHT, CENTER
+ * @text: cell text
+ *
+ * Set cell contents and allocate memory if needed.
+ */
+void
+gtk_sheet_set_cell(GtkSheet *sheet, gint row, gint col,
+    GtkJustification justification,
+    const gchar *text)
+{
+    GtkSheetCell *cell;
+    gchar *old_text;
 
-#define _HUNT_FOCUS_LEFT(row,col) \
- 	while (col > 0 \
- 	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) \
-	      || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(COLPTR(sheet,col)) \
-	      || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col))) \
- 		  col--; \
- 	if (col < 0) col = 0; \
- 	while (col < sheet->maxcol \
- 	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) \
-	      || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(COLPTR(sheet, col)) \
-              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col)) ) \
- 		  col++; \
- 	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) \
-	    || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(COLPTR(sheet, col)) \
-            || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col) ) \
- 		col = -1;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+    if (col > sheet->maxcol || row > sheet->maxrow)
+	return;
+    if (col < 0 || row < 0)
+	return;
 
-#define _HUNT_FOCUS_RIGHT(row,col) \
- 	while (col < sheet->maxcol \
- 	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) \
-	      || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(COLPTR(sheet, col)) \
-              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col)) ) \
- 		col++; \
-         if (col > sheet->maxcol) col = sheet->maxcol; \
- 	while (col > 0 \
- 	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) \
-	      || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(COLPTR(sheet, col)) \
-              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col)) ) \
- 		col--; \
- 	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) \
-	    || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(COLPTR(sheet, col)) \
-            || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col) ) \
- 		col = -1;
+    if (sheet->model)  /* the model stores the text */
+    {
+	_gtk_sheet_model_set_cell(sheet, row, col, justification, text);
+	return;
+    }
 
-#define _HUNT_FOCUS_UP(row,col) \
- 	while (row > 0 \
- 	  && (!GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row)) \
-	      || !GTK_SHEET_ROW_CAN_GRAB_FOCUS(ROWPTR(sheet, row)) \
-              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col))) \
- 	      row--; \
- 	if (row < 0) row = 0; \
- 	while (row < sheet->maxrow \
- 	  && (!GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row)) \
-	      || !GTK_SHEET_ROW_CAN_GRAB_FOCUS(ROWPTR(sheet, row)) \
-              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col))) \
- 	    row++; \
- 	if (!GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row)) \
-	    || !GTK_SHEET_ROW_CAN_GRAB_FOCUS(ROWPTR(sheet, row)) \
-            || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col)) \
- 	    row = -1;
+#if GTK_SHEET_DEBUG_SET_CELL_TIMER > 0
+    GTimer *tm = g_timer_new();
+#endif
 
-#define _HUNT_FOCUS_DOWN(row,col) \
- 	while (row < sheet->maxrow \
- 	  && (!GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row)) \
-	      || !GTK_SHEET_ROW_CAN_GRAB_FOCUS(ROWPTR(sheet, row)) \
-              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col))) \
- 	       row++; \
- 	if (row > sheet->maxrow) row = sheet->maxrow; \
- 	while (row > 0 \
- 	  && (!GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row)) \
-	      || !GTK_SHEET_ROW_CAN_GRAB_FOCUS(ROWPTR(sheet, row)) \
-              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col))) \
- 	    row--; \
- 	if (!GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row)) \
-	    || !GTK_SHEET_ROW_CAN_GRAB_FOCUS(ROWPTR(sheet, row)) \
-            || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col)) \
- 	    row = -1;
+    CheckCellData(sheet, row, col);
 
-static gint
-_gtk_sheet_move_query(GtkSheet *sheet, gint row, gint column, 
-    gboolean need_focus)
-{
-    gint row_move = FALSE, column_move = FALSE;
-    gint row_align = -1, col_align = -1;  /* undef. */
-    guint height, width;
-    gint new_row = row;
-    gint new_col = column;
-    GtkSheetRange visr;
+#if 0 && GTK_SHEET_DEBUG_SET_CELL_TIMER > 0
+    g_debug("st1: %0.6f", g_timer_elapsed(tm, NULL));
+#endif
 
-#if GTK_SHEET_DEBUG_MOVE > 0
-    g_debug("gtk_sheet_move_query: row %d column %d view row %d-%d col %d-%d",
-	row, column,
-	MIN_VIEW_ROW(sheet), MAX_VIEW_ROW(sheet),
-	MIN_VIEW_COLUMN(sheet), MAX_VIEW_COLUMN(sheet));
+    cell = _gtk_sheet_cell_get(sheet, row, col);
+
+    GtkSheetCellAttr attributes;
+    gtk_sheet_get_attributes(sheet, row, col, &attributes);
+    if (attributes.justification != justification)
+    {
+	attributes.justification = justification;
+	_gtk_sheet_cell_override(sheet, row, col,
+	    &attributes, GTK_SHEET_ATTR_JUSTIFICATION, 0);
+    }
+
+    old_text = cell->text;  /* text may point to it */
+    cell->text = NULL;
+
+    if (text)
+    {
+	gchar *dataformat = gtk_sheet_column_get_format(sheet, col);
+
+	if (dataformat)
+	    text = gtk_data_format_remove(text, dataformat);
+
+#if GTK_SHEET_DEBUG_SET_CELL_TEXT > 0
+	g_debug("gtk_sheet_set_cell[%p]: r %d c %d ar %d ac %d <%s>", 
+	    sheet, row, col, sheet->active_cell.row, sheet->active_cell.col, text);
 #endif
 
-    height = sheet->sheet_window_height;
-    width = sheet->sheet_window_width;
+	cell->text = PoolStrdup(sheet, text);
+    }
+#if GTK_SHEET_DEBUG_SET_CELL_TEXT > 0
+    else
+	g_debug("gtk_sheet_set_cell[%p]: r %d c %d ar %d ac %d NULL", 
+	    sheet, row, col, sheet->active_cell.row, sheet->active_cell.col);
+#endif
+    PoolStrfree(sheet, old_text);
 
-    /* beware of invisible columns/rows */
-    if (!_gtk_sheet_get_visible_range(sheet, &visr))
-	return (0);
+#if 0 && GTK_SHEET_DEBUG_SET_CELL_TIMER > 0
+    g_debug("st2: %0.6f", g_timer_elapsed(tm, NULL));
+#endif
 
-#if GTK_SHEET_DEBUG_MOVE > 0
-    g_debug("gtk_sheet_move_query: state %d visr row %d-%d col %d-%d",
-	sheet->state, visr.row0, visr.rowi, visr.col0, visr.coli);
+    _gtk_sheet_update_extent(sheet, cell, row, col);
+
+#if GTK_SHEET_DEBUG_SET_CELL_TIMER > 0
+    g_debug("st3: %0.6f", g_timer_elapsed(tm, NULL));
 #endif
 
-    if (row >= MAX_VIEW_ROW(sheet)
-	&& row <= visr.rowi
-	&& sheet->state != GTK_SHEET_COLUMN_SELECTED)
+    if (attributes.is_visible)
     {
-#if GTK_SHEET_DEBUG_MOVE > 0
-	g_debug("gtk_sheet_move_query: row %d > maxvr %d visr.rowi %d", 
-	    row, MAX_VIEW_ROW(sheet), visr.rowi);
-#endif
-	row_align = 1;  /* bottom */
-	if (need_focus)
-	{
-	    _HUNT_FOCUS_DOWN(new_row,new_col);
-	}
-	else
+	gboolean need_draw = TRUE;
+
+	/* PR#104553 - if sheet entry editor is active on the cell being modified,
+	   we need to update it's contents
+	   */
+	if (row == sheet->active_cell.row && col == sheet->active_cell.col)
 	{
-	    _HUNT_VISIBLE_DOWN(new_row);
+#if GTK_SHEET_DEBUG_SET_CELL_TEXT > 0
+	    g_debug("gtk_sheet_set_cell[%p]: update sheet entry", sheet);
+#endif
+	    gtk_sheet_set_entry_text(sheet, text);  /* PR#104553 */
 	}
-	if (new_row >= 0) row_move = TRUE;
 
-	if (MAX_VIEW_ROW(sheet) == sheet->maxrow &&
-	    _gtk_sheet_row_bottom_ypixel(sheet, sheet->maxrow) < height)
+	if (gtk_sheet_autoresize(sheet))  /* handle immediate resize */
 	{
-	    row_move = FALSE;
-	    row_align = -1;
-	}
-    }
+	    if (cell->text && cell->text[0])
+	    {
+		if (gtk_sheet_autoresize_columns(sheet))
+		{
+		    GtkSheetColumn *colptr = COLPTR(sheet, col);
+		    gint new_width;
 
-    if (row <= MIN_VIEW_ROW(sheet)
-	&& row >= visr.row0
-	&& sheet->state != GTK_SHEET_COLUMN_SELECTED)
-    {
-#if GTK_SHEET_DEBUG_MOVE > 0
-	g_debug("gtk_sheet_move_query: row %d < minvr %d visr.row0 %d",
-	    row, MIN_VIEW_ROW(sheet), visr.row0);
-#endif
-	row_align = 0;  /* top */
-	if (need_focus)
-	{
-	    _HUNT_FOCUS_UP(new_row,new_col);
-	}
-	else
-	{
-	    _HUNT_VISIBLE_UP(new_row);
-	}
-	if (new_row >= 0) row_move = TRUE;
-    }
+		    _gtk_sheet_column_resolve_extents(sheet, col);
+		    new_width = COLUMN_EXTENT_TO_WIDTH(colptr->max_extent_width);
 
-    if (column >= MAX_VIEW_COLUMN(sheet)
-	&& column <= visr.coli
-	&& sheet->state != GTK_SHEET_ROW_SELECTED)
-    {
-#if GTK_SHEET_DEBUG_MOVE > 0
-	g_debug("gtk_sheet_move_query: col %d > maxvc %d visr.coli %d",
-	    column, MAX_VIEW_COLUMN(sheet), visr.coli);
+		    if (new_width != colptr->width)
+		    {
+#if GTK_SHEET_DEBUG_SIZE > 0
+			g_debug("gtk_sheet_set_cell[%d]: set col width %d", col, new_width);
 #endif
-	col_align = 1;  /* right */
-	if (need_focus)
-	{
-	    _HUNT_FOCUS_RIGHT(new_row,new_col);
-	}
-	else
-	{
-	    _HUNT_VISIBLE_RIGHT(new_col);
-	}
-	if (new_col >= 0) column_move = TRUE;
+			gtk_sheet_set_column_width(sheet, col, new_width);
+			GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_REDRAW_PENDING);
+			need_draw = FALSE;
+		    }
+		}
 
-	if (MAX_VIEW_COLUMN(sheet) == sheet->maxcol &&
-	    _gtk_sheet_column_right_xpixel(sheet, sheet->maxcol) < width)
-	{
-	    column_move = FALSE;
-	    col_align = -1;
-	}
-    }
+		if (gtk_sheet_autoresize_rows(sheet))
+		{
+		    gint new_height;
 
-    if (column <= MIN_VIEW_COLUMN(sheet)
-	&& column >= visr.col0
-	&& sheet->state != GTK_SHEET_ROW_SELECTED)
-    {
-#if GTK_SHEET_DEBUG_MOVE > 0
-	g_debug("gtk_sheet_move_query: col %d < minvc %d visr.col0 %d",
-	    column, MIN_VIEW_COLUMN(sheet), visr.col0);
+		    _gtk_sheet_row_resolve_extents(sheet, row);
+		    new_height = ROW_EXTENT_TO_HEIGHT(ROW_MAX_EXTENT(sheet, row));
+
+		    if (new_height != ROW_HEIGHT(sheet, row))
+		    {
+#if GTK_SHEET_DEBUG_SIZE > 0
+			g_debug("gtk_sheet_set_cell[%d]: set row height %d", row, new_height);
 #endif
-	col_align = 0;  /* left */
-	if (need_focus)
-	{
-	    _HUNT_FOCUS_LEFT(new_row,new_col);
+			gtk_sheet_set_row_height(sheet, row, new_height);
+			GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_REDRAW_PENDING);
+			need_draw = FALSE;
+		    }
+		}
+	    }
 	}
-	else
+
+	if (need_draw)
 	{
-	    _HUNT_VISIBLE_LEFT(new_col);
+	    GtkSheetRange range;
+
+	    range.row0 = row;
+	    range.rowi = row;
+	    range.col0 = sheet->view.col0;
+	    range.coli = sheet->view.coli;
+
+	    _gtk_sheet_range_queue_draw(sheet, &range);
 	}
-	if (new_col >= 0) column_move = TRUE;
     }
+#if GTK_SHEET_DEBUG_SET_CELL_TIMER > 0
+    g_debug("st4: %0.6f", g_timer_elapsed(tm, NULL));
+#endif
 
-#if GTK_SHEET_DEBUG_MOVE > 0
-    g_debug("gtk_sheet_move_query: rowMv %d colMv %d newR %d newC %d",
-	row_move, column_move, new_row, new_col);
+    _gtk_sheet_emit_changed(sheet, row, col);
+    _gtk_sheet_emit_range_changed(sheet, row, col, row, col);
+
+#if GTK_SHEET_DEBUG_SET_CELL_TIMER > 0
+    g_debug("st9: %0.6f", g_timer_elapsed(tm, NULL));
+    g_timer_destroy(tm);
 #endif
+}
 
-    if (row_move || column_move)
-    {
-	gtk_sheet_moveto(sheet, new_row, new_col, row_align, col_align);
-    }
+/*
+ * _gtk_sheet_range_texts_array - text source for gtk_sheet_set_range_texts()
+ */
+typedef struct
+{
+    const GtkSheetRange *range;
+    const gchar * const *texts;
+} GtkSheetRangeTexts;
 
-    return (row_move || column_move);
+static const gchar *
+_gtk_sheet_range_texts_array(GtkSheet *sheet, gint row, gint col, gpointer data)
+{
+    GtkSheetRangeTexts *rt = data;
+    gint ncols = rt->range->coli - rt->range->col0 + 1;
+
+    return (rt->texts[(row - rt->range->row0) * ncols + (col - rt->range->col0)]);
 }
 
-static void
-gtk_sheet_extend_selection(GtkSheet *sheet, gint row, gint column)
+/**
+ * gtk_sheet_set_range_texts:
+ * @sheet: a #GtkSheet.
+ * @range: the #GtkSheetRange to load
+ * @texts: (array) row-major cell texts for @range, NULL entries 
+ *       clear the text of a cell
+ *
+ * Set the texts of all cells in a range at once. Justification, 
+ * attributes and links remain unchanged. See 
+ * gtk_sheet_set_range_texts_func(). 
+ */
+void
+gtk_sheet_set_range_texts(GtkSheet *sheet, const GtkSheetRange *range,
+    const gchar * const *texts)
 {
-    GtkSheetRange range;
-    gint state;
-    gint r, c;
+    GtkSheetRangeTexts rt;
 
-#if GTK_SHEET_DEBUG_SELECTION > 0
-    g_debug("gtk_sheet_extend_selection: row %d column %d", row, column);
-#endif
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_return_if_fail(range != NULL);
+    g_return_if_fail(texts != NULL);
 
-    if (sheet->selection_mode == GTK_SELECTION_SINGLE)
-	return;
-    if (row == sheet->selection_cell.row && column == sheet->selection_cell.col)
-	return;
+    rt.range = range;
+    rt.texts = texts;
 
-    if (sheet->active_cell.row < 0 || sheet->active_cell.row > sheet->maxrow)
-	return;
-    if (sheet->active_cell.col < 0 || sheet->active_cell.col > sheet->maxcol)
+    gtk_sheet_set_range_texts_func(sheet, range,
+	_gtk_sheet_range_texts_array, &rt);
+}
+
+/**
+ * gtk_sheet_set_range_texts_func:
+ * @sheet: a #GtkSheet.
+ * @range: the #GtkSheetRange to load
+ * @func: (scope call) returns the text of each cell
+ * @user_data: passed to @func
+ *
+ * Set the texts of all cells in a range at once, row by row. 
+ * Unlike calling gtk_sheet_set_cell_text() for every cell, 
+ * storage is grown once, row and column extents are updated 
+ * once for the whole range, the sheet is redrawn and 
+ * autoresized once and a single "changed" signal with row and 
+ * column -1 is emitted. 
+ */
+void
+gtk_sheet_set_range_texts_func(GtkSheet *sheet, const GtkSheetRange *range,
+    GtkSheetRangeTextFunc func, gpointer user_data)
+{
+    GtkSheetRange loaded;
+    gchar **dataformat;
+    gint row, col, ncols;
+    gboolean measure;
+
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_return_if_fail(range != NULL);
+    g_return_if_fail(func != NULL);
+
+    loaded.row0 = MAX(range->row0, 0);
+    loaded.rowi = MIN(range->rowi, sheet->maxrow);
+    loaded.col0 = MAX(range->col0, 0);
+    loaded.coli = MIN(range->coli, sheet->maxcol);
+
+    if (loaded.row0 > loaded.rowi || loaded.col0 > loaded.coli)
 	return;
 
-    _gtk_sheet_move_query(sheet, row, column, FALSE);
-    gtk_widget_grab_focus(GTK_WIDGET(sheet));
+    ncols = loaded.coli - loaded.col0 + 1;
 
-    if (GTK_SHEET_IN_DRAG(sheet))
+    dataformat = g_new0(gchar *, ncols);
+    for (col = loaded.col0; col <= loaded.coli; col++)
+	dataformat[col - loaded.col0] = gtk_sheet_column_get_format(sheet, col);
+
+    if (sheet->model)  /* the model stores the texts */
+    {
+	for (row = loaded.row0; row <= loaded.rowi; row++)
+	{
+	    for (col = loaded.col0; col <= loaded.coli; col++)
+	    {
+		const gchar *text = func(sheet, row, col, user_data);
+
+		if (text && dataformat[col - loaded.col0])
+		    text = gtk_data_format_remove(text, dataformat[col - loaded.col0]);
+
+		gtk_sheet_model_set_cell_text(sheet->model, row, col, text);
+	    }
+	}
+
+	for (col = 0; col < ncols; col++)
+	    g_free(dataformat[col]);
+	g_free(dataformat);
+
+	/* the model reports "range-changed" through cells-changed */
+	_gtk_sheet_emit_changed(sheet, -1, -1);
 	return;
+    }
 
-    state = sheet->state;
+    CheckBounds(sheet, loaded.rowi, loaded.coli);  /* grow once */
 
-    switch(sheet->state)
+    measure = gtk_sheet_autoresize(sheet);  /* otherwise defer shaping */
+
+    for (row = loaded.row0; row <= loaded.rowi; row++)
     {
-	case GTK_SHEET_ROW_SELECTED:
-	    column = sheet->maxcol;
-	    break;
+	for (col = loaded.col0; col <= loaded.coli; col++)
+	{
+	    GtkSheetCell *cell = _gtk_sheet_cell_get(sheet, row, col);
+	    const gchar *text = func(sheet, row, col, user_data);
+	    gchar *old_text;
 
-	case GTK_SHEET_COLUMN_SELECTED:
-	    row = sheet->maxrow;
-	    break;
+	    if (text && dataformat[col - loaded.col0])
+		text = gtk_data_format_remove(text, dataformat[col - loaded.col0]);
 
-	case GTK_SHEET_NORMAL:
-	    r = sheet->active_cell.row;
-	    c = sheet->active_cell.col;
+	    if (!text || !text[0])
+		text = NULL;
 
-	    sheet->range.col0 = c;
-	    sheet->range.row0 = r;
-	    sheet->range.coli = c;
-	    sheet->range.rowi = r;
+	    if (!cell)
+	    {
+		if (!text)
+		    continue;
 
-	    gdk_draw_pixmap(sheet->sheet_window,
-		gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
-		sheet->pixmap,
-		_gtk_sheet_column_left_xpixel(sheet, c) - 1,
-		_gtk_sheet_row_top_ypixel(sheet, r) - 1,
-		_gtk_sheet_column_left_xpixel(sheet, c) - 1,
-		_gtk_sheet_row_top_ypixel(sheet, r) - 1,
-		COLPTR(sheet, c)->width + 4,
-		sheet->row[r].height + 4);
+		cell = gtk_sheet_cell_new(sheet);
+		cell->row = row;
+		cell->col = col;
+		PutCellData(sheet, row, col, cell);
+	    }
 
-	    sheet->state = GTK_SHEET_RANGE_SELECTED;
-	    gtk_sheet_range_draw_selection(sheet, sheet->range);
-	    /* FALLTHROUGH */
+	    _gtk_sheet_cell_uncount_extent(sheet, cell, row, col);
 
-	case GTK_SHEET_RANGE_SELECTED:
-	    sheet->state = GTK_SHEET_RANGE_SELECTED;
-	    /* FALLTHROUGH */
+	    old_text = cell->text;  /* text may point to it */
+	    cell->text = PoolStrdup(sheet, text);
+	    PoolStrfree(sheet, old_text);
+
+	    cell->extent.width = 0;
+	    cell->extent.height = 0;
+
+	    if (!text)
+		continue;
+
+	    if (measure)
+		_gtk_sheet_cell_measure_extent(sheet, cell, row, col);
+	    else
+		_gtk_sheet_cell_defer_extent(sheet, cell, row, col);
+	}
     }
 
-    sheet->selection_cell.row = row;
-    sheet->selection_cell.col = column;
+    for (col = 0; col < ncols; col++)
+	g_free(dataformat[col]);
+    g_free(dataformat);
 
-    range.col0 = MIN(column, sheet->active_cell.col);
-    range.coli = MAX(column, sheet->active_cell.col);
+    if (gtk_sheet_autoresize(sheet))
+    {
+	if (gtk_sheet_autoresize_columns(sheet))
+	{
+	    for (col = loaded.col0; col <= loaded.coli; col++)
+		_gtk_sheet_autoresize_column_internal(sheet, col);
+	}
+	if (gtk_sheet_autoresize_rows(sheet))
+	{
+	    for (row = loaded.row0; row <= loaded.rowi; row++)
+		_gtk_sheet_autoresize_row_internal(sheet, row);
+	}
+    }
 
-    range.row0 = MIN(row, sheet->active_cell.row);
-    range.rowi = MAX(row, sheet->active_cell.row);
+    /* PR#104553 - keep the sheet entry in sync */
+    if (_POINT_IN_RANGE(sheet->active_cell.row, sheet->active_cell.col, &loaded))
+    {
+	gchar *text = gtk_sheet_cell_get_text(sheet,
+	    sheet->active_cell.row, sheet->active_cell.col);
 
-    range.coli = MIN(range.coli, sheet->maxcol);
-    range.rowi = MIN(range.rowi, sheet->maxrow);
+	gtk_sheet_set_entry_text(sheet, text ? text : "");
+    }
 
-    if (range.row0 != sheet->range.row0 || range.rowi != sheet->range.rowi ||
-	range.col0 != sheet->range.col0 || range.coli != sheet->range.coli ||
-	state == GTK_SHEET_NORMAL)
     {
-	gtk_sheet_real_select_range(sheet, &range);
+	GtkSheetRange draw;
+
+	/* text may overflow into neighbour cells */
+	draw.row0 = loaded.row0;
+	draw.rowi = loaded.rowi;
+	draw.col0 = sheet->view.col0;
+	draw.coli = sheet->view.coli;
+
+	_gtk_sheet_range_queue_draw(sheet, &draw);
     }
+
+    _gtk_sheet_emit_changed(sheet, -1, -1);
+    _gtk_sheet_emit_range_changed(sheet,
+	loaded.row0, loaded.col0, loaded.rowi, loaded.coli);
 }
 
-/*
- * gtk_sheet_entry_key_press_handler:
- * 
- * this event handler propagates the "key-press-event" signal 
- * from the sheet_entry to the #GtkSheet
- * 
- * @param widget the #GtkSheet (connected "swapped")
- * @param key    the GdkEventKey which triggered this signal
- * 
- * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
+/**
+ * gtk_sheet_cell_clear:
+ * @sheet: a #GtkSheet.
+ * @row: row_number
+ * @column: column number
+ *
+ * Clear cell contents.
  */
-static gboolean
-gtk_sheet_entry_key_press_handler(GtkWidget *widget, GdkEventKey *key, gpointer user_data)
+void
+gtk_sheet_cell_clear(GtkSheet *sheet, gint row, gint column)
 {
-    gboolean stop_emission = FALSE;
-    GtkSheet *sheet = GTK_SHEET(widget);
+    GtkSheetRange range;
 
-#if GTK_SHEET_DEBUG_KEYPRESS > 0
-    g_debug("gtk_sheet_entry_key_press_handler: called, key %s",
-	gtk_accelerator_name(key->keyval, key->state));
-#endif
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (!_gtk_sheet_binding_filter(sheet, key))
-    {
-#if GTK_SHEET_DEBUG_KEYPRESS > 0
-	g_debug("gtk_sheet_entry_key_press_handler: filtered binding");
+    if (column > sheet->maxcol || row > sheet->maxrow)
+	return;
+    if (column > sheet->maxalloccol || row > sheet->maxallocrow)
+	return;
+    if (column < 0 || row < 0)
+	return;
+
+    range.row0 = row;
+    range.rowi = row;
+    range.col0 = sheet->view.col0;
+    range.coli = sheet->view.coli;
+
+    gtk_sheet_real_cell_clear(sheet, row, column, FALSE);
+
+    _gtk_sheet_range_queue_draw(sheet, &range);
+}
+
+/**
+ * gtk_sheet_cell_delete:
+ * @sheet: a #GtkSheet.
+ * @row: row_number
+ * @column: column number
+ *
+ * Clear cell contents and remove links.
+ */
+void
+gtk_sheet_cell_delete(GtkSheet *sheet, gint row, gint column)
+{
+    GtkSheetRange range;
+
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+    if (column > sheet->maxcol || row > sheet->maxrow)
+	return;
+    if (column > sheet->maxalloccol || row > sheet->maxallocrow)
+	return;
+    if (column < 0 || row < 0)
+	return;
+
+    range.row0 = row;
+    range.rowi = row;
+    range.col0 = sheet->view.col0;
+    range.coli = sheet->view.coli;
+
+    gtk_sheet_real_cell_clear(sheet, row, column, TRUE);
+
+    _gtk_sheet_range_queue_draw(sheet, &range);
+}
+
+static void
+gtk_sheet_real_cell_clear(GtkSheet *sheet,
+    gint row, gint column,
+    gboolean delete)
+{
+    GtkSheetCell *cell;
+
+    cell = _gtk_sheet_cell_get(sheet, row, column);
+    if (!cell)
+	return;
+
+#if GTK_SHEET_DEBUG_SET_CELL_TEXT > 0
+	g_debug("gtk_sheet_real_cell_clear[%p]: r %d c %d ar %d ac %d <%s>", 
+                sheet, row, column, 
+                sheet->active_cell.row, sheet->active_cell.col, 
+                cell->text ? cell->text : "<NULL>");
 #endif
-	return (FALSE);
+
+    _gtk_sheet_cell_uncount_extent(sheet, cell, row, column);
+    cell->extent.width = 0;
+    cell->extent.height = 0;
+
+    if (cell->text)
+    {
+	PoolStrfree(sheet, cell->text);
+	cell->text = NULL;
+
+	if (GTK_IS_OBJECT(sheet) && G_OBJECT(sheet)->ref_count > 0)
+	    _gtk_sheet_emit_clear_cell(sheet, row, column);
     }
 
-#if 1
-    /* process enter-event
-       - detect wether Return or Enter was pressed 
-       - detect wether the application wants it to be handled by the sheet 
-       - if unwanted: execute appropriate application handler 
-       - use a new signal for this ? 
-       */
-    if ((key->keyval == GDK_KEY_Return) || (key->keyval == GDK_KEY_KP_Enter))
+    if (cell->link)
     {
-#if GTK_SHEET_DEBUG_ENTER_PRESSED > 0
-	g_debug("gtk_sheet_entry_key_press_handler: enter-pressed: invoke");
-#endif
-	_gtksheet_signal_emit(GTK_OBJECT(sheet),
-	    sheet_signals[ENTER_PRESSED],
-	    key,
-	    &stop_emission);
-#if GTK_SHEET_DEBUG_ENTER_PRESSED > 0
-	g_debug("gtk_sheet_entry_key_press_handler: enter-pressed: returns %d", stop_emission);
-#endif
+	cell->link = NULL;
     }
-#endif
 
-    if (!stop_emission)
+    if (cell->tooltip_markup)
     {
-	/* intercept item_entry processing if there exists a key binding on the sheet */
+	PoolStrfree(sheet, cell->tooltip_markup);
+	cell->tooltip_markup = NULL;
+    }
 
-	if (gtk_bindings_activate_event(GTK_OBJECT(sheet), key))
-	{
-	    stop_emission = TRUE;
-	}
-	else
-	{
-	    g_signal_emit_by_name(GTK_OBJECT(widget),
-		"key_press_event", key,
-		&stop_emission);
-	}
+    if (cell->tooltip_text)
+    {
+	PoolStrfree(sheet, cell->tooltip_text);
+	cell->tooltip_text = NULL;
     }
 
-#if GTK_SHEET_DEBUG_KEYPRESS > 0
-    g_debug("gtk_sheet_entry_key_press_handler: done, key %s stop %d",
-	gtk_accelerator_name(key->keyval, key->state), stop_emission);
+    if (delete)
+    {
+	gtk_sheet_cell_finalize(sheet, cell);
+
+#if GTK_SHEET_DEBUG_ALLOCATION > 0
+	g_debug("gtk_sheet_real_cell_clear: freeing %d %d", row, column); 
 #endif
 
-    return (stop_emission);
+	PutCellData(sheet, row, column, NULL);
+	PoolCellFree(sheet, cell);
+    }
 }
 
-/*
- * gtk_sheet_key_press_handler:
- * 
- * this is the #GtkSheet widget class "key-press-event" handler.
- * 
- * @param widget the #GtkSheet
- * @param key    the GdkEventKey which triggered this signal
- * 
- * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
+/**
+ * gtk_sheet_range_clear:
+ * @sheet: a #GtkSheet.
+ * @range: a #GtkSheetRange
+ *
+ * Clear range contents. If range==NULL the whole sheet will be cleared.
  */
-static gboolean
-gtk_sheet_key_press_handler(GtkWidget *widget, GdkEventKey *key)
+void
+gtk_sheet_range_clear(GtkSheet *sheet, const GtkSheetRange *range)
 {
-    GtkSheet *sheet;
-    gint state;
-    gboolean extend_selection = FALSE;
-    gboolean in_selection = FALSE;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    sheet = GTK_SHEET(widget);
+    gtk_sheet_real_range_clear(sheet, range, FALSE);
+}
 
-    extend_selection = (key->state & GDK_SHIFT_MASK)
-	|| key->keyval == GDK_KEY_Shift_L
-	|| key->keyval == GDK_KEY_Shift_R;
+/**
+ * gtk_sheet_range_delete:
+ * @sheet: a #GtkSheet.
+ * @range: a #GtkSheetRange
+ *
+ * Clear range contents and remove links.
+ * FIXME:: if range==NULL whole sheet is deleted?
+ */
+void
+gtk_sheet_range_delete(GtkSheet *sheet, const GtkSheetRange *range)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    state = sheet->state;
-    in_selection = GTK_SHEET_IN_SELECTION(sheet);
-    GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+    gtk_sheet_real_range_clear(sheet, range, TRUE);
+}
 
-#if GTK_SHEET_DEBUG_KEYPRESS > 0
-    g_debug("gtk_sheet_key_press_handler: key %s",
-	gtk_accelerator_name(key->keyval, key->state));
-#endif
+static void
+gtk_sheet_real_range_clear(GtkSheet *sheet, const GtkSheetRange *range,
+    gboolean delete)
+{
+    gint i, n, *pos;
+    GtkSheetRange clear;
+    GPtrArray *cells;
 
-    /* if there is a key_binding, use implementation from _gtk_sheet_move_cursor() */
+    if (!range)
+    {
+	clear.row0 = 0;
+	clear.rowi = sheet->maxallocrow;
+	clear.col0 = 0;
+	clear.coli = sheet->maxalloccol;
+    }
+    else
+    {
+	clear = *range;
+    }
 
-    if (_gtk_sheet_binding_filter(sheet, key)
-	&& gtk_bindings_activate_event(GTK_OBJECT(sheet), key))
+    clear.row0 = MAX(clear.row0, 0);
+    clear.col0 = MAX(clear.col0, 0);
+    clear.rowi = MIN(clear.rowi, sheet->maxallocrow);
+    clear.coli = MIN(clear.coli, sheet->maxalloccol);
+
+    /* visit populated cells only, maximum extents follow through 
+       the histograms. Positions are copied, CLEAR_CELL handlers 
+       may modify the sheet. */
+    cells = CollectCellData(sheet, clear.row0, clear.rowi, clear.col0, clear.coli);
+
+    n = cells->len;
+    pos = g_new(gint, 2 * n + 1);
+
+    for (i = 0; i < n; i++)
     {
-#if GTK_SHEET_DEBUG_KEYPRESS > 0
-	g_debug("gtk_sheet_key_press_handler: done %s (binding)",
-	    gtk_accelerator_name(key->keyval, key->state));
-#endif
-	return (TRUE);
+	GtkSheetCell *cell = g_ptr_array_index(cells, i);
+
+	pos[2 * i] = cell->row;
+	pos[2 * i + 1] = cell->col;
     }
+    g_ptr_array_free(cells, TRUE);
 
-    return (FALSE);
-}
+    for (i = 0; i < n; i++)
+    {
+	gtk_sheet_real_cell_clear(sheet, pos[2 * i], pos[2 * i + 1], delete);
+    }
+    g_free(pos);
 
+    if (delete)
+	PoolTrim(sheet, FALSE);  /* release slabs when the sheet became empty */
 
-/**
- * _gtk_sheet_move_cursor: 
- * @sheet:  the sheet 
- * @step:   type of movement
- * @count:  number of steps to move
- * @extend_selection: TRUE if the move should extend the 
- * selection default handler for move-cursor signal 
+    if (n > 0)
+	_gtk_sheet_emit_range_changed(sheet,
+	    clear.row0, clear.col0, clear.rowi, clear.coli);
+
+    clear.col0 = sheet->view.col0;  /* text may overflow */
+    clear.coli = sheet->view.coli;
+    _gtk_sheet_range_queue_draw(sheet, &clear);
+}
+
+/*
+ * model text cache
+ *
+ * Texts pulled from a #GtkSheetModel are kept per cell, so that 
+ * drawing, overflow checks and measuring ask the model only once 
+ * for a cell near the view. Empty cells are cached as NULL texts. 
+ * Entries are dropped when the model reports a change and swept 
+ * outside the view when the cache is full. The cache then allows 
+ * twice the entries kept, so a view larger than the default size 
+ * does not sweep on every miss.
  */
-static void _gtk_sheet_move_cursor(GtkSheet *sheet,
-    GtkMovementStep step,
-    gint count,
-    gboolean extend_selection)
+
+#define GTK_SHEET_MODEL_CACHE_SIZE  8192  /* min. texts before a sweep */
+
+typedef struct _GtkSheetModelEntry
 {
-    gint row, col;
-    gboolean veto = TRUE;
+    gint row;     /* key */
+    gint col;
+    gchar *text;  /* NULL for empty cells */
+    guint stamp;  /* cache serial when last handed out */
+} GtkSheetModelEntry;
 
-#if GTK_SHEET_DEBUG_SIGNALS > 0
-    g_debug("SIGNAL _gtk_sheet_move_cursor %p step %d count %d extend %d",
-	sheet, step, count, extend_selection);
-#endif
+struct _GtkSheetModelCache
+{
+    GHashTable *lookup;  /* (row, col) -> GtkSheetModelEntry */
+    guint limit;         /* sweep when reached */
+    guint serial;        /* advanced once per main loop iteration */
+    guint unpin_idle;    /* advances serial, 0 if nothing pinned */
+};
 
-    row = sheet->active_cell.row;
-    col = sheet->active_cell.col;
+static guint
+_gtk_sheet_model_key_hash(gconstpointer k)
+{
+    const GtkSheetModelEntry *key = k;
 
-    switch(step)
-    {
-	case GTK_MOVEMENT_PAGES:
-	    count = count *
-		(MAX_VIEW_ROW(sheet) - MIN_VIEW_ROW(sheet) - GTK_SHEET_PAGE_OVERLAP);
-	    /* FALLTHROUGH */
+    return ((guint)key->row * 8191 + (guint)key->col);
+}
 
-	case GTK_MOVEMENT_DISPLAY_LINES:
-	    if (count < 0) /* Move Up */
-	    {
-		if (extend_selection)
-		{
-		    if (sheet->state == GTK_STATE_NORMAL)
-		    {
-			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-			if (!veto)
-			    break;
-		    }
-		    if (sheet->selection_cell.row > 0)
-		    {
-			row = sheet->selection_cell.row + count;
-			_HUNT_VISIBLE_UP(row);
-			gtk_sheet_extend_selection(sheet, row, sheet->selection_cell.col);
-		    }
-		    return;
-		}
+static gboolean
+_gtk_sheet_model_key_equal(gconstpointer k1, gconstpointer k2)
+{
+    const GtkSheetModelEntry *a = k1;
+    const GtkSheetModelEntry *b = k2;
 
-		if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
-		    row = MIN_VIEW_ROW(sheet);
-		if (sheet->state == GTK_SHEET_ROW_SELECTED)
-		    col = MIN_VIEW_COLUMN(sheet);
+    return (a->row == b->row && a->col == b->col);
+}
 
-		if (row > 0)
-		{
-		    row = row + count;
-		    _HUNT_FOCUS_UP(row,col);
-		}
-	    }
-	    else if (count > 0) /* Move Down */
-	    {
-		if (extend_selection)
-		{
-		    if (sheet->state == GTK_STATE_NORMAL)
-		    {
-			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-			if (!veto)
-			    break;
-		    }
-		    if (sheet->selection_cell.row < sheet->maxrow)
-		    {
-			row = sheet->selection_cell.row + count;
-			_HUNT_VISIBLE_DOWN(row);
-			gtk_sheet_extend_selection(sheet, row, sheet->selection_cell.col);
-		    }
-		    return;
-		}
+static void
+_gtk_sheet_model_entry_free(GtkSheetModelEntry *entry)
+{
+    g_free(entry->text);
+    g_free(entry);
+}
 
-		if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
-		    row = MIN_VIEW_ROW(sheet) - 1;
-		if (sheet->state == GTK_SHEET_ROW_SELECTED)
-		    col = MIN_VIEW_COLUMN(sheet);
+static GtkSheetModelCache *
+_gtk_sheet_model_cache_new(void)
+{
+    GtkSheetModelCache *cache = g_new0(GtkSheetModelCache, 1);
 
-		if (row < sheet->maxrow)
-		{
-		    row = row + count;
-		    _HUNT_FOCUS_DOWN(row,col);
-		}
-	    }
-	    if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-	    break;
+    cache->lookup = g_hash_table_new_full(
+	_gtk_sheet_model_key_hash, _gtk_sheet_model_key_equal,
+	NULL, (GDestroyNotify)_gtk_sheet_model_entry_free);
+    cache->limit = GTK_SHEET_MODEL_CACHE_SIZE;
 
-	case GTK_MOVEMENT_HORIZONTAL_PAGES:
-	    count = count *
-		(MAX_VIEW_COLUMN(sheet) - MIN_VIEW_COLUMN(sheet) - GTK_SHEET_PAGE_OVERLAP);
-	    /* FALLTHROUGH */
+    return (cache);
+}
 
-	case GTK_MOVEMENT_VISUAL_POSITIONS:
-	    if (count < 0)  /* Move Left */
-	    {
-		if (extend_selection)
-		{
-		    if (sheet->state == GTK_STATE_NORMAL)
-		    {
-			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-			if (!veto)
-			    break;
-		    }
-		    if (sheet->selection_cell.col > 0)
-		    {
-			col = sheet->selection_cell.col + count;
-			_HUNT_VISIBLE_LEFT(col);
-			gtk_sheet_extend_selection(sheet, sheet->selection_cell.row, col);
-		    }
-		    return;
-		}
+static void
+_gtk_sheet_model_cache_flush(GtkSheetModelCache *cache)
+{
+    g_hash_table_remove_all(cache->lookup);
+}
 
-		if (sheet->state == GTK_SHEET_ROW_SELECTED)
-		    col = MIN_VIEW_COLUMN(sheet) - 1;
-		if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
-		    row = MIN_VIEW_ROW(sheet);
+static void
+_gtk_sheet_model_cache_free(GtkSheetModelCache *cache)
+{
+    if (cache->unpin_idle)
+	g_source_remove(cache->unpin_idle);
 
-		if (col > 0)
-		{
-		    col = col + count;
-		    _HUNT_FOCUS_LEFT(row,col);
-		}
-	    }
-	    else if (count > 0) /* Move Right */
-	    {
-		if (extend_selection)
-		{
-		    if (sheet->state == GTK_STATE_NORMAL)
-		    {
-			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-			if (!veto)
-			    break;
-		    }
-		    if (sheet->selection_cell.col < sheet->maxcol)
-		    {
-			col = sheet->selection_cell.col + count;
-			_HUNT_VISIBLE_RIGHT(col);
-			gtk_sheet_extend_selection(sheet, sheet->selection_cell.row, col);
-		    }
-		    return;
-		}
+    g_hash_table_destroy(cache->lookup);
+    g_free(cache);
+}
 
-		if (sheet->state == GTK_SHEET_ROW_SELECTED)
-		    col = MIN_VIEW_COLUMN(sheet) - 1;
-		if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
-		    row = MIN_VIEW_ROW(sheet);
+static gboolean
+_gtk_sheet_model_cache_unpin(gpointer data)
+{
+    GtkSheetModelCache *cache = data;
 
-		if (col < sheet->maxcol)
-		{
-		    /* after sheet initialisation, row is -1
-		       when called from gtk_sheet_focus()
-		       */
-		    if (row < 0) row = 0;
+    cache->serial++;
+    cache->unpin_idle = 0;
+    return (FALSE);
+}
 
-		    col = col + count;
-		    _HUNT_FOCUS_RIGHT(row,col);
-		}
-	    }
-	    if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-	    break;
+/*
+ * _gtk_sheet_model_cache_pin - keep a text until the main loop 
+ * runs again
+ * 
+ * a caller may hold texts of several cells, i.e. while walking a 
+ * range, a sweep must not free them under its hands
+ * 
+ * @param cache
+ * @param entry    the entry handed out
+ */
+static inline void
+_gtk_sheet_model_cache_pin(GtkSheetModelCache *cache,
+    GtkSheetModelEntry *entry)
+{
+    entry->stamp = cache->serial;
 
-	case GTK_MOVEMENT_BUFFER_ENDS:
-	    if (count < 0)  /* Topmost Row */
-	    {
-		if (extend_selection)
-		{
-		    if (sheet->state == GTK_STATE_NORMAL)
-		    {
-			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-			if (!veto)
-			    break;
-		    }
-		    if (sheet->selection_cell.row > 0)
-		    {
-			row = 0;
-			_HUNT_VISIBLE_UP(row);
-			gtk_sheet_extend_selection(sheet, row, sheet->selection_cell.col);
-		    }
-		    return;
-		}
-		row = 0;
-		_HUNT_FOCUS_UP(row,col);
-	    }
-	    else if (count > 0)  /* Last Row */
-	    {
-		if (extend_selection)
-		{
-		    if (sheet->state == GTK_STATE_NORMAL)
-		    {
-			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-			if (!veto)
-			    break;
-		    }
-		    if (sheet->selection_cell.row < sheet->maxrow)
-		    {
-			row = sheet->maxrow;
-			_HUNT_VISIBLE_DOWN(row);
-			gtk_sheet_extend_selection(sheet, row, sheet->selection_cell.col);
-		    }
-		    return;
-		}
-		row = sheet->maxrow;
-		_HUNT_FOCUS_DOWN(row,col);
-	    }
-	    if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-	    break;
+    if (!cache->unpin_idle)
+    {
+	cache->unpin_idle = g_idle_add_full(G_PRIORITY_HIGH_IDLE,
+	    _gtk_sheet_model_cache_unpin, cache, NULL);
+    }
+}
 
-	case GTK_MOVEMENT_DISPLAY_LINE_ENDS:
-	    if (count < 0)  /* First Column */
-	    {
-		if (extend_selection)
-		{
-		    if (sheet->state == GTK_STATE_NORMAL)
-		    {
-			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-			if (!veto)
-			    break;
-		    }
-		    if (sheet->selection_cell.col > 0)
-		    {
-			col = 0;
-			_HUNT_VISIBLE_LEFT(col);
-			gtk_sheet_extend_selection(sheet, sheet->selection_cell.row, col);
-		    }
-		    return;
-		}
-		col = 0;
-		_HUNT_FOCUS_LEFT(row,col);
-	    }
-	    else if (count > 0)  /* Last Column */
-	    {
-		if (extend_selection)
-		{
-		    if (sheet->state == GTK_STATE_NORMAL)
-		    {
-			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-			if (!veto)
-			    break;
-		    }
-		    if (sheet->selection_cell.col < sheet->maxcol)
-		    {
-			col = sheet->maxcol;
-			_HUNT_VISIBLE_RIGHT(col);
-			gtk_sheet_extend_selection(sheet, sheet->selection_cell.row, col);
-		    }
-		    return;
-		}
-		col = sheet->maxcol;
-		_HUNT_FOCUS_RIGHT(row,col);
-	    }
-	    if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-	    break;
+/*
+ * _gtk_sheet_model_cache_drop - forget the texts of a range
+ * 
+ * @param cache
+ * @param range    cells to drop or NULL for all
+ */
+static void
+_gtk_sheet_model_cache_drop(GtkSheetModelCache *cache,
+    const GtkSheetRange *range)
+{
+    GHashTableIter iter;
+    gpointer key, value;
 
-	case GTK_MOVEMENT_LOGICAL_POSITIONS:
-	    if (sheet->state == GTK_SHEET_ROW_SELECTED)
-		col = MIN_VIEW_COLUMN(sheet) - 1;
-	    if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
-		row = MIN_VIEW_ROW(sheet);
+    if (!range)
+    {
+	_gtk_sheet_model_cache_flush(cache);
+	return;
+    }
 
-	    if ((count == GTK_DIR_LEFT)  /* Tab horizontal backward */
-		|| (count == GTK_DIR_TAB_BACKWARD))  /* Tab horizontal backward */
-	    {
-		gint old_col = col;
-		gint old_row = row;
+    g_hash_table_iter_init(&iter, cache->lookup);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+	GtkSheetModelEntry *entry = value;
 
-		if (col > 0)  /* move left within line */
-		{
-		    col = col - 1;
-		    _HUNT_FOCUS_LEFT(row,col);
-		}
-		if (col == old_col && row > 0) /* wrap at eol */
-		{
-		    row = row - 1;
-		    _HUNT_FOCUS_UP(row,col);
+	if (_POINT_IN_RANGE(entry->row, entry->col, range))
+	    g_hash_table_iter_remove(&iter);
+    }
+}
 
-		    if (row != old_row) 
-		    {
-			col = sheet->maxcol;
-			_HUNT_FOCUS_LEFT(row,col);
-		    }
-		}
-	    }
-	    else if ((count == GTK_DIR_RIGHT)  /* Tab horizontal forward */
-		|| (count == GTK_DIR_TAB_FORWARD))
-	    {
-		gint old_col = col;
+/*
+ * _gtk_sheet_model_cache_sweep - evict texts of cells away from the view
+ * 
+ * keeps cells within half a view size around the current view and 
+ * texts handed out during this main loop iteration, O(entries) but 
+ * amortized over the misses until the next sweep
+ * 
+ * @param sheet
+ */
+static void
+_gtk_sheet_model_cache_sweep(GtkSheet *sheet)
+{
+    GtkSheetModelCache *cache = sheet->model_cache;
+    GtkSheetRange keep;
+    GHashTableIter iter;
+    gpointer key, value;
+    gint rmargin = (MAX_VIEW_ROW(sheet) - MIN_VIEW_ROW(sheet) + 1) / 2;
+    gint cmargin = (MAX_VIEW_COLUMN(sheet) - MIN_VIEW_COLUMN(sheet) + 1) / 2;
 
-		if (col < sheet->maxcol)  /* move right within line */
-		{
-		    col = col + 1;
-		    _HUNT_FOCUS_RIGHT(row,col);
-		}
-		if (col == old_col && row < sheet->maxrow) /* wrap at eol */
-		{
-		    col = 0;
-		    _HUNT_FOCUS_RIGHT(row,col);
+    keep.row0 = MIN_VIEW_ROW(sheet) - rmargin;
+    keep.rowi = MAX_VIEW_ROW(sheet) + rmargin;
+    keep.col0 = MIN_VIEW_COLUMN(sheet) - cmargin;
+    keep.coli = MAX_VIEW_COLUMN(sheet) + cmargin;
 
-		    row = row + 1;
-		    _HUNT_FOCUS_DOWN(row,col);
-		}
+    g_hash_table_iter_init(&iter, cache->lookup);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+	GtkSheetModelEntry *entry = value;
+
+	if (entry->stamp == cache->serial && cache->unpin_idle)
+	    continue;  /* pinned */
+
+	if (!_POINT_IN_RANGE(entry->row, entry->col, &keep))
+	    g_hash_table_iter_remove(&iter);
+    }
+
+    /* next sweep after as many misses as entries kept */
+    cache->limit = MAX(GTK_SHEET_MODEL_CACHE_SIZE,
+	2 * g_hash_table_size(cache->lookup));
+}
+
+/*
+ * _gtk_sheet_model_grow_extent - account a model text in the extents
+ * 
+ * Model cells have no stored extent, the column width and row 
+ * height maxima only grow with the texts seen in the view.
+ * 
+ * @param sheet
+ * @param row, col
+ * @param text     the cell text
+ */
+static void
+_gtk_sheet_model_grow_extent(GtkSheet *sheet,
+    gint row, gint col, const gchar *text)
+{
+    GtkSheetColumn *colptr = COLPTR(sheet, col);
+    GtkSheetCellAttr attributes;
+    guint text_width = 0, text_height = 0;
+    gint extent_width, extent_height;
+
+    if (!GTK_SHEET_COLUMN_IS_VISIBLE(colptr))
+	return;
+    if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	return;
+
+    gtk_sheet_get_attributes(sheet, row, col, &attributes);
+
+    _get_string_extent(sheet, colptr,
+	attributes.font_desc, text, &text_width, &text_height);
+
+    extent_width = CELL_EXTENT_WIDTH(text_width, attributes.border.width);
+    extent_height = CELL_EXTENT_HEIGHT(text_height, 0);
+
+    if (extent_width > colptr->max_extent_width)
+	colptr->max_extent_width = extent_width;
+    if (extent_height > ROW_MAX_EXTENT(sheet, row))
+	ROW_SET_MAX_EXTENT(sheet, row, extent_height);
+}
+
+/*
+ * _gtk_sheet_model_cell_text - get a cell text from the model
+ * 
+ * asks the model on a cache miss and measures texts of cells 
+ * within the view
+ * 
+ * @param sheet
+ * @param row, col
+ * 
+ * @return the text, owned by the cache and valid until the main 
+ *         loop runs again, or NULL for empty cells
+ */
+static gchar *
+_gtk_sheet_model_cell_text(GtkSheet *sheet, gint row, gint col)
+{
+    GtkSheetModelCache *cache = sheet->model_cache;
+    GtkSheetModelEntry key, *entry;
+
+    key.row = row;
+    key.col = col;
+    entry = g_hash_table_lookup(cache->lookup, &key);
+
+    if (entry)
+    {
+	_gtk_sheet_model_cache_pin(cache, entry);
+	return (entry->text);
+    }
+
+    if (g_hash_table_size(cache->lookup) >= cache->limit)
+	_gtk_sheet_model_cache_sweep(sheet);
+
+    entry = g_new0(GtkSheetModelEntry, 1);
+    entry->row = row;
+    entry->col = col;
+    entry->text = gtk_sheet_model_get_cell_text(sheet->model, row, col);
+
+    if (entry->text && !entry->text[0])
+    {
+	g_free(entry->text);
+	entry->text = NULL;
+    }
+
+    g_hash_table_insert(cache->lookup, entry, entry);
+    _gtk_sheet_model_cache_pin(cache, entry);
+
+    if (entry->text && _POINT_IN_RANGE(row, col, &sheet->view))
+	_gtk_sheet_model_grow_extent(sheet, row, col, entry->text);
+
+    return (entry->text);
+}
+
+/*
+ * _gtk_sheet_model_fit - adjust the sheet size to the model
+ * 
+ * @param sheet
+ */
+static void
+_gtk_sheet_model_fit(GtkSheet *sheet)
+{
+    gint nrows = gtk_sheet_model_get_n_rows(sheet->model);
+    gint ncols = gtk_sheet_model_get_n_columns(sheet->model);
+
+    if (nrows > sheet->maxrow + 1)
+	gtk_sheet_add_row(sheet, nrows - (sheet->maxrow + 1));
+    else if (nrows < sheet->maxrow + 1)
+	gtk_sheet_delete_rows(sheet, nrows, (sheet->maxrow + 1) - nrows);
+
+    if (ncols > sheet->maxcol + 1)
+	gtk_sheet_add_column(sheet, ncols - (sheet->maxcol + 1));
+    else if (ncols < sheet->maxcol + 1)
+	gtk_sheet_delete_columns(sheet, ncols, (sheet->maxcol + 1) - ncols);
+}
+
+/*
+ * _gtk_sheet_model_autoresize - apply grown extents to the view
+ * 
+ * @param sheet
+ * @param range    cells which changed
+ * 
+ * @return TRUE if a row height or column width was changed
+ */
+static gboolean
+_gtk_sheet_model_autoresize(GtkSheet *sheet, const GtkSheetRange *range)
+{
+    gboolean resized = FALSE;
+    gint row, col;
+
+    if (!gtk_sheet_autoresize(sheet))
+	return (FALSE);
+
+    if (gtk_sheet_autoresize_columns(sheet))
+    {
+	for (col = range->col0; col <= range->coli; col++)
+	{
+	    GtkSheetColumn *colptr = COLPTR(sheet, col);
+	    gint new_width;
+
+	    if (!colptr->max_extent_width)
+		continue;
+
+	    new_width = COLUMN_EXTENT_TO_WIDTH(colptr->max_extent_width);
+
+	    if (new_width != colptr->width)
+	    {
+		gtk_sheet_set_column_width(sheet, col, new_width);
+		resized = TRUE;
 	    }
-	    else if (count == GTK_DIR_UP)  /* Tab vertical backward */
+	}
+    }
+
+    if (gtk_sheet_autoresize_rows(sheet))
+    {
+	for (row = range->row0; row <= range->rowi; row++)
+	{
+	    gint max_extent_height = ROW_MAX_EXTENT(sheet, row);
+	    gint new_height;
+
+	    if (!max_extent_height)
+		continue;
+
+	    new_height = ROW_EXTENT_TO_HEIGHT(max_extent_height);
+
+	    if (new_height != ROW_HEIGHT(sheet, row))
 	    {
-		gint old_row = row;
-		gint old_col = col;
+		gtk_sheet_set_row_height(sheet, row, new_height);
+		resized = TRUE;
+	    }
+	}
+    }
+
+    if (resized)
+	GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_REDRAW_PENDING);
+
+    return (resized);
+}
+
+static void
+_gtk_sheet_model_cells_changed_handler(GtkSheetModel *model,
+    GtkSheetRange *range, GtkSheet *sheet)
+{
+    GtkSheetRange changed, visible;
+    gint row, col;
+
+    g_return_if_fail(range != NULL);
+
+    _gtk_sheet_model_cache_drop(sheet->model_cache, range);
+
+    changed.row0 = MAX(range->row0, 0);
+    changed.rowi = MIN(range->rowi, sheet->maxrow);
+    changed.col0 = MAX(range->col0, 0);
+    changed.coli = MIN(range->coli, sheet->maxcol);
+
+    if (changed.row0 > changed.rowi || changed.col0 > changed.coli)
+	return;
+
+    /* pull and measure what is going to be drawn */
+    visible.row0 = MAX(changed.row0, MIN_VIEW_ROW(sheet));
+    visible.rowi = MIN(changed.rowi, MAX_VIEW_ROW(sheet));
+    visible.col0 = MAX(changed.col0, MIN_VIEW_COLUMN(sheet));
+    visible.coli = MIN(changed.coli, MAX_VIEW_COLUMN(sheet));
+
+    if (visible.row0 <= visible.rowi && visible.col0 <= visible.coli)
+    {
+	for (row = visible.row0; row <= visible.rowi; row++)
+	{
+	    for (col = visible.col0; col <= visible.coli; col++)
+		(void) _gtk_sheet_model_cell_text(sheet, row, col);
+	}
+
+	if (!_gtk_sheet_model_autoresize(sheet, &visible))
+	{
+	    GtkSheetRange draw;
+
+	    /* text may overflow into neighbour cells */
+	    draw.row0 = visible.row0;
+	    draw.rowi = visible.rowi;
+	    draw.col0 = sheet->view.col0;
+	    draw.coli = sheet->view.coli;
+
+	    _gtk_sheet_range_queue_draw(sheet, &draw);
+	}
+    }
+    else
+	_gtk_sheet_tile_cache_invalidate(sheet, &changed);
+
+    /* PR#104553 - keep the sheet entry in sync */
+    if (_POINT_IN_RANGE(sheet->active_cell.row, sheet->active_cell.col, &changed))
+    {
+	gchar *text = gtk_sheet_cell_get_text(sheet,
+	    sheet->active_cell.row, sheet->active_cell.col);
+
+	gtk_sheet_set_entry_text(sheet, text ? text : "");
+    }
+
+    _gtk_sheet_emit_range_changed(sheet,
+	changed.row0, changed.col0, changed.rowi, changed.coli);
+}
+
+static void
+_gtk_sheet_model_rows_inserted_handler(GtkSheetModel *model,
+    gint row, gint nrows, GtkSheet *sheet)
+{
+    _gtk_sheet_model_cache_flush(sheet->model_cache);
+
+    if (row > sheet->maxrow)
+	gtk_sheet_add_row(sheet, nrows);
+    else
+	gtk_sheet_insert_rows(sheet, row, nrows);
+}
+
+static void
+_gtk_sheet_model_rows_deleted_handler(GtkSheetModel *model,
+    gint row, gint nrows, GtkSheet *sheet)
+{
+    _gtk_sheet_model_cache_flush(sheet->model_cache);
+    gtk_sheet_delete_rows(sheet, row, nrows);
+}
+
+static void
+_gtk_sheet_model_columns_inserted_handler(GtkSheetModel *model,
+    gint col, gint ncols, GtkSheet *sheet)
+{
+    _gtk_sheet_model_cache_flush(sheet->model_cache);
+
+    if (col > sheet->maxcol)
+	gtk_sheet_add_column(sheet, ncols);
+    else
+	gtk_sheet_insert_columns(sheet, col, ncols);
+}
+
+static void
+_gtk_sheet_model_columns_deleted_handler(GtkSheetModel *model,
+    gint col, gint ncols, GtkSheet *sheet)
+{
+    _gtk_sheet_model_cache_flush(sheet->model_cache);
+    gtk_sheet_delete_columns(sheet, col, ncols);
+}
+
+/*
+ * _gtk_sheet_model_set_cell - store an edited cell into the model
+ * 
+ * the model reports the change by "cells-changed", which updates 
+ * the cache, extents and the view 
+ * 
+ * @param sheet
+ * @param row, col
+ * @param justification
+ * @param text     new text or NULL
+ */
+static void
+_gtk_sheet_model_set_cell(GtkSheet *sheet, gint row, gint col,
+    GtkJustification justification, const gchar *text)
+{
+    GtkSheetCellAttr attributes;
+    gchar *dataformat;
+
+    gtk_sheet_get_attributes(sheet, row, col, &attributes);
+    if (attributes.justification != justification)
+    {
+	attributes.justification = justification;
+	_gtk_sheet_cell_override(sheet, row, col,
+	    &attributes, GTK_SHEET_ATTR_JUSTIFICATION, 0);
+    }
+
+    dataformat = gtk_sheet_column_get_format(sheet, col);
+    if (text && dataformat)
+	text = gtk_data_format_remove(text, dataformat);
+
+#if GTK_SHEET_DEBUG_SET_CELL_TEXT > 0
+    g_debug("_gtk_sheet_model_set_cell[%p]: r %d c %d <%s>", 
+	sheet, row, col, text ? text : "NULL");
+#endif
+
+    if (!gtk_sheet_model_set_cell_text(sheet->model, row, col, text))
+    {
+	GtkSheetRange range;
+
+	g_free(dataformat);
+
+	/* read-only model or refused text, the cell shows the model text */
+	range.row0 = range.rowi = row;
+	range.col0 = range.coli = col;
+	_gtk_sheet_range_queue_draw(sheet, &range);
+	return;
+    }
+    g_free(dataformat);
+
+    _gtk_sheet_emit_changed(sheet, row, col);
+}
+
+/**
+ * gtk_sheet_set_model:
+ * @sheet: a #GtkSheet
+ * @model: (allow-none) a #GtkSheetModel or NULL
+ *
+ * Attach a cell data source to the sheet. The sheet is resized 
+ * to the dimensions of the model and pulls texts and attributes 
+ * of the cells it draws, measures or edits from the model. 
+ * Cell texts stored in the sheet itself are ignored while a 
+ * model is attached, cell attributes set on the sheet override 
+ * those of the model. 
+ *  
+ * Rows of the default height hold no per-row memory, the sheet 
+ * keeps one pointer per 1024 rows for them. Rows which get 
+ * resized, hidden or measured (within the view) allocate their 
+ * page of 1024 rows, about 17 KB. 
+ *  
+ * Pass NULL to detach the model.
+ */
+void
+gtk_sheet_set_model(GtkSheet *sheet, GtkSheetModel *model)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_return_if_fail(model == NULL || GTK_IS_SHEET_MODEL(model));
+
+    if (sheet->model == model)
+	return;
+
+    if (sheet->model)
+    {
+	g_signal_handlers_disconnect_matched(
+	    G_OBJECT(sheet->model),
+	    G_SIGNAL_MATCH_DATA,
+	    0, 0, NULL, NULL, sheet);
+	g_object_unref(G_OBJECT(sheet->model));
+	sheet->model = NULL;
+    }
+
+    if (sheet->model_cache)
+	_gtk_sheet_model_cache_flush(sheet->model_cache);
+
+    if (model)
+    {
+	sheet->model = g_object_ref(G_OBJECT(model));
+
+	if (!sheet->model_cache)
+	    sheet->model_cache = _gtk_sheet_model_cache_new();
+
+	g_signal_connect(G_OBJECT(model), "cells-changed",
+	    (void *)_gtk_sheet_model_cells_changed_handler,
+	    (gpointer)sheet);
+	g_signal_connect(G_OBJECT(model), "rows-inserted",
+	    (void *)_gtk_sheet_model_rows_inserted_handler,
+	    (gpointer)sheet);
+	g_signal_connect(G_OBJECT(model), "rows-deleted",
+	    (void *)_gtk_sheet_model_rows_deleted_handler,
+	    (gpointer)sheet);
+	g_signal_connect(G_OBJECT(model), "columns-inserted",
+	    (void *)_gtk_sheet_model_columns_inserted_handler,
+	    (gpointer)sheet);
+	g_signal_connect(G_OBJECT(model), "columns-deleted",
+	    (void *)_gtk_sheet_model_columns_deleted_handler,
+	    (gpointer)sheet);
+
+	_gtk_sheet_model_fit(sheet);
+    }
+
+    _gtk_sheet_range_draw(sheet, NULL, TRUE);
+    gtk_sheet_show_active_cell(sheet);  /* reload the entry */
+}
+
+/**
+ * gtk_sheet_get_model:
+ * @sheet: a #GtkSheet
+ *
+ * Get the cell data source of the sheet.
+ *
+ * Returns: (transfer none) the #GtkSheetModel or NULL
+ */
+GtkSheetModel *
+gtk_sheet_get_model(GtkSheet *sheet)
+{
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
+
+    return (sheet->model);
+}
+
+/**
+ * gtk_sheet_cell_get_text:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ * @col: column number
+ *
+ * Get cell text. With a #GtkSheetModel attached, the text is 
+ * pulled from the model and stays valid until the main loop 
+ * runs again or the cell changes.
+ *
+ * Returns: a pointer to the cell text, or NULL. 
+ * Do not modify or free it, cell texts are owned by the sheet's 
+ * memory pool.
+ */
+gchar *
+gtk_sheet_cell_get_text (GtkSheet *sheet, gint row, gint col)
+{
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
+
+    if (col > sheet->maxcol || row > sheet->maxrow)
+	return (NULL);
+    if (col < 0 || row < 0)
+	return (NULL);
+
+    if (sheet->model)
+	return (_gtk_sheet_model_cell_text(sheet, row, col));
+
+    GtkSheetCell *cell = _gtk_sheet_cell_get(sheet, row, col);
+
+    if (!cell)
+	return (NULL);
+    if (!cell->text)
+	return (NULL);
+    if (!cell->text[0])
+	return (NULL);
+
+    return (cell->text);
+}
+
+/**
+ * gtk_sheet_link_cell:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ * @col: column number
+ * @link: pointer linked to the cell
+ *
+ * Link pointer to a cell.
+ */
+void
+gtk_sheet_link_cell(GtkSheet *sheet, gint row, gint col, gpointer link)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+
+    if (col > sheet->maxcol || row > sheet->maxrow)
+	return;
+    if (col < 0 || row < 0)
+	return;
+
+    CheckCellData(sheet, row, col);
+
+    _gtk_sheet_cell_get(sheet, row, col)->link = link;
+}
+
+/**
+ * gtk_sheet_get_link:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ * @col: column number
+ *
+ * Get link pointer from a cell.
+ *
+ * Returns: (transfer none) pointer linked to the cell
+ */
+gpointer
+gtk_sheet_get_link(GtkSheet *sheet, gint row, gint col)
+{
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
+    if (col > sheet->maxcol || row > sheet->maxrow)
+	return (NULL);
+    if (col < 0 || row < 0)
+	return (NULL);
+
+    GtkSheetCell *cell = _gtk_sheet_cell_get(sheet, row, col);
+
+    if (!cell)
+	return (NULL); /* Added by Chris Howell, Bob Lissner */
+
+    return (cell->link);
+}
+
+/**
+ * gtk_sheet_remove_link:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ * @col: column number
+ *
+ * Remove link pointer from a cell.
+ */
+void
+gtk_sheet_remove_link(GtkSheet *sheet, gint row, gint col)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+    if (col > sheet->maxcol || row > sheet->maxrow)
+	return;
+    if (col < 0 || row < 0)
+	return;
+
+    /* Fixed by Andreas Voegele */
+    GtkSheetCell *cell = _gtk_sheet_cell_get(sheet, row, col);
+
+    if (cell && cell->link)
+	cell->link = NULL;
+}
+
+/**
+ * gtk_sheet_cell_get_state:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ * @col: column number
+ *
+ * Get status of a cell.
+ *
+ * Returns: a #GtkStateType:
+ * GTK_SHEET_NORMAL,GTK_SHEET_ROW_SELECTED,GTK_SHEET_COLUMN_SELECTED,GTK_SHEET_RANGE_SELECTED
+ */
+GtkStateType
+gtk_sheet_cell_get_state(GtkSheet *sheet, gint row, gint col)
+{
+    gint state;
+    GtkSheetRange *range;
+
+    g_return_val_if_fail(sheet != NULL, 0);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), 0);
+    if (col > sheet->maxcol || row > sheet->maxrow)
+	return (0);
+    if (col < 0 || row < 0)
+	return (0);
+
+    state = sheet->state;
+    range = &sheet->range;
+
+    switch(state)
+    {
+	case GTK_SHEET_NORMAL:
+	    return (GTK_STATE_NORMAL);
+	    break;
+	case GTK_SHEET_ROW_SELECTED:
+	    if (row >= range->row0 && row <= range->rowi)
+		return (GTK_STATE_SELECTED);
+	    break;
+	case GTK_SHEET_COLUMN_SELECTED:
+	    if (col >= range->col0 && col <= range->coli)
+		return (GTK_STATE_SELECTED);
+	    break;
+	case GTK_SHEET_RANGE_SELECTED:
+	    if (row >= range->row0 && row <= range->rowi &&\
+		    col >= range->col0 && col <= range->coli)
+		return (GTK_STATE_SELECTED);
+	    break;
+    }
+    return (GTK_STATE_NORMAL);
+}
+
+/**
+ * gtk_sheet_get_pixel_info:
+ * @sheet: a #GtkSheet
+ * @window: base window for coordinates (null)
+ * @x: x coordinate
+ * @y: y coordinate
+ * @row: cell row number
+ * @column: cell column number
+ *
+ * Get row and column correspondig to the given position within 
+ * the sheet. 
+ *  
+ * In order to decode clicks into to title area correctly, pass 
+ * the GdkWindow from the button event. Omitting the 
+ * window (NULL) defaults to the sheet window. 
+ *  
+ * row and column may return values in the range [-1 .. max+1] 
+ * depending on wether the position lies within the title area, 
+ * the sheet cell area or beyond the outermost row/column. 
+ *  
+ * All 9 sheet areas can be reliably determined by evaluating 
+ * the returned row/column values (title area/cell 
+ * area/outside). 
+ *
+ * Returns: TRUE if the position lies within the sheet cell area
+ * or FALSE when outside (title area f.e.)
+ */
+gboolean
+gtk_sheet_get_pixel_info(GtkSheet *sheet,
+    GdkWindow *window, gint x, gint y, gint *row, gint *column)
+{
+    gint trow, tcol;
+
+    *row = *column = -1;  /* init all output vars */
+
+    g_return_val_if_fail(sheet != NULL, 0);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), 0);
+
+    /* there is a coordinate shift to be considered when
+       clicking into a title area because: 
+       - the sheet window covers the whole sheet 
+       - the column titles window overlaps the sheet window,
+          but may be shifted right when row titles are visible
+      - the row titles window overlaps the sheet window,
+         but may be shifted down when column titles are visible
+       */
+
+    if (sheet->column_titles_visible
+	&& window == sheet->column_title_window)
+    {
+	if (sheet->row_titles_visible)
+	{
+#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
+	    g_debug("gtk_sheet_get_pixel_info: shift x");
+#endif
+	    x += sheet->row_title_area.width;
+	}
+#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
+	g_debug("gtk_sheet_get_pixel_info: r1");
+#endif
+	trow = -1;
+	tcol = _gtk_sheet_column_from_xpixel(sheet, x);
+    }
+    else if (sheet->row_titles_visible
+	&& window == sheet->row_title_window)
+    {
+	if (sheet->column_titles_visible)
+	{
+#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
+	    g_debug("gtk_sheet_get_pixel_info: shift y");
+#endif
+	    y += sheet->column_title_area.height;
+	}
+#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
+	g_debug("gtk_sheet_get_pixel_info: c1");
+#endif
+	trow = _gtk_sheet_row_from_ypixel(sheet, y);
+	tcol = -1;
+    }
+    else if (sheet->column_titles_visible
+	     && sheet->row_titles_visible
+	     && x < sheet->row_title_area.width
+	     && y < sheet->column_title_area.height )
+    {
+#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
+	g_debug("gtk_sheet_get_pixel_info: sb");
+#endif
+	trow = -1;
+	tcol = -1;
+    }
+    else
+    {
+#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
+	g_debug("gtk_sheet_get_pixel_info: rN/cN");
+#endif
+	trow = _gtk_sheet_row_from_ypixel(sheet, y);
+	tcol = _gtk_sheet_column_from_xpixel(sheet, x);
+    }
+
+#if GTK_SHEET_DEBUG_PIXEL_INFO > 0
+    g_debug("gtk_sheet_get_pixel_info: x %d y %d row %d col %d", x, y, trow, tcol);
+#endif
+
+    *row = trow;
+    *column = tcol;
+
+    /* bounds checking, return false if the user clicked
+     * on a blank area */
+
+    if (trow < 0 || trow > sheet->maxrow)
+	return (FALSE);
+    if (tcol < 0 || tcol > sheet->maxcol)
+	return (FALSE);
+
+    return (TRUE);
+}
+
+/**
+ * gtk_sheet_get_cell_area:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ * @column: column number
+ * @area: a #GdkRectangle area of the cell
+ *
+ * Get area of a given cell.
+ *
+ * Returns: TRUE(success) or FALSE(failure)
+ */
+gboolean
+gtk_sheet_get_cell_area(GtkSheet *sheet,
+    gint row,
+    gint col,
+    GdkRectangle *area)
+{
+    g_return_val_if_fail(sheet != NULL, 0);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), 0);
+
+    if (row > sheet->maxrow || col > sheet->maxcol)
+	return (FALSE);
+
+    area->x = (col == -1) ? 0 : (_gtk_sheet_column_left_xpixel(sheet, col) -
+	(sheet->row_titles_visible ? sheet->row_title_area.width : 0));
+    area->y = (row == -1) ? 0 : (_gtk_sheet_row_top_ypixel(sheet, row) -
+	(sheet->column_titles_visible ? sheet->column_title_area.height : 0));
+    area->width = (col == -1) ? sheet->row_title_area.width : COLPTR(sheet, col)->width;
+    area->height = (row == -1) ? sheet->column_title_area.height : ROW_HEIGHT(sheet, row);
+
+/*
+  if(row < 0 || col < 0) return FALSE;
+
+  area->x = COLUMN_LEFT_XPIXEL(sheet, col);
+  area->y = ROW_TOP_YPIXEL(sheet, row);
+  if(sheet->row_titles_visible)
+       area->x -= sheet->row_title_area.width;
+  if(sheet->column_titles_visible)
+       area->y -= sheet->column_title_area.height;
+
+  area->width = COLPTR(sheet, col)->width;
+  area->height = ROW_HEIGHT(sheet, row);
+*/
+    return (TRUE);
+}
+
+/**
+ * gtk_sheet_set_active_cell:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ * @column: column number
+ *
+ * Set active cell where the cell entry will be displayed. 
+ * Use (row,col) = (-1,-1) to deactivate active cell. 
+ *
+ * Returns: FALSE if current cell can't be deactivated or
+ * requested cell can't be activated
+ */
+gboolean
+gtk_sheet_set_active_cell(GtkSheet *sheet, gint row, gint col)
+{
+    g_return_val_if_fail(sheet != NULL, 0);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), 0);
+
+    if (row > sheet->maxrow || col > sheet->maxcol)
+	return (FALSE);
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("gtk_sheet_set_active_cell: row %d col %d", row, col);
+#endif
+
+    if (!gtk_widget_get_can_focus(GTK_WIDGET(sheet)))
+    {
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+	g_debug("gtk_sheet_set_active_cell: row %d col %d abort: sheet, can-focus false", row, col);
+#endif
+	return (FALSE);
+    }
+
+    if (col >= 0 && !GTK_SHEET_COLUMN_CAN_FOCUS(COLPTR(sheet, col)))
+    {
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+	g_debug("gtk_sheet_set_active_cell: row %d col %d abort: sheet column, can-focus false", row, col);
+#endif
+	return (FALSE);
+    }
+
+    if (col >= 0 && !GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
+    {
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+	g_debug("gtk_sheet_set_active_cell: row %d col %d abort: sheet column, visible false", row, col);
+#endif
+	return (FALSE);
+    }
+
+    if (gtk_widget_get_realized(GTK_WIDGET(sheet)))
+    {
+#if 0
+	gint old_row = sheet->active_cell.row;
+	gint old_col = sheet->active_cell.col;
+#endif
+
+	if (!gtk_sheet_deactivate_cell(sheet))
+	{
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+	    g_debug("gtk_sheet_set_active_cell: abort: deactivation false");
+#endif
+	    return (FALSE);
+	}
+
+	/* the deactivate signal handler may have activated another cell here */
+#if 0
+	if ((sheet->active_cell.row != old_row) || (sheet->active_cell.col != old_col))
+	{
+#ifdef GTK_SHEET_DEBUG
+	    g_debug("gtk_sheet_set_active_cell: deactivation moved active cell to row %d col %d",
+		    sheet->active_cell.row, sheet->active_cell.col);
+#endif
+	    return(FALSE);
+	}
+#endif
+    }
+
+    if (row < 0 || col < 0)
+    {
+	sheet->range.row0 = -1;
+	sheet->range.rowi = -1;
+	sheet->range.col0 = -1;
+	sheet->range.coli = -1;
+
+	return (TRUE);
+    }
+
+    sheet->active_cell.row = row;
+    sheet->active_cell.col = col;
+
+    if (!gtk_sheet_activate_cell(sheet, row, col))
+	return (FALSE);
+
+    _gtk_sheet_move_query(sheet, row, col, TRUE);
+
+    return (TRUE);
+}
+
+/**
+ * gtk_sheet_get_active_cell:
+ * @sheet: a #GtkSheet
+ * @row: row number
+ * @column: column number
+ *
+ * Store the coordinates of the active cell in row,col. 
+ * If (row<0 || col<0) then there was no active cell in the 
+ * sheet. 
+ */
+void
+gtk_sheet_get_active_cell(GtkSheet *sheet, gint *row, gint *column)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+
+    *row = sheet->active_cell.row;
+    *column = sheet->active_cell.col;
+}
+
+/**
+ * gtk_sheet_set_tab_direction:
+ * @sheet: a #GtkSheet
+ * @dir: the primary tab direction
+ *
+ * Sets a primary movement direction to the Tab, Return and 
+ * Enter keys, and assigns the opposite direction to the same 
+ * keys with GDK_SHIFT_MASK. 
+ *  
+ * Transposed movement direction can be accessed with 
+ * GTK_SHEET_MOD_MASK|GDK_CONTROL_MASK and 
+ * GTK_SHEET_MOD_MASK|GDK_CONTROL_MASK|GDK_SHIFT_MASK. 
+ *  
+ * All bindings are defined for the #GtkSheetClass, so all sheet
+ * instances use the same movement directions. 
+ *  
+ * Default: GTK_DIR_TAB_FORWARD.
+ *  
+ * Since: 3.0.2 
+ */
+void
+gtk_sheet_set_tab_direction(GtkSheet *sheet, GtkDirectionType dir)
+{
+    GtkSheetClass *klass;
+
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+
+    klass = GTK_SHEET_GET_CLASS(sheet);
+
+    _gtk_sheet_class_init_tab_bindings(klass, dir);
+}
+
+
+
+/*
+ * gtk_sheet_entry_changed_handler:
+ * 
+ * this is the sheet_entry editable "changed" signal handler 
+ *  
+ * The signal is emited when typing into the entry, or changing 
+ * its content. 
+ *  
+ * Its main purpose is to update the cell data text 
+ * 
+ * @param widget the sheet_entry widget
+ * @param data the #GtkSheet, passed on signal creation
+ */
+static void
+gtk_sheet_entry_changed_handler(GtkWidget *widget, gpointer data)
+{
+    GtkSheet *sheet;
+    gint row, col;
+    char *text;
+
+    g_return_if_fail(data != NULL);
+    g_return_if_fail(GTK_IS_SHEET(data));
+
+    sheet = GTK_SHEET(data);
+
+    if (!gtk_widget_get_visible(gtk_sheet_get_entry_widget(sheet)))
+	return;
+    if (sheet->state != GTK_STATE_NORMAL)
+	return;
+
+    row = sheet->active_cell.row;
+    col = sheet->active_cell.col;
+
+    if (row < 0 || col < 0)
+	return;
+
+    sheet->active_cell.row = -1;
+    sheet->active_cell.col = -1;
+
+    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IS_FROZEN);
+
+    text = gtk_sheet_get_entry_text(sheet);
+    gtk_sheet_set_cell_text(sheet, row, col, text);
+    g_free(text);
+
+    if (sheet->freeze_count == 0)
+	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IS_FROZEN);
+
+    sheet->active_cell.row = row;;
+    sheet->active_cell.col = col;
+}
+
+
+static gboolean
+gtk_sheet_deactivate_cell(GtkSheet *sheet)
+{
+    gboolean veto = TRUE;
+    gint row, col;
+
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+
+    row = sheet->active_cell.row;
+    col = sheet->active_cell.col;
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("gtk_sheet_deactivate_cell: called, row %d col %d", row, col);
+#endif
+
+    if (row < 0 || row > sheet->maxrow)
+	return (TRUE);
+    if (col < 0 || col > sheet->maxcol)
+	return (TRUE);
+
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return (FALSE);
+    if (sheet->state != GTK_SHEET_NORMAL)
+	return (FALSE);
+
+    gtk_sheet_entry_signal_disconnect_by_func(sheet,
+	G_CALLBACK(gtk_sheet_entry_changed_handler));
+
+    _gtk_sheet_hide_active_cell(sheet);
+
+    sheet->active_cell.row = -1;  /* reset before signal emission, to prevent recursion */
+    sheet->active_cell.col = -1;
+
+    /* beware: DEACTIVATE handler may call gtk_sheet_set_active_cell()
+       */
+
+    _gtksheet_signal_emit(GTK_OBJECT(sheet), sheet_signals[DEACTIVATE],
+	row, col, &veto);
+
+    if (!veto)
+    {
+	sheet->active_cell.row = row;
+	sheet->active_cell.col = col;
+
+	return (FALSE);
+    }
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("gtk_sheet_deactivate_cell: running");
+#endif
+
+
+    if (GTK_SHEET_REDRAW_PENDING(sheet))
+    {
+	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_REDRAW_PENDING);
+	_gtk_sheet_range_draw(sheet, NULL, TRUE);
+    }
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("gtk_sheet_deactivate_cell: done row %d col %d", row, col);
+#endif
+
+    return (TRUE);
+}
+
+/**
+ * _gtk_sheet_hide_active_cell:
+ * 
+ * @param sheet  the #GtkSheet 
+ *  
+ * hide active cell
+ */
+void
+_gtk_sheet_hide_active_cell(GtkSheet *sheet)
+{
+    gint row, col;
+
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+    if (!gtk_widget_get_visible(sheet->sheet_entry))
+	return;
+
+    row = sheet->active_cell.row;
+    col = sheet->active_cell.col;
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("_gtk_sheet_hide_active_cell: called row %d col %d", row, col);
+#endif
+
+    if (row < 0 || row > sheet->maxrow)
+	return;
+    if (col < 0 || col > sheet->maxcol)
+	return;
+
+    if (sheet->freeze_count == 0)
+	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IS_FROZEN);
+
+#if 0
+    /* transferring entry text to the cell gives problems when gtk_sheet_change_entry()
+       is called during TRAVERSE signal emission. The text of the already changed
+       entry gets written into the deactivated cell */
+    {
+	char *text = gtk_sheet_get_entry_text(sheet);
+
+	/* todo: compare with existing text, only notify if text changes */
+	gtk_sheet_set_cell_text(sheet, row, col, text);
+
+	g_free(text);
+    }
+#endif
+
+#if 0
+    /* why shoud we first set the cursor to the cell we want hide ? */
+    g_signal_emit(GTK_OBJECT(sheet),sheet_signals[SET_CELL], 0, row, col);
+#endif
+
+    if (!GTK_SHEET_IS_FROZEN(sheet))
+    {
+	GtkSheetRange range;
+
+	range.row0 = range.rowi = row;
+	range.col0 = range.coli = col;
+
+	_gtk_sheet_range_draw(sheet, &range, FALSE);  /* do not reactivate active cell!!! */
+    }
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("_gtk_sheet_hide_active_cell: _gtk_sheet_column_button_release");
+#endif
+    _gtk_sheet_column_button_release(sheet, col);
+    row_button_release(sheet, row);
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("_gtk_sheet_hide_active_cell: gtk_widget_unmap");
+#endif
+    gtk_widget_unmap(sheet->sheet_entry);
+
+    gdk_draw_pixmap(sheet->sheet_window,
+	gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+	sheet->pixmap,
+	_gtk_sheet_column_left_xpixel(sheet, col) - 1,
+	_gtk_sheet_row_top_ypixel(sheet, row) - 1,
+	_gtk_sheet_column_left_xpixel(sheet, col) - 1,
+	_gtk_sheet_row_top_ypixel(sheet, row) - 1,
+	COLPTR(sheet, col)->width + 4,
+	ROW_HEIGHT(sheet, row) + 4);
+
+#if 0
+    /* why shoud we first set the cursor to the cell we want hide ? */
+    gtk_widget_grab_focus(GTK_WIDGET(sheet));
+#endif
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("_gtk_sheet_hide_active_cell: gtk_widget_set_visible");
+#endif
+
+    gtk_widget_set_visible(GTK_WIDGET(sheet->sheet_entry), FALSE);
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("_gtk_sheet_hide_active_cell: done");
+#endif
+}
+
+static gboolean
+gtk_sheet_activate_cell(GtkSheet *sheet, gint row, gint col)
+{
+    gboolean veto = TRUE;
+
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+
+    if (GTK_SHEET_FLAGS(sheet) & GTK_SHEET_IS_DESTROYED) return(FALSE); /* PR#102114 */
+
+    if (row < 0 || col < 0)
+	return (FALSE);
+    if (row > sheet->maxrow || col > sheet->maxcol)
+	return (FALSE);
+
+    if (!gtk_widget_get_can_focus(GTK_WIDGET(sheet)))
+    {
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+	g_debug("gtk_sheet_activate_cell: row %d col %d abort: sheet, can-focus false", row, col);
+#endif
+	return (FALSE);
+    }
+
+    if (!GTK_SHEET_COLUMN_CAN_FOCUS(COLPTR(sheet, col)))
+    {
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+	g_debug("gtk_sheet_activate_cell: row %d col %d abort: sheet column, can-focus false", row, col);
+#endif
+	return (FALSE);
+    }
+
+/* 
+   _gtksheet_signal_emit(GTK_OBJECT(sheet),sheet_signals[ACTIVATE], row, col, &veto);
+    if(!gtk_widget_get_realized(GTK_WIDGET(sheet))) return veto;
+    if (!veto) return FALSE;
+*/
+
+    if (sheet->state != GTK_SHEET_NORMAL)
+    {
+	sheet->state = GTK_SHEET_NORMAL;
+	gtk_sheet_real_unselect_range(sheet, NULL);
+    }
+
+    sheet->range.row0 = row;
+    sheet->range.col0 = col;
+    sheet->range.rowi = row;
+    sheet->range.coli = col;
+
+    sheet->active_cell.row = row;
+    sheet->active_cell.col = col;
+
+    sheet->selection_cell.row = row;
+    sheet->selection_cell.col = col;
+
+    row_button_set(sheet, row);
+    _gtk_sheet_column_button_set(sheet, col);
+
+    GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+    gtk_sheet_show_active_cell(sheet);
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("gtk_sheet_activate_cell: signal setup");
+#endif
+
+    gtk_sheet_entry_signal_connect_changed(sheet,
+	G_CALLBACK(gtk_sheet_entry_changed_handler));
+
+    _gtksheet_signal_emit(GTK_OBJECT(sheet), sheet_signals[ACTIVATE], row, col, &veto);
+
+    return (TRUE);
+}
+
+static void _gtk_sheet_entry_preselect(GtkSheet *sheet)
+{
+    gboolean select_on_focus;
+    gboolean editable = TRUE;  /* incomplete - refer to gtkitementry::gtk_entry_grab_focus() */
+    gboolean in_click = FALSE;  /* incomplete - refer to gtkitementry::gtk_entry_grab_focus() */
+
+#if GTK_SHEET_DEBUG_MOVE > 0
+    g_debug("_gtk_sheet_entry_preselect: called");
+#endif
+
+    g_object_get(G_OBJECT(gtk_settings_get_default()),
+	"gtk-entry-select-on-focus",
+	&select_on_focus,
+	NULL);
+
+    if (select_on_focus && editable && !in_click)
+    {
+	gtk_sheet_entry_select_region(sheet, 0, -1);
+    }
+}
+
+/**
+ * _gtk_sheet_entry_setup: 
+ * @sheet:  the #GtkSheet
+ * @row:    row index
+ * @col:    column index
+ * @entry_widget: entry widget 
+ * 
+ * configure sheet_entry for use within the active cell
+ * - justification 
+ * - editable
+ * - max_length 
+ * - wrap_mode 
+ * - color attributes
+ * - font
+ *  
+ * this function must not dependant on any text contents.
+ */
+static void _gtk_sheet_entry_setup(GtkSheet *sheet, gint row, gint col,
+    GtkWidget *entry_widget)
+{
+    GtkJustification justification = GTK_JUSTIFY_LEFT;
+    gboolean editable;
+    GtkStyle *style;
+    GtkSheetColumn *colptr = COLPTR(sheet, col);
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("_gtk_sheet_entry_setup: row %d col %d", row, col);
+#endif
+
+    if (row < 0 || col < 0)
+	return;
+
+    GtkSheetCellAttr attributes;
+    gtk_sheet_get_attributes(sheet, row, col, &attributes);
+
+    if (gtk_sheet_justify_entry(sheet))
+	justification = attributes.justification;
+
+    editable = !(gtk_sheet_locked(sheet)
+	|| !attributes.is_editable
+	|| colptr->is_readonly 
+        || GTK_SHEET_ROW_IS_READONLY(sheet, row));
+
+    gtk_sheet_set_entry_editable(sheet, editable);
+
+    if (GTK_IS_ITEM_ENTRY(entry_widget))
+    {
+	GtkItemEntry *item_entry = GTK_ITEM_ENTRY(entry_widget);
+	GtkEntry *entry = GTK_ENTRY(entry_widget);
+
+	/* 5.8.2010/fp - the code below has no effect in GTK 2.18.9,
+	   a right justified editable will pop to left justification
+	   as soon as something gets selected, and will
+	   pop back to right aligment, as soon as the
+	   cursor ist moved. When this happens, the
+	   justification value in the editable is correct. */
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+	g_debug("_gtk_sheet_entry_setup: GtkItemEntry justification %d", justification);
+#endif
+	gtk_item_entry_set_justification(item_entry, justification);
+	gtk_item_entry_set_max_length_bytes(item_entry, colptr->max_length_bytes);
+
+	gtk_entry_set_max_length(entry, colptr->max_length);
+    }
+    else if (GTK_IS_DATA_TEXT_VIEW(entry_widget))
+    {
+	GtkDataTextView *data_textview = GTK_DATA_TEXT_VIEW(entry_widget);
+	GtkTextView *textview = GTK_TEXT_VIEW(entry_widget);
+
+	gtk_text_view_set_wrap_mode(textview, colptr->wrap_mode);
+	gtk_data_text_view_set_max_length(data_textview, colptr->max_length);
+	gtk_data_text_view_set_max_length_bytes(data_textview, colptr->max_length_bytes);
+    }
+    else if (GTK_IS_TEXT_VIEW(entry_widget))
+    {
+	GtkTextView *textview = GTK_TEXT_VIEW(entry_widget);
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+	g_debug("_gtk_sheet_entry_setup: GtkTextView justification %d", justification);
+#endif
+	gtk_text_view_set_justification(textview, justification);
+	gtk_text_view_set_wrap_mode(textview, colptr->wrap_mode);
+    }
+    else if (GTK_IS_ENTRY(entry_widget))
+    {
+	GtkEntry *entry = GTK_ENTRY(entry_widget);
+	gtk_entry_set_max_length(entry, colptr->max_length);
+    }
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("_gtk_sheet_entry_setup: style bg color %s",
+	gdk_color_to_string(&attributes.background));
+#endif
+
+#if 1
+    if (gtk_widget_get_realized(entry_widget))
+    {
+	style = gtk_widget_get_style(entry_widget);
+	if (!style)
+	    gtk_widget_ensure_style(entry_widget);  /* why this ?? */
+	style = gtk_widget_get_style(entry_widget);
+
+	style = gtk_style_copy(style);
+
+	style->bg[GTK_STATE_NORMAL] = attributes.background;
+	style->base[GTK_STATE_NORMAL] = attributes.background;
+	style->fg[GTK_STATE_NORMAL] = attributes.foreground;
+	style->text[GTK_STATE_NORMAL] = attributes.foreground;
+
+	style->bg[GTK_STATE_ACTIVE] = attributes.background;
+	style->base[GTK_STATE_ACTIVE] = attributes.background;
+	style->fg[GTK_STATE_ACTIVE] = attributes.foreground;
+	style->text[GTK_STATE_ACTIVE] = attributes.foreground;
+
+	pango_font_description_free(style->font_desc);
+	style->font_desc = pango_font_description_copy(attributes.font_desc);
+
+	gtk_widget_set_style(entry_widget, style);
+
+	g_object_unref(style); /* 22.06.13/fp */
+    }
+#endif
+}
+
+static void
+gtk_sheet_show_active_cell(GtkSheet *sheet)
+{
+    gchar *text = NULL;
+    gchar *old_text;
+    gint row, col;
+    gboolean is_visible = TRUE;
+
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+
+    row = sheet->active_cell.row;
+    col = sheet->active_cell.col;
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug(
+        "gtk_sheet_show_active_cell: called row %d col %d insel %d", 
+        row, col, GTK_SHEET_IN_SELECTION(sheet));
+#endif
+
+    if (row < 0 || col < 0)
+	return;
+    if (row > sheet->maxrow || col > sheet->maxcol)
+	return;
+
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+    if (sheet->state != GTK_SHEET_NORMAL)
+	return;
+    if (GTK_SHEET_IN_SELECTION(sheet))
+	return;
+    if (!sheet->sheet_entry)   /* PR#102114 */
+	return;
+
+    /* we should send a ENTRY_CHANGE_REQUEST signal here */
+
+    {
+	GtkSheetCellAttr attributes;
+
+	text = g_strdup(gtk_sheet_cell_get_text(sheet, row, col));  /* model aware */
+
+	gtk_sheet_get_attributes(sheet, row, col, &attributes);  /* layered */
+	is_visible = attributes.is_visible;
+    }
+
+    GtkWidget *entry_widget = gtk_sheet_get_entry(sheet);
+
+    /* update visibility */
+
+    gtk_widget_set_visible(GTK_WIDGET(sheet->sheet_entry), is_visible);
+
+    if (GTK_IS_ENTRY(entry_widget))
+    {
+	gtk_entry_set_visibility(GTK_ENTRY(entry_widget), is_visible);
+    }
+
+    /* update text  */
+
+    if (!text)
+	text = g_strdup("");
+
+    old_text = gtk_sheet_get_entry_text(sheet);
+
+    /* the entry setup must be done before the text assigment,
+       otherwise max_length may cause text assignment to fail
+       */
+    _gtk_sheet_entry_setup(sheet, row, col, entry_widget);
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("gtk_sheet_show_active_cell: old_text <%s> text <%s>", old_text, text);
+#endif
+
+    if (!old_text || (old_text[0] != text[0]) || strcmp(old_text, text) != 0)
+    {
+	gtk_sheet_set_entry_text(sheet, text);
+    }
+
+    /* we should send an ENTRY_CONFIGURATION signal here */
+
+    gtk_sheet_entry_set_max_size(sheet);
+    _gtk_sheet_entry_size_allocate(sheet);
+
+    gtk_widget_map(sheet->sheet_entry);
+    gtk_sheet_draw_active_cell(sheet);
+
+    _gtk_sheet_entry_preselect(sheet);
+
+    gtk_widget_grab_focus(entry_widget);
+
+    g_free(text);
+    g_free(old_text);
+}
+
+static void
+gtk_sheet_draw_active_cell(GtkSheet *sheet)
+{
+    gint row, col;
+
+    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
+	return;
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+
+    row = sheet->active_cell.row;
+    col = sheet->active_cell.col;
+
+    if (row < 0 || row > sheet->maxrow)
+	return;
+    if (col < 0 || col > sheet->maxcol)
+	return;
+
+    if (!gtk_sheet_cell_isvisible(sheet, row, col))
+	return;
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("gtk_sheet_draw_active_cell: row %d col %d", row, col);
+#endif
+
+    row_button_set(sheet, row);
+    _gtk_sheet_column_button_set(sheet, col);
+
+    gtk_sheet_draw_backing_pixmap(sheet, sheet->range);
+    gtk_sheet_draw_border(sheet, sheet->range);
+}
+
+
+static void
+gtk_sheet_make_backing_pixmap(GtkSheet *sheet, guint width, guint height)
+{
+    gint pixmap_width, pixmap_height;
+
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+
+    if (width == 0 && height == 0)
+    {
+	width = sheet->sheet_window_width + 80;
+	height = sheet->sheet_window_height + 80;
+    }
+
+    if (!sheet->pixmap)
+    {
+	/* allocate */
+	sheet->pixmap = gdk_pixmap_new(sheet->sheet_window,
+	    width, height,
+	    -1);
+	if (!GTK_SHEET_IS_FROZEN(sheet))
+	    _gtk_sheet_range_draw(sheet, NULL, TRUE);
+    }
+    else
+    {
+	/* reallocate if sizes don't match */
+	gdk_window_get_size(sheet->pixmap, &pixmap_width, &pixmap_height);
+
+	if ((pixmap_width != width) || (pixmap_height != height))
+	{
+	    g_object_unref(G_OBJECT(sheet->pixmap));
+	    sheet->pixmap = gdk_pixmap_new(sheet->sheet_window,
+		width, height,
+		-1);
+	    if (!GTK_SHEET_IS_FROZEN(sheet))
+		_gtk_sheet_range_draw(sheet, NULL, TRUE);
+	}
+    }
+}
+
+static void
+gtk_sheet_new_selection(GtkSheet *sheet, GtkSheetRange *range)
+{
+    gint i, j, mask1, mask2;
+    gint state, selected;
+    gint x, y, width, height;
+    GtkSheetRange new_range, aux_range;
+
+    g_return_if_fail(sheet != NULL);
+
+    if (range == NULL)
+	range = &sheet->range;
+
+    new_range = *range;
+
+    range->row0 = MIN(range->row0, sheet->range.row0);
+    range->rowi = MAX(range->rowi, sheet->range.rowi);
+    range->col0 = MIN(range->col0, sheet->range.col0);
+    range->coli = MAX(range->coli, sheet->range.coli);
+
+    range->row0 = MAX(range->row0, MIN_VIEW_ROW(sheet));
+    range->rowi = MIN(range->rowi, MAX_VIEW_ROW(sheet));
+    range->col0 = MAX(range->col0, MIN_VIEW_COLUMN(sheet));
+    range->coli = MIN(range->coli, MAX_VIEW_COLUMN(sheet));
+
+    aux_range.row0 = MAX(new_range.row0, MIN_VIEW_ROW(sheet));
+    aux_range.rowi = MIN(new_range.rowi, MAX_VIEW_ROW(sheet));
+    aux_range.col0 = MAX(new_range.col0, MIN_VIEW_COLUMN(sheet));
+    aux_range.coli = MIN(new_range.coli, MAX_VIEW_COLUMN(sheet));
+
+    for (i = range->row0; i <= range->rowi; i++)
+    {
+	if (i > sheet->maxrow)
+	    break;
+
+	for (j = range->col0; j <= range->coli; j++)
+	{
+	    if (j > sheet->maxcol)
+		break;
+
+	    state = gtk_sheet_cell_get_state(sheet, i, j);
+	    selected = (i <= new_range.rowi && i >= new_range.row0 &&
+		j <= new_range.coli && j >= new_range.col0) ? TRUE : FALSE;
+
+	    if (state == GTK_STATE_SELECTED && selected &&
+		GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, j)) && GTK_SHEET_ROW_IS_VISIBLE(sheet, i) &&
+		(i == sheet->range.row0 || i == sheet->range.rowi ||
+		    j == sheet->range.col0 || j == sheet->range.coli ||
+		    i == new_range.row0 || i == new_range.rowi ||
+		    j == new_range.col0 || j == new_range.coli))
+	    {
+
+		mask1 = i == sheet->range.row0 ? 1 : 0;
+		mask1 = i == sheet->range.rowi ? mask1 + 2 : mask1;
+		mask1 = j == sheet->range.col0 ? mask1 + 4 : mask1;
+		mask1 = j == sheet->range.coli ? mask1 + 8 : mask1;
+
+		mask2 = i == new_range.row0 ? 1 : 0;
+		mask2 = i == new_range.rowi ? mask2 + 2 : mask2;
+		mask2 = j == new_range.col0 ? mask2 + 4 : mask2;
+		mask2 = j == new_range.coli ? mask2 + 8 : mask2;
+
+		if (mask1 != mask2)
+		{
+		    x = _gtk_sheet_column_left_xpixel(sheet, j);
+		    y = _gtk_sheet_row_top_ypixel(sheet, i);
+		    width = _gtk_sheet_column_left_xpixel(sheet, j) - x + COLPTR(sheet, j)->width;
+		    height = _gtk_sheet_row_top_ypixel(sheet, i) - y + ROW_HEIGHT(sheet, i);
+
+		    if (i == sheet->range.row0)
+		    {
+			y = y - 3;
+			height = height + 3;
+		    }
+		    if (i == sheet->range.rowi)
+			height = height + 3;
+		    if (j == sheet->range.col0)
+		    {
+			x = x - 3;
+			width = width + 3;
+		    }
+		    if (j == sheet->range.coli)
+			width = width + 3;
+
+		    gdk_draw_pixmap(sheet->sheet_window,
+			gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+			sheet->pixmap,
+			x + 1,
+			y + 1,
+			x + 1,
+			y + 1,
+			width,
+			height);
+
+		    if (i != sheet->active_cell.row || j != sheet->active_cell.col)
+		    {
+			x = _gtk_sheet_column_left_xpixel(sheet, j);
+			y = _gtk_sheet_row_top_ypixel(sheet, i);
+			width = _gtk_sheet_column_left_xpixel(sheet, j) - x + COLPTR(sheet, j)->width;
+			height = _gtk_sheet_row_top_ypixel(sheet, i) - y + ROW_HEIGHT(sheet, i);
+
+			if (i == new_range.row0)
+			{
+			    y = y + 2;
+			    height = height - 2;
+			}
+			if (i == new_range.rowi)
+			    height = height - 3;
+			if (j == new_range.col0)
+			{
+			    x = x + 2;
+			    width = width - 2;
+			}
+			if (j == new_range.coli)
+			    width = width - 3;
+
+			gdk_draw_rectangle(sheet->sheet_window,
+			    sheet->xor_gc,
+			    TRUE,
+			    x + 1, y + 1,
+			    width, height);
+		    }
+		}
+	    }
+	}
+    }
+
+    for (i = range->row0; i <= range->rowi; i++)
+    {
+	for (j = range->col0; j <= range->coli; j++)
+	{
+	    state = gtk_sheet_cell_get_state(sheet, i, j);
+	    selected = (i <= new_range.rowi && i >= new_range.row0 &&
+		j <= new_range.coli && j >= new_range.col0) ? TRUE : FALSE;
+
+	    if (state == GTK_STATE_SELECTED && !selected &&
+		GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, j)) &&
+		GTK_SHEET_ROW_IS_VISIBLE(sheet, i))
+	    {
+		x = _gtk_sheet_column_left_xpixel(sheet, j);
+		y = _gtk_sheet_row_top_ypixel(sheet, i);
+		width = _gtk_sheet_column_left_xpixel(sheet, j) - x + COLPTR(sheet, j)->width;
+		height = _gtk_sheet_row_top_ypixel(sheet, i) - y + ROW_HEIGHT(sheet, i);
+
+		if (i == sheet->range.row0)
+		{
+		    y = y - 3;
+		    height = height + 3;
+		}
+		if (i == sheet->range.rowi)
+		    height = height + 3;
+		if (j == sheet->range.col0)
+		{
+		    x = x - 3;
+		    width = width + 3;
+		}
+		if (j == sheet->range.coli)
+		    width = width + 3;
+
+		gdk_draw_pixmap(sheet->sheet_window,
+		    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+		    sheet->pixmap,
+		    x + 1,
+		    y + 1,
+		    x + 1,
+		    y + 1,
+		    width,
+		    height);
+	    }
+	}
+    }
+
+    for (i = range->row0; i <= range->rowi; i++)
+    {
+	for (j = range->col0; j <= range->coli; j++)
+	{
+	    state = gtk_sheet_cell_get_state(sheet, i, j);
+	    selected = (i <= new_range.rowi && i >= new_range.row0 &&
+		j <= new_range.coli && j >= new_range.col0) ? TRUE : FALSE;
+
+	    if (state != GTK_STATE_SELECTED && selected &&
+		GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, j)) && GTK_SHEET_ROW_IS_VISIBLE(sheet, i) &&
+		(i != sheet->active_cell.row || j != sheet->active_cell.col))
+	    {
+		x = _gtk_sheet_column_left_xpixel(sheet, j);
+		y = _gtk_sheet_row_top_ypixel(sheet, i);
+		width = _gtk_sheet_column_left_xpixel(sheet, j) - x + COLPTR(sheet, j)->width;
+		height = _gtk_sheet_row_top_ypixel(sheet, i) - y + ROW_HEIGHT(sheet, i);
+
+		if (i == new_range.row0)
+		{
+		    y = y + 2;
+		    height = height - 2;
+		}
+		if (i == new_range.rowi)
+		    height = height - 3;
+		if (j == new_range.col0)
+		{
+		    x = x + 2;
+		    width = width - 2;
+		}
+		if (j == new_range.coli)
+		    width = width - 3;
+
+		gdk_draw_rectangle(sheet->sheet_window,
+		    sheet->xor_gc,
+		    TRUE,
+		    x + 1, y + 1,
+		    width, height);
+	    }
+	}
+    }
+
+    for (i = aux_range.row0; i <= aux_range.rowi; i++)
+    {
+	for (j = aux_range.col0; j <= aux_range.coli; j++)
+	{
+	    if (GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, j)) && GTK_SHEET_ROW_IS_VISIBLE(sheet, i))
+	    {
+		state = gtk_sheet_cell_get_state(sheet, i, j);
+
+		mask1 = i == sheet->range.row0 ? 1 : 0;
+		mask1 = i == sheet->range.rowi ? mask1 + 2 : mask1;
+		mask1 = j == sheet->range.col0 ? mask1 + 4 : mask1;
+		mask1 = j == sheet->range.coli ? mask1 + 8 : mask1;
+
+		mask2 = i == new_range.row0 ? 1 : 0;
+		mask2 = i == new_range.rowi ? mask2 + 2 : mask2;
+		mask2 = j == new_range.col0 ? mask2 + 4 : mask2;
+		mask2 = j == new_range.coli ? mask2 + 8 : mask2;
+		if (mask2 != mask1 || (mask2 == mask1 && state != GTK_STATE_SELECTED))
+		{
+		    x = _gtk_sheet_column_left_xpixel(sheet, j);
+		    y = _gtk_sheet_row_top_ypixel(sheet, i);
+		    width = COLPTR(sheet, j)->width;
+		    height = ROW_HEIGHT(sheet, i);
+		    if (mask2 & 1)
+			gdk_draw_rectangle(sheet->sheet_window,
+			    sheet->xor_gc,
+			    TRUE,
+			    x + 1, y - 1,
+			    width, 3);
+
+		    if (mask2 & 2)
+			gdk_draw_rectangle(sheet->sheet_window,
+			    sheet->xor_gc,
+			    TRUE,
+			    x + 1, y + height - 1,
+			    width, 3);
+
+		    if (mask2 & 4)
+			gdk_draw_rectangle(sheet->sheet_window,
+			    sheet->xor_gc,
+			    TRUE,
+			    x - 1, y + 1,
+			    3, height);
+
+		    if (mask2 & 8)
+			gdk_draw_rectangle(sheet->sheet_window,
+			    sheet->xor_gc,
+			    TRUE,
+			    x + width - 1, y + 1,
+			    3, height);
+		}
+	    }
+	}
+    }
+
+    *range = new_range;
+    gtk_sheet_draw_corners(sheet, new_range);
+}
+
+static void
+gtk_sheet_draw_border(GtkSheet *sheet, GtkSheetRange new_range)
+{
+    GdkRectangle clip_area, area;
+    gint i;
+
+    area.x = _gtk_sheet_column_left_xpixel(sheet, new_range.col0);
+    area.y = _gtk_sheet_row_top_ypixel(sheet, new_range.row0);
+    area.width = _gtk_sheet_column_right_xpixel(sheet, new_range.coli) - area.x;
+    area.height = _gtk_sheet_row_bottom_ypixel(sheet, new_range.rowi) - area.y;
+
+    clip_area.x = sheet->row_title_area.width;
+    clip_area.y = sheet->column_title_area.height;
+    clip_area.width = sheet->sheet_window_width;
+    clip_area.height = sheet->sheet_window_height;
+
+    if (!sheet->row_titles_visible)
+	clip_area.x = 0;
+    if (!sheet->column_titles_visible)
+	clip_area.y = 0;
+
+    if (area.x < 0)
+    {
+	area.width = area.width + area.x;
+	area.x = 0;
+    }
+    if (area.width > clip_area.width)
+	area.width = clip_area.width + 10;
+    if (area.y < 0)
+    {
+	area.height = area.height + area.y;
+	area.y = 0;
+    }
+    if (area.height > clip_area.height)
+	area.height = clip_area.height + 10;
+
+#if GTK_SHEET_DEBUG_CELL_ACTIVATION > 0
+    g_debug("gtk_sheet_draw_border: clip_area (%d, %d, %d, %d)",
+	clip_area.x, clip_area.y, clip_area.width, clip_area.height);
+#endif
+
+    clip_area.x--;
+    clip_area.y--;
+    clip_area.width += 3;
+    clip_area.height += 3;
+
+    gdk_gc_set_clip_rectangle(sheet->xor_gc, &clip_area);
+
+    for (i = -1; i <= 1; ++i)
+    {
+	gdk_draw_rectangle(sheet->sheet_window,
+	    sheet->xor_gc,
+	    FALSE,
+	    area.x + i, area.y + i,
+	    area.width - 2 * i, area.height - 2 * i);
+    }
+
+    gdk_gc_set_clip_rectangle(sheet->xor_gc, NULL);
+    gtk_sheet_draw_corners(sheet, new_range);
+}
+
+static void
+gtk_sheet_draw_corners(GtkSheet *sheet, GtkSheetRange range)
+{
+    gint x, y;
+    guint width = 1;
+
+    if (gtk_sheet_cell_isvisible(sheet, range.row0, range.col0))
+    {
+	x = _gtk_sheet_column_left_xpixel(sheet, range.col0);
+	y = _gtk_sheet_row_top_ypixel(sheet, range.row0);
+	gdk_draw_pixmap(sheet->sheet_window,
+	    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+	    sheet->pixmap,
+	    x - 1,
+	    y - 1,
+	    x - 1,
+	    y - 1,
+	    3,
+	    3);
+	gdk_draw_rectangle(sheet->sheet_window,
+	    sheet->xor_gc,
+	    TRUE,
+	    x - 1, y - 1,
+	    3, 3);
+    }
+
+    if (gtk_sheet_cell_isvisible(sheet, range.row0, range.coli) ||
+	sheet->state == GTK_SHEET_COLUMN_SELECTED)
+    {
+	x = _gtk_sheet_column_left_xpixel(sheet, range.coli) +
+	    COLPTR(sheet, range.coli)->width;
+	y = _gtk_sheet_row_top_ypixel(sheet, range.row0);
+	width = 1;
+	if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
+	{
+	    y = _gtk_sheet_row_top_ypixel(sheet, sheet->view.row0) + 3;
+	    width = 3;
+	}
+	gdk_draw_pixmap(sheet->sheet_window,
+	    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+	    sheet->pixmap,
+	    x - width,
+	    y - width,
+	    x - width,
+	    y - width,
+	    2 * width + 1,
+	    2 * width + 1);
+	gdk_draw_rectangle(sheet->sheet_window,
+	    sheet->xor_gc,
+	    TRUE,
+	    x - width + width / 2, y - width + width / 2,
+	    2 + width, 2 + width);
+    }
+
+    if (gtk_sheet_cell_isvisible(sheet, range.rowi, range.col0) ||
+	sheet->state == GTK_SHEET_ROW_SELECTED)
+    {
+	x = _gtk_sheet_column_left_xpixel(sheet, range.col0);
+	y = _gtk_sheet_row_top_ypixel(sheet, range.rowi) +
+	    ROW_HEIGHT(sheet, range.rowi);
+	width = 1;
+	if (sheet->state == GTK_SHEET_ROW_SELECTED)
+	{
+	    x = _gtk_sheet_column_left_xpixel(sheet, sheet->view.col0) + 3;
+	    width = 3;
+	}
+	gdk_draw_pixmap(sheet->sheet_window,
+	    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+	    sheet->pixmap,
+	    x - width,
+	    y - width,
+	    x - width,
+	    y - width,
+	    2 * width + 1,
+	    2 * width + 1);
+	gdk_draw_rectangle(sheet->sheet_window,
+	    sheet->xor_gc,
+	    TRUE,
+	    x - width + width / 2, y - width + width / 2,
+	    2 + width, 2 + width);
+    }
+
+    if (gtk_sheet_cell_isvisible(sheet, range.rowi, range.coli))
+    {
+	x = _gtk_sheet_column_left_xpixel(sheet, range.coli) +
+	    COLPTR(sheet, range.coli)->width;
+	y = _gtk_sheet_row_top_ypixel(sheet, range.rowi) +
+	    ROW_HEIGHT(sheet, range.rowi);
+	width = 1;
+	if (sheet->state == GTK_SHEET_RANGE_SELECTED)
+	    width = 3;
+	if (sheet->state == GTK_SHEET_NORMAL)
+	    width = 3;
+	gdk_draw_pixmap(sheet->sheet_window,
+	    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+	    sheet->pixmap,
+	    x - width,
+	    y - width,
+	    x - width,
+	    y - width,
+	    2 * width + 1,
+	    2 * width + 1);
+	gdk_draw_rectangle(sheet->sheet_window,
+	    sheet->xor_gc,
+	    TRUE,
+	    x - width + width / 2, y - width + width / 2,
+	    2 + width, 2 + width);
+
+    }
+
+}
+
+
+static void
+gtk_sheet_real_select_range(GtkSheet *sheet, GtkSheetRange *range)
+{
+    gint i;
+    gint state;
+
+    g_return_if_fail(sheet != NULL);
+
+    if (range == NULL)
+	range = &sheet->range;
+
+    if (range->row0 < 0 || range->rowi < 0)
+	return;
+    if (range->col0 < 0 || range->coli < 0)
+	return;
+
+#if GTK_SHEET_DEBUG_SELECTION > 0
+    g_debug("gtk_sheet_real_select_range: {%d, %d, %d, %d}",
+	range->row0, range->col0, range->rowi, range->coli);
+#endif
+
+    state = sheet->state;
+
+    if (state == GTK_SHEET_COLUMN_SELECTED || state == GTK_SHEET_RANGE_SELECTED)
+    {
+	for (i = sheet->range.col0; i < range->col0; i++) _gtk_sheet_column_button_release(sheet, i);
+
+	for (i = range->coli + 1; i <= sheet->range.coli; i++) _gtk_sheet_column_button_release(sheet, i);
+
+	for (i = range->col0; i <= range->coli; i++)
+	{
+	    _gtk_sheet_column_button_set(sheet, i);
+	}
+    }
+
+    if (state == GTK_SHEET_ROW_SELECTED || state == GTK_SHEET_RANGE_SELECTED)
+    {
+	for (i = sheet->range.row0; i < range->row0; i++) row_button_release(sheet, i);
+
+	for (i = range->rowi + 1; i <= sheet->range.rowi; i++) row_button_release(sheet, i);
+
+	for (i = range->row0; i <= range->rowi; i++)
+	{
+	    row_button_set(sheet, i);
+	}
+    }
+
+    if (range->coli != sheet->range.coli || range->col0 != sheet->range.col0 ||
+	range->rowi != sheet->range.rowi || range->row0 != sheet->range.row0)
+    {
+	gtk_sheet_new_selection(sheet, range);
+
+	sheet->range.col0 = range->col0;
+	sheet->range.coli = range->coli;
+	sheet->range.row0 = range->row0;
+	sheet->range.rowi = range->rowi;
+    }
+    else
+    {
+	gtk_sheet_draw_backing_pixmap(sheet, sheet->range);
+	gtk_sheet_range_draw_selection(sheet, sheet->range);
+    }
+
+    g_signal_emit(GTK_OBJECT(sheet), sheet_signals[SELECT_RANGE], 0, range);
+}
+
+/**
+ * gtk_sheet_select_range:
+ * @sheet: a #GtkSheet
+ * @range: a #GtkSheetRange
+ *
+ * Highlight the selected range and store bounds in sheet->range
+ */
+void
+gtk_sheet_select_range(GtkSheet *sheet, const GtkSheetRange *range)
+{
+    GtkSheetRange new_range;  /* buffer needed because gtk_sheet_real_unselect_range() will clear it */
+
+    g_return_if_fail(sheet != NULL);
+
+    if (!range)
+	range = &sheet->range;
+
+    new_range = *range;
+
+    if (new_range.row0 < 0 || new_range.rowi < 0)
+	return;
+    if (new_range.col0 < 0 || new_range.coli < 0)
+	return;
+
+    if (sheet->state != GTK_SHEET_NORMAL)
+    {
+	/* this will clear sheet->range */
+	gtk_sheet_real_unselect_range(sheet, NULL);
+    }
+    else
+    {
+	gboolean veto = TRUE;
+	veto = gtk_sheet_deactivate_cell(sheet);
+	if (!veto)
+	    return;
+    }
+
+    sheet->range.row0 = new_range.row0;
+    sheet->range.rowi = new_range.rowi;
+    sheet->range.col0 = new_range.col0;
+    sheet->range.coli = new_range.coli;
+
+    sheet->active_cell.row = new_range.row0;
+    sheet->active_cell.col = new_range.col0;
+
+    sheet->selection_cell.row = new_range.rowi;
+    sheet->selection_cell.col = new_range.coli;
+
+    sheet->state = GTK_SHEET_RANGE_SELECTED;
+    gtk_sheet_real_select_range(sheet, NULL);
+
+}
+/**
+ * gtk_sheet_unselect_range:
+ * @sheet: a #GtkSheet
+ *
+ * Unselect the current selected range and clears the bounds in sheet->range.
+ */
+void
+gtk_sheet_unselect_range(GtkSheet *sheet)
+{
+    gtk_sheet_real_unselect_range(sheet, NULL);
+    sheet->state = GTK_SHEET_NORMAL;
+    gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
+}
+
+
+static void
+gtk_sheet_real_unselect_range(GtkSheet *sheet, GtkSheetRange *range)
+{
+    gint i;
+
+    g_return_if_fail(sheet != NULL);
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+
+    if (!range)
+	range = &sheet->range;
+
+#if GTK_SHEET_DEBUG_SELECTION > 0
+    g_debug("gtk_sheet_real_unselect_range: called {%d, %d, %d, %d}",
+	range->row0, range->col0, range->rowi, range->coli);
+#endif
+
+    if (range->row0 < 0 || range->rowi < 0)
+	return;
+    if (range->col0 < 0 || range->coli < 0)
+	return;
+
+    if (gtk_sheet_range_isvisible(sheet, *range))
+    {
+#if GTK_SHEET_DEBUG_SELECTION > 0
+	g_debug("gtk_sheet_real_unselect_range: gtk_sheet_draw_backing_pixmap");
+#endif
+	gtk_sheet_draw_backing_pixmap(sheet, *range);
+    }
+
+    for (i = range->col0; i <= range->coli; i++)
+    {
+#if GTK_SHEET_DEBUG_SELECTION > 0
+	g_debug("gtk_sheet_real_unselect_range: _gtk_sheet_column_button_release(%d)", i);
+#endif
+	_gtk_sheet_column_button_release(sheet, i);
+    }
+
+    for (i = range->row0; i <= range->rowi; i++)
+    {
+#if GTK_SHEET_DEBUG_SELECTION > 0
+	g_debug("gtk_sheet_real_unselect_range: row_button_release(%d)", i);
+#endif
+	row_button_release(sheet, i);
+    }
+
+#if GTK_SHEET_DEBUG_SELECTION > 0
+    g_debug("gtk_sheet_real_unselect_range: gtk_sheet_position_children()");
+#endif
+    gtk_sheet_position_children(sheet);
+
+    /* reset range */
+    range->row0 = range->rowi = range->col0 = range->coli = -1;
+}
+
+
+/*
+ * gtk_sheet_expose_handler:
+ * 
+ * this is the #GtkSheet widget class "expose-event" signal handler
+ * 
+ * @param widget the #GtkSheet
+ * @param event  the GdkEventExpose which triggered this signal
+ * 
+ * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
+ */
+static gboolean
+gtk_sheet_expose_handler(GtkWidget *widget, GdkEventExpose *event)
+{
+    GtkSheet *sheet;
+    gint i;
+
+    g_return_val_if_fail(widget != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(widget), FALSE);
+    g_return_val_if_fail(event != NULL, FALSE);
+
+    sheet = GTK_SHEET(widget);
+
+    if (gtk_widget_is_drawable(widget))
+    {
+#if GTK_SHEET_DEBUG_EXPOSE > 0
+	g_debug("gtk_sheet_expose_handler: called");
+#endif
+
+	if (event->window == sheet->row_title_window && sheet->row_titles_visible)
+	{
+#if GTK_SHEET_DEBUG_EXPOSE > 0
+	    g_debug("gtk_sheet_expose_handler: row buttons");
+#endif
+	    /* only buttons within the exposed area, see scrolling */
+	    gint y = event->area.y + COLUMN_TITLES_HEIGHT(sheet);
+	    gint row0 = MAX(_gtk_sheet_row_from_ypixel(sheet, y), MIN_VIEW_ROW(sheet));
+	    gint rowi = MIN(_gtk_sheet_row_from_ypixel(sheet, y + event->area.height),
+		MAX_VIEW_ROW(sheet));
+
+	    for (i = row0; i <= rowi && i <= sheet->maxrow; i++)
+	    {
+		_gtk_sheet_draw_button(sheet, i, -1);
+	    }
+	}
+
+	if (event->window == sheet->column_title_window && sheet->column_titles_visible)
+	{
+#if GTK_SHEET_DEBUG_EXPOSE > 0
+	    g_debug("gtk_sheet_expose_handler: column buttons");
+#endif
+	    gint x = event->area.x + ROW_TITLES_WIDTH(sheet);
+	    gint col0 = MAX(_gtk_sheet_column_from_xpixel(sheet, x), MIN_VIEW_COLUMN(sheet));
+	    gint coli = MIN(_gtk_sheet_column_from_xpixel(sheet, x + event->area.width),
+		MAX_VIEW_COLUMN(sheet));
+
+	    for (i = col0; i <= coli && i <= sheet->maxcol; i++)
+	    {
+		_gtk_sheet_draw_button(sheet, -1, i);
+	    }
+	}
+
+	if (event->window == sheet->sheet_window)
+	{
+	    GtkSheetRange range;
+
+	    range.row0 = _gtk_sheet_row_from_ypixel(sheet, event->area.y);
+	    range.col0 = _gtk_sheet_column_from_xpixel(sheet, event->area.x);
+	    range.rowi = _gtk_sheet_row_from_ypixel(sheet, event->area.y + event->area.height);
+	    range.coli = _gtk_sheet_column_from_xpixel(sheet, event->area.x + event->area.width);
+
+#if GTK_SHEET_DEBUG_EXPOSE > 0
+	    g_debug("gtk_sheet_expose_handler: backing pixmap (%d,%d) (%d,%d)",
+		range.row0, range.col0, range.rowi, range.coli);
+#endif
+
+	    gtk_sheet_draw_backing_pixmap(sheet, range);
+
+	    if (sheet->state != GTK_SHEET_NORMAL)
+	    {
+		if (gtk_sheet_range_isvisible(sheet, sheet->range))
+		    gtk_sheet_draw_backing_pixmap(sheet, sheet->range);
+		if (GTK_SHEET_IN_RESIZE(sheet) || GTK_SHEET_IN_DRAG(sheet))
+		    gtk_sheet_draw_backing_pixmap(sheet, sheet->drag_range);
+
+		if (gtk_sheet_range_isvisible(sheet, sheet->range))
+		    gtk_sheet_range_draw_selection(sheet, sheet->range);
+		if (GTK_SHEET_IN_RESIZE(sheet) || GTK_SHEET_IN_DRAG(sheet))
+		    draw_xor_rectangle(sheet, sheet->drag_range);
+	    }
+
+	    if ((!GTK_SHEET_IN_XDRAG(sheet)) && 
+                (!GTK_SHEET_IN_YDRAG(sheet)))
+	    {
+		if (sheet->state == GTK_SHEET_NORMAL)
+		{
+#if GTK_SHEET_DEBUG_EXPOSE > 0
+                    g_debug(
+                        "gtk_sheet_expose_handler: draw_active_cell ar %d ac %d",
+                        sheet->active_cell.row,
+                        sheet->active_cell.col);
+#endif
+
+		    gtk_sheet_draw_active_cell(sheet);
+
+#if GTK_SHEET_DEBUG_EXPOSE > 0
+                    g_debug("gtk_sheet_expose_handler: insel %d",
+                            GTK_SHEET_IN_SELECTION(sheet));
+#endif
+		    if (!GTK_SHEET_IN_SELECTION(sheet)){
+                        gtk_widget_queue_draw(sheet->sheet_entry); 
+                    }
+		}
+	    }
+	}
+    }
+
+    if (sheet->state != GTK_SHEET_NORMAL && GTK_SHEET_IN_SELECTION(sheet))
+	gtk_widget_grab_focus(GTK_WIDGET(sheet));
+
+    (*GTK_WIDGET_CLASS(sheet_parent_class)->expose_event)(widget, event);
+
+    return (FALSE);
+}
+
+
+/*
+ * gtk_sheet_button_press_handler:
+ * 
+ * this is the #GtkSheet widget class "button-press-event" handler
+ * 
+ * @param widget the #GtkSheet
+ * @param event  the GdkEventButton which triggered this signal
+ * 
+ * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
+ */
+static gboolean
+gtk_sheet_button_press_handler(GtkWidget *widget, GdkEventButton *event)
+{
+    GtkSheet *sheet;
+    GdkModifierType mods;
+    gint x, y, row, column;
+    gboolean veto;
+
+    g_return_val_if_fail(widget != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(widget), FALSE);
+    g_return_val_if_fail(event != NULL, FALSE);
+/*
+    if(event->type != GDK_BUTTON_PRESS) return(TRUE);
+*/
+
+#if GTK_SHEET_DEBUG_MOUSE > 0
+    g_debug("gtk_sheet_button_press_handler: called");
+#endif
+
+    gdk_window_get_pointer(gtk_widget_get_window(widget),
+	NULL, NULL, &mods);
+
+    if (!(mods & GDK_BUTTON1_MASK))
+	return (TRUE);
+
+    sheet = GTK_SHEET(widget);
+
+    /* press on resize windows */
+    if (event->window == sheet->column_title_window && gtk_sheet_columns_resizable(sheet))
+    {
+	gtk_widget_get_pointer(widget, &sheet->x_drag, NULL);
+	if (POSSIBLE_XDRAG(sheet, sheet->x_drag, &sheet->drag_cell.col))
+	{
+	    guint req;
+	    if (event->type == GDK_2BUTTON_PRESS)
+	    {
+		_gtk_sheet_autoresize_column_internal(sheet, sheet->drag_cell.col);
+		GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_XDRAG);
+		return (TRUE);
+	    }
+	    _gtk_sheet_column_size_request(sheet, sheet->drag_cell.col, &req);
+	    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_XDRAG);
+	    gdk_pointer_grab(sheet->column_title_window, FALSE,
+		GDK_POINTER_MOTION_HINT_MASK |
+		    GDK_BUTTON1_MOTION_MASK |
+		    GDK_BUTTON_RELEASE_MASK,
+		NULL, NULL, event->time);
+
+	    draw_xor_vline(sheet);
+	    return (TRUE);
+	}
+    }
+
+    if (event->window == sheet->row_title_window && gtk_sheet_rows_resizable(sheet))
+    {
+	gtk_widget_get_pointer(widget, NULL, &sheet->y_drag);
+
+	if (POSSIBLE_YDRAG(sheet, sheet->y_drag, &sheet->drag_cell.row))
+	{
+	    guint req;
+	    gtk_sheet_row_size_request(sheet, sheet->drag_cell.row, &req);
+	    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_YDRAG);
+	    gdk_pointer_grab(sheet->row_title_window, FALSE,
+		GDK_POINTER_MOTION_HINT_MASK |
+		    GDK_BUTTON1_MOTION_MASK |
+		    GDK_BUTTON_RELEASE_MASK,
+		NULL, NULL, event->time);
+
+	    draw_xor_hline(sheet);
+	    return (TRUE);
+	}
+    }
+
+    /* the sheet itself does not handle other than single click events */
+    if (event->type != GDK_BUTTON_PRESS)
+	return (FALSE);
+
+    /* selections on the sheet */
+    if (event->window == sheet->sheet_window)
+    {
+#if GTK_SHEET_DEBUG_MOUSE > 0
+	g_debug("gtk_sheet_button_press_handler: on sheet");
+#endif
+
+	gtk_widget_get_pointer(widget, &x, &y);
+	gtk_sheet_get_pixel_info(sheet, NULL, x, y, &row, &column);
+	if (row < 0 && column < 0) return(FALSE);  /* chain up to global button press handler*/
+
+#if GTK_SHEET_DEBUG_MOUSE > 0
+	g_debug("gtk_sheet_button_press_handler: pointer grab (%d,%d) r %d c %d mr %d mc %d", 
+	    x, y, row, column, sheet->maxrow, sheet->maxcol
+	    );
+#endif
+	gdk_pointer_grab(sheet->sheet_window, FALSE,
+	    GDK_POINTER_MOTION_HINT_MASK |
+		GDK_BUTTON1_MOTION_MASK |
+		GDK_BUTTON_RELEASE_MASK,
+	    NULL, NULL, event->time);
+	gtk_grab_add(GTK_WIDGET(sheet));
+	sheet->timer = g_timeout_add_full(0, TIMEOUT_SCROLL, _gtk_sheet_scroll_to_pointer, sheet, NULL);
+#if GTK_SHEET_DEBUG_MOUSE > 0
+	g_debug("gtk_sheet_button_press_handler: grab focus");
+#endif
+	gtk_widget_grab_focus(GTK_WIDGET(sheet));
+
+	if (sheet->selection_mode != GTK_SELECTION_SINGLE &&
+	    gdk_cursor_get_cursor_type(sheet->cursor_drag) == GDK_SIZING &&
+	    !GTK_SHEET_IN_SELECTION(sheet) && !GTK_SHEET_IN_RESIZE(sheet))
+	{
+	    if (sheet->state == GTK_STATE_NORMAL)
+	    {
+		gint row = sheet->active_cell.row;  /* PR#203012 */
+		gint column = sheet->active_cell.col;  /* PR#203012 */
+
+		if (!gtk_sheet_deactivate_cell(sheet))
+		    return (FALSE);
+		sheet->active_cell.row = row;
+		sheet->active_cell.col = column;
+		sheet->drag_range = sheet->range;
+		sheet->state = GTK_SHEET_RANGE_SELECTED;
+		gtk_sheet_select_range(sheet, &sheet->drag_range);
+	    }
+	    sheet->x_drag = x;
+	    sheet->y_drag = y;
+	    if (row > sheet->range.rowi)
+		row--;
+	    if (column > sheet->range.coli)
+		column--;
+	    sheet->drag_cell.row = row;
+	    sheet->drag_cell.col = column;
+	    sheet->drag_range = sheet->range;
+	    draw_xor_rectangle(sheet, sheet->drag_range);
+	    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_RESIZE);
+	}
+	else if (gdk_cursor_get_cursor_type(sheet->cursor_drag) == GDK_TOP_LEFT_ARROW &&
+	    !GTK_SHEET_IN_SELECTION(sheet) && !GTK_SHEET_IN_DRAG(sheet))
+	{
+	    if (sheet->state == GTK_STATE_NORMAL)
+	    {
+		gint row = sheet->active_cell.row;  /* PR#203012 */
+		gint column = sheet->active_cell.col;  /* PR#203012 */
+
+		if (!gtk_sheet_deactivate_cell(sheet))
+		    return (FALSE);
+		sheet->active_cell.row = row;
+		sheet->active_cell.col = column;
+		sheet->drag_range = sheet->range;
+		sheet->state = GTK_SHEET_RANGE_SELECTED;
+		gtk_sheet_select_range(sheet, &sheet->drag_range);
+	    }
+	    sheet->x_drag = x;
+	    sheet->y_drag = y;
+	    if (row < sheet->range.row0)
+		row++;
+	    if (row > sheet->range.rowi)
+		row--;
+	    if (column < sheet->range.col0)
+		column++;
+	    if (column > sheet->range.coli)
+		column--;
+	    sheet->drag_cell.row = row;
+	    sheet->drag_cell.col = column;
+	    sheet->drag_range = sheet->range;
+#if GTK_SHEET_DEBUG_MOUSE > 0
+	    g_debug("gtk_sheet_button_press_handler: drag_range r %d c %d (%d,%d, %d, %d) mr %d mc %d", 
+		sheet->drag_cell.row, sheet->drag_cell.col, 
+		sheet->drag_range.row0, sheet->drag_range.rowi, 
+		sheet->drag_range.col0, sheet->drag_range.coli, 
+		sheet->maxrow, sheet->maxcol
+	    );
+#endif
+	    draw_xor_rectangle(sheet, sheet->drag_range);
+	    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_DRAG);
+	}
+	else
+	{
+#if GTK_SHEET_DEBUG_MOUSE > 0
+	    g_debug("gtk_sheet_button_press_handler: on click cell");
+#endif
+
+	    gtk_sheet_click_cell(sheet, row, column, &veto);
+	    if (veto)
+		GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+	}
+	return(TRUE);
+    }
+
+    if (event->window == sheet->column_title_window)
+    {
+	gtk_widget_get_pointer(widget, &x, &y);
+	column = _gtk_sheet_column_from_xpixel(sheet, x);
+	if (column < 0 || column > sheet->maxcol)
+	    return (FALSE);
+
+	if (GTK_SHEET_COLUMN_IS_SENSITIVE(COLPTR(sheet, column)))
+	{
+	    gtk_sheet_click_cell(sheet, -1, column, &veto);
+	    gtk_grab_add(GTK_WIDGET(sheet));
+	    sheet->timer = g_timeout_add_full(0, TIMEOUT_SCROLL, _gtk_sheet_scroll_to_pointer, sheet, NULL);
+	    gtk_widget_grab_focus(GTK_WIDGET(sheet));
+	    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+	}
+    }
+
+    if (event->window == sheet->row_title_window)
+    {
+	gtk_widget_get_pointer(widget, &x, &y);
+	row = _gtk_sheet_row_from_ypixel(sheet, y);
+	if (row < 0 || row > sheet->maxrow)
+	    return (FALSE);
+
+	if (GTK_SHEET_ROW_IS_SENSITIVE(sheet, row))
+	{
+	    gtk_sheet_click_cell(sheet, row, -1, &veto);
+	    gtk_grab_add(GTK_WIDGET(sheet));
+	    sheet->timer = g_timeout_add_full(0, TIMEOUT_SCROLL, _gtk_sheet_scroll_to_pointer, sheet, NULL);
+	    gtk_widget_grab_focus(GTK_WIDGET(sheet));
+	    GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+	}
+    }
+
+    return (TRUE);
+}
+
+static gint
+_gtk_sheet_scroll_to_pointer(gpointer data)
+{
+    GtkSheet *sheet = GTK_SHEET(data);
+    gint x, y, row, column;
+    gint move = TRUE;
+
+    GDK_THREADS_ENTER();
+
+    gtk_widget_get_pointer(GTK_WIDGET(sheet), &x, &y);
+    gtk_sheet_get_pixel_info(sheet, NULL, x, y, &row, &column);
+
+    if (GTK_SHEET_IN_SELECTION(sheet))
+    {
+	GtkSheetRange visr;
+
+	/* beware of invisible columns/rows */
+	if (!_gtk_sheet_get_visible_range(sheet, &visr))
+	    return (TRUE);
+
+	if (_POINT_IN_RANGE(row, column, &visr))
+	{
+	    gtk_sheet_extend_selection(sheet, row, column);
+	}
+    }
+
+    if (GTK_SHEET_IN_DRAG(sheet) || GTK_SHEET_IN_RESIZE(sheet))
+    {
+	move = _gtk_sheet_move_query(sheet, row, column, FALSE);
+	if (move)
+	    draw_xor_rectangle(sheet, sheet->drag_range);
+    }
+
+    GDK_THREADS_LEAVE();
+    return (TRUE);
+}
+
+static void
+gtk_sheet_click_cell(GtkSheet *sheet, gint row, gint col, gboolean *veto)
+{
+    *veto = TRUE;
+
+#if GTK_SHEET_DEBUG_CLICK > 0
+    g_debug("gtk_sheet_click_cell: called, row %d col %d", row, col);
+#endif
+
+    /* allow row,col < 0 here, see below */
+    if (row > sheet->maxrow || col > sheet->maxcol)
+    {
+	*veto = FALSE;
+	return;
+    }
+
+    if (col >= 0 && row >= 0)
+    {
+	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) ||
+	    !GTK_SHEET_ROW_IS_VISIBLE(sheet, row)    || 
+            !GTK_SHEET_CELL_IS_VISIBLE(sheet,row,col)        ||
+            !GTK_SHEET_COLUMN_IS_SENSITIVE(COLPTR(sheet,col))||
+            !GTK_SHEET_ROW_IS_SENSITIVE(sheet, row)   || 
+            !GTK_SHEET_CELL_IS_SENSITIVE(sheet,row,col)      ||
+            !GTK_SHEET_COLUMN_CAN_FOCUS(COLPTR(sheet,col))   ||
+            !GTK_SHEET_ROW_CAN_FOCUS(sheet, row)      ||
+            !GTK_SHEET_CELL_CAN_FOCUS(sheet,row,col)         )
+	{
+	    *veto = FALSE;
+	    return;
+	}
+    }
+
+
+    /* if we do not grab focus here, some entry widgets (i.e. GtkSpinButton)
+       will not format contents correctly on field exit */
+
+    gtk_widget_grab_focus(GTK_WIDGET(sheet));
+
+    _gtksheet_signal_emit(GTK_OBJECT(sheet), sheet_signals[TRAVERSE],
+	sheet->active_cell.row, sheet->active_cell.col,
+	&row, &col, veto);
+
+    if (!*veto)
+    {
+	if (sheet->state == GTK_STATE_NORMAL)
+	    return;
+
+	row = sheet->active_cell.row;
+	col = sheet->active_cell.col;
+	gtk_sheet_activate_cell(sheet, row, col);
+	return;
+    }
+
+    if (row == -1 && col >= 0)  /* column button clicked */
+    {
+	if (gtk_sheet_autoscroll(sheet))
+	    _gtk_sheet_move_query(sheet, row, col, FALSE);
+
+	gtk_sheet_select_column(sheet, col);
+	return;
+    }
+    if (col == -1 && row >= 0)  /* row button clicked */
+    {
+	if (gtk_sheet_autoscroll(sheet))
+	    _gtk_sheet_move_query(sheet, row, col, FALSE);
+
+	gtk_sheet_select_row(sheet, row);
+	return;
+    }
+
+    if (row == -1 && col == -1)  /* global button clicked */
+    {
+	sheet->range.row0 = 0;
+	sheet->range.col0 = 0;
+	sheet->range.rowi = sheet->maxrow;
+	sheet->range.coli = sheet->maxcol;
+
+	sheet->active_cell.row = 0;
+	sheet->active_cell.col = 0;
+
+	if (sheet->state != GTK_STATE_NORMAL)   /* if any range is selected, clear it */
+	    gtk_sheet_unselect_range(sheet);
+	else
+	    gtk_sheet_select_range(sheet, NULL);
+
+	return;
+    }
+
+    if (row != -1 && col != -1)  /* sheet cell clicked */
+    {
+	GtkSheetColumn *colp = COLPTR(sheet, col);
+
+	if (!gtk_widget_get_can_focus(GTK_WIDGET(sheet)))
+	{
+#if GTK_SHEET_DEBUG_CLICK > 0
+	    g_debug("gtk_sheet_click_cell: row %d col %d VETO: sheet, can-focus false", row, col);
+#endif
+	    *veto = FALSE;
+	    return;
+	}
+
+	if (!GTK_SHEET_COLUMN_CAN_FOCUS(colp))
+	{
+#if GTK_SHEET_DEBUG_CLICK > 0
+	    g_debug("gtk_sheet_click_cell: row %d col %d VETO: sheet column, can-focus false", row, col);
+#endif
+	    *veto = FALSE;
+	    return;
+	}
+
+	if (sheet->state != GTK_SHEET_NORMAL)
+	{
+	    sheet->state = GTK_SHEET_NORMAL;
+	    gtk_sheet_real_unselect_range(sheet, NULL);
+	}
+	else
+	{
+#if GTK_SHEET_DEBUG_CLICK > 0
+	    g_debug("gtk_sheet_click_cell: row %d col %d calling deactivate", row, col);
+#endif
+	    if (!gtk_sheet_deactivate_cell(sheet))
+	    {
+#if GTK_SHEET_DEBUG_CLICK > 0
+		g_debug("gtk_sheet_click_cell: row %d col %d VETO: deactivate false", row, col);
+#endif
+		*veto = FALSE;
+		return;
+	    }
+#if GTK_SHEET_DEBUG_CLICK > 0
+	    g_debug("gtk_sheet_click_cell: row %d col %d back from deactivate", row, col);
+#endif
+	}
+
+	/* auto switch column entry_type */
+	/* not sure wether to move this code to gtk_sheet_show_active_cell() */
+	{
+	    GType installed_entry_type = sheet->installed_entry_type;
+	    GType wanted_type =
+		(colp->entry_type != G_TYPE_NONE) ? colp->entry_type : sheet->entry_type;
+
+	    if (installed_entry_type != wanted_type)
+	    {
+		if (sheet->state == GTK_SHEET_NORMAL)
+		    _gtk_sheet_hide_active_cell(sheet);
+
+		create_sheet_entry(sheet, wanted_type ? wanted_type : G_TYPE_NONE);
+	    }
+	}
+
+	/* DEACTIVATE handler might have called gtk_sheet_set_active_cell(),
+	   so wie leave it, if it was changed
+	   */
+#if 0
+	{
+	    gint act_row = sheet->active_cell.row;
+	    gint act_col = sheet->active_cell.col;
+
+	    if (act_row != -1 && act_col != -1 &&
+		(sheet->active_cell.row != row || sheet->active_cell.col != col))
+	    {
+		row = sheet->active_cell.row;
+		col = sheet->active_cell.col;
+	    }
+	}
+#endif
+
+	if (gtk_sheet_autoscroll(sheet))
+	    _gtk_sheet_move_query(sheet, row, col, TRUE);
+
+	sheet->active_cell.row = row;
+	sheet->active_cell.col = col;
+
+	sheet->selection_cell.row = row;
+	sheet->selection_cell.col = col;
+
+	sheet->range.row0 = row;
+	sheet->range.col0 = col;
+	sheet->range.rowi = row;
+	sheet->range.coli = col;
+
+	sheet->state = GTK_SHEET_NORMAL;
+
+	GTK_SHEET_SET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+	gtk_sheet_draw_active_cell(sheet);
+	return;
+    }
+
+    g_assert_not_reached();
+    gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
+}
+
+/*
+ * gtk_sheet_button_release_handler:
+ * 
+ * this is the #GtkSheet widget class "button-release-event" handler
+ * 
+ * @param widget the #GtkSheet
+ * @param event  the GdkEventButton which triggered this signal
+ * 
+ * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
+ */
+static gboolean
+gtk_sheet_button_release_handler(GtkWidget *widget, GdkEventButton *event)
+{
+    GtkSheet *sheet;
+    gint x, y;
+
+    sheet = GTK_SHEET(widget);
+
+    /* release on resize windows */
+    if (GTK_SHEET_IN_XDRAG(sheet))
+    {
+	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_XDRAG);
+	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+	gtk_widget_get_pointer(widget, &x, NULL);
+	gdk_pointer_ungrab(event->time);
+	draw_xor_vline(sheet);
+
+#if GTK_SHEET_DEBUG_SIZE > 0
+	g_debug("gtk_sheet_button_release_handler[%d]: set width %d",
+	    sheet->drag_cell.col, new_column_width(sheet, sheet->drag_cell.col, &x));
+#endif
+	gtk_sheet_set_column_width(sheet,
+	    sheet->drag_cell.col, new_column_width(sheet, sheet->drag_cell.col, &x));
+
+	sheet->old_hadjustment = -1.;
+
+	if (sheet->hadjustment)
+	{
+	    g_signal_emit_by_name(GTK_OBJECT(sheet->hadjustment),  "value_changed");
+	}
+	return (TRUE);
+    }
+
+    if (GTK_SHEET_IN_YDRAG(sheet))
+    {
+	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_YDRAG);
+	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+	gtk_widget_get_pointer(widget, NULL, &y);
+	gdk_pointer_ungrab(event->time);
+	draw_xor_hline(sheet);
+
+	gtk_sheet_set_row_height(sheet, sheet->drag_cell.row,
+	    new_row_height(sheet, sheet->drag_cell.row, &y));
+
+	sheet->old_vadjustment = -1.;
+	if (sheet->vadjustment)
+	{
+	    g_signal_emit_by_name(GTK_OBJECT(sheet->vadjustment), "value_changed");
+	}
+	return (TRUE);
+    }
+
+
+    if (GTK_SHEET_IN_DRAG(sheet))
+    {
+	GtkSheetRange old_range;
+	draw_xor_rectangle(sheet, sheet->drag_range);
+	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_DRAG);
+	gdk_pointer_ungrab(event->time);
+
+	gtk_sheet_real_unselect_range(sheet, NULL);
+
+	sheet->active_cell.row = sheet->active_cell.row +
+	    (sheet->drag_range.row0 - sheet->range.row0);
+	sheet->active_cell.col = sheet->active_cell.col +
+	    (sheet->drag_range.col0 - sheet->range.col0);
+	sheet->selection_cell.row = sheet->selection_cell.row +
+	    (sheet->drag_range.row0 - sheet->range.row0);
+	sheet->selection_cell.col = sheet->selection_cell.col +
+	    (sheet->drag_range.col0 - sheet->range.col0);
+	old_range = sheet->range;
+	sheet->range = sheet->drag_range;
+	sheet->drag_range = old_range;
+	g_signal_emit(GTK_OBJECT(sheet), sheet_signals[MOVE_RANGE], 0,
+	    &sheet->drag_range, &sheet->range);
+	gtk_sheet_select_range(sheet, &sheet->range);
+    }
+
+    if (GTK_SHEET_IN_RESIZE(sheet))
+    {
+	GtkSheetRange old_range;
+	draw_xor_rectangle(sheet, sheet->drag_range);
+	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_RESIZE);
+	gdk_pointer_ungrab(event->time);
+
+	gtk_sheet_real_unselect_range(sheet, NULL);
+
+	sheet->active_cell.row = sheet->active_cell.row +
+	    (sheet->drag_range.row0 - sheet->range.row0);
+	sheet->active_cell.col = sheet->active_cell.col +
+	    (sheet->drag_range.col0 - sheet->range.col0);
+	if (sheet->drag_range.row0 < sheet->range.row0)
+	    sheet->selection_cell.row = sheet->drag_range.row0;
+	if (sheet->drag_range.rowi >= sheet->range.rowi)
+	    sheet->selection_cell.row = sheet->drag_range.rowi;
+	if (sheet->drag_range.col0 < sheet->range.col0)
+	    sheet->selection_cell.col = sheet->drag_range.col0;
+	if (sheet->drag_range.coli >= sheet->range.coli)
+	    sheet->selection_cell.col = sheet->drag_range.coli;
+	old_range = sheet->range;
+	sheet->range = sheet->drag_range;
+	sheet->drag_range = old_range;
+
+	if (sheet->state == GTK_STATE_NORMAL)
+	    sheet->state = GTK_SHEET_RANGE_SELECTED;
+	g_signal_emit(GTK_OBJECT(sheet), sheet_signals[RESIZE_RANGE], 0,
+	    &sheet->drag_range, &sheet->range);
+	gtk_sheet_select_range(sheet, &sheet->range);
+    }
+
+    if (sheet->state == GTK_SHEET_NORMAL && GTK_SHEET_IN_SELECTION(sheet))
+    {
+	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+	gdk_pointer_ungrab(event->time);
+	gtk_sheet_activate_cell(sheet, sheet->active_cell.row,
+	    sheet->active_cell.col);
+    }
+
+    if (GTK_SHEET_IN_SELECTION)
+	gdk_pointer_ungrab(event->time);
+    if (sheet->timer)
+	g_source_remove(sheet->timer);
+    gtk_grab_remove(GTK_WIDGET(sheet));
+
+    GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+
+    return (TRUE);
+}
+
+/*
+ * gtk_sheet_motion_handler:<p>
+ * this is the #GtkSheet widget class "motion-notify-event" signal handler
+ * 
+ * @param widget the #GtkSheet
+ * @param event  the GdkEventMotion which triggered this signal
+ * 
+ * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
+ */
+static gboolean
+gtk_sheet_motion_handler(GtkWidget *widget, GdkEventMotion *event)
+{
+    GtkSheet *sheet;
+    GdkModifierType mods;
+    GdkCursorType new_cursor;
+    gint x, y, row, column;
+
+    g_return_val_if_fail(widget != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(widget), FALSE);
+    g_return_val_if_fail(event != NULL, FALSE);
+
+
+    sheet = GTK_SHEET(widget);
+
+    /* selections on the sheet */
+    x = event->x;
+    y = event->y;
+
+#if GTK_SHEET_DEBUG_MOTION > 0
+    g_debug("gtk_sheet_motion_handler: (%d,%d) inSel %s", x, y,
+	GTK_SHEET_IN_SELECTION(sheet) ? "Yes" : "No" );
+#endif
+
+    if (event->window == sheet->column_title_window 
+	&& gtk_sheet_columns_resizable(sheet))
+    {
+	gtk_widget_get_pointer(widget, &x, &y);
+	if (!GTK_SHEET_IN_SELECTION(sheet) && POSSIBLE_XDRAG(sheet, x, &column))
+	{
+	    new_cursor = GDK_SB_H_DOUBLE_ARROW;
+	    if (new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
+	    {
+		gdk_cursor_destroy(sheet->cursor_drag);
+		sheet->cursor_drag = gdk_cursor_new(GDK_SB_H_DOUBLE_ARROW);
+		gdk_window_set_cursor(sheet->column_title_window, sheet->cursor_drag);
+	    }
+	}
+	else
+	{
+	    new_cursor = GDK_TOP_LEFT_ARROW;
+	    if (!GTK_SHEET_IN_XDRAG(sheet) && new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
+	    {
+		gdk_cursor_destroy(sheet->cursor_drag);
+		sheet->cursor_drag = gdk_cursor_new(GDK_TOP_LEFT_ARROW);
+		gdk_window_set_cursor(sheet->column_title_window, sheet->cursor_drag);
+	    }
+	}
+    }
+
+    if (event->window == sheet->row_title_window 
+	&& gtk_sheet_rows_resizable(sheet))
+    {
+	gtk_widget_get_pointer(widget, &x, &y);
+	if (!GTK_SHEET_IN_SELECTION(sheet) && POSSIBLE_YDRAG(sheet, y, &column))
+	{
+	    new_cursor = GDK_SB_V_DOUBLE_ARROW;
+	    if (new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
+	    {
+		gdk_cursor_destroy(sheet->cursor_drag);
+		sheet->cursor_drag = gdk_cursor_new(GDK_SB_V_DOUBLE_ARROW);
+		gdk_window_set_cursor(sheet->row_title_window, sheet->cursor_drag);
+	    }
+	}
+	else
+	{
+	    new_cursor = GDK_TOP_LEFT_ARROW;
+	    if (!GTK_SHEET_IN_YDRAG(sheet) && new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
+	    {
+		gdk_cursor_destroy(sheet->cursor_drag);
+		sheet->cursor_drag = gdk_cursor_new(GDK_TOP_LEFT_ARROW);
+		gdk_window_set_cursor(sheet->row_title_window, sheet->cursor_drag);
+	    }
+	}
+    }
+
+    new_cursor = GDK_PLUS;
+    if (!POSSIBLE_DRAG(sheet, x, y, &row, &column) && !GTK_SHEET_IN_DRAG(sheet) &&
+	!POSSIBLE_RESIZE(sheet, x, y, &row, &column) && !GTK_SHEET_IN_RESIZE(sheet) &&
+	event->window == sheet->sheet_window &&
+	new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
+    {
+	gdk_cursor_destroy(sheet->cursor_drag);
+	sheet->cursor_drag = gdk_cursor_new(GDK_PLUS);
+	gdk_window_set_cursor(sheet->sheet_window, sheet->cursor_drag);
+    }
+
+    new_cursor = GDK_TOP_LEFT_ARROW;
+    if (!(POSSIBLE_RESIZE(sheet, x, y, &row, &column) || GTK_SHEET_IN_RESIZE(sheet)) &&
+	(POSSIBLE_DRAG(sheet, x, y, &row, &column) || GTK_SHEET_IN_DRAG(sheet)) &&
+	event->window == sheet->sheet_window &&
+	new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
+    {
+	gdk_cursor_destroy(sheet->cursor_drag);
+	sheet->cursor_drag = gdk_cursor_new(GDK_TOP_LEFT_ARROW);
+	gdk_window_set_cursor(sheet->sheet_window, sheet->cursor_drag);
+    }
+
+    new_cursor = GDK_SIZING;
+    if (!GTK_SHEET_IN_DRAG(sheet) &&
+	(POSSIBLE_RESIZE(sheet, x, y, &row, &column) || GTK_SHEET_IN_RESIZE(sheet)) &&
+	event->window == sheet->sheet_window &&
+	new_cursor != gdk_cursor_get_cursor_type(sheet->cursor_drag))
+    {
+	gdk_cursor_destroy(sheet->cursor_drag);
+	sheet->cursor_drag = gdk_cursor_new(GDK_SIZING);
+	gdk_window_set_cursor(sheet->sheet_window, sheet->cursor_drag);
+    }
+
+    gdk_window_get_pointer(gtk_widget_get_window(widget), &x, &y, &mods);
+    if (!(mods & GDK_BUTTON1_MASK))
+	return (FALSE);
+
+    if (GTK_SHEET_IN_XDRAG(sheet))
+    {
+	if (event->is_hint ||
+	    event->window != gtk_widget_get_window(widget))
+	{
+	    gtk_widget_get_pointer(widget, &x, NULL);
+	}
+	else
+	    x = event->x;
+
+	new_column_width(sheet, sheet->drag_cell.col, &x);
+	if (x != sheet->x_drag)
+	{
+	    draw_xor_vline(sheet);
+	    sheet->x_drag = x;
+	    draw_xor_vline(sheet);
+	}
+	return (TRUE);
+    }
+
+    if (GTK_SHEET_IN_YDRAG(sheet))
+    {
+	if (event->is_hint ||
+	    event->window != gtk_widget_get_window(widget))
+	{
+	    gtk_widget_get_pointer(widget, NULL, &y);
+	}
+	else
+	    y = event->y;
+
+	new_row_height(sheet, sheet->drag_cell.row, &y);
+	if (y != sheet->y_drag)
+	{
+	    draw_xor_hline(sheet);
+	    sheet->y_drag = y;
+	    draw_xor_hline(sheet);
+	}
+	return (TRUE);
+    }
+
+    if (GTK_SHEET_IN_DRAG(sheet))
+    {
+	GtkSheetRange aux, visr;
+
+	gint current_row = MIN(sheet->maxrow, _gtk_sheet_row_from_ypixel(sheet, y));
+	gint current_col = MIN(sheet->maxcol, _gtk_sheet_column_from_xpixel(sheet, x));
+
+	row = current_row - sheet->drag_cell.row;
+	column = current_col - sheet->drag_cell.col;
+
+	if (sheet->state == GTK_SHEET_ROW_SELECTED)
+	    column = 0;
+	if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
+	    row = 0;
+	sheet->x_drag = x;
+	sheet->y_drag = y;
+	aux = sheet->range;
+
+	/* beware of invisible columns/rows */
+	if (!_gtk_sheet_get_visible_range(sheet, &visr))
+	    return (TRUE);
+
+	if (_RECT_IN_RANGE(aux.row0 + row, aux.rowi + row,
+		aux.col0 + column, aux.coli + column, &visr))
+	{
+	    aux = sheet->drag_range;
+
+#if 1
+	    /* The following code doesn't behave properly when there
+	       are invisible columns in the sheet. For a proper user experience
+	       it should
+	       1. _gtk_sheet_count_visible(drag_range)
+	       2. try to move the outer edge into the given direction
+	       3. find and add enough visible columns backwards
+	       Beware: above algo will modify width/height of the drag area
+	       */
+	    if (row > 0)
+	    {
+		gint nrow0 = _gtk_sheet_first_visible_rowidx(sheet, sheet->range.row0 + row);
+		gint nrowi = _gtk_sheet_first_visible_rowidx(sheet, sheet->range.rowi + row);
+		if (nrow0 >= 0 && nrowi >= 0)
+		{
+		    sheet->drag_range.row0 = nrow0;
+		    sheet->drag_range.rowi = nrowi;
+		}
+	    }
+	    else
+	    {
+		gint nrow0 = _gtk_sheet_last_visible_rowidx(sheet, sheet->range.row0 + row);
+		gint nrowi = _gtk_sheet_last_visible_rowidx(sheet, sheet->range.rowi + row);
+		if (nrow0 >= 0 && nrowi >= 0)
+		{
+		    sheet->drag_range.row0 = nrow0;
+		    sheet->drag_range.rowi = nrowi;
+		}
+	    }
+	    if (column > 0)
+	    {
+		gint ncol0 = _gtk_sheet_first_visible_colidx(sheet, sheet->range.col0 + column);
+		gint ncoli = _gtk_sheet_first_visible_colidx(sheet, sheet->range.coli + column);
+		if (ncol0 >= 0 && ncoli >= 0)
+		{
+		    sheet->drag_range.col0 = ncol0;
+		    sheet->drag_range.coli = ncoli;
+		}
+	    }
+	    else
+	    {
+		gint ncol0 = _gtk_sheet_last_visible_colidx(sheet, sheet->range.col0 + column);
+		gint ncoli = _gtk_sheet_last_visible_colidx(sheet, sheet->range.coli + column);
+		if (ncol0 >= 0 && ncoli >= 0)
+		{
+		    sheet->drag_range.col0 = ncol0;
+		    sheet->drag_range.coli = ncoli;
+		}
+	    }
+#endif
+
+	    if (aux.row0 != sheet->drag_range.row0 ||
+		aux.col0 != sheet->drag_range.col0)
+	    {
+		draw_xor_rectangle(sheet, aux);
+		draw_xor_rectangle(sheet, sheet->drag_range);
+	    }
+	}
+	return (TRUE);
+    }
+
+    if (GTK_SHEET_IN_RESIZE(sheet))
+    {
+	GtkSheetRange aux, visr;
+	gint current_col, current_row, col_threshold, row_threshold;
+
+	g_assert(0 <= sheet->drag_cell.row && sheet->drag_cell.row <= sheet->maxrow);
+	g_assert(0 <= sheet->drag_cell.col && sheet->drag_cell.col <= sheet->maxcol);
+
+	current_row = MIN(sheet->maxrow, _gtk_sheet_row_from_ypixel(sheet, y));
+	current_col = MIN(sheet->maxcol, _gtk_sheet_column_from_xpixel(sheet, x));
+
+	row    = current_row - sheet->drag_cell.row;
+	column = current_col - sheet->drag_cell.col;
+
+#if GTK_SHEET_DEBUG_SELECTION > 0
+	g_debug("gtk_sheet_motion: RESIZE row %d col %d cr %d cc %d",
+	    row, column, current_row, current_col);
+#endif
+
+	/*use half of column width resp. row height as threshold to expand selection*/
+	row_threshold = _gtk_sheet_row_top_ypixel(sheet, current_row);
+	if (current_row >= 0)
+	    row_threshold += (ROW_HEIGHT(sheet, current_row)) / 2;
+
+	if (current_row > sheet->drag_range.row0 && y < row_threshold)
+	    current_row = _gtk_sheet_last_visible_rowidx(sheet, current_row - 1);
+	else if (current_row < sheet->drag_range.row0 && y < row_threshold)
+	    current_row = _gtk_sheet_first_visible_rowidx(sheet, current_row + 1);
+
+	col_threshold = _gtk_sheet_column_left_xpixel(sheet, current_col);
+	if (current_col >= 0)
+	    col_threshold += (COLPTR(sheet, current_col)->width) / 2;
+
+	if (current_col > sheet->drag_range.col0 && x < col_threshold)
+	    current_col = _gtk_sheet_last_visible_colidx(sheet, current_col - 1);
+	else if (current_col < sheet->drag_range.col0 && x > col_threshold)
+	    current_col = _gtk_sheet_first_visible_colidx(sheet, current_col + 1);
+
+	sheet->x_drag = x;
+	sheet->y_drag = y;
+	aux = sheet->range;
+
+	/* beware of invisible columns/rows */
+	if (!_gtk_sheet_get_visible_range(sheet, &visr))
+	    return (TRUE);
+
+#if GTK_SHEET_DEBUG_SELECTION > 0
+	g_debug("gtk_sheet_motion: RESIZE th %d row %d col %d cr %d cc %d",
+	    row_threshold, row, column, current_row, current_col);
+#endif
+
+	if (_POINT_IN_RANGE(current_row, current_col, &visr))
+	{
+	    aux = sheet->drag_range;
+	    sheet->drag_range = sheet->range;
+
+	    if (sheet->state != GTK_SHEET_COLUMN_SELECTED)
+	    {
+		if (current_row >= sheet->drag_range.row0)
+		{
+		    sheet->drag_range.rowi = current_row;
+		}
+		else if (current_row < sheet->drag_range.row0)
+		{
+		    sheet->drag_range.rowi = sheet->drag_range.row0;
+		    sheet->drag_range.row0 = current_row;
+		}
+	    }
+
+	    if (sheet->state != GTK_SHEET_ROW_SELECTED)
+	    {
+		if (current_col >= sheet->drag_range.col0)
+		{
+		    sheet->drag_range.coli = current_col;
+		}
+		else if (current_col < sheet->drag_range.col0)
+		{
+		    sheet->drag_range.coli = sheet->drag_range.col0;
+		    sheet->drag_range.col0 = current_col;
+		}
+	    }
+
+	    if (_RANGE_NEQ_RANGE(&aux, &sheet->drag_range)
+	    {
+		draw_xor_rectangle(sheet, aux);
+		draw_xor_rectangle(sheet, sheet->drag_range);
+	    }
+	}
+	return (TRUE);
+    }
+
+    gtk_sheet_get_pixel_info(sheet, NULL, x, y, &row, &column);
+
+    if (sheet->state == GTK_SHEET_NORMAL
+	&& row == sheet->active_cell.row && column == sheet->active_cell.col)
+    {
+	return (TRUE);
+    }
+
+    if (GTK_SHEET_IN_SELECTION(sheet) && (mods & GDK_BUTTON1_MASK))
+    {
+	GtkSheetRange visr;
+
+	if (!_gtk_sheet_get_visible_range(sheet, &visr))
+	    return (TRUE);
+
+	if (_POINT_IN_RANGE(
+	    row >= 0 ? row : _gtk_sheet_first_visible_rowidx(sheet, 0),
+	    column >= 0 ? column : _gtk_sheet_first_visible_colidx(sheet, 0), 
+	    &visr))
+	{
+	    gtk_sheet_extend_selection(sheet, row, column);
+	}
+    }
+
+    return (TRUE);
+}
+
+/* _HUNT_() statement macros find visible row/col into hunting direction */
+
+#define _HUNT_VISIBLE_LEFT(col) \
+	while (col > 0 \
+	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col))) ) \
+		  col--; \
+	if (col < 0) col = 0; \
+	while (col < sheet->maxcol \
+	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col))) ) \
+		  col++; \
+	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) ) \
+		col = -1;
+
+#define _HUNT_VISIBLE_RIGHT(col) \
+	while (col < sheet->maxcol \
+	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col))) ) \
+		col++; \
+    if (col > sheet->maxcol) col = sheet->maxcol; \
+	while (col > 0 \
+	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col))) ) \
+		col--; \
+	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) ) \
+		col = -1;
+
+#define _HUNT_VISIBLE_UP(row) \
+	while (row > 0 \
+	  && !GTK_SHEET_ROW_IS_VISIBLE(sheet, row)) row--; \
+	if (row < 0) row = 0; \
+	while (row < sheet->maxrow \
+	  && !GTK_SHEET_ROW_IS_VISIBLE(sheet, row)) row++; \
+	if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row)) row = -1;
+
+#define _HUNT_VISIBLE_DOWN(row) \
+	while (row < sheet->maxrow \
+	  && ((row < 0) || !GTK_SHEET_ROW_IS_VISIBLE(sheet, row)) ) \
+	       row++; \
+	if (row > sheet->maxrow) row = sheet->maxrow; \
+	while (row > 0 \
+	  && !GTK_SHEET_ROW_IS_VISIBLE(sheet, row)) row--; \
+	if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row)) row = -1;
+
+#define _HUNT_FOCUS_LEFT(row,col) \
+ 	while (col > 0 \
+ 	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) \
+	      || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(COLPTR(sheet,col)) \
+	      || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col))) \
+ 		  col--; \
+ 	if (col < 0) col = 0; \
+ 	while (col < sheet->maxcol \
+ 	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) \
+	      || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(COLPTR(sheet, col)) \
+              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col)) ) \
+ 		  col++; \
+ 	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) \
+	    || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(COLPTR(sheet, col)) \
+            || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col) ) \
+ 		col = -1;
+
+#define _HUNT_FOCUS_RIGHT(row,col) \
+ 	while (col < sheet->maxcol \
+ 	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) \
+	      || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(COLPTR(sheet, col)) \
+              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col)) ) \
+ 		col++; \
+         if (col > sheet->maxcol) col = sheet->maxcol; \
+ 	while (col > 0 \
+ 	  && (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) \
+	      || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(COLPTR(sheet, col)) \
+              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col)) ) \
+ 		col--; \
+ 	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)) \
+	    || !GTK_SHEET_COLUMN_CAN_GRAB_FOCUS(COLPTR(sheet, col)) \
+            || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col) ) \
+ 		col = -1;
+
+#define _HUNT_FOCUS_UP(row,col) \
+ 	while (row > 0 \
+ 	  && (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row) \
+	      || !GTK_SHEET_ROW_CAN_GRAB_FOCUS(sheet, row) \
+              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col))) \
+ 	      row--; \
+ 	if (row < 0) row = 0; \
+ 	while (row < sheet->maxrow \
+ 	  && (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row) \
+	      || !GTK_SHEET_ROW_CAN_GRAB_FOCUS(sheet, row) \
+              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col))) \
+ 	    row++; \
+ 	if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row) \
+	    || !GTK_SHEET_ROW_CAN_GRAB_FOCUS(sheet, row) \
+            || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col)) \
+ 	    row = -1;
+
+#define _HUNT_FOCUS_DOWN(row,col) \
+ 	while (row < sheet->maxrow \
+ 	  && (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row) \
+	      || !GTK_SHEET_ROW_CAN_GRAB_FOCUS(sheet, row) \
+              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col))) \
+ 	       row++; \
+ 	if (row > sheet->maxrow) row = sheet->maxrow; \
+ 	while (row > 0 \
+ 	  && (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row) \
+	      || !GTK_SHEET_ROW_CAN_GRAB_FOCUS(sheet, row) \
+              || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col))) \
+ 	    row--; \
+ 	if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row) \
+	    || !GTK_SHEET_ROW_CAN_GRAB_FOCUS(sheet, row) \
+            || !GTK_SHEET_CELL_TRAVERSABLE(sheet,row,col)) \
+ 	    row = -1;
+
+static gint
+_gtk_sheet_move_query(GtkSheet *sheet, gint row, gint column, 
+    gboolean need_focus)
+{
+    gint row_move = FALSE, column_move = FALSE;
+    gint row_align = -1, col_align = -1;  /* undef. */
+    guint height, width;
+    gint new_row = row;
+    gint new_col = column;
+    GtkSheetRange visr;
+
+#if GTK_SHEET_DEBUG_MOVE > 0
+    g_debug("gtk_sheet_move_query: row %d column %d view row %d-%d col %d-%d",
+	row, column,
+	MIN_VIEW_ROW(sheet), MAX_VIEW_ROW(sheet),
+	MIN_VIEW_COLUMN(sheet), MAX_VIEW_COLUMN(sheet));
+#endif
+
+    height = sheet->sheet_window_height;
+    width = sheet->sheet_window_width;
+
+    /* beware of invisible columns/rows */
+    if (!_gtk_sheet_get_visible_range(sheet, &visr))
+	return (0);
+
+#if GTK_SHEET_DEBUG_MOVE > 0
+    g_debug("gtk_sheet_move_query: state %d visr row %d-%d col %d-%d",
+	sheet->state, visr.row0, visr.rowi, visr.col0, visr.coli);
+#endif
+
+    if (row >= MAX_VIEW_ROW(sheet)
+	&& row <= visr.rowi
+	&& sheet->state != GTK_SHEET_COLUMN_SELECTED)
+    {
+#if GTK_SHEET_DEBUG_MOVE > 0
+	g_debug("gtk_sheet_move_query: row %d > maxvr %d visr.rowi %d", 
+	    row, MAX_VIEW_ROW(sheet), visr.rowi);
+#endif
+	row_align = 1;  /* bottom */
+	if (need_focus)
+	{
+	    _HUNT_FOCUS_DOWN(new_row,new_col);
+	}
+	else
+	{
+	    _HUNT_VISIBLE_DOWN(new_row);
+	}
+	if (new_row >= 0) row_move = TRUE;
+
+	if (MAX_VIEW_ROW(sheet) == sheet->maxrow &&
+	    _gtk_sheet_row_bottom_ypixel(sheet, sheet->maxrow) < height)
+	{
+	    row_move = FALSE;
+	    row_align = -1;
+	}
+    }
+
+    if (row <= MIN_VIEW_ROW(sheet)
+	&& row >= visr.row0
+	&& sheet->state != GTK_SHEET_COLUMN_SELECTED)
+    {
+#if GTK_SHEET_DEBUG_MOVE > 0
+	g_debug("gtk_sheet_move_query: row %d < minvr %d visr.row0 %d",
+	    row, MIN_VIEW_ROW(sheet), visr.row0);
+#endif
+	row_align = 0;  /* top */
+	if (need_focus)
+	{
+	    _HUNT_FOCUS_UP(new_row,new_col);
+	}
+	else
+	{
+	    _HUNT_VISIBLE_UP(new_row);
+	}
+	if (new_row >= 0) row_move = TRUE;
+    }
+
+    if (column >= MAX_VIEW_COLUMN(sheet)
+	&& column <= visr.coli
+	&& sheet->state != GTK_SHEET_ROW_SELECTED)
+    {
+#if GTK_SHEET_DEBUG_MOVE > 0
+	g_debug("gtk_sheet_move_query: col %d > maxvc %d visr.coli %d",
+	    column, MAX_VIEW_COLUMN(sheet), visr.coli);
+#endif
+	col_align = 1;  /* right */
+	if (need_focus)
+	{
+	    _HUNT_FOCUS_RIGHT(new_row,new_col);
+	}
+	else
+	{
+	    _HUNT_VISIBLE_RIGHT(new_col);
+	}
+	if (new_col >= 0) column_move = TRUE;
+
+	if (MAX_VIEW_COLUMN(sheet) == sheet->maxcol &&
+	    _gtk_sheet_column_right_xpixel(sheet, sheet->maxcol) < width)
+	{
+	    column_move = FALSE;
+	    col_align = -1;
+	}
+    }
+
+    if (column <= MIN_VIEW_COLUMN(sheet)
+	&& column >= visr.col0
+	&& sheet->state != GTK_SHEET_ROW_SELECTED)
+    {
+#if GTK_SHEET_DEBUG_MOVE > 0
+	g_debug("gtk_sheet_move_query: col %d < minvc %d visr.col0 %d",
+	    column, MIN_VIEW_COLUMN(sheet), visr.col0);
+#endif
+	col_align = 0;  /* left */
+	if (need_focus)
+	{
+	    _HUNT_FOCUS_LEFT(new_row,new_col);
+	}
+	else
+	{
+	    _HUNT_VISIBLE_LEFT(new_col);
+	}
+	if (new_col >= 0) column_move = TRUE;
+    }
+
+#if GTK_SHEET_DEBUG_MOVE > 0
+    g_debug("gtk_sheet_move_query: rowMv %d colMv %d newR %d newC %d",
+	row_move, column_move, new_row, new_col);
+#endif
+
+    if (row_move || column_move)
+    {
+	gtk_sheet_moveto(sheet, new_row, new_col, row_align, col_align);
+    }
+
+    return (row_move || column_move);
+}
+
+static void
+gtk_sheet_extend_selection(GtkSheet *sheet, gint row, gint column)
+{
+    GtkSheetRange range;
+    gint state;
+    gint r, c;
+
+#if GTK_SHEET_DEBUG_SELECTION > 0
+    g_debug("gtk_sheet_extend_selection: row %d column %d", row, column);
+#endif
+
+    if (sheet->selection_mode == GTK_SELECTION_SINGLE)
+	return;
+    if (row == sheet->selection_cell.row && column == sheet->selection_cell.col)
+	return;
+
+    if (sheet->active_cell.row < 0 || sheet->active_cell.row > sheet->maxrow)
+	return;
+    if (sheet->active_cell.col < 0 || sheet->active_cell.col > sheet->maxcol)
+	return;
+
+    _gtk_sheet_move_query(sheet, row, column, FALSE);
+    gtk_widget_grab_focus(GTK_WIDGET(sheet));
+
+    if (GTK_SHEET_IN_DRAG(sheet))
+	return;
+
+    state = sheet->state;
+
+    switch(sheet->state)
+    {
+	case GTK_SHEET_ROW_SELECTED:
+	    column = sheet->maxcol;
+	    break;
+
+	case GTK_SHEET_COLUMN_SELECTED:
+	    row = sheet->maxrow;
+	    break;
+
+	case GTK_SHEET_NORMAL:
+	    r = sheet->active_cell.row;
+	    c = sheet->active_cell.col;
+
+	    sheet->range.col0 = c;
+	    sheet->range.row0 = r;
+	    sheet->range.coli = c;
+	    sheet->range.rowi = r;
+
+	    gdk_draw_pixmap(sheet->sheet_window,
+		gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL],
+		sheet->pixmap,
+		_gtk_sheet_column_left_xpixel(sheet, c) - 1,
+		_gtk_sheet_row_top_ypixel(sheet, r) - 1,
+		_gtk_sheet_column_left_xpixel(sheet, c) - 1,
+		_gtk_sheet_row_top_ypixel(sheet, r) - 1,
+		COLPTR(sheet, c)->width + 4,
+		ROW_HEIGHT(sheet, r) + 4);
+
+	    sheet->state = GTK_SHEET_RANGE_SELECTED;
+	    gtk_sheet_range_draw_selection(sheet, sheet->range);
+	    /* FALLTHROUGH */
+
+	case GTK_SHEET_RANGE_SELECTED:
+	    sheet->state = GTK_SHEET_RANGE_SELECTED;
+	    /* FALLTHROUGH */
+    }
+
+    sheet->selection_cell.row = row;
+    sheet->selection_cell.col = column;
+
+    range.col0 = MIN(column, sheet->active_cell.col);
+    range.coli = MAX(column, sheet->active_cell.col);
+
+    range.row0 = MIN(row, sheet->active_cell.row);
+    range.rowi = MAX(row, sheet->active_cell.row);
+
+    range.coli = MIN(range.coli, sheet->maxcol);
+    range.rowi = MIN(range.rowi, sheet->maxrow);
+
+    if (range.row0 != sheet->range.row0 || range.rowi != sheet->range.rowi ||
+	range.col0 != sheet->range.col0 || range.coli != sheet->range.coli ||
+	state == GTK_SHEET_NORMAL)
+    {
+	gtk_sheet_real_select_range(sheet, &range);
+    }
+}
+
+/*
+ * gtk_sheet_entry_key_press_handler:
+ * 
+ * this event handler propagates the "key-press-event" signal 
+ * from the sheet_entry to the #GtkSheet
+ * 
+ * @param widget the #GtkSheet (connected "swapped")
+ * @param key    the GdkEventKey which triggered this signal
+ * 
+ * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
+ */
+static gboolean
+gtk_sheet_entry_key_press_handler(GtkWidget *widget, GdkEventKey *key, gpointer user_data)
+{
+    gboolean stop_emission = FALSE;
+    GtkSheet *sheet = GTK_SHEET(widget);
+
+#if GTK_SHEET_DEBUG_KEYPRESS > 0
+    g_debug("gtk_sheet_entry_key_press_handler: called, key %s",
+	gtk_accelerator_name(key->keyval, key->state));
+#endif
+
+    if (!_gtk_sheet_binding_filter(sheet, key))
+    {
+#if GTK_SHEET_DEBUG_KEYPRESS > 0
+	g_debug("gtk_sheet_entry_key_press_handler: filtered binding");
+#endif
+	return (FALSE);
+    }
+
+#if 1
+    /* process enter-event
+       - detect wether Return or Enter was pressed 
+       - detect wether the application wants it to be handled by the sheet 
+       - if unwanted: execute appropriate application handler 
+       - use a new signal for this ? 
+       */
+    if ((key->keyval == GDK_KEY_Return) || (key->keyval == GDK_KEY_KP_Enter))
+    {
+#if GTK_SHEET_DEBUG_ENTER_PRESSED > 0
+	g_debug("gtk_sheet_entry_key_press_handler: enter-pressed: invoke");
+#endif
+	_gtksheet_signal_emit(GTK_OBJECT(sheet),
+	    sheet_signals[ENTER_PRESSED],
+	    key,
+	    &stop_emission);
+#if GTK_SHEET_DEBUG_ENTER_PRESSED > 0
+	g_debug("gtk_sheet_entry_key_press_handler: enter-pressed: returns %d", stop_emission);
+#endif
+    }
+#endif
+
+    if (!stop_emission)
+    {
+	/* intercept item_entry processing if there exists a key binding on the sheet */
+
+	if (gtk_bindings_activate_event(GTK_OBJECT(sheet), key))
+	{
+	    stop_emission = TRUE;
+	}
+	else
+	{
+	    g_signal_emit_by_name(GTK_OBJECT(widget),
+		"key_press_event", key,
+		&stop_emission);
+	}
+    }
+
+#if GTK_SHEET_DEBUG_KEYPRESS > 0
+    g_debug("gtk_sheet_entry_key_press_handler: done, key %s stop %d",
+	gtk_accelerator_name(key->keyval, key->state), stop_emission);
+#endif
+
+    return (stop_emission);
+}
+
+/*
+ * gtk_sheet_key_press_handler:
+ * 
+ * this is the #GtkSheet widget class "key-press-event" handler.
+ * 
+ * @param widget the #GtkSheet
+ * @param key    the GdkEventKey which triggered this signal
+ * 
+ * @return TRUE to stop other handlers from being invoked for the event. FALSE to propagate the event further.
+ */
+static gboolean
+gtk_sheet_key_press_handler(GtkWidget *widget, GdkEventKey *key)
+{
+    GtkSheet *sheet;
+    gint state;
+    gboolean extend_selection = FALSE;
+    gboolean in_selection = FALSE;
+
+    sheet = GTK_SHEET(widget);
+
+    extend_selection = (key->state & GDK_SHIFT_MASK)
+	|| key->keyval == GDK_KEY_Shift_L
+	|| key->keyval == GDK_KEY_Shift_R;
+
+    state = sheet->state;
+    in_selection = GTK_SHEET_IN_SELECTION(sheet);
+    GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_SELECTION);
+
+#if GTK_SHEET_DEBUG_KEYPRESS > 0
+    g_debug("gtk_sheet_key_press_handler: key %s",
+	gtk_accelerator_name(key->keyval, key->state));
+#endif
+
+    /* if there is a key_binding, use implementation from _gtk_sheet_move_cursor() */
+
+    if (_gtk_sheet_binding_filter(sheet, key)
+	&& gtk_bindings_activate_event(GTK_OBJECT(sheet), key))
+    {
+#if GTK_SHEET_DEBUG_KEYPRESS > 0
+	g_debug("gtk_sheet_key_press_handler: done %s (binding)",
+	    gtk_accelerator_name(key->keyval, key->state));
+#endif
+	return (TRUE);
+    }
+
+    return (FALSE);
+}
+
+
+/**
+ * _gtk_sheet_move_cursor: 
+ * @sheet:  the sheet 
+ * @step:   type of movement
+ * @count:  number of steps to move
+ * @extend_selection: TRUE if the move should extend the 
+ * selection default handler for move-cursor signal 
+ */
+static void _gtk_sheet_move_cursor(GtkSheet *sheet,
+    GtkMovementStep step,
+    gint count,
+    gboolean extend_selection)
+{
+    gint row, col;
+    gboolean veto = TRUE;
+
+#if GTK_SHEET_DEBUG_SIGNALS > 0
+    g_debug("SIGNAL _gtk_sheet_move_cursor %p step %d count %d extend %d",
+	sheet, step, count, extend_selection);
+#endif
+
+    row = sheet->active_cell.row;
+    col = sheet->active_cell.col;
+
+    switch(step)
+    {
+	case GTK_MOVEMENT_PAGES:
+	    count = count *
+		(MAX_VIEW_ROW(sheet) - MIN_VIEW_ROW(sheet) - GTK_SHEET_PAGE_OVERLAP);
+	    /* FALLTHROUGH */
+
+	case GTK_MOVEMENT_DISPLAY_LINES:
+	    if (count < 0) /* Move Up */
+	    {
+		if (extend_selection)
+		{
+		    if (sheet->state == GTK_STATE_NORMAL)
+		    {
+			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+			if (!veto)
+			    break;
+		    }
+		    if (sheet->selection_cell.row > 0)
+		    {
+			row = sheet->selection_cell.row + count;
+			_HUNT_VISIBLE_UP(row);
+			gtk_sheet_extend_selection(sheet, row, sheet->selection_cell.col);
+		    }
+		    return;
+		}
+
+		if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
+		    row = MIN_VIEW_ROW(sheet);
+		if (sheet->state == GTK_SHEET_ROW_SELECTED)
+		    col = MIN_VIEW_COLUMN(sheet);
+
+		if (row > 0)
+		{
+		    row = row + count;
+		    _HUNT_FOCUS_UP(row,col);
+		}
+	    }
+	    else if (count > 0) /* Move Down */
+	    {
+		if (extend_selection)
+		{
+		    if (sheet->state == GTK_STATE_NORMAL)
+		    {
+			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+			if (!veto)
+			    break;
+		    }
+		    if (sheet->selection_cell.row < sheet->maxrow)
+		    {
+			row = sheet->selection_cell.row + count;
+			_HUNT_VISIBLE_DOWN(row);
+			gtk_sheet_extend_selection(sheet, row, sheet->selection_cell.col);
+		    }
+		    return;
+		}
+
+		if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
+		    row = MIN_VIEW_ROW(sheet) - 1;
+		if (sheet->state == GTK_SHEET_ROW_SELECTED)
+		    col = MIN_VIEW_COLUMN(sheet);
+
+		if (row < sheet->maxrow)
+		{
+		    row = row + count;
+		    _HUNT_FOCUS_DOWN(row,col);
+		}
+	    }
+	    if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+	    break;
+
+	case GTK_MOVEMENT_HORIZONTAL_PAGES:
+	    count = count *
+		(MAX_VIEW_COLUMN(sheet) - MIN_VIEW_COLUMN(sheet) - GTK_SHEET_PAGE_OVERLAP);
+	    /* FALLTHROUGH */
+
+	case GTK_MOVEMENT_VISUAL_POSITIONS:
+	    if (count < 0)  /* Move Left */
+	    {
+		if (extend_selection)
+		{
+		    if (sheet->state == GTK_STATE_NORMAL)
+		    {
+			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+			if (!veto)
+			    break;
+		    }
+		    if (sheet->selection_cell.col > 0)
+		    {
+			col = sheet->selection_cell.col + count;
+			_HUNT_VISIBLE_LEFT(col);
+			gtk_sheet_extend_selection(sheet, sheet->selection_cell.row, col);
+		    }
+		    return;
+		}
+
+		if (sheet->state == GTK_SHEET_ROW_SELECTED)
+		    col = MIN_VIEW_COLUMN(sheet) - 1;
+		if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
+		    row = MIN_VIEW_ROW(sheet);
+
+		if (col > 0)
+		{
+		    col = col + count;
+		    _HUNT_FOCUS_LEFT(row,col);
+		}
+	    }
+	    else if (count > 0) /* Move Right */
+	    {
+		if (extend_selection)
+		{
+		    if (sheet->state == GTK_STATE_NORMAL)
+		    {
+			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+			if (!veto)
+			    break;
+		    }
+		    if (sheet->selection_cell.col < sheet->maxcol)
+		    {
+			col = sheet->selection_cell.col + count;
+			_HUNT_VISIBLE_RIGHT(col);
+			gtk_sheet_extend_selection(sheet, sheet->selection_cell.row, col);
+		    }
+		    return;
+		}
+
+		if (sheet->state == GTK_SHEET_ROW_SELECTED)
+		    col = MIN_VIEW_COLUMN(sheet) - 1;
+		if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
+		    row = MIN_VIEW_ROW(sheet);
+
+		if (col < sheet->maxcol)
+		{
+		    /* after sheet initialisation, row is -1
+		       when called from gtk_sheet_focus()
+		       */
+		    if (row < 0) row = 0;
+
+		    col = col + count;
+		    _HUNT_FOCUS_RIGHT(row,col);
+		}
+	    }
+	    if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+	    break;
+
+	case GTK_MOVEMENT_BUFFER_ENDS:
+	    if (count < 0)  /* Topmost Row */
+	    {
+		if (extend_selection)
+		{
+		    if (sheet->state == GTK_STATE_NORMAL)
+		    {
+			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+			if (!veto)
+			    break;
+		    }
+		    if (sheet->selection_cell.row > 0)
+		    {
+			row = 0;
+			_HUNT_VISIBLE_UP(row);
+			gtk_sheet_extend_selection(sheet, row, sheet->selection_cell.col);
+		    }
+		    return;
+		}
+		row = 0;
+		_HUNT_FOCUS_UP(row,col);
+	    }
+	    else if (count > 0)  /* Last Row */
+	    {
+		if (extend_selection)
+		{
+		    if (sheet->state == GTK_STATE_NORMAL)
+		    {
+			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+			if (!veto)
+			    break;
+		    }
+		    if (sheet->selection_cell.row < sheet->maxrow)
+		    {
+			row = sheet->maxrow;
+			_HUNT_VISIBLE_DOWN(row);
+			gtk_sheet_extend_selection(sheet, row, sheet->selection_cell.col);
+		    }
+		    return;
+		}
+		row = sheet->maxrow;
+		_HUNT_FOCUS_DOWN(row,col);
+	    }
+	    if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+	    break;
+
+	case GTK_MOVEMENT_DISPLAY_LINE_ENDS:
+	    if (count < 0)  /* First Column */
+	    {
+		if (extend_selection)
+		{
+		    if (sheet->state == GTK_STATE_NORMAL)
+		    {
+			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+			if (!veto)
+			    break;
+		    }
+		    if (sheet->selection_cell.col > 0)
+		    {
+			col = 0;
+			_HUNT_VISIBLE_LEFT(col);
+			gtk_sheet_extend_selection(sheet, sheet->selection_cell.row, col);
+		    }
+		    return;
+		}
+		col = 0;
+		_HUNT_FOCUS_LEFT(row,col);
+	    }
+	    else if (count > 0)  /* Last Column */
+	    {
+		if (extend_selection)
+		{
+		    if (sheet->state == GTK_STATE_NORMAL)
+		    {
+			if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+			if (!veto)
+			    break;
+		    }
+		    if (sheet->selection_cell.col < sheet->maxcol)
+		    {
+			col = sheet->maxcol;
+			_HUNT_VISIBLE_RIGHT(col);
+			gtk_sheet_extend_selection(sheet, sheet->selection_cell.row, col);
+		    }
+		    return;
+		}
+		col = sheet->maxcol;
+		_HUNT_FOCUS_RIGHT(row,col);
+	    }
+	    if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+	    break;
+
+	case GTK_MOVEMENT_LOGICAL_POSITIONS:
+	    if (sheet->state == GTK_SHEET_ROW_SELECTED)
+		col = MIN_VIEW_COLUMN(sheet) - 1;
+	    if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
+		row = MIN_VIEW_ROW(sheet);
+
+	    if ((count == GTK_DIR_LEFT)  /* Tab horizontal backward */
+		|| (count == GTK_DIR_TAB_BACKWARD))  /* Tab horizontal backward */
+	    {
+		gint old_col = col;
+		gint old_row = row;
+
+		if (col > 0)  /* move left within line */
+		{
+		    col = col - 1;
+		    _HUNT_FOCUS_LEFT(row,col);
+		}
+		if (col == old_col && row > 0) /* wrap at eol */
+		{
+		    row = row - 1;
+		    _HUNT_FOCUS_UP(row,col);
+
+		    if (row != old_row) 
+		    {
+			col = sheet->maxcol;
+			_HUNT_FOCUS_LEFT(row,col);
+		    }
+		}
+	    }
+	    else if ((count == GTK_DIR_RIGHT)  /* Tab horizontal forward */
+		|| (count == GTK_DIR_TAB_FORWARD))
+	    {
+		gint old_col = col;
+
+		if (col < sheet->maxcol)  /* move right within line */
+		{
+		    col = col + 1;
+		    _HUNT_FOCUS_RIGHT(row,col);
+		}
+		if (col == old_col && row < sheet->maxrow) /* wrap at eol */
+		{
+		    col = 0;
+		    _HUNT_FOCUS_RIGHT(row,col);
+
+		    row = row + 1;
+		    _HUNT_FOCUS_DOWN(row,col);
+		}
+	    }
+	    else if (count == GTK_DIR_UP)  /* Tab vertical backward */
+	    {
+		gint old_row = row;
+		gint old_col = col;
+
+		if (row > 0)  /* move up within column */
+		{
+		    row = row - 1;
+		    _HUNT_FOCUS_UP(row,col);
+		}
+		if (row == old_row && col > 0) /* wrap at eol */
+		{
+		    col = col - 1;
+		    _HUNT_FOCUS_LEFT(row,col);
+
+		    if (col != old_col)
+		    { 
+			row = sheet->maxrow;
+			_HUNT_FOCUS_UP(row,col);
+		    } 
+		}
+	    }
+	    else if (count == GTK_DIR_DOWN)  /* Tab vertical forward */
+	    {
+		gint old_row = row;
+		gint old_col = col;
+
+		if (row < sheet->maxrow)  /* move down within column */
+		{
+		    row = row + 1;
+		    _HUNT_FOCUS_DOWN(row,col);
+
+		}
+		if (row == old_row && col < sheet->maxcol) /* wrap at eol */
+		{
+		    col = col + 1;
+		    _HUNT_FOCUS_RIGHT(row,col);
+		    if (col != old_col)
+		    { 
+			row = 0;
+			_HUNT_FOCUS_DOWN(row,col);
+		    } 
+		}
+	    }
+	    if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
+	    break;
+
+	default:
+	    break;
+    }
+
+    gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
+
+#if GTK_SHEET_DEBUG_SIGNALS > 0
+    g_debug("SIGNAL _gtk_sheet_move_cursor %p done", sheet);
+#endif
+}
+
+/*
+ * gtk_sheet_size_request_handler:
+ * 
+ * this is the #GtkSheet widget class "size-request" signal handler
+ * 
+ * @param widget the #GtkSheet
+ * @param requisition
+ *               the #GtkRequisition
+ */
+static void
+gtk_sheet_size_request_handler(GtkWidget *widget, GtkRequisition *requisition)
+{
+    GtkSheet *sheet;
+    GList *children;
+    GtkSheetChild *child;
+    GtkRequisition child_requisition;
+
+    g_return_if_fail(widget != NULL);
+    g_return_if_fail(GTK_IS_SHEET(widget));
+    g_return_if_fail(requisition != NULL);
+
+#if GTK_SHEET_DEBUG_SIZE > 0
+    g_debug("gtk_sheet_size_request_handler: called");
+#endif
+
+    sheet = GTK_SHEET(widget);
+
+    requisition->width = 3 * GTK_SHEET_COLUMN_DEFAULT_WIDTH;
+    requisition->height = 3 * _gtk_sheet_row_default_height(widget);
+
+    /* compute the size of the column title area */
+    if (sheet->column_titles_visible)
+	requisition->height += sheet->column_title_area.height;
+
+    /* compute the size of the row title area */
+    if (sheet->row_titles_visible)
+	requisition->width += sheet->row_title_area.width;
+
+    _gtk_sheet_recalc_view_range(sheet);
+
+    children = sheet->children;
+    while (children)
+    {
+	child = children->data;
+	children = children->next;
+
+	gtk_widget_size_request(child->widget, &child_requisition);
+    }
+}
+
+
+/*
+ * gtk_sheet_size_allocate_handler:
+ * 
+ * this is the #GtkSheet widget class "size-allocate" signal handler
+ * 
+ * @param widget     the #GtkSheet
+ * @param allocation the #GtkAllocation
+ */
+static void
+gtk_sheet_size_allocate_handler(GtkWidget *widget, GtkAllocation *allocation)
+{
+    GtkSheet *sheet;
+    GtkAllocation sheet_allocation;
+    gint border_width;
+    gboolean modified;
+
+    g_return_if_fail(widget != NULL);
+    g_return_if_fail(GTK_IS_SHEET(widget));
+    g_return_if_fail(allocation != NULL);
+
+#if GTK_SHEET_DEBUG_SIZE > 0
+    g_debug("gtk_sheet_size_allocate_handler: called (%d, %d, %d, %d)",
+	allocation->x, allocation->y, allocation->width, allocation->height);
+#endif
+
+    sheet = GTK_SHEET(widget);
+
+    gtk_widget_set_allocation(widget, allocation);
+    border_width = gtk_container_get_border_width(GTK_CONTAINER(widget));
+
+    if (gtk_widget_get_realized(widget))
+    {
+	gdk_window_move_resize(gtk_widget_get_window(widget),
+	    allocation->x + border_width,
+	    allocation->y + border_width,
+	    allocation->width - 2 * border_width,
+	    allocation->height - 2 * border_width);
+    }
+
+    /* use internal allocation structure for all the math
+     * because it's easier than always subtracting the container
+     * border width */
+
+    sheet->internal_allocation.x = 0;
+    sheet->internal_allocation.y = 0;
+    sheet->internal_allocation.width = allocation->width - 2 * border_width;
+    sheet->internal_allocation.height = allocation->height - 2 * border_width;
+
+    sheet_allocation.x = 0;
+    sheet_allocation.y = 0;
+    sheet_allocation.width = allocation->width - 2 * border_width;
+    sheet_allocation.height = allocation->height - 2 * border_width;
+
+    modified =
+	(sheet->sheet_window_width != sheet_allocation.width) ||
+	(sheet->sheet_window_height != sheet_allocation.height);
+
+    sheet->sheet_window_width = sheet_allocation.width;
+    sheet->sheet_window_height = sheet_allocation.height;
+
+    if (gtk_widget_get_realized(widget))
+    {
+	gdk_window_move_resize(sheet->sheet_window,
+	    sheet_allocation.x,
+	    sheet_allocation.y,
+	    sheet_allocation.width,
+	    sheet_allocation.height);
+    }
+
+    /* position the window which holds the column title buttons */
+
+    sheet->column_title_area.x = 0;
+    sheet->column_title_area.y = 0;
+    if (sheet->row_titles_visible)
+	sheet->column_title_area.x = sheet->row_title_area.width;
+    sheet->column_title_area.width = sheet_allocation.width - sheet->column_title_area.x;
+
+    if (gtk_widget_get_realized(widget) && sheet->column_titles_visible)
+    {
+	gdk_window_move_resize(sheet->column_title_window,
+	    sheet->column_title_area.x,
+	    sheet->column_title_area.y,
+	    sheet->column_title_area.width,
+	    sheet->column_title_area.height);
+    }
+
+    /* column button allocation */
+    _gtk_sheet_column_buttons_size_allocate(sheet);
+
+    /* position the window which holds the row title buttons */
+    sheet->row_title_area.x = 0;
+    sheet->row_title_area.y = 0;
+    if (sheet->column_titles_visible)
+	sheet->row_title_area.y = sheet->column_title_area.height;
+    sheet->row_title_area.height = sheet_allocation.height - sheet->row_title_area.y;
+
+    if (gtk_widget_get_realized(widget) && sheet->row_titles_visible)
+    {
+	gdk_window_move_resize(sheet->row_title_window,
+	    sheet->row_title_area.x,
+	    sheet->row_title_area.y,
+	    sheet->row_title_area.width,
+	    sheet->row_title_area.height);
+    }
+
+    /* row button allocation */
+    size_allocate_row_title_buttons(sheet);
+
+    if (gtk_sheet_autoresize(sheet) &&
+	(modified || (GTK_SHEET_FLAGS(sheet) & GTK_SHEET_IN_AUTORESIZE_PENDING)))
+    {
+	/* autoresize here, because window was changed -> max col_width */
+	gtk_sheet_autoresize_all(sheet);
+	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_AUTORESIZE_PENDING);
+    }
+
+    _gtk_sheet_recalc_view_range(sheet);
+
+    /* re-scale backing pixmap */
+    gtk_sheet_make_backing_pixmap(sheet, 0, 0);
+    gtk_sheet_position_children(sheet);
+
+    /* set the scrollbars adjustments */
+    _gtk_sheet_scrollbar_adjust(sheet);
+}
+
+static gboolean gtk_sheet_focus(GtkWidget *widget,
+    GtkDirectionType  direction)
+{
+    g_return_val_if_fail(GTK_IS_SHEET(widget), FALSE);
+    GtkSheet *sheet = GTK_SHEET(widget);
+
+    if (!gtk_widget_is_sensitive(GTK_WIDGET(sheet))) {
+	g_debug("gtk_sheet_focus: not sensitive"); 
+	return(FALSE);
+    }
+
+#if GTK_SHEET_DEBUG_KEYPRESS > 0
+    g_debug("gtk_sheet_focus: %p %d", widget, direction); 
+#endif
+
+    if (!gtk_widget_has_focus (widget))
+    {
+	gtk_widget_grab_focus (widget);
+    }
+
+    gint row = sheet->active_cell.row;
+    gint col = sheet->active_cell.col;
+
+    if (row < 0 || col < 0)  /* not in sheet */
+    {
+	_gtk_sheet_move_cursor(sheet, GTK_MOVEMENT_VISUAL_POSITIONS, 1, FALSE);
+	return(TRUE);
+    }
+
+    gboolean veto;
+
+    gtk_sheet_click_cell(sheet, row, col, &veto);
+    if (!veto) return(FALSE);
+	
+    return(TRUE);
+}
+
+
+static void
+size_allocate_row_title_buttons(GtkSheet *sheet)
+{
+    gint i, y, height;
+    GdkRectangle *rta = &sheet->row_title_area;
+
+    if (!sheet->row_titles_visible)
+	return;
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+
+#if GTK_SHEET_DEBUG_ALLOCATION > 0
+    g_debug("size_allocate_row_title_buttons: called");
+#endif
+
+    height = sheet->sheet_window_height;
+    y = 0;
+
+    if (sheet->column_titles_visible)
+    {
+	height -= sheet->column_title_area.height;
+	y = sheet->column_title_area.height;
+    }
+
+    /* if neccessary, resize the row title window */
+    if (rta->height != height || rta->y != y)
+    {
+	rta->y = y;
+	rta->height = height;
+	gdk_window_move_resize(sheet->row_title_window,
+	    rta->x,
+	    rta->y,
+	    rta->width,
+	    rta->height);
+    }
+
+    /* if the right edge of the sheet is visible, clear it */
+    if (MAX_VIEW_ROW(sheet) >= sheet->maxrow)
+    {
+	/* this one causes flicker */
+
+	gdk_window_clear_area(sheet->row_title_window,
+	    0, 0,
+	    rta->width,
+	    rta->height);
+    }
+
+    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
+	return;
+
+    for (i = MIN_VIEW_ROW(sheet); i <= MAX_VIEW_ROW(sheet) && i <= sheet->maxrow; i++) _gtk_sheet_draw_button(sheet, i, -1);
+}
+
+/**
+ * gtk_sheet_recalc_top_ypixels:
+ * @sheet:  the #GtkSheet 
+ *  
+ * rebuild the row geometry after rows were added or removed
+ */
+void
+_gtk_sheet_recalc_top_ypixels(GtkSheet *sheet)
+{
+    GtkSheetPrefixSum *ps = sheet->row_geometry;
+    GtkSheetRowPage *page;
+    gint p;
+
+    _gtk_sheet_psum_resize(ps, sheet->row_npages);
+
+    for (p = 0; p < sheet->row_npages; p++)
+    {
+	page = sheet->row_pages[p];
+	if (page)
+	{
+	    _gtk_sheet_row_page_rebuild(page);
+	    ps->value[p] = page->total;
+	}
+	else
+	    ps->value[p] = GTK_SHEET_ROW_PAGE_SIZE * sheet->row_page_height;
+    }
+
+    _gtk_sheet_psum_rebuild(ps);
+    sheet->geometry_dirty &= ~GTK_SHEET_GEOMETRY_ROWS;
+    _gtk_sheet_tile_cache_invalidate(sheet, NULL);
+}
+
+/**
+ * _gtk_sheet_row_geometry_changed:
+ * @sheet:  the #GtkSheet 
+ * @row:    row index
+ *  
+ * update the row geometry after a row height or visibility change
+ */
+void
+_gtk_sheet_row_geometry_changed(GtkSheet *sheet, gint row)
+{
+    GtkSheetPrefixSum *ps = sheet->row_geometry;
+    GtkSheetRowPage *page;
+    gint slot, delta, i;
+
+    if (row < 0 || row > sheet->maxrow)
+	return;
+
+    if (sheet->geometry_batch)
+    {
+	sheet->geometry_dirty |= GTK_SHEET_GEOMETRY_ROWS;
+	return;
+    }
+
+    if (ps->n != sheet->row_npages)
+    {
+	_gtk_sheet_recalc_top_ypixels(sheet);
+	return;
+    }
+
+    page = ROW_PAGE(sheet, row);
+    if (page)  /* else still a default row */
+    {
+	slot = ROW_SLOT(row);
+	delta = ROW_GEOMETRY_HEIGHT(sheet, row)
+	    - (_gtk_sheet_row_page_prefix(page, slot + 1) - _gtk_sheet_row_page_prefix(page, slot));
+
+	for (i = slot + 1; delta && i <= GTK_SHEET_ROW_PAGE_SIZE; i += i & -i)
+	    page->tree[i] += delta;
+	page->total += delta;
+
+	_gtk_sheet_psum_set(ps, row >> GTK_SHEET_ROW_PAGE_SHIFT, page->total);
+    }
+    _gtk_sheet_tile_cache_invalidate(sheet, NULL);
+}
+
+/**
+ * _gtk_sheet_recalc_left_xpixels:
+ * @sheet:  the #GtkSheet 
+ *  
+ * rebuild the column geometry after columns were added, removed 
+ * or moved 
+ */
+void
+_gtk_sheet_recalc_left_xpixels(GtkSheet *sheet)
+{
+    GtkSheetPrefixSum *ps = sheet->column_geometry;
+    gint i;
+
+    _gtk_sheet_psum_resize(ps, sheet->maxcol + 1);
+
+    for (i = 0; i <= sheet->maxcol; i++)
+	ps->value[i] = COLUMN_GEOMETRY_WIDTH(sheet, i);
+
+    _gtk_sheet_psum_rebuild(ps);
+    sheet->geometry_dirty &= ~GTK_SHEET_GEOMETRY_COLUMNS;
+    _gtk_sheet_tile_cache_invalidate(sheet, NULL);
+}
+
+/**
+ * _gtk_sheet_column_geometry_changed:
+ * @sheet:  the #GtkSheet 
+ * @col:    column index
+ *  
+ * update the column geometry after a column width or visibility 
+ * change
+ */
+void
+_gtk_sheet_column_geometry_changed(GtkSheet *sheet, gint col)
+{
+    GtkSheetPrefixSum *ps = sheet->column_geometry;
+
+    if (col < 0 || col > sheet->maxcol)
+	return;
+
+    if (sheet->geometry_batch)
+    {
+	sheet->geometry_dirty |= GTK_SHEET_GEOMETRY_COLUMNS;
+	return;
+    }
+
+    if (ps->n != sheet->maxcol + 1)
+    {
+	_gtk_sheet_recalc_left_xpixels(sheet);
+	return;
+    }
+    _gtk_sheet_psum_set(ps, col, COLUMN_GEOMETRY_WIDTH(sheet, col));
+    _gtk_sheet_tile_cache_invalidate(sheet, NULL);
+}
+
+/**
+ * _gtk_sheet_column_geometry_offset:
+ * @sheet:  the #GtkSheet 
+ * @col:    column index
+ *  
+ * left edge of the column, relative to the sheet window and not 
+ * honoring the sheet's hoffset
+ *  
+ * Returns: pixel offset
+ */
+gint
+_gtk_sheet_column_geometry_offset(GtkSheet *sheet, gint col)
+{
+    return (ROW_TITLES_WIDTH(sheet)
+	+ _gtk_sheet_psum_prefix(sheet->column_geometry, col));
+}
+
+/**
+ * _gtk_sheet_reset_text_column:
+ * @sheet:  the #GtkSheet
+ * @start_column: last column that kept its index, -1 for all
+ *  
+ * reset left/right text column index to initial state. 
+ *  
+ * Columns right of @start_column were added, removed or moved. 
+ * Their spans are reset, spans of the other columns reaching 
+ * beyond @start_column are cut back. Spans are recorded again 
+ * by the next redraw. 
+ */
+void
+_gtk_sheet_reset_text_column(GtkSheet *sheet, gint start_column)
+{
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+    int i;
+
+    g_assert(start_column >= -1);
+
+    for (i = 0; i <= sheet->maxcol; i++)
+    {
+	GtkSheetColumn *colptr = COLPTR(sheet, i);
+
+	if (!colptr)
+	    continue;
+
+	if (i > start_column)  /* for the fresh columns */
+	{
+	    colptr->left_text_column = i;
+	    colptr->right_text_column = i;
+	}
+	else if (colptr->right_text_column > start_column)
+	{
+	    colptr->right_text_column = i;
+	}
+
+	/* recorded labels may belong to other columns now */
+	if (i > start_column || colptr->right_text_spread > start_column)
+	{
+	    if (colptr->text_spans)
+	    {
+		g_hash_table_destroy(colptr->text_spans);
+		colptr->text_spans = NULL;
+	    }
+	    if (i > start_column)
+		colptr->left_text_spread = i;
+	    colptr->right_text_spread = i;
+	    colptr->text_spread_dirty = FALSE;
+	}
+    }
+#endif
+}
+
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+/*
+ * _gtk_sheet_range_add_text_columns - add overflowing text columns
+ * 
+ * extend a range by the columns whose text overflows into it and 
+ * by the columns its text overflows into, so that all text crossing 
+ * the range is painted completely inside of it. Repeated until no 
+ * more columns are found, because repainting a column may clear 
+ * text overflowing from further columns.
+ * 
+ * @param sheet
+ * @param range  range with valid columns, extended
+ */
+static inline void
+_gtk_sheet_text_column_sources(GtkSheet *sheet, gint col, GtkSheetRange *range)
+{
+    GtkSheetColumn *colptr = COLPTR(sheet, col);
+
+    if (colptr->left_text_column < range->col0)
+	range->col0 = MAX(colptr->left_text_column, 0);
+    if (colptr->right_text_column > range->coli)
+	range->coli = MIN(colptr->right_text_column, sheet->maxcol);
+}
+
+static inline void
+_gtk_sheet_text_column_targets(GtkSheet *sheet, GtkSheetRange *range)
+{
+    /* hidden columns are passed by overflowing text */
+    while (range->coli < sheet->maxcol)
+    {
+	GtkSheetColumn *colptr = COLPTR(sheet, range->coli + 1);
+
+	if (GTK_SHEET_COLUMN_IS_VISIBLE(colptr)
+	    && colptr->left_text_column > range->coli)
+	    break;
+	range->coli++;
+    }
+    while (range->col0 > 0)
+    {
+	GtkSheetColumn *colptr = COLPTR(sheet, range->col0 - 1);
+
+	if (GTK_SHEET_COLUMN_IS_VISIBLE(colptr)
+	    && colptr->right_text_column < range->col0)
+	    break;
+	range->col0--;
+    }
+}
+
+/*
+ * _gtk_sheet_text_columns_rebuild - shrink the text column index
+ * 
+ * recounts the text spread of columns whose labels were found 
+ * narrower or gone and derives the index of all columns from the 
+ * spreads. The labels were repainted within their former spread, 
+ * so the narrower index leaves no text behind.
+ * 
+ * @param sheet
+ */
+static void
+_gtk_sheet_text_columns_rebuild(GtkSheet *sheet)
+{
+    gint col, i;
+
+    for (col = 0; col <= sheet->maxcol; col++)
+    {
+	GtkSheetColumn *colptr = COLPTR(sheet, col);
+	GHashTableIter iter;
+	gpointer span;
+
+	if (!colptr->text_spread_dirty)
+	    continue;
+
+	colptr->text_spread_dirty = FALSE;
+	colptr->left_text_spread = colptr->right_text_spread = col;
+
+	if (!colptr->text_spans)
+	    continue;
+
+	g_hash_table_iter_init(&iter, colptr->text_spans);
+	while (g_hash_table_iter_next(&iter, NULL, &span))
+	{
+	    colptr->left_text_spread = MIN(colptr->left_text_spread,
+		col - TEXT_SPAN_LEFT(span));
+	    colptr->right_text_spread = MAX(colptr->right_text_spread,
+		col + TEXT_SPAN_RIGHT(span));
+	}
+	colptr->left_text_spread = MAX(colptr->left_text_spread, 0);
+	colptr->right_text_spread = MIN(colptr->right_text_spread, sheet->maxcol);
+
+	if (!g_hash_table_size(colptr->text_spans))
+	{
+	    g_hash_table_destroy(colptr->text_spans);
+	    colptr->text_spans = NULL;
+	}
+    }
+
+    for (col = 0; col <= sheet->maxcol; col++)
+    {
+	GtkSheetColumn *colptr = COLPTR(sheet, col);
+
+	colptr->left_text_column = colptr->right_text_column = col;
+    }
+
+    for (col = 0; col <= sheet->maxcol; col++)  /* ascending, minimum first */
+    {
+	GtkSheetColumn *colptr = COLPTR(sheet, col);
+
+	for (i = colptr->left_text_spread; i < col; i++)
+	    COLPTR(sheet, i)->right_text_column = col;
+	for (i = col + 1; i <= colptr->right_text_spread; i++)
+	{
+	    GtkSheetColumn *cpi = COLPTR(sheet, i);
+
+	    if (cpi->left_text_column > col)
+		cpi->left_text_column = col;
+	}
+    }
+
+    sheet->text_spread_dirty = FALSE;
+}
+
+static void
+_gtk_sheet_range_add_text_columns(GtkSheet *sheet, GtkSheetRange *range)
+{
+    gint lo = range->col0, hi = range->coli;  /* scanned columns */
+    gint col;
+
+    if (lo < 0 || hi > sheet->maxcol)
+	return;
+
+    if (sheet->text_spread_dirty)
+	_gtk_sheet_text_columns_rebuild(sheet);
+
+    for (col = lo; col <= hi; col++)
+	_gtk_sheet_text_column_sources(sheet, col, range);
+    _gtk_sheet_text_column_targets(sheet, range);
+
+    while (range->col0 < lo || range->coli > hi)
+    {
+	gint col0 = range->col0, coli = range->coli;
+
+	for (col = col0; col < lo; col++)
+	    _gtk_sheet_text_column_sources(sheet, col, range);
+	for (col = hi + 1; col <= coli; col++)
+	    _gtk_sheet_text_column_sources(sheet, col, range);
+
+	lo = col0;
+	hi = coli;
+	_gtk_sheet_text_column_targets(sheet, range);
+    }
+}
+#endif
+
+static void
+_get_entry_window_size(GtkEntry *entry,
+    gint     *x,
+    gint     *y,
+    gint     *width,
+    gint     *height)
+{
+    GtkRequisition requisition;
+    GtkAllocation allocation;
+    GtkWidget *widget = GTK_WIDGET(entry);
+
+    /* GtkEntry->is_cell_renderer is a GSEAL()ed structure member.
+       It will only be set to TRUE when calling the GtkEntry's GtkCellEditable
+       interface function gtk_entry_cell_editable_init().
+     
+       This should never be the case in GtkSheet or GtkItemEntry.
+     
+       Anyhow, if the above statement wasn't true, solutions could be:
+       - ask the Gtk maintainers to add the function
+         GtkEntry::get_widget_window_size() to the public GtkEntry interface
+       - last resort work-around:
+         use the sealed member anyhow GtkEntry->GSEAL(is_cell_renderer)
+       */
+#if 0
+#    define ENTRY_IS_CELL_RENDERER  entry->is_cell_renderer
+#else
+#    define ENTRY_IS_CELL_RENDERER  FALSE
+#endif
+
+    gtk_widget_get_child_requisition(widget, &requisition);
+    gtk_widget_get_allocation(widget, &allocation);
+
+    if (x)
+	*x = allocation.x;
+
+    if (y)
+    {
+	if (ENTRY_IS_CELL_RENDERER)
+	    *y = allocation.y;
+	else
+	    *y = allocation.y + (allocation.height - requisition.height) / 2;
+    }
+
+    if (width)
+	*width = allocation.width;
+
+    if (height)
+    {
+	if (ENTRY_IS_CELL_RENDERER)
+	    *height = allocation.height;
+	else
+	    *height = requisition.height;
+    }
+}
+
+
+
+/**
+ * _gtk_sheet_entry_size_allocate:
+ * @sheet:  the #GtkSheet
+ *  
+ * size allocation handler for the sheet entry
+ */
+void
+_gtk_sheet_entry_size_allocate(GtkSheet *sheet)
+{
+    GtkAllocation shentry_allocation;
+    gint row, col;
+    gint size, entry_max_size, column_width, row_height;
+    guint text_width, text_height;
+
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+    if (!gtk_widget_get_mapped(GTK_WIDGET(sheet)))
+	return;
+    if (sheet->maxrow < 0 || sheet->maxcol < 0)
+	return;
+    if (!sheet->sheet_entry)   /* PR#102114 */
+	return;
+
+#if GTK_SHEET_DEBUG_SIZE > 0
+    g_debug("_gtk_sheet_entry_size_allocate: called");
+#endif
+
+    GtkWidget *entry_widget = gtk_sheet_get_entry(sheet);
+
+#if 0
+    /* the entry setup must be done before the text assigment,
+       otherwise max_length may cause text assignment to fail
+       */
+    _gtk_sheet_entry_setup(sheet,
+	sheet->active_cell.row, sheet->active_cell.col,
+	entry_widget);
+#endif
+
+    GtkSheetCellAttr attributes;
+    gtk_sheet_get_attributes(sheet,
+	sheet->active_cell.row, sheet->active_cell.col,
+	&attributes);
+
+    if (gtk_widget_get_realized(sheet->sheet_entry))
+    {
+	gtk_widget_size_request(sheet->sheet_entry, NULL);
+    }
+
+    if (GTK_IS_ITEM_ENTRY(entry_widget))
+    {
+	entry_max_size = GTK_ITEM_ENTRY(entry_widget)->text_max_size;
+    }
+    else
+	entry_max_size = 0;
+
+    row = sheet->active_cell.row;
+    col = sheet->active_cell.col;
+
+    text_width = 0;
+    text_height = 0;
+    {
+	gchar *text = gtk_sheet_get_entry_text(sheet);
+
+	if (text && text[0])
+	{
+	    _get_string_extent(sheet, 
+		 (0 <= col && col <= sheet->maxcol) ? COLPTR(sheet, col) : NULL,
+		attributes.font_desc, text, &text_width, &text_height);
+	}
+
+	g_free(text);
+    }
+
+    if (0 <= col && col <= sheet->maxcol)
+	column_width = COLPTR(sheet, col)->width;
+    else
+	column_width = GTK_SHEET_COLUMN_DEFAULT_WIDTH;
+
+    if (0 <= row && row <= sheet->maxrow)
+	row_height = ROW_HEIGHT(sheet, row);
+    else
+	row_height = GTK_SHEET_ROW_DEFAULT_HEIGHT;
+
+    size = MIN(text_width, entry_max_size);
+    size = MAX(size, column_width - 2 * CELLOFFSET);
+
+    shentry_allocation.x = _gtk_sheet_column_left_xpixel(sheet, col);
+    shentry_allocation.y = _gtk_sheet_row_top_ypixel(sheet, row);
+    shentry_allocation.width = column_width;
+    shentry_allocation.height = row_height;
+
+    if (GTK_IS_ITEM_ENTRY(sheet->sheet_entry))
+    {
+#if GTK_SHEET_DEBUG_SIZE > 0
+	g_debug("_gtk_sheet_entry_size_allocate: is_item_entry");
+#endif
+
+	shentry_allocation.height -= 2 * CELLOFFSET;
+	shentry_allocation.y += CELLOFFSET;
+
+	if (gtk_sheet_clip_text(sheet))
+	    shentry_allocation.width = column_width - 2 * CELLOFFSET;
+	else  /* text extends multiple cells */
+	    shentry_allocation.width = size;
+
+	switch(GTK_ITEM_ENTRY(entry_widget)->justification)
+	{
+	    case GTK_JUSTIFY_CENTER:
+		shentry_allocation.x += (column_width) / 2 - size / 2;
+		break;
+
+	    case GTK_JUSTIFY_RIGHT:
+		shentry_allocation.x += column_width - size;
+		break;
+
+	    case GTK_JUSTIFY_LEFT:
+	    case GTK_JUSTIFY_FILL:
+		shentry_allocation.x += CELLOFFSET;
+		break;
+	}
+
+	/* vertical justification */
+	{
+	    gint x, y, width, height;
+
+	    _get_entry_window_size(GTK_ENTRY(entry_widget), &x, &y, &width, &height);
+
+#if GTK_SHEET_DEBUG_SIZE>0
+	    g_debug("_gtk_sheet_entry_size_allocate: get_widget_window_size (%d, %d, %d, %d)",
+		x, y, width, height);
+#endif
+
+	    switch(sheet->vjust)
+	    {
+		case GTK_SHEET_VERTICAL_JUSTIFICATION_DEFAULT:
+		case GTK_SHEET_VERTICAL_JUSTIFICATION_TOP:
+		    shentry_allocation.height = height;
+		    break;
+
+		case GTK_SHEET_VERTICAL_JUSTIFICATION_MIDDLE:
+		    shentry_allocation.height = shentry_allocation.height / 2;
+		    break;
+
+		case GTK_SHEET_VERTICAL_JUSTIFICATION_BOTTOM:
+		    break;
+	    }
+	}
+    }
+    else if ( GTK_IS_DATA_TEXT_VIEW(sheet->sheet_entry)
+	     || GTK_IS_TEXT_VIEW(sheet->sheet_entry) )
+    {
+#if GTK_SHEET_DEBUG_SIZE > 0
+	g_debug("_gtk_sheet_entry_size_allocate: is_text_view");
+#endif
+
+	shentry_allocation.height -= 2 * CELLOFFSET;
+	shentry_allocation.y += CELLOFFSET;
+	shentry_allocation.x += CELLOFFSET;
+
+	if (gtk_sheet_clip_text(sheet))
+	    shentry_allocation.width = column_width - 2 * CELLOFFSET;
+	else  /* text extends multiple cells */
+	    shentry_allocation.width = size;
+    }
+    else
+    {
+	shentry_allocation.x += 2;
+	shentry_allocation.y += 2;
+	shentry_allocation.width -= MIN(shentry_allocation.width, 3);
+	shentry_allocation.height -= MIN(shentry_allocation.height, 3);
+    }
+
+#if 0
+    /* the following works with most widgets, but looks funny */
+    gtk_widget_set_size_request(sheet->sheet_entry,
+				shentry_allocation.width, shentry_allocation.height);
+#endif
+
+#if GTK_SHEET_DEBUG_SIZE >0
+    g_debug("_gtk_sheet_entry_size_allocate: allocate (%d,%d,%d,%d)",
+	shentry_allocation.x, shentry_allocation.y, shentry_allocation.width, shentry_allocation.height);
+#endif
+
+    gtk_widget_size_allocate(sheet->sheet_entry, &shentry_allocation);
+
+#if GTK_SHEET_DEBUG_SIZE > 0
+    g_debug("_gtk_sheet_entry_size_allocate: returned (%d,%d,%d,%d)",
+	shentry_allocation.x, shentry_allocation.y, shentry_allocation.width, shentry_allocation.height);
+#endif
+}
+
+#if GTK_SHEET_DEBUG_FINALIZE > 0
+/* obj_ref debug code */
+static void weak_notify(gpointer data, GObject *o)
+{
+    gchar *msg = data;  /* assume a string was passed as data */
+
+    g_debug("weak_notify: %p finalized (%s)", o, msg ? msg : "");
+}
+#endif
+
+static void
+gtk_sheet_entry_set_max_size(GtkSheet *sheet)
+{
+    gint i;
+    gint size = 0;
+    gint sizel = 0, sizer = 0;
+    gint row, col;
+    GtkJustification justification;
+
+    row = sheet->active_cell.row;
+    col = sheet->active_cell.col;
+
+#if GTK_SHEET_DEBUG_SIZE > 0
+    g_debug("gtk_sheet_entry_set_max_size: called");
+#endif
+
+    if (!GTK_IS_ITEM_ENTRY(sheet->sheet_entry) || gtk_sheet_clip_text(sheet))
+	return;
+
+    justification = GTK_ITEM_ENTRY(sheet->sheet_entry)->justification;
+
+    switch(justification)
+    {
+	case GTK_JUSTIFY_FILL:
+	case GTK_JUSTIFY_LEFT:
+	    for (i = col + 1; i <= MAX_VIEW_COLUMN(sheet) && i <= sheet->maxcol; i++)
+	    {
+		if (gtk_sheet_cell_get_text(sheet, row, i))
+		    break;
+
+		size += COLPTR(sheet, i)->width;
+	    }
+	    size = MIN(size, sheet->sheet_window_width - _gtk_sheet_column_left_xpixel(sheet, col));
+	    break;
+
+	case GTK_JUSTIFY_RIGHT:
+	    for (i = col - 1; i >= MIN_VIEW_COLUMN(sheet); i--)
+	    {
+		if (gtk_sheet_cell_get_text(sheet, row, i))
+		    break;
+
+		if (i < 0 || i > sheet->maxcol)
+		    continue;
+		size += COLPTR(sheet, i)->width;
+	    }
+	    break;
+
+	case GTK_JUSTIFY_CENTER:
+	    for (i = col + 1; i <= MAX_VIEW_COLUMN(sheet) && i <= sheet->maxcol; i++)
+	    {
+		/* if (gtk_sheet_cell_get_text(sheet, row, i)) break; */
+
+		sizer += COLPTR(sheet, i)->width;
+	    }
+	    for (i = col - 1; i >= MIN_VIEW_COLUMN(sheet); i--)
+	    {
+		if (gtk_sheet_cell_get_text(sheet, row, i))
+		    break;
+
+		if (i < 0 || i > sheet->maxcol)
+		    continue;
+		sizel += COLPTR(sheet, i)->width;
+	    }
+	    size = 2 * MIN(sizel, sizer);
+	    break;
+    }
+
+    if (size != 0)
+	size += COLPTR(sheet, col)->width;
+    GTK_ITEM_ENTRY(sheet->sheet_entry)->text_max_size = size;
+}
+
+static gboolean sheet_entry_focus_in_handler(GtkWidget *widget,
+    GdkEventFocus *event, gpointer user_data)
+{
+    gboolean retval = FALSE;
+    g_signal_emit(GTK_OBJECT(widget),
+	sheet_signals[ENTRY_FOCUS_IN], 0, event, &retval);
+    return (retval);
+}
+
+static gboolean sheet_entry_focus_out_handler(GtkWidget *widget,
+    GdkEventFocus *event, gpointer user_data)
+{
+    gboolean retval = FALSE;
+    g_signal_emit(GTK_OBJECT(widget),
+	sheet_signals[ENTRY_FOCUS_OUT], 0, event, &retval);
+    return (retval);
+}
+
+static void sheet_entry_populate_popup_handler(GtkWidget *widget,
+    GtkMenu *menu, gpointer user_data)
+{
+#if GTK_SHEET_DEBUG_SIGNALS > 0
+    g_debug("sheet_entry_populate_popup_handler: menu %p", menu);
+#endif
+
+    g_signal_emit(GTK_OBJECT(widget),
+	sheet_signals[ENTRY_POPULATE_POPUP], 0, menu);
+}
+
+static void
+create_sheet_entry(GtkSheet *sheet, GType new_entry_type)
+{
+    GtkWidget *widget;
+    GtkWidget * entry, *new_entry;
+    GtkStyle *style;
+
+    widget = GTK_WIDGET(sheet);
+
+#if GTK_SHEET_DEBUG_ENTRY > 0
+    g_debug("create_sheet_entry: called");
+#endif
+
+    style = gtk_style_copy(gtk_widget_get_style(GTK_WIDGET(sheet)));
+
+    if (sheet->sheet_entry)
+    {
+	/* avoids warnings */
+	g_object_ref(sheet->sheet_entry);
+	gtk_widget_unparent(sheet->sheet_entry);
+#if GTK_SHEET_DEBUG_ENTRY > 0
+	g_debug("create_sheet_entry: destroying old entry %p", sheet->sheet_entry);
+#endif
+	gtk_widget_destroy(sheet->sheet_entry);
+	sheet->sheet_entry = NULL;
+    }
+
+    if (new_entry_type == G_TYPE_NONE) new_entry_type = G_TYPE_ITEM_ENTRY;
+
+#if GTK_SHEET_DEBUG_ENTRY > 0
+	g_debug("create_sheet_entry: new_entry type %s", 
+	    g_type_name(new_entry_type));
+#endif
+
+    new_entry = gtk_widget_new(new_entry_type, NULL);
+
+#if GTK_SHEET_DEBUG_ENTRY > 0
+	g_debug("create_sheet_entry: got new_entry %p", new_entry);
+#endif
+
+    /* connect focus signal propagation handlers */
+    g_signal_connect_swapped(new_entry, "focus-in-event",
+	G_CALLBACK(sheet_entry_focus_in_handler), sheet);
+    g_signal_connect_swapped(new_entry, "focus-out-event",
+	G_CALLBACK(sheet_entry_focus_out_handler), sheet);
+
+    if (GTK_IS_ENTRY(new_entry) 
+	|| GTK_IS_DATA_TEXT_VIEW(new_entry) 
+	|| GTK_IS_TEXT_VIEW(new_entry))
+    {
+	g_signal_connect_swapped(new_entry, "populate-popup",
+	    G_CALLBACK(sheet_entry_populate_popup_handler), sheet);
+    }
+
+    sheet->installed_entry_type = new_entry_type;
+    sheet->sheet_entry = new_entry;
+    entry = gtk_sheet_get_entry(sheet);
+
+    if (!entry)  /* this was an unsupported entry type */
+    {
+	g_warning("Unsupported entry type - widget must contain an GtkEditable or GtkTextView");
+	gtk_widget_destroy(new_entry);
+
+	new_entry = gtk_item_entry_new();
+	sheet->sheet_entry = new_entry;
+	sheet->installed_entry_type = G_TYPE_ITEM_ENTRY;
+    }
+    g_object_ref_sink(sheet->sheet_entry);
+
+#if GTK_SHEET_DEBUG_FINALIZE > 0
+    g_object_weak_ref(G_OBJECT(sheet->sheet_entry), weak_notify, "Sheet-Entry");
+#endif
+
+    if (gtk_widget_get_realized(GTK_WIDGET(sheet)))
+    {
+	gtk_widget_size_request(sheet->sheet_entry, NULL);
+
+#if GTK_SHEET_DEBUG_ENTRY > 0
+	g_debug("create_sheet_entry: sheet was realized");
+#endif
+	gtk_widget_set_parent_window(sheet->sheet_entry, sheet->sheet_window);
+	gtk_widget_set_parent(sheet->sheet_entry, GTK_WIDGET(sheet));
+	gtk_widget_realize(sheet->sheet_entry);
+    }
+
+    g_signal_connect_swapped(GTK_OBJECT(entry), "key_press_event",
+	(void *)gtk_sheet_entry_key_press_handler,
+	GTK_OBJECT(sheet));
+
+    gtk_widget_show(sheet->sheet_entry);
+}
+
+
+/**
+ * gtk_sheet_get_entry_type:
+ * @sheet: a #GtkSheet
+ *
+ * Get sheets entry type, if known
+ *
+ * Returns: a #GtkSheetEntryType or GTK_SHEET_ENTRY_TYPE_DEFAULT
+ */
+GType
+gtk_sheet_get_entry_type(GtkSheet *sheet)
+{
+    g_return_val_if_fail(sheet, GTK_SHEET_ENTRY_TYPE_DEFAULT);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), GTK_SHEET_ENTRY_TYPE_DEFAULT);
+
+    return (sheet->entry_type);
+}
+
+/**
+ * gtk_sheet_get_entry:
+ * @sheet: a #GtkSheet
+ *
+ * Get sheet's entry widget. 
+ *  
+ * If the entry widget is a container, the direct childs of the 
+ * container are searched for a valid entry widget. If you want
+ * the container itself to be returned, you should use 
+ * #gtk_sheet_get_entry_widget() instead. 
+ *
+ * Returns: (transfer none) a #GtkWidget or NULL
+ */
+GtkWidget *
+gtk_sheet_get_entry(GtkSheet *sheet)
+{
+    GtkWidget *parent;
+    GtkWidget *entry = NULL;
+    GtkTableChild *table_child;
+    GtkBoxChild *box_child;
+    GList *children = NULL;
+
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
+
+    if (!sheet->sheet_entry)   /* PR#102114 */
+	return(NULL);
+    
+    if (GTK_IS_EDITABLE(sheet->sheet_entry))
+	return (sheet->sheet_entry);
+    if (GTK_IS_DATA_TEXT_VIEW(sheet->sheet_entry))
+	return (sheet->sheet_entry);
+    if (GTK_IS_TEXT_VIEW(sheet->sheet_entry))
+	return (sheet->sheet_entry);
+
+    parent = GTK_WIDGET(sheet->sheet_entry);
+
+    if (GTK_IS_TABLE(parent))
+	children = GTK_TABLE(parent)->children;
+    if (GTK_IS_BOX(parent))
+	children = GTK_BOX(parent)->children;
+
+    if (!children)
+	return (NULL);
+
+    while (children)
+    {
+	if (GTK_IS_TABLE(parent))
+	{
+	    table_child = children->data;
+	    entry = table_child->widget;
+	}
+
+	if (GTK_IS_BOX(parent))
+	{
+	    box_child = children->data;
+	    entry = box_child->widget;
+	}
+
+	if (GTK_IS_EDITABLE(entry))
+	    return (entry);
+	if (GTK_IS_DATA_TEXT_VIEW(entry))
+	    return (entry);
+	if (GTK_IS_TEXT_VIEW(entry))
+	    return (entry);
+
+	children = children->next;
+    }
+
+    return (NULL);
+}
+
+/**
+ * gtk_sheet_get_entry_widget:
+ * @sheet: a #GtkSheet
+ *
+ * Get sheet's entry widget. 
+ *  
+ * If the entry widget is a container, the container widget is 
+ * returned. In order to get the entry in the container child, 
+ * you might want to use #gtk_sheet_get_entry() instead. 
+ *
+ * Returns: (transfer none) a #GtkWidget or NULL
+ */
+GtkWidget *
+gtk_sheet_get_entry_widget(GtkSheet *sheet)
+{
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
+    g_return_val_if_fail(sheet->sheet_entry != NULL, NULL);
+
+    return (sheet->sheet_entry);
+}
+
+/**
+ * gtk_sheet_get_entry_text:
+ * @sheet: a #GtkSheet
+ *
+ * Get the text out of the sheet_entry. 
+ *  
+ * This function is mainly used to synchronize the text of a 
+ * second entry with the sheet_entry. 
+ *  
+ * This function is necessary, because not all possible entry 
+ * widgets implement the GtkEditable interface yet. 
+ *
+ * Returns: a copy of the sheet_entry text or NULL. This 
+ * function returns an allocated string, so g_free() it after 
+ * usage! 
+ */
+gchar *gtk_sheet_get_entry_text(GtkSheet *sheet)
+{
+    gchar *text = NULL;
+    GtkWidget *entry = NULL;
+
+    g_return_val_if_fail(sheet != NULL, NULL);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
+
+#if GTK_SHEET_DEBUG_SET_ENTRY_TEXT > 0
+	g_debug("gtk_sheet_get_entry_text[%p]", sheet);
+#endif
+
+    if (!sheet->sheet_entry)   /* PR#102114 */
+	return(NULL);
+
+    entry = gtk_sheet_get_entry(sheet);
+    g_return_val_if_fail(entry != NULL, NULL);
+
+    if (GTK_IS_EDITABLE(entry))
+    {
+	text = gtk_editable_get_chars(GTK_EDITABLE(entry), 0, -1);
+    }
+    else if ( GTK_IS_DATA_TEXT_VIEW(entry) 
+	     || GTK_IS_TEXT_VIEW(entry) )
+    {
+	GtkTextIter start, end;
+	GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(entry));
+	gtk_text_buffer_get_bounds(buffer, &start, &end);
+	text = gtk_text_buffer_get_text(buffer, &start, &end, TRUE);
+    }
+    else
+    {
+	g_warning("gtk_sheet_get_entry_text: no GTK_EDITABLE, don't know how to get the text.");
+    }
+
+#if GTK_SHEET_DEBUG_SET_ENTRY_TEXT > 0
+	g_debug("gtk_sheet_get_entry_text[%p] returns <%s>", 
+                sheet, text);
+#endif
+
+    return (text);
+}
+
+/**
+ * gtk_sheet_set_entry_text:
+ * @sheet: a #GtkSheet 
+ * @text: the text to be set or NULL 
+ *
+ * Set the text in the sheet_entry (and active cell).
+ *  
+ * This function is mainly used to synchronize the text of a 
+ * second entry with the sheet_entry.
+ *  
+ * This function is necessary, because not all possible entry 
+ * widgets implement the GtkEditable interface yet. 
+ */
+void gtk_sheet_set_entry_text(GtkSheet *sheet, const gchar *text)
+{
+    GtkWidget *entry = NULL;
+
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+
+#if GTK_SHEET_DEBUG_SET_ENTRY_TEXT > 0
+	g_debug("gtk_sheet_set_entry_text[%p] = <%s>", 
+                sheet, text);
+#endif
+
+    if (!sheet->sheet_entry)   /* PR#102114 */
+	return;
+
+    entry = gtk_sheet_get_entry(sheet);
+    g_return_if_fail(entry != NULL);
+
+    if (GTK_IS_EDITABLE(entry))
+    {
+	gint position = 0;
+	gtk_editable_delete_text(GTK_EDITABLE(entry), 0, -1);
+	gtk_editable_insert_text(GTK_EDITABLE(entry), text, -1, &position);
+    }
+    else if ( GTK_IS_DATA_TEXT_VIEW(entry) 
+	     || GTK_IS_TEXT_VIEW(entry) )
+    {
+	GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(entry));
+	GtkTextIter iter;
+
+	gtk_text_buffer_set_text(buffer, text, -1);
+
+	gtk_text_buffer_get_start_iter(buffer, &iter);
+	gtk_text_buffer_place_cursor(buffer, &iter);
+    }
+    else
+    {
+	g_warning("gtk_sheet_set_entry_text: no GTK_EDITABLE, don't know how to set the text.");
+    }
+
+#if GTK_SHEET_DEBUG_SET_ENTRY_TEXT > 0
+	g_debug("gtk_sheet_set_entry_text[%p] done", sheet);
+#endif
+}
+
+/**
+ * gtk_sheet_set_entry_editable:
+ * @sheet: a #GtkSheet 
+ * @editable: editable flag
+ *
+ * Set the editable flag in the sheet_entry
+ *  
+ * This function is mainly used to synchronize the editable flag
+ * of a second entry with the sheet_entry. 
+ *  
+ * This function is necessary, because not all possible entry 
+ * widgets implement the GtkEditable interface yet. 
+ */
+void gtk_sheet_set_entry_editable(GtkSheet *sheet, const gboolean editable)
+{
+    GtkWidget *entry = NULL;
+
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+
+    if (!sheet->sheet_entry)   /* PR#102114 */
+	return;
+
+    entry = gtk_sheet_get_entry(sheet);
+    g_return_if_fail(entry != NULL);
+
+    if (GTK_IS_EDITABLE(entry))
+    {
+	gtk_editable_set_editable(GTK_EDITABLE(entry), editable);
+    }
+    else if ( GTK_IS_DATA_TEXT_VIEW(entry)
+	     || GTK_IS_TEXT_VIEW(entry) )
+    {
+	gtk_text_view_set_editable(GTK_TEXT_VIEW(entry), editable);
+    }
+    else
+    {
+	g_warning("gtk_sheet_set_entry_editable: no GTK_EDITABLE, don't know how to set editable.");
+    }
+}
 
-		if (row > 0)  /* move up within column */
-		{
-		    row = row - 1;
-		    _HUNT_FOCUS_UP(row,col);
-		}
-		if (row == old_row && col > 0) /* wrap at eol */
-		{
-		    col = col - 1;
-		    _HUNT_FOCUS_LEFT(row,col);
+/**
+ * gtk_sheet_entry_select_region:
+ * @sheet: a #GtkSheet 
+ * @start_pos: start of region 
+ * @end_pos: end of region 
+ *
+ * Selects a region of text.
+ *  
+ * This function is necessary, because not all possible entry 
+ * widgets implement the GtkEditable interface yet. 
+ */
+void gtk_sheet_entry_select_region(GtkSheet *sheet, gint start_pos, gint end_pos)
+{
+    GtkWidget *entry = NULL;
 
-		    if (col != old_col)
-		    { 
-			row = sheet->maxrow;
-			_HUNT_FOCUS_UP(row,col);
-		    } 
-		}
-	    }
-	    else if (count == GTK_DIR_DOWN)  /* Tab vertical forward */
-	    {
-		gint old_row = row;
-		gint old_col = col;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-		if (row < sheet->maxrow)  /* move down within column */
-		{
-		    row = row + 1;
-		    _HUNT_FOCUS_DOWN(row,col);
+    if (!sheet->sheet_entry)   /* PR#102114 */
+	return;
 
-		}
-		if (row == old_row && col < sheet->maxcol) /* wrap at eol */
-		{
-		    col = col + 1;
-		    _HUNT_FOCUS_RIGHT(row,col);
-		    if (col != old_col)
-		    { 
-			row = 0;
-			_HUNT_FOCUS_DOWN(row,col);
-		    } 
-		}
-	    }
-	    if( (row>=0) && (col>=0) ) gtk_sheet_click_cell(sheet, row, col, &veto);
-	    break;
+    entry = gtk_sheet_get_entry(sheet);
+    g_return_if_fail(entry != NULL);
 
-	default:
-	    break;
+    if (GTK_IS_EDITABLE(entry))
+    {
+	gtk_editable_select_region(GTK_EDITABLE(entry), start_pos, end_pos);
     }
+    else if ( GTK_IS_DATA_TEXT_VIEW(entry)
+	     || GTK_IS_TEXT_VIEW(entry) )
+    {
+	GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(entry));
+	GtkTextIter start, end;
 
-    gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
-
-#if GTK_SHEET_DEBUG_SIGNALS > 0
-    g_debug("SIGNAL _gtk_sheet_move_cursor %p done", sheet);
-#endif
+	gtk_text_buffer_get_iter_at_offset(buffer, &start, start_pos);
+	gtk_text_buffer_get_iter_at_offset(buffer, &end, end_pos);
+	gtk_text_buffer_select_range(buffer, &start, &end);
+    }
+    else
+    {
+	g_warning("gtk_sheet_entry_select_region: no GTK_EDITABLE, don't know how to select region.");
+    }
 }
 
-/*
- * gtk_sheet_size_request_handler:
- * 
- * this is the #GtkSheet widget class "size-request" signal handler
- * 
- * @param widget the #GtkSheet
- * @param requisition
- *               the #GtkRequisition
+/**
+ * gtk_sheet_entry_signal_connect_changed:
+ * @sheet: a #GtkSheet 
+ * @handler: (scope notified) the signal handler
+ *
+ * Connect a handler to the sheet_entry "changed" signal. The 
+ * user_data argument of the handler will be filled with the 
+ * #GtkSheet. 
+ *  
+ * This function is mainly used to synchronize a second entry 
+ * widget with the sheet_entry. 
+ *  
+ * This function is necessary, because not all possible entry 
+ * widgets implement the GtkEditable interface yet. 
+ *  
+ * Returns: the handler id 
  */
-static void
-gtk_sheet_size_request_handler(GtkWidget *widget, GtkRequisition *requisition)
+gulong gtk_sheet_entry_signal_connect_changed(GtkSheet *sheet, GCallback handler)
 {
-    GtkSheet *sheet;
-    GList *children;
-    GtkSheetChild *child;
-    GtkRequisition child_requisition;
+    GtkWidget *entry = NULL;
+    gulong handler_id = 0;
 
-    g_return_if_fail(widget != NULL);
-    g_return_if_fail(GTK_IS_SHEET(widget));
-    g_return_if_fail(requisition != NULL);
+    g_return_val_if_fail(sheet != NULL, handler_id);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), handler_id);
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("gtk_sheet_size_request_handler: called");
-#endif
+    if (!sheet->sheet_entry)   /* PR#102114 */
+	return(handler_id);
 
-    sheet = GTK_SHEET(widget);
+    entry = gtk_sheet_get_entry(sheet);
+    g_return_val_if_fail(entry != NULL, handler_id);
 
-    requisition->width = 3 * GTK_SHEET_COLUMN_DEFAULT_WIDTH;
-    requisition->height = 3 * _gtk_sheet_row_default_height(widget);
+    if (GTK_IS_EDITABLE(entry))
+    {
+	handler_id = g_signal_connect(G_OBJECT(entry),
+	    "changed", handler, GTK_OBJECT(sheet));
+    }
+    else if ( GTK_IS_DATA_TEXT_VIEW(entry) 
+	     || GTK_IS_TEXT_VIEW(entry) )
+    {
+	GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(entry));
 
-    /* compute the size of the column title area */
-    if (sheet->column_titles_visible)
-	requisition->height += sheet->column_title_area.height;
+	handler_id = g_signal_connect(G_OBJECT(buffer),
+	    "changed", handler, GTK_OBJECT(sheet));
+    }
+    else
+    {
+	g_warning("gtk_sheet_entry_signal_connect_changed: no GTK_EDITABLE, don't know how to get editable.");
+    }
+    return (handler_id);
+}
 
-    /* compute the size of the row title area */
-    if (sheet->row_titles_visible)
-	requisition->width += sheet->row_title_area.width;
+/**
+ * gtk_sheet_entry_signal_disconnect_by_func:
+ * @sheet: a #GtkSheet 
+ * @handler: (scope call) the signal handler
+ *
+ * Disconnect a handler from the sheet_entry "changed" signal
+ *  
+ * This function is mainly used to synchronize a second entry 
+ * widget with the sheet_entry. 
+ *  
+ * This function is necessary, because not all possible entry 
+ * widgets implement the GtkEditable interface yet. 
+ */
+void gtk_sheet_entry_signal_disconnect_by_func(GtkSheet *sheet, GCallback handler)
+{
+    GtkWidget *entry = NULL;
 
-    _gtk_sheet_recalc_view_range(sheet);
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    children = sheet->children;
-    while (children)
+    if (!sheet->sheet_entry)   /* PR#102114 */
+	return;
+
+    entry = gtk_sheet_get_entry(sheet);
+    g_return_if_fail(entry != NULL);
+
+    if (GTK_IS_EDITABLE(entry))
     {
-	child = children->data;
-	children = children->next;
+	g_signal_handlers_disconnect_by_func(G_OBJECT(entry),
+	    handler, GTK_OBJECT(sheet));
+    }
+    else if ( GTK_IS_DATA_TEXT_VIEW(entry)
+	     || GTK_IS_TEXT_VIEW(entry) )
+    {
+	GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(entry));
 
-	gtk_widget_size_request(child->widget, &child_requisition);
+	g_signal_handlers_disconnect_by_func(G_OBJECT(buffer),
+	    handler, GTK_OBJECT(sheet));
+    }
+    else
+    {
+	g_warning("gtk_sheet_entry_signal_disconnect_by_func: no GTK_EDITABLE, don't know how to get editable.");
     }
 }
 
 
-/*
- * gtk_sheet_size_allocate_handler:
- * 
- * this is the #GtkSheet widget class "size-allocate" signal handler
- * 
- * @param widget     the #GtkSheet
- * @param allocation the #GtkAllocation
- */
+
+/* BUTTONS */
 static void
-gtk_sheet_size_allocate_handler(GtkWidget *widget, GtkAllocation *allocation)
+row_button_set(GtkSheet *sheet, gint row)
 {
-    GtkSheet *sheet;
-    GtkAllocation sheet_allocation;
-    gint border_width;
-    gboolean modified;
+    if (row < 0 || row > sheet->maxrow)
+	return;
+    if (ROW_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_ACTIVE))
+	return;
 
-    g_return_if_fail(widget != NULL);
-    g_return_if_fail(GTK_IS_SHEET(widget));
-    g_return_if_fail(allocation != NULL);
+    ROW_SET_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_ACTIVE, TRUE);
+    _gtk_sheet_draw_button(sheet, row, -1);
+}
+
+static void
+row_button_release(GtkSheet *sheet, gint row)
+{
+    if (row < 0 || row > sheet->maxrow)
+	return;
+    if (!ROW_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_ACTIVE))
+	return;
+
+    ROW_SET_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_ACTIVE, FALSE);
+    _gtk_sheet_draw_button(sheet, row, -1);
+}
+
+/**
+ * _gtk_sheet_draw_button: 
+ * @sheet:  the #GtkSheet
+ * @row:    row index
+ * @col:    column index 
+ *  
+ * draw a sheet button
+ * if row == -1 draw a column button
+ * if col == -1 draw a row button
+ * if both == -1 draw the sheet button
+ * 
+ */
+void
+_gtk_sheet_draw_button(GtkSheet *sheet, gint row, gint col)
+{
+    GdkWindow *window = NULL;
+    GtkShadowType shadow_type;
+    guint width = 0, height = 0;
+    gint x = 0, y = 0;
+    gint index = 0;
+    guint text_width = 0, text_height = 0;
+    GtkSheetButton *button = NULL, row_button;
+    GtkSheetChild *child = NULL;
+    GdkRectangle allocation;
+    gboolean sensitive = FALSE;
+    gint state = 0;
+    gchar * label, label_buf[10];
+    PangoAlignment pango_alignment = PANGO_ALIGN_LEFT;
+    GtkSheetArea area = ON_SHEET_BUTTON_AREA;
+    PangoFontDescription *font_desc =
+	gtk_widget_get_style(GTK_WIDGET(sheet))->font_desc;
+    PangoRectangle extent;
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("gtk_sheet_size_allocate_handler: called (%d, %d, %d, %d)",
-	allocation->x, allocation->y, allocation->width, allocation->height);
-#endif
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
 
-    sheet = GTK_SHEET(widget);
+    if ((row == -1) && (col == -1))
+	return;
 
-    gtk_widget_set_allocation(widget, allocation);
-    border_width = gtk_container_get_border_width(GTK_CONTAINER(widget));
+#if GTK_SHEET_DEBUG_DRAW_BUTTON > 0
+    g_debug("_gtk_sheet_draw_button: row %d col %d", row, col);
+#endif
 
-    if (gtk_widget_get_realized(widget))
+    if (row >= 0)
     {
-	gdk_window_move_resize(gtk_widget_get_window(widget),
-	    allocation->x + border_width,
-	    allocation->y + border_width,
-	    allocation->width - 2 * border_width,
-	    allocation->height - 2 * border_width);
+	if (row > sheet->maxrow)
+	    return;
+	if (!sheet->row_titles_visible)
+	    return;
+	if (!GTK_SHEET_ROW_IS_VISIBLE(sheet, row))
+	    return;
+	if (row < MIN_VIEW_ROW(sheet))
+	    return;
+	if (row > MAX_VIEW_ROW(sheet))
+	    return;
     }
 
-    /* use internal allocation structure for all the math
-     * because it's easier than always subtracting the container
-     * border width */
-
-    sheet->internal_allocation.x = 0;
-    sheet->internal_allocation.y = 0;
-    sheet->internal_allocation.width = allocation->width - 2 * border_width;
-    sheet->internal_allocation.height = allocation->height - 2 * border_width;
-
-    sheet_allocation.x = 0;
-    sheet_allocation.y = 0;
-    sheet_allocation.width = allocation->width - 2 * border_width;
-    sheet_allocation.height = allocation->height - 2 * border_width;
-
-    modified =
-	(sheet->sheet_window_width != sheet_allocation.width) ||
-	(sheet->sheet_window_height != sheet_allocation.height);
-
-    sheet->sheet_window_width = sheet_allocation.width;
-    sheet->sheet_window_height = sheet_allocation.height;
+    if (col >= 0)
+    {
+	if (col > sheet->maxcol)
+	    return;
+	if (!sheet->column_titles_visible)
+	    return;
+	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
+	    return;
+	if (col < MIN_VIEW_COLUMN(sheet))
+	    return;
+	if (col > MAX_VIEW_COLUMN(sheet))
+	    return;
+    }
 
-    if (gtk_widget_get_realized(widget))
+    if (row == -1)
     {
-	gdk_window_move_resize(sheet->sheet_window,
-	    sheet_allocation.x,
-	    sheet_allocation.y,
-	    sheet_allocation.width,
-	    sheet_allocation.height);
+	window = sheet->column_title_window;
+	button = &COLPTR(sheet, col)->button;
+	index = col;
+	x = _gtk_sheet_column_left_xpixel(sheet, col) + CELL_SPACING;
+	if (sheet->row_titles_visible)
+	    x -= sheet->row_title_area.width;
+	y = 0;
+	width = COLPTR(sheet, col)->width;
+	height = sheet->column_title_area.height;
+	sensitive = GTK_SHEET_COLUMN_IS_SENSITIVE(COLPTR(sheet, col));
+	area = ON_COLUMN_TITLES_AREA;
+    }
+    else if (col == -1)
+    {
+	window = sheet->row_title_window;
+	/* the row button state is kept in the row flags */
+	row_button = *_gtk_sheet_row_button(sheet, row);
+	row_button.state = ROW_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_ACTIVE) ?
+	    GTK_STATE_ACTIVE : GTK_STATE_NORMAL;
+	button = &row_button;
+	index = row;
+	x = 0;
+	y = _gtk_sheet_row_top_ypixel(sheet, row) + CELL_SPACING;
+	if (sheet->column_titles_visible)
+	    y -= sheet->column_title_area.height;
+	width = sheet->row_title_area.width;
+	height = ROW_HEIGHT(sheet, row);
+	sensitive = GTK_SHEET_ROW_IS_SENSITIVE(sheet, row);
+	area = ON_ROW_TITLES_AREA;
     }
 
-    /* position the window which holds the column title buttons */
+    allocation.x = x;
+    allocation.y = y;
+    allocation.width = width;
+    allocation.height = height;
 
-    sheet->column_title_area.x = 0;
-    sheet->column_title_area.y = 0;
-    if (sheet->row_titles_visible)
-	sheet->column_title_area.x = sheet->row_title_area.width;
-    sheet->column_title_area.width = sheet_allocation.width - sheet->column_title_area.x;
+    gdk_window_clear_area(window, x, y, width, height);
 
-    if (gtk_widget_get_realized(widget) && sheet->column_titles_visible)
-    {
-	gdk_window_move_resize(sheet->column_title_window,
-	    sheet->column_title_area.x,
-	    sheet->column_title_area.y,
-	    sheet->column_title_area.width,
-	    sheet->column_title_area.height);
-    }
+    state = button->state;
+    if (!sensitive)
+	state = GTK_STATE_INSENSITIVE;
 
-    /* column button allocation */
-    _gtk_sheet_column_buttons_size_allocate(sheet);
+    if (state == GTK_STATE_ACTIVE)
+	shadow_type = GTK_SHADOW_IN;
+    else
+	shadow_type = GTK_SHADOW_OUT;
 
-    /* position the window which holds the row title buttons */
-    sheet->row_title_area.x = 0;
-    sheet->row_title_area.y = 0;
-    if (sheet->column_titles_visible)
-	sheet->row_title_area.y = sheet->column_title_area.height;
-    sheet->row_title_area.height = sheet_allocation.height - sheet->row_title_area.y;
+    if (state != GTK_STATE_NORMAL && state != GTK_STATE_INSENSITIVE)
+	gtk_paint_box(gtk_widget_get_style(sheet->button), window,
+	    button->state, shadow_type,
+	    &allocation, GTK_WIDGET(sheet->button),
+	    "table-heading", x, y, width, height);
+    else
+	gtk_paint_box(gtk_widget_get_style(sheet->button), window,
+	    GTK_STATE_NORMAL, GTK_SHADOW_OUT,
+	    &allocation, GTK_WIDGET(sheet->button),
+	    "table-heading", x, y, width, height);
 
-    if (gtk_widget_get_realized(widget) && sheet->row_titles_visible)
+    if (button->label_visible)
     {
-	gdk_window_move_resize(sheet->row_title_window,
-	    sheet->row_title_area.x,
-	    sheet->row_title_area.y,
-	    sheet->row_title_area.width,
-	    sheet->row_title_area.height);
-    }
+	PangoLayout *layout = NULL;
+	gint real_x = x, real_y;
 
-    /* row button allocation */
-    size_allocate_row_title_buttons(sheet);
+	text_height =
+	    _gtk_sheet_row_default_height(GTK_WIDGET(sheet)) - 2 * CELLOFFSET;
 
-    if (gtk_sheet_autoresize(sheet) &&
-	(modified || (GTK_SHEET_FLAGS(sheet) & GTK_SHEET_IN_AUTORESIZE_PENDING)))
-    {
-	/* autoresize here, because window was changed -> max col_width */
-	gtk_sheet_autoresize_all(sheet);
-	GTK_SHEET_UNSET_FLAGS(sheet, GTK_SHEET_IN_AUTORESIZE_PENDING);
-    }
+	gdk_gc_set_clip_rectangle(
+	    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[button->state],
+	    &allocation);
+	gdk_gc_set_clip_rectangle(
+	    gtk_widget_get_style(GTK_WIDGET(sheet))->white_gc,
+	    &allocation);
 
-    _gtk_sheet_recalc_view_range(sheet);
+	y += 2 * gtk_widget_get_style(sheet->button)->ythickness;
 
-    /* re-scale backing pixmap */
-    gtk_sheet_make_backing_pixmap(sheet, 0, 0);
-    gtk_sheet_position_children(sheet);
+	real_y = y;
+	label = button->label;
 
-    /* set the scrollbars adjustments */
-    _gtk_sheet_scrollbar_adjust(sheet);
-}
+	if (!label || !label[0])   /* revert to auto-generated numeric label */
+	{
+	    sprintf(label_buf, "%d", index);
+	    label = label_buf;
+	}
 
-static gboolean gtk_sheet_focus(GtkWidget *widget,
-    GtkDirectionType  direction)
-{
-    g_return_val_if_fail(GTK_IS_SHEET(widget), FALSE);
-    GtkSheet *sheet = GTK_SHEET(widget);
+	layout = gtk_widget_create_pango_layout(GTK_WIDGET(sheet), label);
+	pango_layout_set_font_description(layout, font_desc);
 
-    if (!gtk_widget_is_sensitive(GTK_WIDGET(sheet))) {
-	g_debug("gtk_sheet_focus: not sensitive"); 
-	return(FALSE);
-    }
+	pango_layout_get_pixel_extents(layout, NULL, &extent);
+	text_width = extent.width;
 
-#if GTK_SHEET_DEBUG_KEYPRESS > 0
-    g_debug("gtk_sheet_focus: %p %d", widget, direction); 
-#endif
+	switch(button->justification)
+	{
+	    case GTK_JUSTIFY_LEFT:
+		real_x = x + CELLOFFSET;
+		pango_alignment = PANGO_ALIGN_LEFT;
+		break;
 
-    if (!gtk_widget_has_focus (widget))
-    {
-	gtk_widget_grab_focus (widget);
-    }
+	    case GTK_JUSTIFY_RIGHT:
+		real_x = x + width - text_width - CELLOFFSET;
+		pango_alignment = PANGO_ALIGN_RIGHT;
+		break;
 
-    gint row = sheet->active_cell.row;
-    gint col = sheet->active_cell.col;
+	    case GTK_JUSTIFY_FILL:
+		pango_layout_set_justify(layout, TRUE);
+		/* FALLTHROUGH */
 
-    if (row < 0 || col < 0)  /* not in sheet */
-    {
-	_gtk_sheet_move_cursor(sheet, GTK_MOVEMENT_VISUAL_POSITIONS, 1, FALSE);
-	return(TRUE);
-    }
+	    case GTK_JUSTIFY_CENTER:
+		real_x = x + (width - text_width) / 2;
+		pango_alignment = PANGO_ALIGN_CENTER;
 
-    gboolean veto;
+	    default:
+		break;
+	}
+	pango_layout_set_alignment(layout, pango_alignment);
+	gtk_paint_layout(gtk_widget_get_style(GTK_WIDGET(sheet)),
+	    window,
+	    state,
+	    FALSE,
+	    &allocation,
+	    GTK_WIDGET(sheet),
+	    "label",
+	    real_x, real_y,
+	    layout);
+	g_object_unref(G_OBJECT(layout));
 
-    gtk_sheet_click_cell(sheet, row, col, &veto);
-    if (!veto) return(FALSE);
-	
-    return(TRUE);
-}
+	gdk_gc_set_clip_rectangle(
+	    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[button->state],
+	    NULL);
+	gdk_gc_set_clip_rectangle(
+	    gtk_widget_get_style(GTK_WIDGET(sheet))->white_gc,
+	    NULL);
+    }
 
+    gtk_sheet_draw_tooltip_marker(sheet, area, row, col);
 
-static void
-size_allocate_row_title_buttons(GtkSheet *sheet)
-{
-    gint i, y, height;
-    GdkRectangle *rta = &sheet->row_title_area;
+    if ((child = button->child) && (child->widget))
+    {
+	GtkRequisition requisition;
 
-    if (!sheet->row_titles_visible)
-	return;
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
+	child->x = allocation.x;
+	child->y = allocation.y;
 
-#if GTK_SHEET_DEBUG_ALLOCATION > 0
-    g_debug("size_allocate_row_title_buttons: called");
-#endif
+	gtk_widget_get_requisition(child->widget, &requisition);
 
-    height = sheet->sheet_window_height;
-    y = 0;
+	child->x += (width - requisition.width) / 2;
+	child->y += (height - requisition.height) / 2;
 
-    if (sheet->column_titles_visible)
-    {
-	height -= sheet->column_title_area.height;
-	y = sheet->column_title_area.height;
-    }
+	allocation.x = child->x;
+	allocation.y = child->y;
+	allocation.width = requisition.width;
+	allocation.height = requisition.height;
 
-    /* if neccessary, resize the row title window */
-    if (rta->height != height || rta->y != y)
-    {
-	rta->y = y;
-	rta->height = height;
-	gdk_window_move_resize(sheet->row_title_window,
-	    rta->x,
-	    rta->y,
-	    rta->width,
-	    rta->height);
-    }
+	x = child->x;
+	y = child->y;
 
-    /* if the right edge of the sheet is visible, clear it */
-    if (MAX_VIEW_ROW(sheet) >= sheet->maxrow)
-    {
-	/* this one causes flicker */
+	gtk_widget_set_state(child->widget, button->state);
 
-	gdk_window_clear_area(sheet->row_title_window,
-	    0, 0,
-	    rta->width,
-	    rta->height);
+	if (gtk_widget_get_realized(GTK_WIDGET(sheet)) &&
+	    gtk_widget_get_mapped(child->widget))
+	{
+	    gtk_widget_size_allocate(child->widget, &allocation);
+	    gtk_widget_queue_draw(child->widget);
+	}
     }
+}
 
-    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
-	return;
 
-    for (i = MIN_VIEW_ROW(sheet); i <= MAX_VIEW_ROW(sheet) && i <= sheet->maxrow; i++) _gtk_sheet_draw_button(sheet, i, -1);
-}
+/* SCROLLBARS
+ *
+ * functions:
+ *   adjust_scrollbars
+ *   vadjustment_changed
+ *   hadjustment_changed
+ *   vadjustment_value_changed
+ *   hadjustment_value_changed */
 
 /**
- * gtk_sheet_recalc_top_ypixels:
- * @sheet:  the #GtkSheet 
+ * _gtk_sheet_scrollbar_adjust:
+ * 
+ * @param sheet  the #GtkSheet
  *  
- * recalculate topmost pixel of all rows
+ * recalculate scrollbar adjustments and emit changed signals 
  */
 void
-_gtk_sheet_recalc_top_ypixels(GtkSheet *sheet)
+_gtk_sheet_scrollbar_adjust(GtkSheet *sheet)
 {
-    gint i, cy;
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
+    g_debug("_gtk_sheet_scrollbar_adjust: called");
+#endif
 
-    if (sheet->column_titles_visible)
-	cy = sheet->column_title_area.height;
-    else
-	cy = 0;
+    if (sheet->geometry_batch)  /* see gtk_sheet_geometry_commit() */
+	return;
 
-    for (i = 0; i <= sheet->maxrow; i++)
+    if (sheet->vadjustment)
     {
-	sheet->row[i].top_ypixel = cy;
-	if (GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, i)))
-	    cy += sheet->row[i].height;
-    }
-}
+	GtkAdjustment *va = sheet->vadjustment;
 
-/**
- * _gtk_sheet_recalc_left_xpixels:
- * @sheet:  the #GtkSheet 
- *  
- * recalculate left pixel index of all columns
- */
-void
-_gtk_sheet_recalc_left_xpixels(GtkSheet *sheet)
-{
-    gint i, cx;
+	gint upper = gtk_sheet_height(sheet) + 80;
+	gint page_size = sheet->sheet_window_height;
 
-    if (sheet->row_titles_visible)
-	cx = sheet->row_title_area.width;
-    else
-	cx = 0;
+	gtk_adjustment_configure(va,
+	    gtk_adjustment_get_value(va),  /* value */
+	    0.0,  /* lower */
+	    upper,  /* upper */
+	    _gtk_sheet_row_default_height(GTK_WIDGET(sheet)), /* step_increment */
+	    sheet->sheet_window_height / 2, /* page_increment */
+	    page_size  /* page_size */
+	    );
 
-    for (i = 0; i <= sheet->maxcol; i++)
-    {
-	COLPTR(sheet, i)->left_xpixel = cx;
-	if (GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, i)))
-	    cx += COLPTR(sheet, i)->width;
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
+	g_debug("_gtk_sheet_scrollbar_adjust: va PS %d PI %g SI %g L %g U %d V %g VO %d",
+	    page_size, 
+	    gtk_adjustment_get_page_increment(va), 
+	    gtk_adjustment_get_step_increment(va),
+	    gtk_adjustment_get_lower(va), 
+	    upper, 
+	    gtk_adjustment_get_value(va), 
+	    sheet->voffset);
+#endif
+
+	if (upper <= page_size)  /* whole sheet fits into window? */
+	{
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
+	    g_debug("_gtk_sheet_scrollbar_adjust: reset V to 0");
+#endif
+	    gtk_adjustment_set_value(va, 0);
+	    gtk_adjustment_value_changed(va);
+	}
+	/* can produce smudge effects - 23.3.13/fp 
+	else if (va->value >= va->upper - va->page_size)
+	{
+	    va->value = va->upper - va->page_size;
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
+	    g_debug("_gtk_sheet_scrollbar_adjust: reset to V %g VO %d", 
+		va->value, sheet->voffset);
+#endif
+	    g_signal_emit_by_name(GTK_OBJECT(va), "value_changed");
+	} 
+	*/ 
+	
+	gtk_adjustment_changed(va);
     }
-}
 
-/**
- * _gtk_sheet_reset_text_column:
- * @sheet:  the #GtkSheet
- * @start_column: left most column to start from 
- *  
- * reset left/right text column index to initial state
- */
-void
-_gtk_sheet_reset_text_column(GtkSheet *sheet, gint start_column)
-{
-#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
-    int i;
+    if (sheet->hadjustment)
+    {
+	GtkAdjustment *ha = sheet->hadjustment;
 
-    g_assert(start_column >= -1);
+	/* gint upper = gtk_sheet_width(sheet) * 3 / 2; */
+	gint upper = gtk_sheet_width(sheet) + 80;
+	gint page_size = sheet->sheet_window_width;
 
-    for (i = start_column + 1; i <= sheet->maxcol; i++)  /* for the fresh columns */
-    {
-	GtkSheetColumn *colptr = COLPTR(sheet, i);
+	gtk_adjustment_configure(ha,
+	    gtk_adjustment_get_value(ha),  /* value */
+	    0.0,  /* lower */
+	    upper,  /* upper */
+	    GTK_SHEET_COLUMN_DEFAULT_WIDTH, /* step_increment */
+	    sheet->sheet_window_width / 2, /* page_increment */
+	    page_size  /* page_size */
+	    );
 
-	colptr->left_text_column = i;
-	colptr->right_text_column = i;
-    }
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
+	g_debug("_gtk_sheet_scrollbar_adjust: ha PS %d PI %g SI %g L %g U %d V %g HO %d",
+	    page_size, 
+	    gtk_adjustment_get_page_increment(ha), 
+	    gtk_adjustment_get_step_increment(ha),
+	    gtk_adjustment_get_lower(ha), 
+	    upper, 
+	    gtk_adjustment_get_value(ha), sheet->hoffset);
+#endif
+
+	if (upper <= page_size)  /* whole sheet fits into window? */
+	{
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
+	    g_debug("_gtk_sheet_scrollbar_adjust: reset V to 0");
+#endif
+	    gtk_adjustment_set_value(ha, 0);
+	    gtk_adjustment_value_changed(ha);
+	}
+	/* can produce smudge effects - 23.3.13/fp
+	else if (ha->value >= ha->upper - ha->page_size)
+	{
+	    ha->value = ha->upper - ha->page_size;
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
+	    g_debug("_gtk_sheet_scrollbar_adjust: reset to V %g HO %d", 
+		va->value, sheet->hoffset);
 #endif
+	    g_signal_emit_by_name(GTK_OBJECT(ha), "value_changed");
+	} 
+	*/ 
+	
+	gtk_adjustment_changed(ha);
+    }
 }
 
+
+/*
+ * _vadjustment_changed_handler:
+ * 
+ * this is the #GtkSheet vertical adjustment "changed" signal handler
+ * 
+ * @param adjustment the #GtkAdjustment that received the signal
+ * @param data the #GtkSheet passed on signal creation
+ */
 static void
-_get_entry_window_size(GtkEntry *entry,
-    gint     *x,
-    gint     *y,
-    gint     *width,
-    gint     *height)
+_vadjustment_changed_handler(GtkAdjustment *adjustment,
+    gpointer data)
 {
-    GtkRequisition requisition;
-    GtkAllocation allocation;
-    GtkWidget *widget = GTK_WIDGET(entry);
+    GtkSheet *sheet;
 
-    /* GtkEntry->is_cell_renderer is a GSEAL()ed structure member.
-       It will only be set to TRUE when calling the GtkEntry's GtkCellEditable
-       interface function gtk_entry_cell_editable_init().
-     
-       This should never be the case in GtkSheet or GtkItemEntry.
-     
-       Anyhow, if the above statement wasn't true, solutions could be:
-       - ask the Gtk maintainers to add the function
-         GtkEntry::get_widget_window_size() to the public GtkEntry interface
-       - last resort work-around:
-         use the sealed member anyhow GtkEntry->GSEAL(is_cell_renderer)
-       */
-#if 0
-#    define ENTRY_IS_CELL_RENDERER  entry->is_cell_renderer
-#else
-#    define ENTRY_IS_CELL_RENDERER  FALSE
+    g_return_if_fail(adjustment != NULL);
+    g_return_if_fail(data != NULL);
+
+    sheet = GTK_SHEET(data);
+
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 1
+    g_debug("_vadjustment_changed_handler: called: O VA %g VO %d",
+	sheet->old_vadjustment, sheet->voffset);
 #endif
+}
+
+/*
+ * _hadjustment_changed_handler:
+ * 
+ * this is the #GtkSheet horizontal adjustment "change" handler
+ * 
+ * @param adjustment the #GtkAdjustment that received the signal
+ * @param data       the #GtkSheet passed on signal creation
+ */
+static void
+_hadjustment_changed_handler(GtkAdjustment *adjustment, gpointer data)
+{
+    GtkSheet *sheet;
 
-    gtk_widget_get_child_requisition(widget, &requisition);
-    gtk_widget_get_allocation(widget, &allocation);
+    g_return_if_fail(adjustment != NULL);
+    g_return_if_fail(data != NULL);
 
-    if (x)
-	*x = allocation.x;
+    sheet = GTK_SHEET(data);
 
-    if (y)
-    {
-	if (ENTRY_IS_CELL_RENDERER)
-	    *y = allocation.y;
-	else
-	    *y = allocation.y + (allocation.height - requisition.height) / 2;
-    }
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 1
+    g_debug("_hadjustment_changed_handler: called: O VA %g VO %d",
+	sheet->old_vadjustment, sheet->voffset);
+#endif
+}
 
-    if (width)
-	*width = allocation.width;
 
-    if (height)
+/*
+ * _gtk_sheet_title_buttons_have_children - check for title children
+ * 
+ * @param sheet
+ * @param row_titles TRUE for row titles, FALSE for column titles
+ * 
+ * @return TRUE if a widget is attached to one of the title buttons
+ */
+static gboolean
+_gtk_sheet_title_buttons_have_children(GtkSheet *sheet, gboolean row_titles)
+{
+    GList *children;
+
+    for (children = sheet->children; children; children = children->next)
     {
-	if (ENTRY_IS_CELL_RENDERER)
-	    *height = allocation.height;
-	else
-	    *height = requisition.height;
+	GtkSheetChild *child = children->data;
+
+	if (child->attached_to_cell
+	    && (row_titles ? child->col < 0 : child->row < 0))
+	    return (TRUE);
     }
+    return (FALSE);
 }
 
-
-
-/**
- * _gtk_sheet_entry_size_allocate:
- * @sheet:  the #GtkSheet
+/*
+ * _gtk_sheet_scroll_view - shift the view by a pixel delta
+ * 
+ * The backing pixmap is copied onto itself and only the rows or 
+ * columns that became visible are painted. Title windows are 
+ * scrolled and redraw the uncovered buttons on expose. 
  *  
- * size allocation handler for the sheet entry
+ * The view range and offsets must already be updated.
+ * 
+ * @param sheet
+ * @param dx     horizontal shift of the contents in pixels
+ * @param dy     vertical shift of the contents in pixels
+ * 
+ * @return TRUE if done, FALSE if the caller has to redraw the 
+ *  	   whole view
  */
-void
-_gtk_sheet_entry_size_allocate(GtkSheet *sheet)
+static gboolean
+_gtk_sheet_scroll_view(GtkSheet *sheet, gint dx, gint dy)
 {
-    GtkAllocation shentry_allocation;
-    gint row, col;
-    gint size, entry_max_size, column_width, row_height;
-    guint text_width, text_height;
+    GdkRectangle cells;
+    GtkSheetRange strip;
+    GdkGC *gc;
 
+    if (!gtk_widget_is_drawable(GTK_WIDGET(sheet)))
+	return (FALSE);
     if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
+	return (FALSE);
     if (!gtk_widget_get_mapped(GTK_WIDGET(sheet)))
-	return;
-    if (sheet->maxrow < 0 || sheet->maxcol < 0)
-	return;
-    if (!sheet->sheet_entry)   /* PR#102114 */
-	return;
+	return (FALSE);
+    if (!sheet->pixmap)
+	return (FALSE);
+    if ((dx != 0) == (dy != 0))  /* nothing or both directions */
+	return (FALSE);
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("_gtk_sheet_entry_size_allocate: called");
-#endif
+    cells.x = ROW_TITLES_WIDTH(sheet);
+    cells.y = COLUMN_TITLES_HEIGHT(sheet);
+    cells.width = sheet->sheet_window_width - cells.x;
+    cells.height = sheet->sheet_window_height - cells.y;
 
-    GtkWidget *entry_widget = gtk_sheet_get_entry(sheet);
+    if (ABS(dx) >= cells.width || ABS(dy) >= cells.height)
+	return (FALSE);
 
-#if 0
-    /* the entry setup must be done before the text assigment,
-       otherwise max_length may cause text assignment to fail
-       */
-    _gtk_sheet_entry_setup(sheet,
-	sheet->active_cell.row, sheet->active_cell.col,
-	entry_widget);
+    strip.row0 = MIN_VIEW_ROW(sheet);
+    strip.rowi = MAX_VIEW_ROW(sheet);
+    strip.col0 = MIN_VIEW_COLUMN(sheet);
+    strip.coli = MAX_VIEW_COLUMN(sheet);
+
+    if (dy > 0)  /* uncovered at the top */
+	strip.rowi = _gtk_sheet_row_from_ypixel(sheet, cells.y + dy - 1);
+    else if (dy < 0)  /* uncovered at the bottom */
+	strip.row0 = _gtk_sheet_row_from_ypixel(sheet,
+	    cells.y + cells.height + dy);
+
+    if (dx > 0)  /* uncovered at the left */
+	strip.coli = _gtk_sheet_column_from_xpixel(sheet, cells.x + dx - 1);
+    else if (dx < 0)  /* uncovered at the right */
+	strip.col0 = _gtk_sheet_column_from_xpixel(sheet,
+	    cells.x + cells.width + dx);
+
+    /* keep the strip inside the view, repainting one extra line 
+       when only the area beyond the last row or column was uncovered */
+    strip.row0 = CLAMP(strip.row0, MIN_VIEW_ROW(sheet), MAX_VIEW_ROW(sheet));
+    strip.rowi = CLAMP(strip.rowi, MIN_VIEW_ROW(sheet), MAX_VIEW_ROW(sheet));
+    strip.col0 = CLAMP(strip.col0, MIN_VIEW_COLUMN(sheet), MAX_VIEW_COLUMN(sheet));
+    strip.coli = CLAMP(strip.coli, MIN_VIEW_COLUMN(sheet), MAX_VIEW_COLUMN(sheet));
+
+    if (strip.row0 > strip.rowi || strip.col0 > strip.coli)
+	return (FALSE);
+
+#if GTK_SHEET_DEBUG_DRAW > 0
+    g_debug("_gtk_sheet_scroll_view: dx %d dy %d strip row %d - %d col %d - %d",
+	dx, dy, strip.row0, strip.rowi, strip.col0, strip.coli);
 #endif
 
-    GtkSheetCellAttr attributes;
-    gtk_sheet_get_attributes(sheet,
-	sheet->active_cell.row, sheet->active_cell.col,
-	&attributes);
+    gc = gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[GTK_STATE_NORMAL];
 
-    if (gtk_widget_get_realized(sheet->sheet_entry))
+    gdk_draw_pixmap(sheet->pixmap,
+	gc,
+	sheet->pixmap,
+	cells.x + MAX(-dx, 0), cells.y + MAX(-dy, 0),
+	cells.x + MAX(dx, 0), cells.y + MAX(dy, 0),
+	cells.width - ABS(dx), cells.height - ABS(dy));
+
+    _gtk_sheet_range_paint(sheet, &strip);
+
+    gdk_draw_pixmap(sheet->sheet_window,
+	gc,
+	sheet->pixmap,
+	cells.x, cells.y,
+	cells.x, cells.y,
+	cells.width, cells.height);
+
+    /* title buttons carrying widgets need a full reallocation */
+    if (dy && sheet->row_titles_visible)
     {
-	gtk_widget_size_request(sheet->sheet_entry, NULL);
+	if (_gtk_sheet_title_buttons_have_children(sheet, TRUE))
+	    size_allocate_row_title_buttons(sheet);
+	else
+	    gdk_window_scroll(sheet->row_title_window, 0, dy);
     }
-
-    if (GTK_IS_ITEM_ENTRY(entry_widget))
+    if (dx && sheet->column_titles_visible)
     {
-	entry_max_size = GTK_ITEM_ENTRY(entry_widget)->text_max_size;
+	if (_gtk_sheet_title_buttons_have_children(sheet, FALSE))
+	    _gtk_sheet_column_buttons_size_allocate(sheet);
+	else
+	    gdk_window_scroll(sheet->column_title_window, dx, 0);
     }
-    else
-	entry_max_size = 0;
-
-    row = sheet->active_cell.row;
-    col = sheet->active_cell.col;
 
-    text_width = 0;
-    text_height = 0;
+    if (sheet->state != GTK_SHEET_NORMAL &&
+	gtk_sheet_range_isvisible(sheet, sheet->range))
     {
-	gchar *text = gtk_sheet_get_entry_text(sheet);
-
-	if (text && text[0])
-	{
-	    _get_string_extent(sheet, 
-		 (0 <= col && col <= sheet->maxcol) ? COLPTR(sheet, col) : NULL,
-		attributes.font_desc, text, &text_width, &text_height);
-	}
+	gtk_sheet_range_draw_selection(sheet, sheet->view);
+    }
 
-	g_free(text);
+    if (sheet->state == GTK_STATE_NORMAL &&
+	_POINT_IN_RANGE(sheet->active_cell.row, sheet->active_cell.col, 
+	    &sheet->view))
+    {
+	gtk_sheet_show_active_cell(sheet);
     }
 
-    if (0 <= col && col <= sheet->maxcol)
-	column_width = COLPTR(sheet, col)->width;
-    else
-	column_width = GTK_SHEET_COLUMN_DEFAULT_WIDTH;
+    return (TRUE);
+}
 
-    if (0 <= row && row <= sheet->maxrow)
-	row_height = sheet->row[row].height;
-    else
-	row_height = GTK_SHEET_ROW_DEFAULT_HEIGHT;
+/*
+ * vadjustment_value_changed_handler:
+ * 
+ * this is the #GtkSheet vertical adjustment "value-changed" signal handler
+ * 
+ * @param adjustment the #GtkAdjustment that received the signal
+ * @param data       the #GtkSheet passed on signal creation
+ */
+static void
+_vadjustment_value_changed_handler(GtkAdjustment *adjustment, gpointer data)
+{
+    GtkSheet *sheet;
+    gint old_value, old_offset;
 
-    size = MIN(text_width, entry_max_size);
-    size = MAX(size, column_width - 2 * CELLOFFSET);
+    g_return_if_fail(adjustment != NULL);
+    g_return_if_fail(data != NULL);
+    g_return_if_fail(GTK_IS_SHEET(data));
 
-    shentry_allocation.x = _gtk_sheet_column_left_xpixel(sheet, col);
-    shentry_allocation.y = _gtk_sheet_row_top_ypixel(sheet, row);
-    shentry_allocation.width = column_width;
-    shentry_allocation.height = row_height;
+    sheet = GTK_SHEET(data);
 
-    if (GTK_IS_ITEM_ENTRY(sheet->sheet_entry))
-    {
-#if GTK_SHEET_DEBUG_SIZE > 0
-	g_debug("_gtk_sheet_entry_size_allocate: is_item_entry");
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
+    g_debug("_vadjustment_value_changed_handler: called: O VA %g VO %d ar %d ac %d",
+            sheet->old_vadjustment, sheet->voffset,
+            sheet->active_cell.row, sheet->active_cell.col); 
 #endif
 
-	shentry_allocation.height -= 2 * CELLOFFSET;
-	shentry_allocation.y += CELLOFFSET;
+    if (GTK_SHEET_IS_FROZEN(sheet))
+	return;
 
-	if (gtk_sheet_clip_text(sheet))
-	    shentry_allocation.width = column_width - 2 * CELLOFFSET;
-	else  /* text extends multiple cells */
-	    shentry_allocation.width = size;
+    old_offset = sheet->voffset;
 
-	switch(GTK_ITEM_ENTRY(entry_widget)->justification)
-	{
-	    case GTK_JUSTIFY_CENTER:
-		shentry_allocation.x += (column_width) / 2 - size / 2;
-		break;
+#if 0
+    if (sheet->column_titles_visible)
+	row = _gtk_sheet_row_from_ypixel(sheet, sheet->column_title_area.height + CELL_SPACING);
+    else
+	row = _gtk_sheet_row_from_ypixel(sheet, CELL_SPACING);
 
-	    case GTK_JUSTIFY_RIGHT:
-		shentry_allocation.x += column_width - size;
-		break;
+    old_value = -sheet->voffset;
 
-	    case GTK_JUSTIFY_LEFT:
-	    case GTK_JUSTIFY_FILL:
-		shentry_allocation.x += CELLOFFSET;
-		break;
-	}
+    for (i = 0; i < sheet->maxrow; i++)  /* all but the last row */
+    {
+	if (GTK_SHEET_ROW_IS_VISIBLE(sheet, i))
+	    y += ROW_HEIGHT(sheet, i);
+	if (y > gtk_adjustment_get_value(adjustment))
+	    break;
+    }
+    if (0 <= i && i <= sheet->maxrow)
+	y -= ROW_HEIGHT(sheet, i);
+    new_row = i;
 
-	/* vertical justification */
+    y = MAX(y, 0);
+
+#if 0
+    if (adjustment->value > sheet->old_vadjustment && sheet->old_vadjustment > 0. &&
+	0 <= new_row && new_row <= sheet->maxrow &&
+	ROW_HEIGHT(sheet, new_row) > sheet->vadjustment->step_increment)
+    {
+	/* This avoids embarrassing twitching */
+	if (row == new_row && row != sheet->maxrow &&
+	    adjustment->value - sheet->old_vadjustment >=
+	    sheet->vadjustment->step_increment &&
+	    new_row + 1 != MIN_VISIBLE_ROW(sheet))
 	{
-	    gint x, y, width, height;
+	    new_row+=1;
+	    y=y+ROW_HEIGHT(sheet, row);
+	}
+    }
+#else
+    if (gtk_adjustment_get_value(adjustment) > sheet->old_vadjustment && sheet->old_vadjustment > 0. &&
+	0 <= new_row && new_row <= sheet->maxrow &&
+	ROW_HEIGHT(sheet, new_row) > gtk_adjustment_get_step_increment(sheet->vadjustment))
+    {
+	new_row += 1;
+	y = y + ROW_HEIGHT(sheet, row);
+    }
+#endif
 
-	    _get_entry_window_size(GTK_ENTRY(entry_widget), &x, &y, &width, &height);
+    /* Negative old_adjustment enforces the redraw, otherwise avoid spureous redraw */
+    if (sheet->old_vadjustment >= 0. && row == new_row)
+    {
+	sheet->old_vadjustment = gtk_adjustment_get_value(sheet->vadjustment);
 
-#if GTK_SHEET_DEBUG_SIZE>0
-	    g_debug("_gtk_sheet_entry_size_allocate: get_widget_window_size (%d, %d, %d, %d)",
-		x, y, width, height);
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
+	g_debug("_vadjustment_value_changed_handler: return 1: vv %g",
+	    sheet->old_vadjustment);
 #endif
+	return;
+    }
 
-	    switch(sheet->vjust)
-	    {
-		case GTK_SHEET_VERTICAL_JUSTIFICATION_DEFAULT:
-		case GTK_SHEET_VERTICAL_JUSTIFICATION_TOP:
-		    shentry_allocation.height = height;
-		    break;
-
-		case GTK_SHEET_VERTICAL_JUSTIFICATION_MIDDLE:
-		    shentry_allocation.height = shentry_allocation.height / 2;
-		    break;
+    sheet->old_vadjustment = gtk_adjustment_get_value(sheet->vadjustment);
+    gtk_adjustment_set_value(adjustment, y);
 
-		case GTK_SHEET_VERTICAL_JUSTIFICATION_BOTTOM:
-		    break;
-	    }
-	}
+    if (new_row < 0 || new_row > sheet->maxrow)
+    {
+	gtk_adjustment_set_step_increment(sheet->vadjustment, 
+	    GTK_SHEET_ROW_DEFAULT_HEIGHT);
     }
-    else if ( GTK_IS_DATA_TEXT_VIEW(sheet->sheet_entry)
-	     || GTK_IS_TEXT_VIEW(sheet->sheet_entry) )
+    else if (new_row == 0)
     {
-#if GTK_SHEET_DEBUG_SIZE > 0
-	g_debug("_gtk_sheet_entry_size_allocate: is_text_view");
-#endif
+	gtk_adjustment_set_step_increment(sheet->vadjustment, 
+	    ROW_HEIGHT(sheet, 0));
+    }
+    else
+    {
+	gtk_adjustment_set_step_increment(sheet->vadjustment,
+	    MIN(ROW_HEIGHT(sheet, new_row), ROW_HEIGHT(sheet, new_row - 1)));
+    }
 
-	shentry_allocation.height -= 2 * CELLOFFSET;
-	shentry_allocation.y += CELLOFFSET;
-	shentry_allocation.x += CELLOFFSET;
+    value = gtk_adjustment_get_value(adjustment);
+    gtk_adjustment_set_value(sheet->vadjustment, value);
 
-	if (gtk_sheet_clip_text(sheet))
-	    shentry_allocation.width = column_width - 2 * CELLOFFSET;
-	else  /* text extends multiple cells */
-	    shentry_allocation.width = size;
+    if (value >= -sheet->voffset)
+    {
+	/* scroll down */
+	diff = value + sheet->voffset;
     }
     else
     {
-	shentry_allocation.x += 2;
-	shentry_allocation.y += 2;
-	shentry_allocation.width -= MIN(shentry_allocation.width, 3);
-	shentry_allocation.height -= MIN(shentry_allocation.height, 3);
+	/* scroll up */
+	diff = -sheet->voffset - value;
     }
 
-#if 0
-    /* the following works with most widgets, but looks funny */
-    gtk_widget_set_size_request(sheet->sheet_entry,
-				shentry_allocation.width, shentry_allocation.height);
-#endif
+    sheet->voffset = -value;
+#else
+    /* Negative old_adjustment enforces the redraw, otherwise avoid spureous redraw */
+    old_value = sheet->old_vadjustment;
+    sheet->old_vadjustment = gtk_adjustment_get_value(sheet->vadjustment);
 
-#if GTK_SHEET_DEBUG_SIZE >0
-    g_debug("_gtk_sheet_entry_size_allocate: allocate (%d,%d,%d,%d)",
-	shentry_allocation.x, shentry_allocation.y, shentry_allocation.width, shentry_allocation.height);
+    if (old_value >= 0. && sheet->voffset == -1 *  gtk_adjustment_get_value(adjustment))
+	return;
+
+    gdouble value = gtk_adjustment_get_value(adjustment);
+    gtk_adjustment_set_value(sheet->vadjustment, value);
+    sheet->voffset = -value;
 #endif
 
-    gtk_widget_size_allocate(sheet->sheet_entry, &shentry_allocation);
+    _gtk_sheet_recalc_view_range(sheet);
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("_gtk_sheet_entry_size_allocate: returned (%d,%d,%d,%d)",
-	shentry_allocation.x, shentry_allocation.y, shentry_allocation.width, shentry_allocation.height);
-#endif
-}
+    if (gtk_widget_get_realized(sheet->sheet_entry) &&
+	sheet->state == GTK_SHEET_NORMAL &&
+	sheet->active_cell.row >= 0 && sheet->active_cell.col >= 0 &&
+	!gtk_sheet_cell_isvisible(sheet, sheet->active_cell.row, sheet->active_cell.col))
+    {
+        /* PR#211566 - removed gtk_sheet_cell_clear() */
+	gtk_widget_unmap(sheet->sheet_entry);
+    }
 
-#if GTK_SHEET_DEBUG_FINALIZE > 0
-/* obj_ref debug code */
-static void weak_notify(gpointer data, GObject *o)
-{
-    gchar *msg = data;  /* assume a string was passed as data */
 
-    g_debug("weak_notify: %p finalized (%s)", o, msg ? msg : "");
+    gtk_sheet_position_children(sheet);
+
+    size_allocate_global_button(sheet);
+
+    /* negative old_value enforces a full redraw */
+    if (old_value >= 0
+	&& _gtk_sheet_scroll_view(sheet, 0, sheet->voffset - old_offset))
+	return;
+
+    size_allocate_row_title_buttons(sheet);
+
+    _gtk_sheet_range_draw(sheet, &sheet->view, TRUE);  /* keeps tiles */
 }
-#endif
 
+/*
+ * hadjustment_value_changed_handler:
+ * 
+ * this is the #GtkSheet horizontal adjustment "value-changed" handler
+ * 
+ * @param adjustment the #GtkAdjustment that received the signal
+ * @param data       the #GtkSheet passed on signal creation
+ */
 static void
-gtk_sheet_entry_set_max_size(GtkSheet *sheet)
+_hadjustment_value_changed_handler(GtkAdjustment *adjustment, gpointer data)
 {
-    gint i;
-    gint size = 0;
-    gint sizel = 0, sizer = 0;
-    gint row, col;
-    GtkJustification justification;
+    GtkSheet *sheet;
+    gint old_value, old_offset;
 
-    row = sheet->active_cell.row;
-    col = sheet->active_cell.col;
+    g_return_if_fail(adjustment != NULL);
+    g_return_if_fail(data != NULL);
+    g_return_if_fail(GTK_IS_SHEET(data));
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("gtk_sheet_entry_set_max_size: called");
+    sheet = GTK_SHEET(data);
+
+#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
+    g_debug("_hadjustment_value_changed_handler: called: O HA %g HO %d",
+	sheet->old_hadjustment, sheet->hoffset);
 #endif
 
-    if (!GTK_IS_ITEM_ENTRY(sheet->sheet_entry) || gtk_sheet_clip_text(sheet))
+    if (GTK_SHEET_IS_FROZEN(sheet))
 	return;
 
-    justification = GTK_ITEM_ENTRY(sheet->sheet_entry)->justification;
+    old_offset = sheet->hoffset;
 
-    switch(justification)
+#if 0
+    if (sheet->row_titles_visible) col = _gtk_sheet_column_from_xpixel(sheet, sheet->row_title_area.width + CELL_SPACING);
+    else
+    col = _gtk_sheet_column_from_xpixel(sheet, CELL_SPACING);
+
+    old_value = -sheet->hoffset;
+
+    for (i = 0; i < sheet->maxcol; i++)  /* all but the last column */
     {
-	case GTK_JUSTIFY_FILL:
-	case GTK_JUSTIFY_LEFT:
-	    for (i = col + 1; i <= MAX_VIEW_COLUMN(sheet) && i <= sheet->maxcol; i++)
-	    {
-		if (gtk_sheet_cell_get_text(sheet, row, i))
-		    break;
+	if (GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, i))) x += COLPTR(sheet, i)->width;
+	if (x > adjustment->value) break;
+    }
+    if (0 <= i && i <= sheet->maxcol) x -= COLPTR(sheet, i)->width;
+    new_col = i;
 
-		size += COLPTR(sheet, i)->width;
-	    }
-	    size = MIN(size, sheet->sheet_window_width - _gtk_sheet_column_left_xpixel(sheet, col));
-	    break;
+    x = MAX(x, 0);
 
-	case GTK_JUSTIFY_RIGHT:
-	    for (i = col - 1; i >= MIN_VIEW_COLUMN(sheet); i--)
-	    {
-		if (gtk_sheet_cell_get_text(sheet, row, i))
-		    break;
+#if 0
+    if (adjustment->value > sheet->old_hadjustment && sheet->old_hadjustment > 0 &&
+	0 <= new_col && new_col <= sheet->maxcol &&
+	COLPTR(sheet, new_col)->width > sheet->hadjustment->step_increment)
+    {
+	/* This avoids embarrassing twitching */
+	if (col == new_col && col != sheet->maxcol &&
+	    adjustment->value - sheet->old_hadjustment >=
+	    sheet->hadjustment->step_increment &&
+	    new_col + 1 != MIN_VISIBLE_COLUMN(sheet))
+	{
+	    new_col+=1;
+	    x=x+COLPTR(sheet, col)->width;
+	}
+    }
+#else
+    if (adjustment->value > sheet->old_hadjustment && sheet->old_hadjustment > 0 &&
+	0 <= new_col && new_col <= sheet->maxcol &&
+	COLPTR(sheet, new_col)->width > sheet->hadjustment->step_increment)
+    {
+	new_col += 1;
+	x = x + COLPTR(sheet, col)->width;
+    }
+#endif
 
-		if (i < 0 || i > sheet->maxcol)
-		    continue;
-		size += COLPTR(sheet, i)->width;
-	    }
-	    break;
+    /* Negative old_adjustment enforces the redraw, otherwise avoid spureous redraw */
+    if (sheet->old_hadjustment >= 0. && new_col == col)
+    {
+	sheet->old_hadjustment = sheet->hadjustment->value;
+	return;
+    }
 
-	case GTK_JUSTIFY_CENTER:
-	    for (i = col + 1; i <= MAX_VIEW_COLUMN(sheet) && i <= sheet->maxcol; i++)
-	    {
-		/* if (gtk_sheet_cell_get_text(sheet, row, i)) break; */
+    sheet->old_hadjustment = sheet->hadjustment->value;
+    adjustment->value = x;
 
-		sizer += COLPTR(sheet, i)->width;
-	    }
-	    for (i = col - 1; i >= MIN_VIEW_COLUMN(sheet); i--)
-	    {
-		if (gtk_sheet_cell_get_text(sheet, row, i))
-		    break;
+    if (new_col < 0 || new_col > sheet->maxcol)
+    {
+	sheet->hadjustment->step_increment = GTK_SHEET_COLUMN_DEFAULT_WIDTH;
+    }
+    else if (new_col == 0)
+    {
+	sheet->hadjustment->step_increment = COLPTR(sheet, 0)->width;
+    }
+    else
+    {
+	sheet->hadjustment->step_increment =
+	MIN(COLPTR(sheet, new_col)->width, COLPTR(sheet, new_col - 1)->width);
+    }
 
-		if (i < 0 || i > sheet->maxcol)
-		    continue;
-		sizel += COLPTR(sheet, i)->width;
-	    }
-	    size = 2 * MIN(sizel, sizer);
-	    break;
+    sheet->hadjustment->value = adjustment->value;
+    value = adjustment->value;
+
+    if (value >= -sheet->hoffset)
+    {
+	/* scroll right */
+	diff = value + sheet->hoffset;
     }
+    else
+    {
+	/* scroll left */
+	diff = -sheet->hoffset - value;
+    }
+
+    sheet->hoffset = -value;
+#else
+    /* Negative old_adjustment enforces the redraw, otherwise avoid spureous redraw */
+    old_value = sheet->old_hadjustment;
+    sheet->old_hadjustment = gtk_adjustment_get_value(sheet->hadjustment);
+
+    if (old_value >= 0. && sheet->hoffset == -1 *  gtk_adjustment_get_value(adjustment))
+	return;
+
+    gdouble value = gtk_adjustment_get_value(adjustment);
+    gtk_adjustment_set_value(sheet->hadjustment, value);
+    sheet->hoffset = -value;
+#endif
+
+    _gtk_sheet_recalc_view_range(sheet);
+
+    if (gtk_widget_get_realized(sheet->sheet_entry) &&
+	sheet->state == GTK_SHEET_NORMAL &&
+	sheet->active_cell.row >= 0 && sheet->active_cell.col >= 0 &&
+	!gtk_sheet_cell_isvisible(sheet, sheet->active_cell.row, sheet->active_cell.col))
+    {
+        /* PR#211566 - removed gtk_sheet_cell_clear() */
+	gtk_widget_unmap(sheet->sheet_entry);
+    }
+
+    gtk_sheet_position_children(sheet);
 
-    if (size != 0)
-	size += COLPTR(sheet, col)->width;
-    GTK_ITEM_ENTRY(sheet->sheet_entry)->text_max_size = size;
-}
+    size_allocate_global_button(sheet);
 
-static gboolean sheet_entry_focus_in_handler(GtkWidget *widget,
-    GdkEventFocus *event, gpointer user_data)
-{
-    gboolean retval = FALSE;
-    g_signal_emit(GTK_OBJECT(widget),
-	sheet_signals[ENTRY_FOCUS_IN], 0, event, &retval);
-    return (retval);
-}
+    /* negative old_value enforces a full redraw */
+    if (old_value >= 0
+	&& _gtk_sheet_scroll_view(sheet, sheet->hoffset - old_offset, 0))
+	return;
 
-static gboolean sheet_entry_focus_out_handler(GtkWidget *widget,
-    GdkEventFocus *event, gpointer user_data)
-{
-    gboolean retval = FALSE;
-    g_signal_emit(GTK_OBJECT(widget),
-	sheet_signals[ENTRY_FOCUS_OUT], 0, event, &retval);
-    return (retval);
+    _gtk_sheet_column_buttons_size_allocate(sheet);
+
+    _gtk_sheet_range_draw(sheet, &sheet->view, TRUE);  /* keeps tiles */
 }
 
-static void sheet_entry_populate_popup_handler(GtkWidget *widget,
-    GtkMenu *menu, gpointer user_data)
+
+/* COLUMN RESIZING */
+static void
+draw_xor_vline(GtkSheet *sheet)
 {
-#if GTK_SHEET_DEBUG_SIGNALS > 0
-    g_debug("sheet_entry_populate_popup_handler: menu %p", menu);
-#endif
+    GtkWidget *widget;
 
-    g_signal_emit(GTK_OBJECT(widget),
-	sheet_signals[ENTRY_POPULATE_POPUP], 0, menu);
+    g_return_if_fail(sheet != NULL);
+
+    widget = GTK_WIDGET(sheet);
+
+    gdk_draw_line(gtk_widget_get_window(widget), sheet->xor_gc,
+	sheet->x_drag,
+	sheet->column_title_area.height,
+	sheet->x_drag,
+	sheet->sheet_window_height + 1);
 }
 
+/* ROW RESIZING */
 static void
-create_sheet_entry(GtkSheet *sheet, GType new_entry_type)
+draw_xor_hline(GtkSheet *sheet)
 {
     GtkWidget *widget;
-    GtkWidget * entry, *new_entry;
-    GtkStyle *style;
+
+    g_return_if_fail(sheet != NULL);
 
     widget = GTK_WIDGET(sheet);
 
-#if GTK_SHEET_DEBUG_ENTRY > 0
-    g_debug("create_sheet_entry: called");
-#endif
+    gdk_draw_line(gtk_widget_get_window(widget), sheet->xor_gc,
+	sheet->row_title_area.width,
+	sheet->y_drag,
+	sheet->sheet_window_width + 1,
+	sheet->y_drag);
+}
 
-    style = gtk_style_copy(gtk_widget_get_style(GTK_WIDGET(sheet)));
+/* SELECTED RANGE */
+static void
+draw_xor_rectangle(GtkSheet *sheet, GtkSheetRange range)
+{
+    gint i;
+    GdkRectangle clip_area, area;
+    GdkGCValues values;
 
-    if (sheet->sheet_entry)
+    if (range.col0 < 0 || range.coli < 0 || range.row0 < 0 || range.rowi < 0)
+	return;  /* PR#203012 */
+
+    area.x = _gtk_sheet_column_left_xpixel(sheet, range.col0);
+    area.y = _gtk_sheet_row_top_ypixel(sheet, range.row0);
+    area.width = _gtk_sheet_column_left_xpixel(sheet, range.coli) - area.x +
+	COLPTR(sheet, range.coli)->width;
+    area.height = _gtk_sheet_row_top_ypixel(sheet, range.rowi) - area.y +
+	ROW_HEIGHT(sheet, range.rowi);
+
+    clip_area.x = sheet->row_title_area.width;
+    clip_area.y = sheet->column_title_area.height;
+    clip_area.width = sheet->sheet_window_width;
+    clip_area.height = sheet->sheet_window_height;
+
+    if (!sheet->row_titles_visible)
+	clip_area.x = 0;
+    if (!sheet->column_titles_visible)
+	clip_area.y = 0;
+
+    if (area.x < 0)
     {
-	/* avoids warnings */
-	g_object_ref(sheet->sheet_entry);
-	gtk_widget_unparent(sheet->sheet_entry);
-#if GTK_SHEET_DEBUG_ENTRY > 0
-	g_debug("create_sheet_entry: destroying old entry %p", sheet->sheet_entry);
-#endif
-	gtk_widget_destroy(sheet->sheet_entry);
-	sheet->sheet_entry = NULL;
+	area.width = area.width + area.x;
+	area.x = 0;
+    }
+    if (area.width > clip_area.width)
+	area.width = clip_area.width + 10;
+    if (area.y < 0)
+    {
+	area.height = area.height + area.y;
+	area.y = 0;
     }
+    if (area.height > clip_area.height)
+	area.height = clip_area.height + 10;
 
-    if (new_entry_type == G_TYPE_NONE) new_entry_type = G_TYPE_ITEM_ENTRY;
+    clip_area.x--;
+    clip_area.y--;
+    clip_area.width += 3;
+    clip_area.height += 3;
 
-#if GTK_SHEET_DEBUG_ENTRY > 0
-	g_debug("create_sheet_entry: new_entry type %s", 
-	    g_type_name(new_entry_type));
-#endif
+    gdk_gc_get_values(sheet->xor_gc, &values);
 
-    new_entry = gtk_widget_new(new_entry_type, NULL);
+    gdk_gc_set_clip_rectangle(sheet->xor_gc, &clip_area);
 
-#if GTK_SHEET_DEBUG_ENTRY > 0
-	g_debug("create_sheet_entry: got new_entry %p", new_entry);
-#endif
+    for (i = -1; i <= 1; ++i) gdk_draw_rectangle(sheet->sheet_window,
+	    sheet->xor_gc,
+	    FALSE,
+	    area.x + i, area.y + i,
+	    area.width - 2 * i, area.height - 2 * i);
 
-    /* connect focus signal propagation handlers */
-    g_signal_connect_swapped(new_entry, "focus-in-event",
-	G_CALLBACK(sheet_entry_focus_in_handler), sheet);
-    g_signal_connect_swapped(new_entry, "focus-out-event",
-	G_CALLBACK(sheet_entry_focus_out_handler), sheet);
 
-    if (GTK_IS_ENTRY(new_entry) 
-	|| GTK_IS_DATA_TEXT_VIEW(new_entry) 
-	|| GTK_IS_TEXT_VIEW(new_entry))
-    {
-	g_signal_connect_swapped(new_entry, "populate-popup",
-	    G_CALLBACK(sheet_entry_populate_popup_handler), sheet);
-    }
+    gdk_gc_set_clip_rectangle(sheet->xor_gc, NULL);
 
-    sheet->installed_entry_type = new_entry_type;
-    sheet->sheet_entry = new_entry;
-    entry = gtk_sheet_get_entry(sheet);
+    gdk_gc_set_foreground(sheet->xor_gc, &values.foreground);
+}
 
-    if (!entry)  /* this was an unsupported entry type */
-    {
-	g_warning("Unsupported entry type - widget must contain an GtkEditable or GtkTextView");
-	gtk_widget_destroy(new_entry);
 
-	new_entry = gtk_item_entry_new();
-	sheet->sheet_entry = new_entry;
-	sheet->installed_entry_type = G_TYPE_ITEM_ENTRY;
-    }
-    g_object_ref_sink(sheet->sheet_entry);
+/* this function returns the new width of the column being resized given
+ * the column and x position of the cursor; the x cursor position is passed
+ * in as a pointer and automaticaly corrected if it's beyond min/max limits */
 
-#if GTK_SHEET_DEBUG_FINALIZE > 0
-    g_object_weak_ref(G_OBJECT(sheet->sheet_entry), weak_notify, "Sheet-Entry");
+static guint
+new_column_width(GtkSheet *sheet, gint col, gint *x)
+{
+    gint cx, width;
+    GtkRequisition requisition;
+
+#if GTK_SHEET_DEBUG_SIZE > 0
+    g_debug("new_column_width: called");
 #endif
 
-    if (gtk_widget_get_realized(GTK_WIDGET(sheet)))
-    {
-	gtk_widget_size_request(sheet->sheet_entry, NULL);
+    cx = *x;
 
-#if GTK_SHEET_DEBUG_ENTRY > 0
-	g_debug("create_sheet_entry: sheet was realized");
-#endif
-	gtk_widget_set_parent_window(sheet->sheet_entry, sheet->sheet_window);
-	gtk_widget_set_parent(sheet->sheet_entry, GTK_WIDGET(sheet));
-	gtk_widget_realize(sheet->sheet_entry);
+    requisition.width = COLPTR(sheet, col)->requisition;
+
+    /* you can't shrink a column to less than its minimum width */
+    if (cx < _gtk_sheet_column_left_xpixel(sheet, col) + requisition.width)
+    {
+	*x = cx = _gtk_sheet_column_left_xpixel(sheet, col) + requisition.width;
     }
 
-    g_signal_connect_swapped(GTK_OBJECT(entry), "key_press_event",
-	(void *)gtk_sheet_entry_key_press_handler,
-	GTK_OBJECT(sheet));
+    /* don't grow past the end of the window */
+    /*
+    if (cx > sheet->sheet_window_width)
+      {
+    *x = cx = sheet->sheet_window_width;
+      }
+      */
 
-    gtk_widget_show(sheet->sheet_entry);
-}
+    /* calculate new column width making sure it doesn't end up
+     * less than the minimum width */
+    width = cx - _gtk_sheet_column_left_xpixel(sheet, col);
+    if (width < requisition.width)
+	width = requisition.width;
 
+    COLPTR(sheet, col)->width = width;
+    _gtk_sheet_column_geometry_changed(sheet, col);
+    _gtk_sheet_recalc_view_range(sheet);
 
-/**
- * gtk_sheet_get_entry_type:
- * @sheet: a #GtkSheet
- *
- * Get sheets entry type, if known
- *
- * Returns: a #GtkSheetEntryType or GTK_SHEET_ENTRY_TYPE_DEFAULT
- */
-GType
-gtk_sheet_get_entry_type(GtkSheet *sheet)
-{
-    g_return_val_if_fail(sheet, GTK_SHEET_ENTRY_TYPE_DEFAULT);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), GTK_SHEET_ENTRY_TYPE_DEFAULT);
+    _gtk_sheet_column_buttons_size_allocate(sheet);
 
-    return (sheet->entry_type);
+    return (width);
 }
 
-/**
- * gtk_sheet_get_entry:
- * @sheet: a #GtkSheet
- *
- * Get sheet's entry widget. 
- *  
- * If the entry widget is a container, the direct childs of the 
- * container are searched for a valid entry widget. If you want
- * the container itself to be returned, you should use 
- * #gtk_sheet_get_entry_widget() instead. 
- *
- * Returns: (transfer none) a #GtkWidget or NULL
- */
-GtkWidget *
-gtk_sheet_get_entry(GtkSheet *sheet)
-{
-    GtkWidget *parent;
-    GtkWidget *entry = NULL;
-    GtkTableChild *table_child;
-    GtkBoxChild *box_child;
-    GList *children = NULL;
-
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
-
-    if (!sheet->sheet_entry)   /* PR#102114 */
-	return(NULL);
-    
-    if (GTK_IS_EDITABLE(sheet->sheet_entry))
-	return (sheet->sheet_entry);
-    if (GTK_IS_DATA_TEXT_VIEW(sheet->sheet_entry))
-	return (sheet->sheet_entry);
-    if (GTK_IS_TEXT_VIEW(sheet->sheet_entry))
-	return (sheet->sheet_entry);
+/* this function returns the new height of the row being resized given
+ * the row and y position of the cursor; the y cursor position is passed
+ * in as a pointer and automaticaly corrected if it's beyond min/max limits */
 
-    parent = GTK_WIDGET(sheet->sheet_entry);
+static guint
+new_row_height(GtkSheet *sheet, gint row, gint *y)
+{
+    GtkRequisition requisition;
+    GtkSheetRow *rowp;
+    gint cy, height;
 
-    if (GTK_IS_TABLE(parent))
-	children = GTK_TABLE(parent)->children;
-    if (GTK_IS_BOX(parent))
-	children = GTK_BOX(parent)->children;
+    cy = *y;
 
-    if (!children)
-	return (NULL);
+    rowp = _gtk_sheet_row_peek(sheet, row);
+    requisition.height = rowp ?
+	rowp->requisition : _gtk_sheet_row_default_height(GTK_WIDGET(sheet));
 
-    while (children)
+    /* you can't shrink a row to less than its minimum height */
+    if (cy < _gtk_sheet_row_top_ypixel(sheet, row) + requisition.height)
     {
-	if (GTK_IS_TABLE(parent))
-	{
-	    table_child = children->data;
-	    entry = table_child->widget;
-	}
+	*y = cy = _gtk_sheet_row_top_ypixel(sheet, row) + requisition.height;
+    }
 
-	if (GTK_IS_BOX(parent))
-	{
-	    box_child = children->data;
-	    entry = box_child->widget;
-	}
+    /* don't grow past the end of the window */
+    /*
+    if (cy > sheet->sheet_window_height)
+      {
+    *y = cy = sheet->sheet_window_height;
+      }
+      */
 
-	if (GTK_IS_EDITABLE(entry))
-	    return (entry);
-	if (GTK_IS_DATA_TEXT_VIEW(entry))
-	    return (entry);
-	if (GTK_IS_TEXT_VIEW(entry))
-	    return (entry);
+    /* calculate new row height making sure it doesn't end up
+     * less than the minimum height */
+    height = (cy - _gtk_sheet_row_top_ypixel(sheet, row));
+    if (height < requisition.height)
+	height = requisition.height;
 
-	children = children->next;
-    }
+    ROW_SET_HEIGHT(sheet, row, height);
+    _gtk_sheet_row_geometry_changed(sheet, row);
+    _gtk_sheet_recalc_view_range(sheet);
 
-    return (NULL);
+    size_allocate_row_title_buttons(sheet);
+
+    return (height);
 }
 
+
 /**
- * gtk_sheet_get_entry_widget:
- * @sheet: a #GtkSheet
- *
- * Get sheet's entry widget. 
- *  
- * If the entry widget is a container, the container widget is 
- * returned. In order to get the entry in the container child, 
- * you might want to use #gtk_sheet_get_entry() instead. 
+ * gtk_sheet_set_row_height:
+ * @sheet: a #GtkSheet.
+ * @row: row number.
+ * @height: row height(in pixels).
  *
- * Returns: (transfer none) a #GtkWidget or NULL
+ * Set row height.
  */
-GtkWidget *
-gtk_sheet_get_entry_widget(GtkSheet *sheet)
+void
+gtk_sheet_set_row_height(GtkSheet *sheet, gint row, guint height)
 {
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
-    g_return_val_if_fail(sheet->sheet_entry != NULL, NULL);
+    guint min_height;
 
-    return (sheet->sheet_entry);
-}
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-/**
- * gtk_sheet_get_entry_text:
- * @sheet: a #GtkSheet
- *
- * Get the text out of the sheet_entry. 
- *  
- * This function is mainly used to synchronize the text of a 
- * second entry with the sheet_entry. 
- *  
- * This function is necessary, because not all possible entry 
- * widgets implement the GtkEditable interface yet. 
- *
- * Returns: a copy of the sheet_entry text or NULL. This 
- * function returns an allocated string, so g_free() it after 
- * usage! 
- */
-gchar *gtk_sheet_get_entry_text(GtkSheet *sheet)
-{
-    gchar *text = NULL;
-    GtkWidget *entry = NULL;
+    if (row < 0 || row > sheet->maxrow)
+	return;
 
-    g_return_val_if_fail(sheet != NULL, NULL);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), NULL);
+    gtk_sheet_row_size_request(sheet, row, &min_height);
 
-#if GTK_SHEET_DEBUG_SET_ENTRY_TEXT > 0
-	g_debug("gtk_sheet_get_entry_text[%p]", sheet);
-#endif
+    if (height < min_height) height = min_height;
 
-    if (!sheet->sheet_entry)   /* PR#102114 */
-	return(NULL);
+    ROW_SET_HEIGHT(sheet, row, height);
 
-    entry = gtk_sheet_get_entry(sheet);
-    g_return_val_if_fail(entry != NULL, NULL);
+    _gtk_sheet_row_geometry_changed(sheet, row);
 
-    if (GTK_IS_EDITABLE(entry))
-    {
-	text = gtk_editable_get_chars(GTK_EDITABLE(entry), 0, -1);
-    }
-    else if ( GTK_IS_DATA_TEXT_VIEW(entry) 
-	     || GTK_IS_TEXT_VIEW(entry) )
-    {
-	GtkTextIter start, end;
-	GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(entry));
-	gtk_text_buffer_get_bounds(buffer, &start, &end);
-	text = gtk_text_buffer_get_text(buffer, &start, &end, TRUE);
-    }
-    else
+    if (gtk_widget_get_realized(GTK_WIDGET(sheet)) 
+        && !GTK_SHEET_IS_FROZEN(sheet))
     {
-	g_warning("gtk_sheet_get_entry_text: no GTK_EDITABLE, don't know how to get the text.");
+	size_allocate_row_title_buttons(sheet);
+	_gtk_sheet_scrollbar_adjust(sheet);
+	_gtk_sheet_entry_size_allocate(sheet);
+	_gtk_sheet_range_draw(sheet, NULL, TRUE);
     }
 
-#if GTK_SHEET_DEBUG_SET_ENTRY_TEXT > 0
-	g_debug("gtk_sheet_get_entry_text[%p] returns <%s>", 
-                sheet, text);
-#endif
-
-    return (text);
+    g_signal_emit(GTK_OBJECT(sheet), 
+                  sheet_signals[NEW_ROW_HEIGHT], 0, row, height);
 }
 
 /**
- * gtk_sheet_set_entry_text:
- * @sheet: a #GtkSheet 
- * @text: the text to be set or NULL 
+ * gtk_sheet_add_column:
+ * @sheet: a #GtkSheet.
+ * @ncols: number of columns to be appended.
  *
- * Set the text in the sheet_entry (and active cell).
- *  
- * This function is mainly used to synchronize the text of a 
- * second entry with the sheet_entry.
- *  
- * This function is necessary, because not all possible entry 
- * widgets implement the GtkEditable interface yet. 
+ * Append @ncols columns to the right of the sheet.
  */
-void gtk_sheet_set_entry_text(GtkSheet *sheet, const gchar *text)
+void
+gtk_sheet_add_column(GtkSheet *sheet, guint ncols)
 {
-    GtkWidget *entry = NULL;
 
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-#if GTK_SHEET_DEBUG_SET_ENTRY_TEXT > 0
-	g_debug("gtk_sheet_set_entry_text[%p] = <%s>", 
-                sheet, text);
-#endif
+    AddColumns(sheet, sheet->maxcol + 1, ncols);
 
-    if (!sheet->sheet_entry)   /* PR#102114 */
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
 	return;
 
-    entry = gtk_sheet_get_entry(sheet);
-    g_return_if_fail(entry != NULL);
+    _gtk_sheet_scrollbar_adjust(sheet);
 
-    if (GTK_IS_EDITABLE(entry))
-    {
-	gint position = 0;
-	gtk_editable_delete_text(GTK_EDITABLE(entry), 0, -1);
-	gtk_editable_insert_text(GTK_EDITABLE(entry), text, -1, &position);
-    }
-    else if ( GTK_IS_DATA_TEXT_VIEW(entry) 
-	     || GTK_IS_TEXT_VIEW(entry) )
-    {
-	GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(entry));
-	GtkTextIter iter;
+    if (sheet->state == GTK_SHEET_ROW_SELECTED)
+	sheet->range.coli += ncols;
 
-	gtk_text_buffer_set_text(buffer, text, -1);
+    _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
+}
 
-	gtk_text_buffer_get_start_iter(buffer, &iter);
-	gtk_text_buffer_place_cursor(buffer, &iter);
-    }
-    else
-    {
-	g_warning("gtk_sheet_set_entry_text: no GTK_EDITABLE, don't know how to set the text.");
-    }
+/**
+ * gtk_sheet_add_row:
+ * @sheet: a #GtkSheet.
+ * @nrows: number of rows to be appended.
+ *
+ * Append @nrows rows to the end of the sheet.
+ */
+void
+gtk_sheet_add_row(GtkSheet *sheet, guint nrows)
+{
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-#if GTK_SHEET_DEBUG_SET_ENTRY_TEXT > 0
-	g_debug("gtk_sheet_set_entry_text[%p] done", sheet);
-#endif
+    AddRows(sheet, sheet->maxrow + 1, nrows);
+
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+
+    if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
+	sheet->range.rowi += nrows;
+
+    _gtk_sheet_scrollbar_adjust(sheet);
+
+    _gtk_sheet_redraw_internal(sheet, FALSE, TRUE);
 }
 
 /**
- * gtk_sheet_set_entry_editable:
- * @sheet: a #GtkSheet 
- * @editable: editable flag
+ * gtk_sheet_insert_rows:
+ * @sheet: a #GtkSheet.
+ * @row: row number.
+ * @nrows: number of rows to be inserted.
  *
- * Set the editable flag in the sheet_entry
- *  
- * This function is mainly used to synchronize the editable flag
- * of a second entry with the sheet_entry. 
- *  
- * This function is necessary, because not all possible entry 
- * widgets implement the GtkEditable interface yet. 
+ * Insert @nrows rows before the given row and pull right.
  */
-void gtk_sheet_set_entry_editable(GtkSheet *sheet, const gboolean editable)
+void
+gtk_sheet_insert_rows(GtkSheet *sheet, guint row, guint nrows)
 {
-    GtkWidget *entry = NULL;
+    GList *children;
+    GtkSheetChild *child;
 
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (!sheet->sheet_entry)   /* PR#102114 */
+    gtk_sheet_real_unselect_range(sheet, NULL);
+
+    InsertRow(sheet, row, nrows);
+
+    children = sheet->children;
+    while (children)
+    {
+	child = (GtkSheetChild *)children->data;
+
+	if (child->attached_to_cell)
+	    if (child->row >= row)
+		child->row += nrows;
+
+	children = children->next;
+    }
+
+    /* rows at and below the insertion point moved */
+    _gtk_sheet_emit_range_changed(sheet, row, 0, sheet->maxrow, sheet->maxcol);
+
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
 	return;
 
-    entry = gtk_sheet_get_entry(sheet);
-    g_return_if_fail(entry != NULL);
+    if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
+	sheet->range.rowi += nrows;
 
-    if (GTK_IS_EDITABLE(entry))
-    {
-	gtk_editable_set_editable(GTK_EDITABLE(entry), editable);
-    }
-    else if ( GTK_IS_DATA_TEXT_VIEW(entry)
-	     || GTK_IS_TEXT_VIEW(entry) )
-    {
-	gtk_text_view_set_editable(GTK_TEXT_VIEW(entry), editable);
-    }
-    else
-    {
-	g_warning("gtk_sheet_set_entry_editable: no GTK_EDITABLE, don't know how to set editable.");
-    }
+    _gtk_sheet_scrollbar_adjust(sheet);
+    _gtk_sheet_redraw_internal(sheet, FALSE, TRUE);
 }
 
 /**
- * gtk_sheet_entry_select_region:
- * @sheet: a #GtkSheet 
- * @start_pos: start of region 
- * @end_pos: end of region 
+ * gtk_sheet_insert_columns:
+ * @sheet: a #GtkSheet.
+ * @col: column number.
+ * @ncols: number of columns to be inserted.
  *
- * Selects a region of text.
- *  
- * This function is necessary, because not all possible entry 
- * widgets implement the GtkEditable interface yet. 
+ * Insert @ncols columns before the given row and pull right.
  */
-void gtk_sheet_entry_select_region(GtkSheet *sheet, gint start_pos, gint end_pos)
+void
+gtk_sheet_insert_columns(GtkSheet *sheet, guint col, guint ncols)
 {
-    GtkWidget *entry = NULL;
+    GList *children;
+    GtkSheetChild *child;
 
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (!sheet->sheet_entry)   /* PR#102114 */
-	return;
+    gtk_sheet_real_unselect_range(sheet, NULL);
 
-    entry = gtk_sheet_get_entry(sheet);
-    g_return_if_fail(entry != NULL);
+    InsertColumn(sheet, col, ncols);
 
-    if (GTK_IS_EDITABLE(entry))
-    {
-	gtk_editable_select_region(GTK_EDITABLE(entry), start_pos, end_pos);
-    }
-    else if ( GTK_IS_DATA_TEXT_VIEW(entry)
-	     || GTK_IS_TEXT_VIEW(entry) )
+    children = sheet->children;
+    while (children)
     {
-	GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(entry));
-	GtkTextIter start, end;
+	child = (GtkSheetChild *)children->data;
 
-	gtk_text_buffer_get_iter_at_offset(buffer, &start, start_pos);
-	gtk_text_buffer_get_iter_at_offset(buffer, &end, end_pos);
-	gtk_text_buffer_select_range(buffer, &start, &end);
-    }
-    else
-    {
-	g_warning("gtk_sheet_entry_select_region: no GTK_EDITABLE, don't know how to select region.");
+	if (child->attached_to_cell)
+	    if (child->col >= col)
+		child->col += ncols;
+
+	children = children->next;
     }
+
+    _gtk_sheet_emit_range_changed(sheet, 0, col, sheet->maxrow, sheet->maxcol);
+
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+
+    if (sheet->state == GTK_SHEET_ROW_SELECTED)
+	sheet->range.coli += ncols;
+
+    _gtk_sheet_scrollbar_adjust(sheet);
+    _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
 }
 
 /**
- * gtk_sheet_entry_signal_connect_changed:
- * @sheet: a #GtkSheet 
- * @handler: (scope notified) the signal handler
+ * gtk_sheet_delete_rows:
+ * @sheet: a #GtkSheet.
+ * @row: row number.
+ * @nrows: number of rows to be deleted.
  *
- * Connect a handler to the sheet_entry "changed" signal. The 
- * user_data argument of the handler will be filled with the 
- * #GtkSheet. 
- *  
- * This function is mainly used to synchronize a second entry 
- * widget with the sheet_entry. 
- *  
- * This function is necessary, because not all possible entry 
- * widgets implement the GtkEditable interface yet. 
- *  
- * Returns: the handler id 
+ * Delete @nrows rows starting from @row.
  */
-gulong gtk_sheet_entry_signal_connect_changed(GtkSheet *sheet, GCallback handler)
+void
+gtk_sheet_delete_rows(GtkSheet *sheet, guint row, guint nrows)
 {
-    GtkWidget *entry = NULL;
-    gulong handler_id = 0;
+    GList *children;
+    GtkSheetChild *child;
+    gint act_row, act_col;
 
-    g_return_val_if_fail(sheet != NULL, handler_id);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), handler_id);
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (!sheet->sheet_entry)   /* PR#102114 */
-	return(handler_id);
+    nrows = MIN(nrows, sheet->maxrow - row + 1);
 
-    entry = gtk_sheet_get_entry(sheet);
-    g_return_val_if_fail(entry != NULL, handler_id);
+    act_row = sheet->active_cell.row;
+    act_col = sheet->active_cell.col;
 
-    if (GTK_IS_EDITABLE(entry))
-    {
-	handler_id = g_signal_connect(G_OBJECT(entry),
-	    "changed", handler, GTK_OBJECT(sheet));
-    }
-    else if ( GTK_IS_DATA_TEXT_VIEW(entry) 
-	     || GTK_IS_TEXT_VIEW(entry) )
+    _gtk_sheet_hide_active_cell(sheet);
+    gtk_sheet_real_unselect_range(sheet, NULL);
+
+    DeleteRow(sheet, row, nrows);
+
+    children = sheet->children;
+    while (children)
     {
-	GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(entry));
+	child = (GtkSheetChild *)children->data;
 
-	handler_id = g_signal_connect(G_OBJECT(buffer),
-	    "changed", handler, GTK_OBJECT(sheet));
+	if (child->attached_to_cell &&
+	    child->row >= row && child->row < row + nrows &&
+	    gtk_widget_get_realized(child->widget))
+	{
+	    gtk_container_remove(GTK_CONTAINER(sheet), child->widget);
+	    children = sheet->children;
+	}
+	else
+	    children = children->next;
     }
-    else
+
+    children = sheet->children;
+    while (children)
     {
-	g_warning("gtk_sheet_entry_signal_connect_changed: no GTK_EDITABLE, don't know how to get editable.");
+	child = (GtkSheetChild *)children->data;
+
+	if (child->attached_to_cell && child->row > row)
+	    child->row -= nrows;
+	children = children->next;
     }
-    return (handler_id);
+
+    /* rows at and below the deletion point moved, including 
+       the rows that disappeared at the end */
+    _gtk_sheet_emit_range_changed(sheet,
+	row, 0, sheet->maxrow + nrows, sheet->maxcol);
+
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+
+    sheet->active_cell.row = -1;
+    sheet->active_cell.col = -1;
+
+/* if(sheet->state == GTK_SHEET_ROW_SELECTED)
+*/
+
+    act_row = MIN(act_row, sheet->maxrow);
+    act_row = MAX(act_row, 0);
+
+    _gtk_sheet_scrollbar_adjust(sheet);
+    _gtk_sheet_redraw_internal(sheet, FALSE, TRUE);
+
+    gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
 }
 
 /**
- * gtk_sheet_entry_signal_disconnect_by_func:
- * @sheet: a #GtkSheet 
- * @handler: (scope call) the signal handler
+ * gtk_sheet_delete_columns:
+ * @sheet: a #GtkSheet.
+ * @col: column number.
+ * @ncols: number of columns to be deleted.
  *
- * Disconnect a handler from the sheet_entry "changed" signal
- *  
- * This function is mainly used to synchronize a second entry 
- * widget with the sheet_entry. 
- *  
- * This function is necessary, because not all possible entry 
- * widgets implement the GtkEditable interface yet. 
+ * Delete @ncols columns starting from @col.
  */
-void gtk_sheet_entry_signal_disconnect_by_func(GtkSheet *sheet, GCallback handler)
+void
+gtk_sheet_delete_columns(GtkSheet *sheet, guint col, guint ncols)
 {
-    GtkWidget *entry = NULL;
+    GList *children;
+    GtkSheetChild *child;
+    gint act_row, act_col;
 
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if (!sheet->sheet_entry)   /* PR#102114 */
-	return;
+    ncols = MIN(ncols, sheet->maxcol - col + 1);
 
-    entry = gtk_sheet_get_entry(sheet);
-    g_return_if_fail(entry != NULL);
+    _gtk_sheet_hide_active_cell(sheet);
+    gtk_sheet_real_unselect_range(sheet, NULL);
 
-    if (GTK_IS_EDITABLE(entry))
+    DeleteColumn(sheet, col, ncols);
+
+    children = sheet->children;
+    while (children)
     {
-	g_signal_handlers_disconnect_by_func(G_OBJECT(entry),
-	    handler, GTK_OBJECT(sheet));
+	child = (GtkSheetChild *)children->data;
+
+	if (child->attached_to_cell &&
+	    child->col >= col && child->col < col + ncols &&
+	    gtk_widget_get_realized(child->widget))
+	{
+	    gtk_container_remove(GTK_CONTAINER(sheet), child->widget);
+	    children = sheet->children;
+	}
+	else
+	    children = children->next;
     }
-    else if ( GTK_IS_DATA_TEXT_VIEW(entry)
-	     || GTK_IS_TEXT_VIEW(entry) )
+
+    children = sheet->children;
+    while (children)
     {
-	GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(entry));
+	child = (GtkSheetChild *)children->data;
+
+	if (child->attached_to_cell && child->col > col)
+	    child->col -= ncols;
+	children = children->next;
+    }
+
+    _gtk_sheet_emit_range_changed(sheet,
+	0, col, sheet->maxrow, sheet->maxcol + ncols);
+
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+	return;
+
+    act_row = sheet->active_cell.row;
+    act_col = sheet->active_cell.col;
+
+    sheet->active_cell.row = -1;
+    sheet->active_cell.col = -1;
+
+/* if(sheet->state == GTK_SHEET_COLUMN_SELECTED)
+*/
+
+    act_col = MIN(act_col, sheet->maxcol);
+    act_col = MAX(act_col, 0);
+
+    _gtk_sheet_scrollbar_adjust(sheet);
+    _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
+
+    gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
+}
+
+/* attribute modifiers for _gtk_sheet_range_modify_attributes() */
+
+static void
+_attr_set_background(GtkSheetCellAttr *attributes, gpointer data)
+{
+    attributes->background = *(GdkColor *)data;
+}
 
-	g_signal_handlers_disconnect_by_func(G_OBJECT(buffer),
-	    handler, GTK_OBJECT(sheet));
-    }
-    else
-    {
-	g_warning("gtk_sheet_entry_signal_disconnect_by_func: no GTK_EDITABLE, don't know how to get editable.");
-    }
+static void
+_attr_set_foreground(GtkSheetCellAttr *attributes, gpointer data)
+{
+    attributes->foreground = *(GdkColor *)data;
+}
+
+static void
+_attr_set_justification(GtkSheetCellAttr *attributes, gpointer data)
+{
+    attributes->justification = GPOINTER_TO_INT(data);
 }
 
+static void
+_attr_set_editable(GtkSheetCellAttr *attributes, gpointer data)
+{
+    attributes->is_editable = GPOINTER_TO_INT(data);
+}
 
+static void
+_attr_set_visible(GtkSheetCellAttr *attributes, gpointer data)
+{
+    attributes->is_visible = GPOINTER_TO_INT(data);
+}
 
-/* BUTTONS */
 static void
-row_button_set(GtkSheet *sheet, gint row)
+_attr_set_border(GtkSheetCellAttr *attributes, gpointer data)
 {
-    if (row < 0 || row > sheet->maxrow)
-	return;
-    if (sheet->row[row].button.state == GTK_STATE_ACTIVE)
-	return;
+    GtkSheetCellBorder *border = data;
 
-    sheet->row[row].button.state = GTK_STATE_ACTIVE;
-    _gtk_sheet_draw_button(sheet, row, -1);
+    attributes->border.mask = border->mask;
+    attributes->border.width = border->width;
+    attributes->border.line_style = border->line_style;
+    attributes->border.cap_style = border->cap_style;
+    attributes->border.join_style = border->join_style;
 }
 
 static void
-row_button_release(GtkSheet *sheet, gint row)
+_attr_set_border_color(GtkSheetCellAttr *attributes, gpointer data)
 {
-    if (row < 0 || row > sheet->maxrow)
-	return;
-    if (sheet->row[row].button.state == GTK_STATE_NORMAL)
-	return;
+    attributes->border.color = *(GdkColor *)data;
+}
 
-    sheet->row[row].button.state = GTK_STATE_NORMAL;
-    _gtk_sheet_draw_button(sheet, row, -1);
+static void
+_attr_set_font(GtkSheetCellAttr *attributes, gpointer data)
+{
+    attributes->font_desc = data;  /* copied by the attribute table or layer */
 }
 
 /**
- * _gtk_sheet_draw_button: 
- * @sheet:  the #GtkSheet
- * @row:    row index
- * @col:    column index 
- *  
- * draw a sheet button
- * if row == -1 draw a column button
- * if col == -1 draw a row button
- * if both == -1 draw the sheet button
- * 
+ * gtk_sheet_range_set_background:
+ * @sheet: a #GtkSheet.
+ * @urange: a #GtkSheetRange.
+ * @color: a #GdkColor.
+ *
+ * Set background color of the given range.
  */
 void
-_gtk_sheet_draw_button(GtkSheet *sheet, gint row, gint col)
+gtk_sheet_range_set_background(GtkSheet *sheet,
+    const GtkSheetRange *urange,
+    const GdkColor *color)
 {
-    GdkWindow *window = NULL;
-    GtkShadowType shadow_type;
-    guint width = 0, height = 0;
-    gint x = 0, y = 0;
-    gint index = 0;
-    guint text_width = 0, text_height = 0;
-    GtkSheetButton *button = NULL;
-    GtkSheetChild *child = NULL;
-    GdkRectangle allocation;
-    gboolean sensitive = FALSE;
-    gint state = 0;
-    gchar * label, label_buf[10];
-    PangoAlignment pango_alignment = PANGO_ALIGN_LEFT;
-    GtkSheetArea area = ON_SHEET_BUTTON_AREA;
-    PangoFontDescription *font_desc =
-	gtk_widget_get_style(GTK_WIDGET(sheet))->font_desc;
-    PangoRectangle extent;
+    GtkSheetRange range;
+    GdkColor background;
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if ((row == -1) && (col == -1))
-	return;
+    if (!urange)
+	range = sheet->range;
+    else
+	range = *urange;
 
-#if GTK_SHEET_DEBUG_DRAW_BUTTON > 0
-    g_debug("_gtk_sheet_draw_button: row %d col %d", row, col);
+#if GTK_SHEET_DEBUG_COLORS > 0
+    g_debug("gtk_sheet_range_set_background: %s row %d-%d col %d-%d)",
+	gdk_color_to_string(color), range.row0, range.rowi, range.col0, range.coli);
 #endif
 
-    if (row >= 0)
-    {
-	if (row > sheet->maxrow)
-	    return;
-	if (!sheet->row_titles_visible)
-	    return;
-	if (!GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, row)))
-	    return;
-	if (row < MIN_VIEW_ROW(sheet))
-	    return;
-	if (row > MAX_VIEW_ROW(sheet))
-	    return;
-    }
-
-    if (col >= 0)
-    {
-	if (col > sheet->maxcol)
-	    return;
-	if (!sheet->column_titles_visible)
-	    return;
-	if (!GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, col)))
-	    return;
-	if (col < MIN_VIEW_COLUMN(sheet))
-	    return;
-	if (col > MAX_VIEW_COLUMN(sheet))
-	    return;
-    }
-
-    if (row == -1)
-    {
-	window = sheet->column_title_window;
-	button = &COLPTR(sheet, col)->button;
-	index = col;
-	x = _gtk_sheet_column_left_xpixel(sheet, col) + CELL_SPACING;
-	if (sheet->row_titles_visible)
-	    x -= sheet->row_title_area.width;
-	y = 0;
-	width = COLPTR(sheet, col)->width;
-	height = sheet->column_title_area.height;
-	sensitive = GTK_SHEET_COLUMN_IS_SENSITIVE(COLPTR(sheet, col));
-	area = ON_COLUMN_TITLES_AREA;
-    }
-    else if (col == -1)
-    {
-	window = sheet->row_title_window;
-	button = &sheet->row[row].button;
-	index = row;
-	x = 0;
-	y = _gtk_sheet_row_top_ypixel(sheet, row) + CELL_SPACING;
-	if (sheet->column_titles_visible)
-	    y -= sheet->column_title_area.height;
-	width = sheet->row_title_area.width;
-	height = sheet->row[row].height;
-	sensitive = GTK_SHEET_ROW_IS_SENSITIVE(ROWPTR(sheet, row));
-	area = ON_ROW_TITLES_AREA;
-    }
-
-    allocation.x = x;
-    allocation.y = y;
-    allocation.width = width;
-    allocation.height = height;
-
-    gdk_window_clear_area(window, x, y, width, height);
-
-    state = button->state;
-    if (!sensitive)
-	state = GTK_STATE_INSENSITIVE;
-
-    if (state == GTK_STATE_ACTIVE)
-	shadow_type = GTK_SHADOW_IN;
-    else
-	shadow_type = GTK_SHADOW_OUT;
-
-    if (state != GTK_STATE_NORMAL && state != GTK_STATE_INSENSITIVE)
-	gtk_paint_box(gtk_widget_get_style(sheet->button), window,
-	    button->state, shadow_type,
-	    &allocation, GTK_WIDGET(sheet->button),
-	    "table-heading", x, y, width, height);
+    if (color != NULL)
+	background = *color;
     else
-	gtk_paint_box(gtk_widget_get_style(sheet->button), window,
-	    GTK_STATE_NORMAL, GTK_SHADOW_OUT,
-	    &allocation, GTK_WIDGET(sheet->button),
-	    "table-heading", x, y, width, height);
-
-    if (button->label_visible)
-    {
-	PangoLayout *layout = NULL;
-	gint real_x = x, real_y;
-
-	text_height =
-	    _gtk_sheet_row_default_height(GTK_WIDGET(sheet)) - 2 * CELLOFFSET;
-
-	gdk_gc_set_clip_rectangle(
-	    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[button->state],
-	    &allocation);
-	gdk_gc_set_clip_rectangle(
-	    gtk_widget_get_style(GTK_WIDGET(sheet))->white_gc,
-	    &allocation);
-
-	y += 2 * gtk_widget_get_style(sheet->button)->ythickness;
-
-	real_y = y;
-	label = button->label;
-
-	if (!label || !label[0])   /* revert to auto-generated numeric label */
-	{
-	    sprintf(label_buf, "%d", index);
-	    label = label_buf;
-	}
+	background = sheet->bg_color;
 
-	layout = gtk_widget_create_pango_layout(GTK_WIDGET(sheet), label);
-	pango_layout_set_font_description(layout, font_desc);
-
-	pango_layout_get_pixel_extents(layout, NULL, &extent);
-	text_width = extent.width;
-
-	switch(button->justification)
-	{
-	    case GTK_JUSTIFY_LEFT:
-		real_x = x + CELLOFFSET;
-		pango_alignment = PANGO_ALIGN_LEFT;
-		break;
+    gdk_colormap_alloc_color(gdk_colormap_get_system(), &background, FALSE, TRUE);
 
-	    case GTK_JUSTIFY_RIGHT:
-		real_x = x + width - text_width - CELLOFFSET;
-		pango_alignment = PANGO_ALIGN_RIGHT;
-		break;
+    _gtk_sheet_range_modify_attributes(sheet, &range,
+	GTK_SHEET_ATTR_BACKGROUND, _attr_set_background, &background);
 
-	    case GTK_JUSTIFY_FILL:
-		pango_layout_set_justify(layout, TRUE);
-		/* FALLTHROUGH */
+    _gtk_sheet_range_queue_draw(sheet, &range);
+}
 
-	    case GTK_JUSTIFY_CENTER:
-		real_x = x + (width - text_width) / 2;
-		pango_alignment = PANGO_ALIGN_CENTER;
+/**
+ * gtk_sheet_range_set_foreground:
+ * @sheet: a #GtkSheet.
+ * @urange: a #GtkSheetRange.
+ * @color: a #GdkColor.
+ *
+ * Set foreground color of the given range.
+ */
+void
+gtk_sheet_range_set_foreground(GtkSheet *sheet,
+    const GtkSheetRange *urange,
+    const GdkColor *color)
+{
+    GtkSheetRange range;
+    GdkColor foreground;
 
-	    default:
-		break;
-	}
-	pango_layout_set_alignment(layout, pango_alignment);
-	gtk_paint_layout(gtk_widget_get_style(GTK_WIDGET(sheet)),
-	    window,
-	    state,
-	    FALSE,
-	    &allocation,
-	    GTK_WIDGET(sheet),
-	    "label",
-	    real_x, real_y,
-	    layout);
-	g_object_unref(G_OBJECT(layout));
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-	gdk_gc_set_clip_rectangle(
-	    gtk_widget_get_style(GTK_WIDGET(sheet))->fg_gc[button->state],
-	    NULL);
-	gdk_gc_set_clip_rectangle(
-	    gtk_widget_get_style(GTK_WIDGET(sheet))->white_gc,
-	    NULL);
-    }
+    if (!urange)
+	range = sheet->range;
+    else
+	range = *urange;
 
-    gtk_sheet_draw_tooltip_marker(sheet, area, row, col);
+#if GTK_SHEET_DEBUG_COLORS > 0
+    g_debug("gtk_sheet_range_set_foreground: %s row %d-%d col %d-%d)",
+	gdk_color_to_string(color), range.row0, range.rowi, range.col0, range.coli);
+#endif
 
-    if ((child = button->child) && (child->widget))
-    {
-	GtkRequisition requisition;
+    if (color != NULL)
+	foreground = *color;
+    else
+	gdk_color_black(gdk_colormap_get_system(), &foreground);
 
-	child->x = allocation.x;
-	child->y = allocation.y;
+    gdk_colormap_alloc_color(gdk_colormap_get_system(), &foreground, FALSE, TRUE);
 
-	gtk_widget_get_requisition(child->widget, &requisition);
+    _gtk_sheet_range_modify_attributes(sheet, &range,
+	GTK_SHEET_ATTR_FOREGROUND, _attr_set_foreground, &foreground);
 
-	child->x += (width - requisition.width) / 2;
-	child->y += (height - requisition.height) / 2;
+    _gtk_sheet_range_queue_draw(sheet, &range);
+}
 
-	allocation.x = child->x;
-	allocation.y = child->y;
-	allocation.width = requisition.width;
-	allocation.height = requisition.height;
+/**
+ * gtk_sheet_range_set_justification:
+ * @sheet: a #GtkSheet.
+ * @urange: a #GtkSheetRange.
+ * @just: a #GtkJustification : GTK_JUSTIFY_LEFT, RIGHT, CENTER.
+ *
+ * Set text justification (GTK_JUSTIFY_LEFT, RIGHT, CENTER) of the given range.
+ * The default value is GTK_JUSTIFY_LEFT. If autoformat is on, the default justification for numbers is GTK_JUSTIFY_RIGHT.
+ */
+void
+gtk_sheet_range_set_justification(GtkSheet *sheet, const GtkSheetRange *urange,
+    GtkJustification just)
+{
+    GtkSheetRange range;
 
-	x = child->x;
-	y = child->y;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-	gtk_widget_set_state(child->widget, button->state);
+    if (!urange)
+	range = sheet->range;
+    else
+	range = *urange;
 
-	if (gtk_widget_get_realized(GTK_WIDGET(sheet)) &&
-	    gtk_widget_get_mapped(child->widget))
-	{
-	    gtk_widget_size_allocate(child->widget, &allocation);
-	    gtk_widget_queue_draw(child->widget);
-	}
-    }
-}
+    _gtk_sheet_range_modify_attributes(sheet, &range,
+	GTK_SHEET_ATTR_JUSTIFICATION, _attr_set_justification, GINT_TO_POINTER(just));
 
+    range.col0 = sheet->view.col0;
+    range.coli = sheet->view.coli;
+
+    _gtk_sheet_range_queue_draw(sheet, &range);
+}
 
-/* SCROLLBARS
- *
- * functions:
- *   adjust_scrollbars
- *   vadjustment_changed
- *   hadjustment_changed
- *   vadjustment_value_changed
- *   hadjustment_value_changed */
 
 /**
- * _gtk_sheet_scrollbar_adjust:
- * 
- * @param sheet  the #GtkSheet
- *  
- * recalculate scrollbar adjustments and emit changed signals 
+ * gtk_sheet_range_set_editable:
+ * @sheet: a #GtkSheet.
+ * @urange: a #GtkSheetRange
+ * @editable: TRUE or FALSE
+ *
+ * Set if cell contents can be edited or not in the given range.
  */
 void
-_gtk_sheet_scrollbar_adjust(GtkSheet *sheet)
+gtk_sheet_range_set_editable(GtkSheet *sheet, const GtkSheetRange *urange, gboolean editable)
 {
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
-    g_debug("_gtk_sheet_scrollbar_adjust: called");
-#endif
-
-    if (sheet->vadjustment)
-    {
-	GtkAdjustment *va = sheet->vadjustment;
+    GtkSheetRange range;
 
-	gint upper = gtk_sheet_height(sheet) + 80;
-	gint page_size = sheet->sheet_window_height;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-	gtk_adjustment_configure(va,
-	    gtk_adjustment_get_value(va),  /* value */
-	    0.0,  /* lower */
-	    upper,  /* upper */
-	    _gtk_sheet_row_default_height(GTK_WIDGET(sheet)), /* step_increment */
-	    sheet->sheet_window_height / 2, /* page_increment */
-	    page_size  /* page_size */
-	    );
+    if (!urange)
+	range = sheet->range;
+    else
+	range = *urange;
 
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
-	g_debug("_gtk_sheet_scrollbar_adjust: va PS %d PI %g SI %g L %g U %d V %g VO %d",
-	    page_size, 
-	    gtk_adjustment_get_page_increment(va), 
-	    gtk_adjustment_get_step_increment(va),
-	    gtk_adjustment_get_lower(va), 
-	    upper, 
-	    gtk_adjustment_get_value(va), 
-	    sheet->voffset);
-#endif
+    _gtk_sheet_range_modify_attributes(sheet, &range,
+	GTK_SHEET_ATTR_EDITABLE, _attr_set_editable, GINT_TO_POINTER(editable));
 
-	if (upper <= page_size)  /* whole sheet fits into window? */
-	{
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
-	    g_debug("_gtk_sheet_scrollbar_adjust: reset V to 0");
-#endif
-	    gtk_adjustment_set_value(va, 0);
-	    gtk_adjustment_value_changed(va);
-	}
-	/* can produce smudge effects - 23.3.13/fp 
-	else if (va->value >= va->upper - va->page_size)
-	{
-	    va->value = va->upper - va->page_size;
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
-	    g_debug("_gtk_sheet_scrollbar_adjust: reset to V %g VO %d", 
-		va->value, sheet->voffset);
-#endif
-	    g_signal_emit_by_name(GTK_OBJECT(va), "value_changed");
-	} 
-	*/ 
-	
-	gtk_adjustment_changed(va);
-    }
+    _gtk_sheet_range_queue_draw(sheet, &range);
+}
 
-    if (sheet->hadjustment)
-    {
-	GtkAdjustment *ha = sheet->hadjustment;
+/**
+ * gtk_sheet_range_set_visible:
+ * @sheet: a #GtkSheet.
+ * @urange: a #GtkSheetRange.
+ * @visible: TRUE or FALSE.
+ *
+ * Set if cell contents are visible or not in the given range: accepted values are TRUE or FALSE.
+ */
+void
+gtk_sheet_range_set_visible(GtkSheet *sheet, const GtkSheetRange *urange, gboolean visible)
+{
+    GtkSheetRange range;
 
-	/* gint upper = gtk_sheet_width(sheet) * 3 / 2; */
-	gint upper = gtk_sheet_width(sheet) + 80;
-	gint page_size = sheet->sheet_window_width;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-	gtk_adjustment_configure(ha,
-	    gtk_adjustment_get_value(ha),  /* value */
-	    0.0,  /* lower */
-	    upper,  /* upper */
-	    GTK_SHEET_COLUMN_DEFAULT_WIDTH, /* step_increment */
-	    sheet->sheet_window_width / 2, /* page_increment */
-	    page_size  /* page_size */
-	    );
+    if (!urange)
+	range = sheet->range;
+    else
+	range = *urange;
 
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
-	g_debug("_gtk_sheet_scrollbar_adjust: ha PS %d PI %g SI %g L %g U %d V %g HO %d",
-	    page_size, 
-	    gtk_adjustment_get_page_increment(ha), 
-	    gtk_adjustment_get_step_increment(ha),
-	    gtk_adjustment_get_lower(ha), 
-	    upper, 
-	    gtk_adjustment_get_value(ha), sheet->hoffset);
-#endif
+    _gtk_sheet_range_modify_attributes(sheet, &range,
+	GTK_SHEET_ATTR_VISIBLE, _attr_set_visible, GINT_TO_POINTER(visible));
 
-	if (upper <= page_size)  /* whole sheet fits into window? */
-	{
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
-	    g_debug("_gtk_sheet_scrollbar_adjust: reset V to 0");
-#endif
-	    gtk_adjustment_set_value(ha, 0);
-	    gtk_adjustment_value_changed(ha);
-	}
-	/* can produce smudge effects - 23.3.13/fp
-	else if (ha->value >= ha->upper - ha->page_size)
-	{
-	    ha->value = ha->upper - ha->page_size;
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
-	    g_debug("_gtk_sheet_scrollbar_adjust: reset to V %g HO %d", 
-		va->value, sheet->hoffset);
-#endif
-	    g_signal_emit_by_name(GTK_OBJECT(ha), "value_changed");
-	} 
-	*/ 
-	
-	gtk_adjustment_changed(ha);
-    }
+    _gtk_sheet_range_queue_draw(sheet, &range);
 }
 
-
-/*
- * _vadjustment_changed_handler:
- * 
- * this is the #GtkSheet vertical adjustment "changed" signal handler
- * 
- * @param adjustment the #GtkAdjustment that received the signal
- * @param data the #GtkSheet passed on signal creation
+/**
+ * gtk_sheet_range_set_border:
+ * @sheet: a #GtkSheet.
+ * @urange: a #GtkSheetRange where we set border style.
+ * @mask: CELL_LEFT_BORDER, CELL_RIGHT_BORDER, CELL_TOP_BORDER,CELL_BOTTOM_BORDER
+ * @width: width of the border line in pixels
+ * @line_style: GdkLineStyle for the border line
+ *
+ * Set cell border style in the given range.
  */
-static void
-_vadjustment_changed_handler(GtkAdjustment *adjustment,
-    gpointer data)
+void
+gtk_sheet_range_set_border(GtkSheet *sheet, const GtkSheetRange *urange, gint mask,
+    guint width, gint line_style)
 {
-    GtkSheet *sheet;
+    GtkSheetRange range;
+    GtkSheetCellBorder border;
 
-    g_return_if_fail(adjustment != NULL);
-    g_return_if_fail(data != NULL);
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    sheet = GTK_SHEET(data);
+    if (!urange)
+	range = sheet->range;
+    else
+	range = *urange;
 
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 1
-    g_debug("_vadjustment_changed_handler: called: O VA %g VO %d",
-	sheet->old_vadjustment, sheet->voffset);
-#endif
+    border.mask = mask;
+    border.width = width;
+    border.line_style = line_style;
+    border.cap_style = GDK_CAP_NOT_LAST;
+    border.join_style = GDK_JOIN_MITER;
+
+    _gtk_sheet_range_modify_attributes(sheet, &range,
+	GTK_SHEET_ATTR_BORDER, _attr_set_border, &border);
+
+    range.row0--;
+    range.col0--;
+    range.rowi++;
+    range.coli++;
+
+    _gtk_sheet_range_queue_draw(sheet, &range);
 }
 
-/*
- * _hadjustment_changed_handler:
- * 
- * this is the #GtkSheet horizontal adjustment "change" handler
- * 
- * @param adjustment the #GtkAdjustment that received the signal
- * @param data       the #GtkSheet passed on signal creation
+/**
+ * gtk_sheet_range_set_border_color:
+ * @sheet: a #GtkSheet.
+ * @urange: a #GtkSheetRange where we set border color.
+ * @color: a #GdkColor.
+ *
+ * Set border color for the given range.
  */
-static void
-_hadjustment_changed_handler(GtkAdjustment *adjustment, gpointer data)
+void
+gtk_sheet_range_set_border_color(GtkSheet *sheet,
+    const GtkSheetRange *urange,
+    const GdkColor *color)
 {
-    GtkSheet *sheet;
+    GtkSheetRange range;
 
-    g_return_if_fail(adjustment != NULL);
-    g_return_if_fail(data != NULL);
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    sheet = GTK_SHEET(data);
+    if (!urange)
+	range = sheet->range;
+    else
+	range = *urange;
 
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 1
-    g_debug("_hadjustment_changed_handler: called: O VA %g VO %d",
-	sheet->old_vadjustment, sheet->voffset);
-#endif
-}
+    _gtk_sheet_range_modify_attributes(sheet, &range,
+	GTK_SHEET_ATTR_BORDER_COLOR, _attr_set_border_color, (gpointer)color);
 
+    _gtk_sheet_range_queue_draw(sheet, &range);
+}
 
-/*
- * vadjustment_value_changed_handler:
- * 
- * this is the #GtkSheet vertical adjustment "value-changed" signal handler
- * 
- * @param adjustment the #GtkAdjustment that received the signal
- * @param data       the #GtkSheet passed on signal creation
+/**
+ * gtk_sheet_range_set_font:
+ * @sheet: a #GtkSheet.
+ * @urange: a #GtkSheetRange where we set font_desc.
+ * @font_desc: (transfer none) a #PangoFontDescription.
+ *
+ * Set font_desc for the given range.
  */
-static void
-_vadjustment_value_changed_handler(GtkAdjustment *adjustment, gpointer data)
+void
+gtk_sheet_range_set_font(GtkSheet *sheet,
+    const GtkSheetRange *urange,
+    PangoFontDescription *font_desc)
 {
-    GtkSheet *sheet;
-    gint old_value;
-
-    g_return_if_fail(adjustment != NULL);
-    g_return_if_fail(data != NULL);
-    g_return_if_fail(GTK_IS_SHEET(data));
-
-    sheet = GTK_SHEET(data);
-
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
-    g_debug("_vadjustment_value_changed_handler: called: O VA %g VO %d ar %d ac %d",
-            sheet->old_vadjustment, sheet->voffset,
-            sheet->active_cell.row, sheet->active_cell.col); 
-#endif
+    gint i;
+    gint font_height;
+    GtkSheetRange range;
+    const GtkSheetFontMetrics *fm;
 
-    if (GTK_SHEET_IS_FROZEN(sheet))
-	return;
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-#if 0
-    if (sheet->column_titles_visible)
-	row = _gtk_sheet_row_from_ypixel(sheet, sheet->column_title_area.height + CELL_SPACING);
+    if (!urange)
+	range = sheet->range;
     else
-	row = _gtk_sheet_row_from_ypixel(sheet, CELL_SPACING);
-
-    old_value = -sheet->voffset;
+	range = *urange;
 
-    for (i = 0; i < sheet->maxrow; i++)  /* all but the last row */
-    {
-	if (GTK_SHEET_ROW_IS_VISIBLE(ROWPTR(sheet, i)))
-	    y += sheet->row[i].height;
-	if (y > gtk_adjustment_get_value(adjustment))
-	    break;
-    }
-    if (0 <= i && i <= sheet->maxrow)
-	y -= sheet->row[i].height;
-    new_row = i;
+    gtk_sheet_geometry_begin(sheet);
 
-    y = MAX(y, 0);
+    fm = _gtk_sheet_font_metrics(sheet, font_desc);
+    font_height = fm ?
+	PANGO_PIXELS(fm->ascent + fm->descent) + 2 * CELLOFFSET :
+	GTK_SHEET_ROW_DEFAULT_HEIGHT;
 
-#if 0
-    if (adjustment->value > sheet->old_vadjustment && sheet->old_vadjustment > 0. &&
-	0 <= new_row && new_row <= sheet->maxrow &&
-	sheet->row[new_row].height > sheet->vadjustment->step_increment)
+    for (i = MAX(range.row0, 0); i <= range.rowi && i <= sheet->maxrow; i++)
     {
-	/* This avoids embarrassing twitching */
-	if (row == new_row && row != sheet->maxrow &&
-	    adjustment->value - sheet->old_vadjustment >=
-	    sheet->vadjustment->step_increment &&
-	    new_row + 1 != MIN_VISIBLE_ROW(sheet))
+	if (font_height > ROW_HEIGHT(sheet, i))
 	{
-	    new_row+=1;
-	    y=y+sheet->row[row].height;
+	    ROW_SET_HEIGHT(sheet, i, font_height);
+	    _gtk_sheet_row_geometry_changed(sheet, i);
 	}
     }
-#else
-    if (gtk_adjustment_get_value(adjustment) > sheet->old_vadjustment && sheet->old_vadjustment > 0. &&
-	0 <= new_row && new_row <= sheet->maxrow &&
-	sheet->row[new_row].height > gtk_adjustment_get_step_increment(sheet->vadjustment))
-    {
-	new_row += 1;
-	y = y + sheet->row[row].height;
-    }
-#endif
-
-    /* Negative old_adjustment enforces the redraw, otherwise avoid spureous redraw */
-    if (sheet->old_vadjustment >= 0. && row == new_row)
-    {
-	sheet->old_vadjustment = gtk_adjustment_get_value(sheet->vadjustment);
 
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
-	g_debug("_vadjustment_value_changed_handler: return 1: vv %g",
-	    sheet->old_vadjustment);
-#endif
-	return;
-    }
+    _gtk_sheet_range_modify_attributes(sheet, &range,
+	GTK_SHEET_ATTR_FONT, _attr_set_font, font_desc);
 
-    sheet->old_vadjustment = gtk_adjustment_get_value(sheet->vadjustment);
-    gtk_adjustment_set_value(adjustment, y);
+    gtk_sheet_geometry_commit(sheet);
+}
 
-    if (new_row < 0 || new_row > sheet->maxrow)
-    {
-	gtk_adjustment_set_step_increment(sheet->vadjustment, 
-	    GTK_SHEET_ROW_DEFAULT_HEIGHT);
-    }
-    else if (new_row == 0)
-    {
-	gtk_adjustment_set_step_increment(sheet->vadjustment, 
-	    sheet->row[0].height);
-    }
-    else
-    {
-	gtk_adjustment_set_step_increment(sheet->vadjustment,
-	    MIN(sheet->row[new_row].height, sheet->row[new_row - 1].height));
-    }
+/*
+ * interned cell attributes
+ *
+ * Per cell attribute overrides are stored once in the sheet's 
+ * attribute table and shared by reference counted id. Cells keep the 
+ * id only, id 0 stands for no override. An entry holds the fields 
+ * named in its mask, other fields are zero. A font_desc of NULL in a 
+ * table entry means the widget style font.
+ */
 
-    value = gtk_adjustment_get_value(adjustment);
-    gtk_adjustment_set_value(sheet->vadjustment, value);
+struct _GtkSheetAttrEntry
+{
+    GtkSheetCellAttr attributes;  /* font_desc owned by the entry */
+    guint mask;                   /* GTK_SHEET_ATTR_* fields set */
+    guint id;
+    guint ref_count;
+};
 
-    if (value >= -sheet->voffset)
-    {
-	/* scroll down */
-	diff = value + sheet->voffset;
-    }
-    else
-    {
-	/* scroll up */
-	diff = -sheet->voffset - value;
-    }
+struct _GtkSheetAttrTable
+{
+    GPtrArray *entries;  /* GtkSheetAttrEntry by id, slot 0 unused */
+    GHashTable *lookup;  /* GtkSheetAttrEntry -> GtkSheetAttrEntry */
+    GArray *free_ids;    /* ids for reuse */
+};
 
-    sheet->voffset = -value;
-#else
-    /* Negative old_adjustment enforces the redraw, otherwise avoid spureous redraw */
-    old_value = sheet->old_vadjustment;
-    sheet->old_vadjustment = gtk_adjustment_get_value(sheet->vadjustment);
+static inline guint
+_color_hash(const GdkColor *color)
+{
+    return (color->pixel ^ (color->red << 1) ^ (color->green << 7) ^ (color->blue << 13));
+}
 
-    if (old_value >= 0. && sheet->voffset == -1 *  gtk_adjustment_get_value(adjustment))
-	return;
+static inline gboolean
+_color_equal(const GdkColor *a, const GdkColor *b)
+{
+    return (a->pixel == b->pixel
+	&& a->red == b->red && a->green == b->green && a->blue == b->blue);
+}
 
-    gdouble value = gtk_adjustment_get_value(adjustment);
-    gtk_adjustment_set_value(sheet->vadjustment, value);
-    sheet->voffset = -value;
-#endif
+static inline gboolean
+_font_desc_equal(const PangoFontDescription *a, const PangoFontDescription *b)
+{
+    if (a == b)
+	return (TRUE);
+    if (!a || !b)
+	return (FALSE);
+    return (pango_font_description_equal(a, b));
+}
 
-    _gtk_sheet_recalc_view_range(sheet);
+static guint
+_gtk_sheet_attr_hash(gconstpointer key)
+{
+    const GtkSheetAttrEntry *entry = key;
+    const GtkSheetCellAttr *a = &entry->attributes;
+    guint h = entry->mask;
 
-    if (gtk_widget_get_realized(sheet->sheet_entry) &&
-	sheet->state == GTK_SHEET_NORMAL &&
-	sheet->active_cell.row >= 0 && sheet->active_cell.col >= 0 &&
-	!gtk_sheet_cell_isvisible(sheet, sheet->active_cell.row, sheet->active_cell.col))
-    {
-        /* PR#211566 - removed gtk_sheet_cell_clear() */
-	gtk_widget_unmap(sheet->sheet_entry);
-    }
+    h = h * 31 + a->justification;
+    h = h * 31 + (a->font_desc ? pango_font_description_hash(a->font_desc) : 0);
+    h = h * 31 + _color_hash(&a->foreground);
+    h = h * 31 + _color_hash(&a->background);
+    h = h * 31 + a->border.mask;
+    h = h * 31 + a->border.width;
+    h = h * 31 + a->border.line_style;
+    h = h * 31 + _color_hash(&a->border.color);
+    h = h * 31 + ((a->is_editable != 0) << 3 | (a->is_visible != 0) << 2
+	| (a->is_sensitive != 0) << 1 | (a->can_focus != 0));
+    return (h);
+}
 
+static gboolean
+_gtk_sheet_attr_equal(gconstpointer k1, gconstpointer k2)
+{
+    const GtkSheetCellAttr *a = &((const GtkSheetAttrEntry *)k1)->attributes;
+    const GtkSheetCellAttr *b = &((const GtkSheetAttrEntry *)k2)->attributes;
 
-    gtk_sheet_position_children(sheet);
+    if (((const GtkSheetAttrEntry *)k1)->mask != ((const GtkSheetAttrEntry *)k2)->mask)
+	return (FALSE);
+    if (a->justification != b->justification)
+	return (FALSE);
+    if (!_font_desc_equal(a->font_desc, b->font_desc))
+	return (FALSE);
+    if (!_color_equal(&a->foreground, &b->foreground))
+	return (FALSE);
+    if (!_color_equal(&a->background, &b->background))
+	return (FALSE);
+    if (a->border.mask != b->border.mask
+	|| a->border.width != b->border.width
+	|| a->border.line_style != b->border.line_style
+	|| a->border.cap_style != b->border.cap_style
+	|| a->border.join_style != b->border.join_style
+	|| !_color_equal(&a->border.color, &b->border.color))
+	return (FALSE);
+    if (!a->is_editable != !b->is_editable
+	|| !a->is_visible != !b->is_visible
+	|| !a->is_sensitive != !b->is_sensitive
+	|| !a->can_focus != !b->can_focus)
+	return (FALSE);
 
-    size_allocate_global_button(sheet);
-    size_allocate_row_title_buttons(sheet);
+    return (TRUE);
+}
 
-    _gtk_sheet_range_draw(sheet, NULL, TRUE);
+/*
+ * _gtk_sheet_attr_copy_fields - copy selected attribute fields
+ * 
+ * @param dst
+ * @param src
+ * @param mask   GTK_SHEET_ATTR_* fields to be copied
+ */
+static void
+_gtk_sheet_attr_copy_fields(GtkSheetCellAttr *dst,
+    const GtkSheetCellAttr *src, guint mask)
+{
+    if (mask & GTK_SHEET_ATTR_BACKGROUND)
+	dst->background = src->background;
+    if (mask & GTK_SHEET_ATTR_FOREGROUND)
+	dst->foreground = src->foreground;
+    if (mask & GTK_SHEET_ATTR_JUSTIFICATION)
+	dst->justification = src->justification;
+    if (mask & GTK_SHEET_ATTR_FONT)
+	dst->font_desc = src->font_desc;
+    if (mask & GTK_SHEET_ATTR_BORDER)
+    {
+	dst->border.mask = src->border.mask;
+	dst->border.width = src->border.width;
+	dst->border.line_style = src->border.line_style;
+	dst->border.cap_style = src->border.cap_style;
+	dst->border.join_style = src->border.join_style;
+    }
+    if (mask & GTK_SHEET_ATTR_BORDER_COLOR)
+	dst->border.color = src->border.color;
+    if (mask & GTK_SHEET_ATTR_EDITABLE)
+	dst->is_editable = src->is_editable;
+    if (mask & GTK_SHEET_ATTR_VISIBLE)
+	dst->is_visible = src->is_visible;
+    if (mask & GTK_SHEET_ATTR_SENSITIVE)
+	dst->is_sensitive = src->is_sensitive;
+    if (mask & GTK_SHEET_ATTR_CAN_FOCUS)
+	dst->can_focus = src->can_focus;
 }
 
 /*
- * hadjustment_value_changed_handler:
+ * _gtk_sheet_attr_diff - find differing attribute fields
  * 
- * this is the #GtkSheet horizontal adjustment "value-changed" handler
+ * @param a
+ * @param b
  * 
- * @param adjustment the #GtkAdjustment that received the signal
- * @param data       the #GtkSheet passed on signal creation
+ * @return GTK_SHEET_ATTR_* mask of fields that differ
  */
-static void
-_hadjustment_value_changed_handler(GtkAdjustment *adjustment, gpointer data)
+static guint
+_gtk_sheet_attr_diff(const GtkSheetCellAttr *a, const GtkSheetCellAttr *b)
 {
-    GtkSheet *sheet;
-    gint old_value;
+    guint mask = 0;
 
-    g_return_if_fail(adjustment != NULL);
-    g_return_if_fail(data != NULL);
-    g_return_if_fail(GTK_IS_SHEET(data));
+    if (!_color_equal(&a->background, &b->background))
+	mask |= GTK_SHEET_ATTR_BACKGROUND;
+    if (!_color_equal(&a->foreground, &b->foreground))
+	mask |= GTK_SHEET_ATTR_FOREGROUND;
+    if (a->justification != b->justification)
+	mask |= GTK_SHEET_ATTR_JUSTIFICATION;
+    if (!_font_desc_equal(a->font_desc, b->font_desc))
+	mask |= GTK_SHEET_ATTR_FONT;
+    if (a->border.mask != b->border.mask
+	|| a->border.width != b->border.width
+	|| a->border.line_style != b->border.line_style
+	|| a->border.cap_style != b->border.cap_style
+	|| a->border.join_style != b->border.join_style)
+	mask |= GTK_SHEET_ATTR_BORDER;
+    if (!_color_equal(&a->border.color, &b->border.color))
+	mask |= GTK_SHEET_ATTR_BORDER_COLOR;
+    if (!a->is_editable != !b->is_editable)
+	mask |= GTK_SHEET_ATTR_EDITABLE;
+    if (!a->is_visible != !b->is_visible)
+	mask |= GTK_SHEET_ATTR_VISIBLE;
+    if (!a->is_sensitive != !b->is_sensitive)
+	mask |= GTK_SHEET_ATTR_SENSITIVE;
+    if (!a->can_focus != !b->can_focus)
+	mask |= GTK_SHEET_ATTR_CAN_FOCUS;
 
-    sheet = GTK_SHEET(data);
+    return (mask);
+}
 
-#if GTK_SHEET_DEBUG_ADJUSTMENT > 0
-    g_debug("_hadjustment_value_changed_handler: called: O HA %g HO %d",
-	sheet->old_hadjustment, sheet->hoffset);
-#endif
+static GtkSheetAttrTable *
+_gtk_sheet_attr_table_new(void)
+{
+    GtkSheetAttrTable *table = g_new(GtkSheetAttrTable, 1);
 
-    if (GTK_SHEET_IS_FROZEN(sheet))
-	return;
+    table->entries = g_ptr_array_new();
+    g_ptr_array_add(table->entries, NULL);  /* id 0: no override */
 
-#if 0
-    if (sheet->row_titles_visible) col = _gtk_sheet_column_from_xpixel(sheet, sheet->row_title_area.width + CELL_SPACING);
-    else
-    col = _gtk_sheet_column_from_xpixel(sheet, CELL_SPACING);
+    table->lookup = g_hash_table_new(_gtk_sheet_attr_hash, _gtk_sheet_attr_equal);
+    table->free_ids = g_array_new(FALSE, FALSE, sizeof(guint));
 
-    old_value = -sheet->hoffset;
+    return (table);
+}
 
-    for (i = 0; i < sheet->maxcol; i++)  /* all but the last column */
-    {
-	if (GTK_SHEET_COLUMN_IS_VISIBLE(COLPTR(sheet, i))) x += COLPTR(sheet, i)->width;
-	if (x > adjustment->value) break;
-    }
-    if (0 <= i && i <= sheet->maxcol) x -= COLPTR(sheet, i)->width;
-    new_col = i;
+static void
+_gtk_sheet_attr_entry_free(GtkSheetAttrEntry *entry)
+{
+    if (entry->attributes.font_desc && entry->attributes.do_font_desc_free)
+	pango_font_description_free(entry->attributes.font_desc);
+    g_free(entry);
+}
 
-    x = MAX(x, 0);
+static void
+_gtk_sheet_attr_table_free(GtkSheetAttrTable *table)
+{
+    guint i;
 
-#if 0
-    if (adjustment->value > sheet->old_hadjustment && sheet->old_hadjustment > 0 &&
-	0 <= new_col && new_col <= sheet->maxcol &&
-	COLPTR(sheet, new_col)->width > sheet->hadjustment->step_increment)
-    {
-	/* This avoids embarrassing twitching */
-	if (col == new_col && col != sheet->maxcol &&
-	    adjustment->value - sheet->old_hadjustment >=
-	    sheet->hadjustment->step_increment &&
-	    new_col + 1 != MIN_VISIBLE_COLUMN(sheet))
-	{
-	    new_col+=1;
-	    x=x+COLPTR(sheet, col)->width;
-	}
-    }
-#else
-    if (adjustment->value > sheet->old_hadjustment && sheet->old_hadjustment > 0 &&
-	0 <= new_col && new_col <= sheet->maxcol &&
-	COLPTR(sheet, new_col)->width > sheet->hadjustment->step_increment)
-    {
-	new_col += 1;
-	x = x + COLPTR(sheet, col)->width;
-    }
-#endif
+    g_hash_table_destroy(table->lookup);
 
-    /* Negative old_adjustment enforces the redraw, otherwise avoid spureous redraw */
-    if (sheet->old_hadjustment >= 0. && new_col == col)
+    for (i = 1; i < table->entries->len; i++)
     {
-	sheet->old_hadjustment = sheet->hadjustment->value;
-	return;
+	GtkSheetAttrEntry *entry = g_ptr_array_index(table->entries, i);
+
+	if (entry)
+	    _gtk_sheet_attr_entry_free(entry);
     }
+    g_ptr_array_free(table->entries, TRUE);
+    g_array_free(table->free_ids, TRUE);
+    g_free(table);
+}
 
-    sheet->old_hadjustment = sheet->hadjustment->value;
-    adjustment->value = x;
+/*
+ * _gtk_sheet_attr_intern - find or add attributes to the attribute table
+ * 
+ * @param sheet
+ * @param attributes
+ * @param mask   GTK_SHEET_ATTR_* fields taken from attributes
+ * 
+ * @return attribute id, holding a new reference, 0 for an empty mask
+ */
+static guint
+_gtk_sheet_attr_intern(GtkSheet *sheet,
+    const GtkSheetCellAttr *attributes, guint mask)
+{
+    GtkSheetAttrTable *table = sheet->attr_table;
+    GtkSheetAttrEntry key, *entry;
 
-    if (new_col < 0 || new_col > sheet->maxcol)
+    if (!mask)
+	return (0);
+
+    memset(&key, 0, sizeof(key));
+    key.mask = mask;
+    _gtk_sheet_attr_copy_fields(&key.attributes, attributes, mask);
+
+    if (key.attributes.font_desc ==
+	gtk_widget_get_style(GTK_WIDGET(sheet))->font_desc)
     {
-	sheet->hadjustment->step_increment = GTK_SHEET_COLUMN_DEFAULT_WIDTH;
+	key.attributes.font_desc = NULL;  /* follow widget style */
     }
-    else if (new_col == 0)
+
+    entry = g_hash_table_lookup(table->lookup, &key);
+    if (entry)
     {
-	sheet->hadjustment->step_increment = COLPTR(sheet, 0)->width;
+	entry->ref_count++;
+	return (entry->id);
     }
-    else
+
+    entry = g_new(GtkSheetAttrEntry, 1);
+    *entry = key;
+    entry->ref_count = 1;
+
+    if (entry->attributes.font_desc)
     {
-	sheet->hadjustment->step_increment =
-	MIN(COLPTR(sheet, new_col)->width, COLPTR(sheet, new_col - 1)->width);
+	entry->attributes.font_desc =
+	    pango_font_description_copy(entry->attributes.font_desc);  /* copy */
+	entry->attributes.do_font_desc_free = TRUE;
     }
 
-    sheet->hadjustment->value = adjustment->value;
-    value = adjustment->value;
-
-    if (value >= -sheet->hoffset)
+    if (table->free_ids->len > 0)
     {
-	/* scroll right */
-	diff = value + sheet->hoffset;
+	entry->id = g_array_index(table->free_ids, guint, table->free_ids->len - 1);
+	g_array_set_size(table->free_ids, table->free_ids->len - 1);
+	g_ptr_array_index(table->entries, entry->id) = entry;
     }
     else
     {
-	/* scroll left */
-	diff = -sheet->hoffset - value;
+	entry->id = table->entries->len;
+	g_ptr_array_add(table->entries, entry);
     }
 
-    sheet->hoffset = -value;
-#else
-    /* Negative old_adjustment enforces the redraw, otherwise avoid spureous redraw */
-    old_value = sheet->old_hadjustment;
-    sheet->old_hadjustment = gtk_adjustment_get_value(sheet->hadjustment);
+    g_hash_table_insert(table->lookup, entry, entry);
 
-    if (old_value >= 0. && sheet->hoffset == -1 *  gtk_adjustment_get_value(adjustment))
+#if GTK_SHEET_DEBUG_ALLOCATION > 0
+    g_debug("_gtk_sheet_attr_intern: new id %d, %d in use",
+	entry->id, g_hash_table_size(table->lookup));
+#endif
+
+    return (entry->id);
+}
+
+static void
+_gtk_sheet_attr_ref(GtkSheet *sheet, guint id)
+{
+    GtkSheetAttrEntry *entry;
+
+    if (!id)
 	return;
 
-    gdouble value = gtk_adjustment_get_value(adjustment);
-    gtk_adjustment_set_value(sheet->hadjustment, value);
-    sheet->hoffset = -value;
-#endif
+    entry = g_ptr_array_index(sheet->attr_table->entries, id);
+    g_return_if_fail(entry != NULL);
 
-    _gtk_sheet_recalc_view_range(sheet);
+    entry->ref_count++;
+}
 
-    if (gtk_widget_get_realized(sheet->sheet_entry) &&
-	sheet->state == GTK_SHEET_NORMAL &&
-	sheet->active_cell.row >= 0 && sheet->active_cell.col >= 0 &&
-	!gtk_sheet_cell_isvisible(sheet, sheet->active_cell.row, sheet->active_cell.col))
-    {
-        /* PR#211566 - removed gtk_sheet_cell_clear() */
-	gtk_widget_unmap(sheet->sheet_entry);
-    }
+static void
+_gtk_sheet_attr_unref(GtkSheet *sheet, guint id)
+{
+    GtkSheetAttrTable *table = sheet->attr_table;
+    GtkSheetAttrEntry *entry;
 
-    gtk_sheet_position_children(sheet);
+    if (!id)
+	return;
 
-    size_allocate_global_button(sheet);
-    _gtk_sheet_column_buttons_size_allocate(sheet);
+    entry = g_ptr_array_index(table->entries, id);
+    g_return_if_fail(entry != NULL);
 
-    _gtk_sheet_range_draw(sheet, NULL, TRUE);
+    if (--entry->ref_count > 0)
+	return;
+
+    g_hash_table_remove(table->lookup, entry);
+    g_ptr_array_index(table->entries, id) = NULL;
+    g_array_append_val(table->free_ids, id);
+
+    _gtk_sheet_attr_entry_free(entry);
 }
 
+static const GtkSheetAttrEntry *
+_gtk_sheet_attr_lookup(GtkSheet *sheet, guint id)
+{
+    return (g_ptr_array_index(sheet->attr_table->entries, id));
+}
 
-/* COLUMN RESIZING */
-static void
-draw_xor_vline(GtkSheet *sheet)
+/*
+ * attribute layers
+ *
+ * Range styling is not materialized per cell. Ranges spanning whole
+ * columns or rows store their fields in a column or row layer, other
+ * large ranges become range rules. Every layer field carries the
+ * serial of the update that set it, of all layers covering a cell the
+ * most recent one wins per field. Per cell overrides apply on top, a
+ * layer update strips the fields it sets from the overrides within
+ * its range.
+ *
+ * Range rules are indexed by block row (band), a lookup only tests the
+ * rules covering the band of the cell. Styling a band which holds
+ * GTK_SHEET_ATTR_RULES_PER_BAND rules already falls back to per cell
+ * overrides, so lookups stay bounded however often ranges are styled.
+ */
+
+#define GTK_SHEET_ATTR_RULE_MIN_CELLS  1024  /* smaller ranges go per cell */
+#define GTK_SHEET_ATTR_RULES_PER_BAND  32    /* rules covering a block row */
+
+struct _GtkSheetAttrLayer
 {
-    GtkWidget *widget;
+    guint mask;                            /* GTK_SHEET_ATTR_* fields set */
+    guint serial[GTK_SHEET_ATTR_NFIELDS];  /* update serial per field */
+    GtkSheetCellAttr attributes;           /* font_desc owned by the layer */
+};
 
-    g_return_if_fail(sheet != NULL);
+typedef struct _GtkSheetAttrRule
+{
+    GtkSheetRange range;
+    GtkSheetAttrLayer layer;
+} GtkSheetAttrRule;
 
-    widget = GTK_WIDGET(sheet);
+static void
+_gtk_sheet_attr_layer_clear(GtkSheetAttrLayer *layer, guint fields)
+{
+    if ((layer->mask & fields & GTK_SHEET_ATTR_FONT) && layer->attributes.font_desc)
+    {
+	pango_font_description_free(layer->attributes.font_desc);
+	layer->attributes.font_desc = NULL;
+    }
+    layer->mask &= ~fields;
+}
 
-    gdk_draw_line(gtk_widget_get_window(widget), sheet->xor_gc,
-	sheet->x_drag,
-	sheet->column_title_area.height,
-	sheet->x_drag,
-	sheet->sheet_window_height + 1);
+static void
+_gtk_sheet_attr_layer_free(GtkSheetAttrLayer *layer)
+{
+    if (!layer)
+	return;
+
+    _gtk_sheet_attr_layer_clear(layer, GTK_SHEET_ATTR_ALL);
+    g_free(layer);
 }
 
-/* ROW RESIZING */
+/*
+ * _gtk_sheet_attr_layer_set - set layer fields
+ * 
+ * @param layer
+ * @param fields  GTK_SHEET_ATTR_* fields set by func
+ * @param serial  update serial
+ * @param func    attribute modifier
+ * @param data    passed to func
+ */
 static void
-draw_xor_hline(GtkSheet *sheet)
+_gtk_sheet_attr_layer_set(GtkSheetAttrLayer *layer,
+    guint fields, guint serial, GtkSheetAttrFunc func, gpointer data)
 {
-    GtkWidget *widget;
+    GtkSheetCellAttr values;
+    gint f;
 
-    g_return_if_fail(sheet != NULL);
+    memset(&values, 0, sizeof(values));
+    (*func)(&values, data);
 
-    widget = GTK_WIDGET(sheet);
+    _gtk_sheet_attr_layer_clear(layer, fields & GTK_SHEET_ATTR_FONT);
 
-    gdk_draw_line(gtk_widget_get_window(widget), sheet->xor_gc,
-	sheet->row_title_area.width,
-	sheet->y_drag,
-	sheet->sheet_window_width + 1,
-	sheet->y_drag);
+    if ((fields & GTK_SHEET_ATTR_FONT) && values.font_desc)
+	values.font_desc = pango_font_description_copy(values.font_desc);
+
+    _gtk_sheet_attr_copy_fields(&layer->attributes, &values, fields);
+    layer->mask |= fields;
+
+    for (f = 0; f < GTK_SHEET_ATTR_NFIELDS; f++)
+    {
+	if (fields & (1 << f))
+	    layer->serial[f] = serial;
+    }
 }
 
-/* SELECTED RANGE */
 static void
-draw_xor_rectangle(GtkSheet *sheet, GtkSheetRange range)
+_gtk_sheet_attr_layer_apply(const GtkSheetAttrLayer *layer,
+    GtkSheetCellAttr *attributes, guint *serial)
 {
-    gint i;
-    GdkRectangle clip_area, area;
-    GdkGCValues values;
+    gint f;
 
-    if (range.col0 < 0 || range.coli < 0 || range.row0 < 0 || range.rowi < 0)
-	return;  /* PR#203012 */
+    for (f = 0; f < GTK_SHEET_ATTR_NFIELDS; f++)
+    {
+	if ((layer->mask & (1 << f)) && layer->serial[f] > serial[f])
+	{
+	    _gtk_sheet_attr_copy_fields(attributes, &layer->attributes, 1 << f);
+	    serial[f] = layer->serial[f];
+	}
+    }
+}
 
-    area.x = _gtk_sheet_column_left_xpixel(sheet, range.col0);
-    area.y = _gtk_sheet_row_top_ypixel(sheet, range.row0);
-    area.width = _gtk_sheet_column_left_xpixel(sheet, range.coli) - area.x +
-	COLPTR(sheet, range.coli)->width;
-    area.height = _gtk_sheet_row_top_ypixel(sheet, range.rowi) - area.y +
-	sheet->row[range.rowi].height;
+static void
+_gtk_sheet_attr_rule_free(GtkSheetAttrRule *rule)
+{
+    _gtk_sheet_attr_layer_clear(&rule->layer, GTK_SHEET_ATTR_ALL);
+    g_free(rule);
+}
 
-    clip_area.x = sheet->row_title_area.width;
-    clip_area.y = sheet->column_title_area.height;
-    clip_area.width = sheet->sheet_window_width;
-    clip_area.height = sheet->sheet_window_height;
+/*
+ * _gtk_sheet_attr_rules_index_add - enter a rule into the bands 
+ * it covers
+ * 
+ * @param sheet
+ * @param rule
+ */
+static void
+_gtk_sheet_attr_rules_index_add(GtkSheet *sheet, GtkSheetAttrRule *rule)
+{
+    GPtrArray *bands = sheet->attr_rule_bands;
+    guint b, bi = BLOCK_ROW_IDX(rule->range.rowi);
 
-    if (!sheet->row_titles_visible)
-	clip_area.x = 0;
-    if (!sheet->column_titles_visible)
-	clip_area.y = 0;
+    if (bands->len <= bi)
+	g_ptr_array_set_size(bands, bi + 1);
 
-    if (area.x < 0)
+    for (b = BLOCK_ROW_IDX(rule->range.row0); b <= bi; b++)
     {
-	area.width = area.width + area.x;
-	area.x = 0;
+	if (!g_ptr_array_index(bands, b))
+	    g_ptr_array_index(bands, b) = g_ptr_array_new();
+
+	g_ptr_array_add(g_ptr_array_index(bands, b), rule);
     }
-    if (area.width > clip_area.width)
-	area.width = clip_area.width + 10;
-    if (area.y < 0)
+}
+
+/*
+ * _gtk_sheet_attr_rules_index_remove - remove a rule from the 
+ * bands it covers
+ * 
+ * @param sheet
+ * @param rule
+ */
+static void
+_gtk_sheet_attr_rules_index_remove(GtkSheet *sheet, GtkSheetAttrRule *rule)
+{
+    GPtrArray *bands = sheet->attr_rule_bands;
+    guint b;
+
+    for (b = BLOCK_ROW_IDX(rule->range.row0);
+	b <= BLOCK_ROW_IDX(rule->range.rowi) && b < bands->len; b++)
     {
-	area.height = area.height + area.y;
-	area.y = 0;
+	GPtrArray *band = g_ptr_array_index(bands, b);
+
+	if (band)
+	    g_ptr_array_remove_fast(band, rule);
     }
-    if (area.height > clip_area.height)
-	area.height = clip_area.height + 10;
+}
 
-    clip_area.x--;
-    clip_area.y--;
-    clip_area.width += 3;
-    clip_area.height += 3;
+/*
+ * _gtk_sheet_attr_rules_index_clear - empty the band index
+ * 
+ * @param sheet
+ */
+static void
+_gtk_sheet_attr_rules_index_clear(GtkSheet *sheet)
+{
+    GPtrArray *bands = sheet->attr_rule_bands;
+    guint b;
 
-    gdk_gc_get_values(sheet->xor_gc, &values);
+    for (b = 0; b < bands->len; b++)
+    {
+	if (g_ptr_array_index(bands, b))
+	    g_ptr_array_free(g_ptr_array_index(bands, b), TRUE);
+    }
+    g_ptr_array_set_size(bands, 0);
+}
 
-    gdk_gc_set_clip_rectangle(sheet->xor_gc, &clip_area);
+/*
+ * _gtk_sheet_attr_rules_crowded - check whether a band within 
+ * rows row0..rowi is full
+ * 
+ * @param sheet
+ * @param range
+ * 
+ * @return TRUE if the range should not get another rule
+ */
+static gboolean
+_gtk_sheet_attr_rules_crowded(GtkSheet *sheet, const GtkSheetRange *range)
+{
+    GPtrArray *bands = sheet->attr_rule_bands;
+    guint b;
 
-    for (i = -1; i <= 1; ++i) gdk_draw_rectangle(sheet->sheet_window,
-	    sheet->xor_gc,
-	    FALSE,
-	    area.x + i, area.y + i,
-	    area.width - 2 * i, area.height - 2 * i);
+    for (b = BLOCK_ROW_IDX(range->row0);
+	b <= BLOCK_ROW_IDX(range->rowi) && b < bands->len; b++)
+    {
+	GPtrArray *band = g_ptr_array_index(bands, b);
+
+	if (band && band->len >= GTK_SHEET_ATTR_RULES_PER_BAND)
+	    return (TRUE);
+    }
+    return (FALSE);
+}
+
+/*
+ * _gtk_sheet_attr_rules_find - find the rule of a range
+ * 
+ * @param sheet
+ * @param range
+ * 
+ * @return the rule with exactly this range or NULL
+ */
+static GtkSheetAttrRule *
+_gtk_sheet_attr_rules_find(GtkSheet *sheet, const GtkSheetRange *range)
+{
+    GPtrArray *bands = sheet->attr_rule_bands;
+    GPtrArray *band;
+    guint i;
 
+    if (BLOCK_ROW_IDX(range->row0) >= bands->len)
+	return (NULL);
 
-    gdk_gc_set_clip_rectangle(sheet->xor_gc, NULL);
+    band = g_ptr_array_index(bands, BLOCK_ROW_IDX(range->row0));
+    if (!band)
+	return (NULL);
 
-    gdk_gc_set_foreground(sheet->xor_gc, &values.foreground);
+    for (i = 0; i < band->len; i++)
+    {
+	GtkSheetAttrRule *rule = g_ptr_array_index(band, i);
+
+	if (_RECT_EQ_RANGE(rule->range.row0, rule->range.rowi,
+	    rule->range.col0, rule->range.coli, range))
+	{
+	    return (rule);
+	}
+    }
+    return (NULL);
 }
 
+static void
+_gtk_sheet_attr_rules_free(GtkSheet *sheet)
+{
+    g_list_foreach(sheet->attr_rules, (GFunc)_gtk_sheet_attr_rule_free, NULL);
+    g_list_free(sheet->attr_rules);
+    sheet->attr_rules = NULL;
 
-/* this function returns the new width of the column being resized given
- * the column and x position of the cursor; the x cursor position is passed
- * in as a pointer and automaticaly corrected if it's beyond min/max limits */
+    if (sheet->attr_rule_bands)
+    {
+	_gtk_sheet_attr_rules_index_clear(sheet);
+	g_ptr_array_free(sheet->attr_rule_bands, TRUE);
+	sheet->attr_rule_bands = NULL;
+    }
+}
 
-static guint
-new_column_width(GtkSheet *sheet, gint col, gint *x)
+/*
+ * _gtk_sheet_attr_rules_prune - drop superseded range rule fields
+ * 
+ * Rule fields within range are hidden by an update of the same 
+ * fields and are removed, rules left empty are deleted.
+ * 
+ * @param sheet
+ * @param range
+ * @param fields  GTK_SHEET_ATTR_* fields updated
+ */
+static void
+_gtk_sheet_attr_rules_prune(GtkSheet *sheet,
+    const GtkSheetRange *range, guint fields)
 {
-    gint cx, width;
-    GtkRequisition requisition;
+    GList *list = sheet->attr_rules;
+
+    while (list)
+    {
+	GList *next = list->next;
+	GtkSheetAttrRule *rule = list->data;
+
+	if (_RECT_IN_RANGE(rule->range.row0, rule->range.rowi,
+	    rule->range.col0, rule->range.coli, range))
+	{
+	    _gtk_sheet_attr_layer_clear(&rule->layer, fields);
+
+	    if (!rule->layer.mask)
+	    {
+		_gtk_sheet_attr_rules_index_remove(sheet, rule);
+		_gtk_sheet_attr_rule_free(rule);
+		sheet->attr_rules = g_list_delete_link(sheet->attr_rules, list);
+	    }
+	}
+	list = next;
+    }
+}
 
-#if GTK_SHEET_DEBUG_SIZE > 0
-    g_debug("new_column_width: called");
-#endif
+/*
+ * _gtk_sheet_attr_rules_adjust - adjust range rules to inserted or 
+ * deleted rows or columns
+ * 
+ * @param sheet
+ * @param rows      TRUE for rows, FALSE for columns
+ * @param position  first row or column inserted or deleted
+ * @param n         number inserted (> 0) or deleted (< 0)
+ */
+static void
+_gtk_sheet_attr_rules_adjust(GtkSheet *sheet,
+    gboolean rows, gint position, gint n)
+{
+    GList *list = sheet->attr_rules;
 
-    cx = *x;
+    if (!list)
+	return;
 
-    requisition.width = COLPTR(sheet, col)->requisition;
+    /* band membership changes, index again below */
+    _gtk_sheet_attr_rules_index_clear(sheet);
 
-    /* you can't shrink a column to less than its minimum width */
-    if (cx < _gtk_sheet_column_left_xpixel(sheet, col) + requisition.width)
+    while (list)
     {
-	*x = cx = _gtk_sheet_column_left_xpixel(sheet, col) + requisition.width;
-    }
+	GList *next = list->next;
+	GtkSheetAttrRule *rule = list->data;
+	gint *lo = rows ? &rule->range.row0 : &rule->range.col0;
+	gint *hi = rows ? &rule->range.rowi : &rule->range.coli;
 
-    /* don't grow past the end of the window */
-    /*
-    if (cx > sheet->sheet_window_width)
-      {
-    *x = cx = sheet->sheet_window_width;
-      }
-      */
+	if (n > 0)
+	{
+	    if (position <= *lo)
+		*lo += n;
+	    if (position <= *hi)
+		*hi += n;
+	}
+	else
+	{
+	    gint end = position - n;  /* first behind deleted */
 
-    /* calculate new column width making sure it doesn't end up
-     * less than the minimum width */
-    width = cx - _gtk_sheet_column_left_xpixel(sheet, col);
-    if (width < requisition.width)
-	width = requisition.width;
+	    if (*lo >= end)
+		*lo += n;
+	    else if (*lo > position)
+		*lo = position;
 
-    COLPTR(sheet, col)->width = width;
-    _gtk_sheet_recalc_left_xpixels(sheet);
-    _gtk_sheet_recalc_view_range(sheet);
+	    if (*hi >= end)
+		*hi += n;
+	    else if (*hi >= position)
+		*hi = position - 1;
 
-    _gtk_sheet_column_buttons_size_allocate(sheet);
+	    if (*lo > *hi)
+	    {
+		_gtk_sheet_attr_rule_free(rule);
+		sheet->attr_rules = g_list_delete_link(sheet->attr_rules, list);
+	    }
+	}
+	list = next;
+    }
 
-    return (width);
+    for (list = sheet->attr_rules; list; list = list->next)
+	_gtk_sheet_attr_rules_index_add(sheet, list->data);
 }
 
-/* this function returns the new height of the row being resized given
- * the row and y position of the cursor; the y cursor position is passed
- * in as a pointer and automaticaly corrected if it's beyond min/max limits */
-
-static guint
-new_row_height(GtkSheet *sheet, gint row, gint *y)
+/*
+ * _gtk_sheet_layered_attributes - resolve attributes without per cell 
+ * overrides
+ * 
+ * @param sheet
+ * @param row, col    a valid cell
+ * @param attributes  result
+ */
+static void
+_gtk_sheet_layered_attributes(GtkSheet *sheet,
+    gint row, gint col, GtkSheetCellAttr *attributes)
 {
-    GtkRequisition requisition;
-    gint cy, height;
-
-    cy = *y;
+    guint serial[GTK_SHEET_ATTR_NFIELDS] = { 0 };
+    GPtrArray *band = NULL;
+    guint i;
 
-    requisition.height = sheet->row[row].requisition;
+    init_attributes(sheet, col, attributes);
 
-    /* you can't shrink a row to less than its minimum height */
-    if (cy < _gtk_sheet_row_top_ypixel(sheet, row) + requisition.height)
-    {
-	*y = cy = _gtk_sheet_row_top_ypixel(sheet, row) + requisition.height;
-    }
+    if (COLPTR(sheet, col)->attr_layer)
+	_gtk_sheet_attr_layer_apply(COLPTR(sheet, col)->attr_layer, attributes, serial);
 
-    /* don't grow past the end of the window */
-    /*
-    if (cy > sheet->sheet_window_height)
-      {
-    *y = cy = sheet->sheet_window_height;
-      }
-      */
+    if (ROW_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_STYLED))
+	_gtk_sheet_attr_layer_apply(_gtk_sheet_row_peek(sheet, row)->attr_layer,
+	    attributes, serial);
 
-    /* calculate new row height making sure it doesn't end up
-     * less than the minimum height */
-    height = (cy - _gtk_sheet_row_top_ypixel(sheet, row));
-    if (height < requisition.height)
-	height = requisition.height;
+    if (BLOCK_ROW_IDX(row) < sheet->attr_rule_bands->len)
+	band = g_ptr_array_index(sheet->attr_rule_bands, BLOCK_ROW_IDX(row));
 
-    sheet->row[row].height = height;
-    _gtk_sheet_recalc_top_ypixels(sheet);
-    _gtk_sheet_recalc_view_range(sheet);
+    for (i = 0; band && i < band->len; i++)
+    {
+	GtkSheetAttrRule *rule = g_ptr_array_index(band, i);
 
-    size_allocate_row_title_buttons(sheet);
+	if (_POINT_IN_RANGE(row, col, &rule->range))
+	    _gtk_sheet_attr_layer_apply(&rule->layer, attributes, serial);
+    }
 
-    return (height);
+    if (!attributes->font_desc)  /* follow widget style */
+	attributes->font_desc = gtk_widget_get_style(GTK_WIDGET(sheet))->font_desc;
 }
 
-
-/**
- * gtk_sheet_set_row_height:
- * @sheet: a #GtkSheet.
- * @row: row number.
- * @height: row height(in pixels).
- *
- * Set row height.
+/*
+ * _gtk_sheet_cell_override - set or drop per cell attribute fields
+ * 
+ * @param sheet
+ * @param row, col    a valid cell
+ * @param attributes  field values
+ * @param set         GTK_SHEET_ATTR_* fields taken from attributes
+ * @param unset       GTK_SHEET_ATTR_* fields dropped from the override
  */
-void
-gtk_sheet_set_row_height(GtkSheet *sheet, gint row, guint height)
+static void
+_gtk_sheet_cell_override(GtkSheet *sheet, gint row, gint col,
+    const GtkSheetCellAttr *attributes, guint set, guint unset)
 {
-    guint min_height;
+    GtkSheetCell *cell = _gtk_sheet_cell_get(sheet, row, col);
+    GtkSheetCellAttr values;
+    guint mask = 0;
+    guint id;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    memset(&values, 0, sizeof(values));
 
-    if (row < 0 || row > sheet->maxrow)
-	return;
+    if (cell && cell->attr_id)
+    {
+	const GtkSheetAttrEntry *entry = _gtk_sheet_attr_lookup(sheet, cell->attr_id);
 
-    gtk_sheet_row_size_request(sheet, row, &min_height);
+	values = entry->attributes;
+	mask = entry->mask;
+    }
 
-    if (height < min_height) height = min_height;
+    _gtk_sheet_attr_copy_fields(&values, attributes, set);
+    mask = (mask | set) & ~unset;
+
+    if (!cell)
+    {
+	if (!mask)
+	    return;
 
-    sheet->row[row].height = height;
+	CheckCellData(sheet, row, col);
+	cell = _gtk_sheet_cell_get(sheet, row, col);
+    }
 
-    _gtk_sheet_recalc_top_ypixels(sheet);
+    id = _gtk_sheet_attr_intern(sheet, &values, mask);  /* before unref, might be the same */
+    _gtk_sheet_attr_unref(sheet, cell->attr_id);
+    cell->attr_id = id;
 
-    if (gtk_widget_get_realized(GTK_WIDGET(sheet)) 
-        && !GTK_SHEET_IS_FROZEN(sheet))
+    if ((set | unset) & GTK_SHEET_ATTR_VISIBLE)
     {
-	size_allocate_row_title_buttons(sheet);
-	_gtk_sheet_scrollbar_adjust(sheet);
-	_gtk_sheet_entry_size_allocate(sheet);
-	_gtk_sheet_range_draw(sheet, NULL, TRUE);
+	GtkSheetRange range;
+
+	range.row0 = range.rowi = row;
+	range.col0 = range.coli = col;
+
+	_gtk_sheet_recount_extents(sheet, &range);
     }
+}
 
-    g_signal_emit(GTK_OBJECT(sheet), 
-                  sheet_signals[NEW_ROW_HEIGHT], 0, row, height);
+static void
+gtk_sheet_set_cell_attributes(GtkSheet *sheet,
+    gint row, gint col,
+    GtkSheetCellAttr attributes)
+{
+    GtkSheetCellAttr base;
+    guint mask;
+
+    if (row < 0 || row > sheet->maxrow)
+	return;
+    if (col < 0 || col > sheet->maxcol)
+	return;
+
+    /* override only what differs from the layers */
+    _gtk_sheet_layered_attributes(sheet, row, col, &base);
+    mask = _gtk_sheet_attr_diff(&base, &attributes);
+
+    _gtk_sheet_cell_override(sheet, row, col,
+	&attributes, mask, GTK_SHEET_ATTR_ALL & ~mask);
 }
 
-/**
- * gtk_sheet_add_column:
- * @sheet: a #GtkSheet.
- * @ncols: number of columns to be appended.
- *
- * Append @ncols columns to the right of the sheet.
+/*
+ * _gtk_sheet_range_strip_attributes - drop per cell override fields 
+ * within a range
+ * 
+ * @param sheet
+ * @param range
+ * @param fields  GTK_SHEET_ATTR_* fields to be dropped
  */
-void
-gtk_sheet_add_column(GtkSheet *sheet, guint ncols)
+static void
+_gtk_sheet_range_strip_attributes(GtkSheet *sheet,
+    const GtkSheetRange *range, guint fields)
 {
+    GPtrArray *cells;
+    GHashTable *memo;
+    GHashTableIter iter;
+    gpointer key, value;
+    guint i;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    cells = CollectCellData(sheet, range->row0, range->rowi, range->col0, range->coli);
+    memo = g_hash_table_new(g_direct_hash, g_direct_equal);  /* old id -> new id */
 
-    AddColumns(sheet, sheet->maxcol + 1, ncols);
+    for (i = 0; i < cells->len; i++)
+    {
+	GtkSheetCell *cell = g_ptr_array_index(cells, i);
+	const GtkSheetAttrEntry *entry;
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
+	if (!cell->attr_id)
+	    continue;
 
-    _gtk_sheet_scrollbar_adjust(sheet);
+	entry = _gtk_sheet_attr_lookup(sheet, cell->attr_id);
+	if (!(entry->mask & fields))
+	    continue;
 
-    if (sheet->state == GTK_SHEET_ROW_SELECTED)
-	sheet->range.coli += ncols;
+	key = GUINT_TO_POINTER(cell->attr_id);
 
-    _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
+	if (!g_hash_table_lookup_extended(memo, key, NULL, &value))
+	{
+	    value = GUINT_TO_POINTER(_gtk_sheet_attr_intern(sheet,
+		&entry->attributes, entry->mask & ~fields));
+	    _gtk_sheet_attr_ref(sheet, cell->attr_id);  /* keep key valid */
+
+	    g_hash_table_insert(memo, key, value);
+	}
+
+	_gtk_sheet_attr_ref(sheet, GPOINTER_TO_UINT(value));
+	_gtk_sheet_attr_unref(sheet, cell->attr_id);
+	cell->attr_id = GPOINTER_TO_UINT(value);
+    }
+
+    g_hash_table_iter_init(&iter, memo);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+	_gtk_sheet_attr_unref(sheet, GPOINTER_TO_UINT(key));
+	_gtk_sheet_attr_unref(sheet, GPOINTER_TO_UINT(value));
+    }
+    g_hash_table_destroy(memo);
+    g_ptr_array_free(cells, TRUE);
 }
 
-/**
- * gtk_sheet_add_row:
- * @sheet: a #GtkSheet.
- * @nrows: number of rows to be appended.
- *
- * Append @nrows rows to the end of the sheet.
+/*
+ * _gtk_sheet_range_modify_attributes - modify cell attributes of a range
+ * 
+ * Unbounded columns or rows, reaching to G_MAXINT, are styled through 
+ * their layers and so extend to rows or columns added later. Other 
+ * large ranges get a range rule, which keeps their extent, so the 
+ * cost does not depend on the number of cells. Small ranges, and large ones within bands crowded 
+ * with rules, get per cell overrides, cells sharing an override are 
+ * mapped to the same new attribute id.
+ * 
+ * @param sheet
+ * @param urange
+ * @param fields GTK_SHEET_ATTR_* fields set by func
+ * @param func   attribute modifier
+ * @param data   passed to func
  */
-void
-gtk_sheet_add_row(GtkSheet *sheet, guint nrows)
+static void
+_gtk_sheet_range_modify_attributes(GtkSheet *sheet,
+    const GtkSheetRange *urange, guint fields,
+    GtkSheetAttrFunc func, gpointer data)
 {
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    GtkSheetRange range;
+    gboolean whole_columns, whole_rows;
+    gint row, col;
+    guint serial;
 
-    AddRows(sheet, sheet->maxrow + 1, nrows);
+    range.row0 = MAX(urange->row0, 0);
+    range.rowi = MIN(urange->rowi, sheet->maxrow);
+    range.col0 = MAX(urange->col0, 0);
+    range.coli = MIN(urange->coli, sheet->maxcol);
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+    if (range.row0 > range.rowi || range.col0 > range.coli)
 	return;
 
-    if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
-	sheet->range.rowi += nrows;
+    /* only explicitly unbounded ranges, a range that happens to 
+       cover the sheet must not grow with it */
+    whole_columns = (urange->row0 <= 0 && urange->rowi == G_MAXINT);
+    whole_rows = (urange->col0 <= 0 && urange->coli == G_MAXINT);
 
-    _gtk_sheet_scrollbar_adjust(sheet);
+    if (whole_columns || whole_rows
+	|| ((gdouble)(range.rowi - range.row0 + 1) * (range.coli - range.col0 + 1)
+	    >= GTK_SHEET_ATTR_RULE_MIN_CELLS
+	    && !_gtk_sheet_attr_rules_crowded(sheet, &range)))
+    {
+	serial = ++sheet->attr_serial;
 
-    _gtk_sheet_redraw_internal(sheet, FALSE, TRUE);
-}
+	_gtk_sheet_attr_rules_prune(sheet, &range, fields);
 
-/**
- * gtk_sheet_insert_rows:
- * @sheet: a #GtkSheet.
- * @row: row number.
- * @nrows: number of rows to be inserted.
- *
- * Insert @nrows rows before the given row and pull right.
- */
-void
-gtk_sheet_insert_rows(GtkSheet *sheet, guint row, guint nrows)
-{
-    GList *children;
-    GtkSheetChild *child;
+	if (whole_columns)
+	{
+	    for (col = range.col0; col <= range.coli; col++)
+	    {
+		GtkSheetColumn *colobj = COLPTR(sheet, col);
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+		if (!colobj->attr_layer)
+		    colobj->attr_layer = g_new0(GtkSheetAttrLayer, 1);
 
-    gtk_sheet_real_unselect_range(sheet, NULL);
+		_gtk_sheet_attr_layer_set(colobj->attr_layer, fields, serial, func, data);
+	    }
+	}
+	else if (whole_rows)
+	{
+	    for (row = range.row0; row <= range.rowi; row++)
+	    {
+		GtkSheetRow *rowobj = _gtk_sheet_row_get(sheet, row);
 
-    InsertRow(sheet, row, nrows);
+		if (!rowobj->attr_layer)
+		{
+		    rowobj->attr_layer = g_new0(GtkSheetAttrLayer, 1);
+		    ROW_SET_FLAG(sheet, row, GTK_SHEET_ROW_FLAG_STYLED, TRUE);
+		}
 
-    children = sheet->children;
-    while (children)
-    {
-	child = (GtkSheetChild *)children->data;
+		_gtk_sheet_attr_layer_set(rowobj->attr_layer, fields, serial, func, data);
+	    }
+	}
+	else
+	{
+	    GtkSheetAttrRule *rule = _gtk_sheet_attr_rules_find(sheet, &range);
 
-	if (child->attached_to_cell)
-	    if (child->row >= row)
-		child->row += nrows;
+	    if (!rule)  /* restyling a range updates its rule */
+	    {
+		rule = g_new0(GtkSheetAttrRule, 1);
+		rule->range = range;
 
-	children = children->next;
-    }
+		sheet->attr_rules = g_list_prepend(sheet->attr_rules, rule);
+		_gtk_sheet_attr_rules_index_add(sheet, rule);
+	    }
+	    _gtk_sheet_attr_layer_set(&rule->layer, fields, serial, func, data);
+	}
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
+	_gtk_sheet_range_strip_attributes(sheet, &range, fields);
+    }
+    else
+    {
+	GHashTable *memo;
+	GHashTableIter iter;
+	gpointer key, value;
+	GtkSheetCellAttr values;
 
-    if (sheet->state == GTK_SHEET_COLUMN_SELECTED)
-	sheet->range.rowi += nrows;
+	memset(&values, 0, sizeof(values));
+	(*func)(&values, data);
 
-    _gtk_sheet_scrollbar_adjust(sheet);
-    _gtk_sheet_redraw_internal(sheet, FALSE, TRUE);
-}
+	memo = g_hash_table_new(g_direct_hash, g_direct_equal);  /* old id -> new id */
 
-/**
- * gtk_sheet_insert_columns:
- * @sheet: a #GtkSheet.
- * @col: column number.
- * @ncols: number of columns to be inserted.
- *
- * Insert @ncols columns before the given row and pull right.
- */
-void
-gtk_sheet_insert_columns(GtkSheet *sheet, guint col, guint ncols)
-{
-    GList *children;
-    GtkSheetChild *child;
+	for (row = range.row0; row <= range.rowi; row++)
+	{
+	    for (col = range.col0; col <= range.coli; col++)
+	    {
+		GtkSheetCell *cell = _gtk_sheet_cell_get(sheet, row, col);
+		guint old_id = cell ? cell->attr_id : 0;
+		guint new_id;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+		key = GUINT_TO_POINTER(old_id);
+		new_id = GPOINTER_TO_UINT(g_hash_table_lookup(memo, key));
 
-    gtk_sheet_real_unselect_range(sheet, NULL);
+		if (!new_id)  /* fields is not empty, new ids are never 0 */
+		{
+		    GtkSheetCellAttr attributes;
+		    guint mask = fields;
 
-    InsertColumn(sheet, col, ncols);
+		    memset(&attributes, 0, sizeof(attributes));
 
-    children = sheet->children;
-    while (children)
-    {
-	child = (GtkSheetChild *)children->data;
+		    if (old_id)
+		    {
+			const GtkSheetAttrEntry *entry = _gtk_sheet_attr_lookup(sheet, old_id);
 
-	if (child->attached_to_cell)
-	    if (child->col >= col)
-		child->col += ncols;
+			attributes = entry->attributes;
+			mask |= entry->mask;
+		    }
+		    _gtk_sheet_attr_copy_fields(&attributes, &values, fields);
 
-	children = children->next;
-    }
+		    new_id = _gtk_sheet_attr_intern(sheet, &attributes, mask);
+		    _gtk_sheet_attr_ref(sheet, old_id);  /* keep key valid */
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
+		    g_hash_table_insert(memo, key, GUINT_TO_POINTER(new_id));
+		}
 
-    if (sheet->state == GTK_SHEET_ROW_SELECTED)
-	sheet->range.coli += ncols;
+		CheckCellData(sheet, row, col);
+		cell = _gtk_sheet_cell_get(sheet, row, col);
 
-    _gtk_sheet_scrollbar_adjust(sheet);
-    _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
+		_gtk_sheet_attr_ref(sheet, new_id);
+		_gtk_sheet_attr_unref(sheet, cell->attr_id);
+		cell->attr_id = new_id;
+	    }
+	}
+
+	g_hash_table_iter_init(&iter, memo);
+	while (g_hash_table_iter_next(&iter, &key, &value))
+	{
+	    _gtk_sheet_attr_unref(sheet, GPOINTER_TO_UINT(key));
+	    _gtk_sheet_attr_unref(sheet, GPOINTER_TO_UINT(value));
+	}
+	g_hash_table_destroy(memo);
+    }
+
+    if (fields & GTK_SHEET_ATTR_VISIBLE)
+	_gtk_sheet_recount_extents(sheet, &range);
 }
 
 /**
- * gtk_sheet_delete_rows:
+ * gtk_sheet_get_attributes:
  * @sheet: a #GtkSheet.
- * @row: row number.
- * @nrows: number of rows to be deleted.
+ * @row: row number
+ * @col: column number
+ * @attributes: #GtkSheetCellAttr of the given range
  *
- * Delete @nrows rows starting from @row.
+ * Gett cell attributes of the given cell.
+ *
+ * Returns: TRUE means that the cell is currently allocated.
  */
-void
-gtk_sheet_delete_rows(GtkSheet *sheet, guint row, guint nrows)
+gboolean
+gtk_sheet_get_attributes(GtkSheet *sheet,
+    gint row, gint col,
+    GtkSheetCellAttr *attributes)
 {
-    GList *children;
-    GtkSheetChild *child;
-    gint act_row, act_col;
+    GtkSheetCell *cell;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_return_val_if_fail(sheet != NULL, FALSE);
+    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
 
-    nrows = MIN(nrows, sheet->maxrow - row + 1);
+    if ((row < 0 || row > sheet->maxrow) || (col < 0 || col > sheet->maxcol))
+    {
+	init_attributes(sheet, col, attributes);
+	return (FALSE);
+    }
 
-    act_row = sheet->active_cell.row;
-    act_col = sheet->active_cell.col;
+    _gtk_sheet_layered_attributes(sheet, row, col, attributes);
 
-    _gtk_sheet_hide_active_cell(sheet);
-    gtk_sheet_real_unselect_range(sheet, NULL);
+    if (sheet->model)  /* between styles and cell overrides */
+	gtk_sheet_model_get_cell_attributes(sheet->model, row, col, attributes);
 
-    DeleteRow(sheet, row, nrows);
+    cell = _gtk_sheet_cell_get(sheet, row, col);
 
-    children = sheet->children;
-    while (children)
+    if (cell && cell->attr_id)
     {
-	child = (GtkSheetChild *)children->data;
+	const GtkSheetAttrEntry *entry = _gtk_sheet_attr_lookup(sheet, cell->attr_id);
 
-	if (child->attached_to_cell &&
-	    child->row >= row && child->row < row + nrows &&
-	    gtk_widget_get_realized(child->widget))
-	{
-	    gtk_container_remove(GTK_CONTAINER(sheet), child->widget);
-	    children = sheet->children;
-	}
-	else
-	    children = children->next;
+	_gtk_sheet_attr_copy_fields(attributes, &entry->attributes, entry->mask);
+
+	if (!attributes->font_desc)  /* follow widget style */
+	    attributes->font_desc = gtk_widget_get_style(GTK_WIDGET(sheet))->font_desc;
     }
+    attributes->do_font_desc_free = FALSE;  /* owned by the sheet */
 
-    children = sheet->children;
-    while (children)
+    if (COLPTR(sheet, col)->justification != GTK_SHEET_COLUMN_DEFAULT_JUSTIFICATION)
     {
-	child = (GtkSheetChild *)children->data;
-
-	if (child->attached_to_cell && child->row > row)
-	    child->row -= nrows;
-	children = children->next;
+	attributes->justification = COLPTR(sheet, col)->justification;
     }
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
+    return (cell && cell->attr_id);
+}
 
-    sheet->active_cell.row = -1;
-    sheet->active_cell.col = -1;
+static void
+init_attributes(GtkSheet *sheet, gint col, GtkSheetCellAttr *attributes)
+{
+    /* DEFAULT VALUES */
+    attributes->foreground = gtk_widget_get_style(GTK_WIDGET(sheet))->black;
+    attributes->background = sheet->bg_color;
 
-/* if(sheet->state == GTK_SHEET_ROW_SELECTED)
-*/
+    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+    {
+	GdkColormap *colormap;
+	colormap = gdk_colormap_get_system();
+	gdk_color_black(colormap, &attributes->foreground);
+	attributes->background = sheet->bg_color;
+    }
 
-    act_row = MIN(act_row, sheet->maxrow);
-    act_row = MAX(act_row, 0);
+    if (col < 0 || col > sheet->maxcol)
+	attributes->justification = GTK_SHEET_COLUMN_DEFAULT_JUSTIFICATION;
+    else
+	attributes->justification = COLPTR(sheet, col)->justification;
 
-    _gtk_sheet_scrollbar_adjust(sheet);
-    _gtk_sheet_redraw_internal(sheet, FALSE, TRUE);
+    attributes->border.width = 0;
+    attributes->border.line_style = GDK_LINE_SOLID;
+    attributes->border.cap_style = GDK_CAP_NOT_LAST;
+    attributes->border.join_style = GDK_JOIN_MITER;
+    attributes->border.mask = 0;
+    attributes->border.color = gtk_widget_get_style(GTK_WIDGET(sheet))->black;
+    attributes->is_editable = TRUE;
+    attributes->is_sensitive = TRUE;
+    attributes->can_focus = TRUE;
+    attributes->is_visible = TRUE;
+    attributes->font = gtk_widget_get_style(GTK_WIDGET(sheet))->private_font;
 
-    gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
+    attributes->font_desc = 
+	gtk_widget_get_style(GTK_WIDGET(sheet))->font_desc;  /* no copy */
+    attributes->do_font_desc_free = FALSE;
 }
 
-/**
- * gtk_sheet_delete_columns:
- * @sheet: a #GtkSheet.
- * @col: column number.
- * @ncols: number of columns to be deleted.
- *
- * Delete @ncols columns starting from @col.
- */
-void
-gtk_sheet_delete_columns(GtkSheet *sheet, guint col, guint ncols)
-{
-    GList *children;
-    GtkSheetChild *child;
-    gint act_row, act_col;
-
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
-
-    ncols = MIN(ncols, sheet->maxcol - col + 1);
+/**********************************************************************
+ * Memory allocation routines:
+ * AddRow & AddColumn allocate memory for GtkSheetColumn & GtkSheetRow structs.
+ * InsertRow
+ * InsertColumn
+ * DeleteRow
+ * DeleteColumn
+ * GrowSheet extends the sparse block directory for the sheet cells contents.
+ * Cell blocks are allocated on demand by PutCellData and released when empty.
+ * CheckBounds checks whether the given cell is within the allocation bounds.
+ * If not, it calls to GrowSheet.
+ **********************************************************************/
 
-    _gtk_sheet_hide_active_cell(sheet);
-    gtk_sheet_real_unselect_range(sheet, NULL);
+static void
+AddColumns(GtkSheet *sheet, gint position, gint ncols)
+{
+    gint c;
+    GtkSheetColumn *newobj;
 
-    DeleteColumn(sheet, col, ncols);
+    g_assert(ncols >= 0);
+    g_assert(position >= 0 && position <= sheet->maxcol + 1);
 
-    children = sheet->children;
-    while (children)
+    if (ncols > 0)
     {
-	child = (GtkSheetChild *)children->data;
+	sheet->column = (GtkSheetColumn **)g_realloc(sheet->column,
+	    (sheet->maxcol + 1 + ncols)* sizeof(GtkSheetColumn *));
 
-	if (child->attached_to_cell &&
-	    child->col >= col && child->col < col + ncols &&
-	    gtk_widget_get_realized(child->widget))
+	for (c = sheet->maxcol; c >= position; c--)  /* make space */
 	{
-	    gtk_container_remove(GTK_CONTAINER(sheet), child->widget);
-	    children = sheet->children;
+	    sheet->column[c + ncols] = sheet->column[c];
+	    sheet->column[c] = NULL;
 	}
-	else
-	    children = children->next;
-    }
 
-    children = sheet->children;
-    while (children)
-    {
-	child = (GtkSheetChild *)children->data;
+	for (c = 0; c < ncols; c++)
+	{
+	    gint newidx = position + c;
 
-	if (child->attached_to_cell && child->col > col)
-	    child->col -= ncols;
-	children = children->next;
-    }
+	    newobj = g_object_new(G_TYPE_SHEET_COLUMN, NULL);
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
-	return;
+#if GTK_SHEET_DEBUG_FINALIZE > 0
+	    g_object_weak_ref(G_OBJECT(newobj), weak_notify, "Sheet-Column");
+#endif
 
-    act_row = sheet->active_cell.row;
-    act_col = sheet->active_cell.col;
+	    newobj->sheet = sheet;
+	    sheet->column[newidx] = newobj;
 
-    sheet->active_cell.row = -1;
-    sheet->active_cell.col = -1;
+	    gtk_widget_set_parent(GTK_WIDGET(newobj), GTK_WIDGET(sheet));
 
-/* if(sheet->state == GTK_SHEET_COLUMN_SELECTED)
-*/
+#if 0
+	    g_debug("Setting Column %p Parent to GtkSheet %p - got %p",
+		    newobj, sheet, gtk_widget_get_parent(GTK_WIDGET(newobj)));
+#endif
 
-    act_col = MIN(act_col, sheet->maxcol);
-    act_col = MAX(act_col, 0);
+	    g_object_ref_sink(newobj);
+	}
 
-    _gtk_sheet_scrollbar_adjust(sheet);
-    _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
+	sheet->maxcol += ncols;
 
-    gtk_sheet_activate_cell(sheet, sheet->active_cell.row, sheet->active_cell.col);
+	_gtk_sheet_reset_text_column(sheet, position - 1);
+	_gtk_sheet_recalc_left_xpixels(sheet);
+    }
 }
 
-/**
- * gtk_sheet_range_set_background:
- * @sheet: a #GtkSheet.
- * @urange: a #GtkSheetRange.
- * @color: a #GdkColor.
- *
- * Set background color of the given range.
- */
-void
-gtk_sheet_range_set_background(GtkSheet *sheet,
-    const GtkSheetRange *urange,
-    const GdkColor *color)
-{
-    gint i, j;
-    GtkSheetRange range;
-
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
-
-    if (!urange)
-	range = sheet->range;
-    else
-	range = *urange;
-
-#if GTK_SHEET_DEBUG_COLORS > 0
-    g_debug("gtk_sheet_range_set_background: %s row %d-%d col %d-%d)",
-	gdk_color_to_string(color), range.row0, range.rowi, range.col0, range.coli);
-#endif
-
-    for (i = range.row0; i <= range.rowi; i++) for (j = range.col0; j <= range.coli; j++)
-    {
-	GtkSheetCellAttr attributes;
-	gtk_sheet_get_attributes(sheet, i, j, &attributes);
+static void
+InsertColumn(GtkSheet *sheet, gint position, gint ncols)
+{
+    g_assert(ncols >= 0);
+    g_assert(position >= 0);
 
-	if (color != NULL)
-	    attributes.background = *color;
-	else
-	    attributes.background = sheet->bg_color;
-	
-	gdk_colormap_alloc_color(gdk_colormap_get_system(), &attributes.background, FALSE, TRUE);
+    AddColumns(sheet, position, ncols);
 
-	gtk_sheet_set_cell_attributes(sheet, i, j, attributes);
+    if (position <= sheet->maxalloccol)  /* adjust allocated cells */
+    {
+	GrowSheet(sheet, 0, ncols);
+	MoveCellData(sheet, 0, position, 0, ncols);
     }
 
-    if (!GTK_SHEET_IS_FROZEN(sheet))
-	_gtk_sheet_range_draw(sheet, &range, TRUE);
+    _gtk_sheet_attr_rules_adjust(sheet, FALSE, position, ncols);
 }
 
-/**
- * gtk_sheet_range_set_foreground:
- * @sheet: a #GtkSheet.
- * @urange: a #GtkSheetRange.
- * @color: a #GdkColor.
- *
- * Set foreground color of the given range.
- */
-void
-gtk_sheet_range_set_foreground(GtkSheet *sheet,
-    const GtkSheetRange *urange,
-    const GdkColor *color)
+static void
+DeleteColumn(GtkSheet *sheet, gint position, gint ncols)
 {
-    gint i, j;
-    GtkSheetRange range;
+    gint c;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_assert(ncols >= 0);
+    g_assert(position >= 0);
 
-    if (!urange)
-	range = sheet->range;
-    else
-	range = *urange;
+    ncols = MIN(ncols, sheet->maxcol - position + 1);
 
-#if GTK_SHEET_DEBUG_COLORS > 0
-    g_debug("gtk_sheet_range_set_foreground: %s row %d-%d col %d-%d)",
-	gdk_color_to_string(color), range.row0, range.rowi, range.col0, range.coli);
+    if (ncols <= 0 || position > sheet->maxcol)
+	return;
+
+#if GTK_SHEET_DEBUG_ALLOCATION > 0
+    g_debug("DeleteColumn: pos %d ncols %d mxr %d mxc %d mxar %d mxac %d ", 
+	position, ncols, 
+	sheet->maxrow, sheet->maxcol, sheet->maxallocrow, sheet->maxalloccol);
 #endif
 
-    for (i = range.row0; i <= range.rowi; i++) for (j = range.col0; j <= range.coli; j++)
-    {
-	GtkSheetCellAttr attributes;
-	gtk_sheet_get_attributes(sheet, i, j, &attributes);
+    /* dispose cell data first, cells are uncounted from their row and column */
+    if (position <= sheet->maxalloccol)
+	DeleteCellData(sheet, 0, sheet->maxallocrow, position, position + ncols - 1);
 
-	if (color != NULL)
-	    attributes.foreground = *color;
-	else
-	    gdk_color_black(gdk_colormap_get_system(), &attributes.foreground);
+    for (c = position; c < position + ncols; c++)  /* dispose columns */
+    {
+	sheet->column[c]->sheet = NULL;
 
-	gdk_colormap_alloc_color(gdk_colormap_get_system(), &attributes.foreground, FALSE, TRUE);
+	_gtk_sheet_attr_layer_free(sheet->column[c]->attr_layer);
+	sheet->column[c]->attr_layer = NULL;
 
-	gtk_sheet_set_cell_attributes(sheet, i, j, attributes);
+	g_object_unref(sheet->column[c]);
+	sheet->column[c] = NULL;
     }
 
-    if (!GTK_SHEET_IS_FROZEN(sheet))
-	_gtk_sheet_range_draw(sheet, &range, TRUE);
-}
-
-/**
- * gtk_sheet_range_set_justification:
- * @sheet: a #GtkSheet.
- * @urange: a #GtkSheetRange.
- * @just: a #GtkJustification : GTK_JUSTIFY_LEFT, RIGHT, CENTER.
- *
- * Set text justification (GTK_JUSTIFY_LEFT, RIGHT, CENTER) of the given range.
- * The default value is GTK_JUSTIFY_LEFT. If autoformat is on, the default justification for numbers is GTK_JUSTIFY_RIGHT.
- */
-void
-gtk_sheet_range_set_justification(GtkSheet *sheet, const GtkSheetRange *urange,
-    GtkJustification just)
-{
-    gint i, j;
-    GtkSheetRange range;
+    for (c = position; c <= sheet->maxcol - ncols; c++)  /* shift columns into position*/
+    {
+	sheet->column[c] = sheet->column[c + ncols];
+    }
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    for (c = sheet->maxcol - ncols + 1; c <= sheet->maxcol; c++)  /* clear tail */
+    {
+	sheet->column[c] = NULL;
+    }
 
-    if (!urange)
-	range = sheet->range;
-    else
-	range = *urange;
+    /* to be done: shrink pointer pool via realloc */
 
-    for (i = range.row0; i <= range.rowi; i++)
+    if (position <= sheet->maxalloccol)
     {
-	for (j = range.col0; j <= range.coli; j++)
-	{
-	    GtkSheetCellAttr attributes;
-	    gtk_sheet_get_attributes(sheet, i, j, &attributes);
-	    attributes.justification = just;
-	    gtk_sheet_set_cell_attributes(sheet, i, j, attributes);
-	}
+	/* shift tail into position */
+	MoveCellData(sheet, 0, position + ncols, 0, -ncols);
+
+	sheet->maxalloccol -= MIN(ncols, sheet->maxalloccol - position + 1);
+	sheet->maxalloccol = MIN(sheet->maxalloccol, sheet->maxcol);
     }
 
-    range.col0 = sheet->view.col0;
-    range.coli = sheet->view.coli;
+    _gtk_sheet_attr_rules_adjust(sheet, FALSE, position, -ncols);
 
-    if (!GTK_SHEET_IS_FROZEN(sheet))
-	_gtk_sheet_range_draw(sheet, &range, TRUE);
-}
+    sheet->maxcol -= ncols;
 
+    _gtk_sheet_range_fixup(sheet, &sheet->view);
+    _gtk_sheet_range_fixup(sheet, &sheet->range);
 
-/**
- * gtk_sheet_range_set_editable:
- * @sheet: a #GtkSheet.
- * @urange: a #GtkSheetRange
- * @editable: TRUE or FALSE
- *
- * Set if cell contents can be edited or not in the given range.
- */
-void
-gtk_sheet_range_set_editable(GtkSheet *sheet, const GtkSheetRange *urange, gboolean editable)
-{
-    gint i, j;
-    GtkSheetRange range;
+    _gtk_sheet_reset_text_column(sheet, position);
+    _gtk_sheet_recalc_left_xpixels(sheet);
+}
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+static void
+AddRows(GtkSheet *sheet, gint position, gint nrows)
+{
+    gint p, npages, ntail;
 
-    if (!urange)
-	range = sheet->range;
-    else
-	range = *urange;
+    g_assert(nrows >= 0);
+    g_assert(position >= 0 && position <= sheet->maxrow + 1);
 
-    for (i = range.row0; i <= range.rowi; i++)
+    if (nrows > 0)
     {
-	for (j = range.col0; j <= range.coli; j++)
+	gint height = _gtk_sheet_row_default_height(GTK_WIDGET(sheet));
+
+	if (sheet->maxrow < 0)  /* no rows, no pages */
+	    sheet->row_page_height = height;
+
+	npages = (sheet->maxrow + 1 + nrows + GTK_SHEET_ROW_PAGE_MASK) >> GTK_SHEET_ROW_PAGE_SHIFT;
+	if (npages > sheet->row_npages)
 	{
-	    GtkSheetCellAttr attributes;
-	    gtk_sheet_get_attributes(sheet, i, j, &attributes);
-	    attributes.is_editable = editable;
-	    gtk_sheet_set_cell_attributes(sheet, i, j, attributes);
+	    sheet->row_pages = g_renew(GtkSheetRowPage *, sheet->row_pages, npages);
+	    for (p = sheet->row_npages; p < npages; p++) sheet->row_pages[p] = NULL;
+	    sheet->row_npages = npages;
 	}
-    }
 
-    if (!GTK_SHEET_IS_FROZEN(sheet))
-	_gtk_sheet_range_draw(sheet, &range, TRUE);
+	ntail = sheet->maxrow + 1 - position;
+	if (ntail > 0)  /* make space */
+	    _gtk_sheet_row_pages_move(sheet, position + nrows, position, ntail);
+
+	_gtk_sheet_row_pages_reset(sheet, position, nrows, height);
+
+	_gtk_sheet_row_data_shift(sheet, position, nrows);
+	_gtk_sheet_row_table_shift(&sheet->row_extent_hist, &sheet->row_extent_hist_last,
+	    position, nrows, (GDestroyNotify)g_sequence_free);
+
+	sheet->maxrow += nrows;
+
+	_gtk_sheet_recalc_top_ypixels(sheet);
+    }
 }
 
-/**
- * gtk_sheet_range_set_visible:
- * @sheet: a #GtkSheet.
- * @urange: a #GtkSheetRange.
- * @visible: TRUE or FALSE.
- *
- * Set if cell contents are visible or not in the given range: accepted values are TRUE or FALSE.
- */
-void
-gtk_sheet_range_set_visible(GtkSheet *sheet, const GtkSheetRange *urange, gboolean visible)
+static void
+InsertRow(GtkSheet *sheet, gint row, gint nrows)
 {
-    gint i, j;
-    GtkSheetRange range;
-
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    AddRows(sheet, row, nrows);
 
-    if (!urange)
-	range = sheet->range;
-    else
-	range = *urange;
+    _gtk_sheet_recalc_top_ypixels(sheet);
 
-    for (i = range.row0; i <= range.rowi; i++)
+    if (row <= sheet->maxallocrow)  /* adjust allocated cells */
     {
-	for (j = range.col0; j <= range.coli; j++)
-	{
-	    GtkSheetCellAttr attributes;
-	    gtk_sheet_get_attributes(sheet, i, j, &attributes);
-	    attributes.is_visible = visible;
-	    gtk_sheet_set_cell_attributes(sheet, i, j, attributes);
-	}
+	GrowSheet(sheet, nrows, 0);  /* append rows at end */
+	MoveCellData(sheet, row, 0, nrows, 0);
     }
 
-    if (!GTK_SHEET_IS_FROZEN(sheet))
-	_gtk_sheet_range_draw(sheet, &range, TRUE);
+    _gtk_sheet_attr_rules_adjust(sheet, TRUE, row, nrows);
 }
 
-/**
- * gtk_sheet_range_set_border:
- * @sheet: a #GtkSheet.
- * @urange: a #GtkSheetRange where we set border style.
- * @mask: CELL_LEFT_BORDER, CELL_RIGHT_BORDER, CELL_TOP_BORDER,CELL_BOTTOM_BORDER
- * @width: width of the border line in pixels
- * @line_style: GdkLineStyle for the border line
- *
- * Set cell border style in the given range.
- */
-void
-gtk_sheet_range_set_border(GtkSheet *sheet, const GtkSheetRange *urange, gint mask,
-    guint width, gint line_style)
+static void
+DeleteRow(GtkSheet *sheet, gint position, gint nrows)
 {
-    gint i, j;
-    GtkSheetRange range;
+    gint p, npages, ntail;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_assert(nrows >= 0);
+    g_assert(position >= 0);
 
-    if (!urange)
-	range = sheet->range;
-    else
-	range = *urange;
+    nrows = MIN(nrows, sheet->maxrow - position + 1);
 
-    for (i = range.row0; i <= range.rowi; i++)
-    {
-	for (j = range.col0; j <= range.coli; j++)
-	{
-	    GtkSheetCellAttr attributes;
-	    gtk_sheet_get_attributes(sheet, i, j, &attributes);
-	    attributes.border.mask = mask;
-	    attributes.border.width = width;
-	    attributes.border.line_style = line_style;
-	    attributes.border.cap_style = GDK_CAP_NOT_LAST;
-	    attributes.border.join_style = GDK_JOIN_MITER;
-	    gtk_sheet_set_cell_attributes(sheet, i, j, attributes);
-	}
-    }
+    if (nrows <= 0 || position > sheet->maxrow)
+	return;
 
-    range.row0--;
-    range.col0--;
-    range.rowi++;
-    range.coli++;
+#if GTK_SHEET_DEBUG_ALLOCATION > 0
+    g_debug("DeleteRow: pos %d nrows %d mxr %d mxc %d mxar %d mxac %d ", 
+	position, nrows, 
+	sheet->maxrow, sheet->maxcol, sheet->maxallocrow, sheet->maxalloccol);
+#endif
 
-    if (!GTK_SHEET_IS_FROZEN(sheet))
-	_gtk_sheet_range_draw(sheet, &range, TRUE);
-}
+    /* dispose cell data first, cells are uncounted from their row and column */
+    if (position <= sheet->maxallocrow)
+	DeleteCellData(sheet, position, position + nrows - 1, 0, sheet->maxalloccol);
 
-/**
- * gtk_sheet_range_set_border_color:
- * @sheet: a #GtkSheet.
- * @urange: a #GtkSheetRange where we set border color.
- * @color: a #GdkColor.
- *
- * Set border color for the given range.
- */
-void
-gtk_sheet_range_set_border_color(GtkSheet *sheet,
-    const GtkSheetRange *urange,
-    const GdkColor *color)
-{
-    gint i, j;
-    GtkSheetRange range;
+    _gtk_sheet_row_data_shift(sheet, position, -nrows);  /* dispose row data */
+    _gtk_sheet_row_table_shift(&sheet->row_extent_hist, &sheet->row_extent_hist_last,
+	position, -nrows, (GDestroyNotify)g_sequence_free);
+
+    ntail = sheet->maxrow + 1 - (position + nrows);
+    if (ntail > 0)  /* shift rows into position */
+	_gtk_sheet_row_pages_move(sheet, position, position + nrows, ntail);
+
+    if (position <= sheet->maxallocrow)
+    {
+	/* shift tail down */
+	MoveCellData(sheet, position + nrows, 0, -nrows, 0);
+
+	sheet->maxallocrow -= MIN(nrows, sheet->maxallocrow - position + 1);
+	sheet->maxallocrow = MIN(sheet->maxallocrow, sheet->maxrow);
+    }
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    _gtk_sheet_attr_rules_adjust(sheet, TRUE, position, -nrows);
 
-    if (!urange)
-	range = sheet->range;
-    else
-	range = *urange;
+    sheet->maxrow -= nrows;
 
-    for (i = range.row0; i <= range.rowi; i++)
+    /* free pages beyond the last row, to be done: shrink page array via realloc */
+    npages = (sheet->maxrow + 1 + GTK_SHEET_ROW_PAGE_MASK) >> GTK_SHEET_ROW_PAGE_SHIFT;
+    for (p = npages; p < sheet->row_npages; p++)
     {
-	for (j = range.col0; j <= range.coli; j++)
-	{
-	    GtkSheetCellAttr attributes;
-	    gtk_sheet_get_attributes(sheet, i, j, &attributes);
-	    attributes.border.color = *color;
-	    gtk_sheet_set_cell_attributes(sheet, i, j, attributes);
-	}
+	g_free(sheet->row_pages[p]);
+	sheet->row_pages[p] = NULL;
     }
+    sheet->row_npages = npages;
 
-    if (!GTK_SHEET_IS_FROZEN(sheet))
-	_gtk_sheet_range_draw(sheet, &range, TRUE);
+    _gtk_sheet_range_fixup(sheet, &sheet->view);
+    _gtk_sheet_range_fixup(sheet, &sheet->range);
+
+    _gtk_sheet_recalc_top_ypixels(sheet);
 }
 
-/**
- * gtk_sheet_range_set_font:
- * @sheet: a #GtkSheet.
- * @urange: a #GtkSheetRange where we set font_desc.
- * @font_desc: (transfer none) a #PangoFontDescription.
- *
- * Set font_desc for the given range.
- */
-void
-gtk_sheet_range_set_font(GtkSheet *sheet,
-    const GtkSheetRange *urange,
-    PangoFontDescription *font_desc)
+static gint
+GrowSheet(GtkSheet *tbl, gint newrows, gint newcols)
 {
-    gint i, j;
-    gint font_height;
-    GtkSheetRange range;
-    PangoContext *context;
-    PangoFontMetrics *metrics;
+    gint br, bc;
+    gint nbrows, nbcols;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
+    tbl->maxalloccol = tbl->maxalloccol + newcols;
+    tbl->maxallocrow = tbl->maxallocrow + newrows;
 
-    if (!urange)
-	range = sheet->range;
-    else
-	range = *urange;
+    /* only the block directory grows here, blocks are allocated on demand */
 
-    gtk_sheet_freeze(sheet);
+    nbrows = (tbl->maxallocrow >= 0) ? BLOCK_ROW_IDX(tbl->maxallocrow) + 1 : 0;
+    nbcols = (tbl->maxalloccol >= 0) ? BLOCK_COL_IDX(tbl->maxalloccol) + 1 : 0;
 
-    context = gtk_widget_get_pango_context(GTK_WIDGET(sheet));
-    metrics = pango_context_get_metrics(context,
-	font_desc,
-	pango_context_get_language(context));
-    font_height = pango_font_metrics_get_descent(metrics) +
-	pango_font_metrics_get_ascent(metrics);
-    font_height = PANGO_PIXELS(font_height) + 2 * CELLOFFSET;
+    if (nbrows > tbl->data_block_rows)
+    {
+	nbrows = MAX(nbrows, 2 * tbl->data_block_rows);
 
-    for (i = range.row0; i <= range.rowi; i++)
+	tbl->data = g_renew(GtkSheetCellBlock **, tbl->data, nbrows);
+
+	for (br = tbl->data_block_rows; br < nbrows; br++)
+	{
+	    tbl->data[br] = NULL;
+	}
+	tbl->data_block_rows = nbrows;
+    }
+
+    if (nbcols > tbl->data_block_cols)
     {
-	for (j = range.col0; j <= range.coli; j++)
+	nbcols = MAX(nbcols, 2 * tbl->data_block_cols);
+
+	for (br = 0; br < tbl->data_block_rows; br++)
 	{
-	    GtkSheetCellAttr attributes;
-	    gtk_sheet_get_attributes(sheet, i, j, &attributes);
-	    attributes.font_desc = pango_font_description_copy(font_desc);  /* copy */
-	    attributes.do_font_desc_free = TRUE;
+	    if (!tbl->data[br])
+		continue;
 
-	    if (font_height > sheet->row[i].height)
+	    tbl->data[br] = g_renew(GtkSheetCellBlock *, tbl->data[br], nbcols);
+
+	    for (bc = tbl->data_block_cols; bc < nbcols; bc++)
 	    {
-		sheet->row[i].height = font_height;
-		_gtk_sheet_recalc_top_ypixels(sheet);
+		tbl->data[br][bc] = NULL;
 	    }
-
-	    gtk_sheet_set_cell_attributes(sheet, i, j, attributes);
 	}
+	tbl->data_block_cols = nbcols;
     }
 
-    gtk_sheet_thaw(sheet);
-    pango_font_metrics_unref(metrics);
+    return (0);
 }
 
 static void
-gtk_sheet_set_cell_attributes(GtkSheet *sheet,
-    gint row, gint col,
-    GtkSheetCellAttr attributes)
+CheckBounds(GtkSheet *sheet, gint row, gint col)
 {
-    GtkSheetCell *cell;
-
-    if (row < 0 || row > sheet->maxrow)
-	return;
-    if (col < 0 || col > sheet->maxcol)
-	return;
-
-    CheckCellData(sheet, row, col);
-
-    cell = sheet->data[row][col];
+    gint newrows = 0, newcols = 0;
 
-    if (!cell->attributes)
-	cell->attributes = g_new(GtkSheetCellAttr, 1);
+    if (col > sheet->maxalloccol)
+	newcols = col - sheet->maxalloccol;
+    if (row > sheet->maxallocrow)
+	newrows = row - sheet->maxallocrow;
 
-    *(cell->attributes) = attributes;
+    if (newrows > 0 || newcols > 0)
+	GrowSheet(sheet, newrows, newcols);
 }
 
-/**
- * gtk_sheet_get_attributes:
- * @sheet: a #GtkSheet.
- * @row: row number
- * @col: column number
- * @attributes: #GtkSheetCellAttr of the given range
- *
- * Gett cell attributes of the given cell.
- *
- * Returns: TRUE means that the cell is currently allocated.
+
+/*
+ * CheckCellData - verify existance of cell data, allocate if necessary
+ * 
+ * @param sheet
+ * @param row
+ * @param col
  */
-gboolean
-gtk_sheet_get_attributes(GtkSheet *sheet,
-    gint row, gint col,
-    GtkSheetCellAttr *attributes)
+static void
+CheckCellData(GtkSheet *sheet, const gint row, const gint col)
 {
     GtkSheetCell *cell;
 
-    g_return_val_if_fail(sheet != NULL, FALSE);
-    g_return_val_if_fail(GTK_IS_SHEET(sheet), FALSE);
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
 
-    if ((row < 0 || row > sheet->maxrow) || (col < 0 || col > sheet->maxcol))
-    {
-	init_attributes(sheet, col, attributes);
-	return (FALSE);
-    }
+    if (col > sheet->maxcol || row > sheet->maxrow)
+	return;
+    if (col < 0 || row < 0)
+	return;
 
-    if (row > sheet->maxallocrow || col > sheet->maxalloccol ||
-	!sheet->data[row] || !sheet->data[row][col])
-    {
-	init_attributes(sheet, col, attributes);
-	return (FALSE);
-    }
+    CheckBounds(sheet, row, col);
 
-    cell = sheet->data[row][col];
+    cell = _gtk_sheet_cell_get(sheet, row, col);
 
-    if (!cell->attributes)
+    if (!cell)
     {
-	init_attributes(sheet, col, attributes);
-	return (FALSE);
+	cell = gtk_sheet_cell_new(sheet);
+	PutCellData(sheet, row, col, cell);
     }
 
-    *attributes = *(cell->attributes);
+    cell->row = row;
+    cell->col = col;
+}
 
-    if (COLPTR(sheet, col)->justification != GTK_SHEET_COLUMN_DEFAULT_JUSTIFICATION)
+/*
+ * _gtk_sheet_cell_block_get - get a block for storing cells
+ * 
+ * allocates the directory row and the block on demand, the 
+ * directory must cover the block
+ * 
+ * @param sheet
+ * @param br     block row
+ * @param bc     block column
+ */
+static GtkSheetCellBlock *
+_gtk_sheet_cell_block_get(GtkSheet *sheet, gint br, gint bc)
+{
+    GtkSheetCellBlock **blockrow = sheet->data[br];
+
+    if (!blockrow)
     {
-	attributes->justification = COLPTR(sheet, col)->justification;
+	blockrow = g_new0(GtkSheetCellBlock *, sheet->data_block_cols);
+	sheet->data[br] = blockrow;
     }
 
-    return (TRUE);
+    if (!blockrow[bc])
+	blockrow[bc] = g_new0(GtkSheetCellBlock, 1);
+
+    return (blockrow[bc]);
 }
 
-static void
-init_attributes(GtkSheet *sheet, gint col, GtkSheetCellAttr *attributes)
+/*
+ * _gtk_sheet_cell_strip_get - get the strip of a column for 
+ * storing cells, allocated on demand
+ * 
+ * @param sheet
+ * @param br     block row
+ * @param col    column
+ */
+static GtkSheetCellStrip *
+_gtk_sheet_cell_strip_get(GtkSheet *sheet, gint br, gint col)
 {
-    /* DEFAULT VALUES */
-    attributes->foreground = gtk_widget_get_style(GTK_WIDGET(sheet))->black;
-    attributes->background = sheet->bg_color;
+    GtkSheetCellBlock *block = _gtk_sheet_cell_block_get(sheet, br, BLOCK_COL_IDX(col));
+    GtkSheetCellStrip **sp = &block->strip[BLOCK_STRIP(col)];
 
-    if (!gtk_widget_get_realized(GTK_WIDGET(sheet)))
+    if (!*sp)
     {
-	GdkColormap *colormap;
-	colormap = gdk_colormap_get_system();
-	gdk_color_black(colormap, &attributes->foreground);
-	attributes->background = sheet->bg_color;
+	*sp = g_new0(GtkSheetCellStrip, 1);
+	block->nstrips++;
     }
-
-    if (col < 0 || col > sheet->maxcol)
-	attributes->justification = GTK_SHEET_COLUMN_DEFAULT_JUSTIFICATION;
-    else
-	attributes->justification = COLPTR(sheet, col)->justification;
-
-    attributes->border.width = 0;
-    attributes->border.line_style = GDK_LINE_SOLID;
-    attributes->border.cap_style = GDK_CAP_NOT_LAST;
-    attributes->border.join_style = GDK_JOIN_MITER;
-    attributes->border.mask = 0;
-    attributes->border.color = gtk_widget_get_style(GTK_WIDGET(sheet))->black;
-    attributes->is_editable = TRUE;
-    attributes->is_sensitive = TRUE;
-    attributes->can_focus = TRUE;
-    attributes->is_visible = TRUE;
-    attributes->font = gtk_widget_get_style(GTK_WIDGET(sheet))->private_font;
-
-    attributes->font_desc = 
-	gtk_widget_get_style(GTK_WIDGET(sheet))->font_desc;  /* no copy */
-    attributes->do_font_desc_free = FALSE;
+    return (*sp);
 }
 
-/**********************************************************************
- * Memory allocation routines:
- * AddRow & AddColumn allocate memory for GtkSheetColumn & GtkSheetRow structs.
- * InsertRow
- * InsertColumn
- * DeleteRow
- * DeleteColumn
- * GrowSheet allocates memory for the sheet cells contents using an array of
- * pointers. Alternative to this could be a linked list or a hash table.
- * CheckBounds checks whether the given cell is currently allocated or not.
- * If not, it calls to GrowSheet.
- **********************************************************************/
-
-static void
-AddColumns(GtkSheet *sheet, gint position, gint ncols)
+/*
+ * _gtk_sheet_cell_strip_take - unlink the strip of a column
+ * 
+ * releases the block and its directory row when they become empty
+ * 
+ * @param sheet
+ * @param br     block row
+ * @param col    column
+ * 
+ * @return the strip or NULL if none
+ */
+static GtkSheetCellStrip *
+_gtk_sheet_cell_strip_take(GtkSheet *sheet, gint br, gint col)
 {
+    GtkSheetCellBlock **blockrow, *block;
+    GtkSheetCellStrip *strip;
+    gint bc = BLOCK_COL_IDX(col);
     gint c;
-    GtkSheetColumn *newobj;
 
-    g_assert(ncols >= 0);
-    g_assert(position >= 0 && position <= sheet->maxcol + 1);
+    if (br >= sheet->data_block_rows || bc >= sheet->data_block_cols)
+	return (NULL);
 
-    if (ncols > 0)
+    blockrow = sheet->data[br];
+    if (!blockrow || !blockrow[bc])
+	return (NULL);
+
+    block = blockrow[bc];
+    strip = block->strip[BLOCK_STRIP(col)];
+    if (!strip)
+	return (NULL);
+
+    block->strip[BLOCK_STRIP(col)] = NULL;
+
+    if (--block->nstrips == 0)  /* release empty block */
     {
-	sheet->column = (GtkSheetColumn **)g_realloc(sheet->column,
-	    (sheet->maxcol + 1 + ncols)* sizeof(GtkSheetColumn *));
+	blockrow[bc] = NULL;
+	g_free(block);
 
-	for (c = sheet->maxcol; c >= position; c--)  /* make space */
+	for (c = 0; c < sheet->data_block_cols; c++)
 	{
-	    sheet->column[c + ncols] = sheet->column[c];
-	    sheet->column[c] = NULL;
+	    if (blockrow[c])
+		break;
 	}
-
-	for (c = 0; c < ncols; c++)
+	if (c >= sheet->data_block_cols)  /* release empty directory row */
 	{
-	    gint newidx = position + c;
-
-	    newobj = g_object_new(G_TYPE_SHEET_COLUMN, NULL);
-
-#if GTK_SHEET_DEBUG_FINALIZE > 0
-	    g_object_weak_ref(G_OBJECT(newobj), weak_notify, "Sheet-Column");
-#endif
-
-	    newobj->sheet = sheet;
-	    sheet->column[newidx] = newobj;
-
-	    gtk_widget_set_parent(GTK_WIDGET(newobj), GTK_WIDGET(sheet));
-
-#if 0
-	    g_debug("Setting Column %p Parent to GtkSheet %p - got %p",
-		    newobj, sheet, gtk_widget_get_parent(GTK_WIDGET(newobj)));
-#endif
-
-	    g_object_ref_sink(newobj);
+	    g_free(blockrow);
+	    sheet->data[br] = NULL;
 	}
-
-	sheet->maxcol += ncols;
-
-	_gtk_sheet_reset_text_column(sheet, sheet->maxcol - ncols);
-	_gtk_sheet_recalc_left_xpixels(sheet);
     }
+    return (strip);
 }
 
+/*
+ * PutCellData - store a cell pointer into the block store
+ * 
+ * Allocates the block and strip on demand. Storing NULL removes 
+ * the pointer and releases the strip, block and directory row 
+ * when they become empty. The cell itself is not touched. 
+ * 
+ * @param sheet
+ * @param row
+ * @param col
+ * @param cell   the cell or NULL
+ */
 static void
-InsertColumn(GtkSheet *sheet, gint position, gint ncols)
+PutCellData(GtkSheet *sheet, gint row, gint col, GtkSheetCell *cell)
 {
-    gint r, c;
+    GtkSheetCellBlock *block;
+    GtkSheetCellStrip *strip;
+    GtkSheetCell **slot;
 
-    g_assert(ncols >= 0);
-    g_assert(position >= 0);
-
-    AddColumns(sheet, position, ncols);
-
-    _gtk_sheet_reset_text_column(sheet, sheet->maxcol - ncols);
-    _gtk_sheet_recalc_left_xpixels(sheet);
-
-    if (position <= sheet->maxalloccol)  /* adjust allocated cells */
+    if (!cell)
     {
-	GrowSheet(sheet, 0, ncols);
+	block = _gtk_sheet_cell_block(sheet, row, col);
+	if (!block)
+	    return;
 
-	for (r = 0; r <= sheet->maxallocrow; r++)
-	{
-	    for (c = sheet->maxalloccol; c >= position + ncols; c--)
-	    {
-		gtk_sheet_real_cell_clear(sheet, r, c, TRUE);
+	strip = block->strip[BLOCK_STRIP(col)];
+	if (!strip)
+	    return;
+
+	slot = &strip->cell[STRIP_SLOT(row)];
+	if (!*slot)
+	    return;
 
-		sheet->data[r][c] = sheet->data[r][c - ncols];
-		if (sheet->data[r][c])
-		    sheet->data[r][c]->col = c;
-		sheet->data[r][c - ncols] = NULL;
-	    }
-	}
+	*slot = NULL;
+
+	if (--strip->ncells == 0)  /* release empty strip */
+	    g_free(_gtk_sheet_cell_strip_take(sheet, BLOCK_ROW_IDX(row), col));
+	return;
     }
-}
 
-static void
-DeleteColumn(GtkSheet *sheet, gint position, gint ncols)
-{
-    gint c, r;
+    CheckBounds(sheet, row, col);
 
-    g_assert(ncols >= 0);
-    g_assert(position >= 0);
+    strip = _gtk_sheet_cell_strip_get(sheet, BLOCK_ROW_IDX(row), col);
 
-    ncols = MIN(ncols, sheet->maxcol - position + 1);
+    slot = &strip->cell[STRIP_SLOT(row)];
+    if (!*slot)
+	strip->ncells++;
 
-    if (ncols <= 0 || position > sheet->maxcol)
-	return;
+    *slot = cell;
+}
 
-#if GTK_SHEET_DEBUG_ALLOCATION > 0
-    g_debug("DeleteColumn: pos %d ncols %d mxr %d mxc %d mxar %d mxac %d ", 
-	position, ncols, 
-	sheet->maxrow, sheet->maxcol, sheet->maxallocrow, sheet->maxalloccol);
-#endif
+/*
+ * CollectCellData - collect allocated cells within a range
+ * 
+ * Only populated strips are visited. 
+ * 
+ * @param sheet
+ * @param row0, rowi, col0, coli  the range
+ * 
+ * @return a #GPtrArray of #GtkSheetCell, free with 
+ *         g_ptr_array_free(array, TRUE)
+ */
+static GPtrArray *
+CollectCellData(GtkSheet *sheet, gint row0, gint rowi, gint col0, gint coli)
+{
+    GPtrArray *cells = g_ptr_array_new();
+    gint br, bc, r, c;
 
-    for (c = position; c < position + ncols; c++)  /* dispose columns */
-    {
-	sheet->column[c]->sheet = NULL;
+    row0 = MAX(row0, 0);
+    col0 = MAX(col0, 0);
+    rowi = MIN(rowi, sheet->maxallocrow);
+    coli = MIN(coli, sheet->maxalloccol);
 
-	g_object_unref(sheet->column[c]);
-	sheet->column[c] = NULL;
-    }
+    if (row0 > rowi || col0 > coli)
+	return (cells);
 
-    for (c = position; c <= sheet->maxcol - ncols; c++)  /* shift columns into position*/
+    for (br = BLOCK_ROW_IDX(row0);
+	br <= BLOCK_ROW_IDX(rowi) && br < sheet->data_block_rows; br++)
     {
-	sheet->column[c] = sheet->column[c + ncols];
-    }
+	GtkSheetCellBlock **blockrow = sheet->data[br];
 
-    for (c = sheet->maxcol - ncols + 1; c <= sheet->maxcol; c++)  /* clear tail */
-    {
-	sheet->column[c] = NULL;
-    }
+	if (!blockrow)
+	    continue;
 
-    /* to be done: shrink pointer pool via realloc */
+	gint r0 = MAX(row0, br << GTK_SHEET_BLOCK_ROW_SHIFT);
+	gint ri = MIN(rowi, ((br + 1) << GTK_SHEET_BLOCK_ROW_SHIFT) - 1);
 
-    if (position <= sheet->maxalloccol)
-    {
-	for (c = position; c <= sheet->maxcol - ncols; c++)  /* shift column data */
+	for (bc = BLOCK_COL_IDX(col0);
+	    bc <= BLOCK_COL_IDX(coli) && bc < sheet->data_block_cols; bc++)
 	{
-	    if (c > sheet->maxalloccol) break;
-	    
-	    for (r = 0; r <= sheet->maxallocrow; r++)
-	    {
-		gtk_sheet_real_cell_clear(sheet, r, c, TRUE);
+	    GtkSheetCellBlock *block = blockrow[bc];
+
+	    if (!block)
+		continue;
 
-		if (c + ncols <= sheet->maxalloccol)
+	    gint c0 = MAX(col0, bc << GTK_SHEET_BLOCK_COL_SHIFT);
+	    gint ci = MIN(coli, ((bc + 1) << GTK_SHEET_BLOCK_COL_SHIFT) - 1);
+
+	    for (r = r0; r <= ri; r++)
+	    {
+		for (c = c0; c <= ci; c++)
 		{
-		    sheet->data[r][c] = sheet->data[r][c + ncols];
-		    sheet->data[r][c + ncols] = NULL;
-		    if (sheet->data[r][c])
-			sheet->data[r][c]->col = c;
+		    GtkSheetCellStrip *strip = block->strip[BLOCK_STRIP(c)];
+
+		    if (strip && strip->cell[STRIP_SLOT(r)])
+			g_ptr_array_add(cells, strip->cell[STRIP_SLOT(r)]);
 		}
 	    }
 	}
+    }
+    return (cells);
+}
+
+/*
+ * _gtk_sheet_cell_strip_move - move a whole strip, O(strip)
+ * 
+ * the target strip must be free
+ * 
+ * @param sheet
+ * @param br     block row
+ * @param col    column
+ * @param dbr    block row offset
+ * @param dcol   column offset
+ */
+static void
+_gtk_sheet_cell_strip_move(GtkSheet *sheet, gint br, gint col, gint dbr, gint dcol)
+{
+    GtkSheetCellStrip *strip = _gtk_sheet_cell_strip_take(sheet, br, col);
+    GtkSheetCellBlock *block;
+    gint i;
+
+    if (!strip)
+	return;
+
+    for (i = 0; i < GTK_SHEET_BLOCK_ROWS; i++)
+    {
+	GtkSheetCell *cell = strip->cell[i];
 
-	for (c = sheet->maxcol - ncols + 1; c <= sheet->maxcol; c++)  /* clear tail */
+	if (cell)
 	{
-	    if (c > sheet->maxalloccol) break;
-	    
-	    for (r = 0; r <= sheet->maxallocrow; r++)
-	    {
-		gtk_sheet_real_cell_clear(sheet, r, c, TRUE);
-	    }
+	    cell->row += dbr * GTK_SHEET_BLOCK_ROWS;
+	    cell->col += dcol;
 	}
-
-	sheet->maxalloccol -= MIN(ncols, sheet->maxalloccol - position + 1);
-	sheet->maxalloccol = MIN(sheet->maxalloccol, sheet->maxcol);
     }
 
-    sheet->maxcol -= ncols;
-
-    _gtk_sheet_range_fixup(sheet, &sheet->view);
-    _gtk_sheet_range_fixup(sheet, &sheet->range);
+    block = _gtk_sheet_cell_block_get(sheet, br + dbr, BLOCK_COL_IDX(col + dcol));
+    g_assert(!block->strip[BLOCK_STRIP(col + dcol)]);
 
-    _gtk_sheet_reset_text_column(sheet, position);
-    _gtk_sheet_recalc_left_xpixels(sheet);
+    block->strip[BLOCK_STRIP(col + dcol)] = strip;
+    block->nstrips++;
 }
 
+/*
+ * _gtk_sheet_cell_slide_rows - shift the cells of a column by 
+ * a row offset which is not a multiple of GTK_SHEET_BLOCK_ROWS
+ * 
+ * cells move between the slots of at most two strips, no 
+ * block lookups per cell
+ * 
+ * @param sheet
+ * @param row0   first row to move
+ * @param col    column
+ * @param drow   row offset
+ */
 static void
-AddRows(GtkSheet *sheet, gint position, gint nrows)
+_gtk_sheet_cell_slide_rows(GtkSheet *sheet, gint row0, gint col, gint drow)
 {
-    gint r;
-
-    g_assert(nrows >= 0);
-    g_assert(position >= 0 && position <= sheet->maxrow + 1);
+    GtkSheetCellStrip *strip, *dst = NULL;
+    gint br0 = BLOCK_ROW_IDX(row0);
+    gint bri = BLOCK_ROW_IDX(sheet->maxallocrow);
+    gint dst_br = -1;
+    gint i, j, br, s, row;
 
-    if (nrows > 0)
+    for (i = 0; i <= bri - br0; i++)
     {
-	sheet->row = (GtkSheetRow *)g_realloc(sheet->row,
-	    (sheet->maxrow + 1 + nrows) * sizeof(GtkSheetRow));
+	/* work away from the target area, so no cell is overwritten */
+	br = (drow > 0) ? bri - i : br0 + i;
 
-	for (r = sheet->maxrow; r >= position; r--)  /* make space */
-	{
-	    sheet->row[r + nrows] = sheet->row[r];
-	    _gtk_sheet_row_init(&sheet->row[r]);
-	}
+	if (!sheet->data[br] || BLOCK_COL_IDX(col) >= sheet->data_block_cols
+	    || !sheet->data[br][BLOCK_COL_IDX(col)])
+	    continue;
+
+	strip = sheet->data[br][BLOCK_COL_IDX(col)]->strip[BLOCK_STRIP(col)];
+	if (!strip)
+	    continue;
 
-	for (r = 0; r < nrows; r++)
+	for (j = 0; j < GTK_SHEET_BLOCK_ROWS; j++)
 	{
-	    gint newidx = position + r;
+	    GtkSheetCell *cell;
+
+	    s = (drow > 0) ? GTK_SHEET_BLOCK_ROWS - 1 - j : j;
+	    row = (br << GTK_SHEET_BLOCK_ROW_SHIFT) + s;
 
-	    _gtk_sheet_row_init(&sheet->row[newidx]);
+	    cell = strip->cell[s];
+	    if (!cell || row < row0)
+		continue;
+
+	    strip->cell[s] = NULL;
+	    strip->ncells--;
+
+	    row += drow;
+	    if (BLOCK_ROW_IDX(row) != dst_br)
+	    {
+		dst_br = BLOCK_ROW_IDX(row);
+		dst = _gtk_sheet_cell_strip_get(sheet, dst_br, col);
+	    }
+	    dst->cell[STRIP_SLOT(row)] = cell;
+	    dst->ncells++;
 
-	    sheet->row[newidx].requisition = sheet->row[newidx].height =
-		_gtk_sheet_row_default_height(GTK_WIDGET(sheet));
+	    cell->row = row;
 	}
-	sheet->maxrow += nrows;
 
-	_gtk_sheet_recalc_top_ypixels(sheet);
+	if (strip->ncells == 0)  /* release empty strip */
+	{
+	    g_free(_gtk_sheet_cell_strip_take(sheet, br, col));
+	    if (dst == strip)
+	    {
+		dst = NULL;
+		dst_br = -1;
+	    }
+	}
     }
 }
 
+/*
+ * MoveCellData - shift allocated cells 
+ * 
+ * Either all cells at or beyond row0 (within columns at or 
+ * beyond col0) are moved by drow, or all cells of the columns 
+ * at or beyond col0 are moved by dcol. The target area must 
+ * be free. Column shifts and row shifts by whole blocks move 
+ * strips, other row shifts slide cells within their strips. 
+ * 
+ * @param sheet
+ * @param row0
+ * @param col0
+ * @param drow   row offset
+ * @param dcol   column offset
+ */
 static void
-InsertRow(GtkSheet *sheet, gint row, gint nrows)
+MoveCellData(GtkSheet *sheet, gint row0, gint col0, gint drow, gint dcol)
 {
-    gint r, c;
+    gint i, n, br, col;
 
-    AddRows(sheet, row, nrows);
+    g_return_if_fail(drow == 0 || dcol == 0);
+    g_return_if_fail(dcol == 0 || row0 == 0);
 
-    _gtk_sheet_recalc_top_ypixels(sheet);
+    row0 = MAX(row0, 0);
+    col0 = MAX(col0, 0);
 
-    if (row <= sheet->maxallocrow)  /* adjust allocated cells */
+    if (row0 > sheet->maxallocrow || col0 > sheet->maxalloccol)
+	return;
+
+    if (dcol != 0)
     {
-	GrowSheet(sheet, nrows, 0);  /* append rows at end */
+	n = sheet->maxalloccol - col0 + 1;
 
-	for (r = sheet->maxallocrow; r >= row + nrows; r--)  /* swap new rows into position */
+	for (br = 0; br < sheet->data_block_rows; br++)
 	{
-	    GtkSheetCell **auxdata = sheet->data[r];
+	    for (i = 0; i < n && sheet->data[br]; i++)
+	    {
+		col = (dcol > 0) ? sheet->maxalloccol - i : col0 + i;
+		_gtk_sheet_cell_strip_move(sheet, br, col, 0, dcol);
+	    }
+	}
+	return;
+    }
 
-	    sheet->data[r] = sheet->data[r - nrows];
-	    sheet->data[r - nrows] = auxdata;
+    if (drow == 0)
+	return;
 
-	    /* new cells have no data yet to update */
+    for (col = col0; col <= sheet->maxalloccol; col++)
+    {
+	if (STRIP_SLOT(row0) == 0 && STRIP_SLOT(drow) == 0)
+	{
+	    gint br0 = BLOCK_ROW_IDX(row0);
+	    gint bri = BLOCK_ROW_IDX(sheet->maxallocrow);
 
-	    GtkSheetCell **pp = sheet->data[r];  /* update row in existing cells */
-	    for (c = 0; c <= sheet->maxalloccol; c++, pp++)
+	    for (i = 0; i <= bri - br0; i++)
 	    {
-		if (*pp)
-		    (*pp)->row = r;
+		br = (drow > 0) ? bri - i : br0 + i;
+		_gtk_sheet_cell_strip_move(sheet, br, col, drow / GTK_SHEET_BLOCK_ROWS, 0);
 	    }
 	}
+	else
+	    _gtk_sheet_cell_slide_rows(sheet, row0, col, drow);
     }
 }
 
+/*
+ * DeleteCellData - dispose allocated cells within a range
+ * 
+ * @param sheet
+ * @param row0, rowi, col0, coli  the range
+ */
 static void
-DeleteRow(GtkSheet *sheet, gint position, gint nrows)
+DeleteCellData(GtkSheet *sheet, gint row0, gint rowi, gint col0, gint coli)
 {
-    gint r, c;
-
-    g_assert(nrows >= 0);
-    g_assert(position >= 0);
-
-    nrows = MIN(nrows, sheet->maxrow - position + 1);
+    GPtrArray *cells;
+    gint i, n, *pos;
 
-    if (nrows <= 0 || position > sheet->maxrow)
-	return;
+    cells = CollectCellData(sheet, row0, rowi, col0, coli);
 
-#if GTK_SHEET_DEBUG_ALLOCATION > 0
-    g_debug("DeleteRow: pos %d nrows %d mxr %d mxc %d mxar %d mxac %d ", 
-	position, nrows, 
-	sheet->maxrow, sheet->maxcol, sheet->maxallocrow, sheet->maxalloccol);
-#endif
+    /* copy positions, CLEAR_CELL handlers may modify the sheet */
+    n = cells->len;
+    pos = g_new(gint, 2 * n + 1);
 
-    for (r = position; r < position + nrows; r++)  /* dispose row data */
+    for (i = 0; i < n; i++)
     {
-	gtk_sheet_row_finalize(&sheet->row[r]);
-    }
+	GtkSheetCell *cell = g_ptr_array_index(cells, i);
 
-    for (r = position; r <= sheet->maxrow - nrows; r++)  /* shift rows into position*/
-    {
-	sheet->row[r] = sheet->row[r + nrows];
+	pos[2 * i] = cell->row;
+	pos[2 * i + 1] = cell->col;
     }
+    g_ptr_array_free(cells, TRUE);
 
-    for (r = sheet->maxrow - nrows + 1; r <= sheet->maxrow; r++)  /* clear tail */
+    for (i = 0; i < n; i++)
     {
-	_gtk_sheet_row_init(&sheet->row[r]);
+	gtk_sheet_real_cell_clear(sheet, pos[2 * i], pos[2 * i + 1], TRUE);
     }
+    g_free(pos);
+}
 
-    /* to be done: shrink pointer pool via realloc */
+/*
+ * FreeCellData - release the whole block store
+ * 
+ * Cells and their strings are not released one by one, 
+ * their slabs are dropped in bulk. No signals are emitted. 
+ * 
+ * @param sheet
+ */
+static void
+FreeCellData(GtkSheet *sheet)
+{
+    gint br, bc, c, i;
 
-    if (position <= sheet->maxallocrow)
+    for (br = 0; br < sheet->data_block_rows; br++)
     {
-	for (r = position; r <= sheet->maxrow - nrows; r++)  /* shift row data */
+	GtkSheetCellBlock **blockrow = sheet->data[br];
+
+	if (!blockrow)
+	    continue;
+
+	for (bc = 0; bc < sheet->data_block_cols; bc++)
 	{
-	    if (r > sheet->maxallocrow) break;
+	    GtkSheetCellBlock *block = blockrow[bc];
 
-	    for (c = 0; c <= sheet->maxalloccol; c++)  /* dispose cell data */
-	    {
-		gtk_sheet_real_cell_clear(sheet, r, c, TRUE);
-	    }
+	    if (!block)
+		continue;
 
-	    if (sheet->data[r])  /* dispose row data pointer array */
+	    for (c = 0; c < GTK_SHEET_BLOCK_COLS; c++)
 	    {
-		g_free(sheet->data[r]);
-		sheet->data[r] = NULL;
-	    }
+		GtkSheetCellStrip *strip = block->strip[c];
 
-	    if (r + nrows <= sheet->maxallocrow)  /* shift tail down */
-	    {
-		sheet->data[r] = sheet->data[r + nrows];
-		sheet->data[r + nrows] = NULL;
+		if (!strip)
+		    continue;
 
-		GtkSheetCell **pp = sheet->data[r];  /* update row in existing cells */
-		for (c = 0; c <= sheet->maxalloccol; c++, pp++)
+		for (i = 0; i < GTK_SHEET_BLOCK_ROWS; i++)
 		{
-		    if (*pp)
-			(*pp)->row = r;
+		    GtkSheetCell *cell = strip->cell[i];
+
+		    if (!cell)
+			continue;
+
+		    /* only heap strings need work, arena strings go with the pool,
+		       attributes with the attribute table */
+		    PoolStrfree(sheet, cell->text);
+		    PoolStrfree(sheet, cell->tooltip_markup);
+		    PoolStrfree(sheet, cell->tooltip_text);
 		}
+		g_free(strip);
 	    }
+	    g_free(block);
 	}
+	g_free(blockrow);
+    }
 
-	for (r = sheet->maxrow - nrows + 1; r <= sheet->maxrow; r++)  /* clear tail */
-	{
-	    if (r > sheet->maxallocrow) break;
+    g_free(sheet->data);
+    sheet->data = NULL;
+    sheet->data_block_rows = 0;
+    sheet->data_block_cols = 0;
 
-	    for (c = 0; c <= sheet->maxalloccol; c++)  /* dispose cell data */
-	    {
-		gtk_sheet_real_cell_clear(sheet, r, c, TRUE);
-	    }
+    PoolTrim(sheet, TRUE);
+}
 
-	    if (sheet->data[r])  /* dispose row data pointer array */
-	    {
-		g_free(sheet->data[r]);
-		sheet->data[r] = NULL;
-	    }
-	}
+/*
+ * cell memory pool
+ *
+ * Cells are carved from slabs of GTK_SHEET_POOL_SLAB_CELLS, freed cells
+ * are kept on a free list linked through cell->link. Cell strings up to
+ * GTK_SHEET_POOL_MAX_STRING bytes are bump-allocated from arena chunks
+ * and recycled through per size class free lists, longer strings go to
+ * the heap. Every string is preceded by a header byte holding its size
+ * class or GTK_SHEET_POOL_HEAPED, so it may be shortened in place, but
+ * it is owned by the pool and must never be passed to g_free().
+ */
 
-	sheet->maxallocrow -= MIN(nrows, sheet->maxallocrow - position + 1);
-	sheet->maxallocrow = MIN(sheet->maxallocrow, sheet->maxrow);
-    }
+#define GTK_SHEET_POOL_SLAB_CELLS   512
+#define GTK_SHEET_POOL_CHUNK_SIZE   (64 * 1024)
+#define GTK_SHEET_POOL_MIN_SHIFT    4    /* smallest class 16 bytes */
+#define GTK_SHEET_POOL_CLASSES      5    /* 16, 32, 64, 128, 256 bytes */
+#define GTK_SHEET_POOL_MAX_STRING \
+    (1 << (GTK_SHEET_POOL_MIN_SHIFT + GTK_SHEET_POOL_CLASSES - 1))
+#define GTK_SHEET_POOL_HEAPED       0xFF  /* header of heap strings */
+
+struct _GtkSheetMemPool
+{
+    GSList *cell_slabs;        /* GtkSheetCell[GTK_SHEET_POOL_SLAB_CELLS] */
+    guint slab_used;           /* cells taken from the newest slab */
+    GtkSheetCell *free_cells;  /* linked through cell->link */
+    guint live_cells;
+
+    GSList *string_chunks;     /* gchar[GTK_SHEET_POOL_CHUNK_SIZE] */
+    gchar *string_top;         /* bump pointer within the newest chunk */
+    gchar *string_end;
+    gpointer free_strings[GTK_SHEET_POOL_CLASSES];
+    guint live_strings;
+};
 
-    sheet->maxrow -= nrows;
+static GtkSheetCell *
+PoolCellAlloc(GtkSheet *sheet)
+{
+    GtkSheetMemPool *pool = sheet->mem_pool;
+    GtkSheetCell *cell;
 
-    _gtk_sheet_range_fixup(sheet, &sheet->view);
-    _gtk_sheet_range_fixup(sheet, &sheet->range);
+    pool->live_cells++;
 
-    _gtk_sheet_recalc_top_ypixels(sheet);
+    if (pool->free_cells)
+    {
+	cell = pool->free_cells;
+	pool->free_cells = cell->link;
+	return (cell);
+    }
+
+    if (!pool->cell_slabs || pool->slab_used >= GTK_SHEET_POOL_SLAB_CELLS)
+    {
+	pool->cell_slabs = g_slist_prepend(pool->cell_slabs,
+	    g_new(GtkSheetCell, GTK_SHEET_POOL_SLAB_CELLS));
+	pool->slab_used = 0;
+    }
+
+    cell = (GtkSheetCell *)pool->cell_slabs->data + pool->slab_used++;
+    return (cell);
 }
 
-static gint
-GrowSheet(GtkSheet *tbl, gint newrows, gint newcols)
+static void
+PoolCellFree(GtkSheet *sheet, GtkSheetCell *cell)
 {
-    gint r, c;
-    gint inirow, inicol;
+    GtkSheetMemPool *pool = sheet->mem_pool;
 
-    inirow = tbl->maxallocrow + 1;
-    inicol = tbl->maxalloccol + 1;
+    cell->link = pool->free_cells;
+    pool->free_cells = cell;
+    pool->live_cells--;
+}
 
-    tbl->maxalloccol = tbl->maxalloccol + newcols;
-    tbl->maxallocrow = tbl->maxallocrow + newrows;
+static inline gint
+PoolStringClass(gsize size)
+{
+    gint k = 0;
 
-    if (newrows > 0)
-    {
-	tbl->data = (GtkSheetCell ***)
-	g_realloc(tbl->data, (tbl->maxallocrow + 1)*sizeof(GtkSheetCell **)+sizeof(double));
+    while ((1 << (GTK_SHEET_POOL_MIN_SHIFT + k)) < size)
+	k++;
+    return (k);
+}
 
-	for (r = inirow; r <= tbl->maxallocrow; r++)
-	{
-	    tbl->data[r] = (GtkSheetCell **)
-		g_malloc((tbl->maxcol + 1)*sizeof(GtkSheetCell *)+sizeof(double));
+static gchar *
+PoolStrdup(GtkSheet *sheet, const gchar *str)
+{
+    GtkSheetMemPool *pool = sheet->mem_pool;
+    gsize size, class_size;
+    gint k;
+    gchar *p;
 
-	    for (c = 0; c < inicol; c++)
-	    {
-		tbl->data[r][c] = NULL;
-	    }
-	}
+    if (!str)
+	return (NULL);
 
+    size = strlen(str) + 1;
+    if (size + 1 > GTK_SHEET_POOL_MAX_STRING)
+    {
+	p = g_malloc(size + 1);
+	p[0] = (gchar)GTK_SHEET_POOL_HEAPED;
+	memcpy(p + 1, str, size);
+	return (p + 1);
     }
 
-    if (newcols > 0)
+    k = PoolStringClass(size + 1);  /* with header byte */
+    class_size = 1 << (GTK_SHEET_POOL_MIN_SHIFT + k);
+
+    if (pool->free_strings[k])
+    {
+	p = pool->free_strings[k];
+	pool->free_strings[k] = *(gpointer *)p;
+    }
+    else
     {
-	for (r = 0; r <= tbl->maxallocrow; r++)
+	if (pool->string_top + class_size > pool->string_end)
 	{
-	    tbl->data[r] = (GtkSheetCell **)
-		g_realloc(tbl->data[r], (tbl->maxalloccol + 1)*sizeof(GtkSheetCell *)+sizeof(double));
-	    for (c = inicol; c <= tbl->maxalloccol; c++)
-	    {
-		tbl->data[r][c] = NULL;
-	    }
+	    gchar *chunk = g_malloc(GTK_SHEET_POOL_CHUNK_SIZE);
+
+	    pool->string_chunks = g_slist_prepend(pool->string_chunks, chunk);
+	    pool->string_top = chunk;
+	    pool->string_end = chunk + GTK_SHEET_POOL_CHUNK_SIZE;
 	}
+	p = pool->string_top;
+	pool->string_top += class_size;
     }
 
-    return (0);
+    pool->live_strings++;
+    p[0] = (gchar)k;
+    memcpy(p + 1, str, size);
+    return (p + 1);
 }
 
 static void
-CheckBounds(GtkSheet *sheet, gint row, gint col)
+PoolStrfree(GtkSheet *sheet, gchar *str)
 {
-    gint newrows = 0, newcols = 0;
+    GtkSheetMemPool *pool = sheet->mem_pool;
+    gchar *p;
+    gint k;
 
-    if (col > sheet->maxalloccol)
-	newcols = col - sheet->maxalloccol;
-    if (row > sheet->maxallocrow)
-	newrows = row - sheet->maxallocrow;
+    if (!str)
+	return;
 
-    if (newrows > 0 || newcols > 0)
-	GrowSheet(sheet, newrows, newcols);
-}
+    p = str - 1;  /* header byte */
+    if ((guchar)p[0] == GTK_SHEET_POOL_HEAPED)
+    {
+	g_free(p);
+	return;
+    }
 
+    k = (guchar)p[0];
+    *(gpointer *)p = pool->free_strings[k];
+    pool->free_strings[k] = p;
+    pool->live_strings--;
+}
 
 /*
- * CheckCellData - verify existance of cell data, allocate if necessary
+ * PoolTrim - release all slabs and chunks of the pool
  * 
  * @param sheet
- * @param row
- * @param col
+ * @param force  release even if cells or strings are still in use, 
+ *               caller guarantees they will never be touched again
  */
 static void
-CheckCellData(GtkSheet *sheet, const gint row, const gint col)
+PoolTrim(GtkSheet *sheet, gboolean force)
 {
-    GtkSheetCell **cell;
+    GtkSheetMemPool *pool = sheet->mem_pool;
+    GSList *p;
+    gint k;
 
-    g_return_if_fail(sheet != NULL);
-    g_return_if_fail(GTK_IS_SHEET(sheet));
-
-    if (col > sheet->maxcol || row > sheet->maxrow)
+    if (!pool)
 	return;
-    if (col < 0 || row < 0)
+    if (!force && (pool->live_cells || pool->live_strings))
 	return;
 
-    CheckBounds(sheet, row, col);
-
-    cell = &sheet->data[row][col];
+#if GTK_SHEET_DEBUG_ALLOCATION > 0
+    g_debug("PoolTrim: %d slabs %d chunks",
+	g_slist_length(pool->cell_slabs), g_slist_length(pool->string_chunks));
+#endif
 
-    if (!(*cell))
-	(*cell) = gtk_sheet_cell_new();
+    for (p = pool->cell_slabs; p; p = p->next) g_free(p->data);
+    g_slist_free(pool->cell_slabs);
+    pool->cell_slabs = NULL;
+    pool->slab_used = 0;
+    pool->free_cells = NULL;
+    pool->live_cells = 0;
 
-    (*cell)->row = row;
-    (*cell)->col = col;
+    for (p = pool->string_chunks; p; p = p->next) g_free(p->data);
+    g_slist_free(pool->string_chunks);
+    pool->string_chunks = NULL;
+    pool->string_top = pool->string_end = NULL;
+    for (k = 0; k < GTK_SHEET_POOL_CLASSES; k++) pool->free_strings[k] = NULL;
+    pool->live_strings = 0;
 }
 
 /********************************************************************
@@ -15905,7 +23950,7 @@ gtk_sheet_button_attach(GtkSheet *sheet,
     }
     else
     {
-	button = &sheet->row[row].button;
+	button = &_gtk_sheet_row_get(sheet, row)->button;
 	button->child = child;
     }
 
@@ -15919,15 +23964,21 @@ gtk_sheet_button_attach(GtkSheet *sheet,
 	if (button_requisition.height > sheet->column_title_area.height)
 	    sheet->column_title_area.height = button_requisition.height;
 	if (button_requisition.width > COLPTR(sheet, col)->width)
+	{
 	    COLPTR(sheet, col)->width = button_requisition.width;
+	    _gtk_sheet_column_geometry_changed(sheet, col);
+	}
     }
 
     if (col == -1)
     {
 	if (button_requisition.width > sheet->row_title_area.width)
 	    sheet->row_title_area.width = button_requisition.width;
-	if (button_requisition.height > sheet->row[row].height)
-	    sheet->row[row].height = button_requisition.height;
+	if (button_requisition.height > ROW_HEIGHT(sheet, row))
+	{
+	    ROW_SET_HEIGHT(sheet, row, button_requisition.height);
+	    _gtk_sheet_row_geometry_changed(sheet, row);
+	}
     }
 
     if (gtk_widget_get_visible(GTK_WIDGET(sheet)))
@@ -15996,7 +24047,7 @@ label_size_request(GtkSheet *sheet, gchar *label, GtkRequisition *req)
  */
 void
 _gtk_sheet_button_size_request(GtkSheet *sheet,
-    GtkSheetButton *button,
+    const GtkSheetButton *button,
     GtkRequisition *button_requisition)
 {
     GtkRequisition requisition;
@@ -16040,9 +24091,11 @@ gtk_sheet_row_size_request(GtkSheet *sheet,
     guint *requisition)
 {
     GtkRequisition button_requisition;
+    GtkSheetRow *rowp;
     GList *children;
 
-    _gtk_sheet_button_size_request(sheet, &sheet->row[row].button, &button_requisition);
+    _gtk_sheet_button_size_request(sheet,
+	_gtk_sheet_row_button(sheet, row), &button_requisition);
 
     *requisition = button_requisition.height;
 
@@ -16062,7 +24115,12 @@ gtk_sheet_row_size_request(GtkSheet *sheet,
 	children = children->next;
     }
 
-    sheet->row[row].requisition = *requisition;
+    /* rows without record use the default requisition */
+    rowp = _gtk_sheet_row_peek(sheet, row);
+    if (rowp)
+	rowp->requisition = *requisition;
+    else if (*requisition != _gtk_sheet_row_default_height(GTK_WIDGET(sheet)))
+	_gtk_sheet_row_get(sheet, row)->requisition = *requisition;
 }
 
 /**
@@ -16186,17 +24244,17 @@ gtk_sheet_position_child(GtkSheet *sheet, GtkSheetChild *child)
 		child_allocation.width = COLPTR(sheet, child->col)->width - 2 * child->xpadding;
 	    }
 
-	    if (child_requisition.height + 2 * child->ypadding <= sheet->row[child->row].height)
+	    if (child_requisition.height + 2 * child->ypadding <= ROW_HEIGHT(sheet, child->row))
 	    {
 		if (child->yfill)
 		{
-		    child_requisition.height = child_allocation.height = sheet->row[child->row].height - 2 * child->ypadding;
+		    child_requisition.height = child_allocation.height = ROW_HEIGHT(sheet, child->row) - 2 * child->ypadding;
 		}
 		else
 		{
 		    if (child->yexpand)
 		    {
-			child->y = area.y + sheet->row[child->row].height / 2 -
+			child->y = area.y + ROW_HEIGHT(sheet, child->row) / 2 -
 			    child_requisition.height / 2;
 		    }
 		    child_allocation.height = child_requisition.height;
@@ -16208,7 +24266,7 @@ gtk_sheet_position_child(GtkSheet *sheet, GtkSheetChild *child)
 		{
 		    gtk_sheet_set_row_height(sheet, child->row, child_requisition.height + 2 * child->ypadding);
 		}
-		child_allocation.height = sheet->row[child->row].height - 2 * child->ypadding;
+		child_allocation.height = ROW_HEIGHT(sheet, child->row) - 2 * child->ypadding;
 	    }
 	}
 	else
@@ -16400,10 +24458,15 @@ gtk_sheet_remove_handler(GtkContainer *container, GtkWidget *widget)
     if (children)
     {
 	if (child->row == -1)
-	    sheet->row[child->col].button.child = NULL;
+	    COLPTR(sheet, child->col)->button.child = NULL;
 
 	if (child->col == -1)
-	    COLPTR(sheet, child->row)->button.child = NULL;
+	{
+	    GtkSheetRow *rowp = _gtk_sheet_row_peek(sheet, child->row);
+
+	    if (rowp)
+		rowp->button.child = NULL;
+	}
 
 #if GTK_SHEET_DEBUG_CHILDREN > 0
 	g_debug("gtk_sheet_remove_handler: %p %s widget %p", 
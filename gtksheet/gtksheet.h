@@ -186,8 +186,35 @@ typedef struct _GtkSheetRange GtkSheetRange;
 typedef struct _GtkSheetButton       GtkSheetButton;
 typedef struct _GtkSheetCellAttr     GtkSheetCellAttr;
 typedef struct _GtkSheetCellBorder     GtkSheetCellBorder;
+typedef struct _GtkSheetCellBlock     GtkSheetCellBlock;
+typedef struct _GtkSheetMemPool     GtkSheetMemPool;
+typedef struct _GtkSheetAttrTable     GtkSheetAttrTable;
+typedef struct _GtkSheetAttrLayer     GtkSheetAttrLayer;
+typedef struct _GtkSheetPrefixSum     GtkSheetPrefixSum;
+typedef struct _GtkSheetRowPage     GtkSheetRowPage;
+typedef struct _GtkSheetMetricsCache     GtkSheetMetricsCache;
+typedef struct _GtkSheetExtentCache     GtkSheetExtentCache;
+typedef struct _GtkSheetLayoutCache     GtkSheetLayoutCache;
+typedef struct _GtkSheetTileCache     GtkSheetTileCache;
+typedef struct _GtkSheetRenderPool     GtkSheetRenderPool;
+typedef struct _GtkSheetModelCache     GtkSheetModelCache;
 
-#define GTK_SHEET_OPTIMIZE_COLUMN_DRAW  0  /* 0=off, 1=on */
+/**
+ * GtkSheetRangeTextFunc:
+ * @sheet: the #GtkSheet being loaded
+ * @row: row number
+ * @col: column number
+ * @user_data: data passed to gtk_sheet_set_range_texts_func()
+ *
+ * Text source for bulk loading a range.
+ *
+ * Returns: (transfer none) the cell text or NULL, it must stay 
+ * valid until the next call
+ */
+typedef const gchar *(*GtkSheetRangeTextFunc) (GtkSheet *sheet,
+                                              gint row, gint col, gpointer user_data);
+
+#define GTK_SHEET_OPTIMIZE_COLUMN_DRAW  1  /* 0=off, 1=on */
 
 
 /**
@@ -278,6 +305,8 @@ struct _GtkSheetCellAttr
  *
  * The GtkSheetCell struct contains only private data.
  * It should only be accessed through the functions described below.
+ * Its strings are owned by the sheet's memory pool, they must 
+ * never be freed or replaced by the application.
  */
 struct _GtkSheetCell
 {
@@ -287,7 +316,8 @@ struct _GtkSheetCell
     gint row;
     gint col;
 
-    GtkSheetCellAttr *attributes;
+    guint attr_id;  /* interned attributes, 0 = default */
+    guint extent_flags;  /* extent counted in row/column histograms */
 
     gchar *text;
     gpointer link;
@@ -303,7 +333,9 @@ struct _GtkSheetCell
  * @rowi:  lower right cell 
  * @coli: lower right cell 
  *  
- * Defines a rectangular range of cells.
+ * Defines a rectangular range of cells. When styling a range, 
+ * a @rowi or @coli of G_MAXINT makes it unbounded, it then also 
+ * applies to rows or columns added later.
  */
 struct _GtkSheetRange
 {
@@ -322,23 +354,22 @@ struct _GtkSheetRange
 struct _GtkSheetRow
 {
     /*< private >*/
+    /* only rows with any of these set have a GtkSheetRow, row 
+       heights and flags are kept in arrays of the sheet */
     gchar *name;
-    gint height;
     guint16 requisition;
-    gint top_ypixel;
-    gint max_extent_height;  /* := max(Cell.extent.height) */
 
-    GtkSheetButton button;
-    gboolean is_sensitive;
-    gboolean is_visible;
-    gboolean is_readonly;   /* to override cell editable */
-    gboolean can_focus;     /* to allow keyboard/mouse focus */
+    GtkSheetButton button;  /* button state is a row flag */
 
     gchar *tooltip_markup; /* tooltip, which is marked up with the Pango text markup language */
     gchar *tooltip_text;  /* tooltip, without markup */
+
+    GtkSheetAttrLayer *attr_layer;  /* row style or NULL */
 };
 
 #include "gtksheetcolumn.h"
+#include "gtksheetmodel.h"
+#include "gtksheettreeadapter.h"
 
 
 
@@ -359,6 +390,7 @@ struct _GtkSheet
     gboolean autoresize_rows;
     gboolean autoscroll;
     gboolean clip_text;
+    gboolean text_spread_dirty;  /* a column's text spread may shrink */
     gboolean justify_entry;
     gboolean locked;
 
@@ -378,7 +410,15 @@ struct _GtkSheet
     gchar *title;
     gchar *description;         /* sheet description and further information for application use */
 
-    GtkSheetRow *row;
+    GtkSheetRowPage **row_pages;  /* per page of rows, heights, flags and
+                                     extents, NULL for default rows */
+    gint row_npages;        /* pages covering rows 0..maxrow */
+    gint row_page_height;   /* height of rows in NULL pages */
+    GHashTable *row_data;   /* row -> GtkSheetRow, rows with more data */
+    gint row_data_last;     /* no row_data key beyond this row */
+    GHashTable *row_extent_hist;  /* row -> counted Cell.extent.height,
+                                     rows with mixed extents only */
+    gint row_extent_hist_last;  /* no row_extent_hist key beyond */
     GtkSheetColumn **column;  /* flexible array of column pointers */
 
     gboolean rows_resizable;
@@ -392,13 +432,66 @@ struct _GtkSheet
 
     GtkSheetRange view;
 
-    /* sheet data: dynamically allocated array of cell pointers */
-    GtkSheetCell ***data;
+    /* sheet data: sparse directory of cell blocks, allocated on demand */
+    GtkSheetCellBlock ***data;
+    gint data_block_rows;  /* allocated directory rows */
+    gint data_block_cols;  /* allocated directory columns */
 
-    /* max number of allocated cells in **data */
+    /* max cell coordinates that may be allocated in **data */
     gint maxallocrow;
     gint maxalloccol;
 
+    /* cell slabs and cell string arena */
+    GtkSheetMemPool *mem_pool;
+
+    /* interned cell attributes, shared by id */
+    GtkSheetAttrTable *attr_table;
+
+    /* range style rules, see gtksheet.c */
+    GList *attr_rules;
+    GPtrArray *attr_rule_bands;  /* block row -> rules covering it */
+    guint attr_serial;  /* write stamp for style layers */
+
+    /* row offsets: prefix sums of visible row heights per row page */
+    GtkSheetPrefixSum *row_geometry;
+
+    /* column offsets: prefix sums of visible column widths */
+    GtkSheetPrefixSum *column_geometry;
+
+    /* open gtk_sheet_geometry_begin() calls, geometry left stale */
+    gint geometry_batch;
+    guint geometry_dirty;  /* geometries to rebuild on commit */
+
+    /* font metrics per font description */
+    GtkSheetMetricsCache *metrics_cache;
+
+    /* measured text extents, LRU */
+    GtkSheetExtentCache *extent_cache;
+
+    /* shaped cell labels in or near the view */
+    GtkSheetLayoutCache *layout_cache;
+
+    /* cell ranges waiting for the idle redraw */
+    GArray *dirty_ranges;
+    guint dirty_idle;
+
+    /* render cells with cairo instead of GdkGC */
+    gboolean cairo_draw;
+
+    /* rendered tiles, NULL when disabled */
+    GtkSheetTileCache *tile_cache;
+
+    /* worker threads, NULL when rendering on the main thread */
+    GtkSheetRenderPool *render_pool;
+
+    /* cell data source or NULL, texts pulled near the view */
+    GtkSheetModel *model;
+    GtkSheetModelCache *model_cache;
+
+    /* background extent measuring, see gtk_sheet_refresh_extents() */
+    guint extent_idle;
+    gint extent_cursor;  /* next row to measure */
+
     /* active cell */
     GtkSheetCell active_cell;
     GtkWidget *sheet_entry;
@@ -523,6 +616,9 @@ struct _GtkSheetClass
                         GtkMovementStep step,
                         gint count,
                         gboolean extend_selection);
+
+    void (*range_changed)(GtkSheet *sheet, GtkSheetRange *range);
+    void (*extents_progress)(GtkSheet *sheet, gint done, gint total);
 };
 
 GType gtk_sheet_get_type(void);
@@ -577,11 +673,18 @@ void gtk_sheet_set_autoresize_rows(GtkSheet *sheet, gboolean autoresize);
 gboolean gtk_sheet_autoresize(GtkSheet *sheet);
 gboolean gtk_sheet_autoresize_columns(GtkSheet *sheet);
 gboolean gtk_sheet_autoresize_rows(GtkSheet *sheet);
+void gtk_sheet_refresh_extents(GtkSheet *sheet);
 
 void gtk_sheet_set_autoscroll(GtkSheet *sheet, gboolean autoscroll);
 gboolean gtk_sheet_autoscroll(GtkSheet *sheet);
 void gtk_sheet_set_clip_text(GtkSheet *sheet, gboolean clip_text);
 gboolean gtk_sheet_clip_text(GtkSheet *sheet);
+void gtk_sheet_set_cairo_draw(GtkSheet *sheet, gboolean cairo_draw);
+gboolean gtk_sheet_cairo_draw(GtkSheet *sheet);
+void gtk_sheet_set_tile_cache_size(GtkSheet *sheet, guint kbytes);
+guint gtk_sheet_get_tile_cache_size(GtkSheet *sheet);
+void gtk_sheet_set_render_threads(GtkSheet *sheet, guint n_threads);
+guint gtk_sheet_get_render_threads(GtkSheet *sheet);
 void gtk_sheet_set_justify_entry(GtkSheet *sheet, gboolean justify);
 gboolean gtk_sheet_justify_entry(GtkSheet *sheet);
 void gtk_sheet_set_vjustification(GtkSheet *sheet, GtkSheetVerticalJustification vjust);
@@ -604,6 +707,8 @@ const gchar *gtk_sheet_get_description(GtkSheet *sheet, const gchar *description
 gboolean gtk_sheet_is_frozen(GtkSheet *sheet);
 void gtk_sheet_freeze(GtkSheet *sheet);
 void gtk_sheet_thaw(GtkSheet *sheet);
+void gtk_sheet_geometry_begin(GtkSheet *sheet);
+void gtk_sheet_geometry_commit(GtkSheet *sheet);
 
 /* Background colors */
 void gtk_sheet_set_background(GtkSheet *sheet, GdkColor *color);
@@ -726,8 +831,14 @@ void gtk_sheet_set_tab_direction(GtkSheet *sheet, GtkDirectionType dir);
 void gtk_sheet_set_cell(GtkSheet *sheet, gint row, gint col,
                         GtkJustification justification, const gchar *text);
 void gtk_sheet_set_cell_text(GtkSheet *sheet, gint row, gint col, const gchar *text);
+void gtk_sheet_set_range_texts(GtkSheet *sheet, const GtkSheetRange *range,
+                               const gchar * const *texts);
+void gtk_sheet_set_range_texts_func(GtkSheet *sheet, const GtkSheetRange *range,
+                                    GtkSheetRangeTextFunc func, gpointer user_data);
 
 /* get cell contents */
+void gtk_sheet_set_model(GtkSheet *sheet, GtkSheetModel *model);
+GtkSheetModel *gtk_sheet_get_model(GtkSheet *sheet);
 gchar *gtk_sheet_cell_get_text(GtkSheet *sheet, gint row, gint col);
 
 /* clear cell contents */
@@ -842,17 +953,26 @@ void _gtk_sheet_range_fixup(GtkSheet *sheet, GtkSheetRange *range);
 
 void _gtk_sheet_entry_size_allocate(GtkSheet *sheet);
 void _gtk_sheet_button_size_request(GtkSheet *sheet,
-                                    GtkSheetButton *button, GtkRequisition *requisition);
+                                    const GtkSheetButton *button, GtkRequisition *requisition);
 void _gtk_sheet_scrollbar_adjust(GtkSheet *sheet);
 
+void _gtk_sheet_recount_extents(GtkSheet *sheet,
+                                const GtkSheetRange *range);
+
 void _gtk_sheet_recalc_top_ypixels(GtkSheet *sheet);
+void _gtk_sheet_row_geometry_changed(GtkSheet *sheet, gint row);
 void _gtk_sheet_recalc_left_xpixels(GtkSheet *sheet);
+void _gtk_sheet_column_geometry_changed(GtkSheet *sheet, gint col);
+gint _gtk_sheet_column_geometry_offset(GtkSheet *sheet, gint col);
 void _gtk_sheet_recalc_view_range(GtkSheet *sheet);
 
 void _gtk_sheet_reset_text_column(GtkSheet *sheet, gint start_column);
 
 void _gtk_sheet_range_draw(GtkSheet *sheet,
                            const GtkSheetRange *range, gboolean activate_active_cell);
+void _gtk_sheet_range_queue_draw(GtkSheet *sheet, const GtkSheetRange *range);
+void _gtk_sheet_flush_queued_draw(GtkSheet *sheet);
+void _gtk_sheet_tile_cache_invalidate(GtkSheet *sheet, const GtkSheetRange *range);
 void _gtk_sheet_hide_active_cell(GtkSheet *sheet);
 void _gtk_sheet_redraw_internal(GtkSheet *sheet,
                                 gboolean reset_hadjustment, gboolean reset_vadjustment);
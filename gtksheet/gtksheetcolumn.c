@@ -140,8 +140,9 @@ gtk_sheet_column_set_property(GObject *object,
 
                 /* todo: swap cell data! */
 
-                _gtk_sheet_reset_text_column(sheet, MIN(col, newcol));
-                _gtk_sheet_recalc_left_xpixels(sheet);
+                _gtk_sheet_reset_text_column(sheet, MIN(col, newcol) - 1);
+                _gtk_sheet_column_geometry_changed(sheet, col);
+                _gtk_sheet_column_geometry_changed(sheet, newcol);
             }
             break;
 
@@ -174,6 +175,9 @@ gtk_sheet_column_set_property(GObject *object,
                     || !gtk_widget_get_realized(GTK_WIDGET(sheet)))
                 {
                     colobj->width = width;
+
+                    if (col >= 0 && G_IS_OBJECT(sheet))
+                        _gtk_sheet_column_geometry_changed(sheet, col);
                 }
                 else
                 {
@@ -322,6 +326,9 @@ gtk_sheet_column_set_property(GObject *object,
                     || !gtk_widget_get_realized(GTK_WIDGET(sheet)))
                 {
                     GTK_SHEET_COLUMN_SET_VISIBLE(colobj, visible);
+
+                    if (col >= 0 && G_IS_OBJECT(sheet))
+                        _gtk_sheet_column_geometry_changed(sheet, col);
                 }
                 else
                     gtk_sheet_column_set_visibility(sheet, col, visible);
@@ -663,8 +670,9 @@ gtk_sheet_column_init(GtkSheetColumn *column)
     column->title = NULL;
     column->width = GTK_SHEET_COLUMN_DEFAULT_WIDTH;
     column->requisition = GTK_SHEET_COLUMN_DEFAULT_WIDTH;
-    column->left_xpixel = 0;
     column->max_extent_width = 0;
+    column->extent_hist = NULL;
+    column->extent_unknown = FALSE;
 
     column->button.state = GTK_STATE_NORMAL;
     column->button.label = NULL;
@@ -673,7 +681,10 @@ gtk_sheet_column_init(GtkSheetColumn *column)
     column->button.justification = GTK_JUSTIFY_CENTER;
 
 #if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
-    column->left_text_column = column->right_text_column = 0;
+    column->left_text_column = column->right_text_column = 0;  /* see _gtk_sheet_reset_text_column() */
+    column->left_text_spread = column->right_text_spread = 0;
+    column->text_spread_dirty = FALSE;
+    column->text_spans = NULL;
 #endif
 
     column->justification = GTK_SHEET_COLUMN_DEFAULT_JUSTIFICATION;
@@ -732,6 +743,20 @@ gtk_sheet_column_finalize_handler(GObject *gobject)
         column->description = NULL;
     }
 
+    if (column->extent_hist)
+    {
+        g_sequence_free(column->extent_hist);
+        column->extent_hist = NULL;
+    }
+
+#if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
+    if (column->text_spans)
+    {
+        g_hash_table_destroy(column->text_spans);
+        column->text_spans = NULL;
+    }
+#endif
+
     G_OBJECT_CLASS(sheet_column_parent_class)->finalize(gobject);
 }
 
@@ -912,7 +937,7 @@ gint
 _gtk_sheet_column_left_xpixel(GtkSheet *sheet, gint col)
 {
     if (col < 0 || col > sheet->maxcol) return (sheet->hoffset);
-    return (sheet->hoffset + COLPTR(sheet, col)->left_xpixel);
+    return (sheet->hoffset + _gtk_sheet_column_geometry_offset(sheet, col));
 }
 
 /**
@@ -1077,7 +1102,7 @@ gtk_sheet_set_column_width(GtkSheet *sheet, gint col, guint width)
 
     COLPTR(sheet, col)->width = width;
 
-    _gtk_sheet_recalc_left_xpixels(sheet);
+    _gtk_sheet_column_geometry_changed(sheet, col);
 
     if (gtk_widget_get_realized(GTK_WIDGET(sheet))
         && !gtk_sheet_is_frozen(sheet))
@@ -1178,6 +1203,8 @@ void
 gtk_sheet_column_set_justification(GtkSheet *sheet, gint col,
                                    GtkJustification justification)
 {
+    GtkSheetRange range;
+
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
@@ -1185,6 +1212,11 @@ gtk_sheet_column_set_justification(GtkSheet *sheet, gint col,
 
     COLPTR(sheet, col)->justification = justification;
 
+    range.row0 = 0;
+    range.rowi = sheet->maxrow;
+    range.col0 = range.coli = col;
+    _gtk_sheet_tile_cache_invalidate(sheet, &range);
+
     if (gtk_widget_get_realized(GTK_WIDGET(sheet))
         && !gtk_sheet_is_frozen(sheet)
         && col >= MIN_VIEW_COLUMN(sheet)
@@ -1225,6 +1257,8 @@ void
 gtk_sheet_column_set_vjustification(GtkSheet *sheet, gint col,
                                     GtkSheetVerticalJustification vjust)
 {
+    GtkSheetRange range;
+
     g_return_if_fail(sheet != NULL);
     g_return_if_fail(GTK_IS_SHEET(sheet));
 
@@ -1232,6 +1266,11 @@ gtk_sheet_column_set_vjustification(GtkSheet *sheet, gint col,
 
     COLPTR(sheet, col)->vjust = vjust;
 
+    range.row0 = 0;
+    range.rowi = sheet->maxrow;
+    range.col0 = range.coli = col;
+    _gtk_sheet_tile_cache_invalidate(sheet, &range);
+
     if (gtk_widget_get_realized(GTK_WIDGET(sheet))
         && !gtk_sheet_is_frozen(sheet)
         && col >= MIN_VIEW_COLUMN(sheet)
@@ -1825,8 +1864,18 @@ gtk_sheet_column_set_visibility(GtkSheet *sheet, gint col, gboolean visible)
 
     GTK_SHEET_COLUMN_SET_VISIBLE(colobj, visible);
 
+    {
+        GtkSheetRange range;
+
+        range.row0 = 0;
+        range.rowi = sheet->maxrow;
+        range.col0 = range.coli = col;
+
+        _gtk_sheet_recount_extents(sheet, &range);
+    }
+
     _gtk_sheet_range_fixup(sheet, &sheet->range);
-    _gtk_sheet_recalc_left_xpixels(sheet);
+    _gtk_sheet_column_geometry_changed(sheet, col);
 
     _gtk_sheet_scrollbar_adjust(sheet);
     _gtk_sheet_redraw_internal(sheet, TRUE, FALSE);
@@ -48,14 +48,19 @@ struct _GtkSheetColumn
     gchar *title;
     gint width;
     guint16 requisition;
-    gint left_xpixel;   /* left edge of the column*/
     gint max_extent_width;  /* := max(Cell.extent.width) */
+    GSequence *extent_hist;  /* counted Cell.extent.width or NULL */
+    gboolean extent_unknown;  /* holds cells with deferred extents */
 
     GtkSheetButton button;
 
 #if GTK_SHEET_OPTIMIZE_COLUMN_DRAW>0
     gint left_text_column;      /* min left column displaying text on this column */
     gint right_text_column;    /* max right column displaying text on this column */
+    gint left_text_spread;     /* min left column this column's text is displayed on */
+    gint right_text_spread;    /* max right column this column's text is displayed on */
+    gboolean text_spread_dirty;  /* spread to be recounted from text_spans */
+    GHashTable *text_spans;    /* row -> columns covered by an overflowing label, or NULL */
 #endif
 
     GtkJustification justification;    /* horizontal text justification */
@@ -72,6 +77,8 @@ struct _GtkSheetColumn
     gint max_length;   /* maximum character length */
     gint max_length_bytes;   /* maximum byte length */
     GtkWrapMode wrap_mode;  /* wrap-mode */
+
+    GtkSheetAttrLayer *attr_layer;  /* column style or NULL */
 };
 
 struct _GtkSheetColumnClass
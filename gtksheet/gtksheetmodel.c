@@ -0,0 +1,395 @@
+/* GtkSheetModel interface for Gtk+.
+ * Copyright 2011  Fredy Paquet <fredy@opag.ch>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * SECTION: gtksheetmodel
+ * @short_description: A cell data source for #GtkSheet
+ *
+ * The #GtkSheetModel interface lets a #GtkSheet display data
+ * it does not store. Once a model is attached with
+ * gtk_sheet_set_model(), the sheet asks the model for the text
+ * and attributes of the cells it is going to draw, measure or
+ * edit, and only for those.
+ *
+ * The model announces changes of its data with
+ * gtk_sheet_model_cells_changed() and changes of its shape
+ * with gtk_sheet_model_rows_inserted() and friends.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <glib.h>
+#include <gdk/gdk.h>
+#include <gtk/gtk.h>
+#include <pango/pango.h>
+
+#define __GTKSHEET_H_INSIDE__
+
+#include "gtksheet-compat.h"
+#include "gtksheet.h"
+#include "gtksheetmodel.h"
+#include "gtksheet-marshal.h"
+
+enum
+{
+    CELLS_CHANGED,
+    ROWS_INSERTED,
+    ROWS_DELETED,
+    COLUMNS_INSERTED,
+    COLUMNS_DELETED,
+    LAST_SIGNAL
+};
+
+static guint model_signals[LAST_SIGNAL] = { 0 };
+
+
+static void
+gtk_sheet_model_base_init(gpointer g_iface)
+{
+    static gboolean initialized = FALSE;
+
+    if (initialized)
+	return;
+
+    /**
+     * GtkSheetModel::cells-changed:
+     * @model: the model that emitted the signal
+     * @range: the #GtkSheetRange whose contents changed
+     *
+     * Emmited when the text or attributes of cells changed.
+     */
+    model_signals[CELLS_CHANGED] =
+	g_signal_new("cells-changed",
+	G_TYPE_SHEET_MODEL,
+	G_SIGNAL_RUN_LAST,
+	G_STRUCT_OFFSET(GtkSheetModelIface, cells_changed),
+	NULL, NULL,
+	gtksheet_VOID__BOXED,
+	G_TYPE_NONE, 1, G_TYPE_SHEET_RANGE);
+
+    /**
+     * GtkSheetModel::rows-inserted:
+     * @model: the model that emitted the signal
+     * @row: index of the first new row
+     * @nrows: number of rows inserted
+     *
+     * Emmited after rows were inserted into the model.
+     */
+    model_signals[ROWS_INSERTED] =
+	g_signal_new("rows-inserted",
+	G_TYPE_SHEET_MODEL,
+	G_SIGNAL_RUN_LAST,
+	G_STRUCT_OFFSET(GtkSheetModelIface, rows_inserted),
+	NULL, NULL,
+	gtksheet_VOID__INT_INT,
+	G_TYPE_NONE, 2, G_TYPE_INT, G_TYPE_INT);
+
+    /**
+     * GtkSheetModel::rows-deleted:
+     * @model: the model that emitted the signal
+     * @row: index of the first deleted row
+     * @nrows: number of rows deleted
+     *
+     * Emmited after rows were removed from the model.
+     */
+    model_signals[ROWS_DELETED] =
+	g_signal_new("rows-deleted",
+	G_TYPE_SHEET_MODEL,
+	G_SIGNAL_RUN_LAST,
+	G_STRUCT_OFFSET(GtkSheetModelIface, rows_deleted),
+	NULL, NULL,
+	gtksheet_VOID__INT_INT,
+	G_TYPE_NONE, 2, G_TYPE_INT, G_TYPE_INT);
+
+    /**
+     * GtkSheetModel::columns-inserted:
+     * @model: the model that emitted the signal
+     * @col: index of the first new column
+     * @ncols: number of columns inserted
+     *
+     * Emmited after columns were inserted into the model.
+     */
+    model_signals[COLUMNS_INSERTED] =
+	g_signal_new("columns-inserted",
+	G_TYPE_SHEET_MODEL,
+	G_SIGNAL_RUN_LAST,
+	G_STRUCT_OFFSET(GtkSheetModelIface, columns_inserted),
+	NULL, NULL,
+	gtksheet_VOID__INT_INT,
+	G_TYPE_NONE, 2, G_TYPE_INT, G_TYPE_INT);
+
+    /**
+     * GtkSheetModel::columns-deleted:
+     * @model: the model that emitted the signal
+     * @col: index of the first deleted column
+     * @ncols: number of columns deleted
+     *
+     * Emmited after columns were removed from the model.
+     */
+    model_signals[COLUMNS_DELETED] =
+	g_signal_new("columns-deleted",
+	G_TYPE_SHEET_MODEL,
+	G_SIGNAL_RUN_LAST,
+	G_STRUCT_OFFSET(GtkSheetModelIface, columns_deleted),
+	NULL, NULL,
+	gtksheet_VOID__INT_INT,
+	G_TYPE_NONE, 2, G_TYPE_INT, G_TYPE_INT);
+
+    initialized = TRUE;
+}
+
+/* Type initialisation */
+
+GType
+gtk_sheet_model_get_type(void)
+{
+    static GType sheet_model_type = 0;
+
+    if (!sheet_model_type)
+    {
+        static const GTypeInfo sheet_model_info =
+        {
+            sizeof(GtkSheetModelIface),
+            (GBaseInitFunc)gtk_sheet_model_base_init,
+            NULL,
+            NULL,
+            NULL,
+            NULL,
+            0,
+            0,
+            NULL,
+            NULL,
+        };
+
+        sheet_model_type = g_type_register_static(G_TYPE_INTERFACE,
+                                                  "GtkSheetModel",
+                                                  &sheet_model_info,
+                                                  0);
+
+        g_type_interface_add_prerequisite(sheet_model_type, G_TYPE_OBJECT);
+    }
+    return (sheet_model_type);
+}
+
+/**
+ * gtk_sheet_model_get_n_rows:
+ * @model: a #GtkSheetModel
+ *
+ * Get the number of rows the model provides.
+ *
+ * Returns: number of rows
+ */
+gint
+gtk_sheet_model_get_n_rows(GtkSheetModel *model)
+{
+    GtkSheetModelIface *iface;
+
+    g_return_val_if_fail(GTK_IS_SHEET_MODEL(model), 0);
+
+    iface = GTK_SHEET_MODEL_GET_IFACE(model);
+    g_return_val_if_fail(iface->get_n_rows != NULL, 0);
+
+    return (iface->get_n_rows(model));
+}
+
+/**
+ * gtk_sheet_model_get_n_columns:
+ * @model: a #GtkSheetModel
+ *
+ * Get the number of columns the model provides.
+ *
+ * Returns: number of columns
+ */
+gint
+gtk_sheet_model_get_n_columns(GtkSheetModel *model)
+{
+    GtkSheetModelIface *iface;
+
+    g_return_val_if_fail(GTK_IS_SHEET_MODEL(model), 0);
+
+    iface = GTK_SHEET_MODEL_GET_IFACE(model);
+    g_return_val_if_fail(iface->get_n_columns != NULL, 0);
+
+    return (iface->get_n_columns(model));
+}
+
+/**
+ * gtk_sheet_model_get_cell_text:
+ * @model: a #GtkSheetModel
+ * @row: row number
+ * @col: column number
+ *
+ * Get the text of a cell.
+ *
+ * Returns: (transfer full) the cell text or NULL, free with
+ * g_free()
+ */
+gchar *
+gtk_sheet_model_get_cell_text(GtkSheetModel *model, gint row, gint col)
+{
+    GtkSheetModelIface *iface;
+
+    g_return_val_if_fail(GTK_IS_SHEET_MODEL(model), NULL);
+
+    iface = GTK_SHEET_MODEL_GET_IFACE(model);
+    g_return_val_if_fail(iface->get_cell_text != NULL, NULL);
+
+    return (iface->get_cell_text(model, row, col));
+}
+
+/**
+ * gtk_sheet_model_get_cell_attributes:
+ * @model: a #GtkSheetModel
+ * @row: row number
+ * @col: column number
+ * @attributes: (inout) the attributes the sheet computed so far
+ *
+ * Let the model adjust the attributes of a cell. Models which
+ * do not implement get_cell_attributes leave @attributes
+ * untouched.
+ */
+void
+gtk_sheet_model_get_cell_attributes(GtkSheetModel *model,
+    gint row, gint col, GtkSheetCellAttr *attributes)
+{
+    GtkSheetModelIface *iface;
+
+    g_return_if_fail(GTK_IS_SHEET_MODEL(model));
+    g_return_if_fail(attributes != NULL);
+
+    iface = GTK_SHEET_MODEL_GET_IFACE(model);
+
+    if (iface->get_cell_attributes)
+	iface->get_cell_attributes(model, row, col, attributes);
+}
+
+/**
+ * gtk_sheet_model_set_cell_text:
+ * @model: a #GtkSheetModel
+ * @row: row number
+ * @col: column number
+ * @text: the new cell text or NULL to clear the cell
+ *
+ * Store text into a cell of the model.
+ *
+ * Returns: FALSE if the model is read-only or refused the text
+ */
+gboolean
+gtk_sheet_model_set_cell_text(GtkSheetModel *model,
+    gint row, gint col, const gchar *text)
+{
+    GtkSheetModelIface *iface;
+
+    g_return_val_if_fail(GTK_IS_SHEET_MODEL(model), FALSE);
+
+    iface = GTK_SHEET_MODEL_GET_IFACE(model);
+
+    if (!iface->set_cell_text)
+	return (FALSE);
+
+    return (iface->set_cell_text(model, row, col, text));
+}
+
+/**
+ * gtk_sheet_model_cells_changed:
+ * @model: a #GtkSheetModel
+ * @range: the changed cells
+ *
+ * Emits the "cells-changed" signal. Models must call this
+ * after modifying the text or attributes of cells.
+ */
+void
+gtk_sheet_model_cells_changed(GtkSheetModel *model,
+    const GtkSheetRange *range)
+{
+    g_return_if_fail(GTK_IS_SHEET_MODEL(model));
+    g_return_if_fail(range != NULL);
+
+    g_signal_emit(model, model_signals[CELLS_CHANGED], 0, range);
+}
+
+/**
+ * gtk_sheet_model_rows_inserted:
+ * @model: a #GtkSheetModel
+ * @row: index of the first new row
+ * @nrows: number of rows inserted
+ *
+ * Emits the "rows-inserted" signal. Models must call this
+ * after inserting rows.
+ */
+void
+gtk_sheet_model_rows_inserted(GtkSheetModel *model, gint row, gint nrows)
+{
+    g_return_if_fail(GTK_IS_SHEET_MODEL(model));
+
+    g_signal_emit(model, model_signals[ROWS_INSERTED], 0, row, nrows);
+}
+
+/**
+ * gtk_sheet_model_rows_deleted:
+ * @model: a #GtkSheetModel
+ * @row: index of the first deleted row
+ * @nrows: number of rows deleted
+ *
+ * Emits the "rows-deleted" signal. Models must call this after
+ * deleting rows.
+ */
+void
+gtk_sheet_model_rows_deleted(GtkSheetModel *model, gint row, gint nrows)
+{
+    g_return_if_fail(GTK_IS_SHEET_MODEL(model));
+
+    g_signal_emit(model, model_signals[ROWS_DELETED], 0, row, nrows);
+}
+
+/**
+ * gtk_sheet_model_columns_inserted:
+ * @model: a #GtkSheetModel
+ * @col: index of the first new column
+ * @ncols: number of columns inserted
+ *
+ * Emits the "columns-inserted" signal. Models must call this
+ * after inserting columns.
+ */
+void
+gtk_sheet_model_columns_inserted(GtkSheetModel *model, gint col, gint ncols)
+{
+    g_return_if_fail(GTK_IS_SHEET_MODEL(model));
+
+    g_signal_emit(model, model_signals[COLUMNS_INSERTED], 0, col, ncols);
+}
+
+/**
+ * gtk_sheet_model_columns_deleted:
+ * @model: a #GtkSheetModel
+ * @col: index of the first deleted column
+ * @ncols: number of columns deleted
+ *
+ * Emits the "columns-deleted" signal. Models must call this
+ * after deleting columns.
+ */
+void
+gtk_sheet_model_columns_deleted(GtkSheetModel *model, gint col, gint ncols)
+{
+    g_return_if_fail(GTK_IS_SHEET_MODEL(model));
+
+    g_signal_emit(model, model_signals[COLUMNS_DELETED], 0, col, ncols);
+}
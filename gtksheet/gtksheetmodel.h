@@ -0,0 +1,120 @@
+/* GtkSheetModel interface for Gtk+.
+ * Copyright 2011  Fredy Paquet <fredy@opag.ch>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#if defined(GTK_DISABLE_SINGLE_INCLUDES) && !defined (__GTK_H_INSIDE__) && !defined (GTK_COMPILATION) && !defined (__GTKSHEET_H_INSIDE__)
+#   error "Only <gtksheet/gtksheet.h> can be included directly."
+#endif
+
+#ifndef __GTK_SHEET_MODEL_H__
+#define __GTK_SHEET_MODEL_H__
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+G_BEGIN_DECLS
+
+#define G_TYPE_SHEET_MODEL (gtk_sheet_model_get_type ())
+
+#define GTK_SHEET_MODEL(obj) \
+    (G_TYPE_CHECK_INSTANCE_CAST ((obj), G_TYPE_SHEET_MODEL, GtkSheetModel))
+
+#define GTK_IS_SHEET_MODEL(obj) \
+    (G_TYPE_CHECK_INSTANCE_TYPE ((obj), G_TYPE_SHEET_MODEL))
+
+#define GTK_SHEET_MODEL_GET_IFACE(obj) \
+    (G_TYPE_INSTANCE_GET_INTERFACE ((obj), G_TYPE_SHEET_MODEL, GtkSheetModelIface))
+
+typedef struct _GtkSheetModel GtkSheetModel;  /* dummy object */
+typedef struct _GtkSheetModelIface GtkSheetModelIface;
+
+/**
+ * GtkSheetModelIface:
+ * @get_n_rows: returns the number of rows
+ * @get_n_columns: returns the number of columns
+ * @get_cell_text: returns a newly allocated string for the cell
+ *               or NULL for an empty cell
+ * @get_cell_attributes: optional, adjusts the layered
+ *               attributes of a cell, a font description set
+ *               here remains owned by the model
+ * @set_cell_text: optional, stores text entered into the sheet,
+ *               returns FALSE if the text was not stored
+ * @cells_changed: class handler for the "cells-changed" signal
+ * @rows_inserted: class handler for the "rows-inserted" signal
+ * @rows_deleted: class handler for the "rows-deleted" signal
+ * @columns_inserted: class handler for the "columns-inserted"
+ *               signal
+ * @columns_deleted: class handler for the "columns-deleted"
+ *               signal
+ *
+ * The virtual functions a cell data source has to implement.
+ */
+struct _GtkSheetModelIface
+{
+    /*< private >*/
+    GTypeInterface g_iface;
+
+    /*< public >*/
+    gint (*get_n_rows) (GtkSheetModel *model);
+    gint (*get_n_columns) (GtkSheetModel *model);
+    gchar *(*get_cell_text) (GtkSheetModel *model, gint row, gint col);
+    void (*get_cell_attributes) (GtkSheetModel *model, gint row, gint col,
+                                 GtkSheetCellAttr *attributes);
+    gboolean (*set_cell_text) (GtkSheetModel *model, gint row, gint col,
+                               const gchar *text);
+
+    /* signals */
+    void (*cells_changed) (GtkSheetModel *model, GtkSheetRange *range);
+    void (*rows_inserted) (GtkSheetModel *model, gint row, gint nrows);
+    void (*rows_deleted) (GtkSheetModel *model, gint row, gint nrows);
+    void (*columns_inserted) (GtkSheetModel *model, gint col, gint ncols);
+    void (*columns_deleted) (GtkSheetModel *model, gint col, gint ncols);
+};
+
+GType gtk_sheet_model_get_type(void);
+
+gint gtk_sheet_model_get_n_rows(GtkSheetModel *model);
+gint gtk_sheet_model_get_n_columns(GtkSheetModel *model);
+gchar *gtk_sheet_model_get_cell_text(GtkSheetModel *model,
+                                     gint row, gint col);
+void gtk_sheet_model_get_cell_attributes(GtkSheetModel *model,
+                                         gint row, gint col, GtkSheetCellAttr *attributes);
+gboolean gtk_sheet_model_set_cell_text(GtkSheetModel *model,
+                                       gint row, gint col, const gchar *text);
+
+void gtk_sheet_model_cells_changed(GtkSheetModel *model,
+                                   const GtkSheetRange *range);
+void gtk_sheet_model_rows_inserted(GtkSheetModel *model,
+                                   gint row, gint nrows);
+void gtk_sheet_model_rows_deleted(GtkSheetModel *model,
+                                  gint row, gint nrows);
+void gtk_sheet_model_columns_inserted(GtkSheetModel *model,
+                                      gint col, gint ncols);
+void gtk_sheet_model_columns_deleted(GtkSheetModel *model,
+                                     gint col, gint ncols);
+
+G_END_DECLS
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __GTK_SHEET_MODEL_H__ */
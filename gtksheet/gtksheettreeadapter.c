@@ -0,0 +1,619 @@
+/* GtkSheetTreeAdapter for Gtk+.
+ * Copyright 2011  Fredy Paquet <fredy@opag.ch>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * SECTION: gtksheettreeadapter
+ * @short_description: Show a #GtkTreeModel in a #GtkSheet
+ *
+ * The #GtkSheetTreeAdapter is a #GtkSheetModel which reads the
+ * top level rows of a #GtkTreeModel, e.g. a #GtkListStore, and
+ * maps sheet columns to tree model columns. Rows are read
+ * lazily when the sheet draws or edits them.
+ *
+ * Changes of the tree model are passed to the sheet row by
+ * row, so inserting, deleting, changing or reordering rows of
+ * the store does not reload the sheet. Cells edited in the
+ * sheet are written back into #GtkListStore and #GtkTreeStore
+ * models, also through #GtkTreeModelFilter and #GtkTreeModelSort
+ * models on top of them. Edits of other models are refused.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <glib.h>
+#include <gdk/gdk.h>
+#include <gtk/gtk.h>
+#include <pango/pango.h>
+
+#define __GTKSHEET_H_INSIDE__
+
+#include "gtksheet-compat.h"
+#include "gtksheet.h"
+#include "gtksheettreeadapter.h"
+
+#undef GTK_SHEET_TREE_DEBUG
+
+#ifdef DEBUG
+#define GTK_SHEET_TREE_DEBUG 0  /* define to activate debug output */
+#endif
+
+#ifdef GTK_SHEET_TREE_DEBUG
+#   define GTK_SHEET_TREE_DEBUG_SIGNALS  0
+#endif
+
+static GObjectClass *adapter_parent_class = NULL;
+
+
+/*
+ * _gtk_sheet_tree_adapter_iter - find the iter of a row
+ *
+ * sequential access walks from the last row found, if the tree
+ * model keeps its iters valid
+ *
+ * @param adapter
+ * @param row     top level row
+ * @param iter    returns the iter
+ *
+ * @return TRUE if the row exists
+ */
+static gboolean
+_gtk_sheet_tree_adapter_iter(GtkSheetTreeAdapter *adapter,
+    gint row, GtkTreeIter *iter)
+{
+    gboolean found = FALSE;
+
+    if (row < 0)
+	return (FALSE);
+
+    if (adapter->last_row >= 0 && row == adapter->last_row)
+    {
+	*iter = adapter->last_iter;
+	return (TRUE);
+    }
+
+    if (adapter->last_row >= 0 && row == adapter->last_row + 1)
+    {
+	*iter = adapter->last_iter;
+	found = gtk_tree_model_iter_next(adapter->tree_model, iter);
+    }
+    else
+    {
+	found = gtk_tree_model_iter_nth_child(adapter->tree_model, iter, NULL, row);
+    }
+
+    adapter->last_row = -1;
+
+    if (found
+	&& (gtk_tree_model_get_flags(adapter->tree_model) & GTK_TREE_MODEL_ITERS_PERSIST))
+    {
+	adapter->last_iter = *iter;
+	adapter->last_row = row;
+    }
+
+    return (found);
+}
+
+/*
+ * _gtk_sheet_tree_adapter_value_from_string - convert cell text
+ * into a tree model value
+ *
+ * @param value   an uninitialized #GValue
+ * @param type    tree model column type
+ * @param text    cell text or NULL
+ *
+ * @return FALSE if the column type cannot be set from text
+ */
+static gboolean
+_gtk_sheet_tree_adapter_value_from_string(GValue *value,
+    GType type, const gchar *text)
+{
+    if (!text)
+	text = "";
+
+    g_value_init(value, type);
+
+    switch(G_TYPE_FUNDAMENTAL(type))
+    {
+	case G_TYPE_STRING:
+	    g_value_set_string(value, text);
+	    break;
+
+	case G_TYPE_INT:
+	    g_value_set_int(value, (gint)g_ascii_strtoll(text, NULL, 10));
+	    break;
+
+	case G_TYPE_UINT:
+	    g_value_set_uint(value, (guint)g_ascii_strtoull(text, NULL, 10));
+	    break;
+
+	case G_TYPE_LONG:
+	    g_value_set_long(value, (glong)g_ascii_strtoll(text, NULL, 10));
+	    break;
+
+	case G_TYPE_ULONG:
+	    g_value_set_ulong(value, (gulong)g_ascii_strtoull(text, NULL, 10));
+	    break;
+
+	case G_TYPE_INT64:
+	    g_value_set_int64(value, g_ascii_strtoll(text, NULL, 10));
+	    break;
+
+	case G_TYPE_UINT64:
+	    g_value_set_uint64(value, g_ascii_strtoull(text, NULL, 10));
+	    break;
+
+	case G_TYPE_FLOAT:
+	    g_value_set_float(value, (gfloat)g_ascii_strtod(text, NULL));
+	    break;
+
+	case G_TYPE_DOUBLE:
+	    g_value_set_double(value, g_ascii_strtod(text, NULL));
+	    break;
+
+	case G_TYPE_BOOLEAN:
+	    g_value_set_boolean(value,
+		g_ascii_strcasecmp(text, "true") == 0
+		|| g_ascii_strcasecmp(text, "yes") == 0
+		|| g_ascii_strtoll(text, NULL, 10) != 0);
+	    break;
+
+	default:
+	    g_value_unset(value);
+	    return (FALSE);
+    }
+    return (TRUE);
+}
+
+/*
+ * _gtk_sheet_tree_adapter_store_set - write a value into the store
+ *
+ * filter and sort models are passed down to their child model,
+ * a filter's modify function must keep the child's columns
+ *
+ * @param tree_model
+ * @param iter    iter of tree_model
+ * @param column  tree model column
+ * @param value
+ *
+ * @return FALSE if no store was found below tree_model
+ */
+static gboolean
+_gtk_sheet_tree_adapter_store_set(GtkTreeModel *tree_model,
+    GtkTreeIter *iter, gint column, GValue *value)
+{
+    GtkTreeIter child_iter;
+
+    if (GTK_IS_LIST_STORE(tree_model))
+    {
+	gtk_list_store_set_value(GTK_LIST_STORE(tree_model), iter, column, value);
+	return (TRUE);
+    }
+    if (GTK_IS_TREE_STORE(tree_model))
+    {
+	gtk_tree_store_set_value(GTK_TREE_STORE(tree_model), iter, column, value);
+	return (TRUE);
+    }
+    if (GTK_IS_TREE_MODEL_FILTER(tree_model))
+    {
+	GtkTreeModelFilter *filter = GTK_TREE_MODEL_FILTER(tree_model);
+
+	gtk_tree_model_filter_convert_iter_to_child_iter(filter, &child_iter, iter);
+	return (_gtk_sheet_tree_adapter_store_set(
+	    gtk_tree_model_filter_get_model(filter), &child_iter, column, value));
+    }
+    if (GTK_IS_TREE_MODEL_SORT(tree_model))
+    {
+	GtkTreeModelSort *sort = GTK_TREE_MODEL_SORT(tree_model);
+
+	gtk_tree_model_sort_convert_iter_to_child_iter(sort, &child_iter, iter);
+	return (_gtk_sheet_tree_adapter_store_set(
+	    gtk_tree_model_sort_get_model(sort), &child_iter, column, value));
+    }
+    return (FALSE);
+}
+
+/* GtkSheetModel implementation */
+
+static gint
+gtk_sheet_tree_adapter_get_n_rows(GtkSheetModel *model)
+{
+    GtkSheetTreeAdapter *adapter = GTK_SHEET_TREE_ADAPTER(model);
+
+    return (gtk_tree_model_iter_n_children(adapter->tree_model, NULL));
+}
+
+static gint
+gtk_sheet_tree_adapter_get_n_columns(GtkSheetModel *model)
+{
+    return (GTK_SHEET_TREE_ADAPTER(model)->n_columns);
+}
+
+static gchar *
+gtk_sheet_tree_adapter_get_cell_text(GtkSheetModel *model, gint row, gint col)
+{
+    GtkSheetTreeAdapter *adapter = GTK_SHEET_TREE_ADAPTER(model);
+    GtkTreeIter iter;
+    GValue value = { 0, };
+    gchar *text = NULL;
+
+    if (col < 0 || col >= adapter->n_columns)
+	return (NULL);
+    if (!_gtk_sheet_tree_adapter_iter(adapter, row, &iter))
+	return (NULL);
+
+    gtk_tree_model_get_value(adapter->tree_model, &iter,
+	adapter->columns[col], &value);
+
+    if (G_VALUE_HOLDS_STRING(&value))
+    {
+	text = g_value_dup_string(&value);
+    }
+    else if (g_value_type_transformable(G_VALUE_TYPE(&value), G_TYPE_STRING))
+    {
+	GValue string = { 0, };
+
+	g_value_init(&string, G_TYPE_STRING);
+	if (g_value_transform(&value, &string))
+	    text = g_value_dup_string(&string);
+	g_value_unset(&string);
+    }
+
+    g_value_unset(&value);
+    return (text);
+}
+
+static gboolean
+gtk_sheet_tree_adapter_set_cell_text(GtkSheetModel *model,
+    gint row, gint col, const gchar *text)
+{
+    GtkSheetTreeAdapter *adapter = GTK_SHEET_TREE_ADAPTER(model);
+    GtkTreeIter iter;
+    GValue value = { 0, };
+    gint column;
+    gboolean stored;
+
+    if (col < 0 || col >= adapter->n_columns)
+	return (FALSE);
+    if (!_gtk_sheet_tree_adapter_iter(adapter, row, &iter))
+	return (FALSE);
+
+    column = adapter->columns[col];
+
+    if (!_gtk_sheet_tree_adapter_value_from_string(&value,
+	gtk_tree_model_get_column_type(adapter->tree_model, column), text))
+    {
+	g_warning("gtk_sheet_tree_adapter_set_cell_text: cannot convert text to %s",
+	    g_type_name(gtk_tree_model_get_column_type(adapter->tree_model, column)));
+	return (FALSE);
+    }
+
+    /* the store emits "row-changed" */
+    stored = _gtk_sheet_tree_adapter_store_set(adapter->tree_model,
+	&iter, column, &value);
+
+    g_value_unset(&value);
+    return (stored);
+}
+
+static void
+gtk_sheet_tree_adapter_model_init(GtkSheetModelIface *iface)
+{
+    iface->get_n_rows = gtk_sheet_tree_adapter_get_n_rows;
+    iface->get_n_columns = gtk_sheet_tree_adapter_get_n_columns;
+    iface->get_cell_text = gtk_sheet_tree_adapter_get_cell_text;
+    iface->set_cell_text = gtk_sheet_tree_adapter_set_cell_text;
+}
+
+/* GtkTreeModel signal handlers */
+
+static void
+_gtk_sheet_tree_adapter_row_changed(GtkTreeModel *tree_model,
+    GtkTreePath *path, GtkTreeIter *iter, GtkSheetTreeAdapter *adapter)
+{
+    GtkSheetRange range;
+
+    if (gtk_tree_path_get_depth(path) != 1)
+	return;
+
+#if GTK_SHEET_TREE_DEBUG_SIGNALS > 0
+    g_debug("_gtk_sheet_tree_adapter_row_changed: row %d",
+	gtk_tree_path_get_indices(path)[0]);
+#endif
+
+    range.row0 = range.rowi = gtk_tree_path_get_indices(path)[0];
+    range.col0 = 0;
+    range.coli = adapter->n_columns - 1;
+
+    gtk_sheet_model_cells_changed(GTK_SHEET_MODEL(adapter), &range);
+}
+
+static void
+_gtk_sheet_tree_adapter_row_inserted(GtkTreeModel *tree_model,
+    GtkTreePath *path, GtkTreeIter *iter, GtkSheetTreeAdapter *adapter)
+{
+    if (gtk_tree_path_get_depth(path) != 1)
+	return;
+
+    adapter->last_row = -1;
+
+    gtk_sheet_model_rows_inserted(GTK_SHEET_MODEL(adapter),
+	gtk_tree_path_get_indices(path)[0], 1);
+}
+
+static void
+_gtk_sheet_tree_adapter_row_deleted(GtkTreeModel *tree_model,
+    GtkTreePath *path, GtkSheetTreeAdapter *adapter)
+{
+    if (gtk_tree_path_get_depth(path) != 1)
+	return;
+
+    adapter->last_row = -1;
+
+    gtk_sheet_model_rows_deleted(GTK_SHEET_MODEL(adapter),
+	gtk_tree_path_get_indices(path)[0], 1);
+}
+
+static void
+_gtk_sheet_tree_adapter_rows_reordered(GtkTreeModel *tree_model,
+    GtkTreePath *path, GtkTreeIter *iter, gint *new_order,
+    GtkSheetTreeAdapter *adapter)
+{
+    GtkSheetRange range;
+    gint i, n;
+
+    if (gtk_tree_path_get_depth(path) != 0)  /* top level only */
+	return;
+
+    adapter->last_row = -1;
+
+    /* repaint the span of rows that actually moved */
+    n = gtk_tree_model_iter_n_children(tree_model, NULL);
+    range.row0 = n;
+    range.rowi = -1;
+
+    for (i = 0; i < n; i++)
+    {
+	if (new_order[i] != i)
+	{
+	    if (i < range.row0)
+		range.row0 = i;
+	    range.rowi = i;
+	}
+    }
+
+    if (range.row0 > range.rowi)
+	return;
+
+    range.col0 = 0;
+    range.coli = adapter->n_columns - 1;
+
+    gtk_sheet_model_cells_changed(GTK_SHEET_MODEL(adapter), &range);
+}
+
+static void
+_gtk_sheet_tree_adapter_disconnect(GtkSheetTreeAdapter *adapter)
+{
+    if (!adapter->tree_model)
+	return;
+
+    g_signal_handlers_disconnect_matched(
+	G_OBJECT(adapter->tree_model),
+	G_SIGNAL_MATCH_DATA,
+	0, 0, NULL, NULL, adapter);
+    g_object_unref(G_OBJECT(adapter->tree_model));
+    adapter->tree_model = NULL;
+}
+
+/* GObject */
+
+static void
+gtk_sheet_tree_adapter_init(GtkSheetTreeAdapter *adapter)
+{
+    adapter->tree_model = NULL;
+    adapter->columns = NULL;
+    adapter->n_columns = 0;
+    adapter->last_row = -1;
+}
+
+static void
+gtk_sheet_tree_adapter_dispose(GObject *object)
+{
+    _gtk_sheet_tree_adapter_disconnect(GTK_SHEET_TREE_ADAPTER(object));
+
+    if (adapter_parent_class->dispose)
+	(*adapter_parent_class->dispose)(object);
+}
+
+static void
+gtk_sheet_tree_adapter_finalize(GObject *object)
+{
+    GtkSheetTreeAdapter *adapter = GTK_SHEET_TREE_ADAPTER(object);
+
+    g_free(adapter->columns);
+    adapter->columns = NULL;
+
+    if (adapter_parent_class->finalize)
+	(*adapter_parent_class->finalize)(object);
+}
+
+static void
+gtk_sheet_tree_adapter_class_init(GtkSheetTreeAdapterClass *klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+
+    adapter_parent_class = g_type_class_peek_parent(klass);
+
+    gobject_class->dispose = gtk_sheet_tree_adapter_dispose;
+    gobject_class->finalize = gtk_sheet_tree_adapter_finalize;
+}
+
+/* Type initialisation */
+
+GType
+gtk_sheet_tree_adapter_get_type(void)
+{
+    static GType tree_adapter_type = 0;
+
+    if (!tree_adapter_type)
+    {
+        static const GTypeInfo tree_adapter_info =
+        {
+            sizeof(GtkSheetTreeAdapterClass),
+            NULL,
+            NULL,
+            (GClassInitFunc)gtk_sheet_tree_adapter_class_init,
+            NULL,
+            NULL,
+            sizeof(GtkSheetTreeAdapter),
+            0,
+            (GInstanceInitFunc)gtk_sheet_tree_adapter_init,
+            NULL,
+        };
+
+        static const GInterfaceInfo model_info = {
+            (GInterfaceInitFunc)gtk_sheet_tree_adapter_model_init,
+            (GInterfaceFinalizeFunc)NULL,
+            (gpointer)NULL
+        };
+
+        tree_adapter_type = g_type_register_static(G_TYPE_OBJECT,
+                                                   "GtkSheetTreeAdapter",
+                                                   &tree_adapter_info,
+                                                   0);
+
+        g_type_add_interface_static(tree_adapter_type,
+                                    G_TYPE_SHEET_MODEL,
+                                    &model_info);
+    }
+    return (tree_adapter_type);
+}
+
+/**
+ * gtk_sheet_tree_adapter_new:
+ * @tree_model: the #GtkTreeModel to show
+ * @n_columns: number of sheet columns or -1 for all tree model
+ *           columns
+ * @columns: (allow-none) (array length=n_columns) tree model
+ *         column for each sheet column, NULL maps sheet column
+ *         n to tree model column n
+ *
+ * Create a #GtkSheetModel reading the top level rows of
+ * @tree_model.
+ *
+ * Returns: (transfer full) the new #GtkSheetTreeAdapter
+ */
+GtkSheetTreeAdapter *
+gtk_sheet_tree_adapter_new(GtkTreeModel *tree_model,
+    gint n_columns, const gint *columns)
+{
+    GtkSheetTreeAdapter *adapter;
+    gint i, n_model_columns;
+
+    g_return_val_if_fail(GTK_IS_TREE_MODEL(tree_model), NULL);
+
+    n_model_columns = gtk_tree_model_get_n_columns(tree_model);
+
+    if (n_columns < 0)
+	n_columns = n_model_columns;
+
+    adapter = g_object_new(G_TYPE_SHEET_TREE_ADAPTER, NULL);
+
+    adapter->tree_model = g_object_ref(G_OBJECT(tree_model));
+    adapter->n_columns = n_columns;
+    adapter->columns = g_new0(gint, MAX(n_columns, 1));
+
+    for (i = 0; i < n_columns; i++)
+    {
+	adapter->columns[i] = columns ? columns[i] : i;
+
+	if (adapter->columns[i] < 0 || adapter->columns[i] >= n_model_columns)
+	{
+	    g_warning("gtk_sheet_tree_adapter_new: invalid tree model column %d",
+		adapter->columns[i]);
+	    adapter->columns[i] = 0;
+	}
+    }
+
+    g_signal_connect(G_OBJECT(tree_model), "row-changed",
+	(void *)_gtk_sheet_tree_adapter_row_changed,
+	(gpointer)adapter);
+    g_signal_connect(G_OBJECT(tree_model), "row-inserted",
+	(void *)_gtk_sheet_tree_adapter_row_inserted,
+	(gpointer)adapter);
+    g_signal_connect(G_OBJECT(tree_model), "row-deleted",
+	(void *)_gtk_sheet_tree_adapter_row_deleted,
+	(gpointer)adapter);
+    g_signal_connect(G_OBJECT(tree_model), "rows-reordered",
+	(void *)_gtk_sheet_tree_adapter_rows_reordered,
+	(gpointer)adapter);
+
+    return (adapter);
+}
+
+/**
+ * gtk_sheet_tree_adapter_get_tree_model:
+ * @adapter: a #GtkSheetTreeAdapter
+ *
+ * Get the tree model shown by the adapter.
+ *
+ * Returns: (transfer none) the #GtkTreeModel
+ */
+GtkTreeModel *
+gtk_sheet_tree_adapter_get_tree_model(GtkSheetTreeAdapter *adapter)
+{
+    g_return_val_if_fail(GTK_IS_SHEET_TREE_ADAPTER(adapter), NULL);
+
+    return (adapter->tree_model);
+}
+
+/**
+ * gtk_sheet_set_tree_model:
+ * @sheet: a #GtkSheet
+ * @tree_model: (allow-none) the #GtkTreeModel to show or NULL
+ * @n_columns: number of sheet columns or -1 for all tree model
+ *           columns
+ * @columns: (allow-none) (array length=n_columns) tree model
+ *         column for each sheet column or NULL
+ *
+ * Show the top level rows of @tree_model in the sheet, see
+ * gtk_sheet_tree_adapter_new(). The sheet keeps no copy of the
+ * data. Passing NULL detaches the tree model.
+ */
+void
+gtk_sheet_set_tree_model(GtkSheet *sheet, GtkTreeModel *tree_model,
+    gint n_columns, const gint *columns)
+{
+    GtkSheetTreeAdapter *adapter;
+
+    g_return_if_fail(sheet != NULL);
+    g_return_if_fail(GTK_IS_SHEET(sheet));
+    g_return_if_fail(tree_model == NULL || GTK_IS_TREE_MODEL(tree_model));
+
+    if (!tree_model)
+    {
+	gtk_sheet_set_model(sheet, NULL);
+	return;
+    }
+
+    adapter = gtk_sheet_tree_adapter_new(tree_model, n_columns, columns);
+    gtk_sheet_set_model(sheet, GTK_SHEET_MODEL(adapter));
+    g_object_unref(G_OBJECT(adapter));  /* owned by the sheet */
+}
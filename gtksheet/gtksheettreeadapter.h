@@ -0,0 +1,88 @@
+/* GtkSheetTreeAdapter for Gtk+.
+ * Copyright 2011  Fredy Paquet <fredy@opag.ch>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#if defined(GTK_DISABLE_SINGLE_INCLUDES) && !defined (__GTK_H_INSIDE__) && !defined (GTK_COMPILATION) && !defined (__GTKSHEET_H_INSIDE__)
+#   error "Only <gtksheet/gtksheet.h> can be included directly."
+#endif
+
+#ifndef __GTK_SHEET_TREE_ADAPTER_H__
+#define __GTK_SHEET_TREE_ADAPTER_H__
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+G_BEGIN_DECLS
+
+#define G_TYPE_SHEET_TREE_ADAPTER (gtk_sheet_tree_adapter_get_type ())
+
+#define GTK_SHEET_TREE_ADAPTER(obj) \
+    (G_TYPE_CHECK_INSTANCE_CAST ((obj), G_TYPE_SHEET_TREE_ADAPTER, GtkSheetTreeAdapter))
+
+#define GTK_SHEET_TREE_ADAPTER_CLASS(klass) \
+    (G_TYPE_CHECK_CLASS_CAST ((klass), G_TYPE_SHEET_TREE_ADAPTER, GtkSheetTreeAdapterClass))
+
+#define GTK_IS_SHEET_TREE_ADAPTER(obj) \
+    (G_TYPE_CHECK_INSTANCE_TYPE ((obj), G_TYPE_SHEET_TREE_ADAPTER))
+
+typedef struct _GtkSheetTreeAdapter GtkSheetTreeAdapter;
+typedef struct _GtkSheetTreeAdapterClass GtkSheetTreeAdapterClass;
+
+/**
+ * GtkSheetTreeAdapter:
+ *
+ * The GtkSheetTreeAdapter struct contains only private data.
+ * It should only be accessed through the functions described below.
+ */
+struct _GtkSheetTreeAdapter
+{
+    /*< private >*/
+    GObject parent;
+
+    GtkTreeModel *tree_model;
+    gint *columns;     /* sheet column -> tree model column */
+    gint n_columns;
+
+    GtkTreeIter last_iter;  /* iter of last_row, for sequential access */
+    gint last_row;          /* -1 if last_iter is not valid */
+};
+
+struct _GtkSheetTreeAdapterClass
+{
+    GObjectClass parent_class;
+};
+
+GType gtk_sheet_tree_adapter_get_type(void);
+
+GtkSheetTreeAdapter *gtk_sheet_tree_adapter_new(GtkTreeModel *tree_model,
+                                                gint n_columns, const gint *columns);
+GtkTreeModel *gtk_sheet_tree_adapter_get_tree_model(GtkSheetTreeAdapter *adapter);
+
+void gtk_sheet_set_tree_model(GtkSheet *sheet, GtkTreeModel *tree_model,
+                              gint n_columns, const gint *columns);
+
+G_END_DECLS
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __GTK_SHEET_TREE_ADAPTER_H__ */